@@ -0,0 +1,240 @@
+/**
+********************************************************************************
+\file   common/benchmark.c
+
+\defgroup module_com_bench Benchmark trace module
+\{
+
+\brief  RAM trace buffer backend of the benchmark points
+
+If BENCHMARK_TRACE_ENABLED is defined the benchmark points of benchmark.h
+record an event with probe id, edge and time stamp into a RAM ring buffer
+instead of driving pins. The ring is lock-free: writers reserve an entry by
+atomically incrementing the write index and may be interrupted by each other.
+The background loop prints the events with benchmark_traceDump() over the
+debug output. The dump is decoded on the host by contrib/scripts/benchtrace.py.
+
+\ingroup group_app_common
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+
+#include <common/benchmark.h>
+#include <common/debug.h>
+
+#ifdef BENCHMARK_TRACE_ENABLED
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#define BENCHMARK_TRACE_MASK        (BENCHMARK_TRACE_BUFFER_SIZE - 1)
+
+/* Reserve the next event number, safe against nested writers */
+#if defined(__GNUC__)
+    #define BENCHMARK_TRACE_RESERVE()   __atomic_fetch_add(&writeIdx_l, 1, __ATOMIC_RELAXED)
+    #define BENCHMARK_TRACE_LOAD_IDX()  __atomic_load_n(&writeIdx_l, __ATOMIC_ACQUIRE)
+    #define BENCHMARK_TRACE_BARRIER()   __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+    #define BENCHMARK_TRACE_RESERVE()   (writeIdx_l++)
+    #define BENCHMARK_TRACE_LOAD_IDX()  (writeIdx_l)
+    #define BENCHMARK_TRACE_BARRIER()
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tBenchmarkTraceEvent traceBuffer_l[BENCHMARK_TRACE_BUFFER_SIZE];
+static volatile UINT32 writeIdx_l = 0;      /**< Number of the next event to write */
+static UINT32 readIdx_l = 0;                /**< Number of the next event to dump */
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Initialize the benchmark trace
+
+Starts the time base of the target, clears the ring buffer and prints the
+trace header with the time stamp frequency for the host decoder.
+*/
+/*----------------------------------------------------------------------------*/
+void benchmark_traceInit(void)
+{
+    UINT32 i;
+
+    BENCHMARK_TRACE_TIMER_INIT();
+
+    /* Mark all entries as written in the round before the first one */
+    for(i = 0; i < BENCHMARK_TRACE_BUFFER_SIZE; i++)
+    {
+        traceBuffer_l[i].seq_m = (UINT16)(i - BENCHMARK_TRACE_BUFFER_SIZE);
+    }
+
+    readIdx_l = 0;
+    writeIdx_l = 0;
+
+    DEBUG_TRACE(DEBUG_LVL_ALWAYS, "\nBMT H %lu %u\n",
+                (unsigned long)BENCHMARK_TRACE_TICK_HZ, (unsigned int)BENCHMARK_TRACE_BUFFER_SIZE);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Record a benchmark trace event
+
+The function is called by the BENCHMARK_MOD_xx_SET/RESET/TOGGLE macros and is
+safe to be called from the background loop and from interrupt context. The
+sequence number is written last, so the reader is able to detect an entry
+which is not completely written yet.
+
+\param[in] probe_p      Probe id of the benchmark point
+\param[in] edge_p       Edge of type tBenchmarkEdge
+*/
+/*----------------------------------------------------------------------------*/
+void benchmark_traceEvent(UINT8 probe_p, UINT8 edge_p)
+{
+    UINT32 timeStamp = (UINT32)BENCHMARK_TRACE_TIMESTAMP();
+    UINT32 idx = BENCHMARK_TRACE_RESERVE();
+    tBenchmarkTraceEvent * pEvent = &traceBuffer_l[idx & BENCHMARK_TRACE_MASK];
+
+    pEvent->timeStamp_m = timeStamp;
+    pEvent->probe_m = probe_p;
+    pEvent->edge_m = edge_p;
+
+    BENCHMARK_TRACE_BARRIER();
+    pEvent->seq_m = (UINT16)idx;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Print recorded events over the debug output
+
+Prints at most \p maxEvents_p events in order to limit the time spent in the
+background loop. Events which were overwritten before they could be printed
+are reported as lost.
+
+\param[in] maxEvents_p  Maximum number of events to print
+
+\return The number of printed events
+*/
+/*----------------------------------------------------------------------------*/
+UINT16 benchmark_traceDump(UINT16 maxEvents_p)
+{
+    UINT16 count = 0;
+    UINT32 lost = 0;
+    UINT32 writeIdx = BENCHMARK_TRACE_LOAD_IDX();
+    tBenchmarkTraceEvent event;
+    INT16 seqDiff;
+
+    /* The writers have already overtaken the reader */
+    if((writeIdx - readIdx_l) > BENCHMARK_TRACE_BUFFER_SIZE)
+    {
+        lost = writeIdx - readIdx_l - BENCHMARK_TRACE_BUFFER_SIZE;
+        readIdx_l = writeIdx - BENCHMARK_TRACE_BUFFER_SIZE;
+    }
+
+    while((readIdx_l != writeIdx) && (count < maxEvents_p))
+    {
+        event = traceBuffer_l[readIdx_l & BENCHMARK_TRACE_MASK];
+
+        seqDiff = (INT16)(event.seq_m - (UINT16)readIdx_l);
+        if(seqDiff < 0)
+        {
+            /* Entry is reserved but not written yet -> retry on next call */
+            break;
+        }
+
+        if(seqDiff == 0)
+        {
+            DEBUG_TRACE(DEBUG_LVL_ALWAYS, "BMT E %04x %02x %x %08lx\n",
+                        (unsigned int)event.seq_m, (unsigned int)event.probe_m,
+                        (unsigned int)event.edge_m, (unsigned long)event.timeStamp_m);
+            count++;
+        }
+        else
+        {
+            /* Entry was overwritten while dumping */
+            lost++;
+        }
+
+        readIdx_l++;
+    }
+
+    if(lost != 0)
+    {
+        DEBUG_TRACE(DEBUG_LVL_ALWAYS, "BMT L %lu\n", (unsigned long)lost);
+    }
+
+    return count;
+}
+
+/**
+ * \}
+ */
+
+#endif /* #ifdef BENCHMARK_TRACE_ENABLED */
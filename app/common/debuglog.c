@@ -0,0 +1,345 @@
+/**
+********************************************************************************
+\file   common/debuglog.c
+
+\defgroup module_com_debuglog Deferred debug log module
+\{
+
+\brief  Deferred binary logging for DEBUG_LOG()
+
+DEBUG_LOG() records the id of the format string and the raw arguments of a
+message into a ring buffer. Formatting and printing is deferred to
+debuglog_dump() in the background loop, so the call site costs a few stores
+instead of a printf(). Each execution context (background loop, interrupt) has
+its own ring, a burst in one context does not overwrite the records of the
+other one. Writers reserve a record by atomically incrementing the write index
+of the ring and write the sequence number last, so nested interrupts are safe.
+
+The dump is decoded on the host with contrib/scripts/debuglog.py and the
+table of format strings extracted from the ELF file.
+
+\ingroup group_app_common
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+
+#include <common/debug.h>
+
+#ifdef DEBUG_LOG_ENABLED
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+volatile UINT32 debuglog_lvlMask_g = DEBUG_LOG_GLB_LVL;    /**< Runtime debug level filter */
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#define DEBUG_LOG_MASK              (DEBUG_LOG_BUFFER_SIZE - 1)
+
+#define DEBUG_LOG_CTX_BACKGROUND    0       /**< Background loop (thread mode) */
+#define DEBUG_LOG_CTX_INTERRUPT     1       /**< Interrupt service routines */
+#define DEBUG_LOG_CTX_COUNT         2
+
+#if defined(__GNUC__)
+    #define DEBUG_LOG_RESERVE(pIdx)     __atomic_fetch_add((pIdx), 1, __ATOMIC_RELAXED)
+    #define DEBUG_LOG_LOAD_IDX(pIdx)    __atomic_load_n((pIdx), __ATOMIC_ACQUIRE)
+    #define DEBUG_LOG_BARRIER()         __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+    #define DEBUG_LOG_RESERVE(pIdx)     ((*(pIdx))++)
+    #define DEBUG_LOG_LOAD_IDX(pIdx)    (*(pIdx))
+    #define DEBUG_LOG_BARRIER()
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Ring buffer of one execution context
+ */
+typedef struct
+{
+    tDebugLogRecord aRecord_m[DEBUG_LOG_BUFFER_SIZE];   /**< Records */
+    volatile UINT32 writeIdx_m;                         /**< Number of the next record to write */
+    UINT32 readIdx_m;                                   /**< Number of the next record to dump */
+} tDebugLogRing;
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tDebugLogRing ring_l[DEBUG_LOG_CTX_COUNT];
+static UINT8 dumpCtx_l = 0;                 /**< Context to dump next */
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static UINT8 getContext(void);
+static UINT16 dumpRing(UINT8 ctx_p, UINT16 maxRecords_p);
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Initialize the deferred debug log
+
+Clears the ring buffers and prints the log header for the host decoder.
+*/
+/*----------------------------------------------------------------------------*/
+void debuglog_init(void)
+{
+    UINT8 ctx;
+    UINT32 i;
+
+    for(ctx = 0; ctx < DEBUG_LOG_CTX_COUNT; ctx++)
+    {
+        /* Mark all records as written in the round before the first one */
+        for(i = 0; i < DEBUG_LOG_BUFFER_SIZE; i++)
+        {
+            ring_l[ctx].aRecord_m[i].seq_m = (UINT16)(i - DEBUG_LOG_BUFFER_SIZE);
+        }
+
+        ring_l[ctx].readIdx_m = 0;
+        ring_l[ctx].writeIdx_m = 0;
+    }
+
+    dumpCtx_l = 0;
+
+    DEBUG_LOG_PRINT("\nBML H %u %u\n", (unsigned int)DEBUG_LOG_CTX_COUNT,
+                    (unsigned int)DEBUG_LOG_BUFFER_SIZE);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Change the runtime debug level filter
+
+Only levels which are also set in DEBUG_LOG_GLB_LVL are compiled in and can be
+enabled.
+
+\param[in] lvlMask_p    Mask of enabled DEBUG_LVL_xx levels
+*/
+/*----------------------------------------------------------------------------*/
+void debuglog_setLevel(UINT32 lvlMask_p)
+{
+    debuglog_lvlMask_g = lvlMask_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Record a message
+
+Called by DEBUG_LOG(), may be called from any context.
+
+\param[in] fmtId_p      Id of the format string
+\param[in] argCnt_p     Number of arguments
+\param[in] pArg_p       Pointer to the raw arguments
+*/
+/*----------------------------------------------------------------------------*/
+void debuglog_write(UINT32 fmtId_p, UINT8 argCnt_p, const UINT32* pArg_p)
+{
+    tDebugLogRing * pRing = &ring_l[getContext()];
+    UINT32 idx = DEBUG_LOG_RESERVE(&pRing->writeIdx_m);
+    tDebugLogRecord * pRecord = &pRing->aRecord_m[idx & DEBUG_LOG_MASK];
+    UINT8 i;
+
+    pRecord->fmtId_m = fmtId_p;
+    pRecord->argCnt_m = argCnt_p;
+    for(i = 0; i < argCnt_p; i++)
+    {
+        pRecord->aArg_m[i] = pArg_p[i];
+    }
+
+    DEBUG_LOG_BARRIER();
+    pRecord->seq_m = (UINT16)idx;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Print recorded messages over the debug output
+
+Prints at most \p maxRecords_p records in order to limit the time spent in
+the background loop. The contexts are served round robin.
+
+\param[in] maxRecords_p     Maximum number of records to print
+
+\return The number of printed records
+*/
+/*----------------------------------------------------------------------------*/
+UINT16 debuglog_dump(UINT16 maxRecords_p)
+{
+    UINT16 count = 0;
+    UINT8 i;
+
+    for(i = 0; (i < DEBUG_LOG_CTX_COUNT) && (count < maxRecords_p); i++)
+    {
+        count += dumpRing(dumpCtx_l, (UINT16)(maxRecords_p - count));
+
+        dumpCtx_l++;
+        if(dumpCtx_l >= DEBUG_LOG_CTX_COUNT)
+        {
+            dumpCtx_l = 0;
+        }
+    }
+
+    return count;
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the execution context of the caller
+
+\return DEBUG_LOG_CTX_INTERRUPT in an exception handler, otherwise
+        DEBUG_LOG_CTX_BACKGROUND
+*/
+/*----------------------------------------------------------------------------*/
+static UINT8 getContext(void)
+{
+#if defined(__GNUC__) && (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+    UINT32 ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+
+    return (ipsr != 0) ? DEBUG_LOG_CTX_INTERRUPT : DEBUG_LOG_CTX_BACKGROUND;
+#else
+    return DEBUG_LOG_CTX_BACKGROUND;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Print the records of one context
+
+\param[in] ctx_p            Context of the ring
+\param[in] maxRecords_p     Maximum number of records to print
+
+\return The number of printed records
+*/
+/*----------------------------------------------------------------------------*/
+static UINT16 dumpRing(UINT8 ctx_p, UINT16 maxRecords_p)
+{
+    tDebugLogRing * pRing = &ring_l[ctx_p];
+    UINT32 writeIdx = DEBUG_LOG_LOAD_IDX(&pRing->writeIdx_m);
+    UINT32 lost = 0;
+    UINT16 count = 0;
+    tDebugLogRecord record;
+    INT16 seqDiff;
+    UINT8 i;
+
+    /* The writers have already overtaken the reader */
+    if((writeIdx - pRing->readIdx_m) > DEBUG_LOG_BUFFER_SIZE)
+    {
+        DEBUG_LOG_PRINT("BML L %u %lu\n", (unsigned int)ctx_p,
+                        (unsigned long)(writeIdx - pRing->readIdx_m - DEBUG_LOG_BUFFER_SIZE));
+        pRing->readIdx_m = writeIdx - DEBUG_LOG_BUFFER_SIZE;
+    }
+
+    while((pRing->readIdx_m != writeIdx) && (count < maxRecords_p))
+    {
+        record = pRing->aRecord_m[pRing->readIdx_m & DEBUG_LOG_MASK];
+
+        seqDiff = (INT16)(record.seq_m - (UINT16)pRing->readIdx_m);
+        if(seqDiff < 0)
+        {
+            /* Record is reserved but not written yet -> retry on next call */
+            break;
+        }
+
+        /* An interrupt may overwrite the record during the copy */
+        if((seqDiff == 0) &&
+           (pRing->aRecord_m[pRing->readIdx_m & DEBUG_LOG_MASK].seq_m == record.seq_m) &&
+           (record.argCnt_m <= DEBUG_LOG_ARG_MAX))
+        {
+            DEBUG_LOG_PRINT("BML R %u %04x %08lx", (unsigned int)ctx_p,
+                            (unsigned int)record.seq_m, (unsigned long)record.fmtId_m);
+            for(i = 0; i < record.argCnt_m; i++)
+            {
+                DEBUG_LOG_PRINT(" %lx", (unsigned long)record.aArg_m[i]);
+            }
+            DEBUG_LOG_PRINT("\n");
+
+            count++;
+        }
+        else
+        {
+            /* Record was overwritten while dumping */
+            lost++;
+        }
+
+        pRing->readIdx_m++;
+    }
+
+    if(lost != 0)
+    {
+        DEBUG_LOG_PRINT("BML L %u %lu\n", (unsigned int)ctx_p, (unsigned long)lost);
+    }
+
+    return count;
+}
+
+/**
+ * \}
+ * \}
+ */
+
+#endif /* #ifdef DEBUG_LOG_ENABLED */
@@ -7,6 +7,11 @@
 This header is used to set benchmark pins in order to enable timing
 measurements on the application processor.
 
+If BENCHMARK_TRACE_ENABLED is defined the benchmark points are not mapped to
+pins. Each edge is recorded with a time stamp in a RAM ring buffer instead
+and dumped over the debug output by benchmark_traceDump(). The dump is decoded
+on the host with contrib/scripts/benchtrace.py.
+
 *******************************************************************************/
 
 /*------------------------------------------------------------------------------
@@ -87,11 +92,49 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define BENCHMARK_MOD_31                    0x40000000
 #define BENCHMARK_MOD_32                    0x80000000
 
+#ifdef BENCHMARK_TRACE_ENABLED
+    #ifndef BENCHMARK_TRACE_TIMESTAMP
+        #error "The target does not provide a time stamp for the benchmark trace!"
+    #endif
+
+    /* Number of trace events in the ring buffer (power of two) */
+    #ifndef BENCHMARK_TRACE_BUFFER_SIZE
+        #define BENCHMARK_TRACE_BUFFER_SIZE     128
+    #endif
+
+    #if ((BENCHMARK_TRACE_BUFFER_SIZE & (BENCHMARK_TRACE_BUFFER_SIZE - 1)) != 0) || \
+        (BENCHMARK_TRACE_BUFFER_SIZE > 0x4000)
+        #error "BENCHMARK_TRACE_BUFFER_SIZE must be a power of two not larger than 0x4000!"
+    #endif
+
+    /* Maximum number of events printed by one benchmark_traceDump() call */
+    #ifndef BENCHMARK_TRACE_DUMP_MAX
+        #define BENCHMARK_TRACE_DUMP_MAX        8
+    #endif
+
+    /* Probe id: module number in the upper five bits, pin in the lower three */
+    #define BENCHMARK_TRACE_PROBE(mod, x)   ((UINT8)((((mod) - 1) << 3) | ((x) & 0x07)))
+
+    #define BENCHMARK_MOD_SET(mod, x)       benchmark_traceEvent(BENCHMARK_TRACE_PROBE(mod, x), kBenchmarkEdgeSet)
+    #define BENCHMARK_MOD_RESET(mod, x)     benchmark_traceEvent(BENCHMARK_TRACE_PROBE(mod, x), kBenchmarkEdgeReset)
+    #define BENCHMARK_MOD_TOGGLE(mod, x)    benchmark_traceEvent(BENCHMARK_TRACE_PROBE(mod, x), kBenchmarkEdgeToggle)
+
+    #define BENCHMARK_TRACE_INIT()          benchmark_traceInit()
+    #define BENCHMARK_TRACE_DUMP()          (void)benchmark_traceDump(BENCHMARK_TRACE_DUMP_MAX)
+#else
+    #define BENCHMARK_MOD_SET(mod, x)       BENCHMARK_SET(x)
+    #define BENCHMARK_MOD_RESET(mod, x)     BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_TOGGLE(mod, x)    BENCHMARK_TOGGLE(x)
+
+    #define BENCHMARK_TRACE_INIT()
+    #define BENCHMARK_TRACE_DUMP()
+#endif
+
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_01)
-    #define BENCHMARK_MOD_01_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_01_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_01_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_01_SET(x)     BENCHMARK_MOD_SET(1, x)
+    #define BENCHMARK_MOD_01_RESET(x)   BENCHMARK_MOD_RESET(1, x)
+    #define BENCHMARK_MOD_01_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(1, x)
 #else
     #define BENCHMARK_MOD_01_SET(x)
     #define BENCHMARK_MOD_01_RESET(x)
@@ -99,9 +142,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_02)
-    #define BENCHMARK_MOD_02_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_02_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_02_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_02_SET(x)     BENCHMARK_MOD_SET(2, x)
+    #define BENCHMARK_MOD_02_RESET(x)   BENCHMARK_MOD_RESET(2, x)
+    #define BENCHMARK_MOD_02_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(2, x)
 #else
     #define BENCHMARK_MOD_02_SET(x)
     #define BENCHMARK_MOD_02_RESET(x)
@@ -109,9 +152,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_03)
-    #define BENCHMARK_MOD_03_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_03_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_03_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_03_SET(x)     BENCHMARK_MOD_SET(3, x)
+    #define BENCHMARK_MOD_03_RESET(x)   BENCHMARK_MOD_RESET(3, x)
+    #define BENCHMARK_MOD_03_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(3, x)
 #else
     #define BENCHMARK_MOD_03_SET(x)
     #define BENCHMARK_MOD_03_RESET(x)
@@ -119,9 +162,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_04)
-    #define BENCHMARK_MOD_04_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_04_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_04_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_04_SET(x)     BENCHMARK_MOD_SET(4, x)
+    #define BENCHMARK_MOD_04_RESET(x)   BENCHMARK_MOD_RESET(4, x)
+    #define BENCHMARK_MOD_04_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(4, x)
 #else
     #define BENCHMARK_MOD_04_SET(x)
     #define BENCHMARK_MOD_04_RESET(x)
@@ -129,9 +172,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_05)
-    #define BENCHMARK_MOD_05_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_05_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_05_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_05_SET(x)     BENCHMARK_MOD_SET(5, x)
+    #define BENCHMARK_MOD_05_RESET(x)   BENCHMARK_MOD_RESET(5, x)
+    #define BENCHMARK_MOD_05_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(5, x)
 #else
     #define BENCHMARK_MOD_05_SET(x)
     #define BENCHMARK_MOD_05_RESET(x)
@@ -139,9 +182,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_06)
-    #define BENCHMARK_MOD_06_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_06_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_06_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_06_SET(x)     BENCHMARK_MOD_SET(6, x)
+    #define BENCHMARK_MOD_06_RESET(x)   BENCHMARK_MOD_RESET(6, x)
+    #define BENCHMARK_MOD_06_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(6, x)
 #else
     #define BENCHMARK_MOD_06_SET(x)
     #define BENCHMARK_MOD_06_RESET(x)
@@ -149,9 +192,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_07)
-    #define BENCHMARK_MOD_07_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_07_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_07_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_07_SET(x)     BENCHMARK_MOD_SET(7, x)
+    #define BENCHMARK_MOD_07_RESET(x)   BENCHMARK_MOD_RESET(7, x)
+    #define BENCHMARK_MOD_07_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(7, x)
 #else
     #define BENCHMARK_MOD_07_SET(x)
     #define BENCHMARK_MOD_07_RESET(x)
@@ -159,9 +202,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_08)
-    #define BENCHMARK_MOD_08_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_08_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_08_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_08_SET(x)     BENCHMARK_MOD_SET(8, x)
+    #define BENCHMARK_MOD_08_RESET(x)   BENCHMARK_MOD_RESET(8, x)
+    #define BENCHMARK_MOD_08_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(8, x)
 #else
     #define BENCHMARK_MOD_08_SET(x)
     #define BENCHMARK_MOD_08_RESET(x)
@@ -169,9 +212,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_09)
-    #define BENCHMARK_MOD_09_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_09_RESET(x)       BENCHMARK_RESET(x)
-    #define BENCHMARK_MOD_09_TOGGLE(x)      BENCHMARK_TOGGLE(x)
+    #define BENCHMARK_MOD_09_SET(x)     BENCHMARK_MOD_SET(9, x)
+    #define BENCHMARK_MOD_09_RESET(x)   BENCHMARK_MOD_RESET(9, x)
+    #define BENCHMARK_MOD_09_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(9, x)
 #else
     #define BENCHMARK_MOD_09_SET(x)
     #define BENCHMARK_MOD_09_RESET(x)
@@ -179,187 +222,233 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_10)
-    #define BENCHMARK_MOD_10_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_10_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_10_SET(x)     BENCHMARK_MOD_SET(10, x)
+    #define BENCHMARK_MOD_10_RESET(x)   BENCHMARK_MOD_RESET(10, x)
+    #define BENCHMARK_MOD_10_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(10, x)
 #else
     #define BENCHMARK_MOD_10_SET(x)
     #define BENCHMARK_MOD_10_RESET(x)
+    #define BENCHMARK_MOD_10_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_11)
-    #define BENCHMARK_MOD_11_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_11_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_11_SET(x)     BENCHMARK_MOD_SET(11, x)
+    #define BENCHMARK_MOD_11_RESET(x)   BENCHMARK_MOD_RESET(11, x)
+    #define BENCHMARK_MOD_11_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(11, x)
 #else
     #define BENCHMARK_MOD_11_SET(x)
     #define BENCHMARK_MOD_11_RESET(x)
+    #define BENCHMARK_MOD_11_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_12)
-    #define BENCHMARK_MOD_12_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_12_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_12_SET(x)     BENCHMARK_MOD_SET(12, x)
+    #define BENCHMARK_MOD_12_RESET(x)   BENCHMARK_MOD_RESET(12, x)
+    #define BENCHMARK_MOD_12_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(12, x)
 #else
     #define BENCHMARK_MOD_12_SET(x)
     #define BENCHMARK_MOD_12_RESET(x)
+    #define BENCHMARK_MOD_12_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_13)
-    #define BENCHMARK_MOD_13_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_13_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_13_SET(x)     BENCHMARK_MOD_SET(13, x)
+    #define BENCHMARK_MOD_13_RESET(x)   BENCHMARK_MOD_RESET(13, x)
+    #define BENCHMARK_MOD_13_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(13, x)
 #else
     #define BENCHMARK_MOD_13_SET(x)
     #define BENCHMARK_MOD_13_RESET(x)
+    #define BENCHMARK_MOD_13_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_14)
-    #define BENCHMARK_MOD_14_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_14_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_14_SET(x)     BENCHMARK_MOD_SET(14, x)
+    #define BENCHMARK_MOD_14_RESET(x)   BENCHMARK_MOD_RESET(14, x)
+    #define BENCHMARK_MOD_14_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(14, x)
 #else
     #define BENCHMARK_MOD_14_SET(x)
     #define BENCHMARK_MOD_14_RESET(x)
+    #define BENCHMARK_MOD_14_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_15)
-    #define BENCHMARK_MOD_15_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_15_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_15_SET(x)     BENCHMARK_MOD_SET(15, x)
+    #define BENCHMARK_MOD_15_RESET(x)   BENCHMARK_MOD_RESET(15, x)
+    #define BENCHMARK_MOD_15_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(15, x)
 #else
     #define BENCHMARK_MOD_15_SET(x)
     #define BENCHMARK_MOD_15_RESET(x)
+    #define BENCHMARK_MOD_15_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_16)
-    #define BENCHMARK_MOD_16_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_16_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_16_SET(x)     BENCHMARK_MOD_SET(16, x)
+    #define BENCHMARK_MOD_16_RESET(x)   BENCHMARK_MOD_RESET(16, x)
+    #define BENCHMARK_MOD_16_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(16, x)
 #else
     #define BENCHMARK_MOD_16_SET(x)
     #define BENCHMARK_MOD_16_RESET(x)
+    #define BENCHMARK_MOD_16_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_17)
-    #define BENCHMARK_MOD_17_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_17_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_17_SET(x)     BENCHMARK_MOD_SET(17, x)
+    #define BENCHMARK_MOD_17_RESET(x)   BENCHMARK_MOD_RESET(17, x)
+    #define BENCHMARK_MOD_17_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(17, x)
 #else
     #define BENCHMARK_MOD_17_SET(x)
     #define BENCHMARK_MOD_17_RESET(x)
+    #define BENCHMARK_MOD_17_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_18)
-    #define BENCHMARK_MOD_18_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_18_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_18_SET(x)     BENCHMARK_MOD_SET(18, x)
+    #define BENCHMARK_MOD_18_RESET(x)   BENCHMARK_MOD_RESET(18, x)
+    #define BENCHMARK_MOD_18_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(18, x)
 #else
     #define BENCHMARK_MOD_18_SET(x)
     #define BENCHMARK_MOD_18_RESET(x)
+    #define BENCHMARK_MOD_18_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_19)
-    #define BENCHMARK_MOD_19_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_19_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_19_SET(x)     BENCHMARK_MOD_SET(19, x)
+    #define BENCHMARK_MOD_19_RESET(x)   BENCHMARK_MOD_RESET(19, x)
+    #define BENCHMARK_MOD_19_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(19, x)
 #else
     #define BENCHMARK_MOD_19_SET(x)
     #define BENCHMARK_MOD_19_RESET(x)
+    #define BENCHMARK_MOD_19_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_20)
-    #define BENCHMARK_MOD_20_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_20_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_20_SET(x)     BENCHMARK_MOD_SET(20, x)
+    #define BENCHMARK_MOD_20_RESET(x)   BENCHMARK_MOD_RESET(20, x)
+    #define BENCHMARK_MOD_20_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(20, x)
 #else
     #define BENCHMARK_MOD_20_SET(x)
     #define BENCHMARK_MOD_20_RESET(x)
+    #define BENCHMARK_MOD_20_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_21)
-    #define BENCHMARK_MOD_21_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_21_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_21_SET(x)     BENCHMARK_MOD_SET(21, x)
+    #define BENCHMARK_MOD_21_RESET(x)   BENCHMARK_MOD_RESET(21, x)
+    #define BENCHMARK_MOD_21_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(21, x)
 #else
     #define BENCHMARK_MOD_21_SET(x)
     #define BENCHMARK_MOD_21_RESET(x)
+    #define BENCHMARK_MOD_21_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_22)
-    #define BENCHMARK_MOD_22_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_22_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_22_SET(x)     BENCHMARK_MOD_SET(22, x)
+    #define BENCHMARK_MOD_22_RESET(x)   BENCHMARK_MOD_RESET(22, x)
+    #define BENCHMARK_MOD_22_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(22, x)
 #else
     #define BENCHMARK_MOD_22_SET(x)
     #define BENCHMARK_MOD_22_RESET(x)
+    #define BENCHMARK_MOD_22_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_23)
-    #define BENCHMARK_MOD_23_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_23_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_23_SET(x)     BENCHMARK_MOD_SET(23, x)
+    #define BENCHMARK_MOD_23_RESET(x)   BENCHMARK_MOD_RESET(23, x)
+    #define BENCHMARK_MOD_23_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(23, x)
 #else
     #define BENCHMARK_MOD_23_SET(x)
     #define BENCHMARK_MOD_23_RESET(x)
+    #define BENCHMARK_MOD_23_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_24)
-    #define BENCHMARK_MOD_24_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_24_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_24_SET(x)     BENCHMARK_MOD_SET(24, x)
+    #define BENCHMARK_MOD_24_RESET(x)   BENCHMARK_MOD_RESET(24, x)
+    #define BENCHMARK_MOD_24_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(24, x)
 #else
     #define BENCHMARK_MOD_24_SET(x)
     #define BENCHMARK_MOD_24_RESET(x)
+    #define BENCHMARK_MOD_24_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_25)
-    #define BENCHMARK_MOD_25_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_25_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_25_SET(x)     BENCHMARK_MOD_SET(25, x)
+    #define BENCHMARK_MOD_25_RESET(x)   BENCHMARK_MOD_RESET(25, x)
+    #define BENCHMARK_MOD_25_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(25, x)
 #else
     #define BENCHMARK_MOD_25_SET(x)
     #define BENCHMARK_MOD_25_RESET(x)
+    #define BENCHMARK_MOD_25_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_26)
-    #define BENCHMARK_MOD_26_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_26_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_26_SET(x)     BENCHMARK_MOD_SET(26, x)
+    #define BENCHMARK_MOD_26_RESET(x)   BENCHMARK_MOD_RESET(26, x)
+    #define BENCHMARK_MOD_26_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(26, x)
 #else
     #define BENCHMARK_MOD_26_SET(x)
     #define BENCHMARK_MOD_26_RESET(x)
+    #define BENCHMARK_MOD_26_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_27)
-    #define BENCHMARK_MOD_27_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_27_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_27_SET(x)     BENCHMARK_MOD_SET(27, x)
+    #define BENCHMARK_MOD_27_RESET(x)   BENCHMARK_MOD_RESET(27, x)
+    #define BENCHMARK_MOD_27_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(27, x)
 #else
     #define BENCHMARK_MOD_27_SET(x)
     #define BENCHMARK_MOD_27_RESET(x)
+    #define BENCHMARK_MOD_27_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_28)
-    #define BENCHMARK_MOD_28_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_28_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_28_SET(x)     BENCHMARK_MOD_SET(28, x)
+    #define BENCHMARK_MOD_28_RESET(x)   BENCHMARK_MOD_RESET(28, x)
+    #define BENCHMARK_MOD_28_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(28, x)
 #else
     #define BENCHMARK_MOD_28_SET(x)
     #define BENCHMARK_MOD_28_RESET(x)
+    #define BENCHMARK_MOD_28_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_29)
-    #define BENCHMARK_MOD_29_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_29_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_29_SET(x)     BENCHMARK_MOD_SET(29, x)
+    #define BENCHMARK_MOD_29_RESET(x)   BENCHMARK_MOD_RESET(29, x)
+    #define BENCHMARK_MOD_29_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(29, x)
 #else
     #define BENCHMARK_MOD_29_SET(x)
     #define BENCHMARK_MOD_29_RESET(x)
+    #define BENCHMARK_MOD_29_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_30)
-    #define BENCHMARK_MOD_30_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_30_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_30_SET(x)     BENCHMARK_MOD_SET(30, x)
+    #define BENCHMARK_MOD_30_RESET(x)   BENCHMARK_MOD_RESET(30, x)
+    #define BENCHMARK_MOD_30_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(30, x)
 #else
     #define BENCHMARK_MOD_30_SET(x)
     #define BENCHMARK_MOD_30_RESET(x)
+    #define BENCHMARK_MOD_30_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_31)
-    #define BENCHMARK_MOD_31_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_31_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_31_SET(x)     BENCHMARK_MOD_SET(31, x)
+    #define BENCHMARK_MOD_31_RESET(x)   BENCHMARK_MOD_RESET(31, x)
+    #define BENCHMARK_MOD_31_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(31, x)
 #else
     #define BENCHMARK_MOD_31_SET(x)
     #define BENCHMARK_MOD_31_RESET(x)
+    #define BENCHMARK_MOD_31_TOGGLE(x)
 #endif
 
 #if (BENCHMARK_MODULES & BENCHMARK_MOD_32)
-    #define BENCHMARK_MOD_32_SET(x)         BENCHMARK_SET(x)
-    #define BENCHMARK_MOD_32_RESET(x)       BENCHMARK_RESET(x)
+    #define BENCHMARK_MOD_32_SET(x)     BENCHMARK_MOD_SET(32, x)
+    #define BENCHMARK_MOD_32_RESET(x)   BENCHMARK_MOD_RESET(32, x)
+    #define BENCHMARK_MOD_32_TOGGLE(x)  BENCHMARK_MOD_TOGGLE(32, x)
 #else
     #define BENCHMARK_MOD_32_SET(x)
     #define BENCHMARK_MOD_32_RESET(x)
+    #define BENCHMARK_MOD_32_TOGGLE(x)
 #endif
 
 
@@ -367,9 +456,42 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /* typedef                                                                    */
 /*----------------------------------------------------------------------------*/
 
+#ifdef BENCHMARK_TRACE_ENABLED
+
+/**
+ * \brief Edge of a benchmark point
+ */
+typedef enum
+{
+    kBenchmarkEdgeReset  = 0x00,    /**< Benchmark point reset */
+    kBenchmarkEdgeSet    = 0x01,    /**< Benchmark point set */
+    kBenchmarkEdgeToggle = 0x02,    /**< Benchmark point toggled */
+} tBenchmarkEdge;
+
+/**
+ * \brief Trace event record in the RAM ring buffer
+ */
+typedef struct
+{
+    UINT32 timeStamp_m;     /**< Time stamp in ticks of BENCHMARK_TRACE_TICK_HZ */
+    UINT16 seq_m;           /**< Lower bits of the event number, written last */
+    UINT8  probe_m;         /**< Probe id (see BENCHMARK_TRACE_PROBE) */
+    UINT8  edge_m;          /**< Edge of type tBenchmarkEdge */
+} tBenchmarkTraceEvent;
+
+#endif /* #ifdef BENCHMARK_TRACE_ENABLED */
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
 
+#ifdef BENCHMARK_TRACE_ENABLED
+
+void benchmark_traceInit(void);
+void benchmark_traceEvent(UINT8 probe_p, UINT8 edge_p);
+UINT16 benchmark_traceDump(UINT16 maxEvents_p);
+
+#endif /* #ifdef BENCHMARK_TRACE_ENABLED */
+
 #endif /* _INC_common_benchmark_H_ */
 
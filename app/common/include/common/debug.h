@@ -7,6 +7,19 @@
 This header enables the printing of debug messages according to there debug
 level.
 
+DEBUG_LOG() is the variant for hot paths. If DEBUG_LOG_ENABLED is defined it
+only records the id of the format string and the raw arguments into a ring
+buffer (see common/debuglog.c). The format strings are placed in the section
+.dbglog which is not loaded to the target. The table of format strings is
+extracted from the ELF file and the dump is decoded on the host with
+contrib/scripts/debuglog.py. Without DEBUG_LOG_ENABLED, DEBUG_LOG() is the
+same as DEBUG_TRACE().
+
+DEBUG_LOG() is only available on the SN processors (demo-sn-gpio links
+common/debuglog.c). The cross communication has no traces in its frame path
+and the POWERLINK side of the slim interface (blackchannel/POWERLINK/pcp/psi)
+uses the debug.h of the PCP, so its traces are not converted.
+
 *******************************************************************************/
 
 /*------------------------------------------------------------------------------
@@ -312,12 +325,110 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #endif
 
+/* Deferred binary logging */
+#ifdef DEBUG_LOG_ENABLED
+
+    #include <apptarget/target.h>
+
+    /* Levels which are compiled in, can be reduced at runtime by debuglog_setLevel() */
+    #ifndef DEBUG_LOG_GLB_LVL
+        #define DEBUG_LOG_GLB_LVL               (DEBUG_GLB_LVL)
+    #endif
+
+    /* Number of records in the ring buffer of each context (power of two) */
+    #ifndef DEBUG_LOG_BUFFER_SIZE
+        #define DEBUG_LOG_BUFFER_SIZE           32
+    #endif
+
+    #if ((DEBUG_LOG_BUFFER_SIZE & (DEBUG_LOG_BUFFER_SIZE - 1)) != 0) || \
+        (DEBUG_LOG_BUFFER_SIZE > 0x4000)
+        #error "DEBUG_LOG_BUFFER_SIZE must be a power of two not larger than 0x4000!"
+    #endif
+
+    /* Maximum number of arguments of a DEBUG_LOG() call */
+    #ifndef DEBUG_LOG_ARG_MAX
+        #define DEBUG_LOG_ARG_MAX               4
+    #endif
+
+    /* Maximum number of records printed by one debuglog_dump() call */
+    #ifndef DEBUG_LOG_DUMP_MAX
+        #define DEBUG_LOG_DUMP_MAX              4
+    #endif
+
+    /* Output of the dump, also available in release builds */
+    #ifndef DEBUG_LOG_PRINT
+        #include <stdio.h>
+        #define DEBUG_LOG_PRINT(...)            printf(__VA_ARGS__)
+    #endif
+
+    #if defined(__GNUC__)
+        #define DEBUG_LOG_FMT_ATTR              __attribute__((section(".dbglog"), used))
+    #else
+        #define DEBUG_LOG_FMT_ATTR
+    #endif
+
+    /* Arguments are recorded as UINT32, the format string is never formatted
+     * on the target. Strings (%s) and 64 bit values are not supported. */
+    #define DEBUG_LOG(lvl, fmt, ...)                                                           \
+        do {                                                                                   \
+            if(((DEBUG_LOG_GLB_LVL) & (lvl)) && (debuglog_lvlMask_g & (lvl)))                  \
+            {                                                                                  \
+                static const char DEBUG_LOG_FMT_ATTR debugLogFmt[] = fmt;                      \
+                const UINT32 debugLogArg[] = { 0, ##__VA_ARGS__ };                             \
+                (void)sizeof(char[(sizeof(debugLogArg) <=                                      \
+                                   ((DEBUG_LOG_ARG_MAX + 1) * sizeof(UINT32))) ? 1 : -1]);     \
+                debuglog_write((UINT32)(size_t)debugLogFmt,                                    \
+                               (UINT8)((sizeof(debugLogArg) / sizeof(UINT32)) - 1),            \
+                               &debugLogArg[1]);                                               \
+            }                                                                                  \
+        } while(0)
+
+    #define DEBUG_LOG_INIT()                    debuglog_init()
+    #define DEBUG_LOG_DUMP()                    (void)debuglog_dump(DEBUG_LOG_DUMP_MAX)
+#else
+    #if !defined (NDEBUG)
+        #define DEBUG_LOG(lvl,...)              lvl##_TRACE(__VA_ARGS__)
+    #else
+        #define DEBUG_LOG(lvl,...)
+    #endif
+
+    #define DEBUG_LOG_INIT()
+    #define DEBUG_LOG_DUMP()
+#endif
+
 /*----------------------------------------------------------------------------*/
 /* typedef                                                                    */
 /*----------------------------------------------------------------------------*/
 
+#ifdef DEBUG_LOG_ENABLED
+
+/**
+ * \brief Record of the deferred debug log
+ */
+typedef struct
+{
+    UINT32 fmtId_m;                         /**< Address of the format string in section .dbglog */
+    UINT16 seq_m;                           /**< Lower bits of the record number, written last */
+    UINT8  argCnt_m;                        /**< Number of valid arguments */
+    UINT8  reserved_m;                      /**< Reserved */
+    UINT32 aArg_m[DEBUG_LOG_ARG_MAX];       /**< Raw arguments */
+} tDebugLogRecord;
+
+#endif /* #ifdef DEBUG_LOG_ENABLED */
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
 
+#ifdef DEBUG_LOG_ENABLED
+
+extern volatile UINT32 debuglog_lvlMask_g;
+
+void debuglog_init(void);
+void debuglog_setLevel(UINT32 lvlMask_p);
+void debuglog_write(UINT32 fmtId_p, UINT8 argCnt_p, const UINT32* pArg_p);
+UINT16 debuglog_dump(UINT16 maxRecords_p);
+
+#endif /* #ifdef DEBUG_LOG_ENABLED */
+
 #endif /* _INC_app_common_debug_H_ */
@@ -7,6 +7,18 @@
 Implements the interface to the serial which provides the connection to the
 POWERLINK communication processor (PCP).
 
+The transfer is split into three parts. pcpserial_transfer() only starts the
+transfer and returns immediately. The transfer finished callback is called from
+the transfer complete event (e.g. the DMA interrupt) and carries out the post
+transfer actions. The transfer error callback is called if the hardware reports
+an error or if the transfer is not finished within PCPSERIAL_TIMEOUT_CYCLES
+calls of pcpserial_transfer().
+
+A start which overlaps the running transfer is skipped. This is not an error,
+pcpserial_transfer() returns TRUE and the images of the cycle are not
+exchanged. The skipped starts and the timeouts are counted in the statistics
+(pcpserial_getStatistics()).
+
 *******************************************************************************/
 
 /*------------------------------------------------------------------------------
@@ -47,23 +59,54 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
+#ifndef PCPSERIAL_TIMEOUT_CYCLES
+  /** Number of transfer starts a running transfer may overlap before it is aborted */
+  #define PCPSERIAL_TIMEOUT_CYCLES      2
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* typedef                                                                    */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * \brief Serial transfer errors
+ */
+typedef enum
+{
+    kPcpSerialErrorTransfer     = 0x01,     /**< The serial device reported an error */
+    kPcpSerialErrorTimeout      = 0x02,     /**< The transfer was not finished in time and is aborted */
+    kPcpSerialErrorRestart      = 0x03,     /**< Unable to restart the transfer after completion */
+} tPcpSerialError;
+
 /**
  * \brief Transfer finished interrupt type
  */
-typedef void (*tPcpSerialTransferFin)(BOOL fError_p);
+typedef void (*tPcpSerialTransferFin)(void);
+
+/**
+ * \brief Transfer error or timeout interrupt type
+ */
+typedef void (*tPcpSerialTransferErr)(tPcpSerialError error_p);
+
+/**
+ * \brief Transfer statistics
+ */
+typedef struct
+{
+    UINT32  skipCnt_m;          /**< Transfer starts skipped due to a running transfer */
+    UINT32  timeoutCnt_m;       /**< Transfers aborted after PCPSERIAL_TIMEOUT_CYCLES skipped starts */
+} tPcpSerialStat;
 
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
-BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p);
+BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p,
+                    tPcpSerialTransferErr pfnTransfErr_p);
 void pcpserial_exit(void);
 
 BOOL pcpserial_transfer(tHandlerParam* pHandlParam_p);
+BOOL pcpserial_isBusy(void);
+void pcpserial_getStatistics(tPcpSerialStat* pStat_p);
 
 #endif /* _INC_common_pcpserial_H_ */
 
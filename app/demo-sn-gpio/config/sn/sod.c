@@ -316,8 +316,8 @@ SOD_cfg_TO_RAM_ROM SOD_t_OBJECT SAPL_s_OD_INST_0[]=
 
     /* Life Guarding */
     {0x100C, 0x00, {CONS , U8 , 0x1UL, &b_noE_2}, &b_noE_2 , NULL , SOD_k_NO_CALLBACK},
-    {0x100C, 0x01, {RW | CRC , U32, 0x4UL, &dw_0_def_100C_01 }, &s_0_act_general.lifeGuard.ulGuardTime , NULL , SOD_k_NO_CALLBACK},
-    {0x100C, 0x02, {RW | CRC , U8 , 0x1UL, &b_0_def_100C_02 }, &s_0_act_general.lifeGuard.ucLifeTimeFactor , &s_rg_b_1_255 , SOD_k_NO_CALLBACK},
+    {0x100C, 0x01, {RW | CRC | AFT_WR , U32, 0x4UL, &dw_0_def_100C_01 }, &s_0_act_general.lifeGuard.ulGuardTime , NULL , SAPL_SOD_ParamCrc_CLBK},
+    {0x100C, 0x02, {RW | CRC | AFT_WR , U8 , 0x1UL, &b_0_def_100C_02 }, &s_0_act_general.lifeGuard.ucLifeTimeFactor , &s_rg_b_1_255 , SAPL_SOD_ParamCrc_CLBK},
 
     /* Pre-Operational signal */
     {0x100D, 0x00, {RW , U32, 0x4UL, &dw_0_def_100D_00 }, &s_0_act_general.numRetriesRG.ulRefreshPreOp , NULL , SOD_k_NO_CALLBACK},
@@ -343,45 +343,45 @@ SOD_cfg_TO_RAM_ROM SOD_t_OBJECT SAPL_s_OD_INST_0[]=
     {0x1200, 0x00, {CONS , U8 , 0x1UL, &b_noE_4 }, &b_noE_4 , NULL , SOD_k_NO_CALLBACK},
     {0x1200, 0x01, {RO , U16, 0x2UL, &w_0_def_1200_01 }, &s_0_act_general.commonComParam.usSdn, &s_rg_w_0_1023, SOD_k_NO_CALLBACK},
     {0x1200, 0x02, {RO , U16, 0x2UL, &w_0_def_1200_02 }, &s_0_act_general.commonComParam.usSadrOfScm, &s_rg_w_0_1023, SOD_k_NO_CALLBACK},
-    {0x1200, 0x03, {RW | CRC | AFT_WR , I8 , 0x1UL, &c_0_def_1200_03 }, &s_0_act_general.commonComParam.cCtb, &s_rg_b_0_3, SHNF_SOD_ConsTimeBase_CLBK},
+    {0x1200, 0x03, {RW | CRC | AFT_WR , I8 , 0x1UL, &c_0_def_1200_03 }, &s_0_act_general.commonComParam.cCtb, &s_rg_b_0_3, SAPL_SOD_ConsTimeBase_CLBK},
     {0x1200, 0x04, {RW , OCT , EPLS_k_UDID_LEN, ab_0_def_1200_04}, &s_0_act_1200_04, NULL, SOD_k_NO_CALLBACK},
 
     /* RxSPDO communication parameters */
     {0x1400, 0x00, {CONS , U8 , 0x1UL, &b_noE_12 }, &b_noE_12 , NULL , NULL},
-    {0x1400, 0x01, {RW | CRC , U16, 0x2UL, &w_0_def_1400_01 }, &s_0_act_general.aRxComParam[0].usSadr, &s_rg_w_0_1023, NULL},
-    {0x1400, 0x02, {RW | CRC , U32, 0x4UL, &dw_0_def_1400_02 }, &s_0_act_general.aRxComParam[0].ulSct, &s_rg_dw_1_65535, NULL},
-    {0x1400, 0x03, {RW | CRC , U8 , 0x1UL, &b_0_def_1400_03 }, &s_0_act_general.aRxComParam[0].ucNoConsecTReq, &s_rg_b_1_63, NULL},
-    {0x1400, 0x04, {RW | CRC , U32, 0x4UL, &dw_0_def_1400_04 }, &s_0_act_general.aRxComParam[0].ulTimeDelayTReq, NULL, NULL},
-    {0x1400, 0x05, {RW | CRC , U32, 0x4UL, &dw_0_def_1400_05 }, &s_0_act_general.aRxComParam[0].ulTimeDelaySync, NULL, NULL},
-    {0x1400, 0x06, {RW | CRC , U16, 0x2UL, &w_0_def_1400_06 }, &s_0_act_general.aRxComParam[0].usMinTSyncPropDelay, &PROP_DELAY_RANGE, NULL},
-    {0x1400, 0x07, {RW | CRC , U16, 0x2UL, &w_0_def_1400_07 }, &s_0_act_general.aRxComParam[0].usMaxTSyncPropDelay, &s_rg_w_1_65535, NULL},
-    {0x1400, 0x08, {RW | CRC , U16, 0x2UL, &w_0_def_1400_08 }, &s_0_act_general.aRxComParam[0].usMinSpdoPropDelay, &PROP_DELAY_RANGE, NULL},
-    {0x1400, 0x09, {RW | CRC , U16, 0x2UL, &w_0_def_1400_09 }, &s_0_act_general.aRxComParam[0].usMaxSpdoPropDelay, &s_rg_w_1_65535, NULL},
-    {0x1400, 0x0A, {RW | CRC , U16, 0x2UL, &w_0_def_1400_0A }, &s_0_act_general.aRxComParam[0].usBestCaseTresDelay, &s_rg_w_0_65535, NULL},
-    {0x1400, 0x0B, {RW | CRC , U32, 0x4UL, &dw_0_def_1400_0B }, &s_0_act_general.aRxComParam[0].ulTReqCycle, NULL, NULL},
-    {0x1400, 0x0C, {RW | CRC , U16, 0x2UL, &w_0_def_1400_0C }, &s_0_act_general.aRxComParam[0].usTxSpdoNo, &s_rg_w_1_1023, NULL},
+    {0x1400, 0x01, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_01 }, &s_0_act_general.aRxComParam[0].usSadr, &s_rg_w_0_1023, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x02, {RW | CRC | AFT_WR , U32, 0x4UL, &dw_0_def_1400_02 }, &s_0_act_general.aRxComParam[0].ulSct, &s_rg_dw_1_65535, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x03, {RW | CRC | AFT_WR , U8 , 0x1UL, &b_0_def_1400_03 }, &s_0_act_general.aRxComParam[0].ucNoConsecTReq, &s_rg_b_1_63, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x04, {RW | CRC | AFT_WR , U32, 0x4UL, &dw_0_def_1400_04 }, &s_0_act_general.aRxComParam[0].ulTimeDelayTReq, NULL, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x05, {RW | CRC | AFT_WR , U32, 0x4UL, &dw_0_def_1400_05 }, &s_0_act_general.aRxComParam[0].ulTimeDelaySync, NULL, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x06, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_06 }, &s_0_act_general.aRxComParam[0].usMinTSyncPropDelay, &PROP_DELAY_RANGE, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x07, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_07 }, &s_0_act_general.aRxComParam[0].usMaxTSyncPropDelay, &s_rg_w_1_65535, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x08, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_08 }, &s_0_act_general.aRxComParam[0].usMinSpdoPropDelay, &PROP_DELAY_RANGE, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x09, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_09 }, &s_0_act_general.aRxComParam[0].usMaxSpdoPropDelay, &s_rg_w_1_65535, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x0A, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_0A }, &s_0_act_general.aRxComParam[0].usBestCaseTresDelay, &s_rg_w_0_65535, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x0B, {RW | CRC | AFT_WR , U32, 0x4UL, &dw_0_def_1400_0B }, &s_0_act_general.aRxComParam[0].ulTReqCycle, NULL, SAPL_SOD_ParamCrc_CLBK},
+    {0x1400, 0x0C, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1400_0C }, &s_0_act_general.aRxComParam[0].usTxSpdoNo, &s_rg_w_1_1023, SAPL_SOD_ParamCrc_CLBK},
 
 
     /* RxSPDO mapping Parameter */
-    {0x1800, 0x00, {RW | CRC | BEF_WR, U8, 0x1UL, &b_0_def_1800_00}, &s_0_act_general.aRxMapParam[0].ucNoMappingEntries, &s_rg_b_0_4, SPDO_SOD_RxMappPara_CLBK},
-    {0x1800, 0x01, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[0], NULL, SPDO_SOD_RxMappPara_CLBK},
-    {0x1800, 0x02, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[1], NULL, SPDO_SOD_RxMappPara_CLBK},
-    {0x1800, 0x03, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[2], NULL, SPDO_SOD_RxMappPara_CLBK},
-    {0x1800, 0x04, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[3], NULL, SPDO_SOD_RxMappPara_CLBK},
+    {0x1800, 0x00, {RW | CRC | BEF_WR | AFT_WR, U8, 0x1UL, &b_0_def_1800_00}, &s_0_act_general.aRxMapParam[0].ucNoMappingEntries, &s_rg_b_0_4, SAPL_SOD_RxMappPara_CLBK},
+    {0x1800, 0x01, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[0], NULL, SAPL_SOD_RxMappPara_CLBK},
+    {0x1800, 0x02, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[1], NULL, SAPL_SOD_RxMappPara_CLBK},
+    {0x1800, 0x03, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[2], NULL, SAPL_SOD_RxMappPara_CLBK},
+    {0x1800, 0x04, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_1800_01}, &s_0_act_general.aRxMapParam[0].aulMappingEntry[3], NULL, SAPL_SOD_RxMappPara_CLBK},
 
     /* TxSPDO communication parameters */
     {0x1C00, 0x00, {CONS , U8 , 0x1UL, &b_noE_3 }, &b_noE_3 , NULL , SOD_k_NO_CALLBACK},
-    {0x1C00, 0x01, {RW | CRC , U16, 0x2UL, &w_0_def_1C00_01 }, &s_0_act_general.aTxComParam[0].usSadr , &s_rg_w_0_1023 , SOD_k_NO_CALLBACK},
-    {0x1C00, 0x02, {RW | CRC , U16, 0x2UL, &w_0_def_1C00_02 }, &s_0_act_general.aTxComParam[0].usRefreshPrescale , &s_rg_w_1_32767 , SOD_k_NO_CALLBACK},
-    {0x1C00, 0x03, {RW | CRC , U8 , 0x1UL, &b_0_def_1C00_03 }, &s_0_act_general.aTxComParam[0].ucNoTRes , NULL , SOD_k_NO_CALLBACK},
+    {0x1C00, 0x01, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1C00_01 }, &s_0_act_general.aTxComParam[0].usSadr , &s_rg_w_0_1023 , SAPL_SOD_ParamCrc_CLBK},
+    {0x1C00, 0x02, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_1C00_02 }, &s_0_act_general.aTxComParam[0].usRefreshPrescale , &s_rg_w_1_32767 , SAPL_SOD_ParamCrc_CLBK},
+    {0x1C00, 0x03, {RW | CRC | AFT_WR , U8 , 0x1UL, &b_0_def_1C00_03 }, &s_0_act_general.aTxComParam[0].ucNoTRes , NULL , SAPL_SOD_ParamCrc_CLBK},
 
     /* vendor/module specific data */
-    {0x2001, 0x00, {RW | CRC , DOM, sizeof(tUsedChannels), NULL }, &SOD_UsedChannels, NULL, SOD_k_NO_CALLBACK},
+    {0x2001, 0x00, {RW | CRC | AFT_WR , DOM, sizeof(tUsedChannels), NULL }, &SOD_UsedChannels, NULL, SAPL_SOD_ParamCrc_CLBK},
 
     {0x4000, 0x00, {CONS, U8, 0x1UL, &b_noE_3}, &b_noE_3, NULL, SOD_k_NO_CALLBACK},
-    {0x4000, 0x01, {RW | CRC , U32, 0x4UL, &dw_0_def_4000_01}, &manSettings.DefaultSetting01, NULL, SOD_k_NO_CALLBACK},
-    {0x4000, 0x02, {RW | CRC , U16, 0x2UL, &w_0_def_4000_02}, &manSettings.DefaultSetting02, NULL, SOD_k_NO_CALLBACK},
-    {0x4000, 0x03, {RW | CRC , U16, 0x2UL, &w_0_def_4000_03}, &manSettings.DefaultSetting03, NULL, SOD_k_NO_CALLBACK},
+    {0x4000, 0x01, {RW | CRC | AFT_WR , U32, 0x4UL, &dw_0_def_4000_01}, &manSettings.DefaultSetting01, NULL, SAPL_SOD_ParamCrc_CLBK},
+    {0x4000, 0x02, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_4000_02}, &manSettings.DefaultSetting02, NULL, SAPL_SOD_ParamCrc_CLBK},
+    {0x4000, 0x03, {RW | CRC | AFT_WR , U16, 0x2UL, &w_0_def_4000_03}, &manSettings.DefaultSetting03, NULL, SAPL_SOD_ParamCrc_CLBK},
 
 
     /* Input data */
@@ -399,11 +399,11 @@ SOD_cfg_TO_RAM_ROM SOD_t_OBJECT SAPL_s_OD_INST_0[]=
     {0x6200, 0x04, {RW    | PDO, U8, 0x1UL, &b_0_def_6200_04}, &traspSafeOUT_g.SafeOutput04, NULL, SOD_k_NO_CALLBACK},
 
     /* TxSPDO mapping Parameter */
-    {0xC000, 0x00, {RW | CRC | BEF_WR, U8, 0x1UL, &b_0_def_C000_00}, &s_0_act_general.aTxMapParam[0].ucNoMappingEntries, &s_rg_b_0_4, SPDO_SOD_TxMappPara_CLBK},
-    {0xC000, 0x01, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[0], NULL, SPDO_SOD_TxMappPara_CLBK},
-    {0xC000, 0x02, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[1], NULL, SPDO_SOD_TxMappPara_CLBK},
-    {0xC000, 0x03, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[2], NULL, SPDO_SOD_TxMappPara_CLBK},
-    {0xC000, 0x04, {RW | CRC | BEF_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[3], NULL, SPDO_SOD_TxMappPara_CLBK},
+    {0xC000, 0x00, {RW | CRC | BEF_WR | AFT_WR, U8, 0x1UL, &b_0_def_C000_00}, &s_0_act_general.aTxMapParam[0].ucNoMappingEntries, &s_rg_b_0_4, SAPL_SOD_TxMappPara_CLBK},
+    {0xC000, 0x01, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[0], NULL, SAPL_SOD_TxMappPara_CLBK},
+    {0xC000, 0x02, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[1], NULL, SAPL_SOD_TxMappPara_CLBK},
+    {0xC000, 0x03, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[2], NULL, SAPL_SOD_TxMappPara_CLBK},
+    {0xC000, 0x04, {RW | CRC | BEF_WR | AFT_WR, U32, 0x4UL, &dw_0_def_C000_01}, &s_0_act_general.aTxMapParam[0].aulMappingEntry[3], NULL, SAPL_SOD_TxMappPara_CLBK},
 
     /* end of SOD */
     {SOD_k_END_OF_THE_OD, 0xFF, {0, EPLS_k_BOOLEAN, 0x1UL, 0}, NULL, NULL, SOD_k_NO_CALLBACK}
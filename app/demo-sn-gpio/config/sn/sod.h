@@ -257,6 +257,30 @@ extern BOOLEAN SHNF_SOD_ConsTimeBase_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
                                           UINT32 org_dw_offset, UINT32 org_dw_size,
                                           SOD_t_ABORT_CODES *pe_abortCode);
 
+extern BOOLEAN SAPL_SOD_ParamCrc_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                      const SOD_t_OBJECT *ps_obj,
+                                      const void *pv_data,
+                                      UINT32 org_dw_offset, UINT32 org_dw_size,
+                                      SOD_t_ABORT_CODES *pe_abortCode);
+
+extern BOOLEAN SAPL_SOD_ConsTimeBase_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                          const SOD_t_OBJECT *ps_obj,
+                                          const void *pv_data,
+                                          UINT32 org_dw_offset, UINT32 org_dw_size,
+                                          SOD_t_ABORT_CODES *pe_abortCode);
+
+extern BOOLEAN SAPL_SOD_RxMappPara_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                        const SOD_t_OBJECT *ps_obj,
+                                        const void *pv_data,
+                                        UINT32 org_dw_offset, UINT32 org_dw_size,
+                                        SOD_t_ABORT_CODES *pe_abortCode);
+
+extern BOOLEAN SAPL_SOD_TxMappPara_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                        const SOD_t_OBJECT *ps_obj,
+                                        const void *pv_data,
+                                        UINT32 org_dw_offset, UINT32 org_dw_size,
+                                        SOD_t_ABORT_CODES *pe_abortCode);
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
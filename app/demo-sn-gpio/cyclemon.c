@@ -231,6 +231,37 @@ BOOLEAN cyclemon_checkTimeout(void)
     return fTimeout;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the measured cycle time
+
+\return The cycle time in us; Zero if the cycle monitoring is not active
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 cyclemon_getCycleTime(void)
+{
+    UINT32 cycleTime = 0;
+
+    if(cycMonInstance_l.cycMonState_m == kCycleMonStateActive)
+    {
+        cycleTime = cycMonInstance_l.cycleTime_m;
+    }
+
+    return cycleTime;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the start of the current cycle
+
+\return The time base in us of the last sync interrupt
+*/
+/*----------------------------------------------------------------------------*/
+UINT64 cyclemon_getCycleStart(void)
+{
+    return cycMonInstance_l.lastTimeStamp_m;
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -76,6 +76,9 @@ void cyclemon_exit(void);
 BOOLEAN cyclemon_process(void);
 BOOLEAN cyclemon_checkTimeout(void);
 
+UINT32 cyclemon_getCycleTime(void);
+UINT64 cyclemon_getCycleStart(void);
+
 #ifdef __cplusplus
     }
 #endif
@@ -65,6 +65,7 @@ typedef enum
     kErrorUnableToGenerateStreamParams      = 0x06,     /**< Unable to generate parameters for the stream interface */
     kErrorInitConsTimeFailed                = 0x07,     /**< Unable to init the consecutive timebase */
     kErrorInitApplicationFailed             = 0x08,     /**< Unable to init the application module */
+    kErrorCrcEngineSelfTestFailed           = 0x09,     /**< A CRC implementation differs from the reference */
 
     kErrorSyncProcessFailed                 = 0x20,     /**< Processing the synchronous task has failed */
     kErrorSyncProcessActionFailed           = 0x21,     /**< Processing the post action has failed */
@@ -102,6 +103,7 @@ typedef enum
     kErrorInvalidCrcValue                   = 0x73,     /**< The CRC returned an invalid value */
     kErrorInvalidMsgFormatValue             = 0x74,     /**< Failed to retrieve message format field */
     kErrorInvalidCycleTime                  = 0x75,     /**< The measured cycle time is out of the valid range */
+    kErrorTaskDeadlineMissed                = 0x76,     /**< The tasks of the synchronous cycle finished after the end of the cycle */
 
     kErrorSerialInitFailed                  = 0x80,     /**< Unable to initialize the serial device */
     kErrorSerialTransferFailed              = 0x81,     /**< Error during the serial transfer */
@@ -121,6 +123,9 @@ typedef enum
     kXComSpdoCrcMissmatch                   = 0xA4,     /**< The SPDO CRC is different on uP-Master and uP-Slave */
     kXComSsdoSnmtCrcMissmatch               = 0xA5,     /**< The SSDO/SNMT CRC is different on uP-Master and uP-Slave */
     kXComFrameMissing                       = 0xA6,     /**< A frame was produced on the remote processor but locally non is available */
+    kXComFrameLengthInvalid                 = 0xA7,     /**< The length of the received compact frame is not valid */
+    kXComProcessingOverrun                  = 0xA8,     /**< A frame is still waiting for processing at the next sync or the next frame */
+    kXComProcessDeadlineMissed              = 0xA9,     /**< The processing of the received frame did not finish before the next cycle */
 
     kErrorStatusModuleInitFailed            = 0xB0,     /**< Unable to initialize the PSI status module */
     kErrorPdoModuleInitFailed               = 0xB1,     /**< Unable to initialize the PSI pdo module */
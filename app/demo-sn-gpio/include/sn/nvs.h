@@ -54,6 +54,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // typedef
 //------------------------------------------------------------------------------
 
+/**
+ * \brief Programming characteristics of the non volatile storage
+ */
+typedef struct
+{
+    UINT16 progGranularity_m;   /**< Smallest number of bytes which is programmed in one access */
+    UINT16 pageSize_m;          /**< Size of a program page in bytes (A burst should not cross a page) */
+    UINT32 pageProgTime_m;      /**< Nominal time in us to program a full page */
+    UINT32 sectorSize_m;        /**< Size of an erase sector in bytes */
+    UINT32 storageSize_m;       /**< Size of the storage in bytes (Multiple of the sector size) */
+} tNvsGeometry;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -67,6 +79,8 @@ BOOLEAN nvs_erase(UINT32 offset_p);
 
 UINT8* nvs_getAddress(UINT32 offset_p);
 
+void nvs_getGeometry(tNvsGeometry * pGeometry_p);
+
 #endif /* _INC_sn_nvs_H_ */
 
 
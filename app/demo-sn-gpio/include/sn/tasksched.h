@@ -0,0 +1,134 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/include/sn/tasksched.h
+
+\brief  Task scheduler of the end of the synchronous cycle
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_sn_tasksched_H_
+#define _INC_sn_tasksched_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/global.h>
+
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#ifndef TASKSCHED_MAX_TASKS
+  #define TASKSCHED_MAX_TASKS           4       /**< Maximum number of scheduled tasks */
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Type of a scheduled task
+ */
+typedef BOOLEAN (*tTaskSchedFunc)(void);
+
+/**
+ * \brief Type of the function which reports further work of a task
+ */
+typedef BOOLEAN (*tTaskSchedPending)(void);
+
+/**
+ * \brief Type of the microsecond time base of the scheduler
+ */
+typedef UINT32 (*tTaskSchedGetTime)(void);
+
+/**
+ * \brief Description of a scheduled task
+ */
+typedef struct
+{
+    tTaskSchedFunc pfnTask_m;           /**< Task function (Returns FALSE on error) */
+    tTaskSchedPending pfnPending_m;     /**< Reports work for another run in the same cycle (NULL: Task runs once per cycle) */
+} tTaskSchedTask;
+
+/**
+ * \brief Task scheduler initialization parameters
+ */
+typedef struct
+{
+    const tTaskSchedTask * pTasks_m;    /**< Table of the tasks in the order of the rotation */
+    UINT8 taskCount_m;                  /**< Number of tasks in the table */
+    tTaskSchedGetTime pfnGetTime_m;     /**< Microsecond time base */
+} tTaskSchedInit;
+
+/**
+ * \brief Statistics of one task (Times in us)
+ */
+typedef struct
+{
+    UINT32 runCnt_m;            /**< Number of runs */
+    UINT32 skipCnt_m;           /**< Cycles the task did not fit into the remaining budget */
+    UINT32 costEst_m;           /**< Estimated execution time used for the budget */
+    UINT32 execTimeMax_m;       /**< Maximum measured execution time */
+    UINT32 execTimeSum_m;       /**< Sum of all measured execution times */
+} tTaskSchedTaskStat;
+
+/**
+ * \brief Statistics of the task scheduler (Times in us)
+ */
+typedef struct
+{
+    UINT32 cycleCnt_m;              /**< Number of scheduled cycles */
+    UINT32 budgetOverrunCnt_m;      /**< Cycles the tasks finished after the end of the budget */
+    UINT32 deadlineMissCnt_m;       /**< Cycles the tasks finished after the end of the cycle */
+    UINT32 idleTimeSum_m;           /**< Sum of the budget left unused */
+    UINT16 runsPerCycleMax_m;       /**< Maximum number of task runs in one cycle */
+    tTaskSchedTaskStat task_m[TASKSCHED_MAX_TASKS];     /**< Statistics of each task */
+} tTaskSchedStatistics;
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+BOOLEAN tasksched_init(const tTaskSchedInit * pInitParam_p);
+void tasksched_exit(void);
+
+BOOLEAN tasksched_process(UINT32 cycleStart_p, UINT32 cycleTime_p);
+void tasksched_getStatistics(tTaskSchedStatistics * pStat_p);
+
+#ifdef __cplusplus
+    }
+#endif
+
+
+#endif /* _INC_sn_tasksched_H_ */
@@ -53,14 +53,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // typedef
 //------------------------------------------------------------------------------
 
+/**
+ * \brief Callback of the counter wrap interrupt
+ */
+typedef void (*tTimerWrapCb)(void);
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
 BOOLEAN timer_init(void);
 void timer_close(void);
 
-UINT16 timer_getTickCount(void);
-void timer_setTickCount(UINT16 newVal_p);
+UINT32 timer_getTickCount(void);
+void timer_setTickCount(UINT32 newVal_p);
+UINT8 timer_getTickWidth(void);
+
+BOOLEAN timer_registerWrapCb(tTimerWrapCb pfnWrapCb_p);
+BOOLEAN timer_isWrapPending(void);
 
 #endif /* _INC_sn_timer_H_ */
 
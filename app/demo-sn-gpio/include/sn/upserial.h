@@ -82,6 +82,8 @@ BOOLEAN upserial_receiveBlock(volatile UINT8 * pData_p, UINT32 size_p, UINT32 ti
 BOOLEAN upserial_transmitBlock(volatile UINT8 * pData_p, UINT32 size_p);
 
 BOOLEAN upserial_enableReceive(volatile UINT8 * pData_p, UINT32 size_p);
+BOOLEAN upserial_enableReceiveVarLen(volatile UINT8 * pData_p, UINT32 maxSize_p);
+UINT32 upserial_getReceivedSize(void);
 BOOLEAN upserial_transmit(volatile UINT8 * pData_p, UINT32 size_p);
 
 #endif /* _INC_sn_upserial_H_ */
@@ -53,9 +53,11 @@ stack and processes the background task.
 
 #include <sn/global.h>
 #include <sn/cyclemon.h>
+#include <sn/tasksched.h>
 #include <sn/statehandler.h>
 
 #include <common/platform.h>
+#include <common/benchmark.h>
 
 #include <shnf/shnf.h>
 #include <sapl/sapl.h>
@@ -102,24 +104,20 @@ stack and processes the background task.
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
 
-/**
- * \brief Slots to process in the synchronous IR
- */
-typedef enum
-{
-    kSyncTaskInvalid  = 0x0,    /**< Invalid state */
-    kSyncTaskShnf     = 0x1,    /**< The SHNF task is processed in this slot */
-    kSyncTaskSapl     = 0x2,    /**< The SAPL task is processed in this slot */
-    kSyncTaskState    = 0x3,    /**< State changes are processed in this slot */
-    kSyncTaskCount    = 0x4,    /**< Count of states */
-} tProcSyncTask;
-
-static tProcSyncTask syncTaskState_l;     /**< The current state of the sync task */
-
 /*----------------------------------------------------------------------------*/
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * \brief Tasks processed at the end of the synchronous IR
+ */
+static const tTaskSchedTask syncTasks_l[] =
+{
+    { shnf_process,             shnf_isRxPending },     /* Asynchronous task of the SHNF (Again while SSDO/SNMT frames are queued) */
+    { sapl_processSync,         NULL },                 /* Asynchronous task of the SAPL */
+    { stateh_handleStateChange, NULL },                 /* Internal state changes */
+};
+
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
@@ -134,6 +132,7 @@ static BOOLEAN processSync(void);
 static BOOLEAN syncCycle(void);
 
 static BOOLEAN processTaskSchedule(void);
+static UINT32 getSchedTime(void);
 
 static void enterReset(void);
 static void shutdown(void);
@@ -159,15 +158,23 @@ int main (void)
 {
     int retVal = -1;
     tShnfInitParam shnfInitParam;
+    tTaskSchedInit taskSchedInitParam;
 
     MEMSET(&shnfInitParam, 0, sizeof(tShnfInitParam));
+    MEMSET(&taskSchedInitParam, 0, sizeof(tTaskSchedInit));
 
-    /* Set initial sync task state */
-    syncTaskState_l = kSyncTaskShnf;
+    /* Set the tasks of the end of cycle scheduler */
+    taskSchedInitParam.pTasks_m = syncTasks_l;
+    taskSchedInitParam.taskCount_m = (UINT8)(sizeof(syncTasks_l) / sizeof(syncTasks_l[0]));
+    taskSchedInitParam.pfnGetTime_m = getSchedTime;
 
     /* Initialize target specific functions */
     platform_init();
 
+    /* Start the benchmark trace and the deferred debug log (if enabled) */
+    BENCHMARK_TRACE_INIT();
+    DEBUG_LOG_INIT();
+
     DEBUG_TRACE(DEBUG_LVL_ALWAYS, "\n\n********************************************************************\n");
     DEBUG_TRACE(DEBUG_LVL_ALWAYS, "\n\topenSAFETY SafetyNode Demo V%s \n\n ", OS_DEMO_VERSION);
     DEBUG_TRACE(DEBUG_LVL_ALWAYS, "\tStack version: \t\t%s\n", EPLS_k_STACK_VERSION );
@@ -186,8 +193,8 @@ int main (void)
             /* Initialize the consecutive time module */
             if(constime_init())
             {
-                /* Initialize the cycle monitoring module */
-                if(cyclemon_init())
+                /* Initialize the cycle monitoring and the task scheduler */
+                if(cyclemon_init() && tasksched_init(&taskSchedInitParam))
                 {
                     /* Initialize the SHNF module */
                     shnfInitParam.pfnSyncronize_m = syncCycle;
@@ -391,6 +398,11 @@ static BOOLEAN processAsync(void)
             break;
         }
 
+#if (defined SYSTEM_PATH) && (SYSTEM_PATH > ID_TARG_SINGLE)
+        /* Process the received cross communication frame with priority */
+        xcom_process();
+#endif /* #if (defined SYSTEM_PATH) && (SYSTEM_PATH > ID_TARG_SINGLE) */
+
         /* Periodically process the asynchronous task of the SAPL */
         if(sapl_process() == FALSE)
         {
@@ -398,6 +410,11 @@ static BOOLEAN processAsync(void)
             break;
         }
 
+#if (defined SYSTEM_PATH) && (SYSTEM_PATH > ID_TARG_SINGLE)
+        /* Check again as the frame may have arrived during the SAPL task */
+        xcom_process();
+#endif /* #if (defined SYSTEM_PATH) && (SYSTEM_PATH > ID_TARG_SINGLE) */
+
         /* Check if the cycle monitoring has a timeout */
         fTimeout = cyclemon_checkTimeout();
         if(fTimeout == TRUE)
@@ -405,6 +422,11 @@ static BOOLEAN processAsync(void)
             enterReset();
         }
 
+        /* Print at most BENCHMARK_TRACE_DUMP_MAX recorded benchmark events (if enabled) */
+        BENCHMARK_TRACE_DUMP();
+
+        /* Print at most DEBUG_LOG_DUMP_MAX recorded log records (if enabled) */
+        DEBUG_LOG_DUMP();
     }
 
     return fReturn;
@@ -491,8 +513,9 @@ static BOOLEAN syncCycle(void)
 \brief    Process the end of cycle task scheduler
 
 Process all openSAFETY stack tasks which would be possible to be called in the
-background loop at the end of the synchronous task. In order to reduce the cycle
-time this tasks are multiplexed over multiple cycles.
+background loop at the end of the synchronous task. The scheduler runs as many
+tasks as fit into the budget of the cycle time measured by the cycle
+monitoring. Without a valid cycle time one task is run per cycle.
 
 \note Calling these functions synchronous ensures a valid program flow counter.
 
@@ -501,55 +524,21 @@ time this tasks are multiplexed over multiple cycles.
 /*----------------------------------------------------------------------------*/
 static BOOLEAN processTaskSchedule(void)
 {
-    BOOLEAN fReturn = FALSE;
-
-    /* Process one synchronous action in each cycle */
-    switch(syncTaskState_l)
-    {
-        case kSyncTaskShnf:
-            /* Periodically process the asynchronous task of the SHNF */
-            if(shnf_process())
-            {
-                fReturn = TRUE;
-            }
-
-            /* Switch to next state */
-            syncTaskState_l = kSyncTaskSapl;
-
-            break;
-
-        case kSyncTaskSapl:
-            /* Periodically process the asynchronous task of the SAPL */
-            if(sapl_processSync())
-            {
-                fReturn = TRUE;
-            }
-
-            /* Switch to next state */
-            syncTaskState_l = kSyncTaskState;
-
-            break;
-
-        case kSyncTaskState:
-            /* Handle internal state changes */
-            if(stateh_handleStateChange())
-            {
-                fReturn = TRUE;
-            }
-
-            /* Switch to first state */
-            syncTaskState_l = kSyncTaskShnf;
-            break;
+    return tasksched_process((UINT32)cyclemon_getCycleStart(), cyclemon_getCycleTime());
+}
 
-        default:
-            errh_postFatalError(kErrSourcePeriph, kErrorInvalidState, 0);
-            break;
-    }
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the time base of the task scheduler
 
-    return fReturn;
+\return The lower 32 bit of the microsecond time base
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 getSchedTime(void)
+{
+    return (UINT32)constime_getTimeBase();
 }
 
-
 /*----------------------------------------------------------------------------*/
 /**
 \brief    On a cycle time violation a reset needs to be performed
@@ -583,6 +572,8 @@ static void shutdown(void)
     xcom_exit();
 #endif /* #if (defined SYSTEM_PATH) && (SYSTEM_PATH > ID_TARG_SINGLE) */
 
+    tasksched_exit();
+
     constime_exit();
     platform_exit();
 }
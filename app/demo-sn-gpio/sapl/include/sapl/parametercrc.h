@@ -60,6 +60,19 @@ typedef enum
     kParamCrcProcCrcInvalid = 0x03,     /**< Parameter CRC is calculated but invalid */
 } tProcCrcRet;
 
+/**
+ * \brief Statistics of the parameter CRC calculation
+ */
+typedef struct
+{
+    UINT32 fullPassCnt_m;       /**< Calculations over the whole SOD */
+    UINT32 updateCnt_m;         /**< Calculations which only read the written objects */
+    UINT32 fallbackCnt_m;       /**< Invalid results of an update which were repeated with a full pass */
+    UINT32 byteCnt_m;           /**< Bytes of object data read by the last calculation */
+    UINT32 stepCnt_m;           /**< Calls of paramcrc_process() of the last calculation */
+    UINT16 segmentCnt_m;        /**< Cached segments (0: cache not used) */
+} tParamCrcStatistics;
+
 
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
@@ -73,7 +86,10 @@ BOOLEAN paramcrc_init(void);
 void paramcrc_exit(void);
 
 tProcCrcRet paramcrc_process(void);
-void paramcrc_startProcessing(void);
+void paramcrc_startProcessing(BOOLEAN fFullPass_p);
+
+void paramcrc_objectWritten(UINT32 objHdl_p);
+void paramcrc_getStatistics(tParamCrcStatistics * pStat_p);
 
 
 #ifdef __cplusplus
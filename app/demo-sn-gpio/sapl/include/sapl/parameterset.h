@@ -59,6 +59,18 @@ typedef enum
     kParamProcBusy           = 0x02,     /**< Parameter processing is busy */
 } tProcParamRet;
 
+/**
+ * \brief Statistics of the parameter set processing (Times in us)
+ */
+typedef struct
+{
+    UINT32 setCnt_m;                /**< Number of processed parameter sets */
+    UINT32 objectCnt_m;             /**< Objects of the last parameter set */
+    UINT32 callCnt_m;               /**< Calls of paramset_process() for the last parameter set */
+    UINT32 processTime_m;           /**< Duration of the last processing from the start of the scan to the end of the apply */
+    UINT32 budgetStopCnt_m;         /**< Calls which stopped at the budget with objects left */
+} tParamSetStatistics;
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
@@ -72,6 +84,8 @@ void paramset_exit(void);
 
 tProcParamRet paramset_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p);
 
+void paramset_getStatistics(tParamSetStatistics * pStat_p);
+
 #ifdef __cplusplus
     }
 #endif
@@ -57,9 +57,29 @@ typedef enum
     kSodStoreProcError          = 0x00,     /**< Error during SOD store processing */
     kSodStoreProcFinished       = 0x01,     /**< Storing of the SOD to NVS finished */
     kSodStoreProcBusy           = 0x02,     /**< Storing is currently busy */
-    kSodStoreProcNotApplicable  = 0x03,     /**< Storing the SOD image is not applicable (The NVM is not empty!) */
+    kSodStoreProcNotApplicable  = 0x03,     /**< Storing the SOD image is not applicable (The parameter set does not fit into a bank!) */
 } tProcStoreRet;
 
+/**
+ * \brief Statistics of the SOD store (Times in us)
+ */
+typedef struct
+{
+    UINT32 storeCnt_m;              /**< Number of finished stores */
+    UINT32 storeTime_m;             /**< Duration of the last store from the start to the commit */
+    UINT32 processCnt_m;            /**< Calls which wrote parameter data */
+    UINT32 burstCnt_m;              /**< Number of written bursts */
+    UINT32 burstLenMax_m;           /**< Longest written burst in bytes */
+    UINT32 byteCnt_m;               /**< Number of written bytes of parameter data */
+    UINT32 budgetOverrunCnt_m;      /**< Calls which wrote longer than the budget of the cycle */
+    UINT32 forcedWriteCnt_m;        /**< Writes started without budget after a cycle without write */
+    UINT32 fullStoreCnt_m;          /**< Stores which wrote the whole parameter set to the inactive bank */
+    UINT32 journalCnt_m;            /**< Stores which appended an entry to the journal of the active bank */
+    UINT32 eraseCnt_m;              /**< Number of erased sectors */
+    UINT32 eraseSkipCnt_m;          /**< Sectors of the inactive bank which were already blank */
+    UINT32 accessTimeEst_m;         /**< Estimated time to program one access (us * 16) */
+} tSodStoreStatistics;
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
@@ -76,6 +96,8 @@ tProcStoreRet sodstore_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p);
 
 BOOLEAN sodstore_getSodImage(UINT8** ppParamSetBase_p, UINT32* pParamSetLen_p);
 
+void sodstore_getStatistics(tSodStoreStatistics * pStat_p);
+
 #ifdef __cplusplus
     }
 #endif
@@ -10,6 +10,21 @@
 This module iterates over the whole SOD and calculates the checksum for all
 CRC relevant objects.
 
+The data of the CRC relevant objects forms a stream which is split into
+blocks of 512 bytes with one CRC32 each. The first calculation stores for
+each part of an object within a block (segment) its own CRC32. Objects
+written afterwards are reported by the after write callback
+SAPL_SOD_ParamCrc_CLBK() (SSDO and SOD_Write()) or paramcrc_objectWritten()
+(parameter set parser). An update only reads the written objects and corrects
+the CRC32 of their block with the difference of the segment CRCs
+(crcengine_combine()). If the length of an object changed, the cache is
+exceeded or the updated result does not match 0x1018/6, a full pass over the
+SOD is done.
+
+The segments are only cached if every CRC relevant object has the after write
+attribute. Otherwise a write of the stack is not reported and every
+calculation is a full pass.
+
 \ingroup group_app_sn_sapl
 *******************************************************************************/
 
@@ -52,6 +67,8 @@ CRC relevant objects.
 
 #include <sapl/parametercrc.h>
 
+#include <shnf/crcengine.h>
+
 #include <sod.h>
 
 #include <SODapi.h>
@@ -92,6 +109,14 @@ extern UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length,
 #define DEVICE_VENDOR_OBJ_IDX            0x1018
 #define PARAMETER_CHECKSUM_OBJ_SUBIDX       0x6
 
+#ifndef SOD_HDL_TO_OBJECT
+  #define SOD_HDL_TO_OBJECT(hdl)    ((SOD_t_OBJECT *)(hdl))     /**< The SOD handle is the address of the object */
+#endif
+
+#ifndef PARAMCRC_MAX_SEGMENTS
+  #define PARAMCRC_MAX_SEGMENTS     64      /**< Cached segments (CRC relevant objects plus one per block boundary) */
+#endif
+
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
@@ -105,8 +130,25 @@ typedef enum
     kParamCrcStateInit           = 0x1,       /**< Start of the CRC calculation */
     kParamCrcStateProcess        = 0x2,       /**< Iterate over each SOD object and calculate the CRC */
     kParamCrcStateFinished       = 0x3,       /**< CRC calculation finished */
+    kParamCrcStateUpdate         = 0x4,       /**< Recalculate the written segments of the cache */
 } tParamCrcState;
 
+/**
+ * \brief Part of a CRC relevant object within one CRC32 block
+ */
+typedef struct
+{
+    SOD_t_OBJECT * pSodObject_m;        /**< Object of the segment */
+    UINT32 objOffset_m;                 /**< Offset of the segment in the object data */
+    UINT32 objLen_m;                    /**< Length of the object data when the segment was calculated */
+    UINT32 crc32_m;                     /**< CRC32 of the segment data with initial value 0 */
+    UINT16 blockOffset_m;               /**< Offset of the segment in the CRC32 block */
+    UINT16 length_m;                    /**< Length of the segment */
+    UINT8 block_m;                      /**< Index of the CRC32 block */
+    UINT8 dataType_m;                   /**< Datatype of the object */
+    BOOLEAN fWritten_m;                 /**< The object was written since the segment was calculated */
+} tParamCrcSegment;
+
 /**
  * \brief SOD CRC calculation module instance structure
  */
@@ -114,9 +156,17 @@ typedef struct
 {
     tParamCrcState paramCrcState_m;             /**< State of the CRC calculator */
     BOOLEAN fStartProc_m;                       /**< TRUE of the processing state is entered */
+    BOOLEAN fFullPass_m;                        /**< The running calculation has to read the whole SOD */
     UINT16 currDataLen_m;                       /**< The current length of data already in the CRC32 */
     UINT32 crc32Entries_m[CRC32_ENTRY_COUNT];   /**< Stores all CRC32 value */
     UINT8 activeCrc_m;                          /**< Value of the currently active CRC32 value */
+    tParamCrcSegment segment_m[PARAMCRC_MAX_SEGMENTS];  /**< Segments of the last full pass */
+    UINT16 segmentCnt_m;                        /**< Number of valid segments */
+    UINT16 currSegment_m;                       /**< Next segment checked by the update */
+    BOOLEAN fCacheValid_m;                      /**< Segments and CRC32 values describe the SOD */
+    BOOLEAN fCacheDiscard_m;                    /**< The running full pass can not be cached */
+    BOOLEAN fCacheUsed_m;                       /**< The running calculation is an update */
+    tParamCrcStatistics stat_m;                 /**< Statistics of the calculations */
 } tParamCrcInstance;
 
 /*----------------------------------------------------------------------------*/
@@ -130,7 +180,13 @@ static tParamCrcInstance paramCrcInstance_l SAFE_INIT_SEKTOR;
 static BOOLEAN calculateObjectCrc(SOD_t_OBJECT * pSodObject_p,
                                   EPLS_t_DATATYPE objType,
                                   UINT32 objLength_p);
+static UINT8 * getObjectData(SOD_t_OBJECT * pSodObject_p, EPLS_t_DATATYPE objType,
+                             UINT32 objLength_p, UINT32 * pDataLen_p);
 static UINT32 * getCurrentActiveCrc32(UINT32 currObjLen_p, UINT32 * pRemObjLen_p);
+static void addSegment(SOD_t_OBJECT * pSodObject_p, EPLS_t_DATATYPE objType,
+                       UINT32 objOffset_p, UINT32 objLen_p, UINT32 length_p, UINT32 crc32_p);
+static tParamCrcState updateSegment(void);
+static void markObjectWritten(const SOD_t_OBJECT * pSodObject_p);
 static BOOLEAN verifyCrc32Values(void);
 
 static void resetParamCrcModule(void);
@@ -189,12 +245,33 @@ tProcCrcRet paramcrc_process(void)
     {
         case kParamCrcStateInit:
         {
-            DEBUG_TRACE(DEBUG_LVL_SAPL, "\nStart SOD CRC calculation...\n");
+            if(paramCrcInstance_l.fCacheValid_m && paramCrcInstance_l.fFullPass_m == FALSE)
+            {
+                DEBUG_TRACE(DEBUG_LVL_SAPL, "\nUpdate SOD CRC of written objects...\n");
 
-            resetParamCrcModule();
+                /* Only the written segments are recalculated */
+                paramCrcInstance_l.currSegment_m = 0;
+                paramCrcInstance_l.fCacheUsed_m = TRUE;
+                paramCrcInstance_l.paramCrcState_m = kParamCrcStateUpdate;
+                paramCrcInstance_l.stat_m.updateCnt_m++;
+            }
+            else
+            {
+                DEBUG_TRACE(DEBUG_LVL_SAPL, "\nStart SOD CRC calculation...\n");
+
+                resetParamCrcModule();
+
+                paramCrcInstance_l.fStartProc_m = TRUE;
+                paramCrcInstance_l.paramCrcState_m = kParamCrcStateProcess;
+                paramCrcInstance_l.stat_m.fullPassCnt_m++;
+            }
 
-            paramCrcInstance_l.fStartProc_m = TRUE;
-            paramCrcInstance_l.paramCrcState_m = kParamCrcStateProcess;
+            paramCrcRet = kParamCrcProcBusy;
+            break;
+        }
+        case kParamCrcStateUpdate:
+        {
+            paramCrcInstance_l.paramCrcState_m = updateSegment();
             paramCrcRet = kParamCrcProcBusy;
             break;
         }
@@ -213,8 +290,14 @@ tProcCrcRet paramcrc_process(void)
                 /* Check if the current object is CRC relevant */
                 if((pCurrSodAttr->w_attr & SOD_k_ATTR_CRC) != 0 )
                 {
+                    if((pCurrSodAttr->w_attr & SOD_k_ATTR_AFT_WR) == 0)
+                    {
+                        /* Writes of this object are not reported -> Do not cache the segments */
+                        paramCrcInstance_l.fCacheDiscard_m = TRUE;
+                    }
+
                     /* Convert the handle to a pointer to the object */
-                    pSodObject = (SOD_t_OBJECT*)sodHdl;
+                    pSodObject = SOD_HDL_TO_OBJECT(sodHdl);
                     if(calculateObjectCrc(pSodObject, pCurrSodAttr->e_dataType, pCurrSodAttr->dw_objLen))
                     {
                         paramCrcRet = kParamCrcProcBusy;
@@ -228,7 +311,11 @@ tProcCrcRet paramcrc_process(void)
             }
             else
             {
-                /* End of SOD reached */
+                /* End of SOD reached, the segments are valid if all of them are stored */
+                paramCrcInstance_l.fCacheValid_m = (paramCrcInstance_l.fCacheDiscard_m == FALSE) ? TRUE : FALSE;
+                paramCrcInstance_l.stat_m.segmentCnt_m = (paramCrcInstance_l.fCacheValid_m != FALSE) ?
+                                                         paramCrcInstance_l.segmentCnt_m : 0;
+
                 paramCrcInstance_l.paramCrcState_m = kParamCrcStateFinished;
                 paramCrcRet = kParamCrcProcBusy;
             }
@@ -243,6 +330,15 @@ tProcCrcRet paramcrc_process(void)
                 paramCrcInstance_l.paramCrcState_m = kParamCrcStateInvalid;
                 paramCrcRet = kParamCrcProcCrcValid;
             }
+            else if(paramCrcInstance_l.fCacheUsed_m)
+            {
+                /* An object may have been written without notification ->
+                 * only a full pass may report an invalid CRC */
+                paramCrcInstance_l.fCacheValid_m = FALSE;
+                paramCrcInstance_l.stat_m.fallbackCnt_m++;
+                paramCrcInstance_l.paramCrcState_m = kParamCrcStateInit;
+                paramCrcRet = kParamCrcProcBusy;
+            }
             else
             {
                 /* Parameter CRC is not valid */
@@ -260,17 +356,127 @@ tProcCrcRet paramcrc_process(void)
         }
     }
 
+    paramCrcInstance_l.stat_m.stepCnt_m++;
+
     return paramCrcRet;
 }
 
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Start the processing of the CRC calculator
+
+An update only recalculates the segments of the objects which were reported
+as written. Without a valid cache (first calculation, an object without after
+write callback) an update is a full pass as well. A full pass also refreshes
+the cached segments.
+
+\param[in] fFullPass_p  TRUE: Read the whole SOD; FALSE: Update the cache if
+                        it is valid
 */
 /*----------------------------------------------------------------------------*/
-void paramcrc_startProcessing(void)
+void paramcrc_startProcessing(BOOLEAN fFullPass_p)
 {
     paramCrcInstance_l.paramCrcState_m = kParamCrcStateInit;
+    paramCrcInstance_l.fFullPass_m = fFullPass_p;
+
+    paramCrcInstance_l.stat_m.byteCnt_m = 0;
+    paramCrcInstance_l.stat_m.stepCnt_m = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Report a write access to an object of the SOD
+
+Has to be called for a write of a CRC relevant object which is not reported by
+SAPL_SOD_ParamCrc_CLBK(), after the data was changed. The cached CRC of the segments of this object is recalculated by the
+next CRC calculation. Objects which are not CRC relevant are ignored.
+
+\param[in] objHdl_p     SOD handle of the written object
+*/
+/*----------------------------------------------------------------------------*/
+void paramcrc_objectWritten(UINT32 objHdl_p)
+{
+    markObjectWritten(SOD_HDL_TO_OBJECT(objHdl_p));
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the parameter CRC calculation
+
+\param[out] pStat_p     Copy of the statistics
+*/
+/*----------------------------------------------------------------------------*/
+void paramcrc_getStatistics(tParamCrcStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &paramCrcInstance_l.stat_m, sizeof(tParamCrcStatistics));
+    }
+}
+
+/*
+ * This function is called after the write access of a CRC
+ * relevant object and reports the write to the parameter CRC.
+ *
+ * \param B_INSTNUM    instance number
+ * \param e_srvc       type of service, see {SOD_t_SERVICE}
+ *                     (only SOD_k_SRV_AFTER_WRITE is handled)
+ *                     valid range: SOD_t_SERVICE
+ * \param ps_obj       pointer to a SOD entry, see
+ *                     {SOD_t_OBJECT} (pointer not checked,
+ *                     only called with reference to struct
+ *                     in SOD_Write())
+ *                     valid range: pointer to a SOD_t_OBJECT
+ * \param pv_data      pointer to data to be written (not used)
+ * \param dw_offset    start offset in bytes of the segment
+ *                     within the data block (not used)
+ * \param dw_size      size in bytes of the segment (not used)
+ * \param pe_abortCode abort code has to be set for the SSDO if
+ *                     the return value is FALSE.
+ *                     (pointer not checked, only called with
+ *                     reference to variable)
+ *                     valid range: pointer to the
+ *                     SOD_t_ABORT_CODES
+ *
+ * \return - TRUE  - success
+ *         - FALSE - failure
+ */
+BOOLEAN SAPL_SOD_ParamCrc_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                               const SOD_t_OBJECT *ps_obj,
+                               const void *pv_data,
+                               UINT32 dw_offset, UINT32 dw_size,
+                               SOD_t_ABORT_CODES *pe_abortCode)
+{
+    BOOLEAN fReturn = FALSE;
+
+    UNUSED_PARAMETER(dw_offset);
+    UNUSED_PARAMETER(pv_data);
+    UNUSED_PARAMETER(dw_size);
+
+    /* Check used parameters sanity */
+    if( ps_obj == NULL              ||
+        pe_abortCode == NULL         )
+    {
+        errh_postFatalError(kErrSourceSapl, kErrorInvalidParameter, 0);
+
+        if(pe_abortCode != NULL)
+        {
+            *pe_abortCode = SOD_ABT_GENERAL_ERROR;
+        }
+    }
+    else
+    {
+        if(e_srvc == SOD_k_SRV_AFTER_WRITE)
+        {
+            markObjectWritten(ps_obj);
+        }
+
+        *pe_abortCode = SOD_ABT_NO_ERROR;
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
 }
 
 /*============================================================================*/
@@ -297,33 +503,23 @@ static BOOLEAN calculateObjectCrc(SOD_t_OBJECT * pSodObject_p,
 {
     BOOLEAN fReturn = FALSE;
     BOOLEAN fObjProc = TRUE;
-    void * pObjData = NULL;
+    UINT8 * pObjData = NULL;
     UINT32 objLen = 0;
+    UINT32 dataLen = 0;
     UINT32 * pActCrc32 = &paramCrcInstance_l.crc32Entries_m[paramCrcInstance_l.activeCrc_m];
     UINT32 remObjLen = 0;
+    UINT32 segCrc32 = 0;
 
     /* Get length and data pointer from the current object */
-    if ((objType == EPLS_k_VISIBLE_STRING) ||
-        (objType == EPLS_k_DOMAIN)         ||
-        (objType == EPLS_k_OCTET_STRING)    )
-    {
-        pObjData = ((SOD_t_ACT_LEN_PTR_DATA*)pSodObject_p->pv_objData)->pv_objData;
-        objLen = (UINT32)((SOD_t_ACT_LEN_PTR_DATA*)pSodObject_p->pv_objData)->dw_actLen;
-    }
-    else
-    {
-        /* Object has a normal datatype e.g: UINT32 */
-        pObjData = pSodObject_p->pv_objData;
-        objLen = (UINT32)objLength_p;
-    }
+    pObjData = getObjectData(pSodObject_p, objType, objLength_p, &objLen);
 
     /* Calculate the CRC32 over the object if object available */
     if(pObjData != NULL)
     {
         /* Iterate over all segments of the object */
-        while(objLen > 0)
+        while(dataLen < objLen)
         {
-            pActCrc32 = getCurrentActiveCrc32(objLen, &remObjLen);
+            pActCrc32 = getCurrentActiveCrc32(objLen - dataLen, &remObjLen);
             if(pActCrc32 == NULL)
             {
                 fObjProc = FALSE;
@@ -331,10 +527,15 @@ static BOOLEAN calculateObjectCrc(SOD_t_OBJECT * pSodObject_p,
             }
             else
             {
-                /* Calculate the CRC for this object and add to checksum */
-                *pActCrc32 = HNFiff_Crc32CalcSwp(*pActCrc32, remObjLen, pObjData);
-                paramCrcInstance_l.currDataLen_m += remObjLen;
-                objLen -= remObjLen;
+                /* Calculate the CRC of this segment and add it to the checksum of the block */
+                segCrc32 = HNFiff_Crc32CalcSwp(0, remObjLen, &pObjData[dataLen]);
+                *pActCrc32 = crcengine_combine(kCrcPolyCrc32, *pActCrc32, segCrc32, remObjLen);
+
+                addSegment(pSodObject_p, objType, dataLen, objLen, remObjLen, segCrc32);
+
+                paramCrcInstance_l.currDataLen_m += (UINT16)remObjLen;
+                paramCrcInstance_l.stat_m.byteCnt_m += remObjLen;
+                dataLen += remObjLen;
             }
         }
 
@@ -362,24 +563,13 @@ static UINT32 * getCurrentActiveCrc32(UINT32 currObjLen_p, UINT32 * pRemObjLen_p
 {
     UINT32 * pActCrc32 = (UINT32 *)NULL;
 
-    /* Check if there is space left in the current CRC32 */
-    if((paramCrcInstance_l.currDataLen_m + currObjLen_p) > MAX_CRC32_DATA_LENGTH)
-    {
-        /* Set remaining length which fits into the current active CRC32 */
-        *pRemObjLen_p = MAX_CRC32_DATA_LENGTH - paramCrcInstance_l.currDataLen_m;
-        pActCrc32 = &paramCrcInstance_l.crc32Entries_m[paramCrcInstance_l.activeCrc_m];
-    }
-    else if(paramCrcInstance_l.currDataLen_m == MAX_CRC32_DATA_LENGTH)
+    if(paramCrcInstance_l.currDataLen_m == MAX_CRC32_DATA_LENGTH)
     {
-        if(paramCrcInstance_l.activeCrc_m < CRC32_ENTRY_COUNT)
+        if((paramCrcInstance_l.activeCrc_m + 1) < CRC32_ENTRY_COUNT)
         {
             /* Length of the CRC reached the limit -> Start a new CRC32 */
             paramCrcInstance_l.currDataLen_m = 0;
             paramCrcInstance_l.activeCrc_m++;
-
-            *pRemObjLen_p = currObjLen_p;
-
-            pActCrc32 = &paramCrcInstance_l.crc32Entries_m[paramCrcInstance_l.activeCrc_m];
         }
         else
         {
@@ -387,10 +577,18 @@ static UINT32 * getCurrentActiveCrc32(UINT32 currObjLen_p, UINT32 * pRemObjLen_p
             errh_postFatalError(kErrSourceShnf, kErrorNoCrcFieldAllocated, 0);
         }
     }
-    else
+
+    if(paramCrcInstance_l.currDataLen_m < MAX_CRC32_DATA_LENGTH)
     {
-        /* Data can be added to the current active CRC32 */
-        *pRemObjLen_p = currObjLen_p;
+        /* Set remaining length which fits into the current active CRC32 */
+        if((paramCrcInstance_l.currDataLen_m + currObjLen_p) > MAX_CRC32_DATA_LENGTH)
+        {
+            *pRemObjLen_p = MAX_CRC32_DATA_LENGTH - paramCrcInstance_l.currDataLen_m;
+        }
+        else
+        {
+            *pRemObjLen_p = currObjLen_p;
+        }
 
         pActCrc32 = &paramCrcInstance_l.crc32Entries_m[paramCrcInstance_l.activeCrc_m];
     }
@@ -398,6 +596,181 @@ static UINT32 * getCurrentActiveCrc32(UINT32 currObjLen_p, UINT32 * pRemObjLen_p
     return pActCrc32;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the data of an object
+
+\param[in]  pSodObject_p    Pointer to the object in the SOD
+\param[in]  objType         Type of the object
+\param[in]  objLength_p     Length of the object from the attributes
+\param[out] pDataLen_p      Length of the object data
+
+\retval Address     The address of the object data
+\retval NULL        Object has no data
+*/
+/*----------------------------------------------------------------------------*/
+static UINT8 * getObjectData(SOD_t_OBJECT * pSodObject_p, EPLS_t_DATATYPE objType,
+                             UINT32 objLength_p, UINT32 * pDataLen_p)
+{
+    UINT8 * pObjData = (UINT8 *)NULL;
+
+    if ((objType == EPLS_k_VISIBLE_STRING) ||
+        (objType == EPLS_k_DOMAIN)         ||
+        (objType == EPLS_k_OCTET_STRING)    )
+    {
+        pObjData = (UINT8 *)((SOD_t_ACT_LEN_PTR_DATA*)pSodObject_p->pv_objData)->pv_objData;
+        *pDataLen_p = (UINT32)((SOD_t_ACT_LEN_PTR_DATA*)pSodObject_p->pv_objData)->dw_actLen;
+    }
+    else
+    {
+        /* Object has a normal datatype e.g: UINT32 */
+        pObjData = (UINT8 *)pSodObject_p->pv_objData;
+        *pDataLen_p = objLength_p;
+    }
+
+    return pObjData;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Store a segment of the full pass in the cache
+
+If the cache is full, the segments of this pass are discarded and the next
+calculation is a full pass again.
+
+\param[in] pSodObject_p     Pointer to the object in the SOD
+\param[in] objType          Type of the object
+\param[in] objOffset_p      Offset of the segment in the object data
+\param[in] objLen_p         Length of the object data
+\param[in] length_p         Length of the segment
+\param[in] crc32_p          CRC32 of the segment with initial value 0
+*/
+/*----------------------------------------------------------------------------*/
+static void addSegment(SOD_t_OBJECT * pSodObject_p, EPLS_t_DATATYPE objType,
+                       UINT32 objOffset_p, UINT32 objLen_p, UINT32 length_p, UINT32 crc32_p)
+{
+    tParamCrcSegment * pSegment = (tParamCrcSegment *)NULL;
+
+    if(paramCrcInstance_l.segmentCnt_m < PARAMCRC_MAX_SEGMENTS)
+    {
+        pSegment = &paramCrcInstance_l.segment_m[paramCrcInstance_l.segmentCnt_m];
+
+        pSegment->pSodObject_m = pSodObject_p;
+        pSegment->objOffset_m = objOffset_p;
+        pSegment->objLen_m = objLen_p;
+        pSegment->crc32_m = crc32_p;
+        pSegment->blockOffset_m = paramCrcInstance_l.currDataLen_m;
+        pSegment->length_m = (UINT16)length_p;
+        pSegment->block_m = paramCrcInstance_l.activeCrc_m;
+        pSegment->dataType_m = (UINT8)objType;
+        pSegment->fWritten_m = FALSE;
+
+        paramCrcInstance_l.segmentCnt_m++;
+    }
+    else
+    {
+        paramCrcInstance_l.fCacheDiscard_m = TRUE;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Recalculate the next written segment of the cache
+
+The CRC32 of the block is corrected with the difference of the old and the
+new segment CRC, shifted over the bytes of the block behind the segment.
+The data of the other segments is not read.
+
+\retval kParamCrcStateUpdate     More segments may be written
+\retval kParamCrcStateFinished   All segments are up to date
+\retval kParamCrcStateInit       The layout changed -> Start a full pass
+*/
+/*----------------------------------------------------------------------------*/
+static tParamCrcState updateSegment(void)
+{
+    tParamCrcState nextState = kParamCrcStateFinished;
+    tParamCrcSegment * pSegment = (tParamCrcSegment *)NULL;
+    UINT8 * pObjData = (UINT8 *)NULL;
+    UINT32 objLen = 0;
+    UINT32 segCrc32 = 0;
+    UINT16 blockLen = 0;
+
+    /* Skip the segments which are not written */
+    while(paramCrcInstance_l.currSegment_m < paramCrcInstance_l.segmentCnt_m &&
+          paramCrcInstance_l.segment_m[paramCrcInstance_l.currSegment_m].fWritten_m == FALSE)
+    {
+        paramCrcInstance_l.currSegment_m++;
+    }
+
+    if(paramCrcInstance_l.currSegment_m < paramCrcInstance_l.segmentCnt_m)
+    {
+        pSegment = &paramCrcInstance_l.segment_m[paramCrcInstance_l.currSegment_m];
+
+        pObjData = getObjectData(pSegment->pSodObject_m, (EPLS_t_DATATYPE)pSegment->dataType_m,
+                                 pSegment->objLen_m, &objLen);
+        if(pObjData == NULL || objLen != pSegment->objLen_m)
+        {
+            /* The following data moved to other blocks -> Cache is useless */
+            paramCrcInstance_l.fCacheValid_m = FALSE;
+            nextState = kParamCrcStateInit;
+        }
+        else
+        {
+            segCrc32 = HNFiff_Crc32CalcSwp(0, pSegment->length_m, &pObjData[pSegment->objOffset_m]);
+            paramCrcInstance_l.stat_m.byteCnt_m += pSegment->length_m;
+
+            if(segCrc32 != pSegment->crc32_m)
+            {
+                /* Only the last block is shorter than MAX_CRC32_DATA_LENGTH */
+                blockLen = (pSegment->block_m == paramCrcInstance_l.activeCrc_m) ?
+                           paramCrcInstance_l.currDataLen_m : MAX_CRC32_DATA_LENGTH;
+
+                paramCrcInstance_l.crc32Entries_m[pSegment->block_m] ^=
+                        crcengine_combine(kCrcPolyCrc32, segCrc32 ^ pSegment->crc32_m, 0,
+                                          (UINT32)blockLen - pSegment->blockOffset_m - pSegment->length_m);
+                pSegment->crc32_m = segCrc32;
+            }
+
+            pSegment->fWritten_m = FALSE;
+            paramCrcInstance_l.currSegment_m++;
+            nextState = kParamCrcStateUpdate;
+        }
+    }
+
+    return nextState;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Mark the cached segments of a written object
+
+\param[in] pSodObject_p     Pointer to the written object in the SOD
+*/
+/*----------------------------------------------------------------------------*/
+static void markObjectWritten(const SOD_t_OBJECT * pSodObject_p)
+{
+    UINT16 i;
+
+    if(paramCrcInstance_l.paramCrcState_m == kParamCrcStateProcess)
+    {
+        /* The object may already be passed by the running full pass */
+        paramCrcInstance_l.fCacheDiscard_m = TRUE;
+    }
+    else if(paramCrcInstance_l.fCacheValid_m)
+    {
+        for(i = 0; i < paramCrcInstance_l.segmentCnt_m; i++)
+        {
+            if(paramCrcInstance_l.segment_m[i].pSodObject_m == pSodObject_p)
+            {
+                paramCrcInstance_l.segment_m[i].fWritten_m = TRUE;
+            }
+        }
+
+        /* A running update has to check all segments again */
+        paramCrcInstance_l.currSegment_m = 0;
+    }
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Verify the calculated CRC32 values with the one from the SOD
@@ -476,6 +849,12 @@ static void resetParamCrcModule(void)
     paramCrcInstance_l.currDataLen_m = 0;
     paramCrcInstance_l.activeCrc_m = 0;
 
+    paramCrcInstance_l.segmentCnt_m = 0;
+    paramCrcInstance_l.currSegment_m = 0;
+    paramCrcInstance_l.fCacheValid_m = FALSE;
+    paramCrcInstance_l.fCacheDiscard_m = FALSE;
+    paramCrcInstance_l.fCacheUsed_m = FALSE;
+
     paramCrcInstance_l.fStartProc_m = FALSE;
     paramCrcInstance_l.paramCrcState_m = kParamCrcStateInvalid;
 
@@ -51,6 +51,9 @@ dictionary and performs checks of the stream.
 /*----------------------------------------------------------------------------*/
 
 #include <sapl/parameterset.h>
+#include <sapl/parametercrc.h>
+
+#include <shnf/constime.h>
 
 #include <SODapi.h>
 #include <SERRapi.h>
@@ -58,6 +61,8 @@ dictionary and performs checks of the stream.
 #include <SHNF.h>
 #include <SFS.h>
 
+#include <sod.h>
+
 
 /*============================================================================*/
 /*            G L O B A L   D E F I N I T I O N S                             */
@@ -89,9 +94,25 @@ dictionary and performs checks of the stream.
 #define EPS_PARAMSET_LENGTH_LEN      4      /**< Size of the param stream length field */
 
 
-#define EPS_PARAMSET_HEADER_LENGTH      EPS_PARAMSET_IDX_LEN + \
-                                        EPS_PARAMSET_SUBIDX_LEN + \
-                                        EPS_PARAMSET_LENGTH_LEN        /**< Length of the header of an object in a parameter set (idx, subidx and length)  */
+#define EPS_PARAMSET_HEADER_LENGTH      (EPS_PARAMSET_IDX_LEN + \
+                                         EPS_PARAMSET_SUBIDX_LEN + \
+                                         EPS_PARAMSET_LENGTH_LEN)      /**< Length of the header of an object in a parameter set (idx, subidx and length)  */
+
+#ifndef PARAMSET_INDEX_SIZE
+  #define PARAMSET_INDEX_SIZE       (SAPL_k_MAX_PARAM_SET_LEN / EPS_PARAMSET_HEADER_LENGTH)  /**< Number of objects in the index (All headers of the largest parameter set) */
+#endif
+
+#ifndef PARAMSET_BUDGET_OBJECTS
+  #define PARAMSET_BUDGET_OBJECTS   32      /**< Objects scanned or written per call of paramset_process() */
+#endif
+
+#ifndef PARAMSET_BUDGET_US
+  #define PARAMSET_BUDGET_US        200     /**< Time in us after which paramset_process() handles no further object */
+#endif
+
+#if (SAPL_k_MAX_PARAM_SET_LEN > 0xFFFF)
+  #error "The index addresses the parameter set with UINT16 offsets"
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
@@ -103,35 +124,21 @@ dictionary and performs checks of the stream.
 typedef enum
 {
     kParseObjInvalid          = 0x0,    /**< Invalid return value  */
-    kParseObjFinished         = 0x1,    /**< Finished to parse the object  */
-    kParseObjBusy             = 0x2,    /**< Object parser is currently busy  */
+    kParseObjFinished         = 0x1,    /**< Last object of the parameter set is parsed  */
+    kParseObjBusy             = 0x2,    /**< Object is parsed, further objects follow  */
     kParseObjError            = 0x3,    /**< Error during oject parsing */
 } tParseObjStatus;
 
 /**
- * \brief States of the object parser
- */
-typedef enum
-{
-    kObjStateInvalid            = 0x0,      /**< Invalid state */
-    kObjStateGetParameters      = 0x1,      /**< Fetch index, subindex and size from the image */
-    kObjStateVerifyParameters   = 0x2,      /**< Verify the parsed attributes from the current object */
-    kObjStateGetSodAttributes   = 0x3,      /**< Get the attributes of the current object */
-    kObjStateWriteObjectToSod   = 0x4,      /**< Write the valid object to the SOD */
-} tObjectState;
-
-/**
- * \brief Stores the attributes of the current handled object
+ * \brief Entry of the object index of the parameter set
  */
 typedef struct
 {
-    UINT16 index_m;                 /**< The index of the current object */
-    UINT8 subIndex_m;               /**< The subindex of the current object */
-    UINT32 length_m;                /**< Length of the current object */
-    UINT8 * pData_m;                /**< Pointer to the object data */
-    SOD_t_ATTR * pCurrSodAttr_m;    /**< Attribute of the current SOD entry */
-    UINT32 objHdl_m;                /**< SOD handle of the current object */
-} tObjectAttr;
+    UINT32 objHdl_m;                /**< SOD handle of the object */
+    SOD_t_ATTR * pSodAttr_m;        /**< Attribute of the SOD entry */
+    UINT16 offset_m;                /**< Offset of the object payload in the parameter set */
+    UINT16 length_m;                /**< Length of the object payload */
+} tObjectIndexEntry;
 
 /**
  * \brief Parameter set processing state machine
@@ -140,8 +147,9 @@ typedef enum
 {
     kParamSetStateInvalid             = 0x0,    /**< Invalid state */
     kParamSetStateInitiateProcessing  = 0x2,    /**< Start the processing of the downloaded parameter set */
-    kParamSetStateProcessing          = 0x3,    /**< Process the arrived parameter set */
-    kParamSetStateFinishProcessing    = 0x4,    /**< Processing of the parameter set is finished */
+    kParamSetStateScan                = 0x3,    /**< Verify all objects and build the object index */
+    kParamSetStateApply               = 0x4,    /**< Write the indexed objects to the SOD */
+    kParamSetStateFinishProcessing    = 0x5,    /**< Processing of the parameter set is finished */
 } tParamSetProcState;
 
 /**
@@ -150,8 +158,12 @@ typedef enum
 typedef struct
 {
     tParamSetProcState paramSetState_m;     /**< Current state of the parameter set processing */
-    tObjectState objectState_m;             /**< Processing state of the current object in the parameter set */
-    tObjectAttr currObjAttr_m;              /**< Attributes of the current handled object */
+    UINT32 currParamSetPos_m;               /**< Position of the next object header in the parameter set */
+    UINT16 objCnt_m;                        /**< Number of objects in the index */
+    UINT16 applyPos_m;                      /**< Index entry which is written next */
+    UINT32 startTime_m;                     /**< Start of the processing of the current parameter set */
+    UINT32 callCnt_m;                       /**< Calls of the processing of the current parameter set */
+    tParamSetStatistics stat_m;             /**< Statistics of the parameter set processing */
 } tParamSetInstance;
 
 /*----------------------------------------------------------------------------*/
@@ -159,14 +171,16 @@ typedef struct
 /*----------------------------------------------------------------------------*/
 static tParamSetInstance paramSetInstance_l SAFE_INIT_SEKTOR;
 
+/* Objects of the parameter set in the order of the stream */
+static tObjectIndexEntry aObjIndex_l[PARAMSET_INDEX_SIZE] SAFE_INIT_SEKTOR;
+
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
-static tParseObjStatus processParameterSetObject(UINT8 * pObjData_p,
-                                                 UINT32 currParamSetPos,
-                                                 UINT32 * pCurrObjLen_p,
-                                                 UINT32 paramSetLen_p);
-static BOOLEAN writeDomainToSod(void);
+static tParseObjStatus scanObject(UINT8 * pParamSetBase_p, UINT32 paramSetLen_p);
+static BOOLEAN writeObjectToSod(UINT8 * pParamSetBase_p,
+                                const tObjectIndexEntry * pEntry_p);
+static BOOLEAN isDomainObject(const SOD_t_ATTR * pSodAttr_p);
 
 /*============================================================================*/
 /*            P U B L I C   F U N C T I O N S                                 */
@@ -185,10 +199,10 @@ BOOLEAN paramset_init(void)
     BOOLEAN fReturn = FALSE;
 
     MEMSET(&paramSetInstance_l, 0, sizeof(tParamSetInstance));
+    MEMSET(aObjIndex_l, 0, sizeof(aObjIndex_l));
 
     /* Initialize ParameterSet state machine */
     paramSetInstance_l.paramSetState_m = kParamSetStateInitiateProcessing;
-    paramSetInstance_l.objectState_m = kObjStateGetParameters;
 
     fReturn = TRUE;
 
@@ -209,8 +223,13 @@ void paramset_exit(void)
 /**
 \brief    Process the parameter set state machine
 
-This state machine checks if the parameter set image has arrived and iterates
-over all objects and forwards them to the SOD.
+The parameter set is processed in two passes. The scan verifies the header of
+each object against the bounds of the image and the SOD and stores the SOD
+handle, the attribute and the position of the payload in the object index.
+Only if the whole image is valid, the apply pass writes the indexed objects
+in the order of the stream to the SOD. Both passes handle objects until
+PARAMSET_BUDGET_OBJECTS objects are handled or PARAMSET_BUDGET_US is elapsed,
+the rest is left to the next call.
 
 \param pParamSetBase_p      Base address of the parameter set
 \param paramSetLen_p        Length of the parameter set
@@ -224,89 +243,117 @@ tProcParamRet paramset_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
 {
     tProcParamRet procRet = kParamProcError;
     tParseObjStatus objParseState = kParseObjInvalid;
-    static UINT8 * pCurrDataPos = (UINT8 *)NULL;
-    static UINT32 currParamSetPos = 0;
-    UINT32 currObjLen = 0;
+    BOOLEAN fStop = FALSE;
+    UINT16 objCnt = 0;
+    UINT32 startTime = (UINT32)constime_getTimeBase();
 
     if(pParamSetBase_p != NULL && paramSetLen_p > 0)
     {
-        switch(paramSetInstance_l.paramSetState_m)
+        paramSetInstance_l.callCnt_m++;
+        procRet = kParamProcBusy;
+
+        while(procRet == kParamProcBusy && fStop == FALSE)
         {
-            case kParamSetStateInitiateProcessing:
+            if(objCnt >= PARAMSET_BUDGET_OBJECTS                             ||
+               (UINT32)constime_getTimeBase() - startTime >= PARAMSET_BUDGET_US )
             {
-                DEBUG_TRACE(DEBUG_LVL_SAPL, "\nParse parameter set: "
-                                              "(Size: %dBytes)\n", paramSetLen_p);
-
-                /* Reset global object attributes structures */
-                MEMSET(&paramSetInstance_l.currObjAttr_m, 0, sizeof(tObjectAttr));
-
-                /* Set start of parameter set image */
-                pCurrDataPos = pParamSetBase_p;
-                currParamSetPos = 0;
-
-                paramSetInstance_l.paramSetState_m = kParamSetStateProcessing;
-                procRet = kParamProcBusy;
-                break;
+                paramSetInstance_l.stat_m.budgetStopCnt_m++;
+                fStop = TRUE;
             }
-            case kParamSetStateProcessing:
+            else
             {
-                /* Process next parameter set object */
-                objParseState = processParameterSetObject(pCurrDataPos, currParamSetPos,
-                                                          &currObjLen, paramSetLen_p);
-                if(objParseState == kParseObjBusy)
-                {
-                    /* Object parser is currently busy */
-                    procRet = kParamProcBusy;
-                }
-                else if(objParseState == kParseObjFinished)
+                switch(paramSetInstance_l.paramSetState_m)
                 {
-                    if(currParamSetPos + currObjLen < paramSetLen_p)
+                    case kParamSetStateInitiateProcessing:
                     {
-                        /* Current object finished -> Move data pointer to next object */
-                        pCurrDataPos = &pCurrDataPos[currObjLen];
-                        currParamSetPos += currObjLen;
-                        procRet = kParamProcBusy;
+                        DEBUG_TRACE(DEBUG_LVL_SAPL, "\nParse parameter set: "
+                                                      "(Size: %dBytes)\n", paramSetLen_p);
+
+                        if(paramSetLen_p <= SAPL_k_MAX_PARAM_SET_LEN)
+                        {
+                            /* Set start of parameter set image */
+                            paramSetInstance_l.currParamSetPos_m = 0;
+                            paramSetInstance_l.objCnt_m = 0;
+                            paramSetInstance_l.applyPos_m = 0;
+                            paramSetInstance_l.startTime_m = startTime;
+                            paramSetInstance_l.callCnt_m = 1;
+
+                            paramSetInstance_l.paramSetState_m = kParamSetStateScan;
+                        }
+                        else
+                        {
+                            errh_postFatalError(kErrSourceSapl, kErrorParamSetInvalidSize, paramSetLen_p);
+                            procRet = kParamProcError;
+                        }
+                        break;
                     }
-                    else if(currParamSetPos + currObjLen == paramSetLen_p)
+                    case kParamSetStateScan:
                     {
-                        /* End of parameter set reached */
-                        paramSetInstance_l.paramSetState_m = kParamSetStateFinishProcessing;
-                        procRet = kParamProcBusy;
+                        /* Verify the next object and add it to the index */
+                        objParseState = scanObject(pParamSetBase_p, paramSetLen_p);
+                        objCnt++;
+                        if(objParseState == kParseObjFinished)
+                        {
+                            /* All objects are valid -> Write them to the SOD */
+                            paramSetInstance_l.paramSetState_m = kParamSetStateApply;
+                        }
+                        else if(objParseState != kParseObjBusy)
+                        {
+                            errh_postFatalError(kErrSourceSapl, kErrorParamSetUnableToParseObj,
+                                                paramSetInstance_l.currParamSetPos_m);
+                            paramSetInstance_l.paramSetState_m = kParamSetStateInitiateProcessing;
+                            procRet = kParamProcError;
+                        }
+                        break;
                     }
-                    else
+                    case kParamSetStateApply:
                     {
-                        /* Error during parameter set processing */
-                        errh_postFatalError(kErrSourceSapl, kErrorParamSetInvalidSize, (currParamSetPos + currObjLen));
+                        if(paramSetInstance_l.applyPos_m < paramSetInstance_l.objCnt_m)
+                        {
+                            /* Write the next indexed object */
+                            if(writeObjectToSod(pParamSetBase_p,
+                                                &aObjIndex_l[paramSetInstance_l.applyPos_m]))
+                            {
+                                paramSetInstance_l.applyPos_m++;
+                                objCnt++;
+                            }
+                            else
+                            {
+                                errh_postFatalError(kErrSourceSapl, kErrorParamSetUnableToParseObj,
+                                                    aObjIndex_l[paramSetInstance_l.applyPos_m].offset_m);
+                                paramSetInstance_l.paramSetState_m = kParamSetStateInitiateProcessing;
+                                procRet = kParamProcError;
+                            }
+                        }
+                        else
+                        {
+                            paramSetInstance_l.paramSetState_m = kParamSetStateFinishProcessing;
+                        }
+                        break;
                     }
-                }
-                else
-                {
-                    /* Error occurred -> Return FALSE */
-                    errh_postFatalError(kErrSourceSapl, kErrorParamSetUnableToParseObj, 0);
-                }
-
-                break;
-            }
-            case kParamSetStateFinishProcessing:
-            {
-                DEBUG_TRACE(DEBUG_LVL_SAPL, "Parsing finished!\n");
-
-                /* Reset global object attributes structures */
-                MEMSET(&paramSetInstance_l.currObjAttr_m, 0, sizeof(tObjectAttr));
-
-                paramSetInstance_l.objectState_m = kObjStateGetParameters;
+                    case kParamSetStateFinishProcessing:
+                    {
+                        DEBUG_TRACE(DEBUG_LVL_SAPL, "Parsing finished!\n");
 
-                paramSetInstance_l.paramSetState_m = kParamSetStateInitiateProcessing;
+                        paramSetInstance_l.stat_m.setCnt_m++;
+                        paramSetInstance_l.stat_m.objectCnt_m = paramSetInstance_l.objCnt_m;
+                        paramSetInstance_l.stat_m.callCnt_m = paramSetInstance_l.callCnt_m;
+                        paramSetInstance_l.stat_m.processTime_m =
+                                (UINT32)constime_getTimeBase() - paramSetInstance_l.startTime_m;
 
-                procRet = kParamProcFinished;
-                break;
-            }
-            default:
-            {
-                /* Invalid state reached */
-                errh_postFatalError(kErrSourceSapl, kErrorInvalidState, 0);
+                        paramSetInstance_l.paramSetState_m = kParamSetStateInitiateProcessing;
 
-                break;
+                        procRet = kParamProcFinished;
+                        break;
+                    }
+                    default:
+                    {
+                        /* Invalid state reached */
+                        errh_postFatalError(kErrSourceSapl, kErrorInvalidState, 0);
+                        procRet = kParamProcError;
+                        break;
+                    }
+                }
             }
         }
     }
@@ -320,6 +367,21 @@ tProcParamRet paramset_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
     return procRet;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the parameter set processing
+
+\param[out] pStat_p     Copy of the statistics
+*/
+/*----------------------------------------------------------------------------*/
+void paramset_getStatistics(tParamSetStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &paramSetInstance_l.stat_m, sizeof(tParamSetStatistics));
+    }
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -328,171 +390,178 @@ tProcParamRet paramset_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Process the current parameter set object
+\brief    Verify the next parameter set object and add it to the index
 
-This function parses an object from the parameter set and writes the payload
-to the corresponding SOD entry.
+This function parses the header of the object at the current position,
+checks that the object is inside the parameter set image and fits into its
+SOD entry and stores it in the object index. Nothing is written to the SOD.
 
-\param[in]  pObjData_p      Pointer to the start of the current object
-\param[in]  currParamSetPos Current length position in the parameter set
-\param[out] pCurrObjLen_p   The length of the current object (Including header)
-\param[in]  paramSetLen_p   The length of the parameter set
+\param[in] pParamSetBase_p  Base address of the parameter set
+\param[in] paramSetLen_p    Length of the parameter set
 
-\retval kParseObjBusy        Object processing state machine is currently busy
-\retval kParseObjFinished    Current object processing is finished
-\retval kParseObjError       Error during processing
+\retval kParseObjBusy        Object is indexed, further objects follow
+\retval kParseObjFinished    Object is indexed and ends the parameter set
+\retval kParseObjError       Invalid object
 */
 /*----------------------------------------------------------------------------*/
-static tParseObjStatus processParameterSetObject(UINT8 * pObjData_p,
-                                                 UINT32 currParamSetPos,
-                                                 UINT32 * pCurrObjLen_p,
-                                                 UINT32 paramSetLen_p)
+static tParseObjStatus scanObject(UINT8 * pParamSetBase_p, UINT32 paramSetLen_p)
 {
     tParseObjStatus parseObjRet = kParseObjError;
     SOD_t_ERROR_RESULT errRes;
     BOOLEAN fIsApplObj = FALSE;
-    /* Consists of the object payload if datatype is known. (Provides aligned address) */
-    UINT64 objTmpData = 0;
-
-    switch(paramSetInstance_l.objectState_m)
+    UINT32 currPos = paramSetInstance_l.currParamSetPos_m;
+    UINT8 * pObjData = &pParamSetBase_p[currPos];
+    UINT16 index = 0;
+    UINT8 subIndex = 0;
+    UINT32 length = 0;
+    tObjectIndexEntry * pEntry;
+
+    if(paramSetInstance_l.objCnt_m >= PARAMSET_INDEX_SIZE)
     {
-        case kObjStateGetParameters:
-        {
-            /*
-             * Copy attributes of the current object byte wise because data
-             * inside the parameter set is not guaranteed to be aligned in memory!
-             */
-
-            /* Get index of the current object */
-            SFS_NET_CPY16(&paramSetInstance_l.currObjAttr_m.index_m, &pObjData_p[0]);
-
-            /* Get subindex of the current object */
-            SFS_NET_CPY8(&paramSetInstance_l.currObjAttr_m.subIndex_m, &pObjData_p[2]);
-
-            /* Get length of the current object */
-            SFS_NET_CPY32(&paramSetInstance_l.currObjAttr_m.length_m, &pObjData_p[3]);
-
-            /* Set data pointer to object payload */
-            paramSetInstance_l.currObjAttr_m.pData_m = &pObjData_p[7];
+        /* More objects than the index can hold */
+        errh_postFatalError(kErrSourceSapl, kErrorParamSetInvalidSize, currPos);
+    }
+    else if(paramSetLen_p - currPos < EPS_PARAMSET_HEADER_LENGTH)
+    {
+        /* Header of the object is cut off by the end of the parameter set */
+        errh_postFatalError(kErrSourceSapl, kErrorParamSetInvalidSize, paramSetLen_p);
+    }
+    else
+    {
+        /*
+         * Copy attributes of the current object byte wise because data
+         * inside the parameter set is not guaranteed to be aligned in memory!
+         */
+        SFS_NET_CPY16(&index, &pObjData[0]);
+        SFS_NET_CPY8(&subIndex, &pObjData[2]);
+        SFS_NET_CPY32(&length, &pObjData[3]);
 
-            parseObjRet = kParseObjBusy;
-            paramSetInstance_l.objectState_m = kObjStateVerifyParameters;
+        DEBUG_TRACE(DEBUG_LVL_SAPL, "Idx: 0x%x Sub: 0x%x Len: %d\n", index, subIndex, length);
 
-            DEBUG_TRACE(DEBUG_LVL_SAPL, "Idx: 0x%x Sub: 0x%x Len: %d\n", paramSetInstance_l.currObjAttr_m.index_m,
-                                        paramSetInstance_l.currObjAttr_m.subIndex_m,
-                                        paramSetInstance_l.currObjAttr_m.length_m);
+        pEntry = &aObjIndex_l[paramSetInstance_l.objCnt_m];
 
-            break;
-        }
-        case kObjStateVerifyParameters:
+        /* Check if current object is still inside the parameter set image */
+        if(length > paramSetLen_p - currPos - EPS_PARAMSET_HEADER_LENGTH)
         {
-            /* Check if current object is still inside the parameter set image */
-            if((currParamSetPos + paramSetInstance_l.currObjAttr_m.length_m) < paramSetLen_p)
-            {
-                parseObjRet = kParseObjBusy;
-                paramSetInstance_l.objectState_m = kObjStateGetSodAttributes;
-            }
-            else
-            {
-                /* Return kParseObjError! Length check failed! */
-                errh_postFatalError(kErrSourceShnf, kErrorObjTooLongForParameterSet, 0);
-            }
-
-            break;
+            errh_postFatalError(kErrSourceShnf, kErrorObjTooLongForParameterSet, 0);
         }
-        case kObjStateGetSodAttributes:
+        else
         {
             /* Get the SOD entry attribute of the current object */
-            paramSetInstance_l.currObjAttr_m.pCurrSodAttr_m = (SOD_t_ATTR *)SOD_AttrGet(B_INSTNUM_
-                          paramSetInstance_l.currObjAttr_m.index_m,
-                          paramSetInstance_l.currObjAttr_m.subIndex_m,
-                          &paramSetInstance_l.currObjAttr_m.objHdl_m,
-                          &fIsApplObj, &errRes
-                          );
-            if(paramSetInstance_l.currObjAttr_m.pCurrSodAttr_m != NULL)
+            pEntry->pSodAttr_m = (SOD_t_ATTR *)SOD_AttrGet(B_INSTNUM_ index, subIndex,
+                                                           &pEntry->objHdl_m,
+                                                           &fIsApplObj, &errRes);
+            if(pEntry->pSodAttr_m != NULL)
             {
-                parseObjRet = kParseObjBusy;
-                paramSetInstance_l.objectState_m = kObjStateWriteObjectToSod;
-            }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
-
-            break;
-        }
-        case kObjStateWriteObjectToSod:
-        {
-            if((paramSetInstance_l.currObjAttr_m.pCurrSodAttr_m->e_dataType == EPLS_k_DOMAIN) ||
-               (paramSetInstance_l.currObjAttr_m.pCurrSodAttr_m->e_dataType == EPLS_k_VISIBLE_STRING) ||
-               (paramSetInstance_l.currObjAttr_m.pCurrSodAttr_m->e_dataType == EPLS_k_OCTET_STRING))
-            {
-                /* Object is from type domain */
-                if(writeDomainToSod())
+                if(length > pEntry->pSodAttr_m->dw_objLen                    ||
+                   (isDomainObject(pEntry->pSodAttr_m) == FALSE &&
+                    length > sizeof(UINT64)                     )             )
                 {
-                    parseObjRet = kParseObjFinished;
-                    paramSetInstance_l.objectState_m = kObjStateGetParameters;
+                    /* The payload does not fit into the SOD entry or the write buffer */
+                    errh_postFatalError(kErrSourceShnf, kErrorObjTooLongForParameterSet, 0);
                 }
-            }
-            else
-            {
-                /* The object has a known datatype (e.g: UINT32) */
-                MEMCOPY(&objTmpData, paramSetInstance_l.currObjAttr_m.pData_m,
-                        paramSetInstance_l.currObjAttr_m.length_m);
-
-                if(SOD_Write(B_INSTNUM_
-                             paramSetInstance_l.currObjAttr_m.objHdl_m,
-                             FALSE,
-                             &objTmpData,
-                             TRUE, 0, 0))
+                else
                 {
-                    parseObjRet = kParseObjFinished;
-                    paramSetInstance_l.objectState_m = kObjStateGetParameters;
-                }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
+                    pEntry->offset_m = (UINT16)(currPos + EPS_PARAMSET_HEADER_LENGTH);
+                    pEntry->length_m = (UINT16)length;
 
-            }
-            break;
-        }
-        default:
-        {
-            /* Invalid object parsing state */
-            errh_postFatalError(kErrSourceShnf, kErrorInvalidState, 0);
-            break;
+                    paramSetInstance_l.objCnt_m++;
+                    paramSetInstance_l.currParamSetPos_m += EPS_PARAMSET_HEADER_LENGTH + length;
+
+                    if(paramSetInstance_l.currParamSetPos_m == paramSetLen_p)
+                    {
+                        /* End of parameter set reached */
+                        parseObjRet = kParseObjFinished;
+                    }
+                    else
+                    {
+                        parseObjRet = kParseObjBusy;
+                    }
+                }
+            }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
         }
     }
 
-    /* Set return value to length of the current handled object */
-    *pCurrObjLen_p = EPS_PARAMSET_HEADER_LENGTH + paramSetInstance_l.currObjAttr_m.length_m;
-
     return parseObjRet;
 }
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Write the data of a DOMAIN, O/VSTRING to the SOD
+\brief    Write an indexed object to the SOD
+
+The object is written with the SOD handle and attribute of the scan. The data
+of a DOMAIN, VSTRING or OSTRING is written directly from the parameter set
+together with its actual length, the data of a basic type is copied to an
+aligned buffer before.
+
+\param[in] pParamSetBase_p  Base address of the parameter set
+\param[in] pEntry_p         Index entry of the object
 
 \retval TRUE    Write to the SOD successful
 \retval FALSE   Unable to write to the SOD
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN writeDomainToSod(void)
+static BOOLEAN writeObjectToSod(UINT8 * pParamSetBase_p,
+                                const tObjectIndexEntry * pEntry_p)
 {
     BOOLEAN fReturn = FALSE;
+    UINT8 * pData = &pParamSetBase_p[pEntry_p->offset_m];
+    /* Consists of the object payload if datatype is known. (Provides aligned address) */
+    UINT64 objTmpData = 0;
 
-    /* Object is a DOMAIN, VSTRING or OSTRING */
-    if(SOD_Write(B_INSTNUM_
-                 paramSetInstance_l.currObjAttr_m.objHdl_m,
-                 FALSE,
-                 paramSetInstance_l.currObjAttr_m.pData_m,
-                 TRUE, 0,
-                 paramSetInstance_l.currObjAttr_m.length_m))
+    if(isDomainObject(pEntry_p->pSodAttr_m))
     {
-        /* Write the actual length of the object into the SOD */
-        if(SOD_ActualLenSet(B_INSTNUM_
-                            paramSetInstance_l.currObjAttr_m.objHdl_m,
-                            FALSE,
-                            paramSetInstance_l.currObjAttr_m.length_m))
+        /* Object is a DOMAIN, VSTRING or OSTRING */
+        if(SOD_Write(B_INSTNUM_ pEntry_p->objHdl_m, FALSE, pData, TRUE, 0,
+                     pEntry_p->length_m))
+        {
+            /* Write the actual length of the object into the SOD */
+            if(SOD_ActualLenSet(B_INSTNUM_ pEntry_p->objHdl_m, FALSE,
+                                pEntry_p->length_m))
+            {
+                fReturn = TRUE;
+            }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
+        }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
+    }
+    else
+    {
+        /* The object has a known datatype (e.g: UINT32) */
+        MEMCOPY(&objTmpData, pData, pEntry_p->length_m);
+
+        if(SOD_Write(B_INSTNUM_ pEntry_p->objHdl_m, FALSE, &objTmpData, TRUE, 0, 0))
         {
             fReturn = TRUE;
         }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
+    }
+
+    if(fReturn != FALSE)
+    {
+        paramcrc_objectWritten(pEntry_p->objHdl_m);
+    }
 
-    }   /* no else: Error is already reported via SAPL_SERR_SignalErrorClbk */
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if an SOD entry is a DOMAIN, VSTRING or OSTRING
+
+\param[in] pSodAttr_p   Attribute of the SOD entry
+
+\retval TRUE    Entry has a variable length
+\retval FALSE   Entry has a basic type
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN isDomainObject(const SOD_t_ATTR * pSodAttr_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if((pSodAttr_p->e_dataType == EPLS_k_DOMAIN) ||
+       (pSodAttr_p->e_dataType == EPLS_k_VISIBLE_STRING) ||
+       (pSodAttr_p->e_dataType == EPLS_k_OCTET_STRING))
+    {
+        fReturn = TRUE;
+    }
 
     return fReturn;
 }
@@ -56,6 +56,7 @@ get's time to do some calculation between each piece.
 #include <sapl/sapl.h>
 
 #include <shnf/shnf.h>
+#include <shnf/crcengine.h>
 
 #include <sn/statehandler.h>
 #include <sn/gpio.h>
@@ -65,12 +66,12 @@ get's time to do some calculation between each piece.
 #include <sapl/sodstore.h>
 #include <sapl/app.h>
 
+#include <sod.h>
+
 #include <SODapi.h>
 #include <SERRapi.h>
 #include <SNMTSapi.h>
 
-#include <oschecksum/crc.h>
-
 /*============================================================================*/
 /*            G L O B A L   D E F I N I T I O N S                             */
 /*============================================================================*/
@@ -134,6 +135,7 @@ typedef struct
     UINT32 activeTasks_m;             /**< Stores which task of the SAPL is currently active */
     UINT32 lastTask_m;                /**< Stores the last active task in the SAPL (Debug only!) */
     BOOLEAN fParamCrcValid_m;         /**< TRUE if the parameter CRC is valid */
+    BOOLEAN fSodVerified_m;           /**< TRUE if the parameter CRC was valid once since the start */
     tParamSetAttr paramSetAttr_m;     /**< Attributes of the SOD parameter set */
 } tSaplInstance;
 
@@ -284,7 +286,7 @@ BOOLEAN sapl_process(void)
             /* Reset the flag of the parameter store task */
             saplInstance_l.activeTasks_m &= ~(1<<SAPL_TASK_PROCESS_PARAM_SET_STORE_BIT);
 
-            /* Unable to restore the SOD (NVM is not empty!) */
+            /* Unable to store the SOD (Parameter set does not fit into a bank of the NVS!) */
             DEBUG_TRACE(DEBUG_LVL_ALWAYS, "FAILED!\n");
 
             fReturn = TRUE;
@@ -349,6 +351,7 @@ BOOLEAN sapl_processSync(void)
             SNMTS_PassParamChkSumValid(B_INSTNUM_ TRUE);
             fReturn = TRUE;
             saplInstance_l.fParamCrcValid_m = TRUE;
+            saplInstance_l.fSodVerified_m = TRUE;
 
             /* Reset the flag of the CRC calculator */
             saplInstance_l.activeTasks_m &= ~(1<<SAPL_TASK_PROCESS_PARAM_SET_CRC_BIT);
@@ -455,7 +458,7 @@ BOOLEAN sapl_restoreSod(BOOLEAN fRestoreSod_p)
         {
             procRet = paramset_process(pParamSetBase, paramSetLen);
 
-        } while(procRet != kParamProcFinished || procRet == kParamProcError);
+        } while(procRet == kParamProcBusy);
 
         if(procRet == kParamProcFinished)
         {
@@ -526,8 +529,10 @@ void SAPL_SNMTS_CalcParamChkSumClbk(BYTE_B_INSTNUM)
     b_instNum = b_instNum; /* To avoid warnings */
 #endif
 
-    /* Start the CRC calculation in the background */
-    paramcrc_startProcessing();
+    /* Start the CRC calculation in the background. The first verification
+     * after the start reads the whole SOD, a verification after a
+     * reconfiguration only reads the written objects */
+    paramcrc_startProcessing((saplInstance_l.fSodVerified_m == FALSE) ? TRUE : FALSE);
 
     /* Enable corresponding task in SAPL process */
     saplInstance_l.activeTasks_m |= (1<<SAPL_TASK_PROCESS_PARAM_SET_CRC_BIT);
@@ -642,6 +647,126 @@ BOOLEAN SAPL_SOD_ParameterSet_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
     return fReturn;
 }
 
+/*
+ * This function is called before and after the write access of
+ * the RxSPDO mapping parameters 0x1800 - 0x1BFE. The check before
+ * the write is done by the SPDO unit of the stack, the write is
+ * reported to the parameter CRC afterwards.
+ *
+ * \param B_INSTNUM    instance number
+ * \param e_srvc       type of service, see {SOD_t_SERVICE}
+ * \param ps_obj       pointer to the written SOD entry
+ * \param pv_data      pointer to data to be written, in case
+ *                     of SOD_k_SRV_BEFORE_WRITE, otherwise NULL
+ * \param dw_offset    start offset in bytes of the segment
+ *                     within the data block
+ * \param dw_size      size in bytes of the segment
+ * \param pe_abortCode abort code has to be set for the SSDO if
+ *                     the return value is FALSE.
+ *
+ * \return - TRUE  - success
+ *         - FALSE - failure
+ */
+BOOLEAN SAPL_SOD_RxMappPara_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                 const SOD_t_OBJECT *ps_obj,
+                                 const void *pv_data,
+                                 UINT32 dw_offset, UINT32 dw_size,
+                                 SOD_t_ABORT_CODES *pe_abortCode)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(e_srvc == SOD_k_SRV_AFTER_WRITE)
+    {
+        fReturn = SAPL_SOD_ParamCrc_CLBK(B_INSTNUM_ e_srvc, ps_obj, pv_data,
+                                         dw_offset, dw_size, pe_abortCode);
+    }
+    else
+    {
+        fReturn = SPDO_SOD_RxMappPara_CLBK(B_INSTNUM_ e_srvc, ps_obj, pv_data,
+                                           dw_offset, dw_size, pe_abortCode);
+    }
+
+    return fReturn;
+}
+
+/*
+ * This function is called before and after the write access of
+ * the TxSPDO mapping parameters 0xC000 - 0xC3FE. The check before
+ * the write is done by the SPDO unit of the stack, the write is
+ * reported to the parameter CRC afterwards.
+ *
+ * \param B_INSTNUM    instance number
+ * \param e_srvc       type of service, see {SOD_t_SERVICE}
+ * \param ps_obj       pointer to the written SOD entry
+ * \param pv_data      pointer to data to be written, in case
+ *                     of SOD_k_SRV_BEFORE_WRITE, otherwise NULL
+ * \param dw_offset    start offset in bytes of the segment
+ *                     within the data block
+ * \param dw_size      size in bytes of the segment
+ * \param pe_abortCode abort code has to be set for the SSDO if
+ *                     the return value is FALSE.
+ *
+ * \return - TRUE  - success
+ *         - FALSE - failure
+ */
+BOOLEAN SAPL_SOD_TxMappPara_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                 const SOD_t_OBJECT *ps_obj,
+                                 const void *pv_data,
+                                 UINT32 dw_offset, UINT32 dw_size,
+                                 SOD_t_ABORT_CODES *pe_abortCode)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(e_srvc == SOD_k_SRV_AFTER_WRITE)
+    {
+        fReturn = SAPL_SOD_ParamCrc_CLBK(B_INSTNUM_ e_srvc, ps_obj, pv_data,
+                                         dw_offset, dw_size, pe_abortCode);
+    }
+    else
+    {
+        fReturn = SPDO_SOD_TxMappPara_CLBK(B_INSTNUM_ e_srvc, ps_obj, pv_data,
+                                           dw_offset, dw_size, pe_abortCode);
+    }
+
+    return fReturn;
+}
+
+/*
+ * This function is called after the write access of the
+ * consecutive timebase 0x1200/0x03. The new timebase is taken
+ * over by the SHNF and the write is reported to the parameter CRC.
+ *
+ * \param B_INSTNUM    instance number
+ * \param e_srvc       type of service, see {SOD_t_SERVICE}
+ * \param ps_obj       pointer to the written SOD entry
+ * \param pv_data      pointer to data to be written (not used)
+ * \param dw_offset    start offset in bytes of the segment
+ *                     within the data block (not used)
+ * \param dw_size      size in bytes of the segment (not used)
+ * \param pe_abortCode abort code has to be set for the SSDO if
+ *                     the return value is FALSE.
+ *
+ * \return - TRUE  - success
+ *         - FALSE - failure
+ */
+BOOLEAN SAPL_SOD_ConsTimeBase_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                   const SOD_t_OBJECT *ps_obj,
+                                   const void *pv_data,
+                                   UINT32 dw_offset, UINT32 dw_size,
+                                   SOD_t_ABORT_CODES *pe_abortCode)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(SHNF_SOD_ConsTimeBase_CLBK(B_INSTNUM_ e_srvc, ps_obj, pv_data,
+                                  dw_offset, dw_size, pe_abortCode))
+    {
+        fReturn = SAPL_SOD_ParamCrc_CLBK(B_INSTNUM_ e_srvc, ps_obj, pv_data,
+                                         dw_offset, dw_size, pe_abortCode);
+    }
+
+    return fReturn;
+}
+
 /**
  * HNFiff_Crc32CalcSwp
  * calculates the checksymbols of a buffer (\a buf) of length \a len bytes,
@@ -660,7 +785,7 @@ BOOLEAN SAPL_SOD_ParameterSet_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
 UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length,
                            const void *pv_data)
 {
-    return crc32Checksum(l_length, (UINT8*)pv_data, w_initCrc);
+    return crcengine_calc(kCrcPolyCrc32, w_initCrc, (UINT32)l_length, pv_data);
 }
 
 /*============================================================================*/
@@ -8,7 +8,19 @@
 \brief  Stores and restores the SOD to non volatile memory
 
 This module stores the whole parameter set to non volatile memory which enables
-a fast bootup on SN start.
+a fast bootup on SN start. The NVS is split into two banks. A store writes the
+whole parameter set into the inactive bank while the image in the active bank
+stays valid. The new bank is committed by writing its sequence number as the
+last field, so an interrupted store leaves the previous image in place.
+
+Small changes of a parameter set with the same length are appended as patch
+entries to the journal behind the image of the active bank instead. One entry
+holds all changed bytes of one store. The restore takes the newest valid bank
+and applies its journal.
+
+The data is written in bursts which never cross a program page of the NVS.
+Each call writes as many bursts as fit into the time left until the next cycle
+and the CRC of the image is calculated while the data is written.
 
 \ingroup group_app_sn_sapl
 *******************************************************************************/
@@ -53,6 +65,11 @@ a fast bootup on SN start.
 #include <sapl/sodstore.h>
 
 #include <sn/nvs.h>
+#include <sn/cyclemon.h>
+
+#include <shnf/constime.h>
+
+#include <sod.h>
 
 /*============================================================================*/
 /*            G L O B A L   D E F I N I T I O N S                             */
@@ -61,12 +78,18 @@ a fast bootup on SN start.
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
-#define NVS_IMG_OFFSET_MAGIC        (UINT8)0x00         /**< Offset of the magic word field in the image */
-#define NVS_IMG_OFFSET_STATE        (UINT8)0x04         /**< Offset of the length field in the image */
-#define NVS_IMG_OFFSET_LENGTH       (UINT8)0x08         /**< Offset of the length field in the image */
-#define NVS_IMG_OFFSET_CRC32        (UINT8)0x0C         /**< Offset of the crc32 field in the image */
-#define NVS_IMG_OFFSET_DATA         (UINT8)0x10         /**< Offset of the data field in the image */
+#define NVS_IMG_OFFSET_MAGIC        (UINT8)0x00         /**< Offset of the magic word field in the bank */
+#define NVS_IMG_OFFSET_SEQUENCE     (UINT8)0x04         /**< Offset of the sequence number field in the bank */
+#define NVS_IMG_OFFSET_LENGTH       (UINT8)0x08         /**< Offset of the length field in the bank */
+#define NVS_IMG_OFFSET_CRC32        (UINT8)0x0C         /**< Offset of the crc32 field in the bank */
+#define NVS_IMG_OFFSET_DATA         (UINT8)0x10         /**< Offset of the data field in the bank */
 
+#define NVS_JRNL_OFFSET_LENGTH      (UINT8)0x00         /**< Offset of the entry length field in a journal entry */
+#define NVS_JRNL_OFFSET_PARAM_CRC   (UINT8)0x04         /**< Offset of the CRC32 of the patched parameter set */
+#define NVS_JRNL_OFFSET_ENTRY_CRC   (UINT8)0x08         /**< Offset of the CRC32 of the journal entry */
+#define NVS_JRNL_OFFSET_RUNS        (UINT8)0x0C         /**< Offset of the first patch run in a journal entry */
+
+#define NVS_JRNL_RUN_HEADER_LEN     (UINT8)0x04         /**< Length of the run header (UINT16 offset, UINT16 length) */
 
 /*----------------------------------------------------------------------------*/
 /* module global vars                                                         */
@@ -87,10 +110,36 @@ extern UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length,
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
-#define NVS_MAGIC_WORD                  (UINT32)0xdeadbeef      /**< Magic word which indicates the start of the SOD image */
-#define NVS_STATE_NVM_INVALID           (UINT32)0x00000001      /**< The value of the SOD image state field when the image is not valid */
+#define NVS_MAGIC_WORD                  (UINT32)0xdeadbe02      /**< Magic word which indicates the start of a bank */
+#define NVS_ERASED_WORD                 (UINT32)0xffffffff      /**< Value of an erased field (Sequence number of an uncommitted bank) */
+#define NVS_ERASED_BYTE                 (UINT8)0xff             /**< Value of an erased byte */
+
+#ifndef SODSTORE_BUDGET_RESERVE
+  #define SODSTORE_BUDGET_RESERVE       (UINT32)100     /**< Time in us which is kept free before the start of the next cycle */
+#endif
+
+#ifndef SODSTORE_BUDGET_NO_CYCLE
+  #define SODSTORE_BUDGET_NO_CYCLE      (UINT32)1000    /**< Write budget in us of one call while the cycle time is unknown */
+#endif
+
+#ifndef SODSTORE_JOURNAL_ENTRY_MAX
+  #define SODSTORE_JOURNAL_ENTRY_MAX    (UINT32)64      /**< Maximum length of a journal entry (Larger changes are stored to the other bank) */
+#endif
 
-#define NVS_IMAGE_DATA_CHUNK_SIZE       (UINT8)8                /**< Size of one chunk written to the NVS in one process cycle (Needs to be a divider of 4) */
+#ifndef SODSTORE_BLANK_CHECK_LEN
+  #define SODSTORE_BLANK_CHECK_LEN      (UINT32)0x400   /**< Bytes of a sector which are checked for an erased state per call */
+#endif
+
+#if (SAPL_k_MAX_PARAM_SET_LEN > 0xFFFF)
+  #error "The runs of the journal address the parameter set with UINT16 offsets"
+#endif
+
+#define SODSTORE_JOURNAL_ALIGN          (UINT32)8       /**< Alignment of the journal entries */
+#define SODSTORE_JOURNAL_RUN_GAP        NVS_JRNL_RUN_HEADER_LEN     /**< Shorter gaps of unchanged bytes are merged into one run */
+
+#define SODSTORE_TIME_FRAC_BITS         4               /**< Fractional bits of the program time estimate */
+#define SODSTORE_LEARN_MIN_ACCESS       8               /**< Minimum number of accesses of a burst to update the estimate */
+#define SODSTORE_COST_DECAY_SHIFT       3               /**< The estimate follows a shorter program time by 1/8 of the difference */
 
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
@@ -103,19 +152,50 @@ typedef enum
 {
     kSodStoreStateInvalid       = 0x0,  /**< Invalid state of the SOD store module */
     kSodStoreStateInit          = 0x1,  /**< SOD store is in init state */
-    kSodStoreStateAddCrc        = 0x2,  /**< Calculate a CRC over the parameter set */
-    kSodStoreStateProcess       = 0x3,  /**< SOD store is currently processing */
+    kSodStoreStateAddCrc        = 0x2,  /**< Store the CRC calculated over the written parameter set */
+    kSodStoreStateProcess       = 0x3,  /**< SOD store is currently writing the parameter set */
     kSodStoreStateFinished      = 0x4,  /**< Finished to store objects to the NVS */
+    kSodStoreStateErase         = 0x5,  /**< Erase the sectors of the inactive bank */
+    kSodStoreStateHeader        = 0x6,  /**< Write the header of the inactive bank */
+    kSodStoreStateCommit        = 0x7,  /**< Write the sequence number which makes the new bank valid */
+    kSodStoreStateJournal       = 0x8,  /**< Append a journal entry to the active bank */
 } tSodStoreState;
 
+/**
+ * \brief Description of the newest valid image in the NVS
+ */
+typedef struct
+{
+    UINT32 bankOffs_m;                   /**< Offset of the bank of the image */
+    UINT32 sequence_m;                   /**< Sequence number of the bank */
+    UINT32 length_m;                     /**< Length of the parameter set */
+    UINT32 journalOffs_m;                /**< Offset of the next free journal entry */
+    BOOLEAN fJournalOpen_m;              /**< TRUE if entries can be appended to the journal */
+    UINT32 entryCnt_m;                   /**< Number of applied journal entries */
+    UINT8* pParamSet_m;                  /**< The restored parameter set (NVS or restore buffer) */
+} tSodStoreImage;
+
 /**
  * \brief SOD store module instance type
  */
 typedef struct
 {
     tSodStoreState sodStoreState_m;      /**< The current state of the SOD store module */
-    UINT32 currDataPos_m;                /**< Current image write position */
-    UINT32 currParamSetOffs_m;           /**< Write offset in the current parameter set */
+    UINT32 currDataPos_m;                /**< Current write position in the NVS */
+    UINT32 currParamSetOffs_m;           /**< Write offset in the current data */
+    UINT32 paramCrc_m;                   /**< CRC32 of the parameter set written so far */
+    UINT32 bankSize_m;                   /**< Size of one bank (Multiple of the sector size) */
+    UINT32 bankOffs_m;                   /**< Offset of the bank which is currently written */
+    UINT32 sequence_m;                   /**< Sequence number of the bank which is currently written */
+    UINT32 eraseOffs_m;                  /**< Offset of the sector which is currently erased */
+    UINT32 checkOffs_m;                  /**< Offset of the next blank check in the erased sector */
+    UINT32 entryLen_m;                   /**< Length of the journal entry which is currently written */
+    BOOLEAN fJournalSupported_m;         /**< TRUE if the NVS can program the journal entries */
+    UINT64 storeStart_m;                 /**< Time base at the start of the current store */
+    UINT64 lastWriteCycle_m;             /**< Start of the cycle of the last written burst */
+    tNvsGeometry geometry_m;             /**< Programming characteristics of the NVS */
+    UINT32 accessTimeEst_m;              /**< Estimated time to program one access (us with SODSTORE_TIME_FRAC_BITS) */
+    tSodStoreStatistics stat_m;          /**< Statistics of the SOD store */
 } tSodStoreInstance;
 
 /*----------------------------------------------------------------------------*/
@@ -123,16 +203,37 @@ typedef struct
 /*----------------------------------------------------------------------------*/
 static tSodStoreInstance sodStoreInstance_l;
 
+/* Parameter set with the journal applied (UINT32 for aligned accesses) */
+static UINT32 aRestoreBuf_l[(SAPL_k_MAX_PARAM_SET_LEN + sizeof(UINT32) - 1) / sizeof(UINT32)];
+
+/* Journal entry which is currently written */
+static UINT32 aJournalEntry_l[SODSTORE_JOURNAL_ENTRY_MAX / sizeof(UINT32)];
+
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN eraseNvsSector(UINT32 offset_p);
+static void startStore(UINT8* pParamSetBase_p, UINT32 paramSetLen_p);
+static BOOLEAN eraseBankSector(void);
+static BOOLEAN isBlank(UINT32 offset_p, UINT32 length_p);
 static BOOLEAN storeHeaderToNvs(UINT32 paramSetLen_p);
-
-static BOOLEAN verifyMagic(void);
-static BOOLEAN verifyState(void);
-static BOOLEAN markStateInvalid(void);
-static BOOLEAN verifyParamSetCrc(UINT32 paramSetLen_p);
+static BOOLEAN storeUint32ToNvs(UINT32 offset_p, UINT32 value_p);
+static BOOLEAN writeData(UINT8* pData_p, UINT32 dataLen_p);
+static BOOLEAN writeBurst(UINT8* pData_p, UINT32 burstLen_p);
+static UINT32 getWriteBudget(void);
+static BOOLEAN isWriteDue(UINT32 budget_p, UINT32 length_p);
+static BOOLEAN fitsIntoBudget(UINT32 budget_p, UINT32 elapsed_p);
+static UINT32 getBurstLength(UINT32 budget_p, UINT32 remaining_p);
+
+static BOOLEAN findImage(tSodStoreImage* pImage_p);
+static BOOLEAN verifyBankHeader(UINT32 bankOffs_p, UINT32* pSequence_p, UINT32* pParamSetLen_p);
+static BOOLEAN verifyParamSetCrc(UINT32 bankOffs_p, UINT32 paramSetLen_p);
+static BOOLEAN restoreJournal(tSodStoreImage* pImage_p);
+static BOOLEAN parseJournalEntry(UINT32 entryOffs_p, UINT32 paramSetLen_p, UINT8* pParamSet_p,
+                                 UINT32* pEntryLen_p, UINT32* pParamCrc_p);
+static UINT32 buildJournalEntry(UINT8* pParamSetBase_p, const UINT8* pCurrParamSet_p,
+                                UINT32 paramSetLen_p);
+static UINT32 getJournalStart(UINT32 bankOffs_p, UINT32 paramSetLen_p);
+static UINT32 readUint32(const UINT8* pData_p);
 
 /*============================================================================*/
 /*            P U B L I C   F U N C T I O N S                                 */
@@ -149,6 +250,7 @@ static BOOLEAN verifyParamSetCrc(UINT32 paramSetLen_p);
 BOOLEAN sodstore_init(void)
 {
     BOOLEAN fReturn = FALSE;
+    tNvsGeometry* pGeometry = &sodStoreInstance_l.geometry_m;
 
     MEMSET(&sodStoreInstance_l, 0, sizeof(tSodStoreInstance));
 
@@ -157,7 +259,35 @@ BOOLEAN sodstore_init(void)
     /* Initialize the non volatile storage on this target */
     if(nvs_init())
     {
-        fReturn = TRUE;
+        nvs_getGeometry(pGeometry);
+
+        if(pGeometry->progGranularity_m > 0 && pGeometry->sectorSize_m > 0)
+        {
+            /* Each bank starts at a sector boundary */
+            sodStoreInstance_l.bankSize_m = ((pGeometry->storageSize_m / 2) / pGeometry->sectorSize_m) *
+                                            pGeometry->sectorSize_m;
+        }
+
+        if(sodStoreInstance_l.bankSize_m > NVS_IMG_OFFSET_DATA                 &&
+           pGeometry->pageSize_m >= pGeometry->progGranularity_m                )
+        {
+            /* Journal entries start at an access of the NVS */
+            if((SODSTORE_JOURNAL_ALIGN % pGeometry->progGranularity_m) == 0)
+            {
+                sodStoreInstance_l.fJournalSupported_m = TRUE;
+            }
+
+            /* Start with the nominal program time of the target */
+            sodStoreInstance_l.accessTimeEst_m =
+                (pGeometry->pageProgTime_m << SODSTORE_TIME_FRAC_BITS) /
+                (pGeometry->pageSize_m / pGeometry->progGranularity_m);
+
+            fReturn = TRUE;
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceSapl, kErrorInvalidParameter, 0);
+        }
     }
     else
     {
@@ -182,17 +312,32 @@ void sodstore_close(void)
 /**
 \brief    Prepare the SOD storage
 
+Erases the sectors of both banks which are not blank. No image is restored on
+the next boot until a new parameter set is stored.
+
 \return TRUE on success; FALSE on error
 */
 /*----------------------------------------------------------------------------*/
 BOOLEAN sodstore_prepareStorage(void)
 {
-    BOOLEAN fReturn = FALSE;
+    BOOLEAN fReturn = TRUE;
+    UINT32 sectorSize = sodStoreInstance_l.geometry_m.sectorSize_m;
+    UINT32 offset;
 
-    /* Erase the sector behind the offset before storing data to it */
-    if(eraseNvsSector(NVS_IMG_OFFSET_MAGIC))
+    for(offset = 0; offset < 2 * sodStoreInstance_l.bankSize_m; offset += sectorSize)
     {
-        fReturn = TRUE;
+        if(isBlank(offset, sectorSize) == FALSE)
+        {
+            if(nvs_erase(offset))
+            {
+                sodStoreInstance_l.stat_m.eraseCnt_m++;
+            }
+            else
+            {
+                fReturn = FALSE;
+                break;
+            }
+        }
     }
 
     return fReturn;
@@ -205,16 +350,15 @@ BOOLEAN sodstore_prepareStorage(void)
 \param pParamSetBase_p      The base address of the parameter set
 \param paramSetLen_p        The length of the parameter set
 
-\retval kSodStoreProcError      Error on processing
-\retval kSodStoreProcBusy       Processing is currently busy
-\retval kSodStoreProcFinished   Finished processing
+\retval kSodStoreProcError          Error on processing
+\retval kSodStoreProcBusy           Processing is currently busy
+\retval kSodStoreProcFinished       Finished processing
+\retval kSodStoreProcNotApplicable  The parameter set does not fit into a bank
 */
 /*----------------------------------------------------------------------------*/
 tProcStoreRet sodstore_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
 {
     tProcStoreRet sodStoreRet = kSodStoreProcError;
-    UINT32 writeChunkSize;
-    UINT8 writeRet;
     UINT32 paramCrc;
 
     if(pParamSetBase_p != NULL && paramSetLen_p > 0)
@@ -223,52 +367,96 @@ tProcStoreRet sodstore_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
         {
             case kSodStoreStateInit:
             {
-                /* Check if there is an SOD image in the NVM */
-                if(verifyMagic())
+                if(NVS_IMG_OFFSET_DATA + paramSetLen_p > sodStoreInstance_l.bankSize_m)
                 {
-                    /* NVM is full -> Mark image as invalid. (Store possible on the next boot!) */
-                    if(markStateInvalid())
-                    {
-                        sodStoreRet = kSodStoreProcNotApplicable;
-                    }
+                    /* The parameter set can not be stored */
+                    sodStoreRet = kSodStoreProcNotApplicable;
                 }
                 else
                 {
-                    /* NVM is empty -> Store is possible! */
                     DEBUG_TRACE(DEBUG_LVL_SAPL, "\nStore parameter set to NVS -> ");
 
-                    sodStoreInstance_l.currDataPos_m = NVS_IMG_OFFSET_DATA;
+                    sodStoreInstance_l.storeStart_m = constime_getTimeBase();
+                    sodStoreInstance_l.lastWriteCycle_m = cyclemon_getCycleStart();
+
+                    /* Select between a journal entry and a store to the other bank */
+                    startStore(pParamSetBase_p, paramSetLen_p);
+
+                    sodStoreRet = kSodStoreProcBusy;
+                }
+
+                break;
+            }
+            case kSodStoreStateErase:
+            {
+                /* Erase one sector of the inactive bank per call */
+                if(eraseBankSector())
+                {
+                    if(sodStoreInstance_l.eraseOffs_m ==
+                       sodStoreInstance_l.bankOffs_m + sodStoreInstance_l.bankSize_m)
+                    {
+                        sodStoreInstance_l.sodStoreState_m = kSodStoreStateHeader;
+                    }
+
+                    sodStoreRet = kSodStoreProcBusy;
+                }
+
+                break;
+            }
+            case kSodStoreStateHeader:
+            {
+                if(isWriteDue(getWriteBudget(), 2 * sizeof(UINT32)) == FALSE)
+                {
+                    /* Wait for the next cycle */
+                    sodStoreRet = kSodStoreProcBusy;
+                }
+                else if(storeHeaderToNvs(paramSetLen_p))
+                {
+                    /* The header information is stored to the NVS */
+                    sodStoreInstance_l.currDataPos_m = sodStoreInstance_l.bankOffs_m + NVS_IMG_OFFSET_DATA;
                     sodStoreInstance_l.currParamSetOffs_m = 0;
+                    sodStoreInstance_l.paramCrc_m = 0;
+
+                    /* Switch the current state to write the parameter set */
+                    sodStoreInstance_l.sodStoreState_m = kSodStoreStateProcess;
+
+                    sodStoreRet = kSodStoreProcBusy;
+                }
 
-                    /* Store the header information to the NVS */
-                    if(storeHeaderToNvs(paramSetLen_p))
+                break;
+            }
+            case kSodStoreStateProcess:
+            {
+                /* Write the bursts which fit into the remaining cycle time */
+                if(writeData(pParamSetBase_p, paramSetLen_p))
+                {
+                    if(sodStoreInstance_l.currParamSetOffs_m == paramSetLen_p)
                     {
-                        /* Switch the current state to add CRC */
+                        /* All data is written -> Store the CRC */
                         sodStoreInstance_l.sodStoreState_m = kSodStoreStateAddCrc;
-
-                        sodStoreRet = kSodStoreProcBusy;
                     }
+
+                    sodStoreRet = kSodStoreProcBusy;
                 }
 
                 break;
             }
             case kSodStoreStateAddCrc:
             {
-                /* Calculate a CRC32 over all parameters */
-                paramCrc = HNFiff_Crc32CalcSwp(0, paramSetLen_p, pParamSetBase_p);
+                /* The CRC32 over all parameters was calculated during the write */
+                paramCrc = sodStoreInstance_l.paramCrc_m;
                 if(paramCrc > 0)
                 {
-                    /* Store the CRC32 at the end of the header info in the NVS */
-                    writeRet = nvs_write(NVS_IMG_OFFSET_CRC32, (UINT8*)&paramCrc, sizeof(paramCrc));
-                    if(writeRet == TRUE)
+                    if(isWriteDue(getWriteBudget(), sizeof(paramCrc)) == FALSE)
                     {
-                        /* Perform switch to process state */
-                        sodStoreInstance_l.sodStoreState_m = kSodStoreStateProcess;
+                        /* Wait for the next cycle */
                         sodStoreRet = kSodStoreProcBusy;
                     }
-                    else
+                    /* Store the CRC32 at the end of the header info in the NVS */
+                    else if(storeUint32ToNvs(sodStoreInstance_l.bankOffs_m + NVS_IMG_OFFSET_CRC32, paramCrc))
                     {
-                        errh_postFatalError(kErrSourceSapl, kErrorSodStoreWriteError, 0);
+                        sodStoreInstance_l.sodStoreState_m = kSodStoreStateCommit;
+                        sodStoreRet = kSodStoreProcBusy;
                     }
                 }
                 else
@@ -277,57 +465,52 @@ tProcStoreRet sodstore_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
                 }
                 break;
             }
-            case kSodStoreStateProcess:
+            case kSodStoreStateCommit:
             {
-                if((sodStoreInstance_l.currParamSetOffs_m + NVS_IMAGE_DATA_CHUNK_SIZE) < paramSetLen_p)
+                if(isWriteDue(getWriteBudget(), sizeof(sodStoreInstance_l.sequence_m)) == FALSE)
                 {
-                    /* The next write cycle is a full chunk */
-                    writeChunkSize = NVS_IMAGE_DATA_CHUNK_SIZE;
+                    /* Wait for the next cycle */
+                    sodStoreRet = kSodStoreProcBusy;
                 }
-                else
+                /* The sequence number makes the new bank the active one */
+                else if(storeUint32ToNvs(sodStoreInstance_l.bankOffs_m + NVS_IMG_OFFSET_SEQUENCE,
+                                         sodStoreInstance_l.sequence_m))
                 {
-                    /* Get the length of the last chunk of data */
-                    writeChunkSize = paramSetLen_p - sodStoreInstance_l.currParamSetOffs_m;
-                }
+                    sodStoreInstance_l.stat_m.fullStoreCnt_m++;
 
-                /* Write the next data chunk to the NVS */
-                writeRet = nvs_write(sodStoreInstance_l.currDataPos_m,
-                                     pParamSetBase_p + sodStoreInstance_l.currParamSetOffs_m,
-                                     writeChunkSize);
-                if(writeRet == TRUE)
+                    /* Perform switch to finished state */
+                    sodStoreInstance_l.sodStoreState_m = kSodStoreStateFinished;
+                    sodStoreRet = kSodStoreProcBusy;
+                }
+                break;
+            }
+            case kSodStoreStateJournal:
+            {
+                /* Append the journal entry in bursts */
+                if(writeData((UINT8*)aJournalEntry_l, sodStoreInstance_l.entryLen_m))
                 {
-                    sodStoreInstance_l.currDataPos_m += writeChunkSize;
-                    sodStoreInstance_l.currParamSetOffs_m += writeChunkSize;
-
-                    if(sodStoreInstance_l.currParamSetOffs_m < paramSetLen_p)
+                    if(sodStoreInstance_l.currParamSetOffs_m == sodStoreInstance_l.entryLen_m)
                     {
-                        sodStoreRet = kSodStoreProcBusy;
-                    }
-                    else if(sodStoreInstance_l.currParamSetOffs_m == paramSetLen_p)
-                    {
-                        /* Switch to finished state */
+                        sodStoreInstance_l.stat_m.journalCnt_m++;
+
                         sodStoreInstance_l.sodStoreState_m = kSodStoreStateFinished;
-                        sodStoreRet = kSodStoreProcBusy;
                     }
-                    else
-                    {
-                        /* Image has an invalid size! */
-                        errh_postFatalError(kErrSourceSapl, kErrorSodStoreSizeMissmatch,
-                                            sodStoreInstance_l.currParamSetOffs_m);
-                    }
-                }
-                else
-                {
-                    errh_postFatalError(kErrSourceSapl, kErrorSodStoreWriteError, 0);
+
+                    sodStoreRet = kSodStoreProcBusy;
                 }
 
                 break;
             }
             case kSodStoreStateFinished:
             {
+                sodStoreInstance_l.stat_m.storeCnt_m++;
+                sodStoreInstance_l.stat_m.storeTime_m =
+                    (UINT32)(constime_getTimeBase() - sodStoreInstance_l.storeStart_m);
+
                 /* Reset internal structures */
                 sodStoreInstance_l.currDataPos_m = 0;
                 sodStoreInstance_l.currParamSetOffs_m = 0;
+                sodStoreInstance_l.paramCrc_m = 0;
 
                 /* Reset state to init */
                 sodStoreInstance_l.sodStoreState_m = kSodStoreStateInit;
@@ -356,6 +539,9 @@ tProcStoreRet sodstore_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
 /**
 \brief    Verify the SOD image in the NVS and return the image parameters
 
+The newest valid bank is taken and its journal is applied. Without journal
+entries the image points directly to the NVS.
+
 \param[out] ppParamSetBase_p      Pointer to the base address of the image
 \param[out] pParamSetLen_p        Pointer to the length of the image
 
@@ -366,33 +552,17 @@ tProcStoreRet sodstore_process(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
 BOOLEAN sodstore_getSodImage(UINT8** ppParamSetBase_p, UINT32* pParamSetLen_p)
 {
     BOOLEAN fReturn = FALSE;
-    UINT32 * pParamSetLen = NULL;
+    tSodStoreImage image;
 
     if(ppParamSetBase_p != NULL && pParamSetLen_p != NULL)
     {
-        /* Verify if there is a magic word */
-        if(verifyMagic())
+        if(findImage(&image))
         {
-            /* Verify the state field if the SOD image is valid */
-            if(verifyState())
-            {
-                /* Read the length of the parameter set */
-                if(nvs_readUint32(NVS_IMG_OFFSET_LENGTH, &pParamSetLen))
-                {
-                    if(*pParamSetLen > 0 && *pParamSetLen < UINT32_MAX)
-                    {
-                        /* Verify if the CRC stored in the flash matches the data stream */
-                        if(verifyParamSetCrc(*pParamSetLen))
-                        {
-                            /* Set the output values */
-                            *ppParamSetBase_p = nvs_getAddress(NVS_IMG_OFFSET_DATA);
-                            *pParamSetLen_p = *pParamSetLen;
-
-                            fReturn = TRUE;
-                        }
-                    }
-                }
-            }
+            /* Set the output values */
+            *ppParamSetBase_p = image.pParamSet_m;
+            *pParamSetLen_p = image.length_m;
+
+            fReturn = TRUE;
         }
     }
     else
@@ -403,6 +573,22 @@ BOOLEAN sodstore_getSodImage(UINT8** ppParamSetBase_p, UINT32* pParamSetLen_p)
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the SOD store
+
+\param[out] pStat_p     Pointer to the statistics
+*/
+/*----------------------------------------------------------------------------*/
+void sodstore_getStatistics(tSodStoreStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &sodStoreInstance_l.stat_m, sizeof(tSodStoreStatistics));
+        pStat_p->accessTimeEst_m = sodStoreInstance_l.accessTimeEst_m;
+    }
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -411,57 +597,314 @@ BOOLEAN sodstore_getSodImage(UINT8** ppParamSetBase_p, UINT32* pParamSetLen_p)
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Erase the memory before storing the new parameter set
+\brief    Select how the parameter set is stored
+
+A parameter set with the same length as the current image is appended to the
+journal if the changed bytes fit into one entry. Otherwise it is stored to the
+inactive bank, the current image stays valid until the new bank is committed.
+
+\param pParamSetBase_p      The base address of the parameter set
+\param paramSetLen_p        The length of the parameter set
+*/
+/*----------------------------------------------------------------------------*/
+static void startStore(UINT8* pParamSetBase_p, UINT32 paramSetLen_p)
+{
+    tSodStoreImage image;
+    UINT32 entryLen = 0;
+
+    if(findImage(&image))
+    {
+        if(sodStoreInstance_l.fJournalSupported_m != FALSE        &&
+           image.fJournalOpen_m != FALSE                          &&
+           image.length_m == paramSetLen_p                        &&
+           paramSetLen_p <= SAPL_k_MAX_PARAM_SET_LEN               )
+        {
+            entryLen = buildJournalEntry(pParamSetBase_p, image.pParamSet_m, paramSetLen_p);
+            if(entryLen > image.bankOffs_m + sodStoreInstance_l.bankSize_m - image.journalOffs_m)
+            {
+                /* The journal is full */
+                entryLen = 0;
+            }
+        }
+
+        /* Store to the other bank */
+        sodStoreInstance_l.bankOffs_m = (image.bankOffs_m == 0) ? sodStoreInstance_l.bankSize_m : 0;
+        sodStoreInstance_l.sequence_m = image.sequence_m + 1;
+        if(sodStoreInstance_l.sequence_m == NVS_ERASED_WORD)
+        {
+            sodStoreInstance_l.sequence_m = 0;
+        }
+    }
+    else
+    {
+        /* No valid image -> Start with the first bank */
+        sodStoreInstance_l.bankOffs_m = 0;
+        sodStoreInstance_l.sequence_m = 0;
+    }
+
+    if(entryLen == NVS_JRNL_OFFSET_RUNS)
+    {
+        /* The parameter set is already stored */
+        sodStoreInstance_l.sodStoreState_m = kSodStoreStateFinished;
+    }
+    else if(entryLen > 0)
+    {
+        sodStoreInstance_l.currDataPos_m = image.journalOffs_m;
+        sodStoreInstance_l.currParamSetOffs_m = 0;
+        sodStoreInstance_l.entryLen_m = entryLen;
+
+        sodStoreInstance_l.sodStoreState_m = kSodStoreStateJournal;
+    }
+    else
+    {
+        sodStoreInstance_l.eraseOffs_m = sodStoreInstance_l.bankOffs_m;
+        sodStoreInstance_l.checkOffs_m = sodStoreInstance_l.bankOffs_m;
+
+        sodStoreInstance_l.sodStoreState_m = kSodStoreStateErase;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Erase the current sector of the inactive bank if it is not blank
 
-\param offset_p      The offset of the memory to erase
+The sector is checked in parts of SODSTORE_BLANK_CHECK_LEN per call. A sector
+which is already blank is not erased. The erase of a sector can not be split
+and stalls the CPU on the targets.
 
-\retval TRUE    Success on erase
+\retval TRUE    Success on check or erase
 \retval FALSE   Error on erase
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN eraseNvsSector(UINT32 offset_p)
+static BOOLEAN eraseBankSector(void)
 {
-    BOOLEAN fReturn = FALSE;
+    BOOLEAN fReturn = TRUE;
+    UINT32 sectorEnd = sodStoreInstance_l.eraseOffs_m + sodStoreInstance_l.geometry_m.sectorSize_m;
+    UINT32 checkLen = sectorEnd - sodStoreInstance_l.checkOffs_m;
 
-    if(nvs_erase(offset_p))
+    if(checkLen > SODSTORE_BLANK_CHECK_LEN)
     {
-        fReturn = TRUE;
+        checkLen = SODSTORE_BLANK_CHECK_LEN;
+    }
+
+    if(isBlank(sodStoreInstance_l.checkOffs_m, checkLen))
+    {
+        sodStoreInstance_l.checkOffs_m += checkLen;
+        if(sodStoreInstance_l.checkOffs_m == sectorEnd)
+        {
+            sodStoreInstance_l.stat_m.eraseSkipCnt_m++;
+            sodStoreInstance_l.eraseOffs_m = sectorEnd;
+        }
+    }
+    else
+    {
+        if(nvs_erase(sodStoreInstance_l.eraseOffs_m))
+        {
+            sodStoreInstance_l.stat_m.eraseCnt_m++;
+            sodStoreInstance_l.eraseOffs_m = sectorEnd;
+            sodStoreInstance_l.checkOffs_m = sectorEnd;
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceSapl, kErrorSodStoreWriteError, 0);
+            fReturn = FALSE;
+        }
     }
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if an area of the NVS is erased
+
+\param offset_p     Offset of the area
+\param length_p     Length of the area
+
+\retval TRUE    All bytes are erased
+\retval FALSE   The area contains programmed bytes
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN isBlank(UINT32 offset_p, UINT32 length_p)
+{
+    BOOLEAN fBlank = TRUE;
+    const UINT8* pData = nvs_getAddress(offset_p);
+    UINT32 i;
+
+    for(i = 0; i < length_p; i++)
+    {
+        if(pData[i] != NVS_ERASED_BYTE)
+        {
+            fBlank = FALSE;
+            break;
+        }
+    }
+
+    return fBlank;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Store the header of the parameter set into flash
 
+The sequence number and the CRC are written after the parameter set.
+
 \param paramSetLen_p      The length of the parameter set
 
-\retval TRUE    Success on erase
-\retval FALSE   Error on erase
+\retval TRUE    Success on write
+\retval FALSE   Error on write
 */
 /*----------------------------------------------------------------------------*/
 static BOOLEAN storeHeaderToNvs(UINT32 paramSetLen_p)
 {
     BOOLEAN fReturn = FALSE;
-    UINT32 nvsMagic = NVS_MAGIC_WORD;
-    BOOLEAN writeRet = FALSE;
 
-    /* Write magic to the start of the SOD image */
-    writeRet = nvs_write(NVS_IMG_OFFSET_MAGIC, (UINT8*)&nvsMagic, sizeof(nvsMagic));
-    if(writeRet == TRUE)
+    /* Write magic to the start of the bank */
+    if(storeUint32ToNvs(sodStoreInstance_l.bankOffs_m + NVS_IMG_OFFSET_MAGIC, NVS_MAGIC_WORD))
     {
         /* Write the size of the image to the NVS */
-        writeRet = nvs_write(NVS_IMG_OFFSET_LENGTH,
-                             (UINT8*)&paramSetLen_p, sizeof(paramSetLen_p));
-        if(writeRet == TRUE)
+        if(storeUint32ToNvs(sodStoreInstance_l.bankOffs_m + NVS_IMG_OFFSET_LENGTH, paramSetLen_p))
         {
             fReturn = TRUE;
         }
-        else
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Store a header field into flash
+
+\param offset_p     Offset of the field in the NVS
+\param value_p      The value of the field
+
+\retval TRUE    Success on write
+\retval FALSE   Error on write
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN storeUint32ToNvs(UINT32 offset_p, UINT32 value_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(nvs_write(offset_p, (UINT8*)&value_p, sizeof(value_p)))
+    {
+        fReturn = TRUE;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceSapl, kErrorSodStoreWriteError, 0);
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Write the bursts of the data which fit into the budget
+
+Bursts are written while at least one access fits into the time left until
+the next cycle.
+
+\param pData_p      The base address of the data (Parameter set or journal entry)
+\param dataLen_p    The length of the data
+
+\retval TRUE    Success on write or nothing to write in this call
+\retval FALSE   Error on write
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN writeData(UINT8* pData_p, UINT32 dataLen_p)
+{
+    BOOLEAN fReturn = TRUE;
+    UINT64 callStart = constime_getTimeBase();
+    UINT32 budget = getWriteBudget();
+    UINT32 elapsed = 0;
+    UINT32 burstLen;
+
+    if(isWriteDue(budget, sodStoreInstance_l.geometry_m.progGranularity_m))
+    {
+        do
         {
-            errh_postFatalError(kErrSourceSapl, kErrorSodStoreWriteError, 0);
+            burstLen = getBurstLength(budget - elapsed,
+                                      dataLen_p - sodStoreInstance_l.currParamSetOffs_m);
+
+            fReturn = writeBurst(pData_p, burstLen);
+
+            elapsed = (UINT32)(constime_getTimeBase() - callStart);
+        } while(fReturn != FALSE                                            &&
+                sodStoreInstance_l.currParamSetOffs_m < dataLen_p           &&
+                fitsIntoBudget(budget, elapsed) != FALSE                     );
+
+        sodStoreInstance_l.stat_m.processCnt_m++;
+        if(elapsed > budget)
+        {
+            sodStoreInstance_l.stat_m.budgetOverrunCnt_m++;
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Program one burst of the data and add it to the CRC
+
+The burst starts at the current write position. Its program time updates the
+estimated time of one access. Short bursts are dominated by the call overhead
+and do not update the estimate.
+
+\param pData_p          The base address of the data
+\param burstLen_p       The length of the burst
+
+\retval TRUE    Success on write
+\retval FALSE   Error on write
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN writeBurst(UINT8* pData_p, UINT32 burstLen_p)
+{
+    BOOLEAN fReturn = FALSE;
+    UINT8* pBurst = pData_p + sodStoreInstance_l.currParamSetOffs_m;
+    UINT32 accessCnt;
+    UINT32 accessTime;
+    UINT64 burstStart;
+
+    burstStart = constime_getTimeBase();
+
+    if(nvs_write(sodStoreInstance_l.currDataPos_m, pBurst, burstLen_p))
+    {
+        accessCnt = (burstLen_p + sodStoreInstance_l.geometry_m.progGranularity_m - 1) /
+                    sodStoreInstance_l.geometry_m.progGranularity_m;
+        if(accessCnt >= SODSTORE_LEARN_MIN_ACCESS)
+        {
+            accessTime = (((UINT32)(constime_getTimeBase() - burstStart)) << SODSTORE_TIME_FRAC_BITS) /
+                         accessCnt;
+
+            if(accessTime > sodStoreInstance_l.accessTimeEst_m)
+            {
+                sodStoreInstance_l.accessTimeEst_m = accessTime;
+            }
+            else
+            {
+                sodStoreInstance_l.accessTimeEst_m -=
+                    (sodStoreInstance_l.accessTimeEst_m - accessTime) >> SODSTORE_COST_DECAY_SHIFT;
+            }
+        }
+
+        /* Continue the CRC over the written data */
+        sodStoreInstance_l.paramCrc_m = HNFiff_Crc32CalcSwp(sodStoreInstance_l.paramCrc_m,
+                                                            (INT32)burstLen_p, pBurst);
+
+        sodStoreInstance_l.currDataPos_m += burstLen_p;
+        sodStoreInstance_l.currParamSetOffs_m += burstLen_p;
+
+        sodStoreInstance_l.stat_m.burstCnt_m++;
+        sodStoreInstance_l.stat_m.byteCnt_m += burstLen_p;
+        if(burstLen_p > sodStoreInstance_l.stat_m.burstLenMax_m)
+        {
+            sodStoreInstance_l.stat_m.burstLenMax_m = burstLen_p;
         }
+
+        fReturn = TRUE;
     }
     else
     {
@@ -473,100 +916,261 @@ static BOOLEAN storeHeaderToNvs(UINT32 paramSetLen_p)
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Verify the magic word in the flash
+\brief    Get the time which is left for writing in the current cycle
 
-\retval TRUE    The magic word in the NVS is valid
-\retval FALSE   No magic word in the NVS
+The budget ends SODSTORE_BUDGET_RESERVE before the expected start of the next
+cycle. The program time stalls the CPU and delays the sync interrupt on the
+targets, so a write must not reach into the next cycle.
+
+\return The budget in us
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN verifyMagic(void)
+static UINT32 getWriteBudget(void)
 {
-    BOOLEAN magicValid = FALSE;
-    UINT32 * pReadMagic = NULL;
-    UINT32 refMagic = NVS_MAGIC_WORD;
+    UINT32 budget = 0;
+    UINT32 cycleTime = cyclemon_getCycleTime();
+    UINT32 elapsed;
 
-    /* Verify the magic word */
-    if(nvs_readUint32(NVS_IMG_OFFSET_MAGIC, &pReadMagic) == TRUE)
+    if(cycleTime > 0)
+    {
+        elapsed = (UINT32)(constime_getTimeBase() - cyclemon_getCycleStart());
+        if(elapsed + SODSTORE_BUDGET_RESERVE < cycleTime)
+        {
+            budget = cycleTime - elapsed - SODSTORE_BUDGET_RESERVE;
+        }
+    }
+    else
     {
-        if(*pReadMagic == refMagic)
-            magicValid = TRUE;
+        budget = SODSTORE_BUDGET_NO_CYCLE;
     }
 
-    return magicValid;
+    return budget;
 }
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Verify the state field in the flash
+\brief    Check if a write is started in this call
 
-\retval TRUE    The state field indicates that the SOD image seems to be valid
-\retval FALSE   The SOD image is invalid
+A write is started if its estimated time fits into the budget. If nothing
+was written during a whole cycle the write is started anyway to ensure
+progress.
+
+\param budget_p         The budget of this call in us
+\param length_p         The length of the first write
+
+\retval TRUE    Start the write
+\retval FALSE   Wait for the next cycle
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN verifyState(void)
+static BOOLEAN isWriteDue(UINT32 budget_p, UINT32 length_p)
 {
-    BOOLEAN nvmValid = FALSE;
-    UINT32 * pReadState = NULL;
+    BOOLEAN fDue = FALSE;
+    UINT64 cycleStart = cyclemon_getCycleStart();
+    UINT32 accessCnt = (length_p + sodStoreInstance_l.geometry_m.progGranularity_m - 1) /
+                       sodStoreInstance_l.geometry_m.progGranularity_m;
 
-    /* Verify the magic word */
-    if(nvs_readUint32(NVS_IMG_OFFSET_STATE, &pReadState) == TRUE)
+    if((budget_p << SODSTORE_TIME_FRAC_BITS) >= sodStoreInstance_l.accessTimeEst_m * accessCnt)
     {
-        if(*pReadState == NVS_STATE_NVM_INVALID)
-            nvmValid = FALSE;
-        else
-            nvmValid = TRUE;
+        fDue = TRUE;
+    }
+    else if((UINT32)(cycleStart - sodStoreInstance_l.lastWriteCycle_m) > cyclemon_getCycleTime())
+    {
+        /* No write during the last cycle -> Write out of budget */
+        sodStoreInstance_l.stat_m.forcedWriteCnt_m++;
+        fDue = TRUE;
     }
 
-    return nvmValid;
+    if(fDue != FALSE)
+    {
+        sodStoreInstance_l.lastWriteCycle_m = cycleStart;
+    }
+
+    return fDue;
 }
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Mark the SOD state field as invalid
+\brief    Check if one more access fits into the budget
+
+\param budget_p         The budget of this call in us
+\param elapsed_p        The time in us already spent in this call
 
-\retval TRUE    Successfully marked the state field
-\retval FALSE   Error on NVM write
+\retval TRUE    The estimated time of one access fits into the rest
+\retval FALSE   The budget is used up
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN markStateInvalid(void)
+static BOOLEAN fitsIntoBudget(UINT32 budget_p, UINT32 elapsed_p)
 {
-    BOOLEAN fReturn = FALSE;
-    UINT32 stateInvalid = NVS_STATE_NVM_INVALID;
-    BOOLEAN writeRet = FALSE;
+    BOOLEAN fFits = FALSE;
 
-    /* Write state field to indicate an invalid SOD image */
-    writeRet = nvs_write(NVS_IMG_OFFSET_STATE, (UINT8*)&stateInvalid, sizeof(stateInvalid));
-    if(writeRet == TRUE)
+    if(elapsed_p < budget_p &&
+       ((budget_p - elapsed_p) << SODSTORE_TIME_FRAC_BITS) >= sodStoreInstance_l.accessTimeEst_m)
     {
-        fReturn = TRUE;
+        fFits = TRUE;
     }
-    else
+
+    return fFits;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the length of the next burst
+
+The burst is a multiple of the program granularity which can be programmed
+within the budget, but at least one access. It ends at the next page boundary
+of the NVS or at the end of the data.
+
+\param budget_p         The time in us for the burst
+\param remaining_p      Number of bytes of the data left to write
+
+\return The length of the burst
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 getBurstLength(UINT32 budget_p, UINT32 remaining_p)
+{
+    UINT32 granularity = sodStoreInstance_l.geometry_m.progGranularity_m;
+    UINT32 pageSize = sodStoreInstance_l.geometry_m.pageSize_m;
+    UINT32 pageRest = pageSize - (sodStoreInstance_l.currDataPos_m % pageSize);
+    UINT32 accessCnt = pageSize / granularity;
+    UINT32 burstLen;
+
+    /* Number of accesses which fit into the budget (At least one) */
+    if(sodStoreInstance_l.accessTimeEst_m > 0)
     {
-        errh_postFatalError(kErrSourceSapl, kErrorSodStoreWriteError, 0);
+        accessCnt = (budget_p << SODSTORE_TIME_FRAC_BITS) / sodStoreInstance_l.accessTimeEst_m;
+        if(accessCnt == 0)
+        {
+            accessCnt = 1;
+        }
     }
 
-    return fReturn;
+    burstLen = accessCnt * granularity;
+
+    /* Burst ends at the next page boundary or at the end of the data */
+    if(burstLen > pageRest)
+    {
+        burstLen = pageRest;
+    }
+
+    if(burstLen > remaining_p)
+    {
+        burstLen = remaining_p;
+    }
+
+    return burstLen;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Find the newest valid image in the NVS
+
+The headers of both banks are read first and only the CRC of the newer bank
+is calculated. The older bank is taken if the newer one is corrupted.
+
+\param[out] pImage_p    The description of the image
+
+\retval TRUE    A valid image was found
+\retval FALSE   No valid image in the NVS
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN findImage(tSodStoreImage* pImage_p)
+{
+    BOOLEAN fFound = FALSE;
+    BOOLEAN afValid[2];
+    UINT32 aSequence[2];
+    UINT32 aParamSetLen[2];
+    UINT32 bank;
+    UINT32 i;
+
+    for(bank = 0; bank < 2; bank++)
+    {
+        afValid[bank] = verifyBankHeader(bank * sodStoreInstance_l.bankSize_m,
+                                         &aSequence[bank], &aParamSetLen[bank]);
+    }
+
+    /* Start with the bank of the higher sequence number */
+    bank = 0;
+    if(afValid[0] == FALSE || (afValid[1] != FALSE && (INT32)(aSequence[1] - aSequence[0]) > 0))
+    {
+        bank = 1;
+    }
+
+    for(i = 0; i < 2 && fFound == FALSE; i++, bank ^= 1)
+    {
+        if(afValid[bank] != FALSE)
+        {
+            pImage_p->bankOffs_m = bank * sodStoreInstance_l.bankSize_m;
+            pImage_p->sequence_m = aSequence[bank];
+            pImage_p->length_m = aParamSetLen[bank];
+
+            if(verifyParamSetCrc(pImage_p->bankOffs_m, pImage_p->length_m))
+            {
+                fFound = restoreJournal(pImage_p);
+            }
+        }
+    }
+
+    return fFound;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Verify the header of a bank
+
+\param bankOffs_p           Offset of the bank
+\param[out] pSequence_p     The sequence number of the bank
+\param[out] pParamSetLen_p  The length of the parameter set
+
+\retval TRUE    The bank is committed and the length fits into the bank
+\retval FALSE   No valid image in the bank
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN verifyBankHeader(UINT32 bankOffs_p, UINT32* pSequence_p, UINT32* pParamSetLen_p)
+{
+    BOOLEAN fValid = FALSE;
+    UINT32 * pReadMagic = NULL;
+    UINT32 * pReadSequence = NULL;
+    UINT32 * pReadLength = NULL;
+
+    if(nvs_readUint32(bankOffs_p + NVS_IMG_OFFSET_MAGIC, &pReadMagic)          &&
+       nvs_readUint32(bankOffs_p + NVS_IMG_OFFSET_SEQUENCE, &pReadSequence)    &&
+       nvs_readUint32(bankOffs_p + NVS_IMG_OFFSET_LENGTH, &pReadLength)         )
+    {
+        if(*pReadMagic == NVS_MAGIC_WORD                                                   &&
+           *pReadSequence != NVS_ERASED_WORD                                               &&
+           *pReadLength > 0                                                                &&
+           *pReadLength <= sodStoreInstance_l.bankSize_m - NVS_IMG_OFFSET_DATA              )
+        {
+            *pSequence_p = *pReadSequence;
+            *pParamSetLen_p = *pReadLength;
+
+            fValid = TRUE;
+        }
+    }
+
+    return fValid;
 }
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Verify the NVS image by using the parameter CRC
+\brief    Verify the parameter set of a bank by using the parameter CRC
 
+\param bankOffs_p       Offset of the bank
 \param paramSetLen_p    The length of the parameter set
 
 \retval TRUE    The CRC was successfully verified
 \retval FALSE   CRC error -> The image is not valid
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN verifyParamSetCrc(UINT32 paramSetLen_p)
+static BOOLEAN verifyParamSetCrc(UINT32 bankOffs_p, UINT32 paramSetLen_p)
 {
     BOOLEAN fCrcValid = FALSE;
     UINT32 * pReadCrc = NULL;
     UINT32 calcCrc;
-    UINT8* pParamSet = nvs_getAddress(NVS_IMG_OFFSET_DATA);
+    UINT8* pParamSet = nvs_getAddress(bankOffs_p + NVS_IMG_OFFSET_DATA);
 
     /* Read the parameter set CRC from NVS */
-    if(nvs_readUint32(NVS_IMG_OFFSET_CRC32, &pReadCrc) == TRUE)
+    if(nvs_readUint32(bankOffs_p + NVS_IMG_OFFSET_CRC32, &pReadCrc) == TRUE)
     {
         /* Calculate the parameter CRC over the flash image */
         calcCrc = HNFiff_Crc32CalcSwp(0, paramSetLen_p, pParamSet);
@@ -579,6 +1183,260 @@ static BOOLEAN verifyParamSetCrc(UINT32 paramSetLen_p)
     return fCrcValid;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Apply the journal of a bank to its parameter set
+
+The entries are applied to a copy of the parameter set in RAM. The scan stops
+at the first erased entry. An entry which is not valid (Interrupted write)
+also stops the scan and closes the journal as the rest of the bank is not
+erased anymore.
+
+\param pImage_p     The description of the image with a verified bank
+
+\retval TRUE    The image is valid (With or without entries)
+\retval FALSE   The patched parameter set does not match the CRC of its entry
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN restoreJournal(tSodStoreImage* pImage_p)
+{
+    BOOLEAN fValid = TRUE;
+    UINT32 bankEnd = pImage_p->bankOffs_m + sodStoreInstance_l.bankSize_m;
+    UINT32 entryLen;
+    UINT32 paramCrc = 0;
+    UINT32 * pReadLength = NULL;
+
+    pImage_p->journalOffs_m = getJournalStart(pImage_p->bankOffs_m, pImage_p->length_m);
+    pImage_p->fJournalOpen_m = TRUE;
+    pImage_p->entryCnt_m = 0;
+    pImage_p->pParamSet_m = nvs_getAddress(pImage_p->bankOffs_m + NVS_IMG_OFFSET_DATA);
+
+    while(pImage_p->journalOffs_m + NVS_JRNL_OFFSET_RUNS <= bankEnd   &&
+          nvs_readUint32(pImage_p->journalOffs_m, &pReadLength)       &&
+          *pReadLength != NVS_ERASED_WORD                              )
+    {
+        /* Check the entry before it is applied */
+        if(pImage_p->length_m > SAPL_k_MAX_PARAM_SET_LEN                                           ||
+           *pReadLength > bankEnd - pImage_p->journalOffs_m                                         ||
+           parseJournalEntry(pImage_p->journalOffs_m, pImage_p->length_m, NULL,
+                             &entryLen, &paramCrc) == FALSE                                          )
+        {
+            pImage_p->fJournalOpen_m = FALSE;
+            break;
+        }
+
+        if(pImage_p->entryCnt_m == 0)
+        {
+            MEMCOPY(aRestoreBuf_l, pImage_p->pParamSet_m, pImage_p->length_m);
+            pImage_p->pParamSet_m = (UINT8*)aRestoreBuf_l;
+        }
+
+        (void)parseJournalEntry(pImage_p->journalOffs_m, pImage_p->length_m, pImage_p->pParamSet_m,
+                                &entryLen, &paramCrc);
+
+        pImage_p->journalOffs_m += entryLen;
+        pImage_p->entryCnt_m++;
+    }
+
+    if(pImage_p->entryCnt_m > 0 &&
+       HNFiff_Crc32CalcSwp(0, pImage_p->length_m, pImage_p->pParamSet_m) != paramCrc)
+    {
+        fValid = FALSE;
+    }
+
+    return fValid;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check a journal entry and apply its runs
+
+\param entryOffs_p          Offset of the entry in the NVS
+\param paramSetLen_p        The length of the parameter set
+\param pParamSet_p          The parameter set to patch (NULL: Check only)
+\param[out] pEntryLen_p     The length of the entry
+\param[out] pParamCrc_p     The CRC of the parameter set after the entry
+
+\retval TRUE    The entry is valid
+\retval FALSE   The entry is corrupted
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN parseJournalEntry(UINT32 entryOffs_p, UINT32 paramSetLen_p, UINT8* pParamSet_p,
+                                 UINT32* pEntryLen_p, UINT32* pParamCrc_p)
+{
+    BOOLEAN fValid = FALSE;
+    const UINT8* pEntry = nvs_getAddress(entryOffs_p);
+    UINT32 entryLen = readUint32(&pEntry[NVS_JRNL_OFFSET_LENGTH]);
+    UINT32 entryCrc;
+    UINT32 pos = NVS_JRNL_OFFSET_RUNS;
+    UINT16 runOffs;
+    UINT16 runLen;
+
+    if(entryLen >= NVS_JRNL_OFFSET_RUNS && entryLen <= SODSTORE_JOURNAL_ENTRY_MAX &&
+       (entryLen % SODSTORE_JOURNAL_ALIGN) == 0                                     )
+    {
+        /* The CRC covers the whole entry except its own field */
+        entryCrc = HNFiff_Crc32CalcSwp(0, NVS_JRNL_OFFSET_ENTRY_CRC, pEntry);
+        entryCrc = HNFiff_Crc32CalcSwp(entryCrc, (INT32)(entryLen - NVS_JRNL_OFFSET_RUNS),
+                                       &pEntry[NVS_JRNL_OFFSET_RUNS]);
+
+        if(entryCrc == readUint32(&pEntry[NVS_JRNL_OFFSET_ENTRY_CRC]))
+        {
+            fValid = TRUE;
+
+            /* The runs end at the end of the entry or at the zero padding */
+            while(pos + NVS_JRNL_RUN_HEADER_LEN <= entryLen)
+            {
+                MEMCOPY(&runOffs, &pEntry[pos], sizeof(runOffs));
+                MEMCOPY(&runLen, &pEntry[pos + sizeof(runOffs)], sizeof(runLen));
+                pos += NVS_JRNL_RUN_HEADER_LEN;
+
+                if(runLen == 0)
+                {
+                    break;
+                }
+
+                if((UINT32)runOffs + runLen > paramSetLen_p || pos + runLen > entryLen)
+                {
+                    fValid = FALSE;
+                    break;
+                }
+
+                if(pParamSet_p != NULL)
+                {
+                    MEMCOPY(&pParamSet_p[runOffs], &pEntry[pos], runLen);
+                }
+
+                pos += runLen;
+            }
+
+            *pEntryLen_p = entryLen;
+            *pParamCrc_p = readUint32(&pEntry[NVS_JRNL_OFFSET_PARAM_CRC]);
+        }
+    }
+
+    return fValid;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Build the journal entry of the changed bytes of the parameter set
+
+Changed bytes with gaps shorter than a run header are merged into one run.
+
+\param pParamSetBase_p      The new parameter set
+\param pCurrParamSet_p      The parameter set of the current image
+\param paramSetLen_p        The length of both parameter sets
+
+\return The length of the entry; NVS_JRNL_OFFSET_RUNS if nothing changed;
+        0 if the changes do not fit into one entry
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 buildJournalEntry(UINT8* pParamSetBase_p, const UINT8* pCurrParamSet_p,
+                                UINT32 paramSetLen_p)
+{
+    UINT8* pEntry = (UINT8*)aJournalEntry_l;
+    UINT32 pos = NVS_JRNL_OFFSET_RUNS;
+    UINT32 entryLen = 0;
+    UINT32 entryCrc;
+    UINT32 paramCrc;
+    UINT32 runStart;
+    UINT32 runEnd;
+    UINT32 i = 0;
+    UINT16 runField;
+
+    MEMSET(aJournalEntry_l, 0, sizeof(aJournalEntry_l));
+
+    while(i < paramSetLen_p && pos <= SODSTORE_JOURNAL_ENTRY_MAX)
+    {
+        if(pParamSetBase_p[i] == pCurrParamSet_p[i])
+        {
+            i++;
+        }
+        else
+        {
+            /* Extend the run until a gap of unchanged bytes is long enough */
+            runStart = i;
+            runEnd = i + 1;
+            for(i = runEnd; i < paramSetLen_p && i - runEnd < SODSTORE_JOURNAL_RUN_GAP; i++)
+            {
+                if(pParamSetBase_p[i] != pCurrParamSet_p[i])
+                {
+                    runEnd = i + 1;
+                }
+            }
+
+            if(pos + NVS_JRNL_RUN_HEADER_LEN + (runEnd - runStart) <= SODSTORE_JOURNAL_ENTRY_MAX)
+            {
+                runField = (UINT16)runStart;
+                MEMCOPY(&pEntry[pos], &runField, sizeof(runField));
+                runField = (UINT16)(runEnd - runStart);
+                MEMCOPY(&pEntry[pos + sizeof(runField)], &runField, sizeof(runField));
+                MEMCOPY(&pEntry[pos + NVS_JRNL_RUN_HEADER_LEN], &pParamSetBase_p[runStart],
+                        runEnd - runStart);
+            }
+
+            pos += NVS_JRNL_RUN_HEADER_LEN + (runEnd - runStart);
+            i = runEnd;
+        }
+    }
+
+    if(pos == NVS_JRNL_OFFSET_RUNS)
+    {
+        entryLen = NVS_JRNL_OFFSET_RUNS;
+    }
+    else if(pos <= SODSTORE_JOURNAL_ENTRY_MAX)
+    {
+        entryLen = (pos + SODSTORE_JOURNAL_ALIGN - 1) & ~(SODSTORE_JOURNAL_ALIGN - 1);
+
+        paramCrc = HNFiff_Crc32CalcSwp(0, (INT32)paramSetLen_p, pParamSetBase_p);
+
+        MEMCOPY(&pEntry[NVS_JRNL_OFFSET_LENGTH], &entryLen, sizeof(entryLen));
+        MEMCOPY(&pEntry[NVS_JRNL_OFFSET_PARAM_CRC], &paramCrc, sizeof(paramCrc));
+
+        entryCrc = HNFiff_Crc32CalcSwp(0, NVS_JRNL_OFFSET_ENTRY_CRC, pEntry);
+        entryCrc = HNFiff_Crc32CalcSwp(entryCrc, (INT32)(entryLen - NVS_JRNL_OFFSET_RUNS),
+                                       &pEntry[NVS_JRNL_OFFSET_RUNS]);
+        MEMCOPY(&pEntry[NVS_JRNL_OFFSET_ENTRY_CRC], &entryCrc, sizeof(entryCrc));
+    }
+
+    return entryLen;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the offset of the journal of a bank
+
+\param bankOffs_p       Offset of the bank
+\param paramSetLen_p    The length of the parameter set of the bank
+
+\return The offset of the first journal entry
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 getJournalStart(UINT32 bankOffs_p, UINT32 paramSetLen_p)
+{
+    return bankOffs_p +
+           ((NVS_IMG_OFFSET_DATA + paramSetLen_p + SODSTORE_JOURNAL_ALIGN - 1) & ~(SODSTORE_JOURNAL_ALIGN - 1));
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Read a UINT32 field of a journal entry
+
+\param pData_p      Pointer to the field
+
+\return The value of the field
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 readUint32(const UINT8* pData_p)
+{
+    UINT32 value;
+
+    MEMCOPY(&value, pData_p, sizeof(value));
+
+    return value;
+}
+
 /**
  * \}
  * \}
@@ -10,6 +10,15 @@
 This module provides the consecutive timebase. It acts as an interface to the
 target specific module of the hardware timer.
 
+The 64bit microsecond timebase is extended from the hardware counter (16 or
+32bit) by counting its wraps in the wrap interrupt of the timer. The wrap state
+is written to alternating slots selected by a sequence counter. Reads retry if
+the sequence changed meanwhile and add a wrap which is pending but not yet
+counted. Therefore the timebase can be read from any context without locking
+and independent of the cycle time. Timers without a wrap interrupt are
+extended in constime_process() instead, which then has to be called at least
+once per counter period.
+
 \ingroup group_app_sn_shnf
 *******************************************************************************/
 
@@ -71,6 +80,10 @@ target specific module of the hardware timer.
 /*----------------------------------------------------------------------------*/
 /* global function prototypes                                                 */
 /*----------------------------------------------------------------------------*/
+#ifdef CONSTIME_PUBLISH_HOOK
+/* Provided by the host harness which interrupts the wrap state update */
+void CONSTIME_PUBLISH_HOOK(void);
+#endif
 
 /*============================================================================*/
 /*            P R I V A T E   D E F I N I T I O N S                           */
@@ -88,14 +101,27 @@ target specific module of the hardware timer.
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * \brief Wrap state of the hardware counter
+ */
+typedef struct
+{
+    UINT32 wrapCnt_m;           /**< Number of wraps of the hardware counter */
+    UINT32 lastTick_m;          /**< Counter value of the last update (Timers without wrap interrupt) */
+} tConsTimeWrap;
+
 /**
  * \brief Consecutive time module instance type
  */
 typedef struct
 {
-    UINT64 usTimeBase_m;        /**< Microsecond timebase of the system. (Derived from a 16bit hardware counter) */
+    UINT64 usTimeBase_m;        /**< Microsecond timebase of the current cycle */
     UINT32 currConsTime_m;      /**< The current value of the consecutive time */
     UINT32 consTimeFactor_m;    /**< The consecutive timebase division factor */
+    volatile UINT32 wrapSeq_m;                  /**< Incremented on each update of the wrap state */
+    volatile tConsTimeWrap wrapState_m[2];      /**< Wrap state, the valid slot is selected by wrapSeq_m */
+    UINT8 tickWidth_m;          /**< Width of the hardware counter in bits */
+    BOOLEAN fWrapIrq_m;         /**< The wraps are counted in the wrap interrupt */
 } tConsTimeInstance;
 
 /*----------------------------------------------------------------------------*/
@@ -106,6 +132,8 @@ static tConsTimeInstance consTimeInstance_l;
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
+static void counterWrapped(void);
+static void updateWrapState(UINT32 wrapCnt_p, UINT32 lastTick_p);
 
 /*============================================================================*/
 /*            P U B L I C   F U N C T I O N S                                 */
@@ -130,6 +158,9 @@ BOOLEAN constime_init(void)
         /* Initialize the consecutive timebase division factor */
         consTimeInstance_l.consTimeFactor_m = CONSTIME_BASE_100US;
 
+        consTimeInstance_l.tickWidth_m = timer_getTickWidth();
+        consTimeInstance_l.fWrapIrq_m = timer_registerWrapCb(counterWrapped);
+
         fReturn = TRUE;
     }
     else
@@ -147,9 +178,9 @@ BOOLEAN constime_init(void)
 /*----------------------------------------------------------------------------*/
 void constime_exit(void)
 {
-    MEMSET(&consTimeInstance_l, 0, sizeof(tConsTimeInstance));
-
     timer_close();
+
+    MEMSET(&consTimeInstance_l, 0, sizeof(tConsTimeInstance));
 }
 
 /*----------------------------------------------------------------------------*/
@@ -169,20 +200,46 @@ UINT32 constime_getTime(void)
 \brief    Get the us timebase of the consecutive time
 
 The system generates a microsecond timebase as a basis value for the consecutive
-time.
+time. The function can be called from any context, it only repeats the read if
+the wrap state was updated in between.
 
 \return The current timebase of the system
 */
 /*----------------------------------------------------------------------------*/
 UINT64 constime_getTimeBase(void)
 {
-    UINT64 currentTime = 0;
-    UINT64 newTime = 0;
+    UINT32 seq = 0;
+    UINT32 wrapCnt = 0;
+    UINT32 lastTick = 0;
+    UINT32 tick = 0;
 
-    currentTime = consTimeInstance_l.usTimeBase_m;
-    newTime = currentTime + (((UINT64)(timer_getTickCount()) - currentTime) & 0xffff);
+    do
+    {
+        seq = consTimeInstance_l.wrapSeq_m;
+        wrapCnt = consTimeInstance_l.wrapState_m[seq & 1].wrapCnt_m;
+        lastTick = consTimeInstance_l.wrapState_m[seq & 1].lastTick_m;
+        tick = timer_getTickCount();
 
-    return newTime;
+        if(consTimeInstance_l.fWrapIrq_m)
+        {
+            if(timer_isWrapPending())
+            {
+                /* The wrap interrupt is not served yet (Called with higher priority) */
+                tick = timer_getTickCount();
+                wrapCnt++;
+            }
+        }
+        else
+        {
+            if(tick < lastTick)
+            {
+                /* Wrapped since the last process call */
+                wrapCnt++;
+            }
+        }
+    } while(seq != consTimeInstance_l.wrapSeq_m);
+
+    return (((UINT64)wrapCnt << consTimeInstance_l.tickWidth_m) + tick);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -196,9 +253,15 @@ UINT64 constime_getTimeBase(void)
 /*----------------------------------------------------------------------------*/
 void constime_setTimebase(UINT64 newTime_p)
 {
+    UINT32 tick = (UINT32)(newTime_p & ((((UINT64)1) << consTimeInstance_l.tickWidth_m) - 1));
+
+    util_enterCriticalSection(FALSE);
+
     consTimeInstance_l.usTimeBase_m = newTime_p;
-    timer_setTickCount((UINT16)newTime_p);
+    timer_setTickCount(tick);
+    updateWrapState((UINT32)(newTime_p >> consTimeInstance_l.tickWidth_m), tick);
 
+    util_enterCriticalSection(TRUE);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -263,19 +326,36 @@ BOOLEAN constime_setConsTime(UINT64 * pNewTime_p)
 /**
 \brief    Process the system microsecond timer
 
-This function needs to be called at least each 65ms in order to update the
-local microsecond counter of the system.
+Takes the timebase of the current cycle. If the timer has no wrap interrupt
+this function extends the counter and needs to be called at least once per
+counter period (65ms for a 16bit counter).
+
+\note Only call this function from the sync interrupt.
 
 \return Pointer to the new current time
 */
 /*----------------------------------------------------------------------------*/
 UINT64 * constime_process(void)
 {
-    UINT64 usTimeBase = 0;
+    volatile tConsTimeWrap * pWrap = NULL;
+    UINT32 tick = 0;
 
-    usTimeBase = consTimeInstance_l.usTimeBase_m;
-    consTimeInstance_l.usTimeBase_m = usTimeBase + (((UINT64)(timer_getTickCount())
-                                      - consTimeInstance_l.usTimeBase_m) & 0xffff);
+    if(consTimeInstance_l.fWrapIrq_m == FALSE)
+    {
+        pWrap = &consTimeInstance_l.wrapState_m[consTimeInstance_l.wrapSeq_m & 1];
+
+        tick = timer_getTickCount();
+        if(tick < pWrap->lastTick_m)
+        {
+            updateWrapState(pWrap->wrapCnt_m + 1, tick);
+        }
+        else
+        {
+            updateWrapState(pWrap->wrapCnt_m, tick);
+        }
+    }
+
+    consTimeInstance_l.usTimeBase_m = constime_getTimeBase();
 
     return &consTimeInstance_l.usTimeBase_m;
 }
@@ -389,6 +469,47 @@ BOOLEAN SHNF_SOD_ConsTimeBase_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
 /** \name Private Functions */
 /** \{ */
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Count a wrap of the hardware counter
+
+\note Called in the wrap interrupt of the timer.
+*/
+/*----------------------------------------------------------------------------*/
+static void counterWrapped(void)
+{
+    UINT32 wrapCnt = consTimeInstance_l.wrapState_m[consTimeInstance_l.wrapSeq_m & 1].wrapCnt_m;
+
+    updateWrapState(wrapCnt + 1, 0);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Publish a new wrap state
+
+The new state is written to the unused slot before the sequence is
+incremented. A reader which is interrupted by this function sees the changed
+sequence and repeats the read.
+
+\param[in] wrapCnt_p     The new number of wraps
+\param[in] lastTick_p    The counter value of the update
+*/
+/*----------------------------------------------------------------------------*/
+static void updateWrapState(UINT32 wrapCnt_p, UINT32 lastTick_p)
+{
+    UINT32 nextSeq = consTimeInstance_l.wrapSeq_m + 1;
+
+    consTimeInstance_l.wrapState_m[nextSeq & 1].wrapCnt_m = wrapCnt_p;
+    consTimeInstance_l.wrapState_m[nextSeq & 1].lastTick_m = lastTick_p;
+
+#ifdef CONSTIME_PUBLISH_HOOK
+    /* A reader interrupts the update before the new state is published */
+    CONSTIME_PUBLISH_HOOK();
+#endif
+
+    consTimeInstance_l.wrapSeq_m = nextSeq;
+}
+
 /**
  * \}
  * \}
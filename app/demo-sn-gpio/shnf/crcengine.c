@@ -0,0 +1,1063 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/shnf/crcengine.c
+
+\defgroup module_sn_shnf_crcengine CRC engine module
+\{
+
+\brief  Calculates the CRCs of the openSAFETY frames and parameters
+
+All frame and parameter CRCs of the SN (SPDO build and check, SSDO/SNMT
+frames, cross communication and parameter CRC32) are calculated by this
+module. Each polynomial can use one of several implementations: the
+reference of the openSAFETY stack, a bitwise calculation, a 256 entry table
+and slice-by-4/8 tables. The target can provide a hardware CRC unit.
+
+The tables are generated by crcengine_init() which afterwards verifies each
+implementation against the reference. An implementation which fails the
+self-test is disabled and the polynomial falls back to the reference. Until
+crcengine_init() is called all polynomials use the reference.
+
+\ingroup group_app_sn_shnf
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <shnf/crcengine.h>
+
+#include <common/benchmark.h>
+
+#include <oschecksum/crc.h>
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#ifndef CRCENGINE_SLICE_LIMIT
+  #define CRCENGINE_SLICE_LIMIT     8       /**< Largest slice-by-N the target has RAM for (apptarget/target.h) */
+#endif
+
+#if (CRCENGINE_SLICE_MAX > CRCENGINE_SLICE_LIMIT)
+  #undef CRCENGINE_SLICE_MAX
+  #define CRCENGINE_SLICE_MAX       CRCENGINE_SLICE_LIMIT
+#endif
+
+#if (CRCENGINE_SLICE_MAX > 0)
+  #define CRCENGINE_TABLE_CNT       CRCENGINE_SLICE_MAX
+#else
+  #define CRCENGINE_TABLE_CNT       1
+#endif
+
+#define CRCENGINE_TEST_SIZE         64      /**< Size of the self-test pattern */
+
+#define CRCENGINE_SHIFT_DIRECT_MAX  16      /**< Shifts up to this length run zero bytes through the table */
+
+#define CRCENGINE_BENCH_SIZE        256     /**< Bytes per CRC calculation of the benchmark */
+#define CRCENGINE_BENCH_LOOPS       64      /**< Number of calculations per measurement */
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+struct eCrcPolyDesc;
+
+/**
+ * \brief CRC calculation function of one implementation
+ */
+typedef UINT32 (*tCrcCalc)(const struct eCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                           const UINT8* pData_p, UINT32 length_p);
+
+/**
+ * \brief Description of a polynomial (MSB first, no final XOR)
+ */
+typedef struct eCrcPolyDesc
+{
+    UINT8           width_m;                        /**< Width of the CRC in bits */
+    UINT32          poly_m;                         /**< Generator polynomial (normal form) */
+    const void*     pTable_m;                       /**< Tables of this polynomial ([n][256]) */
+    tCrcCalc        apfnCalc_m[kCrcImplCount];      /**< Implementations (NULL: not available) */
+} tCrcPolyDesc;
+
+/**
+ * \brief Tables of the table driven implementations
+ *
+ * Table n of a polynomial holds the CRC of each byte followed by n zero bytes.
+ * Table 0 is the classic 256 entry table. The slice-by-N implementations are
+ * only provided for the 16 and 32 bit CRCs, the 8 bit CRC only protects
+ * frames with up to 8 bytes payload.
+ */
+typedef struct
+{
+    UINT8           crc8_m[1][256];
+    UINT16          crc16AC9A_m[CRCENGINE_TABLE_CNT][256];
+    UINT16          crc16755B_m[CRCENGINE_TABLE_CNT][256];
+    UINT32          crc32_m[CRCENGINE_TABLE_CNT][256];
+    UINT32          xPow8_m[kCrcPolyCount][32];     /**< x^(8*2^n) mod polynomial for crcengine_combine() */
+} tCrcEngineTables;
+
+/**
+ * \brief CRC engine instance type
+ */
+typedef struct
+{
+    tCrcCalc        apfnSelected_m[kCrcPolyCount];  /**< Selected implementation per polynomial */
+    tCrcEngineImpl  aSelected_m[kCrcPolyCount];     /**< Id of the selected implementation */
+    BOOLEAN         fInitialized_m;                 /**< The tables are valid */
+} tCrcEngineInstance;
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static UINT32 calcReference(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p);
+static UINT32 calcBitwise(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                          const UINT8* pData_p, UINT32 length_p);
+static UINT32 calcTable8(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                         const UINT8* pData_p, UINT32 length_p);
+static UINT32 calcTable16(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                          const UINT8* pData_p, UINT32 length_p);
+static UINT32 calcTable32(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                          const UINT8* pData_p, UINT32 length_p);
+#if (CRCENGINE_SLICE_MAX >= 4)
+static UINT32 calcSlice4_16(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p);
+static UINT32 calcSlice4_32(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p);
+#endif
+#if (CRCENGINE_SLICE_MAX >= 8)
+static UINT32 calcSlice8_16(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p);
+static UINT32 calcSlice8_32(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p);
+#endif
+#ifdef CRCENGINE_HW_CALC
+static UINT32 calcHardware(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                           const UINT8* pData_p, UINT32 length_p);
+#endif
+
+static UINT32 multModPoly(const tCrcPolyDesc* pDesc_p, UINT32 a_p, UINT32 b_p);
+static UINT32 shiftCrc(tCrcEnginePoly poly_p, UINT32 crc_p, UINT32 length_p);
+
+static void generateTables(void);
+static BOOLEAN testImpl(tCrcEnginePoly poly_p, tCrcEngineImpl impl_p);
+static BOOLEAN testCombine(tCrcEnginePoly poly_p);
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tCrcEngineTables crcTables_l;
+
+static tCrcPolyDesc crcPolyDesc_l[kCrcPolyCount] =
+{
+    {    8, 0x2FUL,       crcTables_l.crc8_m,
+        { calcReference, calcBitwise, calcTable8, NULL, NULL, NULL } },
+    {   16, 0x5935UL,     crcTables_l.crc16AC9A_m,
+        { calcReference, calcBitwise, calcTable16, NULL, NULL, NULL } },
+    {   16, 0x755BUL,     crcTables_l.crc16755B_m,
+        { calcReference, calcBitwise, calcTable16, NULL, NULL, NULL } },
+    {   32, 0x1EDC6F41UL, crcTables_l.crc32_m,
+        { calcReference, calcBitwise, calcTable32, NULL, NULL, NULL } },
+};
+
+static tCrcEngineInstance crcEngineInstance_l =
+{
+    { calcReference, calcReference, calcReference, calcReference },
+    { kCrcImplReference, kCrcImplReference, kCrcImplReference, kCrcImplReference },
+    FALSE
+};
+
+#if (defined CRCENGINE_BENCHMARK_ENABLED) && (defined BENCHMARK_TRACE_TIMESTAMP)
+static const char* const crcPolyName_l[kCrcPolyCount] =
+{
+    "crc8", "crc16-ac9a", "crc16-755b", "crc32"
+};
+
+static const char* const crcImplName_l[kCrcImplCount] =
+{
+    "reference", "bitwise", "table", "slice4", "slice8", "hardware"
+};
+#endif
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Initialize the CRC engine
+
+Generates the tables, runs the self-test and selects CRCENGINE_DEFAULT_IMPL
+for all polynomials which pass the self-test with this implementation. If the
+default is not available for a polynomial the table implementation is used.
+
+\retval TRUE    CRC engine is ready (possibly with the reference implementation)
+\retval FALSE   The reference implementation failed the self-test
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN crcengine_init(void)
+{
+    BOOLEAN fReturn = FALSE;
+    UINT8 poly;
+
+    generateTables();
+
+#if (CRCENGINE_SLICE_MAX >= 4)
+    crcPolyDesc_l[kCrcPolyCrc16AC9A].apfnCalc_m[kCrcImplSlice4] = calcSlice4_16;
+    crcPolyDesc_l[kCrcPolyCrc16755B].apfnCalc_m[kCrcImplSlice4] = calcSlice4_16;
+    crcPolyDesc_l[kCrcPolyCrc32].apfnCalc_m[kCrcImplSlice4] = calcSlice4_32;
+#endif
+#if (CRCENGINE_SLICE_MAX >= 8)
+    crcPolyDesc_l[kCrcPolyCrc16AC9A].apfnCalc_m[kCrcImplSlice8] = calcSlice8_16;
+    crcPolyDesc_l[kCrcPolyCrc16755B].apfnCalc_m[kCrcImplSlice8] = calcSlice8_16;
+    crcPolyDesc_l[kCrcPolyCrc32].apfnCalc_m[kCrcImplSlice8] = calcSlice8_32;
+#endif
+#ifdef CRCENGINE_HW_CALC
+    for(poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        if((CRCENGINE_HW_POLY_MASK & (1UL << poly)) != 0)
+            crcPolyDesc_l[poly].apfnCalc_m[kCrcImplHardware] = calcHardware;
+    }
+#endif
+
+    crcEngineInstance_l.fInitialized_m = TRUE;
+
+    if(crcengine_selfTest())
+    {
+        for(poly = 0; poly < kCrcPolyCount; poly++)
+        {
+            /* Fall back to the table if the default is not available (e.g. the
+               slice-by-N tables are capped by the target), otherwise keep the reference */
+            if(!crcengine_select((tCrcEnginePoly)poly, CRCENGINE_DEFAULT_IMPL))
+                (void)crcengine_select((tCrcEnginePoly)poly, kCrcImplTable);
+        }
+
+        fReturn = TRUE;
+    }
+
+#ifdef CRCENGINE_BENCHMARK_ENABLED
+    crcengine_benchmark();
+#endif
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Shutdown the CRC engine
+
+All polynomials fall back to the reference implementation.
+*/
+/*----------------------------------------------------------------------------*/
+void crcengine_exit(void)
+{
+    UINT8 poly;
+
+    for(poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        crcEngineInstance_l.apfnSelected_m[poly] = calcReference;
+        crcEngineInstance_l.aSelected_m[poly] = kCrcImplReference;
+    }
+
+    crcEngineInstance_l.fInitialized_m = FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Select the implementation of a polynomial
+
+\param[in] poly_p       The polynomial
+\param[in] impl_p       The implementation to use
+
+\retval TRUE    Implementation is selected
+\retval FALSE   Implementation is not available (or failed the self-test)
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN crcengine_select(tCrcEnginePoly poly_p, tCrcEngineImpl impl_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(crcengine_isAvailable(poly_p, impl_p))
+    {
+        crcEngineInstance_l.apfnSelected_m[poly_p] = crcPolyDesc_l[poly_p].apfnCalc_m[impl_p];
+        crcEngineInstance_l.aSelected_m[poly_p] = impl_p;
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the selected implementation of a polynomial
+
+\param[in] poly_p       The polynomial
+
+\return The selected implementation
+*/
+/*----------------------------------------------------------------------------*/
+tCrcEngineImpl crcengine_getImpl(tCrcEnginePoly poly_p)
+{
+    tCrcEngineImpl impl = kCrcImplReference;
+
+    if(poly_p < kCrcPolyCount)
+    {
+        impl = crcEngineInstance_l.aSelected_m[poly_p];
+    }
+
+    return impl;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if an implementation is available for a polynomial
+
+\param[in] poly_p       The polynomial
+\param[in] impl_p       The implementation
+
+\retval TRUE    Implementation is available
+\retval FALSE   Not compiled in, not supported by the target or failed the self-test
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN crcengine_isAvailable(tCrcEnginePoly poly_p, tCrcEngineImpl impl_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(poly_p < kCrcPolyCount && impl_p < kCrcImplCount)
+    {
+        if(crcPolyDesc_l[poly_p].apfnCalc_m[impl_p] != NULL &&
+           (impl_p == kCrcImplReference || crcEngineInstance_l.fInitialized_m != FALSE))
+        {
+            fReturn = TRUE;
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Verify all implementations against the reference
+
+Each available implementation calculates the CRC of a test pattern with
+different lengths, alignments and initial values. An implementation with a
+different result than the reference is disabled and reported as minor error.
+If it was selected the polynomial falls back to the reference.
+
+\retval TRUE    The reference produced consistent results
+\retval FALSE   The reference itself is not reproducible
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN crcengine_selfTest(void)
+{
+    BOOLEAN fReturn = TRUE;
+    UINT8 poly;
+    UINT8 impl;
+
+    for(poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        /* The reference is tested against itself for chunked calculation */
+        if(testImpl((tCrcEnginePoly)poly, kCrcImplReference) == FALSE ||
+           testCombine((tCrcEnginePoly)poly) == FALSE                  )
+        {
+            errh_postFatalError(kErrSourceShnf, kErrorCrcEngineSelfTestFailed, poly);
+            fReturn = FALSE;
+        }
+
+        for(impl = kCrcImplReference + 1; impl < kCrcImplCount; impl++)
+        {
+            if(crcengine_isAvailable((tCrcEnginePoly)poly, (tCrcEngineImpl)impl))
+            {
+                if(testImpl((tCrcEnginePoly)poly, (tCrcEngineImpl)impl) == FALSE)
+                {
+                    crcPolyDesc_l[poly].apfnCalc_m[impl] = NULL;
+
+                    if(crcEngineInstance_l.aSelected_m[poly] == impl)
+                    {
+                        (void)crcengine_select((tCrcEnginePoly)poly, kCrcImplReference);
+                    }
+
+                    errh_postMinorError(kErrSourceShnf, kErrorCrcEngineSelfTestFailed,
+                                        ((UINT32)poly << 8) | impl);
+                }
+            }
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Measure the throughput of all implementations
+
+Calculates the CRC over CRCENGINE_BENCH_SIZE bytes CRCENGINE_BENCH_LOOPS
+times for each polynomial and available implementation and prints the
+throughput in bytes per microsecond:
+
+    CRC <polynomial> <implementation> <bytes/us>
+
+The benchmark uses the time base of the benchmark trace
+(BENCHMARK_TRACE_TIMESTAMP()). It is empty if the target provides none.
+*/
+/*----------------------------------------------------------------------------*/
+void crcengine_benchmark(void)
+{
+#if (defined CRCENGINE_BENCHMARK_ENABLED) && (defined BENCHMARK_TRACE_TIMESTAMP)
+    static UINT8 benchData[CRCENGINE_BENCH_SIZE];
+    const tCrcPolyDesc* pDesc;
+    volatile UINT32 crc = 0;
+    UINT32 startTime;
+    UINT32 ticks;
+    UINT64 rate;
+    UINT16 i;
+    UINT8 poly;
+    UINT8 impl;
+
+#ifndef BENCHMARK_TRACE_ENABLED
+    /* The trace did not start the time base */
+    BENCHMARK_TRACE_TIMER_INIT();
+#endif
+
+    for(i = 0; i < CRCENGINE_BENCH_SIZE; i++)
+    {
+        benchData[i] = (UINT8)((i * 7U) + 3U);
+    }
+
+    for(poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        pDesc = &crcPolyDesc_l[poly];
+
+        for(impl = 0; impl < kCrcImplCount; impl++)
+        {
+            if(crcengine_isAvailable((tCrcEnginePoly)poly, (tCrcEngineImpl)impl))
+            {
+                startTime = BENCHMARK_TRACE_TIMESTAMP();
+                for(i = 0; i < CRCENGINE_BENCH_LOOPS; i++)
+                {
+                    crc = pDesc->apfnCalc_m[impl](pDesc, crc, benchData, CRCENGINE_BENCH_SIZE);
+                }
+                ticks = (UINT32)(BENCHMARK_TRACE_TIMESTAMP() - startTime);
+
+                if(ticks == 0)
+                    ticks = 1;
+
+                /* Bytes per microsecond with two decimal places */
+                rate = ((UINT64)CRCENGINE_BENCH_SIZE * CRCENGINE_BENCH_LOOPS *
+                        (UINT64)BENCHMARK_TRACE_TICK_HZ * 100U) / ((UINT64)ticks * 1000000U);
+
+                DEBUG_TRACE(DEBUG_LVL_ALWAYS, "CRC %s %s %lu.%02lu\n",
+                            crcPolyName_l[poly], crcImplName_l[impl],
+                            (unsigned long)(rate / 100U), (unsigned long)(rate % 100U));
+            }
+        }
+    }
+
+    (void)crc;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a CRC
+
+The CRC is calculated MSB first without final XOR like the oschecksum library
+of the openSAFETY stack. Chunked calculation is possible by passing the
+result of the previous chunk as initial value.
+
+\param[in] poly_p       The polynomial
+\param[in] initCrc_p    Initial value of the CRC
+\param[in] length_p     Number of bytes
+\param[in] pData_p      Pointer to the data
+
+\return The CRC (0 if the polynomial is invalid)
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 crcengine_calc(tCrcEnginePoly poly_p, UINT32 initCrc_p, UINT32 length_p,
+                      const void* pData_p)
+{
+    UINT32 crc = 0;
+
+    if(poly_p < kCrcPolyCount)
+    {
+        crc = crcEngineInstance_l.apfnSelected_m[poly_p](&crcPolyDesc_l[poly_p],
+                initCrc_p, (const UINT8*)pData_p, length_p);
+    }
+
+    return crc;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Combine the CRCs of two consecutive blocks
+
+Calculates the CRC of the concatenation A|B from the CRC of A and the CRC of
+B without reading the data again. As the CRC has no final XOR, it is linear
+in the data and in the initial value:
+
+    crc(init, A|B) = crc(init, A) * x^(8*len(B)) mod P  XOR  crc(0, B)
+
+The multiplication is done with the precomputed powers x^(8*2^n), so the
+effort grows with the logarithm of the length of B only. The same relation
+updates a cached CRC after a change of its data without reading the unchanged
+data: crc(A') = crc(A) XOR combine(crc(0, old) XOR crc(0, new), 0, tail),
+where tail is the number of bytes behind the changed data.
+
+\param[in] poly_p       The polynomial
+\param[in] crcA_p       CRC of block A (with any initial value)
+\param[in] crcB_p       CRC of block B calculated with initial value 0
+\param[in] lengthB_p    Length of block B in bytes
+
+\return CRC of A|B (0 if the polynomial is invalid)
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 crcengine_combine(tCrcEnginePoly poly_p, UINT32 crcA_p, UINT32 crcB_p,
+                         UINT32 lengthB_p)
+{
+    UINT32 crc = 0;
+
+    if(poly_p < kCrcPolyCount)
+    {
+        crc = shiftCrc(poly_p, crcA_p, lengthB_p) ^ crcB_p;
+    }
+
+    return crc;
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Multiply two polynomials modulo the generator polynomial
+
+\param[in] pDesc_p      Description of the polynomial
+\param[in] a_p          First factor
+\param[in] b_p          Second factor
+
+\return a * b mod P
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 multModPoly(const tCrcPolyDesc* pDesc_p, UINT32 a_p, UINT32 b_p)
+{
+    UINT32 topBit = 1UL << (pDesc_p->width_m - 1);
+    UINT32 mask = (topBit << 1) - 1;
+    UINT32 prod = 0;
+    UINT32 bit;
+
+    /* Horner scheme over the bits of b, highest power first */
+    for(bit = topBit; bit != 0; bit >>= 1)
+    {
+        if((prod & topBit) != 0)
+            prod = ((prod << 1) ^ pDesc_p->poly_m) & mask;
+        else
+            prod = (prod << 1) & mask;
+
+        if((b_p & bit) != 0)
+            prod ^= a_p;
+    }
+
+    return prod;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Advance a CRC over a number of zero bytes
+
+\param[in] poly_p       The polynomial
+\param[in] crc_p        The CRC to advance
+\param[in] length_p     Number of zero bytes
+
+\return crc * x^(8*length) mod P
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 shiftCrc(tCrcEnginePoly poly_p, UINT32 crc_p, UINT32 length_p)
+{
+    static const UINT8 zeroBytes[CRCENGINE_SHIFT_DIRECT_MAX] = { 0 };
+    const tCrcPolyDesc* pDesc = &crcPolyDesc_l[poly_p];
+    UINT8 n = 0;
+
+    if(length_p <= CRCENGINE_SHIFT_DIRECT_MAX || crcEngineInstance_l.fInitialized_m == FALSE)
+    {
+        /* Short shifts are faster with the table than with the multiplication */
+        while(length_p > 0)
+        {
+            n = (length_p > CRCENGINE_SHIFT_DIRECT_MAX) ? CRCENGINE_SHIFT_DIRECT_MAX : (UINT8)length_p;
+            crc_p = crcEngineInstance_l.apfnSelected_m[poly_p](pDesc, crc_p, zeroBytes, n);
+            length_p -= n;
+        }
+    }
+    else
+    {
+        while(length_p != 0 && crc_p != 0)
+        {
+            if((length_p & 1U) != 0)
+            {
+                crc_p = multModPoly(pDesc, crc_p, crcTables_l.xPow8_m[poly_p][n]);
+            }
+
+            length_p >>= 1;
+            n++;
+        }
+    }
+
+    return crc_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate the CRC with the oschecksum library
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcReference(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p)
+{
+    UINT32 crc;
+
+    if(pDesc_p == &crcPolyDesc_l[kCrcPolyCrc8])
+        crc = crc8Checksum(length_p, (UINT8*)pData_p, (UINT8)crc_p);
+    else if(pDesc_p == &crcPolyDesc_l[kCrcPolyCrc16AC9A])
+        crc = crc16Checksum_AC9A(length_p, pData_p, (UINT16)crc_p);
+    else if(pDesc_p == &crcPolyDesc_l[kCrcPolyCrc16755B])
+        crc = crc16Checksum(length_p, (UINT8*)pData_p, (UINT16)crc_p);
+    else
+        crc = crc32Checksum(length_p, (UINT8*)pData_p, crc_p);
+
+    return crc;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate the CRC bit by bit
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcBitwise(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                          const UINT8* pData_p, UINT32 length_p)
+{
+    UINT32 topBit = 1UL << (pDesc_p->width_m - 1);
+    UINT32 mask = (topBit << 1) - 1;
+    UINT8 bit;
+
+    crc_p &= mask;
+
+    while(length_p-- > 0)
+    {
+        crc_p ^= (UINT32)(*pData_p++) << (pDesc_p->width_m - 8);
+
+        for(bit = 0; bit < 8; bit++)
+        {
+            if((crc_p & topBit) != 0)
+                crc_p = (crc_p << 1) ^ pDesc_p->poly_m;
+            else
+                crc_p <<= 1;
+        }
+
+        crc_p &= mask;
+    }
+
+    return crc_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate an 8 bit CRC with one table
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcTable8(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                         const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT8* pTable = ((const UINT8 (*)[256])pDesc_p->pTable_m)[0];
+    UINT8 crc = (UINT8)crc_p;
+
+    while(length_p-- > 0)
+    {
+        crc = pTable[crc ^ *pData_p++];
+    }
+
+    return crc;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a 16 bit CRC with one table
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcTable16(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                          const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT16* pTable = ((const UINT16 (*)[256])pDesc_p->pTable_m)[0];
+    UINT16 crc = (UINT16)crc_p;
+
+    while(length_p-- > 0)
+    {
+        crc = (UINT16)((crc << 8) ^ pTable[(UINT8)((crc >> 8) ^ *pData_p++)]);
+    }
+
+    return crc;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a 32 bit CRC with one table
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcTable32(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                          const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT32* pTable = ((const UINT32 (*)[256])pDesc_p->pTable_m)[0];
+
+    while(length_p-- > 0)
+    {
+        crc_p = (crc_p << 8) ^ pTable[(UINT8)((crc_p >> 24) ^ *pData_p++)];
+    }
+
+    return crc_p;
+}
+
+#if (CRCENGINE_SLICE_MAX >= 4)
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a 16 bit CRC four bytes per step
+
+The CRC is merged into the first two bytes of each block. Every byte of the
+block is then looked up in the table for its distance to the end of the block.
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcSlice4_16(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT16 (*pTable)[256] = (const UINT16 (*)[256])pDesc_p->pTable_m;
+    UINT16 crc = (UINT16)crc_p;
+
+    while(length_p >= 4)
+    {
+        crc = (UINT16)(pTable[3][(UINT8)(pData_p[0] ^ (crc >> 8))] ^
+                       pTable[2][(UINT8)(pData_p[1] ^ crc)] ^
+                       pTable[1][pData_p[2]] ^
+                       pTable[0][pData_p[3]]);
+        pData_p += 4;
+        length_p -= 4;
+    }
+
+    return calcTable16(pDesc_p, crc, pData_p, length_p);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a 32 bit CRC four bytes per step
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcSlice4_32(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT32 (*pTable)[256] = (const UINT32 (*)[256])pDesc_p->pTable_m;
+
+    while(length_p >= 4)
+    {
+        crc_p = pTable[3][(UINT8)(pData_p[0] ^ (crc_p >> 24))] ^
+                pTable[2][(UINT8)(pData_p[1] ^ (crc_p >> 16))] ^
+                pTable[1][(UINT8)(pData_p[2] ^ (crc_p >> 8))] ^
+                pTable[0][(UINT8)(pData_p[3] ^ crc_p)];
+        pData_p += 4;
+        length_p -= 4;
+    }
+
+    return calcTable32(pDesc_p, crc_p, pData_p, length_p);
+}
+#endif /* #if (CRCENGINE_SLICE_MAX >= 4) */
+
+#if (CRCENGINE_SLICE_MAX >= 8)
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a 16 bit CRC eight bytes per step
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcSlice8_16(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT16 (*pTable)[256] = (const UINT16 (*)[256])pDesc_p->pTable_m;
+    UINT16 crc = (UINT16)crc_p;
+
+    while(length_p >= 8)
+    {
+        crc = (UINT16)(pTable[7][(UINT8)(pData_p[0] ^ (crc >> 8))] ^
+                       pTable[6][(UINT8)(pData_p[1] ^ crc)] ^
+                       pTable[5][pData_p[2]] ^
+                       pTable[4][pData_p[3]] ^
+                       pTable[3][pData_p[4]] ^
+                       pTable[2][pData_p[5]] ^
+                       pTable[1][pData_p[6]] ^
+                       pTable[0][pData_p[7]]);
+        pData_p += 8;
+        length_p -= 8;
+    }
+
+    return calcSlice4_16(pDesc_p, crc, pData_p, length_p);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate a 32 bit CRC eight bytes per step
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcSlice8_32(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                            const UINT8* pData_p, UINT32 length_p)
+{
+    const UINT32 (*pTable)[256] = (const UINT32 (*)[256])pDesc_p->pTable_m;
+
+    while(length_p >= 8)
+    {
+        crc_p = pTable[7][(UINT8)(pData_p[0] ^ (crc_p >> 24))] ^
+                pTable[6][(UINT8)(pData_p[1] ^ (crc_p >> 16))] ^
+                pTable[5][(UINT8)(pData_p[2] ^ (crc_p >> 8))] ^
+                pTable[4][(UINT8)(pData_p[3] ^ crc_p)] ^
+                pTable[3][pData_p[4]] ^
+                pTable[2][pData_p[5]] ^
+                pTable[1][pData_p[6]] ^
+                pTable[0][pData_p[7]];
+        pData_p += 8;
+        length_p -= 8;
+    }
+
+    return calcSlice4_32(pDesc_p, crc_p, pData_p, length_p);
+}
+#endif /* #if (CRCENGINE_SLICE_MAX >= 8) */
+
+#ifdef CRCENGINE_HW_CALC
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Calculate the CRC with the CRC unit of the target
+*/
+/*----------------------------------------------------------------------------*/
+static UINT32 calcHardware(const tCrcPolyDesc* pDesc_p, UINT32 crc_p,
+                           const UINT8* pData_p, UINT32 length_p)
+{
+    return CRCENGINE_HW_CALC((tCrcEnginePoly)(pDesc_p - crcPolyDesc_l), crc_p, pData_p, length_p);
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Generate the tables of all polynomials
+
+Table 0 is generated with the bitwise implementation, table n is table n-1
+followed by one zero byte.
+*/
+/*----------------------------------------------------------------------------*/
+static void generateTables(void)
+{
+    const tCrcPolyDesc* pDesc;
+    UINT32 crc;
+    UINT16 i;
+    UINT8 data;
+    UINT8 n;
+    UINT8 poly;
+
+    for(i = 0; i < 256; i++)
+    {
+        data = (UINT8)i;
+
+        pDesc = &crcPolyDesc_l[kCrcPolyCrc8];
+        crcTables_l.crc8_m[0][i] = (UINT8)calcBitwise(pDesc, 0, &data, 1);
+
+        pDesc = &crcPolyDesc_l[kCrcPolyCrc16AC9A];
+        crcTables_l.crc16AC9A_m[0][i] = (UINT16)calcBitwise(pDesc, 0, &data, 1);
+
+        pDesc = &crcPolyDesc_l[kCrcPolyCrc16755B];
+        crcTables_l.crc16755B_m[0][i] = (UINT16)calcBitwise(pDesc, 0, &data, 1);
+
+        pDesc = &crcPolyDesc_l[kCrcPolyCrc32];
+        crcTables_l.crc32_m[0][i] = calcBitwise(pDesc, 0, &data, 1);
+    }
+
+    data = 0;
+    for(n = 1; n < CRCENGINE_TABLE_CNT; n++)
+    {
+        for(i = 0; i < 256; i++)
+        {
+            crc = crcTables_l.crc16AC9A_m[n - 1][i];
+            crcTables_l.crc16AC9A_m[n][i] = (UINT16)calcTable16(&crcPolyDesc_l[kCrcPolyCrc16AC9A], crc, &data, 1);
+
+            crc = crcTables_l.crc16755B_m[n - 1][i];
+            crcTables_l.crc16755B_m[n][i] = (UINT16)calcTable16(&crcPolyDesc_l[kCrcPolyCrc16755B], crc, &data, 1);
+
+            crc = crcTables_l.crc32_m[n - 1][i];
+            crcTables_l.crc32_m[n][i] = calcTable32(&crcPolyDesc_l[kCrcPolyCrc32], crc, &data, 1);
+        }
+    }
+
+    /* x^8 is one zero byte through the CRC register, x^(8*2^n) is the square of x^(8*2^(n-1)) */
+    for(poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        pDesc = &crcPolyDesc_l[poly];
+        crcTables_l.xPow8_m[poly][0] = calcBitwise(pDesc, 1, &data, 1);
+        for(n = 1; n < 32; n++)
+        {
+            crc = crcTables_l.xPow8_m[poly][n - 1];
+            crcTables_l.xPow8_m[poly][n] = multModPoly(pDesc, crc, crc);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Compare an implementation with the reference
+
+The pattern is calculated with all lengths up to CRCENGINE_TEST_SIZE from an
+unaligned start address, with two initial values and in two chunks.
+
+\param[in] poly_p       The polynomial
+\param[in] impl_p       The implementation to test
+
+\retval TRUE    All results match the reference
+\retval FALSE   Mismatch
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN testImpl(tCrcEnginePoly poly_p, tCrcEngineImpl impl_p)
+{
+    BOOLEAN fReturn = TRUE;
+    const tCrcPolyDesc* pDesc = &crcPolyDesc_l[poly_p];
+    tCrcCalc pfnCalc = pDesc->apfnCalc_m[impl_p];
+    UINT8 pattern[CRCENGINE_TEST_SIZE + 1];
+    UINT32 initCrc;
+    UINT32 expCrc;
+    UINT32 crc;
+    UINT16 len;
+    UINT16 split;
+    UINT8 i;
+
+    for(len = 0; len < sizeof(pattern); len++)
+    {
+        pattern[len] = (UINT8)((len * 0x9DU) ^ 0x5AU);
+    }
+
+    for(i = 0; i < 2 && fReturn != FALSE; i++)
+    {
+        initCrc = (i == 0) ? 0 : (0xA5A5A5A5UL >> (32 - pDesc->width_m));
+
+        for(len = 0; len <= CRCENGINE_TEST_SIZE && fReturn != FALSE; len++)
+        {
+            expCrc = calcReference(pDesc, initCrc, &pattern[1], len);
+
+            crc = pfnCalc(pDesc, initCrc, &pattern[1], len);
+            if(crc != expCrc)
+            {
+                fReturn = FALSE;
+            }
+
+            /* Chunked calculation must give the same result */
+            split = len / 3;
+            crc = pfnCalc(pDesc, initCrc, &pattern[1], split);
+            crc = pfnCalc(pDesc, crc, &pattern[1 + split], len - split);
+            if(crc != expCrc)
+            {
+                fReturn = FALSE;
+            }
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Compare the combination of two CRCs with the chained calculation
+
+\param[in] poly_p       The polynomial
+
+\retval TRUE    crcengine_combine() matches the reference for all splits
+\retval FALSE   Mismatch
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN testCombine(tCrcEnginePoly poly_p)
+{
+    BOOLEAN fReturn = TRUE;
+    const tCrcPolyDesc* pDesc = &crcPolyDesc_l[poly_p];
+    UINT8 pattern[CRCENGINE_TEST_SIZE];
+    UINT32 initCrc = 0xA5A5A5A5UL >> (32 - pDesc->width_m);
+    UINT32 expCrc;
+    UINT32 crcA;
+    UINT32 crcB;
+    UINT16 split;
+
+    for(split = 0; split < sizeof(pattern); split++)
+    {
+        pattern[split] = (UINT8)((split * 0x3BU) ^ 0xC3U);
+    }
+
+    expCrc = calcReference(pDesc, initCrc, pattern, sizeof(pattern));
+
+    for(split = 0; split <= sizeof(pattern) && fReturn != FALSE; split++)
+    {
+        crcA = calcReference(pDesc, initCrc, pattern, split);
+        crcB = calcReference(pDesc, 0, &pattern[split], sizeof(pattern) - split);
+
+        if(crcengine_combine(poly_p, crcA, crcB, sizeof(pattern) - split) != expCrc)
+        {
+            fReturn = FALSE;
+        }
+    }
+
+    return fReturn;
+}
+
+/**
+ * \}
+ * \}
+ */
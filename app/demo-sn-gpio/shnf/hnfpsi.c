@@ -137,7 +137,8 @@ static BOOL processApp(UINT32 rpdoRelTimeLow_p,
         tTpdoMappedObj* pTpdoImage_p );
 
 static void syncHandler(void* pArg_p);
-static void serialTransferFinished(BOOL fError_p);
+static void serialTransferFinished(void);
+static void serialTransferError(tPcpSerialError error_p);
 
 static void errorHandler(tPsiErrorInfo* pErrorInfo_p);
 
@@ -495,7 +496,7 @@ static BOOL initPsi(void)
                 {
                     /* initialize serial interface*/
                     DEBUG_TRACE(DEBUG_LVL_ALWAYS,"\nInitialize serial device -> ");
-                    if(pcpserial_init(&transferParam, serialTransferFinished))
+                    if(pcpserial_init(&transferParam, serialTransferFinished, serialTransferError))
                     {
                         DEBUG_TRACE(DEBUG_LVL_ALWAYS, "SUCCESS!\n");
 
@@ -770,29 +771,37 @@ static void syncHandler(void* pArg_p)
 \brief    Serial transfer finished callback function
 
 This function is called after a serial transfer from the PCP to the application.
-
-\param[in] fError_p       True if the transfer had an error
+It is called from the transfer complete event (e.g. the DMA interrupt) and
+carries out all post transfer actions.
 */
 /*----------------------------------------------------------------------------*/
-static void serialTransferFinished(BOOL fError_p)
+static void serialTransferFinished(void)
 {
-    if(fError_p == FALSE)
-    {
-        BENCHMARK_MOD_01_SET(0);
-
-        /* Transfer finished -> Call all post action tasks */
-        if(psi_processPostTransferActions() == FALSE)
-        {
-            errh_postFatalError(kErrSourceHnf, kErrorSyncProcessFailed, 0);
-        }
+    BENCHMARK_MOD_01_SET(0);
 
-        BENCHMARK_MOD_01_RESET(0);
-    }
-    else
+    /* Transfer finished -> Call all post action tasks */
+    if(psi_processPostTransferActions() == FALSE)
     {
-        /* There was an error during serial transfer */
-        errh_postFatalError(kErrSourceHnf, kErrorSerialTransmitFailed, 0);
+        errh_postFatalError(kErrSourceHnf, kErrorSyncProcessFailed, 0);
     }
+
+    BENCHMARK_MOD_01_RESET(0);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Serial transfer error callback function
+
+This function is called if the serial transfer failed or was not finished in
+time.
+
+\param[in] error_p       Type of the serial transfer error
+*/
+/*----------------------------------------------------------------------------*/
+static void serialTransferError(tPcpSerialError error_p)
+{
+    /* There was an error during serial transfer */
+    errh_postFatalError(kErrSourceHnf, kErrorSerialTransmitFailed, (UINT32)error_p);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -0,0 +1,122 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/shnf/include/shnf/crcengine.h
+
+\brief  Provides the CRC calculation of the openSAFETY frames and parameters
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2013, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_shnf_crcengine_H_
+#define _INC_shnf_crcengine_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/global.h>
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#ifndef CRCENGINE_SLICE_MAX
+  /** Largest slice-by-N implementation (0, 4 or 8). Slice-by-8 needs ~17kB RAM,
+      the target caps it with CRCENGINE_SLICE_LIMIT */
+  #define CRCENGINE_SLICE_MAX           0
+#endif
+
+#ifndef CRCENGINE_DEFAULT_IMPL
+  #define CRCENGINE_DEFAULT_IMPL        kCrcImplTable   /**< Implementation selected by crcengine_init() */
+#endif
+
+#if (CRCENGINE_SLICE_MAX != 0) && (CRCENGINE_SLICE_MAX != 4) && (CRCENGINE_SLICE_MAX != 8)
+  #error "CRCENGINE_SLICE_MAX must be 0, 4 or 8"
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief CRC polynomials used by openSAFETY
+ */
+typedef enum
+{
+    kCrcPolyCrc8 = 0,           /**< 8 bit frame CRC (polynomial 0x2F) */
+    kCrcPolyCrc16AC9A,          /**< 16 bit frame CRC (polynomial 0x5935, 0xAC9A in Koopman notation) */
+    kCrcPolyCrc16755B,          /**< 16 bit frame CRC (polynomial 0x755B) */
+    kCrcPolyCrc32,              /**< 32 bit parameter CRC (polynomial 0x1EDC6F41) */
+    kCrcPolyCount,              /**< Number of polynomials */
+} tCrcEnginePoly;
+
+/**
+ * \brief CRC implementations
+ *
+ * The target enables the hardware implementation by providing
+ * CRCENGINE_HW_POLY_MASK (bit n set: polynomial n is supported) and
+ * CRCENGINE_HW_CALC(poly, crc, pData, len) in apptarget/target.h.
+ */
+typedef enum
+{
+    kCrcImplReference = 0,      /**< Reference implementation of the openSAFETY stack (oschecksum) */
+    kCrcImplBitwise,            /**< Bit by bit calculation without tables */
+    kCrcImplTable,              /**< One 256 entry table per polynomial */
+    kCrcImplSlice4,             /**< Four bytes per step with four tables */
+    kCrcImplSlice8,             /**< Eight bytes per step with eight tables */
+    kCrcImplHardware,           /**< CRC unit of the target */
+    kCrcImplCount,              /**< Number of implementations */
+} tCrcEngineImpl;
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+BOOLEAN crcengine_init(void);
+void crcengine_exit(void);
+
+BOOLEAN crcengine_select(tCrcEnginePoly poly_p, tCrcEngineImpl impl_p);
+tCrcEngineImpl crcengine_getImpl(tCrcEnginePoly poly_p);
+BOOLEAN crcengine_isAvailable(tCrcEnginePoly poly_p, tCrcEngineImpl impl_p);
+BOOLEAN crcengine_selfTest(void);
+void crcengine_benchmark(void);
+
+UINT32 crcengine_calc(tCrcEnginePoly poly_p, UINT32 initCrc_p, UINT32 length_p,
+                      const void* pData_p);
+UINT32 crcengine_combine(tCrcEnginePoly poly_p, UINT32 crcA_p, UINT32 crcB_p,
+                         UINT32 lengthB_p);
+
+#ifdef __cplusplus
+    }
+#endif
+
+
+#endif /* _INC_shnf_crcengine_H_ */
@@ -63,6 +63,22 @@ typedef struct
     tSyncCycle pfnSyncronize_m;     /**< Pointer to the sync cycle callback function */
 } tShnfInitParam;
 
+/**
+ * \brief Statistics of the SSDO/SNMT receive queue (Times in us)
+ */
+typedef struct
+{
+    UINT32 rxFrameCnt_m;        /**< Frames accepted by the receive queue */
+    UINT32 heldCnt_m;           /**< Deliveries kept in the channel because the queue was full */
+    UINT32 servicedCnt_m;       /**< Frames finished by the stack */
+    UINT32 budgetStopCnt_m;     /**< Calls of shnf_process() which left queued frames due to the budget */
+    UINT16 depth_m;             /**< Number of currently queued frames */
+    UINT16 depthMax_m;          /**< Maximum number of queued frames */
+    UINT32 waitTimeMax_m;       /**< Maximum time a frame waited in the queue */
+    UINT32 serviceTimeMax_m;    /**< Maximum time from the start to the end of the processing of a frame */
+    UINT32 serviceTimeSum_m;    /**< Sum of the service times of all finished frames */
+} tShnfRxStatistics;
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
@@ -77,6 +93,8 @@ void shnf_exit(void);
 void shnf_reset(void);
 
 BOOLEAN shnf_process(void);
+BOOLEAN shnf_isRxPending(void);
+void shnf_getRxStatistics(tShnfRxStatistics * pStat_p);
 
 void shnf_enableSyncIr(void);
 
@@ -7,6 +7,10 @@
 This header provides the interface to the SHNF transmit functions. It provides
 different implementations for single and dual channeled demos.
 
+The transmit module owns the memory blocks which are handed to the openSAFETY
+stack. The implementation decides where a block is placed and calculates the
+subframe layout once for each frame length.
+
 *******************************************************************************/
 
 /*------------------------------------------------------------------------------
@@ -57,6 +61,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /* typedef                                                                    */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * \brief Statistics of the SPDO transmit pool
+ */
+typedef struct
+{
+    UINT16 spdoBuilt_m;         /**< SPDO frames built by the stack in the last cycle */
+    UINT16 spdoPacked_m;        /**< SPDO frames placed in the transmit image in the last cycle */
+    UINT16 spdoDeferred_m;      /**< SPDO frames deferred to the next cycle in the last cycle */
+    UINT16 spdoPackedMax_m;     /**< Maximum number of SPDO frames placed in one cycle */
+    UINT32 spdoDeferredSum_m;   /**< Number of all deferred SPDO frames */
+} tShnfTxStatistics;
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
@@ -65,12 +81,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     extern "C" {
 #endif
 
-BOOLEAN shnftx_postSpdoFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
-                             UINT8 * pDstBase_p, UINT32 dstLen_p);
+void shnftx_init(void);
+
+UINT16 shnftx_getFreeSpdoSlots(void);
+UINT8 * shnftx_getSpdoMemBlock(UINT16 frameLen_p);
+BOOLEAN shnftx_markSpdoFrame(const UINT8 * pMemBlock_p);
+BOOLEAN shnftx_postSpdoFrames(void);
+void shnftx_getStatistics(tShnfTxStatistics * pStat_p);
 
-BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
-                                 UINT8 * pDstBase_p, UINT32 dstLen_p,
-                                 BOOLEAN isSlim_p);
+UINT8 * shnftx_getSsdoSnmtMemBlock(UINT16 frameLen_p, BOOLEAN isSlim_p);
+BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pDstBase_p, UINT32 dstLen_p);
 
 BOOLEAN shnftx_process(void);
 
@@ -63,6 +63,22 @@ typedef struct
     UINT32 subLen_m;        /**< The length of the subframe */
 } tSubFrameParams;
 
+/**
+ * \brief Cross communication traffic statistics
+ */
+typedef struct
+{
+    UINT32 txFrameCnt_m;    /**< Number of transmitted frames */
+    UINT32 txByteCnt_m;     /**< Number of transmitted bytes */
+    UINT32 rxFrameCnt_m;    /**< Number of received frames */
+    UINT32 rxByteCnt_m;     /**< Number of received bytes */
+    UINT32 isrTimeMax_m;    /**< Longest receive interrupt in us */
+    UINT32 isrTimeSum_m;    /**< Sum of all receive interrupts in us */
+    UINT32 procTimeMax_m;   /**< Longest processing of a received frame in us */
+    UINT32 procTimeSum_m;   /**< Sum of all frame processings in us */
+    UINT32 lateProcCnt_m;   /**< Frames which were processed after the next sync interrupt */
+} tXComStatistics;
+
 /*----------------------------------------------------------------------------*/
 /* function prototypes                                                        */
 /*----------------------------------------------------------------------------*/
@@ -76,12 +92,14 @@ void xcom_exit(void);
 
 BOOLEAN xcom_setCurrentTimebase(UINT64 * p_currTime);
 BOOLEAN xcom_enableReceiveCheck(void);
+void xcom_process(void);
 
 void xcom_setSsdoSnmtCrc(UINT16 crcSub1_p, UINT16 crcSub2_p);
 BOOLEAN xcom_postSsdoSnmtFrame(tSubFrameParams * pSub1Params_p,
                                tSubFrameParams * pSub2Params_p,
                                UINT8 * pTargBuff_p, UINT32 targLen_p);
 
+UINT8 * xcom_getSpdoMemBlock(UINT32 frameLen_p, UINT32 sub2Len_p);
 void xcom_setSpdoCrc(UINT16 crcSub1_p, UINT16 crcSub2_p);
 BOOLEAN xcom_postSpdoFrame(tSubFrameParams * pSub1Params_p,
                            tSubFrameParams * pSub2Params_p,
@@ -89,6 +107,8 @@ BOOLEAN xcom_postSpdoFrame(tSubFrameParams * pSub1Params_p,
 
 BOOLEAN xcom_transmit(UINT32 flowCount_p);
 
+void xcom_getStatistics(tXComStatistics * pStat_p);
+
 #ifdef __cplusplus
     }
 #endif
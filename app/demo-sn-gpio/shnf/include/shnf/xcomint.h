@@ -50,6 +50,44 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ID_VAL_MASL_MSG         (UINT8)0xAA    /**< ID value of the up-Master -> uP-Slave image */
 #define ID_VAL_SLMA_MSG         (UINT8)0x55    /**< ID value of the up-Slave -> uP-Master image */
 
+#define XCOM_FRAME_HEADER_SIZE  3       /**< Size of the compact frame header (frame length and message format) */
+#define XCOM_FRAME_SIZE_MAX     (XCOM_FRAME_HEADER_SIZE + sizeof(tXComSlMaImage))   /**< Maximum size of a compact frame */
+#define XCOM_IMG_SECTION_COUNT  4       /**< Number of image sections of a compact frame */
+
+/**
+ * \brief Describes the members first_p to last_p of an image as one section
+ */
+#define XCOM_IMG_SECTION(type_p, first_p, last_p, msgFormat_p)                      \
+    { (msgFormat_p), (UINT16)offsetof(type_p, first_p),                             \
+      (UINT16)(offsetof(type_p, last_p) + sizeof(((type_p *)0)->last_p) -           \
+               offsetof(type_p, first_p)) }
+
+/**
+ * \brief Sections of the uP-Master -> uP-Slave image in a compact frame
+ */
+#define XCOM_MASL_LAYOUT                                                            \
+{                                                                                   \
+    XCOM_IMG_SECTION(tXComMaSlImage, id_m, id_m, 0),                                \
+    XCOM_IMG_SECTION(tXComMaSlImage, flowCnt_m, currTime_m, 0),                     \
+    XCOM_IMG_SECTION(tXComMaSlImage, spdoSub1Crc_m, spdoSub2Crc_m,                  \
+                     (1<<MSG_FORMAT_SPDO_SET)),                                     \
+    XCOM_IMG_SECTION(tXComMaSlImage, ssdoSub1Crc_m, ssdoSub2Crc_m,                  \
+                     (1<<MSG_FORMAT_SSDO_SET)),                                     \
+}
+
+/**
+ * \brief Sections of the uP-Slave -> uP-Master image in a compact frame
+ */
+#define XCOM_SLMA_LAYOUT                                                            \
+{                                                                                   \
+    XCOM_IMG_SECTION(tXComSlMaImage, id_m, id_m, 0),                                \
+    XCOM_IMG_SECTION(tXComSlMaImage, flowCnt_m, currTime_m, 0),                     \
+    XCOM_IMG_SECTION(tXComSlMaImage, spdoSub1Crc_m, spdoSub2Payl_m,                 \
+                     (1<<MSG_FORMAT_SPDO_SET)),                                     \
+    XCOM_IMG_SECTION(tXComSlMaImage, ssdoSub1Crc_m, ssdoSub2Payl_m,                 \
+                     (1<<MSG_FORMAT_SSDO_SET)),                                     \
+}
+
 /*----------------------------------------------------------------------------*/
 /* typedef                                                                    */
 /*----------------------------------------------------------------------------*/
@@ -81,6 +119,10 @@ typedef struct
 
 /**
  * \brief Provides the structure of the uP-Slave -> uP-Master transmit image
+ *
+ * The SPDO payload is the last member. This allows the uP-Slave to place
+ * the SPDO memory block of the stack directly at the payload with subframe
+ * one running into a scratch area behind the image.
  */
 typedef struct
 {
@@ -88,23 +130,38 @@ typedef struct
     UINT8 msgFormat_m;                          /**< The format of this message */
     UINT32 flowCnt_m;                           /**< The value of the flow counter */
     UINT64 currTime_m;                          /**< The current timebase of the uP-Slave in us */
-    UINT16 spdoSub1Crc_m;                       /**< The CRC value of TSPDO sub1 */
-    UINT16 spdoSub2Crc_m;                       /**< The CRC value of TSPDO sub2 */
-    UINT8 spdoSub2Payl_m[TSPDO_SUB2_LEN];       /**< The payload of TSPDO sub2 */
     UINT16 ssdoSub1Crc_m;                       /**< The CRC value of TSSDO/TSNMT sub1 */
     UINT16 ssdoSub2Crc_m;                       /**< The CRC value of TSSDO/TSNMT sub2 */
     UINT8 ssdoSub2Payl_m[TSSDO_SNMT_SUB2_LEN];  /**< The payload of TSSDO/TSNMT sub2 */
+    UINT16 spdoSub1Crc_m;                       /**< The CRC value of TSPDO sub1 */
+    UINT16 spdoSub2Crc_m;                       /**< The CRC value of TSPDO sub2 */
+    UINT8 spdoSub2Payl_m[TSPDO_SUB2_LEN];       /**< The payload of TSPDO sub2 */
 } tXComSlMaImage;
 
+/**
+ * \brief Section of an image which is carried by a compact frame
+ *
+ * The sections are copied in the order of the layout. A section with a
+ * message format mask is only part of the frame if one of the bits is set.
+ */
+typedef struct
+{
+    UINT8 msgFormatMask_m;  /**< Message format bits of the section (0: always present) */
+    UINT16 offset_m;        /**< Offset of the section in the image */
+    UINT16 size_m;          /**< Size of the section */
+} tXComImgSection;
+
 /**
  * \brief The xcom module initialization parameters
  */
 typedef struct
 {
-    UINT8 * pTxImg_m;       /**< Pointer to the transmit image base address*/
-    UINT16 txImgSize_m;     /**< The size of the transmit image */
-    UINT8 * pRxImg_m;       /**< Pointer to the receive image base address*/
-    UINT16 rxImgSize_m;     /**< The size of the receive image */
+    UINT8 * pTxImg_m;                       /**< Pointer to the transmit image base address*/
+    UINT16 txImgSize_m;                     /**< The size of the transmit image */
+    UINT8 * pRxImg_m;                       /**< Pointer to the receive image base address*/
+    UINT16 rxImgSize_m;                     /**< The size of the receive image */
+    const tXComImgSection * pTxLayout_m;    /**< Sections of the transmit image (XCOM_IMG_SECTION_COUNT) */
+    const tXComImgSection * pRxLayout_m;    /**< Sections of the receive image (XCOM_IMG_SECTION_COUNT) */
 } tXComTransParams;
 
 
@@ -138,6 +195,7 @@ BOOLEAN xcomint_postSsdoSnmtFrame(tSubFrameParams * pSub1Params_p,
                                   UINT8 * pTargBuff_p, UINT32 targLen_p);
 BOOLEAN xcomint_handleSsdoSnmtPayload(void);
 
+UINT8 * xcomint_getSpdoMemBlock(UINT32 frameLen_p, UINT32 sub2Len_p);
 void xcomint_setSpdoCrc(UINT16 crcSub1_p, UINT16 crcSub2_p);
 BOOLEAN xcomint_getSpdoCrc(tPaylType paylType_p, UINT16 * pSub1Crc_p,
                                                  UINT16 * pSub2Crc_p);
@@ -57,9 +57,13 @@ to the HNF. Also the frame CRCs are calculated inside this module.
 
 #include <shnf/shnftx.h>
 #include <shnf/hnf.h>
+#include <shnf/crcengine.h>
+#include <shnf/constime.h>
 
 #include <sn/statehandler.h>
 
+#include <config/ssdo.h>
+
 #include <SODapi.h>
 #include <SNMTSapi.h>
 #include <SSCapi.h>
@@ -67,7 +71,6 @@ to the HNF. Also the frame CRCs are calculated inside this module.
 #include <SCFMapi.h>
 #include <SHNF.h>
 
-#include <oschecksum/crc.h>
 
 /*============================================================================*/
 /*            G L O B A L   D E F I N I T I O N S                             */
@@ -77,12 +80,6 @@ to the HNF. Also the frame CRCs are calculated inside this module.
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
 
-/* Count of transmit channels (0=Sync0; 1=Async0) */
-#define TX_CHANNEL_COUNT            2
-
-#define TX_CHANNEL_SPDO             0
-#define TX_CHANNEL_SSDO_SNMT        1
-
 /* Positions of fields inside a frame */
 #define FRAME_OFFSET_SADR_LOW   0x0
 #define FRAME_OFFSET_ADRID      0x1
@@ -113,6 +110,23 @@ to the HNF. Also the frame CRCs are calculated inside this module.
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
+#ifndef SHNF_RX_SNMT_QUEUE_SIZE
+  #define SHNF_RX_SNMT_QUEUE_SIZE       2       /**< Number of queued SNMT frames */
+#endif
+
+#ifndef SHNF_RX_SSDO_QUEUE_SIZE
+  #define SHNF_RX_SSDO_QUEUE_SIZE       2       /**< Number of queued SSDO frames (and all other types) */
+#endif
+
+#ifndef SHNF_RX_BUDGET_CALLS
+  #define SHNF_RX_BUDGET_CALLS          2       /**< Calls of the SSC frame processing per call of shnf_process() */
+#endif
+
+#ifndef SHNF_RX_BUDGET_US
+  #define SHNF_RX_BUDGET_US             200     /**< Time in us after which shnf_process() starts no further frame */
+#endif
+
+#define SHNF_RX_FRAME_SIZE      SSDO_STUB_DATA_DOM_SIZE     /**< Size of a queued frame (Size of the asynchronous channel) */
 
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
@@ -128,11 +142,40 @@ typedef enum
     kSsdoRxStatusBusy    = 0x2,
 } tSsdoSnmtRxStatus;
 
+/**
+ * \brief Receive queues in the order of their priority
+ */
+typedef enum
+{
+    kRxQueueSnmt  = 0x0,        /**< SNMT frames (Serviced first) */
+    kRxQueueSsdo  = 0x1,        /**< SSDO frames and all other frame types */
+    kRxQueueCount = 0x2,
+} tRxQueueId;
+
+/**
+ * \brief A received SSDO/SNMT frame waiting for the SSC
+ */
+typedef struct
+{
+    UINT16 frameLen_m;                      /**< Length of the frame */
+    UINT32 rcvTime_m;                       /**< Time base in us when the frame was queued */
+    UINT8 frame_m[SHNF_RX_FRAME_SIZE];      /**< Copy of the frame (Modified in place by the stack) */
+} tRxQueueEntry;
+
+/**
+ * \brief FIFO of received frames of one priority
+ */
+typedef struct
+{
+    tRxQueueEntry * pEntry_m;       /**< Entries of the queue */
+    UINT8 size_m;                   /**< Number of entries */
+    UINT8 head_m;                   /**< Index of the oldest frame */
+    UINT8 count_m;                  /**< Number of queued frames */
+} tRxQueue;
+
 typedef struct
 {
-    UINT16 frameLen_m;                            /**< Length of the frame */
-    UINT8 txBuffer_m[SSC_k_MAX_TEL_LEN_LONG];     /**< Temporary buffer of the frame to fill */
-    BOOLEAN isSlim;                               /**< True if the frame is a SSDO slim frame */
+    UINT8 * pMemBlock_m;        /**< Memory block of the frame to fill (Provided by the transmit module) */
 } tTxDescriptor;
 
 /**
@@ -141,7 +184,13 @@ typedef struct
 typedef struct
 {
     tSsdoSnmtRxStatus  ssdoRxStatus_m;                  /**< Status of the receive state machine */
-    tTxDescriptor      txDesc_m[TX_CHANNEL_COUNT];      /**< Transmit descriptor of each transmit channel */
+    tRxQueue           rxQueue_m[kRxQueueCount];        /**< Receive queues of the SSDO/SNMT channel */
+    tRxQueueEntry      snmtEntry_m[SHNF_RX_SNMT_QUEUE_SIZE];    /**< Entries of the SNMT queue */
+    tRxQueueEntry      ssdoEntry_m[SHNF_RX_SSDO_QUEUE_SIZE];    /**< Entries of the SSDO queue */
+    tRxQueueEntry *    pBusyEntry_m;                    /**< Frame which is currently processed by the SSC */
+    UINT32             serviceStart_m;                  /**< Time base in us when the SSC started the busy frame */
+    tShnfRxStatistics  rxStat_m;                        /**< Statistics of the receive queue */
+    tTxDescriptor      ssdoSnmtTxDesc_m;                /**< Transmit descriptor of the SSDO/SNMT channel (SPDO slots are kept by shnftx) */
     tShnfProcSync      pfnProcSync_m;                   /**< Process sync callback function (Called at the end of the cycle) */
 } tShnfInstance;
 
@@ -167,6 +216,11 @@ static BOOLEAN processRxSsdoSnmtFrame(UINT8* pPayload_p, UINT16 paylLen_p);
 static void processRxSpdoFrame(UINT8* pPayload_p, UINT16 paylLen_p);
 static BOOLEAN processSync(void);
 
+static BOOLEAN serviceRxQueue(void);
+static BOOLEAN queueRxFrame(const UINT8 * pPayload_p, UINT16 paylLen_p);
+static tRxQueueEntry * getNextRxFrame(void);
+static void finishRxFrame(void);
+
 static UINT16 getFrameLength(const UINT8 * pPaylLen_p);
 
 /*============================================================================*/
@@ -194,6 +248,8 @@ BOOLEAN shnf_init(tShnfInitParam * pInitParam_p)
     MEMSET(&shnfInstance_l, 0, sizeof(tShnfInstance));
     MEMSET(&hnfInitParam, 0, sizeof(tHnfInit));
 
+    shnftx_init();
+
     if(pInitParam_p != NULL)
     {
         if(pInitParam_p->pfnProcSync_m != NULL  &&
@@ -203,6 +259,11 @@ BOOLEAN shnf_init(tShnfInitParam * pInitParam_p)
             shnfInstance_l.ssdoRxStatus_m = kSsdoRxStatusReady;
             shnfInstance_l.pfnProcSync_m = pInitParam_p->pfnProcSync_m;
 
+            shnfInstance_l.rxQueue_m[kRxQueueSnmt].pEntry_m = &shnfInstance_l.snmtEntry_m[0];
+            shnfInstance_l.rxQueue_m[kRxQueueSnmt].size_m = SHNF_RX_SNMT_QUEUE_SIZE;
+            shnfInstance_l.rxQueue_m[kRxQueueSsdo].pEntry_m = &shnfInstance_l.ssdoEntry_m[0];
+            shnfInstance_l.rxQueue_m[kRxQueueSsdo].size_m = SHNF_RX_SSDO_QUEUE_SIZE;
+
             /* Setup the HNF initialization parameters */
             hnfInitParam.asyncRcvChan0Handler_m = processRxSsdoSnmtFrame;
             hnfInitParam.syncRcvHandler_m = processRxSpdoFrame;
@@ -210,11 +271,14 @@ BOOLEAN shnf_init(tShnfInitParam * pInitParam_p)
             hnfInitParam.pfnProcSync_m = processSync;
             hnfInitParam.pfnSyncronize_m = pInitParam_p->pfnSyncronize_m;
 
-            /* Initialize the slim interface HNF */
-            if(hnf_init(&hnfInitParam))
+            /* Initialize the CRC engine of the openSAFETY frames */
+            if(crcengine_init())
             {
-                /* Initialize the consecutive time module */
-                fReturn = TRUE;
+                /* Initialize the slim interface HNF */
+                if(hnf_init(&hnfInitParam))
+                {
+                    fReturn = TRUE;
+                }
             }
         }
         else
@@ -238,6 +302,8 @@ BOOLEAN shnf_init(tShnfInitParam * pInitParam_p)
 void shnf_exit(void)
 {
     hnf_exit();
+
+    crcengine_exit();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -258,59 +324,74 @@ void shnf_reset(void)
 \brief    Process the SHNF background task
 
 Needs to be called periodically and processes the asynchronous data of the
-hardware near firmware.
+hardware near firmware. Received SSDO/SNMT frames are queued by the receive
+handler and forwarded to the stack within the budget of SHNF_RX_BUDGET_CALLS
+and SHNF_RX_BUDGET_US per call.
 */
 /*----------------------------------------------------------------------------*/
 BOOLEAN shnf_process(void)
 {
     BOOLEAN fReturn = FALSE;
     UINT32 consTime;
-    SSC_t_PROCESS ssdoProcRet;
     /* number of free management frames can be sent per call of the SSC_BuildTxFrames */
     UINT8 freeMngtFrmsCount = 1U;
 
-    switch(shnfInstance_l.ssdoRxStatus_m)
+    /* Receive frames are also accepted while the stack is busy */
+    if(hnf_processAsync())
     {
-        case kSsdoRxStatusReady:
+        if(serviceRxQueue())
         {
-            if(hnf_processAsync())
+            if(shnfInstance_l.ssdoRxStatus_m == kSsdoRxStatusReady)
             {
                 consTime = constime_getTime();
 
                 /* Guard timeout is checked in operational state,
                  * reset guarding SCM, when in pre-operational state */
                 SNMTS_TimerCheck(B_INSTNUM_ consTime, &freeMngtFrmsCount);
-
-                fReturn = TRUE;
-            }
-            break;
-        }
-        case kSsdoRxStatusBusy:
-        {
-            consTime = constime_getTime();
-
-            /* Call SSDO/SNMT process function with null argument to continue processing */
-            ssdoProcRet = SSC_ProcessSNMTSSDOFrame(B_INSTNUM_ consTime, NULL, 0);
-            if(ssdoProcRet == SSC_k_OK)
-            {
-                hnf_finishedAsyncRxChannel0();
-                shnfInstance_l.ssdoRxStatus_m = kSsdoRxStatusReady;
             }
 
             fReturn = TRUE;
-
-            break;
-        }
-        default:
-        {
-            errh_postFatalError(kErrSourceShnf, kErrorInvalidState, 0);
-            break;
         }
     }
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if received SSDO/SNMT frames are waiting for the stack
+
+\retval TRUE    Frames are queued
+\retval FALSE   The receive queue is empty
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN shnf_isRxPending(void)
+{
+    BOOLEAN fPending = FALSE;
+
+    if(shnfInstance_l.rxStat_m.depth_m > 0)
+    {
+        fPending = TRUE;
+    }
+
+    return fPending;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the SSDO/SNMT receive queue
+
+\param[out] pStat_p     Pointer to the statistics
+*/
+/*----------------------------------------------------------------------------*/
+void shnf_getRxStatistics(tShnfRxStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &shnfInstance_l.rxStat_m, sizeof(tShnfRxStatistics));
+    }
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Enable the synchronous interrupt
@@ -348,7 +429,7 @@ UINT8 * SHNF_GetTxMemBlock(BYTE_B_INSTNUM_ UINT16 w_blockSize,
                            SHNF_t_TEL_TYPE e_telType, UINT16 w_txSpdoNum)
 {
     UINT8 *pResBuffer = (UINT8 *)NULL;
-    tTxDescriptor * pTxDesc = (tTxDescriptor*)NULL;
+    tTxDescriptor * pTxDesc = &shnfInstance_l.ssdoSnmtTxDesc_m;
 
 #if (EPLS_cfg_MAX_INSTANCES > 1)
     UNUSED_PARAMETER(b_instNum);    /* to avoid compiler warnings */
@@ -359,33 +440,26 @@ UINT8 * SHNF_GetTxMemBlock(BYTE_B_INSTNUM_ UINT16 w_blockSize,
     /* Check if frame is synchronous */
     if(e_telType == SHNF_k_SPDO)
     {
-        pTxDesc = &shnfInstance_l.txDesc_m[TX_CHANNEL_SPDO];
-        /* Remember size of the frame */
-        pTxDesc->frameLen_m = w_blockSize;
-        /* Set return value to current buffer */
-        pResBuffer = pTxDesc->txBuffer_m;
+        /* Get a free slot of the SPDO transmit pool */
+        pResBuffer = shnftx_getSpdoMemBlock(w_blockSize);
     }
     else
     {
         /* Frame needs the asynchronous buffer */
-        pTxDesc = &shnfInstance_l.txDesc_m[TX_CHANNEL_SSDO_SNMT];
-
         if(e_telType == SHNF_k_SSDO ||
            e_telType == SHNF_k_SNMT)
         {
-            /* Remember size of the frame */
-            pTxDesc->frameLen_m = w_blockSize;
+            /* Get the placed memory block of the frame */
+            pTxDesc->pMemBlock_m = shnftx_getSsdoSnmtMemBlock(w_blockSize, FALSE);
             /* Set return value to current buffer */
-            pResBuffer = &pTxDesc->txBuffer_m[0];
-            pTxDesc->isSlim = FALSE;
+            pResBuffer = pTxDesc->pMemBlock_m;
         }
         else if (e_telType == SHNF_k_SSDO_SLIM)
         {
-            /* Remember size of the frame */
-            pTxDesc->frameLen_m = w_blockSize;
+            /* Get the placed memory block of the frame */
+            pTxDesc->pMemBlock_m = shnftx_getSsdoSnmtMemBlock(w_blockSize, TRUE);
             /* Set return value to current buffer */
-            pResBuffer = &pTxDesc->txBuffer_m[0];
-            pTxDesc->isSlim = TRUE;
+            pResBuffer = pTxDesc->pMemBlock_m;
         }
         else
         {
@@ -419,7 +493,6 @@ UINT8 * SHNF_GetTxMemBlock(BYTE_B_INSTNUM_ UINT16 w_blockSize,
 BOOLEAN SHNF_MarkTxMemBlock(BYTE_B_INSTNUM_ const UINT8 *pb_memBlock)
 {
     BOOLEAN fReturn = FALSE;
-    tTxDescriptor * pTxDesc = (tTxDescriptor*)NULL;
     UINT8 * pTargBuffer = (UINT8 *)NULL;
     UINT16 targBuffLen = 0;
 
@@ -427,42 +500,26 @@ BOOLEAN SHNF_MarkTxMemBlock(BYTE_B_INSTNUM_ const UINT8 *pb_memBlock)
     UNUSED_PARAMETER(b_instNum); /* to avoid compiler warnings */
 #endif
 
-    if(pb_memBlock == shnfInstance_l.txDesc_m[TX_CHANNEL_SPDO].txBuffer_m)
+    if(pb_memBlock == NULL)
     {
-        /* Frame to transmit is a SPDO frame */
-        pTxDesc = &shnfInstance_l.txDesc_m[TX_CHANNEL_SPDO];
-
-        /* Get transmit buffer from HNF */
-        if(hnf_getSyncTxBuffer(&pTargBuffer, &targBuffLen))
-        {
-            DEBUG_TRACE(DEBUG_LVL_SHNF, "Snd TPDO\n");
-
-            /* Forward SPDO frame to underlying layer */
-            if(shnftx_postSpdoFrame(pTxDesc->txBuffer_m, pTxDesc->frameLen_m,
-                                    pTargBuffer, targBuffLen))
-            {
-                fReturn = TRUE;
-            }
-        }
-        else
-        {
-            errh_postFatalError(kErrSourceShnf, kErrorSyncFrameNoBuffer, 0);
-        }
+        /* Invalid memory block prepared for transmission */
+        errh_postFatalError(kErrSourceShnf, kErrorInvalidTxMemory, 0);
     }
-    else if(pb_memBlock == shnfInstance_l.txDesc_m[TX_CHANNEL_SSDO_SNMT].txBuffer_m)
+    else if(shnftx_markSpdoFrame(pb_memBlock))
+    {
+        /* Frame to transmit is a SPDO frame (Packed after the stack has built all frames) */
+        fReturn = TRUE;
+    }
+    else if(pb_memBlock == shnfInstance_l.ssdoSnmtTxDesc_m.pMemBlock_m)
     {
         /* Frame to transmit is an asynchronous frame */
-        pTxDesc = &shnfInstance_l.txDesc_m[TX_CHANNEL_SSDO_SNMT];
-
         /* Get asynchronous target buffer from hnf */
         if(hnf_getAsyncTxBufferChannel0(&pTargBuffer, &targBuffLen))
         {
-            DEBUG_TRACE(DEBUG_LVL_SHNF, "Snd SSDO/SNMT\n");
+            DEBUG_LOG(DEBUG_LVL_SHNF, "Snd SSDO/SNMT\n");
 
             /* Forward SSDO/SNMT frame to underlying layer */
-            if(shnftx_postSsdoSnmtFrame(pTxDesc->txBuffer_m, pTxDesc->frameLen_m,
-                                        pTargBuffer, targBuffLen,
-                                        pTxDesc->isSlim))
+            if(shnftx_postSsdoSnmtFrame(pTargBuffer, targBuffLen))
             {
                 fReturn = TRUE;
             }
@@ -495,7 +552,7 @@ BOOLEAN SHNF_MarkTxMemBlock(BYTE_B_INSTNUM_ const UINT8 *pb_memBlock)
 UINT8 HNFiff_Crc8CalcSwp(UINT8 b_initCrc, INT32 l_subFrameLength,
                          const void *pv_subFrame)
 {
-    return crc8Checksum(l_subFrameLength, (UINT8*)pv_subFrame, b_initCrc);
+    return (UINT8)crcengine_calc(kCrcPolyCrc8, b_initCrc, (UINT32)l_subFrameLength, pv_subFrame);
 }
 
 
@@ -512,7 +569,7 @@ UINT8 HNFiff_Crc8CalcSwp(UINT8 b_initCrc, INT32 l_subFrameLength,
 UINT16 HNFiff_Crc16CalcSwp(UINT16 w_initCrc, INT32 l_subFrameLength,
                            const void *pv_subFrame)
 {
-    return crc16Checksum_AC9A(l_subFrameLength, pv_subFrame, w_initCrc);
+    return (UINT16)crcengine_calc(kCrcPolyCrc16AC9A, w_initCrc, (UINT32)l_subFrameLength, pv_subFrame);
 }
 
 /**
@@ -528,7 +585,7 @@ UINT16 HNFiff_Crc16CalcSwp(UINT16 w_initCrc, INT32 l_subFrameLength,
 UINT16 HNFiff_Crc16_755B_CalcSwp(UINT16 w_initCrc, INT32 l_subFrameLength,
                                  const void *pv_subFrame)
 {
-    return crc16Checksum(l_subFrameLength, (UINT8*)pv_subFrame, w_initCrc);
+    return (UINT16)crcengine_calc(kCrcPolyCrc16755B, w_initCrc, (UINT32)l_subFrameLength, pv_subFrame);
 }
 
 /*============================================================================*/
@@ -542,25 +599,36 @@ UINT16 HNFiff_Crc16_755B_CalcSwp(UINT16 w_initCrc, INT32 l_subFrameLength,
 \brief    Triggers the creation of an SPDO transmit frame
 
 This function is called periodically in every cycle to ensure that a transmit
-spdo is created in every cycle.
+spdo is created in every cycle. The stack may build one frame for each free
+slot of the transmit pool. All built frames are packed into the transmit image
+afterwards.
 */
 /*----------------------------------------------------------------------------*/
 static void buildTxSpdoFrame(void)
 {
-    UINT16 numFreeSpdoFrms = 1U; /* number of free SPDO frames can be sent per call of the SSC_BuildTxFrames */
+    UINT16 numFreeSpdoFrms; /* number of free SPDO frames can be sent per call of the SSC_BuildTxFrames */
     UINT32 consTime;
 
     if(stateh_getSnState() == kSnStateOperational)
     {
         consTime = constime_getTime();
 
-        DEBUG_TRACE(DEBUG_LVL_SHNF, "Build TSPDO\n");
+        /* The stack fills all free slots of the transmit pool */
+        numFreeSpdoFrms = shnftx_getFreeSpdoSlots();
+
+        DEBUG_LOG(DEBUG_LVL_SHNF, "Build TSPDO\n");
 
        #if (SPDO_cfg_40_BIT_CT_SUPPORT == EPLS_k_ENABLE)
         SPDO_UpdateExtCtValue(B_INSTNUM_ consTime);
        #endif /* (SPDO_cfg_40_BIT_CT_SUPPORT == EPLS_k_ENABLE) */
-        /* SPDO frames are built */
-        SPDO_BuildTxSpdo(B_INSTNUM_ consTime, &numFreeSpdoFrms);
+        if(numFreeSpdoFrms > 0)
+        {
+            /* SPDO frames are built */
+            SPDO_BuildTxSpdo(B_INSTNUM_ consTime, &numFreeSpdoFrms);
+        }
+
+        /* Pack the built frames into the transmit image (Errors are posted by shnftx) */
+        (void)shnftx_postSpdoFrames();
     }
 }
 
@@ -568,41 +636,44 @@ static void buildTxSpdoFrame(void)
 /**
 \brief    Process the incoming receive SSDO/SNMT frame
 
+The frame is copied to the receive queue of its type and the channel is freed
+for the next frame. If the queue is full the channel is kept and the frame is
+delivered again on the next call of hnf_processAsync().
+
 \param pPayload_p   Pointer to the incoming payload
 \param paylLen_p    The length of the payload
 
-\retval TRUE    Successfully processed the incoming frame
-\retval FALSE   Stack is currently busy
+\retval TRUE    Frame is queued, held in the channel for re-delivery or
+                ignored because the SN is not initialized yet
+\retval FALSE   Frame is larger than SHNF_RX_FRAME_SIZE (fatal error posted)
 */
 /*----------------------------------------------------------------------------*/
 static BOOLEAN processRxSsdoSnmtFrame(UINT8* pPayload_p, UINT16 paylLen_p)
 {
     BOOLEAN fReturn = FALSE;
-    UINT32 consTime;
-    SSC_t_PROCESS procRet;
 
     if(stateh_getSnState() > kSnStateInitializing)
     {
-        if(shnfInstance_l.ssdoRxStatus_m == kSsdoRxStatusReady)
+        if(paylLen_p <= SHNF_RX_FRAME_SIZE)
         {
-            consTime = constime_getTime();
-
-            DEBUG_TRACE(DEBUG_LVL_SHNF, "Rcv SSDO/SNMT\n");
+            DEBUG_LOG(DEBUG_LVL_SHNF, "Rcv SSDO/SNMT\n");
 
-            /* Forward frame to stack */
-            procRet = SSC_ProcessSNMTSSDOFrame(B_INSTNUM_ consTime, pPayload_p, paylLen_p);
-            if(procRet == SSC_k_BUSY)
+            if(queueRxFrame(pPayload_p, paylLen_p))
             {
-                /* Frame is passed to the stack but takes further calls of the process function to finish */
-                shnfInstance_l.ssdoRxStatus_m = kSsdoRxStatusBusy;
+                /* Frame is copied to the queue -> Free the channel */
+                hnf_finishedAsyncRxChannel0();
             }
-            else if(procRet == SSC_k_OK)
+            else
             {
-                /* Frame is finished without change to busy or processing was not successful, free frame */
-                hnf_finishedAsyncRxChannel0();
+                /* Queue is full -> Keep the frame in the channel until there is space */
+                shnfInstance_l.rxStat_m.heldCnt_m++;
             }
             fReturn = TRUE;
-        }   /* no else: frame can only be posted when state machine is ready -> return false! */
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceShnf, kErrorAsyncFrameTooLarge, paylLen_p);
+        }
     }
     else
     {
@@ -642,7 +713,7 @@ static void processRxSpdoFrame(UINT8* pPayload_p, UINT16 paylLen_p)
             /* Get payload length field from frame */
             pLenField = &pPayload_p[FRAME_OFFSET_LENGTH];
 
-            DEBUG_TRACE(DEBUG_LVL_SHNF, "Rcv RSPDO\n");
+            DEBUG_LOG(DEBUG_LVL_SHNF, "Rcv RSPDO\n");
 
             consTime = constime_getTime();
 
@@ -702,6 +773,227 @@ static BOOLEAN processSync(void)
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Forward the queued SSDO/SNMT frames to the stack
+
+A busy frame is continued before the next frame is started. SNMT frames are
+started before SSDO frames, the order of the frames of one type is kept. A
+frame is only started if the transmit channel is free for its response. The
+processing stops after SHNF_RX_BUDGET_CALLS calls of the stack or when
+SHNF_RX_BUDGET_US is elapsed, the rest is left to the next call.
+
+\retval TRUE    Processing of the queue successful
+\retval FALSE   Invalid receive state
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN serviceRxQueue(void)
+{
+    BOOLEAN fReturn = TRUE;
+    BOOLEAN fStop = FALSE;
+    UINT8 callCnt = 0;
+    UINT32 startTime = (UINT32)constime_getTimeBase();
+    UINT32 consTime;
+    UINT8 * pTxBuffer = NULL;
+    UINT16 txBuffLen = 0;
+    tRxQueueEntry * pEntry;
+    SSC_t_PROCESS procRet;
+
+    while(fStop == FALSE)
+    {
+        if(callCnt >= SHNF_RX_BUDGET_CALLS                                   ||
+           (UINT32)constime_getTimeBase() - startTime >= SHNF_RX_BUDGET_US    )
+        {
+            if(shnfInstance_l.rxStat_m.depth_m > 0)
+            {
+                shnfInstance_l.rxStat_m.budgetStopCnt_m++;
+            }
+            fStop = TRUE;
+        }
+        else if(shnfInstance_l.ssdoRxStatus_m == kSsdoRxStatusBusy)
+        {
+            consTime = constime_getTime();
+
+            /* Call SSDO/SNMT process function with null argument to continue processing */
+            procRet = SSC_ProcessSNMTSSDOFrame(B_INSTNUM_ consTime, NULL, 0);
+            callCnt++;
+            if(procRet == SSC_k_OK)
+            {
+                finishRxFrame();
+            }
+            else
+            {
+                /* Stack waits for an event -> Continue on the next call */
+                fStop = TRUE;
+            }
+        }
+        else if(shnfInstance_l.ssdoRxStatus_m == kSsdoRxStatusReady)
+        {
+            pEntry = getNextRxFrame();
+            if(pEntry == NULL)
+            {
+                /* Queue is empty */
+                fStop = TRUE;
+            }
+            else if(hnf_getAsyncTxBufferChannel0(&pTxBuffer, &txBuffLen) == FALSE)
+            {
+                /* Last response is still in the transmit channel -> Start the frame later */
+                fStop = TRUE;
+            }
+            else
+            {
+                consTime = constime_getTime();
+
+                shnfInstance_l.pBusyEntry_m = pEntry;
+                shnfInstance_l.serviceStart_m = (UINT32)constime_getTimeBase();
+
+                /* Forward frame to stack */
+                procRet = SSC_ProcessSNMTSSDOFrame(B_INSTNUM_ consTime, pEntry->frame_m,
+                                                   pEntry->frameLen_m);
+                callCnt++;
+                if(procRet == SSC_k_BUSY)
+                {
+                    /* Frame is passed to the stack but takes further calls of the process function to finish */
+                    shnfInstance_l.ssdoRxStatus_m = kSsdoRxStatusBusy;
+                }
+                else
+                {
+                    /* Frame is finished or processing was not successful -> Free queue entry */
+                    finishRxFrame();
+                }
+            }
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceShnf, kErrorInvalidState, 0);
+            fReturn = FALSE;
+            fStop = TRUE;
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Copy a received frame to the queue of its frame type
+
+\param pPayload_p   Pointer to the received frame
+\param paylLen_p    The length of the frame
+
+\retval TRUE    Frame is queued
+\retval FALSE   Queue of the frame type is full
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN queueRxFrame(const UINT8 * pPayload_p, UINT16 paylLen_p)
+{
+    BOOLEAN fReturn = FALSE;
+    tRxQueue * pQueue = &shnfInstance_l.rxQueue_m[kRxQueueSsdo];
+    tRxQueueEntry * pEntry;
+    UINT8 tail;
+
+    if(paylLen_p > FRAME_OFFSET_ADRID &&
+       (pPayload_p[FRAME_OFFSET_ADRID] & ID_FRAME_MASK) == SNMT_FRAME_TYPE)
+    {
+        pQueue = &shnfInstance_l.rxQueue_m[kRxQueueSnmt];
+    }
+
+    if(pQueue->count_m < pQueue->size_m)
+    {
+        tail = (UINT8)((pQueue->head_m + pQueue->count_m) % pQueue->size_m);
+        pEntry = &pQueue->pEntry_m[tail];
+
+        MEMCOPY(&pEntry->frame_m[0], pPayload_p, paylLen_p);
+        pEntry->frameLen_m = paylLen_p;
+        pEntry->rcvTime_m = (UINT32)constime_getTimeBase();
+
+        pQueue->count_m++;
+
+        shnfInstance_l.rxStat_m.rxFrameCnt_m++;
+        shnfInstance_l.rxStat_m.depth_m++;
+        if(shnfInstance_l.rxStat_m.depth_m > shnfInstance_l.rxStat_m.depthMax_m)
+        {
+            shnfInstance_l.rxStat_m.depthMax_m = shnfInstance_l.rxStat_m.depth_m;
+        }
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the next frame to forward to the stack
+
+The oldest frame of the queue with the highest priority is returned. It stays
+in the queue until finishRxFrame() is called.
+
+\return Pointer to the queue entry; NULL if all queues are empty
+*/
+/*----------------------------------------------------------------------------*/
+static tRxQueueEntry * getNextRxFrame(void)
+{
+    tRxQueueEntry * pEntry = (tRxQueueEntry *)NULL;
+    tRxQueue * pQueue;
+    UINT32 waitTime;
+    UINT8 i;
+
+    for(i = 0; i < kRxQueueCount; i++)
+    {
+        pQueue = &shnfInstance_l.rxQueue_m[i];
+        if(pQueue->count_m > 0)
+        {
+            pEntry = &pQueue->pEntry_m[pQueue->head_m];
+
+            waitTime = (UINT32)constime_getTimeBase() - pEntry->rcvTime_m;
+            if(waitTime > shnfInstance_l.rxStat_m.waitTimeMax_m)
+            {
+                shnfInstance_l.rxStat_m.waitTimeMax_m = waitTime;
+            }
+            break;
+        }
+    }
+
+    return pEntry;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Remove the frame which was processed by the stack from its queue
+*/
+/*----------------------------------------------------------------------------*/
+static void finishRxFrame(void)
+{
+    tRxQueue * pQueue;
+    UINT32 serviceTime;
+    UINT8 i;
+
+    for(i = 0; i < kRxQueueCount; i++)
+    {
+        pQueue = &shnfInstance_l.rxQueue_m[i];
+        if(pQueue->count_m > 0 &&
+           &pQueue->pEntry_m[pQueue->head_m] == shnfInstance_l.pBusyEntry_m)
+        {
+            pQueue->head_m = (UINT8)((pQueue->head_m + 1) % pQueue->size_m);
+            pQueue->count_m--;
+            shnfInstance_l.rxStat_m.depth_m--;
+            break;
+        }
+    }
+
+    serviceTime = (UINT32)constime_getTimeBase() - shnfInstance_l.serviceStart_m;
+    if(serviceTime > shnfInstance_l.rxStat_m.serviceTimeMax_m)
+    {
+        shnfInstance_l.rxStat_m.serviceTimeMax_m = serviceTime;
+    }
+    shnfInstance_l.rxStat_m.serviceTimeSum_m += serviceTime;
+    shnfInstance_l.rxStat_m.servicedCnt_m++;
+
+    shnfInstance_l.pBusyEntry_m = (tRxQueueEntry *)NULL;
+    shnfInstance_l.ssdoRxStatus_m = kSsdoRxStatusReady;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Returns the length of a frame by it's payload length
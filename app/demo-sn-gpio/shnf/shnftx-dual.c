@@ -91,14 +91,66 @@ demos. It prepares the frames for transmission to the underlying fieldbus.
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * \brief States of a transmit slot
+ */
+typedef enum
+{
+    kTxSlotFree         = 0x0,      /**< Slot is free */
+    kTxSlotFilling      = 0x1,      /**< Memory block is handed to the stack */
+    kTxSlotReady        = 0x2,      /**< Frame is built and waits for posting */
+} tTxSlotState;
+
+/**
+ * \brief Subframe layout of a frame in the memory block
+ */
+typedef struct
+{
+    UINT16 frameLen_m;      /**< Length of the frame the layout is calculated for */
+    BOOLEAN fIsSlim_m;      /**< TRUE if the layout is calculated for an SSDO slim frame */
+    UINT16 crcSub1Pos_m;    /**< Offset of the CRC of subframe one */
+    UINT16 crcSub2Pos_m;    /**< Offset of the CRC of subframe two */
+    UINT16 sub1Pos_m;       /**< Offset of subframe one in the memory block */
+    UINT16 sub1Len_m;       /**< Length of subframe one */
+    UINT16 sub2Len_m;       /**< Length of subframe two (Starts at the memory block) */
+} tTxLayout;
+
+/**
+ * \brief Transmit channel with the memory block of the stack
+ */
+typedef struct
+{
+    tTxSlotState state_m;                       /**< State of the slot (SPDO only) */
+    tTxLayout layout_m;                         /**< Layout of the current frame */
+    UINT8 * pMemBlock_m;                        /**< Memory block handed to the stack */
+    UINT8 memBlock_m[SSC_k_MAX_TEL_LEN_LONG];   /**< Local memory block for frames which are not placed */
+} tTxChannel;
+
+/**
+ * \brief SHNF transmit instance type
+ *
+ * The cross communication image carries one SPDO per cycle, therefore the
+ * SPDO pool of the dual channeled demos has a single slot.
+ */
+typedef struct
+{
+    tTxChannel spdo_m;                  /**< SPDO transmit slot */
+    tTxChannel ssdoSnmt_m;              /**< SSDO/SNMT transmit channel */
+    UINT16 spdoBuiltCnt_m;              /**< SPDO frames marked since the last posting */
+    tShnfTxStatistics stat_m;           /**< SPDO transmit statistics */
+} tShnfTxInstance;
+
 /*----------------------------------------------------------------------------*/
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
+static tShnfTxInstance shnfTxInstance_l SAFE_INIT_SEKTOR;
 
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN getFrameDetails(UINT8 * pPayBase_p, UINT32 payLen_p, BOOLEAN isSlim_p,
+static void updateLayout(tTxLayout * pLayout_p, UINT16 frameLen_p,
+                         BOOLEAN isSlim_p);
+static BOOLEAN getFrameDetails(tTxChannel * pChannel_p,
                                UINT16 *pCrcSub1_p, UINT16 *pCrcSub2_p,
                                tSubFrameParams * pSub1Param_p, tSubFrameParams * pSub2Param_p);
 
@@ -108,21 +160,121 @@ static BOOLEAN getFrameDetails(UINT8 * pPayBase_p, UINT32 payLen_p, BOOLEAN isSl
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Post the SPDO transmit frame to the HNF
+\brief    Initialize the SHNF transmit module
+*/
+/*----------------------------------------------------------------------------*/
+void shnftx_init(void)
+{
+    MEMSET(&shnfTxInstance_l, 0, sizeof(tShnfTxInstance));
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the number of free SPDO slots
 
-\param[in] pSrcBase_p   Pointer to the source buffer
-\param[in] srcLen_p     The length of the source buffer
-\param[in] pDstBase_p   Pointer to the destination buffer
-\param[in] dstLen_p     The length of the destination buffer
+\return Number of SPDO frames the stack can build in this cycle
+*/
+/*----------------------------------------------------------------------------*/
+UINT16 shnftx_getFreeSpdoSlots(void)
+{
+    UINT16 freeSlots = 0;
+
+    if(shnfTxInstance_l.spdo_m.state_m == kTxSlotFree)
+    {
+        freeSlots = 1;
+    }
+
+    return freeSlots;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the memory block for an SPDO frame
+
+If the cross communication is able to place the frame in its transmit image
+the stack writes subframe two directly to the transmit image. Otherwise the
+local memory block of the channel is used.
+
+\param[in] frameLen_p   The length of the frame
+
+\return Pointer to the memory block; NULL on error
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * shnftx_getSpdoMemBlock(UINT16 frameLen_p)
+{
+    tTxChannel * pChannel = &shnfTxInstance_l.spdo_m;
+    UINT8 * pMemBlock = (UINT8 *)NULL;
+
+    if(frameLen_p > 0 && frameLen_p <= SSC_k_MAX_TEL_LEN_LONG)
+    {
+        if(pChannel->state_m == kTxSlotFree)
+        {
+            updateLayout(&pChannel->layout_m, frameLen_p, FALSE);
+
+            pChannel->pMemBlock_m = xcom_getSpdoMemBlock(frameLen_p,
+                                                         pChannel->layout_m.sub2Len_m);
+            if(pChannel->pMemBlock_m == NULL)
+            {
+                pChannel->pMemBlock_m = pChannel->memBlock_m;
+            }
+
+            pChannel->state_m = kTxSlotFilling;
+            pMemBlock = pChannel->pMemBlock_m;
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceShnf, kErrorInvalidTxMemory, 0);
+        }
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceShnf, kErrorInvalidParameter, 0);
+    }
+
+    return pMemBlock;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Mark an SPDO memory block as ready for transmission
+
+\param[in] pMemBlock_p  Pointer to the memory block filled by the stack
+
+\retval TRUE    The block is the filled SPDO slot
+\retval FALSE   The block is no SPDO memory block
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN shnftx_markSpdoFrame(const UINT8 * pMemBlock_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(pMemBlock_p == shnfTxInstance_l.spdo_m.pMemBlock_m &&
+       shnfTxInstance_l.spdo_m.state_m == kTxSlotFilling    )
+    {
+        shnfTxInstance_l.spdo_m.state_m = kTxSlotReady;
+        shnfTxInstance_l.spdoBuiltCnt_m++;
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Post the built SPDO frame to the cross communication
 
 \retval TRUE    Successfully processed the transmit frame
 \retval FALSE   Error on posting the frame
 */
 /*----------------------------------------------------------------------------*/
-BOOLEAN shnftx_postSpdoFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
-                             UINT8 * pDstBase_p, UINT32 dstLen_p)
+BOOLEAN shnftx_postSpdoFrames(void)
 {
     BOOLEAN fReturn = FALSE;
+    tTxChannel * pChannel = &shnfTxInstance_l.spdo_m;
+    tShnfTxStatistics * pStat = &shnfTxInstance_l.stat_m;
+    UINT8 * pTargBuffer = (UINT8 *)NULL;
+    UINT16 targBuffLen = 0;
     UINT16 crcSub1 = 0;
     UINT16 crcSub2 = 0;
     tSubFrameParams sub1Params;
@@ -131,12 +283,22 @@ BOOLEAN shnftx_postSpdoFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
     MEMSET(&sub1Params, 0, sizeof(tSubFrameParams));
     MEMSET(&sub2Params, 0, sizeof(tSubFrameParams));
 
-    if(pSrcBase_p != NULL && srcLen_p > 0 &&
-       pDstBase_p != NULL && dstLen_p > 0  )
+    pStat->spdoBuilt_m = shnfTxInstance_l.spdoBuiltCnt_m;
+    pStat->spdoPacked_m = 0;
+    pStat->spdoDeferred_m = 0;
+
+    shnfTxInstance_l.spdoBuiltCnt_m = 0;
+
+    if(pChannel->state_m != kTxSlotReady)
+    {
+        /* No frame to transmit in this cycle (A block not marked is dropped) */
+        pChannel->state_m = kTxSlotFree;
+        fReturn = TRUE;
+    }
+    else if(hnf_getSyncTxBuffer(&pTargBuffer, &targBuffLen))
     {
         /* Get the CRC values from the frame */
-        if(getFrameDetails(pSrcBase_p, srcLen_p, FALSE,
-                           &crcSub1, &crcSub2,
+        if(getFrameDetails(pChannel, &crcSub1, &crcSub2,
                            &sub1Params, &sub2Params))
         {
             /* Forward the CRC values to the xcom module */
@@ -144,37 +306,83 @@ BOOLEAN shnftx_postSpdoFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
 
             /* Forward the frame to the xcom module */
             if(xcom_postSpdoFrame(&sub1Params, &sub2Params,
-                                  pDstBase_p, dstLen_p))
+                                  pTargBuffer, targBuffLen))
             {
+                pStat->spdoPacked_m = 1;
+                pStat->spdoPackedMax_m = 1;
+
                 fReturn = TRUE;
             }
         }
+
+        pChannel->state_m = kTxSlotFree;
     }
     else
     {
-        errh_postFatalError(kErrSourceShnf, kErrorInvalidParameter, 0);
+        pChannel->state_m = kTxSlotFree;
+        errh_postFatalError(kErrSourceShnf, kErrorSyncFrameNoBuffer, 0);
     }
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the SPDO transmit pool
+
+\param[out] pStat_p     Pointer to the resulting statistics
+*/
+/*----------------------------------------------------------------------------*/
+void shnftx_getStatistics(tShnfTxStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &shnfTxInstance_l.stat_m, sizeof(tShnfTxStatistics));
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the memory block for an SSDO/SNMT frame
+
+\param[in] frameLen_p   The length of the frame
+\param[in] isSlim_p     TRUE if the frame is a slim frame
+
+\return Pointer to the memory block; NULL on error
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * shnftx_getSsdoSnmtMemBlock(UINT16 frameLen_p, BOOLEAN isSlim_p)
+{
+    tTxChannel * pChannel = &shnfTxInstance_l.ssdoSnmt_m;
+
+    pChannel->pMemBlock_m = (UINT8 *)NULL;
+
+    if(frameLen_p > 0 && frameLen_p <= SSC_k_MAX_TEL_LEN_LONG)
+    {
+        updateLayout(&pChannel->layout_m, frameLen_p, isSlim_p);
+
+        pChannel->pMemBlock_m = pChannel->memBlock_m;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceShnf, kErrorInvalidParameter, 0);
+    }
+
+    return pChannel->pMemBlock_m;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Post the SSDO/SNMT transmit frame to the HNF
 
-\param[in] pSrcBase_p   Pointer to the source buffer
-\param[in] srcLen_p     The length of the source buffer
 \param[in] pDstBase_p   Pointer to the destination buffer
 \param[in] dstLen_p     The length of the destination buffer
-\param[in] isSlim_p     TRUE if the frame is a slim frame
 
 \retval TRUE    Successfully processed the transmit frame
 \retval FALSE   Error on posting the frame
 */
 /*----------------------------------------------------------------------------*/
-BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
-                                 UINT8 * pDstBase_p, UINT32 dstLen_p,
-                                 BOOLEAN isSlim_p)
+BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pDstBase_p, UINT32 dstLen_p)
 {
     BOOLEAN fReturn = FALSE;
     UINT16 crcSub1 = 0;
@@ -182,16 +390,13 @@ BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
     tSubFrameParams sub1Params;
     tSubFrameParams sub2Params;
 
-    UNUSED_PARAMETER(dstLen_p);
-
     MEMSET(&sub1Params, 0, sizeof(tSubFrameParams));
     MEMSET(&sub2Params, 0, sizeof(tSubFrameParams));
 
-    if(pSrcBase_p != NULL && srcLen_p > 0 &&
-       pDstBase_p != NULL && dstLen_p > 0  )
+    if(pDstBase_p != NULL && dstLen_p > 0  )
     {
         /* Get the CRC values from the frame */
-        if(getFrameDetails(pSrcBase_p, srcLen_p, isSlim_p,
+        if(getFrameDetails(&shnfTxInstance_l.ssdoSnmt_m,
                            &crcSub1, &crcSub2,
                            &sub1Params, &sub2Params))
         {
@@ -199,8 +404,8 @@ BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
             xcom_setSsdoSnmtCrc(crcSub1, crcSub2);
 
             /* Forward the frame to the xcom module */
-            if(xcom_postSsdoSnmtFrame(&sub1Params, &sub2Params,
-                                      pDstBase_p, srcLen_p))
+            if(xcom_postSsdoSnmtFrame(&sub1Params, &sub2Params, pDstBase_p,
+                                      shnfTxInstance_l.ssdoSnmt_m.layout_m.frameLen_m))
             {
                 fReturn = TRUE;
             }
@@ -242,79 +447,106 @@ BOOLEAN shnftx_process(void)
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Get the CRC values of subframe one and two from the payload
+\brief    Update the subframe layout of a channel
 
-\param[in] pPayBase_p       The base address of the frame
-\param[in] payLen_p         The length of the frame
-\param[in] isSlim_p         Is the frame slim
-\param[out] pCrcSub1_p      The result CRC value of subframe one
-\param[out] pCrcSub2_p      The result CRC value of subframe two
-\param[out] pSub1Param_p    Pointer to the subframe one parameters
-\param[out] pSub2Param_p    Pointer to the subframe two parameters
+The stack uses the same frame length for all frames of a channel in most
+cases. The layout is therefore only calculated if the frame changes.
 
-\return TRUE on success; FALSE on error
+\param[in] pLayout_p    Pointer to the layout of the channel
+\param[in] frameLen_p   The length of the frame
+\param[in] isSlim_p     Is the frame slim
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN getFrameDetails(UINT8 * pPayBase_p, UINT32 payLen_p, BOOLEAN isSlim_p,
-                               UINT16 *pCrcSub1_p, UINT16 *pCrcSub2_p,
-                               tSubFrameParams * pSub1Param_p, tSubFrameParams * pSub2Param_p)
+static void updateLayout(tTxLayout * pLayout_p, UINT16 frameLen_p,
+                         BOOLEAN isSlim_p)
 {
-    BOOLEAN fReturn = FALSE;
-
-    if(pCrcSub1_p != NULL && pCrcSub2_p != NULL    &&
-       pSub1Param_p != NULL && pSub2Param_p != NULL )
+    if(pLayout_p->frameLen_m != frameLen_p ||
+       pLayout_p->fIsSlim_m != isSlim_p     )
     {
         if(isSlim_p)
         {
             /* Payload is a slim frame */
-            if(payLen_p <= SLIM_FRAME_MAX_CRC8_LEN)
+            if(frameLen_p <= SLIM_FRAME_MAX_CRC8_LEN)
             {
                 /* Frame has a CRC8 */
-                *pCrcSub1_p = (UINT8)pPayBase_p[GET_POS_CRC8_SUB_1(payLen_p)];
-                *pCrcSub2_p = (UINT8)pPayBase_p[SLIM_FRAME_SUB1_POS_CRC8 - 1];
-
-                pSub1Param_p->pSubBase_m = &pPayBase_p[SLIM_FRAME_SUB1_POS_CRC8];
-                pSub1Param_p->subLen_m = payLen_p - SLIM_FRAME_SUB1_POS_CRC8;
-
-                pSub2Param_p->pSubBase_m = pPayBase_p;
-                pSub2Param_p->subLen_m = SLIM_FRAME_SUB1_POS_CRC8;
+                pLayout_p->crcSub1Pos_m = GET_POS_CRC8_SUB_1(frameLen_p);
+                pLayout_p->crcSub2Pos_m = SLIM_FRAME_SUB1_POS_CRC8 - 1;
+                pLayout_p->sub1Pos_m = SLIM_FRAME_SUB1_POS_CRC8;
             }
             else
             {
                 /* Frame has a CRC16 */
-                *pCrcSub1_p = (UINT16)pPayBase_p[GET_POS_CRC16_SUB_1(payLen_p)];
-                *pCrcSub2_p = (UINT16)pPayBase_p[SLIM_FRAME_SUB1_POS_CRC16 - 1];
-
-                pSub1Param_p->pSubBase_m = &pPayBase_p[SLIM_FRAME_SUB1_POS_CRC16];
-                pSub1Param_p->subLen_m = payLen_p - SLIM_FRAME_SUB1_POS_CRC16;
-
-                pSub2Param_p->pSubBase_m = pPayBase_p;
-                pSub2Param_p->subLen_m = SLIM_FRAME_SUB1_POS_CRC16;
+                pLayout_p->crcSub1Pos_m = GET_POS_CRC16_SUB_1(frameLen_p);
+                pLayout_p->crcSub2Pos_m = SLIM_FRAME_SUB1_POS_CRC16 - 1;
+                pLayout_p->sub1Pos_m = SLIM_FRAME_SUB1_POS_CRC16;
             }
+
+            pLayout_p->sub1Len_m = frameLen_p - pLayout_p->sub1Pos_m;
+            pLayout_p->sub2Len_m = pLayout_p->sub1Pos_m;
         }
         else
         {
             /* Payload is a normal safety frame */
-            if(payLen_p <= SSC_k_MAX_TEL_LEN_SHORT)
+            if(frameLen_p <= SSC_k_MAX_TEL_LEN_SHORT)
             {
                 /* Frame has a CRC8 */
-                *pCrcSub1_p = (UINT8)pPayBase_p[GET_POS_CRC8_SUB_1(payLen_p)];
-                *pCrcSub2_p = (UINT8)pPayBase_p[GET_POS_CRC8_SUB_2(payLen_p)];
+                pLayout_p->crcSub1Pos_m = GET_POS_CRC8_SUB_1(frameLen_p);
+                pLayout_p->crcSub2Pos_m = GET_POS_CRC8_SUB_2(frameLen_p);
             }
             else
             {
                 /* Frame has a CRC16 */
-                *pCrcSub1_p = (UINT16)pPayBase_p[GET_POS_CRC16_SUB_1(payLen_p)];
-                *pCrcSub2_p = (UINT16)pPayBase_p[GET_POS_CRC16_SUB_2(payLen_p)];
+                pLayout_p->crcSub1Pos_m = GET_POS_CRC16_SUB_1(frameLen_p);
+                pLayout_p->crcSub2Pos_m = GET_POS_CRC16_SUB_2(frameLen_p);
             }
 
-            pSub1Param_p->pSubBase_m = &pPayBase_p[(payLen_p >> 1) + 1];
-            pSub1Param_p->subLen_m = payLen_p >> 1;
-
-            pSub2Param_p->pSubBase_m = pPayBase_p;
-            pSub2Param_p->subLen_m = (payLen_p >> 1) + 1;
+            pLayout_p->sub1Pos_m = (frameLen_p >> 1) + 1;
+            pLayout_p->sub1Len_m = frameLen_p >> 1;
+            pLayout_p->sub2Len_m = (frameLen_p >> 1) + 1;
         }
 
+        pLayout_p->frameLen_m = frameLen_p;
+        pLayout_p->fIsSlim_m = isSlim_p;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the CRC values of subframe one and two from the memory block
+
+The positions are taken from the layout of the channel. The subframe
+parameters point into the memory block, no data is copied.
+
+\param[in] pChannel_p       Pointer to the transmit channel
+\param[out] pCrcSub1_p      The result CRC value of subframe one
+\param[out] pCrcSub2_p      The result CRC value of subframe two
+\param[out] pSub1Param_p    Pointer to the subframe one parameters
+\param[out] pSub2Param_p    Pointer to the subframe two parameters
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN getFrameDetails(tTxChannel * pChannel_p,
+                               UINT16 *pCrcSub1_p, UINT16 *pCrcSub2_p,
+                               tSubFrameParams * pSub1Param_p, tSubFrameParams * pSub2Param_p)
+{
+    BOOLEAN fReturn = FALSE;
+    UINT8 * pMemBlock = pChannel_p->pMemBlock_m;
+    tTxLayout * pLayout = &pChannel_p->layout_m;
+
+    if(pMemBlock != NULL && pLayout->frameLen_m > 0 &&
+       pCrcSub1_p != NULL && pCrcSub2_p != NULL      &&
+       pSub1Param_p != NULL && pSub2Param_p != NULL   )
+    {
+        *pCrcSub1_p = (UINT16)pMemBlock[pLayout->crcSub1Pos_m];
+        *pCrcSub2_p = (UINT16)pMemBlock[pLayout->crcSub2Pos_m];
+
+        pSub1Param_p->pSubBase_m = &pMemBlock[pLayout->sub1Pos_m];
+        pSub1Param_p->subLen_m = pLayout->sub1Len_m;
+
+        pSub2Param_p->pSubBase_m = pMemBlock;
+        pSub2Param_p->subLen_m = pLayout->sub2Len_m;
+
         fReturn = TRUE;
     }
     else
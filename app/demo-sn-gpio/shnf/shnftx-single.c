@@ -53,6 +53,8 @@ demos. It prepares the frames for transmission to the underlying fieldbus.
 
 #include <shnf/hnf.h>
 
+#include <SSCapi.h>
+
 /*============================================================================*/
 /*            G L O B A L   D E F I N I T I O N S                             */
 /*============================================================================*/
@@ -76,21 +78,73 @@ demos. It prepares the frames for transmission to the underlying fieldbus.
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
+#ifndef SHNFTX_SPDO_SLOT_COUNT
+  #define SHNFTX_SPDO_SLOT_COUNT    (SPDO_cfg_MAX_NO_TX_SPDO + 1)   /**< Number of SPDO slots (One more for time request/response frames) */
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
 
+/**
+ * \brief States of a transmit slot
+ */
+typedef enum
+{
+    kTxSlotFree         = 0x0,      /**< Slot is free */
+    kTxSlotFilling      = 0x1,      /**< Memory block is handed to the stack */
+    kTxSlotReady        = 0x2,      /**< Frame is built and waits for packing */
+    kTxSlotDeferred     = 0x3,      /**< Frame did not fit into the last transmit image */
+} tTxSlotState;
+
+/**
+ * \brief Subframe layout of a frame in the memory block
+ */
+typedef struct
+{
+    UINT16 frameLen_m;      /**< Length of the frame the layout is calculated for */
+    BOOLEAN fIsSlim_m;      /**< TRUE if the layout is calculated for an SSDO slim frame */
+    UINT16 sub1Pos_m;       /**< Offset of subframe one in the memory block */
+    UINT16 sub1Len_m;       /**< Length of subframe one */
+    UINT16 sub2Len_m;       /**< Length of subframe two */
+    UINT16 sub2Targ_m;      /**< Offset of subframe two in the target buffer */
+} tTxLayout;
+
+/**
+ * \brief Transmit channel with the memory block of the stack
+ */
+typedef struct
+{
+    tTxSlotState state_m;                       /**< State of the slot (SPDO slots only) */
+    tTxLayout layout_m;                         /**< Layout of the current frame */
+    UINT8 memBlock_m[SSC_k_MAX_TEL_LEN_LONG];   /**< Memory block filled by the stack */
+} tTxChannel;
+
+/**
+ * \brief SHNF transmit instance type
+ */
+typedef struct
+{
+    tTxChannel spdo_m[SHNFTX_SPDO_SLOT_COUNT];  /**< Pool of SPDO transmit slots */
+    tTxChannel ssdoSnmt_m;                      /**< SSDO/SNMT transmit channel */
+    UINT16 spdoBuiltCnt_m;                      /**< SPDO frames marked since the last packing */
+    tShnfTxStatistics stat_m;                   /**< SPDO transmit statistics */
+} tShnfTxInstance;
+
 /*----------------------------------------------------------------------------*/
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
+static tShnfTxInstance shnfTxInstance_l SAFE_INIT_SEKTOR;
 
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
+static void updateLayout(tTxLayout * pLayout_p, UINT16 frameLen_p,
+                         BOOLEAN fIsSlim_p);
 static BOOLEAN swapSubFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
-                             UINT8 * pSrcBuffer_p, UINT16 srcBuffLen_p,
-                             BOOLEAN fIsSlim_p);
+                             tTxChannel * pChannel_p);
+static UINT16 packSpdoFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
+                             UINT16 * pPackedLen_p, tTxSlotState state_p);
 
 /*============================================================================*/
 /*            P U B L I C   F U N C T I O N S                                 */
@@ -98,30 +152,174 @@ static BOOLEAN swapSubFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
 
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Post the SPDO transmit frame to the HNF
+\brief    Initialize the SHNF transmit module
+*/
+/*----------------------------------------------------------------------------*/
+void shnftx_init(void)
+{
+    MEMSET(&shnfTxInstance_l, 0, sizeof(tShnfTxInstance));
+}
 
-\param[in] pSrcBase_p   Pointer to the source buffer
-\param[in] srcLen_p     The length of the source buffer
-\param[in] pDstBase_p   Pointer to the destination buffer
-\param[in] dstLen_p     The length of the destination buffer
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the number of free SPDO slots
 
-\retval TRUE    Successfully processed the transmit frame
-\retval FALSE   Error on posting the frame
+\return Number of SPDO frames the stack can build in this cycle
+*/
+/*----------------------------------------------------------------------------*/
+UINT16 shnftx_getFreeSpdoSlots(void)
+{
+    UINT16 freeSlots = 0;
+    UINT16 i;
+
+    for(i = 0; i < SHNFTX_SPDO_SLOT_COUNT; i++)
+    {
+        if(shnfTxInstance_l.spdo_m[i].state_m == kTxSlotFree)
+        {
+            freeSlots++;
+        }
+    }
+
+    return freeSlots;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the memory block for an SPDO frame
+
+\param[in] frameLen_p   The length of the frame
+
+\return Pointer to the memory block of a free slot; NULL on error
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * shnftx_getSpdoMemBlock(UINT16 frameLen_p)
+{
+    UINT8 * pMemBlock = (UINT8 *)NULL;
+    tTxChannel * pSlot = (tTxChannel *)NULL;
+    UINT16 i;
+
+    if(frameLen_p > 0 && frameLen_p <= SSC_k_MAX_TEL_LEN_LONG)
+    {
+        for(i = 0; i < SHNFTX_SPDO_SLOT_COUNT && pSlot == NULL; i++)
+        {
+            if(shnfTxInstance_l.spdo_m[i].state_m == kTxSlotFree)
+            {
+                pSlot = &shnfTxInstance_l.spdo_m[i];
+            }
+        }
+
+        if(pSlot != NULL)
+        {
+            updateLayout(&pSlot->layout_m, frameLen_p, FALSE);
+
+            pSlot->state_m = kTxSlotFilling;
+            pMemBlock = pSlot->memBlock_m;
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceShnf, kErrorInvalidTxMemory, 0);
+        }
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceShnf, kErrorInvalidParameter, 0);
+    }
+
+    return pMemBlock;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Mark an SPDO memory block as ready for transmission
+
+\param[in] pMemBlock_p  Pointer to the memory block filled by the stack
+
+\retval TRUE    The block is a filled SPDO slot
+\retval FALSE   The block is no SPDO memory block
 */
 /*----------------------------------------------------------------------------*/
-BOOLEAN shnftx_postSpdoFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
-                             UINT8 * pDstBase_p, UINT32 dstLen_p)
+BOOLEAN shnftx_markSpdoFrame(const UINT8 * pMemBlock_p)
 {
     BOOLEAN fReturn = FALSE;
+    UINT16 i;
 
-    if(pSrcBase_p != NULL && srcLen_p > 0 &&
-       pDstBase_p != NULL && dstLen_p > 0  )
+    for(i = 0; i < SHNFTX_SPDO_SLOT_COUNT && fReturn == FALSE; i++)
     {
-        /* Prepare synchronous target buffer and swap frame */
-        if(swapSubFrames(pDstBase_p, dstLen_p, pSrcBase_p, srcLen_p, FALSE))
+        if(pMemBlock_p == shnfTxInstance_l.spdo_m[i].memBlock_m &&
+           shnfTxInstance_l.spdo_m[i].state_m == kTxSlotFilling   )
         {
+            shnfTxInstance_l.spdo_m[i].state_m = kTxSlotReady;
+            shnfTxInstance_l.spdoBuiltCnt_m++;
+
+            fReturn = TRUE;
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Pack all built SPDO frames into the transmit image
+
+The frames deferred in the last cycle are packed first. All frames which do
+not fit into the remaining space of the transmit image are deferred to the
+next cycle. Their slots stay occupied and reduce the number of frames the
+stack builds in the next cycle.
+
+\retval TRUE    Successfully processed the transmit frames
+\retval FALSE   Error on posting the frames
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN shnftx_postSpdoFrames(void)
+{
+    BOOLEAN fReturn = FALSE;
+    tShnfTxStatistics * pStat = &shnfTxInstance_l.stat_m;
+    UINT8 * pTargBuffer = (UINT8 *)NULL;
+    UINT16 targBuffLen = 0;
+    UINT16 packedLen = 0;
+    UINT16 pendingFrames = 0;
+    UINT16 i;
+
+    pStat->spdoBuilt_m = shnfTxInstance_l.spdoBuiltCnt_m;
+    pStat->spdoPacked_m = 0;
+    pStat->spdoDeferred_m = 0;
+
+    shnfTxInstance_l.spdoBuiltCnt_m = 0;
+
+    for(i = 0; i < SHNFTX_SPDO_SLOT_COUNT; i++)
+    {
+        /* A block not marked by the stack is not transmitted */
+        if(shnfTxInstance_l.spdo_m[i].state_m == kTxSlotFilling)
+        {
+            shnfTxInstance_l.spdo_m[i].state_m = kTxSlotFree;
+        }
+        else if(shnfTxInstance_l.spdo_m[i].state_m != kTxSlotFree)
+        {
+            pendingFrames++;
+        }
+    }
+
+    if(pendingFrames == 0)
+    {
+        /* No frame to transmit in this cycle */
+        fReturn = TRUE;
+    }
+    else if(hnf_getSyncTxBuffer(&pTargBuffer, &targBuffLen))
+    {
+        /* Oldest frames first, then the frames of this cycle */
+        pStat->spdoPacked_m = packSpdoFrames(pTargBuffer, targBuffLen,
+                                             &packedLen, kTxSlotDeferred);
+        pStat->spdoPacked_m += packSpdoFrames(pTargBuffer, targBuffLen,
+                                              &packedLen, kTxSlotReady);
+
+        if(pStat->spdoPacked_m > 0)
+        {
+            /* Clear the rest of the image to avoid resending old frames */
+            MEMSET(&pTargBuffer[packedLen], 0, targBuffLen - packedLen);
+
             /* Forward filled buffer to HNF */
-            if(hnf_postSyncTx(pDstBase_p, dstLen_p))
+            if(hnf_postSyncTx(pTargBuffer, targBuffLen))
             {
                 fReturn = TRUE;
             }
@@ -129,48 +327,97 @@ BOOLEAN shnftx_postSpdoFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
             {
                 errh_postFatalError(kErrSourceShnf, kErrorSyncFramePostingFailed, 0);
             }
+        } /* no else: Error is posted in packSpdoFrames() */
+
+        /* Remaining frames are transmitted in the next cycle */
+        for(i = 0; i < SHNFTX_SPDO_SLOT_COUNT; i++)
+        {
+            if(shnfTxInstance_l.spdo_m[i].state_m == kTxSlotDeferred)
+            {
+                pStat->spdoDeferred_m++;
+            }
         }
-        else
+
+        pStat->spdoDeferredSum_m += pStat->spdoDeferred_m;
+        if(pStat->spdoPacked_m > pStat->spdoPackedMax_m)
         {
-            errh_postFatalError(kErrSourceShnf, kErrorSyncFrameCopyFailed, 0);
+            pStat->spdoPackedMax_m = pStat->spdoPacked_m;
         }
     }
     else
     {
-        errh_postFatalError(kErrSourceShnf, kErrorInvalidParameter, 0);
+        errh_postFatalError(kErrSourceShnf, kErrorSyncFrameNoBuffer, 0);
     }
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the SPDO transmit pool
+
+\param[out] pStat_p     Pointer to the resulting statistics
+*/
+/*----------------------------------------------------------------------------*/
+void shnftx_getStatistics(tShnfTxStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &shnfTxInstance_l.stat_m, sizeof(tShnfTxStatistics));
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the memory block for an SSDO/SNMT frame
+
+\param[in] frameLen_p   The length of the frame
+\param[in] isSlim_p     TRUE if the frame is a slim frame
+
+\return Pointer to the memory block; NULL on error
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * shnftx_getSsdoSnmtMemBlock(UINT16 frameLen_p, BOOLEAN isSlim_p)
+{
+    UINT8 * pMemBlock = (UINT8 *)NULL;
+
+    if(frameLen_p > 0 && frameLen_p <= SSC_k_MAX_TEL_LEN_LONG)
+    {
+        updateLayout(&shnfTxInstance_l.ssdoSnmt_m.layout_m, frameLen_p, isSlim_p);
+
+        pMemBlock = shnfTxInstance_l.ssdoSnmt_m.memBlock_m;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceShnf, kErrorInvalidParameter, 0);
+    }
+
+    return pMemBlock;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Post the SSDO/SNMT transmit frame to the HNF
 
-\param[in] pSrcBase_p   Pointer to the source buffer
-\param[in] srcLen_p     The length of the source buffer
 \param[in] pDstBase_p   Pointer to the destination buffer
 \param[in] dstLen_p     The length of the destination buffer
-\param[in] isSlim_p     TRUE if the frame is a slim frame
 
 \retval TRUE    Successfully processed the transmit frame
 \retval FALSE   Error on posting the frame
 */
 /*----------------------------------------------------------------------------*/
-BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pSrcBase_p, UINT32 srcLen_p,
-                                 UINT8 * pDstBase_p, UINT32 dstLen_p,
-                                 BOOLEAN isSlim_p)
+BOOLEAN shnftx_postSsdoSnmtFrame(UINT8 * pDstBase_p, UINT32 dstLen_p)
 {
     BOOLEAN fReturn = FALSE;
 
-    if(pSrcBase_p != NULL && srcLen_p > 0 &&
-       pDstBase_p != NULL && dstLen_p > 0  )
+    if(pDstBase_p != NULL && dstLen_p > 0  )
     {
         /* Prepare asynchronous target buffer and swap frame */
-        if(swapSubFrames(pDstBase_p, dstLen_p, pSrcBase_p, srcLen_p, isSlim_p))
+        if(swapSubFrames(pDstBase_p, dstLen_p, &shnfTxInstance_l.ssdoSnmt_m))
         {
             /* Post transmit frame to hnf */
-            if(hnf_postAsyncTxChannel0(pDstBase_p, srcLen_p))
+            if(hnf_postAsyncTxChannel0(pDstBase_p,
+                                       shnfTxInstance_l.ssdoSnmt_m.layout_m.frameLen_m))
             {
                 fReturn = TRUE;
             }
@@ -213,61 +460,79 @@ BOOLEAN shnftx_process(void)
 /** \name Private Functions */
 /** \{ */
 
-
 /*----------------------------------------------------------------------------*/
 /**
-\brief    Swap sub1 and sub2 for transmission
+\brief    Update the subframe layout of a channel
 
-This function swaps subframe1 and subframe2 and provides the result in the
-target buffer.
+The stack uses the same frame length for all frames of a channel in most
+cases. The layout is therefore only calculated if the frame changes.
 
-\param pTargBuffer_p   Pointer to the target buffer
-\param targBuffLen_p   Length of the target buffer
-\param pSrcBuffer_p    Pointer to the source frame
-\param srcBuffLen_p    Length of the frame
+\param pLayout_p       Pointer to the layout of the channel
+\param frameLen_p      Length of the frame
 \param fIsSlim_p       TRUE if the frame is an SSDO slim frame
-
-\return TRUE if the target buffer is valid; FALSE otherwise
 */
 /*----------------------------------------------------------------------------*/
-static BOOLEAN swapSubFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
-                             UINT8 * pSrcBuffer_p, UINT16 srcBuffLen_p,
-                             BOOLEAN fIsSlim_p)
+static void updateLayout(tTxLayout * pLayout_p, UINT16 frameLen_p,
+                         BOOLEAN fIsSlim_p)
 {
-    BOOLEAN fReturn = FALSE;
-    UINT16 subFrame1Pos = 0;
-    UINT16 subFrame2Targ = 0;
-    UINT16 subFrame1Len = 0;
-    UINT16 subFrame2Len = 0;
-
-    /* Check if frame fits into target buffer */
-    if(srcBuffLen_p <= targBuffLen_p)
+    if(pLayout_p->frameLen_m != frameLen_p ||
+       pLayout_p->fIsSlim_m != fIsSlim_p    )
     {
         if(fIsSlim_p)
         {
             /* Calculate frame positions and lengths for slim frames */
-            if(srcBuffLen_p <= SLIM_FRAME_MAX_CRC8_LEN)
-                subFrame1Pos = SLIM_FRAME_SUB1_POS_CRC8;
+            if(frameLen_p <= SLIM_FRAME_MAX_CRC8_LEN)
+                pLayout_p->sub1Pos_m = SLIM_FRAME_SUB1_POS_CRC8;
             else
-                subFrame1Pos = SLIM_FRAME_SUB1_POS_CRC16;
+                pLayout_p->sub1Pos_m = SLIM_FRAME_SUB1_POS_CRC16;
 
-            subFrame2Targ = srcBuffLen_p - subFrame1Pos;
+            pLayout_p->sub2Targ_m = frameLen_p - pLayout_p->sub1Pos_m;
         }
         else
         {
             /* Calculate frame positions and lengths for normal frames */
-            subFrame1Pos = (srcBuffLen_p>>1) + 1;
-            subFrame2Targ = subFrame1Pos - 1;
+            pLayout_p->sub1Pos_m = (frameLen_p>>1) + 1;
+            pLayout_p->sub2Targ_m = pLayout_p->sub1Pos_m - 1;
         }
 
         /* Get length of sub frames */
-        subFrame1Len = srcBuffLen_p - subFrame1Pos;
-        subFrame2Len = srcBuffLen_p - subFrame1Len;
+        pLayout_p->sub1Len_m = frameLen_p - pLayout_p->sub1Pos_m;
+        pLayout_p->sub2Len_m = frameLen_p - pLayout_p->sub1Len_m;
+
+        pLayout_p->frameLen_m = frameLen_p;
+        pLayout_p->fIsSlim_m = fIsSlim_p;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Swap sub1 and sub2 for transmission
+
+This function swaps subframe1 and subframe2 of the memory block with the
+offsets of the channel layout and provides the result in the target buffer.
+
+\param pTargBuffer_p   Pointer to the target buffer
+\param targBuffLen_p   Length of the target buffer
+\param pChannel_p      Pointer to the transmit channel
+
+\return TRUE if the target buffer is valid; FALSE otherwise
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN swapSubFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
+                             tTxChannel * pChannel_p)
+{
+    BOOLEAN fReturn = FALSE;
+    tTxLayout * pLayout = &pChannel_p->layout_m;
 
+    /* Check if frame fits into target buffer */
+    if(pLayout->frameLen_m > 0 && pLayout->frameLen_m <= targBuffLen_p)
+    {
         /* Copy subframe1 to start of target buffer */
-        MEMCOPY(pTargBuffer_p, &pSrcBuffer_p[subFrame1Pos], subFrame1Len);
+        MEMCOPY(pTargBuffer_p, &pChannel_p->memBlock_m[pLayout->sub1Pos_m],
+                pLayout->sub1Len_m);
         /* Add subframe2 to end of subframe1 */
-        MEMCOPY(&pTargBuffer_p[subFrame2Targ], pSrcBuffer_p, subFrame2Len);
+        MEMCOPY(&pTargBuffer_p[pLayout->sub2Targ_m], pChannel_p->memBlock_m,
+                pLayout->sub2Len_m);
 
         fReturn = TRUE;
     }
@@ -275,6 +540,57 @@ static BOOLEAN swapSubFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Pack the SPDO frames of one slot state into the target buffer
+
+Each frame is swapped to the end of the already packed frames. Frames which
+do not fit into the remaining space are marked as deferred.
+
+\param pTargBuffer_p   Pointer to the target buffer
+\param targBuffLen_p   Length of the target buffer
+\param pPackedLen_p    Length of the packed frames (Updated)
+\param state_p         State of the slots to pack
+
+\return Number of packed frames
+*/
+/*----------------------------------------------------------------------------*/
+static UINT16 packSpdoFrames(UINT8 * pTargBuffer_p, UINT16 targBuffLen_p,
+                             UINT16 * pPackedLen_p, tTxSlotState state_p)
+{
+    UINT16 packedFrames = 0;
+    tTxChannel * pSlot;
+    UINT16 i;
+
+    for(i = 0; i < SHNFTX_SPDO_SLOT_COUNT; i++)
+    {
+        pSlot = &shnfTxInstance_l.spdo_m[i];
+
+        if(pSlot->state_m == state_p)
+        {
+            if(pSlot->layout_m.frameLen_m > targBuffLen_p)
+            {
+                /* Frame does not even fit into the empty image -> Drop it */
+                pSlot->state_m = kTxSlotFree;
+                errh_postFatalError(kErrSourceShnf, kErrorSyncFrameCopyFailed, 0);
+            }
+            else if(swapSubFrames(&pTargBuffer_p[*pPackedLen_p],
+                                  targBuffLen_p - *pPackedLen_p, pSlot))
+            {
+                *pPackedLen_p += pSlot->layout_m.frameLen_m;
+                pSlot->state_m = kTxSlotFree;
+                packedFrames++;
+            }
+            else
+            {
+                pSlot->state_m = kTxSlotDeferred;
+            }
+        }
+    }
+
+    return packedFrames;
+}
+
 /**
  * \}
  * \}
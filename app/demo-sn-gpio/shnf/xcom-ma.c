@@ -116,6 +116,9 @@ typedef struct
 /*----------------------------------------------------------------------------*/
 static tXComIntInstance xcomIntInstance_l SAFE_INIT_SEKTOR;
 
+static const tXComImgSection txLayout_l[XCOM_IMG_SECTION_COUNT] = XCOM_MASL_LAYOUT;   /**< Sections of the transmit image */
+static const tXComImgSection rxLayout_l[XCOM_IMG_SECTION_COUNT] = XCOM_SLMA_LAYOUT;   /**< Sections of the receive image */
+
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
@@ -148,6 +151,8 @@ BOOLEAN xcomint_init(tXComTransParams * pTransParam_p)
         pTransParam_p->txImgSize_m = sizeof(tXComMaSlImage);
         pTransParam_p->pRxImg_m = (UINT8 *)&xcomIntInstance_l.rcvImg_m;
         pTransParam_p->rxImgSize_m = sizeof(tXComSlMaImage);
+        pTransParam_p->pTxLayout_m = txLayout_l;
+        pTransParam_p->pRxLayout_m = rxLayout_l;
 
         fReturn = TRUE;
     }
@@ -477,6 +482,27 @@ BOOLEAN xcomint_handleSsdoSnmtPayload(void)
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get a memory block for the SPDO which is placed in the transmit image
+
+The uP-Master transmits only the CRC values of the SPDO. Subframe one is
+needed locally to assemble the frame, therefore the frame is not placed.
+
+\param[in] frameLen_p  The length of the SPDO frame
+\param[in] sub2Len_p   The length of subframe two
+
+\return Always NULL
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * xcomint_getSpdoMemBlock(UINT32 frameLen_p, UINT32 sub2Len_p)
+{
+    UNUSED_PARAMETER(frameLen_p);
+    UNUSED_PARAMETER(sub2Len_p);
+
+    return (UINT8 *)NULL;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Set the SPDO crc to transmit image
@@ -79,6 +79,7 @@ in the uP-Slave version.
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
+#define SPDO_SUB1_SCRATCH_LEN   TSPDO_SUB2_LEN  /**< Size of the area which takes subframe one of a placed SPDO */
 
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
@@ -89,8 +90,9 @@ in the uP-Slave version.
  */
 typedef struct
 {
-    volatile tXComSlMaImage  transImg_m;         /**< uP-Slave -> uP-Master transmit image */
-    volatile tXComMaSlImage  rcvImg_m;           /**< uP-Master <- uP-Slave receive image */
+    volatile tXComSlMaImage  transImg_m;                                /**< uP-Slave -> uP-Master transmit image */
+    UINT8                    spdoSub1Scratch_m[SPDO_SUB1_SCRATCH_LEN];  /**< Subframe one of a placed SPDO (Directly behind the transmit image) */
+    volatile tXComMaSlImage  rcvImg_m;                                  /**< uP-Master <- uP-Slave receive image */
 } tXComIntInstance;
 
 /*----------------------------------------------------------------------------*/
@@ -98,6 +100,9 @@ typedef struct
 /*----------------------------------------------------------------------------*/
 static tXComIntInstance xcomIntInstance_l SAFE_INIT_SEKTOR;
 
+static const tXComImgSection txLayout_l[XCOM_IMG_SECTION_COUNT] = XCOM_SLMA_LAYOUT;   /**< Sections of the transmit image */
+static const tXComImgSection rxLayout_l[XCOM_IMG_SECTION_COUNT] = XCOM_MASL_LAYOUT;   /**< Sections of the receive image */
+
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
@@ -131,6 +136,8 @@ BOOLEAN xcomint_init(tXComTransParams * pTransParam_p)
         pTransParam_p->txImgSize_m = sizeof(tXComSlMaImage);
         pTransParam_p->pRxImg_m = (UINT8 *)&xcomIntInstance_l.rcvImg_m;
         pTransParam_p->rxImgSize_m = sizeof(tXComMaSlImage);
+        pTransParam_p->pTxLayout_m = txLayout_l;
+        pTransParam_p->pRxLayout_m = rxLayout_l;
 
         fReturn = TRUE;
     }
@@ -422,6 +429,36 @@ BOOLEAN xcomint_handleSsdoSnmtPayload(void)
     return TRUE;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get a memory block for the SPDO which is placed in the transmit image
+
+The block starts at the SPDO payload of the transmit image. The stack writes
+subframe two directly to the payload and subframe one to the scratch area
+behind the image. The uP-Slave only transmits subframe two, therefore no copy
+is needed when the frame is posted.
+
+\param[in] frameLen_p  The length of the SPDO frame
+\param[in] sub2Len_p   The length of subframe two
+
+\return Pointer to the memory block; NULL if the frame does not fit
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * xcomint_getSpdoMemBlock(UINT32 frameLen_p, UINT32 sub2Len_p)
+{
+    UINT8 * pBlock = (UINT8 *)NULL;
+    UINT8 * pPayl = (UINT8 *)&xcomIntInstance_l.transImg_m.spdoSub2Payl_m[0];
+    UINT8 * pEnd = &xcomIntInstance_l.spdoSub1Scratch_m[SPDO_SUB1_SCRATCH_LEN];
+
+    if(sub2Len_p > 0 && sub2Len_p <= TSPDO_SUB2_LEN &&
+       frameLen_p <= (UINT32)(pEnd - pPayl)           )
+    {
+        pBlock = pPayl;
+    }
+
+    return pBlock;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Set the SPDO crc to transmit image
@@ -498,9 +535,13 @@ BOOLEAN xcomint_postSpdoFrame(tSubFrameParams * pSub1Params_p,
            pSub2Params_p->subLen_m > 0              &&
            pSub2Params_p->subLen_m <= TSPDO_SUB2_LEN )
         {
-            /* Copy subframe two data to transmit buffer */
-            MEMCOPY(&xcomIntInstance_l.transImg_m.spdoSub2Payl_m,
-                    pSub2Params_p->pSubBase_m, pSub2Params_p->subLen_m);
+            /* A placed frame is already in the transmit image */
+            if(pSub2Params_p->pSubBase_m != (UINT8 *)&xcomIntInstance_l.transImg_m.spdoSub2Payl_m[0])
+            {
+                /* Copy subframe two data to transmit buffer */
+                MEMCOPY(&xcomIntInstance_l.transImg_m.spdoSub2Payl_m,
+                        pSub2Params_p->pSubBase_m, pSub2Params_p->subLen_m);
+            }
 
             fReturn = TRUE;
         }
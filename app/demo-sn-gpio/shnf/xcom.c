@@ -57,6 +57,8 @@ needed on the uP-Master and uP-Slave processor.
 #include <sn/upserial.h>
 #include <common/benchmark.h>
 
+#include <SFS.h>
+
 /*============================================================================*/
 /*            G L O B A L   D E F I N I T I O N S                             */
 /*============================================================================*/
@@ -85,6 +87,19 @@ needed on the uP-Master and uP-Slave processor.
 
 #define SAMPLE_VALS     100
 
+#ifndef XCOM_PROC_BUDGET_US
+  #define XCOM_PROC_BUDGET_US       100     /**< Time in us the processing of a received frame needs at most */
+#endif
+
+#define XCOM_RX_BUF_COUNT         2       /**< Number of receive buffers */
+#define XCOM_RX_BUF_NONE          0xFF    /**< No receive buffer is pending */
+
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+  #define XCOM_RX_BUF_SIZE        XCOM_FRAME_SIZE_MAX
+#else
+  #define XCOM_RX_BUF_SIZE        sizeof(tXComSlMaImage)
+#endif
+
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
@@ -93,6 +108,17 @@ typedef struct
 {
     tXComTransParams transParams_m;     /**< The cross communication transmit parameters*/
     volatile BOOLEAN fWaitForRcv_m;     /**< This flag ensures that cross communication occurs in each cycle */
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    UINT8 txFrame_m[XCOM_FRAME_SIZE_MAX];           /**< Compact frame of the transmit image */
+#endif
+    volatile UINT8 rxBuf_m[XCOM_RX_BUF_COUNT][XCOM_RX_BUF_SIZE];  /**< Double buffer of the received frames */
+    volatile UINT8 rxActive_m;          /**< Buffer of the running reception */
+    volatile UINT8 rxPending_m;         /**< Received buffer which waits for processing */
+    volatile BOOLEAN fProcActive_m;     /**< The background loop processes the pending buffer */
+    volatile BOOLEAN fProcLate_m;       /**< The pending buffer missed its deadline */
+    UINT64 syncTime_m;                  /**< Time of the last sync interrupt */
+    UINT32 cycleTime_m;                 /**< Time between the last two sync interrupts */
+    tXComStatistics stat_m;             /**< Cross communication traffic statistics */
 } tXComInstance;
 
 /*----------------------------------------------------------------------------*/
@@ -109,6 +135,19 @@ static void transferError(void);
 
 static BOOLEAN serialEnableReceive(void);
 
+static BOOLEAN checkFrame(volatile UINT8 * pFrame_p, UINT32 rcvSize_p);
+static void processPending(BOOLEAN fLate_p);
+static BOOLEAN processFrame(volatile UINT8 * pFrame_p);
+
+static BOOLEAN buildFrame(volatile UINT8 ** ppFrame_p, UINT16 * pFrameLen_p);
+static BOOLEAN readFrame(volatile UINT8 * pFrame_p);
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+static UINT16 getFrameLen(const tXComImgSection * pLayout_p, UINT8 msgFormat_p);
+static void copySections(const tXComImgSection * pLayout_p, UINT8 msgFormat_p,
+                         volatile UINT8 * pImg_p, volatile UINT8 * pFrame_p,
+                         BOOLEAN fToFrame_p);
+#endif
+
 static BOOLEAN verifyTime(void);
 static BOOLEAN verifyFlowCount(void);
 static BOOLEAN verifySpdoCrcs(void);
@@ -138,6 +177,8 @@ BOOLEAN xcom_init(void)
     MEMSET(&xcomInstance_l, 0, sizeof(tXComInstance));
     MEMSET(&transParam, 0, sizeof(tXComTransParams));
 
+    xcomInstance_l.rxPending_m = XCOM_RX_BUF_NONE;
+
     /* Register all upserial callback functions */
     upserial_registerCb(transferFinished, frameReceived, transferError);
 
@@ -186,6 +227,13 @@ BOOLEAN xcom_setCurrentTimebase(UINT64 * p_currTime)
         /* Set the timebase to the internal module */
         xcomint_setTransTimebase(p_currTime);
 
+        /* Remember the sync time for the deadline of the frame processing */
+        if(xcomInstance_l.syncTime_m != 0 && *p_currTime > xcomInstance_l.syncTime_m)
+        {
+            xcomInstance_l.cycleTime_m = (UINT32)(*p_currTime - xcomInstance_l.syncTime_m);
+        }
+        xcomInstance_l.syncTime_m = *p_currTime;
+
         fReturn = TRUE;
     }
     else
@@ -200,6 +248,13 @@ BOOLEAN xcom_setCurrentTimebase(UINT64 * p_currTime)
 /**
 \brief    Enable the cross communication receive check
 
+The frame of the last cycle has to be processed before the new cycle starts.
+This function is called in the sync interrupt and does not process the frame
+itself. If the background loop had no time for the frame the overrun is
+reported and the frame is left to the background loop, which processes it
+without budget check. If the background loop is still busy with the frame the
+deadline is missed.
+
 \return TRUE on success; FALSE on error
 */
 /*----------------------------------------------------------------------------*/
@@ -207,19 +262,73 @@ BOOLEAN xcom_enableReceiveCheck(void)
 {
     BOOLEAN fReturn = FALSE;
 
-    if(xcomInstance_l.fWaitForRcv_m == FALSE)
+    if(xcomInstance_l.fProcActive_m == FALSE)
     {
-        xcomInstance_l.fWaitForRcv_m = TRUE;
-        fReturn = TRUE;
+        if(xcomInstance_l.rxPending_m != XCOM_RX_BUF_NONE)
+        {
+            /* The frame of the last cycle was not processed in time */
+            xcomInstance_l.fProcLate_m = TRUE;
+            errh_postFatalError(kErrSourceXCom, kXComProcessingOverrun, 0);
+        }
+
+        if(xcomInstance_l.fWaitForRcv_m == FALSE)
+        {
+            xcomInstance_l.fWaitForRcv_m = TRUE;
+            fReturn = TRUE;
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceXCom, kXComMissingCrossCommunication, 0);
+        }
     }
     else
     {
-        errh_postFatalError(kErrSourceXCom, kXComMissingCrossCommunication, 0);
+        errh_postFatalError(kErrSourceXCom, kXComProcessDeadlineMissed, 0);
     }
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Process a received cross communication frame
+
+Verifies the frame which was received in this cycle and forwards the
+payload. This function is called in the background loop. The frame is only
+processed if XCOM_PROC_BUDGET_US are left until the next sync interrupt or
+the cycle time is not known yet. A frame which missed its deadline is
+processed right away.
+*/
+/*----------------------------------------------------------------------------*/
+void xcom_process(void)
+{
+    BOOLEAN fClaimed = FALSE;
+
+    if(xcomInstance_l.rxPending_m != XCOM_RX_BUF_NONE)
+    {
+        util_enterCriticalSection(FALSE);
+
+        if(xcomInstance_l.rxPending_m != XCOM_RX_BUF_NONE &&
+           (xcomInstance_l.fProcLate_m != FALSE ||
+            xcomInstance_l.cycleTime_m == 0     ||
+            constime_getTimeBase() + XCOM_PROC_BUDGET_US <
+            xcomInstance_l.syncTime_m + xcomInstance_l.cycleTime_m))
+        {
+            xcomInstance_l.fProcActive_m = TRUE;
+            fClaimed = TRUE;
+        }
+
+        util_enterCriticalSection(TRUE);
+
+        if(fClaimed)
+        {
+            processPending(xcomInstance_l.fProcLate_m);
+
+            xcomInstance_l.fProcActive_m = FALSE;
+        }
+    }
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Set the SSDO/SNMT CRC to transmit image
@@ -290,6 +399,25 @@ BOOLEAN xcom_postSsdoSnmtFrame(tSubFrameParams * pSub1Params_p,
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get a memory block for the SPDO which is placed in the transmit image
+
+The openSAFETY stack writes subframe two at the start of the block. If the
+processor transmits subframe two to the other processor the block is placed
+so that subframe two is already at its position in the transmit image.
+
+\param[in] frameLen_p  The length of the SPDO frame
+\param[in] sub2Len_p   The length of subframe two
+
+\return Pointer to the memory block; NULL if the frame can not be placed
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 * xcom_getSpdoMemBlock(UINT32 frameLen_p, UINT32 sub2Len_p)
+{
+    return xcomint_getSpdoMemBlock(frameLen_p, sub2Len_p);
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Set the SPDO crc to transmit image
@@ -371,24 +499,49 @@ BOOLEAN xcom_postSpdoFrame(tSubFrameParams * pSub1Params_p,
 BOOLEAN xcom_transmit(UINT32 flowCount_p)
 {
     BOOLEAN fReturn = FALSE;
+    volatile UINT8 * pFrame = NULL;
+    UINT16 frameLen = 0;
 
     /* Set current flow count value to transmit image */
     xcomint_setFlowCount(flowCount_p);
 
-    /* Forward frame to other processor */
-    if(upserial_transmit(xcomInstance_l.transParams_m.pTxImg_m,
-                         xcomInstance_l.transParams_m.txImgSize_m))
-    {
-        fReturn = TRUE;
-    }
-    else
+    /* Build the frame of the current transmit image */
+    if(buildFrame(&pFrame, &frameLen))
     {
-        errh_postFatalError(kErrSourceXCom, kErrorSerialTransferFailed, 0);
-    }
+        /* Forward frame to other processor */
+        if(upserial_transmit(pFrame, frameLen))
+        {
+            xcomInstance_l.stat_m.txFrameCnt_m++;
+            xcomInstance_l.stat_m.txByteCnt_m += frameLen;
+
+            fReturn = TRUE;
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceXCom, kErrorSerialTransferFailed, 0);
+        }
+    }   /* no else: Error is reported in the called function */
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the cross communication traffic statistics
+
+The number of bytes per cycle is the ratio of the byte and the frame counter.
+
+\param[out] pStat_p     Pointer to the resulting statistics
+*/
+/*----------------------------------------------------------------------------*/
+void xcom_getStatistics(tXComStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &xcomInstance_l.stat_m, sizeof(tXComStatistics));
+    }
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -409,59 +562,144 @@ static void transferFinished(void)
 /*----------------------------------------------------------------------------*/
 /**
 \brief    This function is called if a new frame is received
+
+Only the framing is checked in interrupt context. The frame is handed to the
+processing in xcom_process() and the reception of the next frame is started
+in the other buffer.
 */
 /*----------------------------------------------------------------------------*/
 static void frameReceived(void)
 {
+    UINT8 rcvBuf = xcomInstance_l.rxActive_m;
+    UINT32 startTime = (UINT32)constime_getTimeBase();
+    UINT32 isrTime = 0;
+
     BENCHMARK_MOD_01_SET(0);
 
     /* Reset wait for receive flag */
     xcomInstance_l.fWaitForRcv_m = FALSE;
 
-    /* Verify incoming message id header */
-    if(xcomint_verifyIdValue())
+    if(checkFrame(xcomInstance_l.rxBuf_m[rcvBuf], upserial_getReceivedSize()))
     {
-        /* Verify the local timebase to the received timbase */
-        if(verifyTime())
+        if(xcomInstance_l.rxPending_m == XCOM_RX_BUF_NONE)
         {
-            /* Verify the local value of the flow count with the received one */
-            if(verifyFlowCount())
+            /* Hand the frame to the processing and receive to the other buffer */
+            xcomInstance_l.rxPending_m = rcvBuf;
+            xcomInstance_l.rxActive_m = (rcvBuf + 1) % XCOM_RX_BUF_COUNT;
+
+            (void)serialEnableReceive();
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceXCom, kXComProcessingOverrun, 0);
+        }
+    }   /* no else: Error handled in called function */
+
+    isrTime = (UINT32)constime_getTimeBase() - startTime;
+    if(isrTime > xcomInstance_l.stat_m.isrTimeMax_m)
+    {
+        xcomInstance_l.stat_m.isrTimeMax_m = isrTime;
+    }
+    xcomInstance_l.stat_m.isrTimeSum_m += isrTime;
+
+    BENCHMARK_MOD_01_RESET(0);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Process the pending receive buffer
+
+\param[in] fLate_p    TRUE if the frame missed its deadline
+*/
+/*----------------------------------------------------------------------------*/
+static void processPending(BOOLEAN fLate_p)
+{
+    UINT32 startTime = (UINT32)constime_getTimeBase();
+    UINT32 procTime = 0;
+
+    BENCHMARK_MOD_01_SET(1);
+
+    /* Errors are reported in the called function */
+    (void)processFrame(xcomInstance_l.rxBuf_m[xcomInstance_l.rxPending_m]);
+
+    xcomInstance_l.rxPending_m = XCOM_RX_BUF_NONE;
+    xcomInstance_l.fProcLate_m = FALSE;
+
+    procTime = (UINT32)constime_getTimeBase() - startTime;
+    if(procTime > xcomInstance_l.stat_m.procTimeMax_m)
+    {
+        xcomInstance_l.stat_m.procTimeMax_m = procTime;
+    }
+    xcomInstance_l.stat_m.procTimeSum_m += procTime;
+
+    if(fLate_p)
+    {
+        xcomInstance_l.stat_m.lateProcCnt_m++;
+    }
+
+    BENCHMARK_MOD_01_RESET(1);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Verify a received frame and handle its payload
+
+\param[in] pFrame_p    The receive buffer of the frame
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN processFrame(volatile UINT8 * pFrame_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    /* Copy the received frame to the receive image */
+    if(readFrame(pFrame_p))
+    {
+        /* Verify incoming message id header */
+        if(xcomint_verifyIdValue())
+        {
+            /* Verify the local timebase to the received timbase */
+            if(verifyTime())
             {
-                /* Verify the CRC of the local frame with the received frame */
-                if(verifySpdoCrcs())
+                /* Verify the local value of the flow count with the received one */
+                if(verifyFlowCount())
                 {
                     /* Verify the CRC of the local frame with the received frame */
-                    if(verifySsdoSnmtCrcs())
+                    if(verifySpdoCrcs())
                     {
-                        /* Handle the SPDO payload if data is received */
-                        if(xcomint_handleSpdoPayload())
+                        /* Verify the CRC of the local frame with the received frame */
+                        if(verifySsdoSnmtCrcs())
                         {
-                            /* Handle the SSDO/SNMT payload if data is received */
-                            if(xcomint_handleSsdoSnmtPayload())
+                            /* Handle the SPDO payload if data is received */
+                            if(xcomint_handleSpdoPayload())
                             {
-                                /* Reset the message format field */
-                                if(xcomint_setMsgFormat(kPaylTypeTransmit, 0))
-                                {
-                                    /* Re-enable the receiver to get the next message */
-                                    (void)serialEnableReceive();
-                                }
-                                else
+                                /* Handle the SSDO/SNMT payload if data is received */
+                                if(xcomint_handleSsdoSnmtPayload())
                                 {
-                                    errh_postFatalError(kErrSourceXCom, kErrorInvalidMsgFormatValue, 0);
-                                }
+                                    /* Reset the message format field */
+                                    if(xcomint_setMsgFormat(kPaylTypeTransmit, 0))
+                                    {
+                                        fReturn = TRUE;
+                                    }
+                                    else
+                                    {
+                                        errh_postFatalError(kErrSourceXCom, kErrorInvalidMsgFormatValue, 0);
+                                    }
+                                }   /* no else: Error handled in called function */
                             }   /* no else: Error handled in called function */
                         }   /* no else: Error handled in called function */
                     }   /* no else: Error handled in called function */
                 }   /* no else: Error handled in called function */
             }   /* no else: Error handled in called function */
-        }   /* no else: Error handled in called function */
-    }
-    else
-    {
-        errh_postFatalError(kErrSourceXCom, kXComIdValueInvalid, 0);
-    }
+        }
+        else
+        {
+            errh_postFatalError(kErrSourceXCom, kXComIdValueInvalid, 0);
+        }
+    }   /* no else: Error handled in called function */
 
-    BENCHMARK_MOD_01_RESET(0);
+    return fReturn;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -487,8 +725,13 @@ static BOOLEAN serialEnableReceive(void)
     BOOLEAN fReturn = FALSE;
 
     /* Enable the upserial receiver */
-    if(upserial_enableReceive(xcomInstance_l.transParams_m.pRxImg_m,
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    if(upserial_enableReceiveVarLen(xcomInstance_l.rxBuf_m[xcomInstance_l.rxActive_m],
+                                    XCOM_RX_BUF_SIZE))
+#else
+    if(upserial_enableReceive(xcomInstance_l.rxBuf_m[xcomInstance_l.rxActive_m],
                               xcomInstance_l.transParams_m.rxImgSize_m))
+#endif
     {
         fReturn = TRUE;
     }
@@ -500,6 +743,218 @@ static BOOLEAN serialEnableReceive(void)
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Build the frame of the transmit image
+
+Without compact frames the transmit image is sent as it is. A compact frame
+starts with a header of the frame length and the message format followed by
+the sections of the transmit image which are enabled in the message format.
+
+\param[out] ppFrame_p       Pointer to the resulting frame base address
+\param[out] pFrameLen_p     Pointer to the resulting frame length
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN buildFrame(volatile UINT8 ** ppFrame_p, UINT16 * pFrameLen_p)
+{
+    BOOLEAN fReturn = FALSE;
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    UINT8 msgFormat = 0;
+    UINT16 frameLen = 0;
+
+    if(xcomint_getMsgFormat(kPaylTypeTransmit, &msgFormat))
+    {
+        frameLen = getFrameLen(xcomInstance_l.transParams_m.pTxLayout_m, msgFormat);
+
+        /* Fill the frame header */
+        SFS_NET_CPY16(&xcomInstance_l.txFrame_m[0], &frameLen);
+        SFS_NET_CPY8(&xcomInstance_l.txFrame_m[2], &msgFormat);
+
+        /* Copy the present sections of the transmit image */
+        copySections(xcomInstance_l.transParams_m.pTxLayout_m, msgFormat,
+                     xcomInstance_l.transParams_m.pTxImg_m,
+                     xcomInstance_l.txFrame_m, TRUE);
+
+        *ppFrame_p = xcomInstance_l.txFrame_m;
+        *pFrameLen_p = frameLen;
+
+        fReturn = TRUE;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceXCom, kErrorInvalidMsgFormatValue, 0);
+    }
+#else
+    *ppFrame_p = xcomInstance_l.transParams_m.pTxImg_m;
+    *pFrameLen_p = xcomInstance_l.transParams_m.txImgSize_m;
+
+    fReturn = TRUE;
+#endif
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check the framing of a received frame
+
+Without compact frames the received size has to match the receive image. A
+compact frame is only accepted if the length in the header matches the number
+of received bytes and the length of the sections enabled by the message
+format. The content is verified later by processFrame().
+
+\param[in] pFrame_p     The receive buffer of the frame
+\param[in] rcvSize_p    The number of received bytes
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN checkFrame(volatile UINT8 * pFrame_p, UINT32 rcvSize_p)
+{
+    BOOLEAN fReturn = FALSE;
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    UINT16 frameLen = 0;
+    UINT8 msgFormat = 0;
+
+    if(rcvSize_p >= XCOM_FRAME_HEADER_SIZE)
+    {
+        SFS_NET_CPY16(&frameLen, &pFrame_p[0]);
+        SFS_NET_CPY8(&msgFormat, &pFrame_p[2]);
+    }
+
+    if(rcvSize_p >= XCOM_FRAME_HEADER_SIZE && frameLen == rcvSize_p &&
+       frameLen == getFrameLen(xcomInstance_l.transParams_m.pRxLayout_m, msgFormat))
+#else
+    UNUSED_PARAMETER(pFrame_p);
+
+    if(rcvSize_p == xcomInstance_l.transParams_m.rxImgSize_m)
+#endif
+    {
+        fReturn = TRUE;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceXCom, kXComFrameLengthInvalid, rcvSize_p);
+    }
+
+    xcomInstance_l.stat_m.rxFrameCnt_m++;
+    xcomInstance_l.stat_m.rxByteCnt_m += rcvSize_p;
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Copy the received frame to the receive image
+
+The id value and the flow count are always part of the frame and are verified
+afterwards like for the complete image.
+
+\param[in] pFrame_p    The receive buffer of the frame (framing already checked)
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN readFrame(volatile UINT8 * pFrame_p)
+{
+    BOOLEAN fReturn = FALSE;
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    UINT8 msgFormat = 0;
+
+    SFS_NET_CPY8(&msgFormat, &pFrame_p[2]);
+
+    /* Copy the present sections to the receive image */
+    copySections(xcomInstance_l.transParams_m.pRxLayout_m, msgFormat,
+                 xcomInstance_l.transParams_m.pRxImg_m, pFrame_p, FALSE);
+
+    if(xcomint_setMsgFormat(kPaylTypeReceive, msgFormat))
+    {
+        fReturn = TRUE;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourceXCom, kErrorInvalidMsgFormatValue, 0);
+    }
+#else
+    MEMCOPY(xcomInstance_l.transParams_m.pRxImg_m, pFrame_p,
+            xcomInstance_l.transParams_m.rxImgSize_m);
+
+    fReturn = TRUE;
+#endif
+
+    return fReturn;
+}
+
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the length of a compact frame
+
+\param[in] pLayout_p     The sections of the image
+\param[in] msgFormat_p   The message format of the frame
+
+\return The length of the frame including the header
+*/
+/*----------------------------------------------------------------------------*/
+static UINT16 getFrameLen(const tXComImgSection * pLayout_p, UINT8 msgFormat_p)
+{
+    UINT16 frameLen = XCOM_FRAME_HEADER_SIZE;
+    UINT8 i;
+
+    for(i = 0; i < XCOM_IMG_SECTION_COUNT; i++)
+    {
+        if(pLayout_p[i].msgFormatMask_m == 0 ||
+           (pLayout_p[i].msgFormatMask_m & msgFormat_p) > 0)
+        {
+            frameLen += pLayout_p[i].size_m;
+        }
+    }
+
+    return frameLen;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Copy the present sections between an image and a compact frame
+
+\param[in] pLayout_p     The sections of the image
+\param[in] msgFormat_p   The message format of the frame
+\param[in] pImg_p        The base address of the image
+\param[in] pFrame_p      The base address of the frame
+\param[in] fToFrame_p    TRUE: Copy image to frame; FALSE: Copy frame to image
+*/
+/*----------------------------------------------------------------------------*/
+static void copySections(const tXComImgSection * pLayout_p, UINT8 msgFormat_p,
+                         volatile UINT8 * pImg_p, volatile UINT8 * pFrame_p,
+                         BOOLEAN fToFrame_p)
+{
+    UINT16 framePos = XCOM_FRAME_HEADER_SIZE;
+    UINT8 i;
+
+    for(i = 0; i < XCOM_IMG_SECTION_COUNT; i++)
+    {
+        if(pLayout_p[i].msgFormatMask_m == 0 ||
+           (pLayout_p[i].msgFormatMask_m & msgFormat_p) > 0)
+        {
+            if(fToFrame_p)
+            {
+                MEMCOPY(&pFrame_p[framePos], &pImg_p[pLayout_p[i].offset_m],
+                        pLayout_p[i].size_m);
+            }
+            else
+            {
+                MEMCOPY(&pImg_p[pLayout_p[i].offset_m], &pFrame_p[framePos],
+                        pLayout_p[i].size_m);
+            }
+
+            framePos += pLayout_p[i].size_m;
+        }
+    }
+}
+#endif
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Verify the local time with the received time
@@ -65,6 +65,11 @@ flash memory for Altera Nios2.
 
 #define FLASH_DEV_NAME            CFI_FLASH_NAME   /**< Name of the flash controller */
 #define FLASH_BASE                CFI_FLASH_BASE   /**< Base address of the flash controller */
+#define FLASH_PROG_GRANULARITY    2                /**< The CFI flash is programmed in half words */
+#define FLASH_BURST_SIZE          32               /**< Size of the write buffer of the CFI flash */
+#define FLASH_BURST_PROG_TIME     1000             /**< Nominal time in us to program one write buffer through the HAL */
+#define FLASH_SECTOR_SIZE         0x20000UL        /**< Size of one erase block of the CFI flash */
+#define FLASH_STORAGE_SIZE        0x40000UL        /**< Two erase blocks behind the image offset */
 
 /*----------------------------------------------------------------------------*/
 /* module global vars                                                         */
@@ -229,6 +234,25 @@ UINT8* nvs_getAddress(UINT32 offset_p)
     return (UINT8*)(imageBaseAddr_l + offset_p);
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the programming characteristics of the non volatile storage
+
+\param[out] pGeometry_p   Pointer to the resulting geometry
+*/
+/*----------------------------------------------------------------------------*/
+void nvs_getGeometry(tNvsGeometry * pGeometry_p)
+{
+    if(pGeometry_p != (tNvsGeometry*)0)
+    {
+        pGeometry_p->progGranularity_m = FLASH_PROG_GRANULARITY;
+        pGeometry_p->pageSize_m = FLASH_BURST_SIZE;
+        pGeometry_p->pageProgTime_m = FLASH_BURST_PROG_TIME;
+        pGeometry_p->sectorSize_m = FLASH_SECTOR_SIZE;
+        pGeometry_p->storageSize_m = FLASH_STORAGE_SIZE;
+    }
+}
+
 
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
@@ -140,13 +140,9 @@ This function returns the current system tick determined by the system timer.
 \return Returns the system tick in microseconds
 */
 /*----------------------------------------------------------------------------*/
-UINT16 timer_getTickCount(void)
+UINT32 timer_getTickCount(void)
 {
-    UINT32 time;
-
-    time = IORD_32DIRECT(COUNTER_BASE, COUNTER_TIME_REG);
-
-    return (UINT16)time;
+    return IORD_32DIRECT(COUNTER_BASE, COUNTER_TIME_REG);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -156,7 +152,7 @@ UINT16 timer_getTickCount(void)
 \param[in] newVal_p     The new value for the timer
 */
 /*----------------------------------------------------------------------------*/
-void timer_setTickCount(UINT16 newVal_p)
+void timer_setTickCount(UINT32 newVal_p)
 {
     /* Disable counter */
     IOWR_32DIRECT(COUNTER_BASE, COUNTER_TICKCNT_REG, 0);
@@ -168,6 +164,49 @@ void timer_setTickCount(UINT16 newVal_p)
     IOWR_32DIRECT(COUNTER_BASE, COUNTER_TICKCNT_REG, TIMER_TICKS_1US);
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the width of the system tick counter
+
+\return The number of bits of the counter
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 timer_getTickWidth(void)
+{
+    return 32;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Register the callback of the counter wrap interrupt
+
+The counter IP core has no wrap interrupt. The wraps are detected by the
+periodic call of constime_process() (at least once in 71 minutes).
+
+\param[in] pfnWrapCb_p     Function which is called on each wrap of the counter
+
+\return FALSE as the timer provides no wrap interrupt
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_registerWrapCb(tTimerWrapCb pfnWrapCb_p)
+{
+    UNUSED_PARAMETER(pfnWrapCb_p);
+
+    return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if a wrap of the counter is not yet handled by the interrupt
+
+\return Always FALSE as the timer provides no wrap interrupt
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_isWrapPending(void)
+{
+    return FALSE;
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -51,6 +51,8 @@ flash memory for target stm32f103rb (Cortex-M3).
 /*----------------------------------------------------------------------------*/
 #include <sn/nvs.h>
 
+#include <sod.h>
+
 #include <stm32f1xx_hal.h>
 
 /*============================================================================*/
@@ -76,7 +78,21 @@ flash memory for target stm32f103rb (Cortex-M3).
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
-#define FLASH_IMAGE_OFFSET        0x1E400UL       /**< Offset of the stored SOD in the NVS (Page: 120) */
+#define FLASH_IMAGE_OFFSET        0x1E400UL       /**< Offset of the stored SOD in the NVS (Page: 121) */
+#define FLASH_PROG_GRANULARITY    2               /**< The flash is programmed in half words */
+#define FLASH_BURST_SIZE          1024            /**< Size of one flash page */
+#define FLASH_BURST_PROG_TIME     27000           /**< Nominal time in us to program one page (512 * tPROG) */
+#define FLASH_SECTOR_SIZE         1024            /**< Size of one erase page */
+#define FLASH_STORAGE_SIZE        0x1C00UL        /**< Pages 121 to 127 up to the end of the flash */
+#define FLASH_BANK_SIZE           (((FLASH_STORAGE_SIZE / 2) / FLASH_SECTOR_SIZE) * FLASH_SECTOR_SIZE)  /**< One of the two banks of the SOD store (3 pages, page 127 is unused) */
+#define FLASH_BANK_HEADER_SIZE    0x10UL          /**< Header of a bank in front of the parameter set */
+
+/* The SOD store splits the storage into two banks of whole pages. A parameter
+ * set larger than about 3 kB does not fit into a bank and is not stored
+ * (kSodStoreProcNotApplicable) -> Reject such a SOD at compile time */
+#if ((SAPL_k_MAX_PARAM_SET_LEN + FLASH_BANK_HEADER_SIZE) > FLASH_BANK_SIZE)
+  #error "The parameter set does not fit into a bank of the SOD store"
+#endif
 
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
@@ -271,6 +287,25 @@ UINT8* nvs_getAddress(UINT32 offset_p)
     return (UINT8*)(imageBaseAddr_l + offset_p);
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the programming characteristics of the non volatile storage
+
+\param[out] pGeometry_p   Pointer to the resulting geometry
+*/
+/*----------------------------------------------------------------------------*/
+void nvs_getGeometry(tNvsGeometry * pGeometry_p)
+{
+    if(pGeometry_p != NULL)
+    {
+        pGeometry_p->progGranularity_m = FLASH_PROG_GRANULARITY;
+        pGeometry_p->pageSize_m = FLASH_BURST_SIZE;
+        pGeometry_p->pageProgTime_m = FLASH_BURST_PROG_TIME;
+        pGeometry_p->sectorSize_m = FLASH_SECTOR_SIZE;
+        pGeometry_p->storageSize_m = FLASH_STORAGE_SIZE;
+    }
+}
+
 
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
@@ -84,6 +84,12 @@ system timer for stm32f103rb (Cortex-M3).
 
 #define TIMx_CLK_ENABLE()     __HAL_RCC_TIM2_CLK_ENABLE()
 
+#define TIMx_IRQn             TIM2_IRQn
+#define TIMx_IRQHandler       TIM2_IRQHandler
+
+#define TIMER_TICK_WIDTH      16      /**< TIM2 is a 16bit counter */
+#define TIMER_TICK_PERIOD     0xFFFF  /**< Auto reload value of the counter */
+
 /*----------------------------------------------------------------------------*/
 /* local types                                                                */
 /*----------------------------------------------------------------------------*/
@@ -92,6 +98,7 @@ system timer for stm32f103rb (Cortex-M3).
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
 static TIM_HandleTypeDef TimerHandle_l;
+static tTimerWrapCb pfnWrapCb_l = NULL;
 
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
@@ -115,7 +122,14 @@ BOOLEAN timer_init(void)
 
     if(initTimer())
     {
-        if(HAL_TIM_Base_Start(&TimerHandle_l) == HAL_OK)
+        /* The update event of the initialization is no wrap */
+        __HAL_TIM_CLEAR_FLAG(&TimerHandle_l, TIM_FLAG_UPDATE);
+
+        /* The wrap has to be counted before any other interrupt reads the time */
+        HAL_NVIC_SetPriority(TIMx_IRQn, 0, 0);
+        HAL_NVIC_EnableIRQ(TIMx_IRQn);
+
+        if(HAL_TIM_Base_Start_IT(&TimerHandle_l) == HAL_OK)
         {
             fReturn = TRUE;
         }
@@ -131,38 +145,82 @@ BOOLEAN timer_init(void)
 /*----------------------------------------------------------------------------*/
 void timer_close(void)
 {
+    HAL_NVIC_DisableIRQ(TIMx_IRQn);
+
     /* Close TIMx */
     HAL_TIM_Base_DeInit(&TimerHandle_l);
+
+    pfnWrapCb_l = NULL;
 }
 
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Get current system tick
 
-This function returns the current value of the internal 16bit timer.
+This function returns the current value of the internal TIMER_TICK_WIDTH bit
+counter.
 
-\return Returns the system tick in milliseconds
+\return Returns the system tick in microseconds
 */
 /*----------------------------------------------------------------------------*/
-UINT16 timer_getTickCount(void)
+UINT32 timer_getTickCount(void)
 {
-    UINT64 usTime = 0;
-
-    usTime = (UINT32)__HAL_TIM_GET_COUNTER(&TimerHandle_l);
-
-    return usTime;
+    return (UINT32)__HAL_TIM_GET_COUNTER(&TimerHandle_l);
 }
 
 /*----------------------------------------------------------------------------*/
 /**
 \brief    Set the current system tick to a desired value
 
+A wrap which is pending at this time is discarded.
+
 \param[in] newVal_p     The new value for the timer
 */
 /*----------------------------------------------------------------------------*/
-void timer_setTickCount(UINT16 newVal_p)
+void timer_setTickCount(UINT32 newVal_p)
 {
     __HAL_TIM_SET_COUNTER(&TimerHandle_l, newVal_p);
+    __HAL_TIM_CLEAR_FLAG(&TimerHandle_l, TIM_FLAG_UPDATE);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the width of the system tick counter
+
+\return The number of bits of the counter
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 timer_getTickWidth(void)
+{
+    return TIMER_TICK_WIDTH;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Register the callback of the counter wrap interrupt
+
+\param[in] pfnWrapCb_p     Function which is called on each wrap of the counter
+
+\return TRUE as the timer provides a wrap interrupt
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_registerWrapCb(tTimerWrapCb pfnWrapCb_p)
+{
+    pfnWrapCb_l = pfnWrapCb_p;
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if a wrap of the counter is not yet handled by the interrupt
+
+\return TRUE if the wrap interrupt is pending
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_isWrapPending(void)
+{
+    return (__HAL_TIM_GET_FLAG(&TimerHandle_l, TIM_FLAG_UPDATE) != RESET);
 }
 
 /*============================================================================*/
@@ -183,7 +241,7 @@ static BOOLEAN initTimer(void)
     TIMx_CLK_ENABLE();
 
     TimerHandle_l.Instance = TIMx;
-    TimerHandle_l.Init.Period = 0xFFFF;
+    TimerHandle_l.Init.Period = TIMER_TICK_PERIOD;
     TimerHandle_l.Init.Prescaler = TIMER_PRESCALE_1US;
     TimerHandle_l.Init.ClockDivision = 0;
     TimerHandle_l.Init.CounterMode = TIM_COUNTERMODE_UP;
@@ -195,6 +253,24 @@ static BOOLEAN initTimer(void)
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  This function handles the TIMx update (counter wrap) interrupt
+*/
+/*----------------------------------------------------------------------------*/
+void TIMx_IRQHandler(void)
+{
+    if(__HAL_TIM_GET_FLAG(&TimerHandle_l, TIM_FLAG_UPDATE) != RESET)
+    {
+        __HAL_TIM_CLEAR_FLAG(&TimerHandle_l, TIM_FLAG_UPDATE);
+
+        if(pfnWrapCb_l != NULL)
+        {
+            pfnWrapCb_l();
+        }
+    }
+}
+
 /**
  * \}
  * \}
@@ -77,6 +77,11 @@ flash memory for target stm32f103.
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
 #define FLASH_IMAGE_OFFSET        0x40000UL       /**< Offset of the stored SOD in the NVS (Sector: 6) */
+#define FLASH_PROG_GRANULARITY    4               /**< The flash is programmed in words (Voltage range 3) */
+#define FLASH_BURST_SIZE          256             /**< Size of one program burst (The sectors have no pages) */
+#define FLASH_BURST_PROG_TIME     1024            /**< Nominal time in us to program one burst (64 * tPROG) */
+#define FLASH_SECTOR_SIZE         0x20000UL       /**< Size of the sectors 6 and 7 */
+#define FLASH_STORAGE_SIZE        0x40000UL       /**< Sectors 6 and 7 */
 
 /* Base address of the Flash sectors Bank 1 */
 #define ADDR_FLASH_SECTOR_0     ((uint32_t)0x08000000)    /**< Base @ of Sector 0, 16 Kbytes */
@@ -282,6 +287,25 @@ UINT8* nvs_getAddress(UINT32 offset_p)
     return (UINT8*)(imageBaseAddr_l + offset_p);
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the programming characteristics of the non volatile storage
+
+\param[out] pGeometry_p   Pointer to the resulting geometry
+*/
+/*----------------------------------------------------------------------------*/
+void nvs_getGeometry(tNvsGeometry * pGeometry_p)
+{
+    if(pGeometry_p != NULL)
+    {
+        pGeometry_p->progGranularity_m = FLASH_PROG_GRANULARITY;
+        pGeometry_p->pageSize_m = FLASH_BURST_SIZE;
+        pGeometry_p->pageProgTime_m = FLASH_BURST_PROG_TIME;
+        pGeometry_p->sectorSize_m = FLASH_SECTOR_SIZE;
+        pGeometry_p->storageSize_m = FLASH_STORAGE_SIZE;
+    }
+}
+
 
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
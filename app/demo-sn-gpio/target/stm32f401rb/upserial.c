@@ -126,6 +126,9 @@ static DMA_HandleTypeDef DmaTxHandle_l;      /**< DMA transmit handle structure
 static BOOLEAN fTxFinished_l = FALSE;       /**< Transfer finished flag for blocking mode */
 static BOOLEAN fRxFinished_l = FALSE;       /**< Receive finished flag for blocking mode */
 
+static volatile UINT32 rxMaxSize_l = 0;     /**< Buffer size of a variable length reception (0: fixed length) */
+static volatile UINT32 rxSize_l = 0;        /**< Number of bytes of the last finished reception */
+
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
 /*----------------------------------------------------------------------------*/
@@ -135,6 +138,7 @@ static BOOLEAN initDma(UART_HandleTypeDef* pUsartHandler_p);
 static void initNvic(void);
 
 static BOOLEAN waitForTransferFinished(BOOLEAN * pTransFin_p, UINT32 timeoutMs_p);
+static void finishReceiveVarLen(void);
 static void disableFifoErrorIr(void);
 
 /*============================================================================*/
@@ -321,6 +325,8 @@ BOOLEAN upserial_enableReceive(volatile UINT8 * pData_p, UINT32 size_p)
 
     if(pData_p != NULL && size_p > 0)
     {
+        rxMaxSize_l = 0;
+
         /* Perform a DMA transfer */
         if(HAL_UART_Receive_DMA(&UsartHandle_l, (UINT8*)pData_p, size_p) == HAL_OK)
         {
@@ -333,6 +339,67 @@ BOOLEAN upserial_enableReceive(volatile UINT8 * pData_p, UINT32 size_p)
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Enable a DMA reception of variable length
+
+This function enables a DMA reception of a frame with unknown length. The
+reception is finished when the line becomes idle after the frame or when the
+buffer is full. The number of received bytes is provided by
+upserial_getReceivedSize() in the receive finished callback.
+
+\note The frame has to be sent without gaps, as an idle line terminates
+the reception.
+
+\param[in] pData_p       Pointer to the receive buffer
+\param[in] maxSize_p     Size of the receive buffer
+
+\retval TRUE        On success
+\retval FALSE       USART receive failed
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_enableReceiveVarLen(volatile UINT8 * pData_p, UINT32 maxSize_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(pData_p != NULL && maxSize_p > 0)
+    {
+        /* Discard an idle line detected before this reception */
+        __HAL_UART_CLEAR_IDLEFLAG(&UsartHandle_l);
+
+        rxMaxSize_l = maxSize_p;
+
+        /* Perform a DMA transfer */
+        if(HAL_UART_Receive_DMA(&UsartHandle_l, (UINT8*)pData_p, maxSize_p) == HAL_OK)
+        {
+            disableFifoErrorIr();
+
+            /* Terminate the reception on idle line */
+            __HAL_UART_ENABLE_IT(&UsartHandle_l, UART_IT_IDLE);
+
+            fReturn = TRUE;
+        }
+        else
+        {
+            rxMaxSize_l = 0;
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the size of the last reception
+
+\return Number of bytes received by the last finished DMA reception
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 upserial_getReceivedSize(void)
+{
+    return rxSize_l;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief  Start an USART transfer
@@ -595,6 +662,15 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef * pUsartHandle_p)
     {
         fRxFinished_l = TRUE;
 
+        /* The buffer is full before the line became idle */
+        if(rxMaxSize_l > 0)
+        {
+            __HAL_UART_DISABLE_IT(&UsartHandle_l, UART_IT_IDLE);
+            rxMaxSize_l = 0;
+        }
+
+        rxSize_l = pUsartHandle_p->RxXferSize;
+
         /* Call receive finished callback function */
         if(pfnReceiveFin_l != NULL)
             pfnReceiveFin_l();
@@ -652,6 +728,15 @@ This function has been added for HAL 1.4.0 (STM32Cube_FW_F4_V1.4.0) support.
 void USARTx_IRQ_Handler(void)
 {
     HAL_NVIC_ClearPendingIRQ(USARTx_IRQn);
+
+    /* Idle line terminates a variable length reception */
+    if(rxMaxSize_l > 0 &&
+       __HAL_UART_GET_FLAG(&UsartHandle_l, UART_FLAG_IDLE) != RESET)
+    {
+        __HAL_UART_CLEAR_IDLEFLAG(&UsartHandle_l);
+        finishReceiveVarLen();
+    }
+
     HAL_UART_IRQHandler(&UsartHandle_l);
 }
 
@@ -696,6 +781,46 @@ static void disableFifoErrorIr(void)
     __HAL_DMA_DISABLE_IT(&DmaRxHandle_l, DMA_IT_FE);
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Finish a variable length reception on idle line
+
+The receive DMA is stopped without touching a running transmission and the
+receive path of the UART handle is released. The receive finished callback is
+called like on the end of a fixed length reception.
+*/
+/*----------------------------------------------------------------------------*/
+static void finishReceiveVarLen(void)
+{
+    UINT32 rcvSize = rxMaxSize_l - __HAL_DMA_GET_COUNTER(UsartHandle_l.hdmarx);
+
+    /* Ignore the idle state of the line before the first byte */
+    if(rcvSize > 0)
+    {
+        __HAL_UART_DISABLE_IT(&UsartHandle_l, UART_IT_IDLE);
+
+        /* Stop the receive DMA only */
+        CLEAR_BIT(UsartHandle_l.Instance->CR3, USART_CR3_DMAR);
+        (void)HAL_DMA_Abort(UsartHandle_l.hdmarx);
+
+        if(UsartHandle_l.State == HAL_UART_STATE_BUSY_TX_RX)
+        {
+            UsartHandle_l.State = HAL_UART_STATE_BUSY_TX;
+        }
+        else
+        {
+            UsartHandle_l.State = HAL_UART_STATE_READY;
+        }
+
+        rxMaxSize_l = 0;
+        rxSize_l = rcvSize;
+
+        /* Call receive finished callback function */
+        if(pfnReceiveFin_l != NULL)
+            pfnReceiveFin_l();
+    }
+}
+
 /**
  * \}
  * \}
@@ -0,0 +1,91 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/target/x86/include/sn/nvsfile.h
+
+\brief  Control interface of the host non volatile storage model
+
+The x86 target provides a model of the flash of the SN which is backed by a
+file (target/x86/nvs-file.c). Program and erase follow the flash rules and
+take a configurable time on the system timer mock. This allows to run the SOD
+storage on a host and to benchmark the time needed to store the SOD.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_sn_nvsfile_H_
+#define _INC_sn_nvsfile_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/nvs.h>
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Configuration of the non volatile storage model (Times in us)
+ */
+typedef struct
+{
+    const char *    pFileName_m;        /**< Backing file (NULL: The storage is only kept in memory) */
+    UINT32          size_m;             /**< Size of the storage (Multiple of the sector size) */
+    UINT32          sectorSize_m;       /**< Size of one erase sector */
+    UINT16          progGranularity_m;  /**< Smallest number of bytes programmed in one access */
+    UINT16          pageSize_m;         /**< Size of a program page */
+    UINT32          progTime_m;         /**< Time to program one access of progGranularity_m bytes */
+    UINT32          burstTime_m;        /**< Setup time of each write and of each page crossed by a write */
+    UINT32          eraseTime_m;        /**< Time to erase one sector */
+} tNvsFileConfig;
+
+/**
+ * \brief Statistics of the non volatile storage model
+ */
+typedef struct
+{
+    UINT32  writeCnt_m;         /**< Calls of nvs_write() */
+    UINT32  progByteCnt_m;      /**< Programmed bytes */
+    UINT32  pageCrossCnt_m;     /**< Page boundaries crossed by a write */
+    UINT32  eraseCnt_m;         /**< Erased sectors */
+    UINT32  progErrorCnt_m;     /**< Writes which needed to set a bit which is not erased */
+    UINT32  busyTime_m;         /**< Sum of the program and erase time */
+} tNvsFileStat;
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+void nvsfile_setConfig(const tNvsFileConfig * pConfig_p);
+void nvsfile_getStatistics(tNvsFileStat * pStat_p);
+
+#endif /* _INC_sn_nvsfile_H_ */
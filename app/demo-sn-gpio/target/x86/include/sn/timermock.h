@@ -0,0 +1,83 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/target/x86/include/sn/timermock.h
+
+\brief  Control interface of the host system timer mock
+
+The x86 target provides a mock of the system timer (target/x86/timer-mock.c).
+The test advances the counter and controls when the wrap interrupt is served.
+A hook on each access of the timer allows to inject wraps between the reads
+of the timebase extension in constime.c.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_sn_timermock_H_
+#define _INC_sn_timermock_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/timer.h>
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Hook which is called on each access of the timer
+ *
+ * \param accessCnt_p   Number of accesses since the hook was set
+ */
+typedef void (*tTimerMockHook)(UINT32 accessCnt_p);
+
+/**
+ * \brief Statistics of the system timer mock
+ */
+typedef struct
+{
+    UINT32  tickReadCnt_m;      /**< Reads of the counter */
+    UINT32  wrapCnt_m;          /**< Wraps of the counter */
+    UINT32  wrapIrqCnt_m;       /**< Served wrap interrupts */
+} tTimerMockStat;
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+void timermock_setMode(UINT8 tickWidth_p, BOOLEAN fWrapIrq_p);
+void timermock_advance(UINT32 ticks_p);
+void timermock_maskWrapIrq(BOOLEAN fMask_p);
+void timermock_setHook(tTimerMockHook pfnHook_p);
+void timermock_getStatistics(tTimerMockStat * pStat_p);
+
+#endif /* _INC_sn_timermock_H_ */
@@ -0,0 +1,79 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/target/x86/include/sn/upserialmock.h
+
+\brief  Control interface of the host uP serial mock
+
+The x86 target provides a mock of the serial between uP-Master and uP-Slave
+(target/x86/upserial-mock.c). The frames of the local processor are recorded
+and the frames of the other processor are injected by the test. This allows
+to run the cross communication on a host and to count the bytes per cycle.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2014, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_sn_upserialmock_H_
+#define _INC_sn_upserialmock_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/upserial.h>
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#ifndef UPSERIAL_MOCK_FRAME_SIZE
+  #define UPSERIAL_MOCK_FRAME_SIZE      256     /**< Maximum size of a recorded or injected frame */
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Statistics of the uP serial mock
+ */
+typedef struct
+{
+    UINT32  txFrameCnt_m;       /**< Frames sent by the local processor */
+    UINT32  txByteCnt_m;        /**< Bytes sent by the local processor */
+    UINT32  rxFrameCnt_m;       /**< Receptions finished by the mock */
+    UINT32  rxByteCnt_m;        /**< Bytes received by the local processor */
+    UINT32  overrunCnt_m;       /**< Injected frames which did not fit into the receive buffer */
+} tUpSerialMockStat;
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserialmock_receive(const UINT8 * pData_p, UINT32 size_p);
+UINT32 upserialmock_getTxFrame(UINT8 * pData_p, UINT32 size_p);
+void upserialmock_getStatistics(tUpSerialMockStat * pStat_p);
+
+#endif /* _INC_sn_upserialmock_H_ */
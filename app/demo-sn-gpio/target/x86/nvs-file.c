@@ -0,0 +1,463 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/target/x86/nvs-file.c
+
+\defgroup module_sn_x86_nvs_file Non volatile storage model (Linux host)
+\{
+
+\brief  Implements a file backed model of the non volatile storage
+
+Replaces the flash of the target on a Linux host. The storage is mapped from
+a file so an image survives a restart of the host process. Like on the flash
+an erase sets all bits of a sector and a write can only clear bits. Each write
+and erase advances the system timer mock by the configured program and erase
+time, which stalls the caller like the flash stalls the CPU on the target.
+
+\ingroup group_app_sn_targ_x86
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2014, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 200112L     /* open(), ftruncate() and mmap() */
+
+#include <sn/nvs.h>
+#include <sn/nvsfile.h>
+#include <sn/timermock.h>
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#define NVS_FILE_ERASED_BYTE        (UINT8)0xFF     /**< Value of an erased byte */
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Instance of the non volatile storage model
+ */
+typedef struct
+{
+    tNvsFileConfig  config_m;           /**< Configuration of the model */
+    UINT8 *         pImage_m;           /**< Mapped storage (NULL: Closed) */
+    int             fd_m;               /**< Descriptor of the backing file (-1: In memory) */
+    tNvsFileStat    stat_m;             /**< Statistics of the model */
+} tNvsFileInstance;
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+
+/* The default geometry and timing follow sector 6 of the stm32f401 */
+static tNvsFileInstance nvsFile_l =
+{
+    { NULL, 0x20000, 0x20000, 4, 256, 16, 2, 1000000 },
+    NULL, -1,
+    { 0, 0, 0, 0, 0, 0 }
+};
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static BOOLEAN openFile(void);
+static void spendTime(UINT32 time_p);
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Initialize the non volatile storage
+
+The backing file is created and erased if it does not exist. A file which is
+shorter than the storage is extended by erased sectors.
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN nvs_init(void)
+{
+    BOOLEAN retVal = FALSE;
+
+    MEMSET(&nvsFile_l.stat_m, 0, sizeof(tNvsFileStat));
+
+    if(nvsFile_l.pImage_m != NULL)
+    {
+        /* Already open */
+        retVal = TRUE;
+    }
+    else if(nvsFile_l.config_m.pFileName_m != NULL)
+    {
+        retVal = openFile();
+    }
+    else
+    {
+        nvsFile_l.pImage_m = (UINT8*)malloc(nvsFile_l.config_m.size_m);
+        if(nvsFile_l.pImage_m != NULL)
+        {
+            MEMSET(nvsFile_l.pImage_m, NVS_FILE_ERASED_BYTE, nvsFile_l.config_m.size_m);
+            retVal = TRUE;
+        }
+    }
+
+    return retVal;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Close the non volatile storage
+
+The content of the storage is flushed to the backing file.
+*/
+/*----------------------------------------------------------------------------*/
+void nvs_close(void)
+{
+    if(nvsFile_l.pImage_m != NULL)
+    {
+        if(nvsFile_l.fd_m >= 0)
+        {
+            (void)msync(nvsFile_l.pImage_m, nvsFile_l.config_m.size_m, MS_SYNC);
+            (void)munmap(nvsFile_l.pImage_m, nvsFile_l.config_m.size_m);
+            (void)close(nvsFile_l.fd_m);
+            nvsFile_l.fd_m = -1;
+        }
+        else
+        {
+            free(nvsFile_l.pImage_m);
+        }
+
+        nvsFile_l.pImage_m = NULL;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Write data to the non volatile storage
+
+Like on the flash a write can only clear bits. A write which needs to set a
+bit fails and leaves the storage unchanged. The write takes the burst time,
+the program time of each access and the burst time of each crossed page.
+
+\param offset_p  The offset of the data in the storage
+\param pData_p   Pointer to the data to write
+\param length_p  The length of the data to write
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN nvs_write(UINT32 offset_p, UINT8 * pData_p, UINT32 length_p)
+{
+    BOOLEAN retVal = FALSE;
+    UINT32 granularity = nvsFile_l.config_m.progGranularity_m;
+    UINT32 pageSize = nvsFile_l.config_m.pageSize_m;
+    UINT32 accessCnt;
+    UINT32 pageCrossCnt;
+    UINT32 i;
+
+    if(nvsFile_l.pImage_m != NULL && pData_p != NULL && length_p > 0 &&
+       offset_p < nvsFile_l.config_m.size_m                          &&
+       length_p <= nvsFile_l.config_m.size_m - offset_p               )
+    {
+        nvsFile_l.stat_m.writeCnt_m++;
+
+        /* Check that no bit has to be set */
+        retVal = TRUE;
+        for(i = 0; i < length_p; i++)
+        {
+            if((nvsFile_l.pImage_m[offset_p + i] & pData_p[i]) != pData_p[i])
+            {
+                nvsFile_l.stat_m.progErrorCnt_m++;
+                retVal = FALSE;
+                break;
+            }
+        }
+
+        if(retVal != FALSE)
+        {
+            for(i = 0; i < length_p; i++)
+            {
+                nvsFile_l.pImage_m[offset_p + i] &= pData_p[i];
+            }
+
+            accessCnt = ((offset_p + length_p + granularity - 1) / granularity) -
+                        (offset_p / granularity);
+            pageCrossCnt = ((offset_p + length_p - 1) / pageSize) - (offset_p / pageSize);
+
+            nvsFile_l.stat_m.progByteCnt_m += length_p;
+            nvsFile_l.stat_m.pageCrossCnt_m += pageCrossCnt;
+
+            spendTime(nvsFile_l.config_m.burstTime_m * (pageCrossCnt + 1) +
+                      nvsFile_l.config_m.progTime_m * accessCnt);
+        }
+    }
+
+    return retVal;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Read an Uint32 from the non volatile storage
+
+\param offset_p       The offset of the data in the storage
+\param ppReadData_p   Pointer to the resulting read data
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN nvs_readUint32(UINT32 offset_p, UINT32 ** ppReadData_p)
+{
+    BOOLEAN retVal = FALSE;
+
+    if(ppReadData_p != NULL && nvsFile_l.pImage_m != NULL &&
+       offset_p + sizeof(UINT32) <= nvsFile_l.config_m.size_m)
+    {
+        *ppReadData_p = (UINT32 *)(nvsFile_l.pImage_m + offset_p);
+        retVal = TRUE;
+    }
+
+    return retVal;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Erase the sector behind the offset
+
+\param offset_p  The offset of the sector to erase
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN nvs_erase(UINT32 offset_p)
+{
+    BOOLEAN retVal = FALSE;
+    UINT32 sectorStart;
+
+    if(nvsFile_l.pImage_m != NULL && offset_p < nvsFile_l.config_m.size_m)
+    {
+        sectorStart = offset_p - (offset_p % nvsFile_l.config_m.sectorSize_m);
+
+        MEMSET(nvsFile_l.pImage_m + sectorStart, NVS_FILE_ERASED_BYTE,
+               nvsFile_l.config_m.sectorSize_m);
+
+        nvsFile_l.stat_m.eraseCnt_m++;
+        spendTime(nvsFile_l.config_m.eraseTime_m);
+
+        retVal = TRUE;
+    }
+
+    return retVal;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the base address of the NVS memory offset
+
+\return Pointer to the offset address
+*/
+/*----------------------------------------------------------------------------*/
+UINT8* nvs_getAddress(UINT32 offset_p)
+{
+    return nvsFile_l.pImage_m + offset_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the programming characteristics of the non volatile storage
+
+\param[out] pGeometry_p   Pointer to the resulting geometry
+*/
+/*----------------------------------------------------------------------------*/
+void nvs_getGeometry(tNvsGeometry * pGeometry_p)
+{
+    UINT32 accessPerPage;
+
+    if(pGeometry_p != NULL)
+    {
+        accessPerPage = nvsFile_l.config_m.pageSize_m / nvsFile_l.config_m.progGranularity_m;
+
+        pGeometry_p->progGranularity_m = nvsFile_l.config_m.progGranularity_m;
+        pGeometry_p->pageSize_m = nvsFile_l.config_m.pageSize_m;
+        pGeometry_p->pageProgTime_m = nvsFile_l.config_m.burstTime_m +
+                                      nvsFile_l.config_m.progTime_m * accessPerPage;
+        pGeometry_p->sectorSize_m = nvsFile_l.config_m.sectorSize_m;
+        pGeometry_p->storageSize_m = nvsFile_l.config_m.size_m;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Configure the non volatile storage model
+
+Call before nvs_init(). The configuration is kept over nvs_close().
+
+\param[in] pConfig_p    Pointer to the configuration
+*/
+/*----------------------------------------------------------------------------*/
+void nvsfile_setConfig(const tNvsFileConfig * pConfig_p)
+{
+    if(pConfig_p != NULL                                            &&
+       pConfig_p->sectorSize_m > 0                                  &&
+       pConfig_p->size_m >= pConfig_p->sectorSize_m                 &&
+       (pConfig_p->size_m % pConfig_p->sectorSize_m) == 0           &&
+       pConfig_p->progGranularity_m > 0                             &&
+       pConfig_p->pageSize_m >= pConfig_p->progGranularity_m        &&
+       (pConfig_p->pageSize_m % pConfig_p->progGranularity_m) == 0   )
+    {
+        MEMCOPY(&nvsFile_l.config_m, pConfig_p, sizeof(tNvsFileConfig));
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the non volatile storage model
+
+\param[out] pStat_p    Pointer to the resulting statistics
+*/
+/*----------------------------------------------------------------------------*/
+void nvsfile_getStatistics(tNvsFileStat * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &nvsFile_l.stat_m, sizeof(tNvsFileStat));
+    }
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Open and map the backing file
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN openFile(void)
+{
+    BOOLEAN retVal = FALSE;
+    struct stat fileStat;
+    UINT32 fileSize = 0;
+    void * pMap;
+
+    nvsFile_l.fd_m = open(nvsFile_l.config_m.pFileName_m, O_RDWR | O_CREAT, 0644);
+    if(nvsFile_l.fd_m >= 0)
+    {
+        if(fstat(nvsFile_l.fd_m, &fileStat) == 0 &&
+           ftruncate(nvsFile_l.fd_m, (off_t)nvsFile_l.config_m.size_m) == 0)
+        {
+            if((UINT32)fileStat.st_size < nvsFile_l.config_m.size_m)
+            {
+                fileSize = (UINT32)fileStat.st_size;
+            }
+            else
+            {
+                fileSize = nvsFile_l.config_m.size_m;
+            }
+
+            pMap = mmap(NULL, nvsFile_l.config_m.size_m, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, nvsFile_l.fd_m, 0);
+            if(pMap != MAP_FAILED)
+            {
+                nvsFile_l.pImage_m = (UINT8*)pMap;
+
+                /* The extension of the file is zero filled -> Erase it */
+                MEMSET(nvsFile_l.pImage_m + fileSize, NVS_FILE_ERASED_BYTE,
+                       nvsFile_l.config_m.size_m - fileSize);
+
+                retVal = TRUE;
+            }
+        }
+
+        if(retVal == FALSE)
+        {
+            (void)close(nvsFile_l.fd_m);
+            nvsFile_l.fd_m = -1;
+        }
+    }
+
+    return retVal;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Let the program or erase time pass on the system timer
+
+\param time_p   The time in us
+*/
+/*----------------------------------------------------------------------------*/
+static void spendTime(UINT32 time_p)
+{
+    nvsFile_l.stat_m.busyTime_m += time_p;
+
+    timermock_advance(time_p);
+}
+
+/**
+ * \}
+ * \}
+ */
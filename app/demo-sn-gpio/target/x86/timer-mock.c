@@ -0,0 +1,381 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/target/x86/timer-mock.c
+
+\defgroup module_sn_x86_timer_mock System timer mock (Linux host)
+\{
+
+\brief  Implements a host mock of the system timer
+
+Replaces the hardware counter of the target on a Linux host. The counter only
+moves with timermock_advance(). It emulates the 16bit counter with wrap
+interrupt of the stm32f103, the 32bit counter of the stm32f401 or a counter
+without wrap interrupt like on the Nios II. A wrap stays pending while the
+wrap interrupt is masked, like for a read in an interrupt of higher priority.
+
+\ingroup group_app_sn_targ_x86
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2014, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/timer.h>
+#include <sn/timermock.h>
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#define TIMER_MOCK_DEFAULT_WIDTH    16      /**< Counter width of the stm32f103 */
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Instance of the system timer mock
+ */
+typedef struct
+{
+    UINT64          counter_m;          /**< Value of the counter */
+    UINT8           tickWidth_m;        /**< Width of the counter in bits */
+    BOOLEAN         fWrapIrq_m;         /**< The counter provides a wrap interrupt */
+    BOOLEAN         fWrapPending_m;     /**< A wrap is not yet served by the interrupt */
+    BOOLEAN         fIrqMasked_m;       /**< The wrap interrupt is held pending */
+    tTimerWrapCb    pfnWrapCb_m;        /**< Callback of the wrap interrupt */
+
+    tTimerMockHook  pfnHook_m;          /**< Hook on each access of the timer */
+    UINT32          accessCnt_m;        /**< Accesses since the hook was set */
+    BOOLEAN         fInHook_m;          /**< The hook is running */
+
+    tTimerMockStat  stat_m;             /**< Timer statistics */
+} tTimerMockInstance;
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tTimerMockInstance timerMock_l =
+{
+    0, TIMER_MOCK_DEFAULT_WIDTH, TRUE, FALSE, FALSE, NULL,
+    NULL, 0, FALSE,
+    { 0, 0, 0 }
+};
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static void callHook(void);
+static void serveWrapIrq(void);
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Initialize the timer module
+
+The mode set by timermock_setMode() is kept.
+
+\retval TRUE    Always successful
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_init(void)
+{
+    timerMock_l.counter_m = 0;
+    timerMock_l.fWrapPending_m = FALSE;
+    timerMock_l.fIrqMasked_m = FALSE;
+    timerMock_l.pfnWrapCb_m = NULL;
+    MEMSET(&timerMock_l.stat_m, 0, sizeof(tTimerMockStat));
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Close the timer module
+*/
+/*----------------------------------------------------------------------------*/
+void timer_close(void)
+{
+    timerMock_l.pfnWrapCb_m = NULL;
+    timerMock_l.pfnHook_m = NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get current system tick
+
+\return Returns the system tick in microseconds
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 timer_getTickCount(void)
+{
+    callHook();
+
+    timerMock_l.stat_m.tickReadCnt_m++;
+
+    return (UINT32)timerMock_l.counter_m;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Set the current system tick to a desired value
+
+A wrap which is pending at this time is discarded.
+
+\param[in] newVal_p     The new value for the timer
+*/
+/*----------------------------------------------------------------------------*/
+void timer_setTickCount(UINT32 newVal_p)
+{
+    timerMock_l.counter_m = newVal_p & ((((UINT64)1) << timerMock_l.tickWidth_m) - 1);
+    timerMock_l.fWrapPending_m = FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the width of the system tick counter
+
+\return The number of bits of the counter
+*/
+/*----------------------------------------------------------------------------*/
+UINT8 timer_getTickWidth(void)
+{
+    return timerMock_l.tickWidth_m;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Register the callback of the counter wrap interrupt
+
+\param[in] pfnWrapCb_p     Function which is called on each wrap of the counter
+
+\return TRUE if the mock emulates a wrap interrupt
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_registerWrapCb(tTimerWrapCb pfnWrapCb_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(timerMock_l.fWrapIrq_m)
+    {
+        timerMock_l.pfnWrapCb_m = pfnWrapCb_p;
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if a wrap of the counter is not yet handled by the interrupt
+
+\return TRUE if the wrap interrupt is pending
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN timer_isWrapPending(void)
+{
+    callHook();
+
+    return timerMock_l.fWrapPending_m;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Select the emulated counter
+
+Call before constime_init().
+
+\param[in] tickWidth_p     Width of the counter in bits (1 to 32)
+\param[in] fWrapIrq_p      TRUE if the counter provides a wrap interrupt
+*/
+/*----------------------------------------------------------------------------*/
+void timermock_setMode(UINT8 tickWidth_p, BOOLEAN fWrapIrq_p)
+{
+    if(tickWidth_p > 0 && tickWidth_p <= 32)
+    {
+        timerMock_l.tickWidth_m = tickWidth_p;
+    }
+
+    timerMock_l.fWrapIrq_m = fWrapIrq_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Advance the counter
+
+A wrap of the counter raises the wrap interrupt. It is served immediately
+unless it is masked. Only one wrap can be pending like on the hardware.
+
+\param[in] ticks_p     Number of ticks (microseconds) to advance
+*/
+/*----------------------------------------------------------------------------*/
+void timermock_advance(UINT32 ticks_p)
+{
+    UINT64 period = ((UINT64)1) << timerMock_l.tickWidth_m;
+
+    timerMock_l.counter_m += ticks_p;
+
+    while(timerMock_l.counter_m >= period)
+    {
+        timerMock_l.counter_m -= period;
+        timerMock_l.stat_m.wrapCnt_m++;
+
+        if(timerMock_l.fWrapIrq_m)
+        {
+            timerMock_l.fWrapPending_m = TRUE;
+
+            serveWrapIrq();
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Mask the wrap interrupt
+
+A wrap which occurs while the interrupt is masked is served on unmask.
+
+\param[in] fMask_p     TRUE: hold the interrupt pending; FALSE: serve it
+*/
+/*----------------------------------------------------------------------------*/
+void timermock_maskWrapIrq(BOOLEAN fMask_p)
+{
+    timerMock_l.fIrqMasked_m = fMask_p;
+
+    serveWrapIrq();
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Set the hook which is called on each access of the timer
+
+The hook is called before the counter or the pending flag is read. It may
+advance the counter to emulate time passing or an interrupt between two
+reads. Accesses from inside the hook do not call it again.
+
+\param[in] pfnHook_p   The hook (NULL: remove)
+*/
+/*----------------------------------------------------------------------------*/
+void timermock_setHook(tTimerMockHook pfnHook_p)
+{
+    timerMock_l.pfnHook_m = pfnHook_p;
+    timerMock_l.accessCnt_m = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the timer mock
+
+\param[out] pStat_p    Pointer to the resulting statistics
+*/
+/*----------------------------------------------------------------------------*/
+void timermock_getStatistics(tTimerMockStat * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &timerMock_l.stat_m, sizeof(tTimerMockStat));
+    }
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Call the access hook of the test
+*/
+/*----------------------------------------------------------------------------*/
+static void callHook(void)
+{
+    if(timerMock_l.pfnHook_m != NULL && timerMock_l.fInHook_m == FALSE)
+    {
+        timerMock_l.fInHook_m = TRUE;
+        timerMock_l.accessCnt_m++;
+
+        timerMock_l.pfnHook_m(timerMock_l.accessCnt_m);
+
+        timerMock_l.fInHook_m = FALSE;
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Serve a pending wrap interrupt if it is not masked
+*/
+/*----------------------------------------------------------------------------*/
+static void serveWrapIrq(void)
+{
+    if(timerMock_l.fWrapPending_m && timerMock_l.fIrqMasked_m == FALSE)
+    {
+        /* Clear the flag before the callback like TIMx_IRQHandler() */
+        timerMock_l.fWrapPending_m = FALSE;
+        timerMock_l.stat_m.wrapIrqCnt_m++;
+
+        if(timerMock_l.pfnWrapCb_m != NULL)
+        {
+            timerMock_l.pfnWrapCb_m();
+        }
+    }
+}
+
+/**
+ * \}
+ * \}
+ */
@@ -0,0 +1,512 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/target/x86/upserial-mock.c
+
+\defgroup module_sn_x86_upserial_mock Cross communication serial mock (Linux host)
+\{
+
+\brief  Implements a host mock of the uP-Master <-> uP-Slave serial
+
+Replaces the USART and DMA of the target on a Linux host. A transmission
+finishes immediately and the frame is recorded for the test. The frames of
+the other processor are injected with upserialmock_receive() and are copied
+to the enabled receive buffer like by the receive DMA. A variable length
+reception finishes at the end of each injected frame like on idle line.
+
+\ingroup group_app_sn_targ_x86
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2014, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <sn/upserial.h>
+#include <sn/upserialmock.h>
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Instance of the uP serial mock
+ */
+typedef struct
+{
+    tUpSerialTransferFin    pfnTransfFin_m;     /**< Transfer finished callback */
+    tUpSerialReceiveFin     pfnReceiveFin_m;    /**< Frame received callback */
+    tUpSerialTransferError  pfnTransfError_m;   /**< Transfer error callback */
+
+    volatile UINT8 *        pRxBuf_m;           /**< Enabled receive buffer (NULL: disabled) */
+    UINT32                  rxBufSize_m;        /**< Size of the enabled receive buffer */
+    UINT32                  rxPos_m;            /**< Bytes received into the enabled buffer */
+    BOOLEAN                 fRxVarLen_m;        /**< The reception finishes at the end of a frame */
+    UINT32                  rxSize_m;           /**< Number of bytes of the last finished reception */
+
+    UINT8                   pendFrame_m[UPSERIAL_MOCK_FRAME_SIZE];  /**< Frame injected without enabled reception */
+    UINT32                  pendSize_m;                             /**< Size of the pending frame */
+
+    UINT8                   txFrame_m[UPSERIAL_MOCK_FRAME_SIZE];    /**< Last transmitted frame */
+    UINT32                  txSize_m;                               /**< Size of the last transmitted frame */
+
+    tUpSerialMockStat       stat_m;             /**< Transfer statistics */
+} tUpSerialMockInstance;
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tUpSerialMockInstance mockInstance_l;
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static BOOLEAN recordTxFrame(volatile UINT8 * pData_p, UINT32 size_p);
+static BOOLEAN deliverFrame(const UINT8 * pData_p, UINT32 size_p);
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Initialize the up serial mock
+
+\retval TRUE    Always successful
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_init(void)
+{
+    MEMSET(&mockInstance_l, 0, sizeof(tUpSerialMockInstance));
+
+    return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Close the up serial mock
+*/
+/*----------------------------------------------------------------------------*/
+void upserial_exit(void)
+{
+    MEMSET(&mockInstance_l, 0, sizeof(tUpSerialMockInstance));
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Register serial callback functions
+
+\param pfnTransfFin_p     Pointer to the transfer finished callback
+\param pfnReceivefFin_p   Pointer to the receive finished callback
+\param pfnTransfError_p   Pointer to the transfer error callback
+*/
+/*----------------------------------------------------------------------------*/
+void upserial_registerCb(tUpSerialTransferFin pfnTransfFin_p,
+                         tUpSerialReceiveFin pfnReceivefFin_p,
+                         tUpSerialTransferError pfnTransfError_p)
+{
+    mockInstance_l.pfnTransfFin_m = pfnTransfFin_p;
+    mockInstance_l.pfnReceiveFin_m = pfnReceivefFin_p;
+    mockInstance_l.pfnTransfError_m = pfnTransfError_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Deregister serial callback functions
+*/
+/*----------------------------------------------------------------------------*/
+void upserial_deRegisterCb(void)
+{
+    mockInstance_l.pfnTransfFin_m = NULL;
+    mockInstance_l.pfnReceiveFin_m = NULL;
+    mockInstance_l.pfnTransfError_m = NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Perform a blocking transfer
+
+\param[in] pData_p       Pointer to the transmit data
+\param[in] size_p        Size of the transmit data
+
+\retval TRUE        On success
+\retval FALSE       Frame is too large for the mock
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_transmitBlock(volatile UINT8 * pData_p, UINT32 size_p)
+{
+    return recordTxFrame(pData_p, size_p);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Perform a blocking reception
+
+Only a frame which is already injected can be received as the time does not
+advance while the caller blocks.
+
+\param[in] pData_p       Pointer to the received data
+\param[in] size_p        Size of the received data
+\param[in] timeoutMs_p   The timeout in ms (unused)
+
+\retval TRUE        On success
+\retval FALSE       No frame of this size is pending
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_receiveBlock(volatile UINT8 * pData_p, UINT32 size_p, UINT32 timeoutMs_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    UNUSED_PARAMETER(timeoutMs_p);
+
+    if(pData_p != NULL && size_p > 0 && mockInstance_l.pendSize_m == size_p)
+    {
+        MEMCOPY(pData_p, mockInstance_l.pendFrame_m, size_p);
+        mockInstance_l.pendSize_m = 0;
+
+        mockInstance_l.rxSize_m = size_p;
+        mockInstance_l.stat_m.rxFrameCnt_m++;
+        mockInstance_l.stat_m.rxByteCnt_m += size_p;
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Enable a reception of fixed length
+
+A pending frame is received immediately.
+
+\param[in] pData_p       Pointer to the received data
+\param[in] size_p        Size of the received data
+
+\retval TRUE        On success
+\retval FALSE       Invalid parameter
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_enableReceive(volatile UINT8 * pData_p, UINT32 size_p)
+{
+    BOOLEAN fReturn = FALSE;
+    UINT32 pendSize = 0;
+
+    if(pData_p != NULL && size_p > 0)
+    {
+        mockInstance_l.pRxBuf_m = pData_p;
+        mockInstance_l.rxBufSize_m = size_p;
+        mockInstance_l.rxPos_m = 0;
+        mockInstance_l.fRxVarLen_m = FALSE;
+
+        pendSize = mockInstance_l.pendSize_m;
+        if(pendSize > 0)
+        {
+            mockInstance_l.pendSize_m = 0;
+            (void)deliverFrame(mockInstance_l.pendFrame_m, pendSize);
+        }
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Enable a reception of variable length
+
+The reception finishes at the end of the next injected frame. A pending frame
+is received immediately.
+
+\param[in] pData_p       Pointer to the receive buffer
+\param[in] maxSize_p     Size of the receive buffer
+
+\retval TRUE        On success
+\retval FALSE       Invalid parameter
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_enableReceiveVarLen(volatile UINT8 * pData_p, UINT32 maxSize_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(upserial_enableReceive(pData_p, maxSize_p))
+    {
+        mockInstance_l.fRxVarLen_m = TRUE;
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the size of the last reception
+
+\return Number of bytes received by the last finished reception
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 upserial_getReceivedSize(void)
+{
+    return mockInstance_l.rxSize_m;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Start a transfer
+
+The transfer finishes immediately and the frame is recorded.
+
+\param[in] pData_p       Pointer to the transmit data
+\param[in] size_p        Size of the transmit data
+
+\retval TRUE        On success
+\retval FALSE       Frame is too large for the mock
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserial_transmit(volatile UINT8 * pData_p, UINT32 size_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(recordTxFrame(pData_p, size_p))
+    {
+        if(mockInstance_l.pfnTransfFin_m != NULL)
+            mockInstance_l.pfnTransfFin_m();
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Inject a frame of the other processor
+
+The frame is copied to the enabled receive buffer. If no reception is enabled
+the frame is kept until the next reception is enabled. Bytes which do not fit
+into the receive buffer are lost and the transfer error callback is called.
+
+\param[in] pData_p       Pointer to the frame
+\param[in] size_p        Size of the frame
+
+\retval TRUE        The frame was received or is pending
+\retval FALSE       Bytes of the frame were lost
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN upserialmock_receive(const UINT8 * pData_p, UINT32 size_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(pData_p != NULL && size_p > 0)
+    {
+        if(mockInstance_l.pRxBuf_m != NULL)
+        {
+            fReturn = deliverFrame(pData_p, size_p);
+        }
+        else if(mockInstance_l.pendSize_m == 0 && size_p <= UPSERIAL_MOCK_FRAME_SIZE)
+        {
+            MEMCOPY(mockInstance_l.pendFrame_m, pData_p, size_p);
+            mockInstance_l.pendSize_m = size_p;
+
+            fReturn = TRUE;
+        }
+        else
+        {
+            mockInstance_l.stat_m.overrunCnt_m++;
+
+            if(mockInstance_l.pfnTransfError_m != NULL)
+                mockInstance_l.pfnTransfError_m();
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the last transmitted frame
+
+\param[out] pData_p      Pointer to the resulting frame
+\param[in] size_p        Size of the frame buffer
+
+\return Size of the last transmitted frame (0: no frame or buffer too small)
+*/
+/*----------------------------------------------------------------------------*/
+UINT32 upserialmock_getTxFrame(UINT8 * pData_p, UINT32 size_p)
+{
+    UINT32 txSize = 0;
+
+    if(pData_p != NULL && mockInstance_l.txSize_m <= size_p)
+    {
+        MEMCOPY(pData_p, mockInstance_l.txFrame_m, mockInstance_l.txSize_m);
+        txSize = mockInstance_l.txSize_m;
+    }
+
+    return txSize;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the statistics of the uP serial mock
+
+\param[out] pStat_p     Pointer to the resulting statistics
+*/
+/*----------------------------------------------------------------------------*/
+void upserialmock_getStatistics(tUpSerialMockStat * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &mockInstance_l.stat_m, sizeof(tUpSerialMockStat));
+    }
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Record a transmitted frame
+
+\param[in] pData_p       Pointer to the transmit data
+\param[in] size_p        Size of the transmit data
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN recordTxFrame(volatile UINT8 * pData_p, UINT32 size_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    if(pData_p != NULL && size_p > 0 && size_p <= UPSERIAL_MOCK_FRAME_SIZE)
+    {
+        MEMCOPY(mockInstance_l.txFrame_m, pData_p, size_p);
+        mockInstance_l.txSize_m = size_p;
+
+        mockInstance_l.stat_m.txFrameCnt_m++;
+        mockInstance_l.stat_m.txByteCnt_m += size_p;
+
+        fReturn = TRUE;
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Copy a frame to the enabled receive buffer
+
+A fixed length reception finishes when the buffer is full and may span
+several frames. A variable length reception finishes at the end of the frame.
+The reception is disabled before the receive finished callback is called, so
+the callback can enable the next one.
+
+\param[in] pData_p       Pointer to the frame
+\param[in] size_p        Size of the frame
+
+\return TRUE if all bytes were received; FALSE on overrun
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN deliverFrame(const UINT8 * pData_p, UINT32 size_p)
+{
+    BOOLEAN fReturn = TRUE;
+    UINT32 copySize = mockInstance_l.rxBufSize_m - mockInstance_l.rxPos_m;
+
+    if(copySize > size_p)
+    {
+        copySize = size_p;
+    }
+
+    MEMCOPY(&mockInstance_l.pRxBuf_m[mockInstance_l.rxPos_m], pData_p, copySize);
+    mockInstance_l.rxPos_m += copySize;
+    mockInstance_l.stat_m.rxByteCnt_m += copySize;
+
+    if(copySize < size_p)
+    {
+        /* Buffer is full, the remaining bytes are lost */
+        mockInstance_l.stat_m.overrunCnt_m++;
+        fReturn = FALSE;
+    }
+
+    if(mockInstance_l.fRxVarLen_m || mockInstance_l.rxPos_m == mockInstance_l.rxBufSize_m)
+    {
+        mockInstance_l.rxSize_m = mockInstance_l.rxPos_m;
+        mockInstance_l.stat_m.rxFrameCnt_m++;
+
+        mockInstance_l.pRxBuf_m = NULL;
+        mockInstance_l.rxPos_m = 0;
+
+        if(mockInstance_l.pfnReceiveFin_m != NULL)
+            mockInstance_l.pfnReceiveFin_m();
+    }
+
+    if(fReturn == FALSE && mockInstance_l.pfnTransfError_m != NULL)
+    {
+        mockInstance_l.pfnTransfError_m();
+    }
+
+    return fReturn;
+}
+
+/**
+ * \}
+ * \}
+ */
@@ -0,0 +1,368 @@
+/**
+********************************************************************************
+\file   demo-sn-gpio/tasksched.c
+
+\defgroup module_sn_tasksched Task scheduler module
+\{
+
+\brief  This module schedules the tasks at the end of the synchronous cycle
+
+The tasks which would be possible to be called in the background loop are
+called at the end of the synchronous task to ensure a valid program flow. The
+scheduler measures the execution time of each task and runs as many tasks as
+fit into the budget of the cycle. The budget is a share of the cycle time
+measured by the cycle monitoring. The first task of the rotation is always
+run, the start of the rotation moves by one task each cycle. Tasks which
+report further work are run again while the budget lasts.
+
+\ingroup group_app_sn
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2014, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+#include <sn/tasksched.h>
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#ifndef TASKSCHED_BUDGET_PERCENT
+  #define TASKSCHED_BUDGET_PERCENT      (UINT32)50      /**< Share of the cycle time the tasks may use (counted from the start of the cycle) */
+#endif
+
+#ifndef TASKSCHED_MAX_RUNS
+  #define TASKSCHED_MAX_RUNS            8               /**< Maximum number of task runs in one cycle */
+#endif
+
+#define TASKSCHED_COST_DECAY_SHIFT      3               /**< The cost estimate follows a shorter execution time by 1/8 of the difference */
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Task scheduler instance type
+ */
+typedef struct
+{
+    const tTaskSchedTask * pTasks_m;    /**< Table of the scheduled tasks */
+    UINT8 taskCount_m;                  /**< Number of tasks in the table */
+    UINT8 nextTask_m;                   /**< Task which starts the rotation in the next cycle */
+    tTaskSchedGetTime pfnGetTime_m;     /**< Microsecond time base */
+    tTaskSchedStatistics stat_m;        /**< Statistics of the scheduler */
+} tTaskSchedInstance;
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tTaskSchedInstance taskSchedInstance_l SAFE_INIT_SEKTOR;
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static BOOLEAN runTask(UINT8 taskIdx_p, UINT32 * pCurrTime_p);
+static BOOLEAN fitsIntoBudget(UINT8 taskIdx_p, UINT32 currTime_p, UINT32 budgetEnd_p);
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Initialize the task scheduler
+
+\param[in] pInitParam_p    Pointer to the init parameters
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN tasksched_init(const tTaskSchedInit * pInitParam_p)
+{
+    BOOLEAN fReturn = FALSE;
+
+    MEMSET(&taskSchedInstance_l, 0, sizeof(tTaskSchedInstance));
+
+    if(pInitParam_p != NULL                             &&
+       pInitParam_p->pTasks_m != NULL                   &&
+       pInitParam_p->taskCount_m > 0                    &&
+       pInitParam_p->taskCount_m <= TASKSCHED_MAX_TASKS &&
+       pInitParam_p->pfnGetTime_m != NULL                )
+    {
+        taskSchedInstance_l.pTasks_m = pInitParam_p->pTasks_m;
+        taskSchedInstance_l.taskCount_m = pInitParam_p->taskCount_m;
+        taskSchedInstance_l.pfnGetTime_m = pInitParam_p->pfnGetTime_m;
+
+        fReturn = TRUE;
+    }
+    else
+    {
+        errh_postFatalError(kErrSourcePeriph, kErrorInvalidParameter, 0);
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Close the task scheduler
+*/
+/*----------------------------------------------------------------------------*/
+void tasksched_exit(void)
+{
+    MEMSET(&taskSchedInstance_l, 0, sizeof(tTaskSchedInstance));
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Run the tasks of the current cycle
+
+The budget ends TASKSCHED_BUDGET_PERCENT of the cycle time after the start of
+the cycle. Without a known cycle time only the first task of the rotation is
+run. A task is only started if its estimated execution time fits into the
+remaining budget. If the tasks finish after the end of the cycle a deadline
+miss is reported to the error handler.
+
+\param cycleStart_p     Time base in us of the start of the current cycle
+\param cycleTime_p      The measured cycle time in us (Zero if unknown)
+
+\return TRUE on success; FALSE on error
+*/
+/*----------------------------------------------------------------------------*/
+BOOLEAN tasksched_process(UINT32 cycleStart_p, UINT32 cycleTime_p)
+{
+    BOOLEAN fReturn = TRUE;
+    BOOLEAN fRunAgain = TRUE;
+    UINT32 currTime = taskSchedInstance_l.pfnGetTime_m();
+    UINT32 budgetEnd = currTime;
+    UINT32 deadline = 0;
+    UINT16 runCnt = 0;
+    UINT8 firstTask = taskSchedInstance_l.nextTask_m;
+    UINT8 taskIdx;
+    UINT8 i;
+    const tTaskSchedTask * pTask;
+
+    if(cycleTime_p > 0)
+    {
+        budgetEnd = cycleStart_p + ((cycleTime_p * TASKSCHED_BUDGET_PERCENT) / 100);
+        deadline = cycleStart_p + cycleTime_p;
+    }
+
+    /* Move the start of the rotation to give every task the first place */
+    taskSchedInstance_l.nextTask_m = (UINT8)((firstTask + 1) % taskSchedInstance_l.taskCount_m);
+
+    /* First pass: Each task once if it fits */
+    for(i = 0; i < taskSchedInstance_l.taskCount_m && fReturn != FALSE; i++)
+    {
+        taskIdx = (UINT8)((firstTask + i) % taskSchedInstance_l.taskCount_m);
+
+        if(runCnt == 0 || fitsIntoBudget(taskIdx, currTime, budgetEnd))
+        {
+            fReturn = runTask(taskIdx, &currTime);
+            runCnt++;
+        }
+        else
+        {
+            taskSchedInstance_l.stat_m.task_m[taskIdx].skipCnt_m++;
+        }
+    }
+
+    /* Further passes: Tasks with pending work use the rest of the budget */
+    while(fRunAgain != FALSE && fReturn != FALSE)
+    {
+        fRunAgain = FALSE;
+
+        for(i = 0; i < taskSchedInstance_l.taskCount_m && fReturn != FALSE; i++)
+        {
+            taskIdx = (UINT8)((firstTask + i) % taskSchedInstance_l.taskCount_m);
+            pTask = &taskSchedInstance_l.pTasks_m[taskIdx];
+
+            if(runCnt < TASKSCHED_MAX_RUNS                      &&
+               pTask->pfnPending_m != NULL                      &&
+               fitsIntoBudget(taskIdx, currTime, budgetEnd)     &&
+               pTask->pfnPending_m() != FALSE                    )
+            {
+                fReturn = runTask(taskIdx, &currTime);
+                runCnt++;
+                fRunAgain = TRUE;
+            }
+        }
+    }
+
+    taskSchedInstance_l.stat_m.cycleCnt_m++;
+    if(runCnt > taskSchedInstance_l.stat_m.runsPerCycleMax_m)
+    {
+        taskSchedInstance_l.stat_m.runsPerCycleMax_m = runCnt;
+    }
+
+    if(cycleTime_p > 0)
+    {
+        if((INT32)(currTime - budgetEnd) > 0)
+        {
+            taskSchedInstance_l.stat_m.budgetOverrunCnt_m++;
+
+            if((INT32)(currTime - deadline) > 0)
+            {
+                /* The sync interrupt of the next cycle is delayed by the tasks */
+                taskSchedInstance_l.stat_m.deadlineMissCnt_m++;
+                errh_postMinorError(kErrSourcePeriph, kErrorTaskDeadlineMissed, currTime - deadline);
+            }
+        }
+        else
+        {
+            taskSchedInstance_l.stat_m.idleTimeSum_m += budgetEnd - currTime;
+        }
+    }
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the statistics of the task scheduler
+
+\param[out] pStat_p     Pointer to the statistics
+*/
+/*----------------------------------------------------------------------------*/
+void tasksched_getStatistics(tTaskSchedStatistics * pStat_p)
+{
+    if(pStat_p != NULL)
+    {
+        MEMCOPY(pStat_p, &taskSchedInstance_l.stat_m, sizeof(tTaskSchedStatistics));
+    }
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Run a task and measure its execution time
+
+The cost estimate of the task follows a longer execution time at once and a
+shorter one slowly. This keeps rare long runs in the budget.
+
+\param taskIdx_p            Index of the task in the task table
+\param[inout] pCurrTime_p   Time before the task, returns the time after the task
+
+\return The return value of the task
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN runTask(UINT8 taskIdx_p, UINT32 * pCurrTime_p)
+{
+    BOOLEAN fReturn;
+    UINT32 endTime;
+    UINT32 execTime;
+    tTaskSchedTaskStat * pStat = &taskSchedInstance_l.stat_m.task_m[taskIdx_p];
+
+    fReturn = taskSchedInstance_l.pTasks_m[taskIdx_p].pfnTask_m();
+
+    endTime = taskSchedInstance_l.pfnGetTime_m();
+    execTime = endTime - *pCurrTime_p;
+    *pCurrTime_p = endTime;
+
+    if(execTime > pStat->costEst_m)
+    {
+        pStat->costEst_m = execTime;
+    }
+    else
+    {
+        pStat->costEst_m -= (pStat->costEst_m - execTime) >> TASKSCHED_COST_DECAY_SHIFT;
+    }
+
+    if(execTime > pStat->execTimeMax_m)
+    {
+        pStat->execTimeMax_m = execTime;
+    }
+    pStat->execTimeSum_m += execTime;
+    pStat->runCnt_m++;
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Check if a task fits into the remaining budget
+
+\param taskIdx_p        Index of the task in the task table
+\param currTime_p       The current time base in us
+\param budgetEnd_p      Time base in us of the end of the budget
+
+\retval TRUE    The estimated execution time fits
+\retval FALSE   The task would overrun the budget
+*/
+/*----------------------------------------------------------------------------*/
+static BOOLEAN fitsIntoBudget(UINT8 taskIdx_p, UINT32 currTime_p, UINT32 budgetEnd_p)
+{
+    BOOLEAN fFits = FALSE;
+    INT32 remaining = (INT32)(budgetEnd_p - currTime_p);
+
+    if(remaining > 0 &&
+       taskSchedInstance_l.stat_m.task_m[taskIdx_p].costEst_m <= (UINT32)remaining)
+    {
+        fFits = TRUE;
+    }
+
+    return fFits;
+}
+
+/**
+ * \}
+ * \}
+ */
@@ -100,6 +100,7 @@ with the POWERLINK processor. (Target is Altera Nios2)
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
 static tPcpSerialTransferFin pfnTransfFin_l = NULL;
+static tPcpSerialTransferErr pfnTransfErr_l = NULL;
 
 /*----------------------------------------------------------------------------*/
 /* local function prototypes                                                  */
@@ -119,17 +120,20 @@ slave or master mode.
 
 \param pTransParam_p    The transfer parameters (rx/tx base and size)
 \param pfnTransfFin_p   Pointer to the transfer finished interrupt
+\param pfnTransfErr_p   Pointer to the transfer error interrupt
 
 \retval TRUE    On success
 \retval FALSE   Error during initialization
 */
 /*----------------------------------------------------------------------------*/
-BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p)
+BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p,
+                    tPcpSerialTransferErr pfnTransfErr_p)
 {
     UNUSED_PARAMETER(pTransParam_p);
 
     /* No initialization needed for Nios2 (Done in ipcore configuration!) */
     pfnTransfFin_l = pfnTransfFin_p;
+    pfnTransfErr_l = pfnTransfErr_p;
 
     return TRUE;
 }
@@ -142,6 +146,7 @@ BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTran
 void pcpserial_exit(void)
 {
     pfnTransfFin_l = NULL;
+    pfnTransfErr_l = NULL;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -149,7 +154,8 @@ void pcpserial_exit(void)
 \brief  Start an serial transfer
 
 pcpserial_transfer() starts an serial transfer to exchange the process
-image with the PCP.
+image with the PCP. The Avalon SPI master has no DMA, therefore the transfer
+is finished when this function returns.
 
 \param[in] pHandlParam_p       The parameters of the serial transfer handler
 
@@ -189,12 +195,41 @@ BOOL pcpserial_transfer(tHandlerParam* pHandlParam_p)
     {
         /* Call the transfer finished callback function */
         if(pfnTransfFin_l != NULL)
-            pfnTransfFin_l(FALSE);
+            pfnTransfFin_l();
     }
 
     return fReturn;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Check if a serial transfer is running
+
+The transfer is carried out synchronously in pcpserial_transfer().
+
+\retval FALSE       The serial is idle
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserial_isBusy(void)
+{
+    return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the transfer statistics
+
+The transfer is carried out synchronously in pcpserial_transfer(). No start is skipped.
+
+\param pStat_p      Returns the statistics (always zero)
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserial_getStatistics(tPcpSerialStat* pStat_p)
+{
+    pStat_p->skipCnt_m = 0;
+    pStat_p->timeoutCnt_m = 0;
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -60,6 +60,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #define BENCHMARK_SET(x)    HAL_GPIO_WritePin(PINx_BENCHMARK_PORT, (UINT16)(1<<(10 + (x))), GPIO_PIN_SET)
     #define BENCHMARK_RESET(x)  HAL_GPIO_WritePin(PINx_BENCHMARK_PORT, (UINT16)(1<<(10 + (x))), GPIO_PIN_RESET)
     #define BENCHMARK_TOGGLE(x) /* No toggle till now */
+
+    /* The benchmark trace uses the DWT cycle counter of the core */
+    #define BENCHMARK_TRACE_TIMESTAMP()     (DWT->CYCCNT)
+    #define BENCHMARK_TRACE_TICK_HZ         SystemCoreClock
+    #define BENCHMARK_TRACE_TIMER_INIT()                            \
+        do {                                                        \
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;         \
+            DWT->CYCCNT = 0;                                        \
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;                    \
+        } while(0)
 #else
     #undef BENCHMARK_MODULES
     #define BENCHMARK_MODULES           0x00000000
@@ -48,6 +48,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /*----------------------------------------------------------------------------*/
 /* const defines                                                              */
 /*----------------------------------------------------------------------------*/
+/* The slice-by-N CRC tables (up to ~17kB) don't fit into the 20kB RAM */
+#define CRCENGINE_SLICE_LIMIT       0
 
 #if defined(__GNUC__)
 
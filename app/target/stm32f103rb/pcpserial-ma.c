@@ -116,6 +116,11 @@ with the POWERLINK processor. (Target is the stm32f103rb board)
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
 static tPcpSerialTransferFin pfnTransfFin_l = NULL;
+static tPcpSerialTransferErr pfnTransfErr_l = NULL;
+
+static volatile BOOL fTransfActive_l = FALSE;   /**< DMA transfer is running */
+static UINT8 overlapCnt_l = 0;                  /**< Transfer starts skipped due to a running transfer */
+static tPcpSerialStat stat_l;                   /**< Skipped starts and timeouts */
 
 static SPI_HandleTypeDef SpiHandle_l;        /**< SPI handle structure */
 static DMA_HandleTypeDef DmaRxHandle_l;      /**< DMA receive handle structure */
@@ -127,6 +132,7 @@ static void initGpio(void);
 static BOOL initSpi(void);
 static BOOL initDma(SPI_HandleTypeDef* pSpiHandler_p);
 static void initNvic(void);
+static void finishTransfer(void);
 
 /*============================================================================*/
 /*            P U B L I C   F U N C T I O N S                                 */
@@ -142,12 +148,14 @@ slave or master mode.
 
 \param pTransParam_p    The transfer parameters (rx/tx base and size)
 \param pfnTransfFin_p   Pointer to the transfer finished interrupt
+\param pfnTransfErr_p   Pointer to the transfer error and timeout interrupt
 
 \retval TRUE    On success
 \retval FALSE   Error during initialization
 */
 /*----------------------------------------------------------------------------*/
-BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p)
+BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p,
+                    tPcpSerialTransferErr pfnTransfErr_p)
 {
     UINT8 fReturn = FALSE;
     GPIO_InitTypeDef GPIO_InitStruct;
@@ -170,8 +178,14 @@ BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTran
         /* Set NSS high (not active) */
         HAL_GPIO_WritePin(SPIx_SSN_GPIO_PORT, SPIx_SSN_PIN, GPIO_PIN_SET);
 
-        /* Assign transfer finished interrupt callback function */
+        /* Assign transfer finished and error interrupt callback functions */
         pfnTransfFin_l = pfnTransfFin_p;
+        pfnTransfErr_l = pfnTransfErr_p;
+
+        fTransfActive_l = FALSE;
+        overlapCnt_l = 0;
+        stat_l.skipCnt_m = 0;
+        stat_l.timeoutCnt_m = 0;
 
         fReturn = TRUE;
     }
@@ -187,8 +201,13 @@ BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTran
 void pcpserial_exit(void)
 {
     pfnTransfFin_l =  NULL;
+    pfnTransfErr_l =  NULL;
 
-    pfnTransfFin_l =  NULL;
+    if(fTransfActive_l != FALSE)
+    {
+        HAL_SPI_DMAStop(&SpiHandle_l);
+        finishTransfer();
+    }
 
     HAL_GPIO_DeInit(SPIx_SSN_GPIO_PORT, SPIx_SSN_PIN);
 
@@ -199,7 +218,13 @@ void pcpserial_exit(void)
 \brief  Start an serial transfer
 
 pcpserial_transfer() starts an serial transfer to exchange the process
-image with the PCP.
+image with the PCP and returns immediately. The end of the transfer is signaled
+by the transfer finished callback from the DMA interrupt.
+
+If the previous transfer is still running the new transfer is skipped. After
+PCPSERIAL_TIMEOUT_CYCLES skipped transfers the running transfer is aborted,
+the timeout is reported to the transfer error callback and a new transfer
+is started.
 
 \param[in] pHandlParam_p       The parameters of the serial transfer handler
 
@@ -222,26 +247,75 @@ BOOL pcpserial_transfer(tHandlerParam* pHandlParam_p)
             pProdWithInit = pHandlParam_p->prodDesc_m.pBuffBase_m - 4;
             transLen = pHandlParam_p->consDesc_m.buffSize_m + 4;
 
-            /* Wait until SPI is really ready for this transfer */
-            while(HAL_SPI_GetState(&SpiHandle_l) == HAL_SPI_STATE_BUSY_TX_RX)
+            if(fTransfActive_l != FALSE)
             {
-                /* Busy wait here until transfer is finished! */
+                overlapCnt_l++;
+                if(overlapCnt_l >= PCPSERIAL_TIMEOUT_CYCLES)
+                {
+                    /* Transfer is stuck -> Abort it and report the timeout */
+                    HAL_SPI_DMAStop(&SpiHandle_l);
+                    finishTransfer();
+                    stat_l.timeoutCnt_m++;
+
+                    if(pfnTransfErr_l != NULL)
+                        pfnTransfErr_l(kPcpSerialErrorTimeout);
+                }
             }
 
-            /* Set NSS low (active) */
-            HAL_GPIO_WritePin(SPIx_SSN_GPIO_PORT, SPIx_SSN_PIN, GPIO_PIN_RESET);
-
-            /* Enable the DMA rx channel */
-            if(HAL_SPI_TransmitReceive_DMA(&SpiHandle_l, pProdWithInit, pConsWithInit, transLen) == HAL_OK)
+            if(fTransfActive_l != FALSE)
             {
+                /* Previous transfer is still running -> Skip this one */
+                stat_l.skipCnt_m++;
                 retVal = TRUE;
             }
+            else
+            {
+                /* Set NSS low (active) */
+                HAL_GPIO_WritePin(SPIx_SSN_GPIO_PORT, SPIx_SSN_PIN, GPIO_PIN_RESET);
+
+                fTransfActive_l = TRUE;
+
+                /* Enable the DMA rx channel */
+                if(HAL_SPI_TransmitReceive_DMA(&SpiHandle_l, pProdWithInit, pConsWithInit, transLen) == HAL_OK)
+                {
+                    retVal = TRUE;
+                }
+                else
+                {
+                    finishTransfer();
+                }
+            }
         }
     }
 
     return retVal;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Check if a serial transfer is running
+
+\retval TRUE        The transfer is not finished
+\retval FALSE       The serial is idle
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserial_isBusy(void)
+{
+    return fTransfActive_l;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the transfer statistics
+
+\param pStat_p      Returns the number of skipped starts and timeouts
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserial_getStatistics(tPcpSerialStat* pStat_p)
+{
+    *pStat_p = stat_l;
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -426,6 +500,22 @@ static void initNvic(void)
 }
 
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Mark the transfer as finished
+
+Releases the NSS line and clears the transfer state.
+*/
+/*----------------------------------------------------------------------------*/
+static void finishTransfer(void)
+{
+    /* Reset SPI NSS pin */
+    HAL_GPIO_WritePin(SPIx_SSN_GPIO_PORT, SPIx_SSN_PIN, GPIO_PIN_SET);
+
+    overlapCnt_l = 0;
+    fTransfActive_l = FALSE;
+}
+
 /*----------------------------------------------------------------------------*/
 /**
 \brief  TxRx transfer completed callback.
@@ -442,12 +532,11 @@ void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *pSpiHandle_p)
             /* Busy wait here until transfer is finished! */
         }
 
-        /* Reset SPI NSS pin */
-        HAL_GPIO_WritePin(SPIx_SSN_GPIO_PORT, SPIx_SSN_PIN, GPIO_PIN_SET);
+        finishTransfer();
 
         /* Call transfer finished callback function */
         if(pfnTransfFin_l != NULL)
-            pfnTransfFin_l(FALSE);
+            pfnTransfFin_l();
     }
 }
 
@@ -463,9 +552,11 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *pSpiHandle_p)
 {
     if(pSpiHandle_p == &SpiHandle_l)
     {
-         /* Call transfer finished callback function */
-         if(pfnTransfFin_l != NULL)
-             pfnTransfFin_l(TRUE);
+        finishTransfer();
+
+        /* Call transfer error callback function */
+        if(pfnTransfErr_l != NULL)
+            pfnTransfErr_l(kPcpSerialErrorTransfer);
     }
 }
 
@@ -109,6 +109,7 @@ with the POWERLINK processor. (Target is the stm32f401re board)
 /* local vars                                                                 */
 /*----------------------------------------------------------------------------*/
 static tPcpSerialTransferFin pfnTransfFin_l = NULL;
+static tPcpSerialTransferErr pfnTransfErr_l = NULL;
 
 static SPI_HandleTypeDef SpiHandle_l;           /**< SPI handle structure */
 static DMA_HandleTypeDef DmaRxHandle_l;         /**< DMA receive handle structure */
@@ -139,12 +140,14 @@ slave or master mode.
 
 \param pTransParam_p    The transfer parameters (rx/tx base and size)
 \param pfnTransfFin_p   Pointer to the transfer finished interrupt
+\param pfnTransfErr_p   Pointer to the transfer error interrupt
 
 \retval TRUE    On success
 \retval FALSE   Error during initialization
 */
 /*----------------------------------------------------------------------------*/
-BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p)
+BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p,
+                    tPcpSerialTransferErr pfnTransfErr_p)
 {
     UINT8 fReturn = FALSE;
 
@@ -154,8 +157,9 @@ BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTran
         {
             initNvic();
 
-            /* Assign transfer finished interrupt callback function */
+            /* Assign transfer finished and error interrupt callback functions */
             pfnTransfFin_l = pfnTransfFin_p;
+            pfnTransfErr_l = pfnTransfErr_p;
 
             memcpy(&TransParam_l, pTransParam_p, sizeof(tHandlerParam));
 
@@ -178,6 +182,7 @@ BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTran
 void pcpserial_exit(void)
 {
     pfnTransfFin_l =  NULL;
+    pfnTransfErr_l =  NULL;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -185,7 +190,8 @@ void pcpserial_exit(void)
 \brief  Start an serial transfer
 
 pcpserial_transfer() starts an serial transfer to exchange the process
-image with the PCP.
+image with the PCP. In slave mode the transfer is started by the PCP and the
+receive transfer is always armed, therefore nothing needs to be done here.
 
 \param[in] pHandlParam_p       The parameters of the serial transfer handler
 
@@ -200,6 +206,35 @@ BOOL pcpserial_transfer(tHandlerParam* pHandlParam_p)
     return TRUE;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Check if a serial transfer is running
+
+In slave mode the application never starts a transfer on its own.
+
+\retval FALSE       The serial is idle
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserial_isBusy(void)
+{
+    return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the transfer statistics
+
+In slave mode the application never starts a transfer on its own. No start is skipped.
+
+\param pStat_p      Returns the statistics (always zero)
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserial_getStatistics(tPcpSerialStat* pStat_p)
+{
+    pStat_p->skipCnt_m = 0;
+    pStat_p->timeoutCnt_m = 0;
+}
+
 /*============================================================================*/
 /*            P R I V A T E   F U N C T I O N S                               */
 /*============================================================================*/
@@ -416,13 +451,13 @@ void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *pSpiHandle_p)
 
         /* Call transfer finished callback function */
         if(pfnTransfFin_l != NULL)
-            pfnTransfFin_l(FALSE);
+            pfnTransfFin_l();
 
         /* Start the next receive transfer */
         if(receiveInputStream(pSpiHandle_p, &TransParam_l) == FALSE)
         {
-            if(pfnTransfFin_l != NULL)
-                pfnTransfFin_l(TRUE);
+            if(pfnTransfErr_l != NULL)
+                pfnTransfErr_l(kPcpSerialErrorRestart);
         }
 
         (void)dummy;
@@ -440,9 +475,9 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *pSpiHandle_p)
 {
     if(pSpiHandle_p == &SpiHandle_l)
     {
-         /* Call transfer finished callback function */
-         if(pfnTransfFin_l != NULL)
-             pfnTransfFin_l(TRUE);
+         /* Call transfer error callback function */
+         if(pfnTransfErr_l != NULL)
+             pfnTransfErr_l(kPcpSerialErrorTransfer);
     }
 }
 
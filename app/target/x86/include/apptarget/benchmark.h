@@ -0,0 +1,92 @@
+/**
+********************************************************************************
+\file   x86/include/apptarget/benchmark.h
+
+\brief  Header file for debugging. Provides the time base of the benchmark trace
+
+The x86 target has no benchmark pins. The benchmark points are only available
+with the RAM trace backend (BENCHMARK_TRACE_ENABLED) which uses the monotonic
+clock of the host as time base.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2013, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_apptarget_benchmark_H_
+#define _INC_apptarget_benchmark_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <apptarget/target.h>
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+#if (defined BENCHMARK_TRACE_ENABLED) && (defined __GNUC__)
+    #include <time.h>
+
+    #define BENCHMARK_TRACE_TIMESTAMP()     x86_getBenchmarkTime()
+    #define BENCHMARK_TRACE_TICK_HZ         1000000000UL
+    #define BENCHMARK_TRACE_TIMER_INIT()
+#else
+    #undef BENCHMARK_TRACE_ENABLED
+    #undef BENCHMARK_MODULES
+    #define BENCHMARK_MODULES           0x00000000
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+
+#ifdef BENCHMARK_TRACE_ENABLED
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief    Get the time stamp of a benchmark trace event
+
+\return Monotonic time in nanoseconds (wraps every 4.29 seconds)
+*/
+/*----------------------------------------------------------------------------*/
+static inline UINT32 x86_getBenchmarkTime(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (UINT32)(((UINT64)now.tv_sec * 1000000000ULL) + (UINT64)now.tv_nsec);
+}
+
+#endif /* #ifdef BENCHMARK_TRACE_ENABLED */
+
+#endif /* _INC_apptarget_benchmark_H_ */
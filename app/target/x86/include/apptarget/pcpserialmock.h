@@ -0,0 +1,93 @@
+/**
+********************************************************************************
+\file   x86/include/apptarget/pcpserialmock.h
+
+\brief  Control interface of the host PCP serial mock
+
+The x86 target provides a mock of the PCP serial (target/x86/pcpserial-mock.c).
+The transfer is carried out by a thread which simulates the DMA with a
+configurable latency. This allows to test the non-blocking transfer API and to
+measure the CPU time which is freed by the background transfer on the host.
+
+Tests run the mock on a virtual clock which they advance themselves, the
+transfers are then finished deterministically without the thread.
+
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+Copyright (c) 2013, B&R Industrial Automation GmbH
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holders nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_apptarget_pcpserialmock_H_
+#define _INC_apptarget_pcpserialmock_H_
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <common/pcpserial.h>
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#ifndef PCPSERIAL_MOCK_IMAGE_SIZE
+  #define PCPSERIAL_MOCK_IMAGE_SIZE     1024    /**< Maximum size of the simulated PCP image */
+#endif
+
+#ifndef PCPSERIAL_MOCK_LATENCY_US
+  #define PCPSERIAL_MOCK_LATENCY_US     100     /**< Default DMA latency of a transfer */
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* typedef                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Statistics of the PCP serial mock
+ */
+typedef struct
+{
+    UINT32  startCnt_m;         /**< Transfers started by pcpserial_transfer() */
+    UINT32  finishCnt_m;        /**< Transfers finished by the simulated DMA */
+    UINT32  skipCnt_m;          /**< Transfer starts skipped due to a running transfer */
+    UINT32  timeoutCnt_m;       /**< Transfers aborted due to a timeout */
+    UINT32  errorCnt_m;         /**< Transfers finished with an injected error */
+    UINT64  startTimeNs_m;      /**< Time spent in pcpserial_transfer() */
+    UINT64  dmaTimeNs_m;        /**< Time the transfers ran in the background */
+} tPcpSerialMockStat;
+
+/*----------------------------------------------------------------------------*/
+/* function prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_setLatency(UINT32 latencyUs_p);
+void pcpserialmock_injectError(UINT32 errorCnt_p);
+void pcpserialmock_setPcpImage(const UINT8* pData_p, UINT16 size_p);
+UINT16 pcpserialmock_getPcpImage(UINT8* pData_p, UINT16 size_p);
+BOOL pcpserialmock_waitIdle(UINT32 timeoutUs_p);
+void pcpserialmock_getStatistics(tPcpSerialMockStat* pStat_p);
+void pcpserialmock_useVirtualClock(BOOL fEnable_p);
+void pcpserialmock_advanceTime(UINT32 timeUs_p);
+
+#endif /* _INC_apptarget_pcpserialmock_H_ */
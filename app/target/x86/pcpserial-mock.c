@@ -0,0 +1,757 @@
+/**
+********************************************************************************
+\file   target/x86/pcpserial-mock.c
+
+\defgroup module_targ_x86_serial_mock PCP serial mock (Linux host)
+\{
+
+\brief  Implements a host mock of the serial device in master mode
+
+Simulates the serial which interconnects the app with the POWERLINK processor
+on a Linux host. A thread takes the place of the DMA: the transfer started by
+pcpserial_transfer() finishes after a configurable latency and the transfer
+finished callback is called from the thread like from the DMA interrupt on
+the target. The producing image is copied to a simulated PCP image and the
+consuming image is filled from it.
+
+For repeatable tests the mock runs on a virtual clock instead
+(pcpserialmock_useVirtualClock()). No thread is started, the caller advances
+the time with pcpserialmock_advanceTime() and a transfer which is due is
+finished within this call.
+
+\ingroup group_app_targ_x86
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* includes                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <common/pcpserial.h>
+#include <apptarget/pcpserialmock.h>
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+/*============================================================================*/
+/*            G L O B A L   D E F I N I T I O N S                             */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* module global vars                                                         */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* global function prototypes                                                 */
+/*----------------------------------------------------------------------------*/
+
+/*============================================================================*/
+/*            P R I V A T E   D E F I N I T I O N S                           */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/* const defines                                                              */
+/*----------------------------------------------------------------------------*/
+#define NSEC_PER_SEC            1000000000ULL
+#define NSEC_PER_USEC           1000ULL
+
+/*----------------------------------------------------------------------------*/
+/* local types                                                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * \brief Instance of the PCP serial mock
+ */
+typedef struct
+{
+    pthread_t               dmaThread_m;        /**< Thread which simulates the DMA */
+    pthread_mutex_t         mutex_m;            /**< Protects the instance */
+    pthread_cond_t          cond_m;             /**< Signals transfer start, end and shutdown */
+    BOOL                    fCondInit_m;        /**< The condition uses the monotonic clock */
+    BOOL                    fRunning_m;         /**< The serial is initialized */
+    BOOL                    fThread_m;          /**< The DMA thread is running */
+    BOOL                    fVirtualClock_m;    /**< Time is advanced by the caller, no DMA thread */
+    UINT64                  virtualTime_m;      /**< Time of the virtual clock in ns */
+
+    tPcpSerialTransferFin   pfnTransfFin_m;     /**< Transfer finished callback */
+    tPcpSerialTransferErr   pfnTransfErr_m;     /**< Transfer error callback */
+
+    BOOL                    fTransfActive_m;    /**< Simulated DMA transfer is running */
+    UINT32                  transfId_m;         /**< Id of the current transfer (changes on abort) */
+    UINT8                   overlapCnt_m;       /**< Transfer starts skipped due to a running transfer */
+    UINT64                  startTime_m;        /**< Start time of the current transfer */
+    UINT64                  endTime_m;          /**< Simulated end time of the current transfer */
+    tHandlerParam           transParam_m;       /**< Buffers of the current transfer */
+
+    UINT32                  latencyUs_m;        /**< Simulated DMA latency */
+    UINT32                  errorCnt_m;         /**< Number of transfers to fail */
+
+    UINT8                   pcpImage_m[PCPSERIAL_MOCK_IMAGE_SIZE];  /**< Image sent by the PCP */
+    UINT16                  pcpImageSize_m;                         /**< Valid size of the PCP image */
+    UINT8                   appImage_m[PCPSERIAL_MOCK_IMAGE_SIZE];  /**< Image received by the PCP */
+    UINT16                  appImageSize_m;                         /**< Valid size of the received image */
+
+    tPcpSerialMockStat      stat_m;             /**< Transfer statistics */
+} tPcpSerialMockInstance;
+
+/*----------------------------------------------------------------------------*/
+/* local vars                                                                 */
+/*----------------------------------------------------------------------------*/
+static tPcpSerialMockInstance mockInstance_l =
+{
+    .mutex_m = PTHREAD_MUTEX_INITIALIZER,
+    .latencyUs_m = PCPSERIAL_MOCK_LATENCY_US,
+};
+
+/*----------------------------------------------------------------------------*/
+/* local function prototypes                                                  */
+/*----------------------------------------------------------------------------*/
+static UINT64 getTimeNs(void);
+static void toTimespec(UINT64 timeNs_p, struct timespec* pTime_p);
+static void* dmaThread(void* pArg_p);
+static void finishTransfer(tPcpSerialTransferFin* ppfnFin_p, tPcpSerialTransferErr* ppfnErr_p);
+static void advanceClock(UINT64 timeNs_p);
+
+/*============================================================================*/
+/*            P U B L I C   F U N C T I O N S                                 */
+/*============================================================================*/
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Initialize the PCP serial
+
+Starts the thread which simulates the DMA of the serial (not with the virtual
+clock).
+
+\param pTransParam_p    The transfer parameters (rx/tx base and size)
+\param pfnTransfFin_p   Pointer to the transfer finished interrupt
+\param pfnTransfErr_p   Pointer to the transfer error and timeout interrupt
+
+\retval TRUE    On success
+\retval FALSE   Error during initialization
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserial_init(tHandlerParam * pTransParam_p, tPcpSerialTransferFin pfnTransfFin_p,
+                    tPcpSerialTransferErr pfnTransfErr_p)
+{
+    BOOL fReturn = FALSE;
+    pthread_condattr_t condAttr;
+
+    UNUSED_PARAMETER(pTransParam_p);
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    if(mockInstance_l.fCondInit_m == FALSE)
+    {
+        /* All timeouts are based on the monotonic clock */
+        pthread_condattr_init(&condAttr);
+        pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+        if(pthread_cond_init(&mockInstance_l.cond_m, &condAttr) == 0)
+        {
+            mockInstance_l.fCondInit_m = TRUE;
+        }
+        pthread_condattr_destroy(&condAttr);
+    }
+
+    if(mockInstance_l.fCondInit_m != FALSE && mockInstance_l.fRunning_m == FALSE)
+    {
+        mockInstance_l.pfnTransfFin_m = pfnTransfFin_p;
+        mockInstance_l.pfnTransfErr_m = pfnTransfErr_p;
+        mockInstance_l.fTransfActive_m = FALSE;
+        mockInstance_l.overlapCnt_m = 0;
+        memset(&mockInstance_l.stat_m, 0, sizeof(mockInstance_l.stat_m));
+
+        mockInstance_l.fRunning_m = TRUE;
+        if(mockInstance_l.fVirtualClock_m != FALSE)
+        {
+            fReturn = TRUE;
+        }
+        else if(pthread_create(&mockInstance_l.dmaThread_m, NULL, dmaThread, NULL) == 0)
+        {
+            mockInstance_l.fThread_m = TRUE;
+            fReturn = TRUE;
+        }
+        else
+        {
+            mockInstance_l.fRunning_m = FALSE;
+        }
+    }
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    return fReturn;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Close the serial device
+
+A running transfer is dropped without calling the callback functions.
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserial_exit(void)
+{
+    BOOL fJoin = FALSE;
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    mockInstance_l.pfnTransfFin_m = NULL;
+    mockInstance_l.pfnTransfErr_m = NULL;
+
+    if(mockInstance_l.fRunning_m != FALSE)
+    {
+        mockInstance_l.fRunning_m = FALSE;
+        mockInstance_l.fTransfActive_m = FALSE;
+        pthread_cond_broadcast(&mockInstance_l.cond_m);
+        fJoin = mockInstance_l.fThread_m;
+        mockInstance_l.fThread_m = FALSE;
+    }
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    if(fJoin != FALSE)
+    {
+        pthread_join(mockInstance_l.dmaThread_m, NULL);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Start an serial transfer
+
+pcpserial_transfer() starts the simulated DMA transfer and returns immediately.
+The transfer finished callback is called from the DMA thread (or from
+pcpserialmock_advanceTime()) after the configured latency.
+
+If the previous transfer is still running the new transfer is skipped. After
+PCPSERIAL_TIMEOUT_CYCLES skipped transfers the running transfer is aborted,
+the timeout is reported to the transfer error callback and a new transfer
+is started.
+
+\param[in] pHandlParam_p       The parameters of the serial transfer handler
+
+\retval TRUE        On success
+\retval FALSE       Error on sending or receiving
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserial_transfer(tHandlerParam* pHandlParam_p)
+{
+    BOOL retVal = FALSE;
+    UINT64 entryTime = getTimeNs();
+    tPcpSerialTransferErr pfnTimeout = NULL;
+
+    if(pHandlParam_p != NULL)
+    {
+        if(pHandlParam_p->consDesc_m.buffSize_m == pHandlParam_p->prodDesc_m.buffSize_m &&
+           pHandlParam_p->consDesc_m.buffSize_m <= PCPSERIAL_MOCK_IMAGE_SIZE)
+        {
+            pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+            if(mockInstance_l.fTransfActive_m != FALSE)
+            {
+                mockInstance_l.overlapCnt_m++;
+                if(mockInstance_l.overlapCnt_m >= PCPSERIAL_TIMEOUT_CYCLES)
+                {
+                    /* Transfer is stuck -> Abort it and report the timeout */
+                    mockInstance_l.fTransfActive_m = FALSE;
+                    mockInstance_l.overlapCnt_m = 0;
+                    mockInstance_l.stat_m.timeoutCnt_m++;
+                    pfnTimeout = mockInstance_l.pfnTransfErr_m;
+                }
+                else
+                {
+                    /* Previous transfer is still running -> Skip this one */
+                    mockInstance_l.stat_m.skipCnt_m++;
+                }
+            }
+
+            pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+            if(pfnTimeout != NULL)
+                pfnTimeout(kPcpSerialErrorTimeout);
+
+            pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+            if(mockInstance_l.fTransfActive_m != FALSE)
+            {
+                retVal = TRUE;
+            }
+            else if(mockInstance_l.fRunning_m != FALSE)
+            {
+                mockInstance_l.transParam_m = *pHandlParam_p;
+                mockInstance_l.transfId_m++;
+                mockInstance_l.startTime_m = getTimeNs();
+                mockInstance_l.endTime_m = mockInstance_l.startTime_m +
+                        ((UINT64)mockInstance_l.latencyUs_m * NSEC_PER_USEC);
+                mockInstance_l.fTransfActive_m = TRUE;
+                mockInstance_l.stat_m.startCnt_m++;
+
+                pthread_cond_broadcast(&mockInstance_l.cond_m);
+
+                retVal = TRUE;
+            }
+
+            mockInstance_l.stat_m.startTimeNs_m += getTimeNs() - entryTime;
+
+            pthread_mutex_unlock(&mockInstance_l.mutex_m);
+        }
+    }
+
+    return retVal;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Check if a serial transfer is running
+
+\retval TRUE        The transfer is not finished
+\retval FALSE       The serial is idle
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserial_isBusy(void)
+{
+    BOOL fBusy;
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+    fBusy = mockInstance_l.fTransfActive_m;
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    return fBusy;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the transfer statistics
+
+\param pStat_p      Returns the number of skipped starts and timeouts
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserial_getStatistics(tPcpSerialStat* pStat_p)
+{
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+    pStat_p->skipCnt_m = mockInstance_l.stat_m.skipCnt_m;
+    pStat_p->timeoutCnt_m = mockInstance_l.stat_m.timeoutCnt_m;
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Set the latency of the simulated DMA
+
+The latency is applied to all transfers started afterwards. Set it above the
+cycle time to provoke overlapping transfers and timeouts.
+
+\param latencyUs_p      Time from the start to the end of a transfer in us
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_setLatency(UINT32 latencyUs_p)
+{
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+    mockInstance_l.latencyUs_m = latencyUs_p;
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Let the next transfers fail
+
+The transfers are finished with the transfer error callback instead of the
+transfer finished callback. The images are not exchanged.
+
+\param errorCnt_p       Number of transfers to fail
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_injectError(UINT32 errorCnt_p)
+{
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+    mockInstance_l.errorCnt_m = errorCnt_p;
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Set the image the simulated PCP sends
+
+The image is copied to the consuming buffer with every transfer.
+
+\param pData_p      Image data
+\param size_p       Size of the image (limited to PCPSERIAL_MOCK_IMAGE_SIZE)
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_setPcpImage(const UINT8* pData_p, UINT16 size_p)
+{
+    if(size_p > PCPSERIAL_MOCK_IMAGE_SIZE)
+        size_p = PCPSERIAL_MOCK_IMAGE_SIZE;
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+    memcpy(mockInstance_l.pcpImage_m, pData_p, size_p);
+    mockInstance_l.pcpImageSize_m = size_p;
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the image the simulated PCP received with the last transfer
+
+\param pData_p      Buffer for the image data
+\param size_p       Size of the buffer
+
+\return Number of bytes copied to the buffer
+*/
+/*----------------------------------------------------------------------------*/
+UINT16 pcpserialmock_getPcpImage(UINT8* pData_p, UINT16 size_p)
+{
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    if(size_p > mockInstance_l.appImageSize_m)
+        size_p = mockInstance_l.appImageSize_m;
+
+    memcpy(pData_p, mockInstance_l.appImage_m, size_p);
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    return size_p;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Run the mock on a virtual clock
+
+Has to be called before pcpserial_init(). Without the DMA thread the
+transfers only progress with pcpserialmock_advanceTime(), the results do not
+depend on the scheduling of the host. The virtual clock starts at 0.
+
+\param fEnable_p        TRUE to use the virtual clock, FALSE for the thread
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_useVirtualClock(BOOL fEnable_p)
+{
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    if(mockInstance_l.fRunning_m == FALSE)
+    {
+        mockInstance_l.fVirtualClock_m = fEnable_p;
+        mockInstance_l.virtualTime_m = 0;
+    }
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Advance the virtual clock
+
+A transfer which ends within the time is finished and its callback is called
+before the function returns, like the DMA interrupt between two cycles.
+
+\param timeUs_p         Time to advance in us
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_advanceTime(UINT32 timeUs_p)
+{
+    advanceClock((UINT64)timeUs_p * NSEC_PER_USEC);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Wait until the running transfer is finished
+
+With the virtual clock the time is advanced up to the end of the transfer
+instead of waiting.
+
+\param timeoutUs_p      Maximum time to wait in us
+
+\retval TRUE        The serial is idle
+\retval FALSE       The transfer is still running
+*/
+/*----------------------------------------------------------------------------*/
+BOOL pcpserialmock_waitIdle(UINT32 timeoutUs_p)
+{
+    BOOL fIdle;
+    struct timespec deadline;
+    UINT64 timeoutNs = (UINT64)timeoutUs_p * NSEC_PER_USEC;
+    UINT64 remainNs;
+
+    if(mockInstance_l.fVirtualClock_m != FALSE)
+    {
+        pthread_mutex_lock(&mockInstance_l.mutex_m);
+        remainNs = (mockInstance_l.fTransfActive_m != FALSE &&
+                    mockInstance_l.endTime_m > mockInstance_l.virtualTime_m) ?
+                   mockInstance_l.endTime_m - mockInstance_l.virtualTime_m : 0;
+        pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+        advanceClock((remainNs < timeoutNs) ? remainNs : timeoutNs);
+
+        return (pcpserial_isBusy() == FALSE);
+    }
+
+    toTimespec(getTimeNs() + timeoutNs, &deadline);
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    while(mockInstance_l.fTransfActive_m != FALSE)
+    {
+        if(pthread_cond_timedwait(&mockInstance_l.cond_m, &mockInstance_l.mutex_m,
+                                  &deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+
+    fIdle = (mockInstance_l.fTransfActive_m == FALSE);
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    return fIdle;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the transfer statistics
+
+startTimeNs_m is the CPU time the caller spent to start the transfers, while
+dmaTimeNs_m is the time the transfers ran in the background. The difference
+is the time a blocking transfer would have consumed additionally.
+
+\param pStat_p      Returns the statistics
+*/
+/*----------------------------------------------------------------------------*/
+void pcpserialmock_getStatistics(tPcpSerialMockStat* pStat_p)
+{
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+    *pStat_p = mockInstance_l.stat_m;
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+}
+
+/*============================================================================*/
+/*            P R I V A T E   F U N C T I O N S                               */
+/*============================================================================*/
+/** \name Private Functions */
+/** \{ */
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Get the time of the monotonic or the virtual clock
+
+\return Time in ns
+*/
+/*----------------------------------------------------------------------------*/
+static UINT64 getTimeNs(void)
+{
+    struct timespec now;
+
+    if(mockInstance_l.fVirtualClock_m != FALSE)
+        return mockInstance_l.virtualTime_m;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((UINT64)now.tv_sec * NSEC_PER_SEC) + (UINT64)now.tv_nsec;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Convert a time of the monotonic clock to an absolute timeout
+
+\param timeNs_p     Time in ns
+\param pTime_p      Returns the absolute timeout
+*/
+/*----------------------------------------------------------------------------*/
+static void toTimespec(UINT64 timeNs_p, struct timespec* pTime_p)
+{
+    pTime_p->tv_sec = (time_t)(timeNs_p / NSEC_PER_SEC);
+    pTime_p->tv_nsec = (long)(timeNs_p % NSEC_PER_SEC);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Simulated DMA of the serial
+
+Waits for the end time of the running transfer, exchanges the images and
+calls the transfer finished or error callback like the DMA interrupt.
+
+\param pArg_p       Unused thread argument
+
+\return Always NULL
+*/
+/*----------------------------------------------------------------------------*/
+static void* dmaThread(void* pArg_p)
+{
+    tPcpSerialTransferFin pfnFin;
+    tPcpSerialTransferErr pfnErr;
+    struct timespec deadline;
+    UINT32 transfId;
+
+    UNUSED_PARAMETER(pArg_p);
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    while(mockInstance_l.fRunning_m != FALSE)
+    {
+        if(mockInstance_l.fTransfActive_m == FALSE)
+        {
+            pthread_cond_wait(&mockInstance_l.cond_m, &mockInstance_l.mutex_m);
+            continue;
+        }
+
+        /* Wait for the end of the transfer (or its abort) */
+        transfId = mockInstance_l.transfId_m;
+        toTimespec(mockInstance_l.endTime_m, &deadline);
+        if(pthread_cond_timedwait(&mockInstance_l.cond_m, &mockInstance_l.mutex_m,
+                                  &deadline) != ETIMEDOUT)
+        {
+            continue;
+        }
+
+        if(mockInstance_l.fTransfActive_m == FALSE || transfId != mockInstance_l.transfId_m)
+        {
+            /* Aborted (or restarted) while waiting */
+            continue;
+        }
+
+        finishTransfer(&pfnFin, &pfnErr);
+
+        /* Call the callbacks without the lock like from the DMA interrupt */
+        pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+        if(pfnFin != NULL)
+            pfnFin();
+
+        if(pfnErr != NULL)
+            pfnErr(kPcpSerialErrorTransfer);
+
+        pthread_mutex_lock(&mockInstance_l.mutex_m);
+    }
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Finish the running transfer
+
+Exchanges the images or counts the injected error. The caller holds the lock
+and calls the returned callback after releasing it.
+
+\param ppfnFin_p        Returns the transfer finished callback to call
+\param ppfnErr_p        Returns the transfer error callback to call
+*/
+/*----------------------------------------------------------------------------*/
+static void finishTransfer(tPcpSerialTransferFin* ppfnFin_p, tPcpSerialTransferErr* ppfnErr_p)
+{
+    tHandlerParam* pParam = &mockInstance_l.transParam_m;
+    UINT16 size;
+
+    *ppfnFin_p = NULL;
+    *ppfnErr_p = NULL;
+
+    if(mockInstance_l.errorCnt_m > 0)
+    {
+        mockInstance_l.errorCnt_m--;
+        mockInstance_l.stat_m.errorCnt_m++;
+        *ppfnErr_p = mockInstance_l.pfnTransfErr_m;
+    }
+    else
+    {
+        /* Exchange the images */
+        size = pParam->prodDesc_m.buffSize_m;
+        memcpy(mockInstance_l.appImage_m, pParam->prodDesc_m.pBuffBase_m, size);
+        mockInstance_l.appImageSize_m = size;
+
+        if(size > mockInstance_l.pcpImageSize_m)
+            size = mockInstance_l.pcpImageSize_m;
+
+        memcpy(pParam->consDesc_m.pBuffBase_m, mockInstance_l.pcpImage_m, size);
+
+        mockInstance_l.stat_m.finishCnt_m++;
+        *ppfnFin_p = mockInstance_l.pfnTransfFin_m;
+    }
+
+    mockInstance_l.stat_m.dmaTimeNs_m += getTimeNs() - mockInstance_l.startTime_m;
+    mockInstance_l.overlapCnt_m = 0;
+    mockInstance_l.fTransfActive_m = FALSE;
+    pthread_cond_broadcast(&mockInstance_l.cond_m);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+\brief  Advance the virtual clock and finish a transfer which is due
+
+\param timeNs_p         Time to advance in ns
+*/
+/*----------------------------------------------------------------------------*/
+static void advanceClock(UINT64 timeNs_p)
+{
+    tPcpSerialTransferFin pfnFin = NULL;
+    tPcpSerialTransferErr pfnErr = NULL;
+    UINT64 endTime;
+
+    pthread_mutex_lock(&mockInstance_l.mutex_m);
+
+    if(mockInstance_l.fVirtualClock_m != FALSE)
+    {
+        endTime = mockInstance_l.virtualTime_m + timeNs_p;
+
+        if(mockInstance_l.fTransfActive_m != FALSE &&
+           mockInstance_l.endTime_m <= endTime)
+        {
+            /* Finish the transfer at its end time */
+            if(mockInstance_l.endTime_m > mockInstance_l.virtualTime_m)
+                mockInstance_l.virtualTime_m = mockInstance_l.endTime_m;
+
+            finishTransfer(&pfnFin, &pfnErr);
+        }
+
+        mockInstance_l.virtualTime_m = endTime;
+    }
+
+    pthread_mutex_unlock(&mockInstance_l.mutex_m);
+
+    if(pfnFin != NULL)
+        pfnFin();
+
+    if(pfnErr != NULL)
+        pfnErr(kPcpSerialErrorTransfer);
+}
+
+/**
+ * \}
+ * \}
+ */
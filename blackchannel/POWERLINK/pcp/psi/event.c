@@ -49,6 +49,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "event.h"
 #include <psi/obdict.h>
 
+#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_CC)) != 0)
+#include <config/ccobjectlist.h>
+#endif
+
+#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_SSDO)) != 0)
+#include <config/ssdo.h>
+#endif
+
 //============================================================================//
 //            G L O B A L   D E F I N I T I O N S                             //
 //============================================================================//
@@ -77,10 +85,31 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // local types
 //------------------------------------------------------------------------------
 
+/**
+ * \brief Entry of the user OBD access dispatch table
+ */
+typedef struct
+{
+    UINT16              index_m;            ///< Object index handled by the callback
+    tEventObdAccessCb   pfnObdAccessCb_m;   ///< Callback of the owning module
+} tObdAccessEntry;
+
+/**
+ * \brief User OBD access dispatch table
+ *
+ * The entries are kept sorted by object index to allow a binary search.
+ */
+typedef struct
+{
+    tObdAccessEntry     aEntry_m[EVENT_OBD_ACCESS_CB_COUNT];    ///< Sorted callback entries
+    UINT8               entryCount_m;                           ///< Number of used entries
+} tObdAccessTable;
+
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
 static tEventCb pfnEventCb_l = NULL;
+static tObdAccessTable obdAccessTable_l;
 
 //------------------------------------------------------------------------------
 // local function prototypes
@@ -94,6 +123,8 @@ static tOplkError processErrorWarningEvent(const tEventError* pInternalError_p,
 static tOplkError processUserObdAccessEvent(tObdAlConHdl* pParam_p,
                                             void* pUserArg_p);
 
+static tObdAccessEntry* findObdAccessEntry(UINT16 index_p, UINT8* pInsertPos_p);
+
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
 //============================================================================//
@@ -103,7 +134,8 @@ static tOplkError processUserObdAccessEvent(tObdAlConHdl* pParam_p,
 /**
 \brief  Initialize applications event module
 
-The function initializes the applications event module
+The function initializes the applications event module and registers the
+user OBD access callbacks of all integrated slim interface modules.
 
 \param  pfnEventCb_p            User event callback
 
@@ -112,7 +144,96 @@ The function initializes the applications event module
 //------------------------------------------------------------------------------
 void initEvents (tEventCb pfnEventCb_p)
 {
+#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_CC)) != 0)
+    tCcObject   ccObjList[CONF_CHAN_NUM_OBJECTS] = CCOBJECT_LIST_INIT_VECTOR;
+    UINT8       i;
+#endif
+
     pfnEventCb_l = pfnEventCb_p;
+
+    PSI_MEMSET(&obdAccessTable_l, 0, sizeof(tObdAccessTable));
+
+#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_CC)) != 0)
+    // Every index of the configuration channel object list is owned by the cc module
+    for (i = 0; i < CONF_CHAN_NUM_OBJECTS; i++)
+    {
+        if (registerObdAccessCb(ccObjList[i].objIdx, cc_obdAccessCb) != kErrorOk)
+        {
+            PRINTF("ERROR: Unable to register OBD access of object 0x%04X\n",
+                   ccObjList[i].objIdx);
+        }
+    }
+#endif
+
+#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_SSDO)) != 0)
+    if (registerObdAccessCb(SSDO_STUB_DATA_OBJECT_INDEX, rssdo_obdAccessCb) != kErrorOk)
+    {
+        PRINTF("ERROR: Unable to register OBD access of object 0x%04X\n",
+               SSDO_STUB_DATA_OBJECT_INDEX);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Register a user OBD access callback
+
+The function assigns a user specific object access callback to an object
+index. All user OBD access events of this index are then directly routed to
+the given callback. Registering the same callback twice for an index is
+accepted, a different callback for an already registered index is rejected.
+
+\param  index_p                 Object index to register
+\param  pfnObdAccessCb_p        Callback of the module which owns the object
+
+\return The function returns a tOplkError error code.
+\retval kErrorOk                 The callback is registered
+\retval kErrorApiInvalidParam    Invalid callback or index already owned
+\retval kErrorNoResource         The dispatch table is full
+
+\ingroup module_demo_cn_embedded
+*/
+//------------------------------------------------------------------------------
+tOplkError registerObdAccessCb(UINT16 index_p, tEventObdAccessCb pfnObdAccessCb_p)
+{
+    tOplkError          ret = kErrorOk;
+    tObdAccessEntry*    pEntry;
+    UINT8               insertPos;
+    UINT8               i;
+
+    if (pfnObdAccessCb_p == NULL)
+    {
+        ret = kErrorApiInvalidParam;
+        goto Exit;
+    }
+
+    pEntry = findObdAccessEntry(index_p, &insertPos);
+    if (pEntry != NULL)
+    {
+        if (pEntry->pfnObdAccessCb_m != pfnObdAccessCb_p)
+            ret = kErrorApiInvalidParam;
+
+        goto Exit;
+    }
+
+    if (obdAccessTable_l.entryCount_m >= EVENT_OBD_ACCESS_CB_COUNT)
+    {
+        ret = kErrorNoResource;
+        goto Exit;
+    }
+
+    // Shift the higher indices up to keep the table sorted
+    for (i = obdAccessTable_l.entryCount_m; i > insertPos; i--)
+    {
+        obdAccessTable_l.aEntry_m[i] = obdAccessTable_l.aEntry_m[i - 1];
+    }
+
+    obdAccessTable_l.aEntry_m[insertPos].index_m = index_p;
+    obdAccessTable_l.aEntry_m[insertPos].pfnObdAccessCb_m = pfnObdAccessCb_p;
+    obdAccessTable_l.entryCount_m++;
+
+Exit:
+    return ret;
 }
 
 //------------------------------------------------------------------------------
@@ -273,26 +394,64 @@ The function processes user specific non indexed Object access events.
 static tOplkError processUserObdAccessEvent(tObdAlConHdl* pParam_p,
                                             void* pUserArg_p)
 {
-    tOplkError               oplkret = kErrorOk;
+    tOplkError               oplkret = kErrorObdIndexNotExist;
+    tObdAccessEntry*         pEntry;
 
     UNUSED_PARAMETER(pUserArg_p);
 
-    switch (pParam_p->index)
+    pEntry = findObdAccessEntry(pParam_p->index, NULL);
+    if (pEntry != NULL)
+        oplkret = pEntry->pfnObdAccessCb_m(pParam_p);
+
+    return oplkret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Search the user OBD access dispatch table
+
+The function performs a binary search for an object index in the sorted
+dispatch table.
+
+\param  index_p             Object index to search for
+\param  pInsertPos_p        Returns the position where the index would have
+                            to be inserted (may be NULL)
+
+\return The function returns the matching table entry or NULL if the index
+        is not registered.
+*/
+//------------------------------------------------------------------------------
+static tObdAccessEntry* findObdAccessEntry(UINT16 index_p, UINT8* pInsertPos_p)
+{
+    tObdAccessEntry*    pEntry = NULL;
+    UINT8               low = 0;
+    UINT8               high = obdAccessTable_l.entryCount_m;
+    UINT8               mid;
+
+    while (low < high)
     {
-#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_CC)) != 0)
-        case 0x2000:
-            oplkret = cc_obdAccessCb(pParam_p);
+        mid = (UINT8)((low + high) >> 1);
+
+        if (obdAccessTable_l.aEntry_m[mid].index_m < index_p)
+        {
+            low = (UINT8)(mid + 1);
+        }
+        else if (obdAccessTable_l.aEntry_m[mid].index_m > index_p)
+        {
+            high = mid;
+        }
+        else
+        {
+            pEntry = &obdAccessTable_l.aEntry_m[mid];
+            low = mid;
             break;
-#endif
-#if(((PSI_MODULE_INTEGRATION) & (PSI_MODULE_SSDO)) != 0)
-        case 0x2130:
-            oplkret = rssdo_obdAccessCb(pParam_p);
-            break;
-#endif
-        default:
-            oplkret = kErrorObdIndexNotExist;
+        }
     }
-    return oplkret;
+
+    if (pInsertPos_p != NULL)
+        *pInsertPos_p = low;
+
+    return pEntry;
 }
 
 ///\}
@@ -46,6 +46,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#ifndef EVENT_OBD_ACCESS_CB_COUNT
+#define EVENT_OBD_ACCESS_CB_COUNT       8   ///< Size of the user OBD access dispatch table
+#endif
 
 //------------------------------------------------------------------------------
 // typedef
@@ -54,6 +57,8 @@ typedef tOplkError (*tEventCb)(tOplkApiEventType EventType_p,
                                const tOplkApiEventArg* pEventArg_p,
                                void* pUserArg_p);
 
+typedef tOplkError (*tEventObdAccessCb)(tObdAlConHdl* pParam_p);
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -63,6 +68,7 @@ extern "C" {
 #endif
 
 void       initEvents (tEventCb pfnEventCb_p);
+tOplkError registerObdAccessCb(UINT16 index_p, tEventObdAccessCb pfnObdAccessCb_p);
 tOplkError processEvents(tOplkApiEventType EventType_p,
                          const tOplkApiEventArg* pEventArg_p, void* pUserArg_p);
 
@@ -95,13 +95,16 @@ provided from the Virtual Ethernet driver NoOs of openPOWERLINK stack.
 /**
 \brief  Receive buffer descriptor
 
-This structure defines the receive buffer descriptor.
+This structure defines the receive buffer descriptor. The IP stack only knows
+the address of \ref length (ip_packet_typ), the descriptor is recovered from it
+with GET_TYPE_BASE().
 */
-typedef struct
+typedef struct tEdrv2VethRxDesc
 {
-    BOOL            fIpStackOwner;      ///< TRUE if the IP stack owns the buffer
-    ULONG           length;             ///< Payload length
-    UINT8           aBuffer[IP_MTU];    ///< Receive buffer
+    struct tEdrv2VethRxDesc*    pNext;              ///< Next free descriptor
+    BOOL                        fIpStackOwner;      ///< TRUE if the IP stack owns the buffer
+    ULONG                       length;             ///< Payload length
+    UINT8                       aBuffer[IP_MTU + 18];   ///< Receive buffer (Ethernet header, VLAN tag and CRC)
 } tEdrv2VethRxDesc;
 
 /**
@@ -109,10 +112,12 @@ typedef struct
  */
 typedef struct
 {
-    IP_STACK_H              pIpStack;                   ///< Pointer to the IP stack handle.
-    tEdrv2VethRxDesc        aRxBuffer[IP_RX_BUF_CNT];   ///< Edrv2Veth Receive Buffer descriptor.
-    ipState_enum            ipState;                    ///< Current state of the IP Stack.
-    tNmtState               nmtState;                   ///< Current state of the POWERLINK CN.
+    IP_STACK_H              pIpStack;                           ///< Pointer to the IP stack handle.
+    tEdrv2VethRxDesc        aRxBuffer[EDRV2VETH_RX_BUF_CNT];    ///< Edrv2Veth Receive Buffer descriptor.
+    tEdrv2VethRxDesc*       pRxFree;                            ///< List of free receive buffers
+    tEdrv2VethRxStatistics  rxStatistics;                       ///< Receive statistics
+    ipState_enum            ipState;                            ///< Current state of the IP Stack.
+    tNmtState               nmtState;                           ///< Current state of the POWERLINK CN.
 } tEdrv2VethInstance;
 
 //------------------------------------------------------------------------------
@@ -149,9 +154,16 @@ tOplkError edrv2veth_init (eth_addr* pEthMac_p)
     tOplkError      ret = kErrorOk;
     UINT8           aMacAddr[6];
     struct in_addr  ipAddr;
+    INT             i;
 
     memset(&edrv2vethInstance_l, 0, sizeof(tEdrv2VethInstance));
 
+    for (i = 0; i < EDRV2VETH_RX_BUF_CNT; i++)
+    {
+        edrv2vethInstance_l.aRxBuffer[i].pNext = edrv2vethInstance_l.pRxFree;
+        edrv2vethInstance_l.pRxFree = &edrv2vethInstance_l.aRxBuffer[i];
+    }
+
     // Copy default MAC address
     ret = oplk_getEthMacAddr(aMacAddr);
     if (ret != kErrorOk)
@@ -267,6 +279,11 @@ void edrv2veth_setNmtState(tNmtState nmtState_p)
 Handles an incoming frame from the Virtual Ethernet driver and forwards it
 to the IP stack.
 
+The frame buffer of the driver is only valid during this call. Frames which
+the IP stack does not keep are processed directly in this buffer. All other
+frames are copied to a loan buffer, which the IP stack returns with
+freePacket() when it is done.
+
 \param  pFrame_p       Pointer to the incoming payload.
 \param  frameSize_p    Size of the incoming payload.
 
@@ -278,30 +295,45 @@ to the IP stack.
 //------------------------------------------------------------------------------
 tOplkError edrv2veth_receiveHandler(UINT8* pFrame_p, UINT32 frameSize_p)
 {
-    tOplkError     ret = kErrorOk;
-    INT            rcvStatus;
-    ip_packet_typ* pPacket;
-    INT            i;
+    tOplkError              ret = kErrorOk;
+    INT                     rcvStatus;
+    ip_packet_typ*          pPacket;
+    tEdrv2VethRxDesc*       pDesc;
+    tEdrv2VethRxStatistics* pStat = &edrv2vethInstance_l.rxStatistics;
+
+    // Process the frame in place if the IP stack does not keep it
+    if ((edrv2vethInstance_l.nmtState > kNmtCsNotActive) &&
+        (ipPacketProcess(edrv2vethInstance_l.pIpStack, pFrame_p, frameSize_p) == 0))
+    {
+        pStat->directCount++;
+        return ret;
+    }
 
-    for (i=0; i<IP_RX_BUF_CNT; i++)
+    if (frameSize_p > sizeof(pDesc->aBuffer))
     {
-        if (!edrv2vethInstance_l.aRxBuffer[i].fIpStackOwner)
-            break;
+        pStat->oversizeCount++;
+        return ret;
     }
 
-    if (i == IP_RX_BUF_CNT)
+    pDesc = edrv2vethInstance_l.pRxFree;
+    if (pDesc == NULL)
     {
         // No free buffer found => ignore frame
-        PRINTF("%s (Err/Warn): No free buffer found, Frames ignored\n",
-        __func__);
-        return kErrorOk;
+        pStat->overflowCount++;
+        return ret;
     }
 
-    // i points to a free buffer!
-    edrv2vethInstance_l.aRxBuffer[i].fIpStackOwner = TRUE;
-    pPacket = (ip_packet_typ*)&edrv2vethInstance_l.aRxBuffer[i].length;
+    edrv2vethInstance_l.pRxFree = pDesc->pNext;
+    pDesc->fIpStackOwner = TRUE;
+
+    pStat->loanCount++;
+    if (pStat->loanCount > pStat->loanPeak)
+        pStat->loanPeak = pStat->loanCount;
+
+    pPacket = (ip_packet_typ*)&pDesc->length;
     pPacket->length = frameSize_p;
     memcpy(pPacket->data, pFrame_p, frameSize_p);
+    pStat->copyCount++;
 
     // Forward incoming data to IP stack
     rcvStatus = ipPacketReceive(edrv2vethInstance_l.pIpStack,
@@ -315,6 +347,20 @@ tOplkError edrv2veth_receiveHandler(UINT8* pFrame_p, UINT32 frameSize_p)
     return ret;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief Get receive statistics
+
+\return Pointer to the receive statistics of the module
+
+\ingroup module_ip
+*/
+//------------------------------------------------------------------------------
+const tEdrv2VethRxStatistics* edrv2veth_getRxStatistics(void)
+{
+    return &edrv2vethInstance_l.rxStatistics;
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief Process function
@@ -346,6 +392,9 @@ tOplkError edrv2veth_process(void)
         edrv2vethInstance_l.ipState = ipPeriodic(edrv2vethInstance_l.pIpStack,
                                                  timeTick);
 
+        // Deliver the datagrams queued while processing the IP stack
+        socketwrapper_process();
+
         //TODO: Handle IP_STATE_ERROR_* ?
     }
 
@@ -368,23 +417,22 @@ tOplkError edrv2veth_process(void)
 //------------------------------------------------------------------------------
 static void freePacket(ip_packet_typ* pPacket_p)
 {
-    INT i;
+    tEdrv2VethRxDesc*   pDesc = GET_TYPE_BASE(tEdrv2VethRxDesc, length, pPacket_p);
 
-    for (i = 0; i < IP_RX_BUF_CNT; i++)
-    {
-        if ((ip_packet_typ*)&edrv2vethInstance_l.aRxBuffer[i].length == pPacket_p)
-        {
-            edrv2vethInstance_l.aRxBuffer[i].fIpStackOwner = FALSE;
-            break;
-        }
-    }
-
-    if (i == IP_RX_BUF_CNT)
+    if ((pDesc < &edrv2vethInstance_l.aRxBuffer[0]) ||
+        (pDesc >= &edrv2vethInstance_l.aRxBuffer[EDRV2VETH_RX_BUF_CNT]) ||
+        !pDesc->fIpStackOwner)
     {
         PRINTF("%s(Err/Warn): Error while freeing the Veth receive buffer\n",
                __func__);
+        return;
     }
 
+    pDesc->fIpStackOwner = FALSE;
+    pDesc->pNext = edrv2vethInstance_l.pRxFree;
+    edrv2vethInstance_l.pRxFree = pDesc;
+
+    edrv2vethInstance_l.rxStatistics.loanCount--;
 }
 
 //------------------------------------------------------------------------------
@@ -50,11 +50,32 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // const defines
 //---------------------------------------------------------------------------
 
+/**
+ * Number of receive buffers loaned to the IP stack. Buffers are only used for
+ * frames which the IP stack has to keep (queued frames, fragments, sockets),
+ * all other frames are processed in the buffer of the POWERLINK driver.
+ */
+#ifndef EDRV2VETH_RX_BUF_CNT
+#define EDRV2VETH_RX_BUF_CNT        IP_RX_BUF_CNT
+#endif
 
 //---------------------------------------------------------------------------
 // typedef
 //---------------------------------------------------------------------------
 
+/**
+\brief  Receive statistics of the virtual Ethernet bridge
+*/
+typedef struct
+{
+    UINT32      directCount;        ///< Frames processed in the driver buffer (not copied)
+    UINT32      copyCount;          ///< Frames copied to a loan buffer
+    UINT32      overflowCount;      ///< Frames dropped because no loan buffer was free
+    UINT32      oversizeCount;      ///< Frames dropped because they do not fit into a loan buffer
+    UINT16      loanCount;          ///< Loan buffers currently owned by the IP stack
+    UINT16      loanPeak;           ///< Maximum of loanCount
+} tEdrv2VethRxStatistics;
+
 
 //---------------------------------------------------------------------------
 // function prototypes
@@ -67,6 +88,7 @@ void       edrv2veth_changeGateway(UINT32 defGateway_p);
 void       edrv2veth_setNmtState(tNmtState nmtState_p);
 tOplkError edrv2veth_receiveHandler(UINT8* pFrame_p, UINT32 frameSize_p);
 tOplkError edrv2veth_process(void);
+const tEdrv2VethRxStatistics* edrv2veth_getRxStatistics(void);
 
 
 #endif /* _INC_edrv2veth_H_ */
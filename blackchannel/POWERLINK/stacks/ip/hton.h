@@ -71,4 +71,7 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     #define htonl(x)    (x)
 #endif  // LITTLE_ENDIAN == 1
 
+// copy a 32 bit value and convert it to network byte order
+void htonlc(void *pDst, void* pSrc);
+
 #endif //__HTON_H__
@@ -168,6 +168,17 @@ DESCRIPTION
 	#error "at least 1 tx buffer required !"
 #endif
 
+// the hash chains keep index+1 and bucket+1 in an unsigned char (0 = end of chain / not linked)
+#if IP_TCP_SOCKETS > 254
+	#error "IP_TCP_SOCKETS must not be greater than 254 !"
+#endif
+#if IP_LISTEN_PORTS_UDP > 254
+	#error "IP_LISTEN_PORTS_UDP must not be greater than 254 !"
+#endif
+#if (IP_SOCK_HASHSIZE & (IP_SOCK_HASHSIZE - 1)) != 0 || IP_SOCK_HASHSIZE > 128
+	#error "IP_SOCK_HASHSIZE must be a power of 2 and not greater than 128 !"
+#endif
+
 static struct IP_IF	*hIpList=0;		// ptr to first ip stack handle
 
 // user can enter fixed value for VLAN TAG in ip_opt.h
@@ -198,7 +209,6 @@ typedef struct
 
 #define ARP_REQUEST 1
 #define ARP_REPLY   2
-#define ARP_ANNOUNCEMENT   0xFFFF	// opcode is only used to mark packet interally as announcement packet
 #define ARP_HWTYPE_ETH 1
 
 #define IP_DHCP_PORT_CLIENT	68		// dhcp port
@@ -212,6 +222,26 @@ typedef struct
 #define IP_ARP_ANNOUNCE_COUNT	2		// send 2 arp announcements (ARP Probe as in RFC5227)
 #define IP_INIT_ARP_DISABLE		255
 
+#ifndef IP_ARP_MAX_PROBE
+	#define IP_ARP_MAX_PROBE	8		// maximum distance of an arp entry from its hash slot
+#endif
+#ifndef IP_ARP_PENDING_RETRY
+	#define IP_ARP_PENDING_RETRY	3	// arp requests (1 per second) until a resolution has failed
+#endif
+#ifndef IP_ARP_NEGATIVE_S
+	#define IP_ARP_NEGATIVE_S	10		// time in seconds a failed resolution is kept in the table
+#endif
+
+#if (IP_ARP_TABSIZE & (IP_ARP_TABSIZE - 1)) != 0
+	#error "IP_ARP_TABSIZE must be a power of 2 !"
+#endif
+#if IP_ARP_MAX_PROBE > IP_ARP_TABSIZE
+	#undef  IP_ARP_MAX_PROBE
+	#define IP_ARP_MAX_PROBE	IP_ARP_TABSIZE
+#endif
+
+#define ARP_SLOT(i)			((i) & (IP_ARP_TABSIZE - 1))
+
 
 /*
 *  The IP TTL (time to live) of IP packets sent
@@ -231,8 +261,26 @@ static void	copy_eth_address(void *pDst,void *pSrc);								// copy ethernet add
 static void	ip_arp_in(IP_STACK_H hIp, eth_frame *pFrame);							// ARP processing
 static void ip_icmp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen);	// ICMP
 static void ip_udp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen);	// UDP
-static reass_buf_type *ip_reass(IP_STACK_H hIp, eth_frame *pFrame);					// reassembly
+static listen_type *ip_udp_find(IP_STACK_H hIp, unsigned long lport);			// UDP listen port lookup
+static reass_buf_type *ip_reass(IP_STACK_H hIp, eth_frame *pFrame, IP_BUF_FREE_FCT **ppFct);	// reassembly
+static void ip_reass_periodic(IP_STACK_H hIp);										// reassembly timeouts
+static void ip_reass_release(IP_STACK_H hIp, reass_dgram_type *pDg);				// release held fragments
+static int  ip_rx_filter(IP_STACK_H hIp, eth_frame *pFrame);							// pre-filter of received frames
 static void sendArpRequest(IP_STACK_H hIp, struct in_addr *pIp);
+static void prepareArpReq(IP_STACK_H hIp, ip_buf_type *pBuf, struct in_addr *pIpAddr, unsigned long option);
+static void ip_buf_queue(IP_STACK_H hIp, ip_buf_type *pBuf);
+static int  ip_buf_mark_queued(ip_buf_type *pBuf);
+static void ip_buf_enqueue(IP_STACK_H hIp, ip_buf_type *pBuf);
+static void ip_buf_drop(ip_buf_type *pBuf);
+
+// hashed arp table
+static arp_table_entry *arp_lookup(IP_STACK_H hIp, unsigned long ip);
+static arp_table_entry *arp_insert(IP_STACK_H hIp, unsigned long ip);
+static void arp_remove(IP_STACK_H hIp, arp_table_entry *pEntry);
+static void arp_release(IP_STACK_H hIp, arp_table_entry *pEntry);
+static int  arp_resolve(IP_STACK_H hIp, struct in_addr *pIp, ip_buf_type *pBuf);
+static void arp_complete(IP_STACK_H hIp, arp_table_entry *pEntry, void *pMacAddr);
+static void arp_age(IP_STACK_H hIp, int refresh);
 
 #if IP_TCP_SOCKETS > 0
 // clear all internal variables after 'power up'
@@ -286,6 +334,15 @@ IP_STACK_H ipInit(eth_addr *pEthAddr, struct in_addr* pIpAddr, IP_ETHSEND *pEthS
 	hIp->pTxBuffer = calloc(IP_TX_BUF_CNT, sizeof(ip_buf_type));
 	hIp->pReassBuffer = calloc(IP_REASS_BUF_CNT, sizeof(reass_buf_type));
 
+	#if IP_REASS_BUF_CNT > 0
+		// link all fragment chain entries to the free list
+		for(i = 0 ; i < IP_REASS_FRAG_CNT ; i++)
+		{
+			hIp->reassFrag[i].pNext	= hIp->pReassFragFree;
+			hIp->pReassFragFree		= &hIp->reassFrag[i];
+		}
+	#endif
+
 	// overtake local ethernet and ip address
 	copy_eth_address(hIp->local_eth_addr.addr, pEthAddr);
 	copy_ip_address(&hIp->local_ip_addr, pIpAddr);
@@ -341,6 +398,13 @@ IP_STACK_H ipInit(eth_addr *pEthAddr, struct in_addr* pIpAddr, IP_ETHSEND *pEthS
 // destroy ip stack
 void ipDestroy(IP_STACK_H hIp)
 {
+	#if IP_REASS_BUF_CNT > 0
+		reass_dgram_type *pDg;
+
+		// give held fragments back to the ethernet driver
+		for(pDg = hIp->reass ; pDg < hIp->reass + IP_REASS_DGRAM_CNT ; pDg++) ip_reass_release(hIp, pDg);
+	#endif
+
 	//free memory
 	free(hIp->pTxBuffer);
 	free(hIp->pReassBuffer);
@@ -357,10 +421,11 @@ void ipRestartArpProbe(IP_STACK_H hIp)
 	hIp->arp_refresh = 0;
 	hIp->arp_probe   = 0;
 
-	// remove old entries from arp table
+	// remove old entries from arp table (queued packets are dropped)
 	for(pArpEntry = hIp->arp_table ; pArpEntry < hIp->arp_table + IP_ARP_TABSIZE ; pArpEntry++)
 	{
-		pArpEntry->ip.S_un.S_addr = 0;
+		arp_release(hIp, pArpEntry);
+		pArpEntry->state = ARP_STATE_FREE;
 	}
 
 	#if IP_DHCP == 1
@@ -514,17 +579,21 @@ void ipSetNetmask(IP_STACK_H hIp, struct in_addr* pSubnetMask)
 
   Return Value:
 	0  = Ok
-	-1 = Error (hIp=0 or pFct=0 or port already opened or no listen port free)
+	-1 = Error (hIp=0 or pFct=0 or lport=0 or port already opened or no listen port free)
 *********************************************************************************/
 int ipUdpListen(IP_STACK_H hIp, unsigned long lport, IP_HOOKFCT *pFct, void *arg)
 {
 	listen_type		*pList, *pFree;
+	unsigned char	*pHead;
 	unsigned long	i;
 
-	if(hIp==0 || pFct==0) return -1;
+	if(hIp==0 || pFct==0 || lport==0) return -1;
 
 	lport = htons((unsigned short)lport);	// port is stored in network byte order
 
+	// check if port is already used on the system !!
+	if(ip_udp_find(hIp, lport)) return -1;
+
 	pList = hIp->listen_udp;
 	
 	pFree = 0;
@@ -532,12 +601,8 @@ int ipUdpListen(IP_STACK_H hIp, unsigned long lport, IP_HOOKFCT *pFct, void *arg
 	{
 		if(pList->lport == 0)	// take free connection if found
 		{
-			if(pFree==0) pFree = pList;
-		}
-		// check if port is already used on the system !!
-		else if(pList->lport == lport)
-		{
-			return -1;
+			pFree = pList;
+			break;
 		}
 	}
 
@@ -548,6 +613,11 @@ int ipUdpListen(IP_STACK_H hIp, unsigned long lport, IP_HOOKFCT *pFct, void *arg
 	pFree->arg		= arg;
 	pFree->pFct		= pFct;
 
+	// link entry into the port hash
+	pHead		= &hIp->listen_udp_hash[IP_PORT_HASH(lport)];
+	pFree->next	= *pHead;
+	*pHead		= (unsigned char)(pFree - hIp->listen_udp) + 1;
+
 	return 0;
 }
 						
@@ -567,18 +637,29 @@ int ipUdpListen(IP_STACK_H hIp, unsigned long lport, IP_HOOKFCT *pFct, void *arg
 int ipUdpClose(IP_STACK_H hIp, unsigned long lport)
 {
 	listen_type		*pList;
-	unsigned long	i;
+	unsigned char	*pLink;
 
 	if(hIp==0) return -1;
 
 	lport = htons((unsigned short)lport);	// port is stored in network byte order
 
-	pList = hIp->listen_udp;
-	
-	for(i = IP_LISTEN_PORTS_UDP ; i ; pList++, i--)
+	pLink = &hIp->listen_udp_hash[IP_PORT_HASH(lport)];
+
+	while(*pLink)
 	{
+		pList = hIp->listen_udp + *pLink - 1;
+
 		// clear all listening entries to this port
-		if(pList->lport == lport) pList->lport = 0;
+		if(pList->lport == lport)
+		{
+			*pLink			= pList->next;	// unlink from hash chain
+			pList->lport	= 0;
+			pList->next		= 0;
+		}
+		else
+		{
+			pLink = &pList->next;
+		}
 	}
 
 	return 0;
@@ -608,7 +689,7 @@ int ipUdpClose(IP_STACK_H hIp, unsigned long lport)
 *********************************************************************************/
 static void ip_packet_free(ip_packet_typ *pPacket)
 {
-	ip_buf_hdr		*pHdr = &((ip_buf_type*)(((char*)pPacket)-sizeof(ip_buf_hdr)))->header;
+	ip_buf_hdr		*pHdr = &GET_TYPE_BASE(ip_buf_type, length, pPacket)->header;
 
 	if(pPacket==0) return;
 
@@ -654,13 +735,17 @@ void ipGetGateway(IP_STACK_H hIp, void *pSubnetMask, void *pGateway)
     if(pGateway)    memcpy(pGateway,    &hIp->gateway  , 4);
 }
 
-static int processPacket(IP_STACK_H hIp, ip_packet_typ *pPacket)
+// process a received frame, the frame is not released
+// (returns -1 if the frame has to be processed again)
+// *ppFct is the release function of the frame, it is cleared if a socket or the
+// reassembly takes the frame over. The frame itself is not written.
+static int processFrame(IP_STACK_H hIp, eth_frame *pFrame, IP_BUF_FREE_FCT **ppFct)
 {
 	unsigned short	len;
-	eth_frame		*pFrame = (eth_frame*)&pPacket->data;
 
 	#if IP_REASS_BUF_CNT > 0
 		reass_buf_type	*pReass=0;
+		IP_BUF_FREE_FCT	*pReassFct=0;
 	#endif
 
 	// processing of new frame
@@ -694,15 +779,17 @@ static int processPacket(IP_STACK_H hIp, ip_packet_typ *pPacket)
 			{
 				#if IP_REASS_BUF_CNT > 0
 					// call reassembly function only if reassembly is enabled
-					pReass = ip_reass(hIp,pFrame);
+					pReass = ip_reass(hIp,pFrame,ppFct);
 
 					// leave loop if no reassembled buffer was completed
 					if(pReass == 0) break;
 
 					pFrame = &pReass->buf.data.frame;	// new frame pointer if reassembled buffer is ready
 
-					// store callback function inside the frame (first 4 bytes of dst-mac)
-					((ip_int_hdr*)pFrame)->pFct = ip_packet_free;
+					// the reassembled buffer is released here unless a socket takes it over,
+					// the received fragment is still released by the caller
+					pReassFct	= ip_packet_free;
+					ppFct		= &pReassFct;
 				#else
 					IP_STAT( hIp->stat.ip_err_frag++ );
 					IP_LOG("ip: fragment dropped.");
@@ -719,7 +806,7 @@ static int processPacket(IP_STACK_H hIp, ip_packet_typ *pPacket)
 			{
 				#if IP_TCP_SOCKETS > 0
 					case IPPROTO_TCP:
-						if( sock_in(hIp, pFrame, len) == IP_FRAME_RETRY )
+						if( sock_in(hIp, pFrame, len, ppFct) == IP_FRAME_RETRY )
 						{
 							if(pReass) pReass->timer = IP_REASS_MAXAGE;
 							return -1;
@@ -752,7 +839,7 @@ static int processPacket(IP_STACK_H hIp, ip_packet_typ *pPacket)
 					#endif
 
 					#if IP_TCP_SOCKETS > 0
-						if( sock_in(hIp, pFrame, len) == IP_FRAME_RETRY )
+						if( sock_in(hIp, pFrame, len, ppFct) == IP_FRAME_RETRY )
 						{
 							if(pReass) pReass->timer = IP_REASS_MAXAGE;
 							return -1;
@@ -779,14 +866,22 @@ static int processPacket(IP_STACK_H hIp, ip_packet_typ *pPacket)
 		{
 			if(pReass)	// reassembled buffer was created, release if not used anymore
 			{
-				if(((ip_int_hdr*)pFrame)->pFct) ((ip_int_hdr*)pFrame)->pFct((ip_packet_typ*)&pReass->buf.length);
+				if(pReassFct) pReassFct((ip_packet_typ*)&pReass->buf.length);
 			}
 		}
 	#endif
 
+	return 0;
+}
+
+static int processPacket(IP_STACK_H hIp, ip_rx_queue_typ *pQueue)
+{
+	eth_frame	*pFrame = (eth_frame*)&pQueue->pPacket->data;
+
+	if( processFrame(hIp, pFrame, &pQueue->pFct) ) return -1;
+
 	// free buffer and clear rx-queue entry ...  pass buffer to back ethernet driver
-	pFrame = (eth_frame*)pPacket->data;
-	if(((ip_int_hdr*)pFrame)->pFct) ((ip_int_hdr*)pFrame)->pFct(pPacket);
+	if(pQueue->pFct) pQueue->pFct(pQueue->pPacket);
 
 	return 0;
 }
@@ -854,7 +949,7 @@ ipState_enum ipPeriodic(IP_STACK_H hIp, unsigned long timeMs)
 				{
 					// process rx packet
 					// stop processing frames if the current frame is denied (because socket is occupied)
-					if( processPacket(hIp, pQueue->pPacket ) ) break;
+					if( processPacket(hIp, pQueue) ) break;
 
 					pQueue->pPacket	= 0;				// mark as empty
 					hIp->pRxRead2	= pQueue->pNext;	// switch read index to next buffer
@@ -867,7 +962,7 @@ ipState_enum ipPeriodic(IP_STACK_H hIp, unsigned long timeMs)
 
 		// process rx packet
 		// stop processing frames if the current frame is denied (because socket is occupied)
-		if( processPacket(hIp, pQueue->pPacket ) ) break;
+		if( processPacket(hIp, pQueue) ) break;
 
 		pQueue->pPacket = 0;			// mark as empty
 		hIp->pRxRead = pQueue->pNext;	// switch read index to next buffer
@@ -891,18 +986,9 @@ ipState_enum ipPeriodic(IP_STACK_H hIp, unsigned long timeMs)
 
 	//-------------------------------- Periodic IP ---------------------------------------
 
-	// decrease reassembly timers
+	// release datagrams which were not completed in time
 	#if IP_REASS_BUF_CNT > 0
-	{
-		reass_buf_type *pReass;
-
-		// loop through reassembly buffers and decrement timer (buffers with timer=0) will be deleted if the 
-		// memory is required
-		for(pReass = hIp->pReassBuffer ; pReass < hIp->pReassBuffer + IP_REASS_BUF_CNT; pReass++)
-		{
-			if(pReass->timer) pReass->timer--;
-		}
-	}
+		ip_reass_periodic(hIp);
 	#endif
 	
 	#if IP_TCP_SOCKETS > 0
@@ -952,36 +1038,28 @@ ipState_enum ipPeriodic(IP_STACK_H hIp, unsigned long timeMs)
 	// refresh time reached, go through list and remove entries which have reached IP_ARP_MAXAGE
 	if(hIp->arp_refresh >= IP_ARP_REFRESH_S )
 	{
-		arp_table_entry	*pArpEntry, *pArpGateway = 0;
+		arp_table_entry	*pArpGateway;
 
 		hIp->arp_refresh = 0;
 
-		// remove old entries from arp table
-		for(pArpEntry = hIp->arp_table ; pArpEntry < hIp->arp_table + IP_ARP_TABSIZE ; pArpEntry++)
-		{
-			if(pArpEntry->ip.S_un.S_addr)
-			{
-				if (((unsigned short)hIp->time_s - pArpEntry->time) >= IP_ARP_MAXAGE)	// remove entry if too old
-				{
-					pArpEntry->ip.S_un.S_addr = 0;
-				}
-				else if( pArpEntry->ip.S_un.S_addr == hIp->gateway.S_un.S_addr)		// store ptr to gateway entry
-				{
-					pArpGateway = pArpEntry;
-				}
-
-			}
-		}
+		arp_age(hIp, 1);
 
 		// request mac address of gateway (if configured, and last reception was more than 10 minutes ago)
 		if(hIp->gateway.S_un.S_addr)
 		{
-			if(pArpGateway!=0 && ((unsigned short)hIp->time_s - pArpGateway->time) >= 600 )
+			pArpGateway = arp_lookup(hIp, hIp->gateway.S_un.S_addr);
+
+			if(pArpGateway!=0 && pArpGateway->state == ARP_STATE_RESOLVED &&
+			   ((unsigned short)hIp->time_s - pArpGateway->time) >= 600 )
 			{
 				sendArpRequest(hIp, &hIp->gateway);
 			}
 		}
 	}
+	else if(hIp->arp_unresolved)
+	{
+		arp_age(hIp, 0);	// retry pending requests and expire failed entries every second
+	}
 
 	return hIp->state;
 }
@@ -1142,10 +1220,7 @@ void ip_buf_send(IP_STACK_H hIp, ip_buf_type *pBuf, unsigned long option)
 			{
 				IP_STAT(hIp->stat.packets_used++);	// count incoming packets
 
-				// store callback function inside the frame (first 4 bytes of dst-mac)
-				((ip_int_hdr*)pFrame)->pFct = ip_packet_free;
-
-
+				pQueue->pFct	= ip_packet_free;						// release function of the buffer
 				pQueue->pPacket	= (ip_packet_typ*)&pBuf->length;		// write info to queue
 
 				hIp->pRxWrite2 = pQueue->pNext;	// set to next queue element
@@ -1180,20 +1255,27 @@ void ip_buf_send(IP_STACK_H hIp, ip_buf_type *pBuf, unsigned long option)
 				ipAddr.S_un.S_addr = hIp->gateway.S_un.S_addr;
 			}
 
-			for(ptr = hIp->arp_table ; ARP_TAB(ptr) < hIp->arp_table + IP_ARP_TABSIZE ; ptr = (char*)ptr + sizeof(arp_table_entry))
+			ptr = arp_lookup(hIp, ipAddr.S_un.S_addr);
+
+			// change buffer to arp request if frame is addressed to local ip (arp probe)
+			if(ipAddr.S_un.S_addr==hIp->local_ip_addr.S_un.S_addr)
 			{
-				if(ipAddr.S_un.S_addr == ARP_TAB(ptr)->ip.S_un.S_addr)
-				{
-					// build an ethernet header
-					copy_eth_address(pFrame->eth.dst_hw, ARP_TAB(ptr)->eth.addr);
-					break;
-				}
+				prepareArpReq(hIp, pBuf, &ipAddr, option);
 			}
+			else if(ptr != 0 && ARP_TAB(ptr)->state == ARP_STATE_RESOLVED)
+			{
+				IP_STAT( hIp->stat.arp_hit++ );
 
-			// change buffer to arp request if entry in arp table not found (or frame is addressed to local ip)
-			if(ARP_TAB(ptr)== hIp->arp_table + IP_ARP_TABSIZE || ipAddr.S_un.S_addr==hIp->local_ip_addr.S_un.S_addr)
+				// build an ethernet header
+				copy_eth_address(pFrame->eth.dst_hw, ARP_TAB(ptr)->eth.addr);
+			}
+			else if(arp_resolve(hIp, &ipAddr, pBuf))
+			{
+				return;		// packet is queued until the arp reply is received (or dropped)
+			}
+			else
 			{
-				// todo
+				// no buffer for the arp request available, change buffer to arp request
 				prepareArpReq(hIp, pBuf, &ipAddr, option);
 			}
 		}
@@ -1203,30 +1285,94 @@ void ip_buf_send(IP_STACK_H hIp, ip_buf_type *pBuf, unsigned long option)
 		}
 	}
 
+	ip_buf_queue(hIp, pBuf);
+}
 
-	// add to tx queue (no overflow check necessary because queue length and available buffers is same
+/*********************************************************************************
+
+  Function    : ip_buf_queue
+  Description : add a prepared buffer to the tx queue
+
+  Parameter:
+	hIp		: handle of used interface
+	pBuf	: buffer with complete ethernet frame
+
+*********************************************************************************/
+static void ip_buf_queue(IP_STACK_H hIp, ip_buf_type *pBuf)
+{
 	EnableGlobalInterrupt(FALSE);
 
 	// only buffers with state  IP_BUF_STATE_TX or IP_BUF_STATE_TX_ACK will be sent to tx-queue
+	if(ip_buf_mark_queued(pBuf)) ip_buf_enqueue(hIp, pBuf);
+
+	EnableGlobalInterrupt(TRUE);
+}
+
+/*********************************************************************************
+
+  Function    : ip_buf_mark_queued
+  Description : mark a buffer as owned by the tx queue or by an arp entry, the
+				socket does not release it anymore (called with disabled interrupts)
+
+  Parameter:
+	pBuf	: buffer to mark
+
+  Return Value:
+	1 ... buffer marked
+	0 ... buffer state is not IP_BUF_STATE_TX or IP_BUF_STATE_TX_ACK
+
+*********************************************************************************/
+static int ip_buf_mark_queued(ip_buf_type *pBuf)
+{
 	switch(pBuf->header.state)
 	{
 		case IP_BUF_STATE_TX:
 			pBuf->header.state = IP_BUF_STATE_TX_Q;
-			break;
+			return 1;
 
 		case IP_BUF_STATE_TX_ACK:
 			pBuf->header.state = IP_BUF_STATE_TX_ACK_Q;
-			break;
+			return 1;
 
-		default:	// other buffer states will not be placed to TX-queue
-		    EnableGlobalInterrupt(TRUE);
-			return;
+		default:
+			return 0;
 	}
+}
+
+/*********************************************************************************
 
+  Function    : ip_buf_enqueue
+  Description : add a marked buffer to the tx queue (called with disabled interrupts)
+
+  Parameter:
+	hIp		: handle of used interface
+	pBuf	: buffer marked by ip_buf_mark_queued()
+
+*********************************************************************************/
+static void ip_buf_enqueue(IP_STACK_H hIp, ip_buf_type *pBuf)
+{
+	// no overflow check necessary because queue length and available buffers is same
 	hIp->txQueue[hIp->txQWrite++] = pBuf;					// add to send queue
 	if(hIp->txQWrite >= IP_TX_BUF_CNT) hIp->txQWrite = 0;	// increment write index
+}
+
+/*********************************************************************************
+
+  Function    : ip_buf_drop
+  Description : release a buffer which was passed to ip_buf_send() but will
+				not be sent (like a buffer which was sent by the ethernet driver)
+
+  Parameter:
+	pBuf	: buffer to drop
 
+*********************************************************************************/
+static void ip_buf_drop(ip_buf_type *pBuf)
+{
+	EnableGlobalInterrupt(FALSE);
+	ip_buf_mark_queued(pBuf);
 	EnableGlobalInterrupt(TRUE);
+
+	ip_packet_free((ip_packet_typ*)&pBuf->length);
 }
 
 
@@ -1273,6 +1419,107 @@ ip_buf_type* ip_alloc_tx_buffer(IP_STACK_H hIp)
 }
 
 
+/*********************************************************************************
+
+  Function    : ip_chksum_partial
+  Description : add a data block to a 32 bit one's complement accumulator
+
+  The data is summed up as 16 bit words in memory order (the result is valid
+  for big and little endian hosts without swapping). The loop is unrolled to
+  process 16 bytes per iteration. The carries are not folded, therefore the
+  accumulator can take up to 64 kByte of data before it may overflow.
+
+  Parameter:
+	pData	: ptr to data (must be 16 bit aligned)
+	len		: number of bytes (an odd length is padded with a zero byte)
+	sum		: accumulator value of the previous blocks (0 for the first block)
+
+  Return Value:
+	New accumulator value (use ip_chksum_fold() to get the checksum)
+
+*********************************************************************************/
+unsigned long ip_chksum_partial(const void *pData, unsigned long len, unsigned long sum)
+{
+	const unsigned short	*pWord = (const unsigned short*)pData;
+	union
+	{
+		unsigned short	word;
+		unsigned char	byte[2];
+	}tail;
+
+	// 8 words per iteration
+	while(len >= 16)
+	{
+		sum += (unsigned long)pWord[0] + pWord[1] + pWord[2] + pWord[3]
+			 + pWord[4] + pWord[5] + pWord[6] + pWord[7];
+		pWord += 8;
+		len   -= 16;
+	}
+
+	while(len >= 2)
+	{
+		sum += *(pWord++);
+		len -= 2;
+	}
+
+	// odd length: the last byte is the first byte of a zero padded word
+	if(len)
+	{
+		tail.byte[0] = *(const unsigned char*)pWord;
+		tail.byte[1] = 0;
+		sum += tail.word;
+	}
+
+	return sum;
+}
+
+/*********************************************************************************
+
+  Function    : ip_chksum_fold
+  Description : fold a 32 bit accumulator to the 16 bit one's complement checksum
+
+  Parameter:
+	sum		: accumulator value from ip_chksum_partial()
+
+  Return Value:
+	Checksum in memory (network) byte order
+
+*********************************************************************************/
+unsigned short ip_chksum_fold(unsigned long sum)
+{
+	// add carries from high word to low word (two steps are always sufficient)
+	sum = (sum & 0xFFFF) + (sum >> 16);
+	sum = (sum & 0xFFFF) + (sum >> 16);
+
+	return ~(unsigned short)sum;
+}
+
+/*********************************************************************************
+
+  Function    : ip_chksum_adjust
+  Description : incremental checksum update of a modified 16 bit field (RFC 1624)
+
+  Avoids the recalculation of a complete header or payload if only single
+  fields (TTL, length, ports, ICMP type, ...) are rewritten in place.
+
+  Parameter:
+	chksum	: current checksum of the header (memory byte order)
+	oldVal	: old value of the 16 bit field (memory byte order)
+	newVal	: new value of the 16 bit field (memory byte order)
+
+  Return Value:
+	Updated checksum (HC' = ~(~HC + ~m + m'))
+
+*********************************************************************************/
+unsigned short ip_chksum_adjust(unsigned short chksum, unsigned short oldVal, unsigned short newVal)
+{
+	unsigned long	sum;
+
+	sum = (unsigned long)(unsigned short)~chksum + (unsigned short)~oldVal + newVal;
+
+	return ip_chksum_fold(sum);
+}
+
 /*********************************************************************************
 
   Function    : ip_chksum
@@ -1300,62 +1547,25 @@ unsigned short ip_chksum(ip_hdr *pIP, unsigned long prot)
 {
 	unsigned long len;
 	unsigned long offset;
-	unsigned long temp;
-
-	len = (pIP->vhl & 0xF)*2;	// ip header size in words
-
-	if(prot)	// calculate checksum of payload data if another checksum than IP is reqested
-	{
-		offset	= len+len;		// the header length is the offset to the payload data
-		len		= pIP->len;	// get length from ip-header
-
-		// swap if host is little endian
-		#if LITTLE_ENDIAN==1
-			((char*)&temp)[0] = (char)(len>>8);	// high byte -> low address (big endian)
-			((char*)&temp)[1] = (char)len;		// low byte -> high address (big endian)
-			len = (unsigned short)temp;
-		#endif
-
-		len		= len - offset;	// take ip header length off
-		prot	= prot + len;	// first part of pseudo header: protocol number + payload length
-	
-		#if LITTLE_ENDIAN==1		// swap first part of pseudo header on LE systems
-			((char*)&temp)[0] = (char)(prot>>8);
-			((char*)&temp)[1] = (char)prot;
-			prot = (unsigned short)temp;
-		#endif
-
-		// rest of pseudo header (src and dst ip)
-		prot = prot + pIP->src_ip[0] + pIP->src_ip[1] + pIP->dst_ip[0] + pIP->dst_ip[1];
+	unsigned long sum;
 
-		pIP = (ip_hdr*)(((char*)pIP) + offset);	// set ptr to start of payload data
+	offset = (pIP->vhl & 0xF)*4;	// ip header size in bytes
 
-		// odd length, set 1 byte after the frame to 0 because it will be included in the chksum calculation
-		if(len & 1) ((char*)pIP)[len++] = 0;
-		
-		len=len/2;	// generate word counter
-	}
-	
-	while(len)	// checksum calculation
+	if(prot == 0)	// checksum of the ip header only
 	{
-		prot = prot + *(unsigned short*)pIP;	// get word from frame and add to checksum
-		pIP  = (ip_hdr*)(((char*)pIP)+2);		// switch to next word
-		len--;
+		return ip_chksum_fold(ip_chksum_partial(pIP, offset, 0));
 	}
-	
-	// add carries from high word to low word
-	do
-	{
-		temp = prot;
 
-		len  = ((temp & 0xFFFF0000) >> 16);
-		temp = temp & 0xFFFF;
+	// calculate checksum of payload data if another checksum than IP is reqested
+	len = htons(pIP->len) - offset;		// payload length (ip header taken off)
 
-		prot = temp + len;
-	}
-	while(len);
+	// first part of pseudo header: protocol number + payload length
+	sum = htons((unsigned short)(prot + len));
 
-	return ~(unsigned short)prot;
+	// rest of pseudo header (src and dst ip)
+	sum += (unsigned long)pIP->src_ip[0] + pIP->src_ip[1] + pIP->dst_ip[0] + pIP->dst_ip[1];
+
+	return ip_chksum_fold(ip_chksum_partial(((char*)pIP) + offset, len, sum));
 }
 
 //-----------------------------------------------------------------------------
@@ -1368,122 +1578,354 @@ static void copy_eth_address(void *pDst,void *pSrc)
 
 //-----------------------------------------------------------------------------
 
-void*				ipArpAnnouncement		// update arp table (only if entry is already there)
-(
- IP_STACK_H		hIp,			// handle to IP stack
- void			*pMacAddr,		// ptr to remote mac address
- void			*pIpAddr		// ip address of remote host
-)
+//-----------------------------------------------------------------------------
+//
+// ARP table
+//
+// The table is an open addressed hash table (linear probing) indexed by the
+// IP address. Every entry is located at most IP_ARP_MAX_PROBE slots behind
+// its hash slot, therefore a lookup touches only a few entries independent
+// of the table size. Removed entries are closed with backward shifting, no
+// tombstones are required.
+//
+//-----------------------------------------------------------------------------
+
+// hash slot of an IP address (network byte order)
+static unsigned long arp_hash(unsigned long ip)
 {
-	arp_table_entry *pTab,*pFirstFree,*pMaxAge = NULL;		// also used for ARP header in frame
-	struct in_addr	ipAddr;
-	unsigned int	maxAge,tmpAge;
+	// fold all 4 bytes into the low bits, the host part of the address changes most
+	ip = ip ^ (ip >> 16);
+	ip = ip ^ (ip >> 8);
 
-	copy_ip_address(&ipAddr , pIpAddr);
+	return ARP_SLOT(ip);
+}
 
-	// Walk through the ARP mapping table and try to find an entry to update.
-	// If none is found, return the first free entry, or otherwise the oldest entry
+// find the entry of an IP address, 0 if not in table
+static arp_table_entry *arp_lookup(IP_STACK_H hIp, unsigned long ip)
+{
+	arp_table_entry	*pTab;
+	unsigned long	slot = arp_hash(ip);
+	unsigned long	i;
 
-	pFirstFree	= 0;
-	maxAge		= 0;
-	for(pTab = hIp->arp_table ; pTab < hIp->arp_table + IP_ARP_TABSIZE ; pTab++)
+	for(i = IP_ARP_MAX_PROBE ; i ; i--, slot = ARP_SLOT(slot+1))
 	{
-		// Check if the source IP address of the incoming packet matches
-		// the IP address in this ARP table entry
-		if(ipAddr.S_un.S_addr == pTab->ip.S_un.S_addr)
-		{
-			// entry found, update
-			copy_eth_address(pTab->eth.addr, pMacAddr);
-			pTab->time = (unsigned short)hIp->time_s;
-			return 0;	// return 0 = entry was done
-		}
+		pTab = hIp->arp_table + slot;
 
-		// find the oldest entry
-		tmpAge = hIp->time_s - pTab->time;
-		if(tmpAge >= maxAge)
-		{
-			maxAge	= tmpAge;
-			pMaxAge	= pTab;
-		}
+		if(pTab->state == ARP_STATE_FREE) break;		// end of probe sequence
 
-		// try to find the first unused entry in the ARP table
-		if(pTab->ip.S_un.S_addr == 0 && pFirstFree==0) pFirstFree = pTab;
+		if(pTab->ip.S_un.S_addr == ip) return pTab;
 	}
 
-	if(pFirstFree) return pFirstFree;
-
-	return pMaxAge;
+	return 0;
 }
 
-void				ipArpUpdate		// update arp table
-(
-	IP_STACK_H		hIp,			// handle to IP stack
-	void			*pMacAddr,		// ptr to remote mac address
-	void			*pIpAddr		// ip address of remote host
-)
+// get a new entry for an IP address which is not in the table
+// (the oldest entry of the probe sequence is replaced if no entry is free)
+static arp_table_entry *arp_insert(IP_STACK_H hIp, unsigned long ip)
 {
-	arp_table_entry *pTab;
-	struct in_addr	ipAddr;
-	int	local;
+	arp_table_entry	*pTab, *pOldest = 0;
+	unsigned long	slot = arp_hash(ip);
+	unsigned long	i;
+	unsigned short	age, maxAge = 0;
 
-	copy_ip_address(&ipAddr , pIpAddr);
+	for(i = IP_ARP_MAX_PROBE ; i ; i--, slot = ARP_SLOT(slot+1))
+	{
+		pTab = hIp->arp_table + slot;
 
-	// do not take stations which are not in local subnet (to avoid that arp table is flooded with external addresses all having the same mac)
-	local = 0;
+		if(pTab->state == ARP_STATE_FREE)
+		{
+			pOldest = pTab;
+			break;
+		}
 
-	if((ipAddr.S_un.S_addr & hIp->netmask.S_un.S_addr) == hIp->subnet.S_un.S_addr) local=1;	// in local subnet ... enter in ARP-Table
+		// pending entries are only replaced if all other entries are pending too
+		age = (unsigned short)hIp->time_s - pTab->time;
+		if(pTab->state != ARP_STATE_PENDING) age |= 0x8000;
 
-#ifdef IP_SECONDARY_ADDRESS
-	if((ipAddr.S_un.S_addr & hIp->netmask2.S_un.S_addr) == hIp->subnet2.S_un.S_addr) local=1;	// in local subnet ... enter in ARP-Table
-#endif
+		if(pOldest == 0 || age >= maxAge)
+		{
+			maxAge	= age;
+			pOldest	= pTab;
+		}
+	}
 
-	if(local == 0) return;		// frame not in local subnet
+	if(pOldest->state != ARP_STATE_FREE)
+	{
+		IP_STAT( hIp->stat.arp_evict++ );
+		arp_release(hIp, pOldest);
+	}
 
-	// add mac-address to table ... and get free entry if ip was not yet there
-	pTab = ipArpAnnouncement(hIp,pMacAddr,pIpAddr);
+	pOldest->ip.S_un.S_addr	= ip;
+	pOldest->state			= ARP_STATE_RESOLVED;
+	pOldest->retry			= 0;
+	pOldest->pPending		= 0;
+	pOldest->time			= (unsigned short)hIp->time_s;
 
-	if(pTab==0) return;	// entry already updated
+	return pOldest;
+}
 
-	// Now, pNew the ARP table entry which we will fill with the new information
-	copy_eth_address(pTab->eth.addr, pMacAddr);
+// release queued packet and unresolved-counter of an entry (the entry itself stays in the table)
+static void arp_release(IP_STACK_H hIp, arp_table_entry *pEntry)
+{
+	if(pEntry->state == ARP_STATE_PENDING || pEntry->state == ARP_STATE_FAILED)
+	{
+		hIp->arp_unresolved--;
+	}
 
-	pTab->ip.S_un.S_addr	= ipAddr.S_un.S_addr;
-	pTab->time				= (unsigned short)hIp->time_s;
+	if(pEntry->pPending)
+	{
+		ip_buf_drop(pEntry->pPending);
+		pEntry->pPending = 0;
+	}
 }
 
-// get MAC address address of specified IP address
-// return 0 : OK
-// return SOCKET_ERROR
-int ipArpQuery(unsigned long ip, void *pMac)
+// remove an entry and shift the following entries of the probe sequence back
+static void arp_remove(IP_STACK_H hIp, arp_table_entry *pEntry)
 {
-	IP_STACK_H		hIp;
-	arp_table_entry *pTab;
+	unsigned long	hole = pEntry - hIp->arp_table;
+	unsigned long	slot = hole;
+	unsigned long	home;
 
-	// search through all IP stacks
-	for( hIp = hIpList ; hIp != 0 ; hIp = hIp->pNext)
+	arp_release(hIp, pEntry);
+	pEntry->state = ARP_STATE_FREE;
+
+	while(1)
 	{
-		// check if this is the local IP of this instance
-		if(hIp->local_ip_addr.S_un.S_addr == ip)
-		{
-			if(pMac) copy_eth_address(pMac, &hIp->local_eth_addr);
-			return 0;
-		}
+		slot = ARP_SLOT(slot+1);
+		pEntry = hIp->arp_table + slot;
 
-        // check ARP list
-		for(pTab = hIp->arp_table ; pTab < hIp->arp_table + IP_ARP_TABSIZE ; pTab++)
-		{
-			// Check if the source IP address of the incoming packet matches
-			// the IP address in this ARP table entry
-			
-			if(pTab->ip.S_un.S_addr != ip) continue;		// try next
+		if(pEntry->state == ARP_STATE_FREE) break;
 
-			if(pMac) copy_eth_address(pMac, &pTab->eth);	// copy address to user var
+		// the entry can fill the hole if the hole is between its hash slot and its current slot
+		home = arp_hash(pEntry->ip.S_un.S_addr);
+		if(ARP_SLOT(slot - home) < ARP_SLOT(slot - hole)) continue;
 
-			// test again (to make sure to get consistent data because IRQ may modify table entries)
-			if(pTab->ip.S_un.S_addr != ip) continue;
+		hIp->arp_table[hole] = *pEntry;
+		pEntry->state	= ARP_STATE_FREE;
+		hole			= slot;
+	}
+}
+
+// start resolution of an unknown IP address
+// return 1 : packet was queued until the reply is received, or dropped
+// return 0 : packet was not taken (pBuf is 0 or no buffer for the arp request available)
+static int arp_resolve(IP_STACK_H hIp, struct in_addr *pIp, ip_buf_type *pBuf)
+{
+	arp_table_entry	*pEntry = arp_lookup(hIp, pIp->S_un.S_addr);
+	ip_buf_type		*pReq;
+
+	if(pEntry == 0)
+	{
+		IP_STAT( hIp->stat.arp_miss++ );
+
+		pEntry = arp_insert(hIp, pIp->S_un.S_addr);
+		pEntry->state = ARP_STATE_PENDING;
+		pEntry->retry = 1;
+		hIp->arp_unresolved++;
+
+		pReq = ip_alloc_tx_buffer(hIp);
+		if(pReq == 0) return 0;		// the request is repeated by ipPeriodic()
+
+		prepareArpReq(hIp, pReq, pIp, 0);
+		ip_buf_queue(hIp, pReq);
+	}
+	else if(pEntry->state == ARP_STATE_FAILED)
+	{
+		IP_STAT( hIp->stat.arp_neg_hit++ );	// host did not answer recently, do not flood the network
+
+		if(pBuf) ip_buf_drop(pBuf);
+		return 1;
+	}
+
+	if(pBuf == 0 || pEntry->pPending == pBuf) return 1;
+
+	if(pEntry->pPending == 0)
+	{
+		IP_STAT( hIp->stat.arp_queued++ );
+
+		// the entry owns the packet like the tx queue, a socket which is freed meanwhile leaves it here
+		EnableGlobalInterrupt(FALSE);
+		ip_buf_mark_queued(pBuf);
+		EnableGlobalInterrupt(TRUE);
+
+		pEntry->pPending = pBuf;	// send packet when the reply is received
+	}
+	else
+	{
+		IP_STAT( hIp->stat.arp_queue_drop++ );
+		ip_buf_drop(pBuf);
+	}
+
+	return 1;
+}
+
+// mac address of an entry received
+static void arp_complete(IP_STACK_H hIp, arp_table_entry *pEntry, void *pMacAddr)
+{
+	ip_buf_type	*pBuf;
+
+	copy_eth_address(pEntry->eth.addr, pMacAddr);
+	pEntry->time = (unsigned short)hIp->time_s;
+
+	if(pEntry->state == ARP_STATE_RESOLVED) return;
+
+	hIp->arp_unresolved--;
+	pEntry->state = ARP_STATE_RESOLVED;
+
+	// send queued packet
+	pBuf = pEntry->pPending;
+	if(pBuf)
+	{
+		pEntry->pPending = 0;
+		copy_eth_address(pBuf->data.frame.eth.dst_hw, pEntry->eth.addr);
+
+		EnableGlobalInterrupt(FALSE);
+		ip_buf_enqueue(hIp, pBuf);	// already marked by arp_resolve()
+		EnableGlobalInterrupt(TRUE);
+	}
+}
+
+// periodic arp table handling
+//	refresh = 0 : (every second) repeat requests of pending entries, remove expired failed entries
+//	refresh = 1 : (every IP_ARP_REFRESH_S) additionally remove entries which have reached IP_ARP_MAXAGE
+static void arp_age(IP_STACK_H hIp, int refresh)
+{
+	arp_table_entry	*pTab = hIp->arp_table;
+	unsigned short	age;
+
+	while(pTab < hIp->arp_table + IP_ARP_TABSIZE)
+	{
+		age = (unsigned short)hIp->time_s - pTab->time;
+
+		switch(pTab->state)
+		{
+			case ARP_STATE_RESOLVED:
+				if(refresh && age >= IP_ARP_MAXAGE)
+				{
+					arp_remove(hIp, pTab);
+					continue;	// a following entry may have been shifted to this slot
+				}
+				break;
+
+			case ARP_STATE_PENDING:
+				if(pTab->retry < IP_ARP_PENDING_RETRY)
+				{
+					pTab->retry++;
+					sendArpRequest(hIp, &pTab->ip);
+				}
+				else
+				{
+					IP_STAT( hIp->stat.arp_timeout++ );
+
+					// no reply, drop queued packet and keep entry as negative cache entry
+					if(pTab->pPending)
+					{
+						ip_buf_drop(pTab->pPending);
+						pTab->pPending = 0;
+					}
+					pTab->state	= ARP_STATE_FAILED;
+					pTab->time	= (unsigned short)hIp->time_s;
+				}
+				break;
+
+			case ARP_STATE_FAILED:
+				if(age >= IP_ARP_NEGATIVE_S)
+				{
+					arp_remove(hIp, pTab);
+					continue;	// a following entry may have been shifted to this slot
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		pTab++;
+	}
+}
+
+void*				ipArpAnnouncement		// update arp table (only if entry is already there)
+(
+ IP_STACK_H		hIp,			// handle to IP stack
+ void			*pMacAddr,		// ptr to remote mac address
+ void			*pIpAddr		// ip address of remote host
+)
+{
+	arp_table_entry *pTab;
+	struct in_addr	ipAddr;
+
+	copy_ip_address(&ipAddr , pIpAddr);
+
+	pTab = arp_lookup(hIp, ipAddr.S_un.S_addr);
+
+	// entry found, update (this also completes pending and failed resolutions)
+	if(pTab) arp_complete(hIp, pTab, pMacAddr);
+
+	return pTab;
+}
+
+void				ipArpUpdate		// update arp table
+(
+	IP_STACK_H		hIp,			// handle to IP stack
+	void			*pMacAddr,		// ptr to remote mac address
+	void			*pIpAddr		// ip address of remote host
+)
+{
+	arp_table_entry *pTab;
+	struct in_addr	ipAddr;
+	int	local;
 
+	copy_ip_address(&ipAddr , pIpAddr);
+
+	// do not take stations which are not in local subnet (to avoid that arp table is flooded with external addresses all having the same mac)
+	local = 0;
+
+	if((ipAddr.S_un.S_addr & hIp->netmask.S_un.S_addr) == hIp->subnet.S_un.S_addr) local=1;	// in local subnet ... enter in ARP-Table
+
+#ifdef IP_SECONDARY_ADDRESS
+	if((ipAddr.S_un.S_addr & hIp->netmask2.S_un.S_addr) == hIp->subnet2.S_un.S_addr) local=1;	// in local subnet ... enter in ARP-Table
+#endif
+
+	if(local == 0) return;		// frame not in local subnet
+
+	// update mac-address if ip is already in the table
+	if(ipArpAnnouncement(hIp,pMacAddr,pIpAddr)) return;
+
+	// Now, get the ARP table entry which we will fill with the new information
+	pTab = arp_insert(hIp, ipAddr.S_un.S_addr);
+
+	copy_eth_address(pTab->eth.addr, pMacAddr);
+}
+
+// get MAC address address of specified IP address
+// return 0 : OK
+// return SOCKET_ERROR
+int ipArpQuery(unsigned long ip, void *pMac)
+{
+	IP_STACK_H		hIp;
+	arp_table_entry *pTab;
+
+	// search through all IP stacks
+	for( hIp = hIpList ; hIp != 0 ; hIp = hIp->pNext)
+	{
+		// check if this is the local IP of this instance
+		if(hIp->local_ip_addr.S_un.S_addr == ip)
+		{
+			if(pMac) copy_eth_address(pMac, &hIp->local_eth_addr);
 			return 0;
 		}
+
+        // check ARP table
+		pTab = arp_lookup(hIp, ip);
+
+		if(pTab == 0 || pTab->state != ARP_STATE_RESOLVED) continue;		// try next
+
+		if(pMac) copy_eth_address(pMac, &pTab->eth);	// copy address to user var
+
+		// test again (to make sure to get consistent data because IRQ may modify table entries)
+		if(pTab->ip.S_un.S_addr != ip || pTab->state != ARP_STATE_RESOLVED) continue;
+
+		return 0;
 	}
 
 	return SOCKET_ERROR;
@@ -1523,7 +1965,11 @@ int ipArpRequest(unsigned long ip, void *pMac)
 		if ((hIp->local_ip_addr.S_un.S_addr & hIp->subnet.S_un.S_addr) == (ip & hIp->subnet.S_un.S_addr) )
 		{
 			// the requested IP address fits to this network ... generate ARP request
-			sendArpRequest(hIp, (struct in_addr*)&ip );
+			// (only once for pending resolutions, not at all if the host did not answer recently)
+			if(arp_resolve(hIp, (struct in_addr*)&ip, 0) == 0)
+			{
+				sendArpRequest(hIp, (struct in_addr*)&ip );
+			}
 			break;
 		}
 	}
@@ -1561,7 +2007,19 @@ static void ip_arp_in(IP_STACK_H hIp, eth_frame *pFrame)
 		}
 
 
-		if(pArpIn->opcode ==  HTONS(ARP_REPLY))
+		// announcement (RFC5227): sender and target ip address are the same
+		if( memcmp(pArpIn->dst_ip, pArpIn->src_ip, 4) == 0 )
+		{
+			if(pArpIn->src_hw[0] != 0xFFFF)	// normal ARP announcement
+			{
+				ipArpAnnouncement(hIp, pArpIn->src_hw, pArpIn->src_ip);
+			}
+			else	// source-hw is set to broadcast ... use the senders source-MAC in MAC-header
+			{
+				ipArpAnnouncement(hIp, pFrame->eth.src_hw, pArpIn->src_ip);
+			}
+		}
+		else if(pArpIn->opcode ==  HTONS(ARP_REPLY))
 		{
 			ipArpUpdate(hIp, pArpIn->src_hw, pArpIn->src_ip);
 		}
@@ -1604,17 +2062,6 @@ static void ip_arp_in(IP_STACK_H hIp, eth_frame *pFrame)
 
 			ip_buf_send(hIp,pBuf,0);	// send packet with reply to to network
 		}
-		else if(pArpIn->opcode == HTONS(ARP_ANNOUNCEMENT))
-		{
-			if(pArpIn->src_hw[0] != 0xFFFF)	// normal ARP announcement (RFC5227)
-			{
-				ipArpAnnouncement(hIp, pArpIn->src_hw, pArpIn->src_ip);
-			}
-			else	// source-hw is set to broadcast ... use the senders source-MAC in MAC-header
-			{
-				ipArpAnnouncement(hIp, pFrame->eth.src_hw, pArpIn->src_ip);
-			}
-		}
 	}
 }
 
@@ -1646,18 +2093,35 @@ static void ip_icmp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLe
 
 	pICMP = (icmp_hdr*)((char*)&pBuf->data.frame.prot.ip + ipHdrLen);
 
+	// change type and update checksum incrementally (type and code share one word)
+	chksum = *(unsigned short*)&pICMP->type;
 	pICMP->type = ICMP_ECHO_REPLY;
-
-	// update checksum
-	chksum = pICMP->chksum;
-	if(chksum >= HTONS(0xFFFF - (ICMP_ECHO << 8))) chksum++;
-	pICMP->chksum = chksum + HTONS(ICMP_ECHO << 8);
+	pICMP->chksum = ip_chksum_adjust(pICMP->chksum, chksum, *(unsigned short*)&pICMP->type);
 
 	IP_STAT( hIp->stat.icmp_tx++);
 
 	ip_buf_send(hIp, pBuf, TX_IP_REPLY);
 }
 
+//-----------------------------------------------------------------------------
+// find the listen entry of a UDP port (network byte order), 0 if not listening
+static listen_type *ip_udp_find(IP_STACK_H hIp, unsigned long lport)
+{
+	listen_type		*pList;
+	unsigned char	link = hIp->listen_udp_hash[IP_PORT_HASH(lport)];
+
+	while(link)
+	{
+		pList = hIp->listen_udp + link - 1;
+
+		if(pList->lport == lport) return pList;
+
+		link = pList->next;
+	}
+
+	return 0;
+}
+
 //-----------------------------------------------------------------------------
 static void ip_udp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 {
@@ -1671,26 +2135,24 @@ static void ip_udp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen
 	#endif
 
 	// search for udp connection with this port
-	for(pList = hIp->listen_udp ; pList < hIp->listen_udp + IP_LISTEN_PORTS_UDP ; pList++)
+	pList = ip_udp_find(hIp, pUDP->dst_port);
+	if(pList)
 	{
-		if(pList->lport != 0  &&  pList->lport == pUDP->dst_port)
-		{
-			// UDP connection with this local port found ... callback to application
+		// UDP connection with this local port found ... callback to application
 
-			// create info structure
-			info.pData			= ((char*)pUDP)+sizeof(udp_hdr);
-			info.len			= htons(pUDP->len)-sizeof(udp_hdr);
-			info.localPort		= htons(pUDP->dst_port);
-			info.remotePort		= htons(pUDP->src_port);
-			info.pRemoteMac		= (eth_addr*)&pFrame->eth.src_hw;
+		// create info structure
+		info.pData			= ((char*)pUDP)+sizeof(udp_hdr);
+		info.len			= htons(pUDP->len)-sizeof(udp_hdr);
+		info.localPort		= htons(pUDP->dst_port);
+		info.remotePort		= htons(pUDP->src_port);
+		info.pRemoteMac		= (eth_addr*)&pFrame->eth.src_hw;
 
-			copy_ip_address(&info.remoteHost, pIP->src_ip);
-			copy_ip_address(&info.localHost,  pIP->dst_ip);
+		copy_ip_address(&info.remoteHost, pIP->src_ip);
+		copy_ip_address(&info.localHost,  pIP->dst_ip);
 
-			pList->pFct(pList->arg, &info);
+		pList->pFct(pList->arg, &info);
 
-			return;
-		}
+		return;
 	}
 
 	// dispatch default ports
@@ -1708,6 +2170,68 @@ static void ip_udp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen
 	}
 }
 
+/*********************************************************************************
+
+  Function    : ip_udp_buf
+  Description : get the tx buffer of a payload pointer returned by ipUdpReserve()
+
+  Parameter:
+	hIp		: handle of used interface
+	pData	: ptr to the udp payload inside the tx buffer
+
+  Return Value:
+	ptr to the reserved tx buffer
+	0 ... pointer does not belong to a reserved buffer of this interface
+*********************************************************************************/
+static ip_buf_type* ip_udp_buf(IP_STACK_H hIp, void *pData)
+{
+	ip_buf_type	*pBuf;
+
+	pBuf = GET_TYPE_BASE(ip_buf_type, data.frame.prot.ip, ((char*)pData) - sizeof(ip_hdr) - sizeof(udp_hdr));
+
+	if(pBuf < hIp->pTxBuffer || pBuf >= hIp->pTxBuffer + IP_TX_BUF_CNT) return 0;
+	if(pData != UDP_DATA(pBuf)) return 0;
+	if(pBuf->header.state != IP_BUF_STATE_TX) return 0;
+
+	return pBuf;
+}
+
+/*********************************************************************************
+
+  Function    : ip_udp_out
+  Description : complete ip and udp header of a tx buffer and send it
+
+  Parameter:
+	hIp		: handle of used interface
+	pBuf	: tx buffer with the udp payload already in place
+	pInfo	: ptr to structure with connection info
+	len		: length of the udp payload
+*********************************************************************************/
+static void ip_udp_out(IP_STACK_H hIp, ip_buf_type *pBuf, ip_udp_info *pInfo, unsigned long len)
+{
+	void		*ptr;
+
+	// prepare IP header
+	ptr = &pBuf->data.frame.prot.ip;
+	
+	IP(ptr)->len	= sizeof(ip_hdr) + sizeof(udp_hdr) + len;
+	IP(ptr)->proto	= IPPROTO_UDP;
+
+	copy_ip_address(IP(ptr)->dst_ip, &pInfo->remoteHost);
+
+	// prepare udp header and send
+	ptr = (udp_hdr*)(((char*)ptr) + sizeof(ip_hdr));
+
+	UDP(ptr)->dst_port	= htons(pInfo->remotePort);
+	UDP(ptr)->src_port	= htons(pInfo->localPort);
+	UDP(ptr)->len		= htons((unsigned short)(len + sizeof(udp_hdr)));
+	UDP(ptr)->chksum	= 0;
+
+	IP_STAT(hIp->stat.udp_tx++);
+
+	ip_buf_send(hIp, pBuf, TX_IP_HEADER);	// send frame
+}
+
 /*********************************************************************************
 
   Function    : ipUdpSend
@@ -1724,14 +2248,46 @@ static void ip_udp_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen
 *********************************************************************************/
 int ipUdpSend(IP_STACK_H hIp, ip_udp_info *pInfo)
 {
-	ip_buf_type	*pBuf;
-	void		*ptr;
+	ip_udp_seg	seg;
+
+	if(pInfo==0) return -1;
+
+	seg.pData	= pInfo->pData;
+	seg.len		= pInfo->len;
+
+	return ipUdpSendv(hIp, pInfo, &seg, 1);
+}
+
+/*********************************************************************************
+
+  Function    : ipUdpSendv
+  Description : send UDP frame which is given as a list of segments
+				(the segments are copied directly to the tx buffer)
+
+  Parameter:
+	hIp		: handle of used interface
+	pInfo	: ptr to structure with connection info (pData and len are not used)
+	pSeg	: ptr to array of payload segments
+	segCnt	: number of segments
+
+  Return Value:
+	>0 ... number of sent bytes (sum of all segments)
+	0  ... no send buffer available or driver not yet ready, try again
+	-1 ... Error (hIp=0 or length too big)
+*********************************************************************************/
+int ipUdpSendv(IP_STACK_H hIp, ip_udp_info *pInfo, const ip_udp_seg *pSeg, unsigned long segCnt)
+{
+	ip_buf_type		*pBuf;
+	unsigned char	*pDst;
+	unsigned long	len,i;
 
 	// check pointers
-	if(hIp==0 || pInfo==0) return -1;
+	if(hIp==0 || pInfo==0 || (pSeg==0 && segCnt)) return -1;
 
 	// check maximum send length
-	if(pInfo->len > IP_MTU - sizeof(ip_hdr)-sizeof(udp_hdr)) return -1;
+	for(i=0, len=0 ; i<segCnt ; i++) len += pSeg[i].len;
+
+	if(len > IP_MTU - sizeof(ip_hdr)-sizeof(udp_hdr)) return -1;
 	
 	// not ready and no broadcast
 	if((hIp->state != IP_STATE_OK) && (pInfo->remoteHost.S_un.S_addr !=0xFFFFFFFF)) return 0;
@@ -1740,31 +2296,107 @@ int ipUdpSend(IP_STACK_H hIp, ip_udp_info *pInfo)
 
 	if(pBuf==0) return 0;	// no tx buffer available
 
-	// prepare IP header
-	ptr = &pBuf->data.frame.prot.ip;
-	
-	IP(ptr)->len	= sizeof(ip_hdr) + sizeof(udp_hdr) + pInfo->len;
-	IP(ptr)->proto	= IPPROTO_UDP;
+	// gather udp data to send buffer
+	for(i=0, pDst = UDP_DATA(pBuf) ; i<segCnt ; i++)
+	{
+		memcpy(pDst, pSeg[i].pData, pSeg[i].len);
+		pDst += pSeg[i].len;
+	}
 
-	copy_ip_address(IP(ptr)->dst_ip, &pInfo->remoteHost);
+	ip_udp_out(hIp, pBuf, pInfo, len);
 
-	// prepare udp frame and send
-	ptr = (udp_hdr*)(((char*)ptr) + sizeof(ip_hdr));
+	return len;
+}
 
-	memcpy( UDP(ptr)+1 , pInfo->pData, pInfo->len);			// copy udp data to send buffer
+/*********************************************************************************
 
-	UDP(ptr)->dst_port	= htons(pInfo->remotePort);
-	UDP(ptr)->src_port	= htons(pInfo->localPort);
-	UDP(ptr)->len		= htons((unsigned short)(pInfo->len + sizeof(udp_hdr)));
-	UDP(ptr)->chksum	= 0;
+  Function    : ipUdpReserve
+  Description : reserve a tx buffer for an UDP frame, the caller writes the
+				payload directly to the buffer and sends it with ipUdpCommit()
+				or releases it with ipUdpRelease()
 
-	IP_STAT(hIp->stat.udp_tx++);
+  Parameter:
+	hIp		: handle of used interface
+	maxLen	: maximum payload length the caller will write
 
-	ip_buf_send(hIp, pBuf, TX_IP_HEADER);	// send frame
+  Return Value:
+	ptr to the payload area of the buffer (maxLen bytes can be written)
+	0 ... no tx buffer available, length too big or hIp=0
+*********************************************************************************/
+void* ipUdpReserve(IP_STACK_H hIp, unsigned long maxLen)
+{
+	ip_buf_type	*pBuf;
+
+	if(hIp==0) return 0;
+
+	if(maxLen > IP_MTU - sizeof(ip_hdr)-sizeof(udp_hdr)) return 0;
+
+	pBuf = ip_alloc_tx_buffer(hIp);	// get tx buffer
+
+	if(pBuf==0) return 0;	// no tx buffer available
+
+	return UDP_DATA(pBuf);
+}
+
+/*********************************************************************************
+
+  Function    : ipUdpCommit
+  Description : send an UDP frame reserved with ipUdpReserve()
+
+  Parameter:
+	hIp		: handle of used interface
+	pInfo	: ptr to structure with connection info
+			  (pData = ptr returned by ipUdpReserve(), len = number of written bytes)
+
+  Return Value:
+	>0 ... number of sent bytes
+	0  ... driver not yet ready, the buffer stays reserved (try again or release it)
+	-1 ... Error (hIp=0, length too big or no reserved buffer, the buffer is released)
+*********************************************************************************/
+int ipUdpCommit(IP_STACK_H hIp, ip_udp_info *pInfo)
+{
+	ip_buf_type	*pBuf;
+
+	if(hIp==0 || pInfo==0) return -1;
+
+	pBuf = ip_udp_buf(hIp, pInfo->pData);
+
+	if(pBuf==0) return -1;
+
+	if(pInfo->len > IP_MTU - sizeof(ip_hdr)-sizeof(udp_hdr))
+	{
+		pBuf->header.state = IP_BUF_STATE_IDLE;
+		return -1;
+	}
+
+	// not ready and no broadcast
+	if((hIp->state != IP_STATE_OK) && (pInfo->remoteHost.S_un.S_addr !=0xFFFFFFFF)) return 0;
+
+	ip_udp_out(hIp, pBuf, pInfo, pInfo->len);
 
 	return pInfo->len;
 }
 
+/*********************************************************************************
+
+  Function    : ipUdpRelease
+  Description : release a tx buffer reserved with ipUdpReserve() without sending
+
+  Parameter:
+	hIp		: handle of used interface
+	pData	: ptr returned by ipUdpReserve()
+*********************************************************************************/
+void ipUdpRelease(IP_STACK_H hIp, void *pData)
+{
+	ip_buf_type	*pBuf;
+
+	if(hIp==0 || pData==0) return;
+
+	pBuf = ip_udp_buf(hIp, pData);
+
+	if(pBuf) pBuf->header.state = IP_BUF_STATE_IDLE;
+}
+
 
 /*********************************************************************************
 
@@ -1785,7 +2417,6 @@ int ipUdpSend(IP_STACK_H hIp, ip_udp_info *pInfo)
 *********************************************************************************/
 int	ipPacketReceive(IP_STACK_H hIp, ip_packet_typ *pPacket, IP_BUF_FREE_FCT *pFct)
 {
-	struct in_addr	ipAddr;
 	ip_rx_queue_typ	*pQueue;
 	eth_frame		*pFrame;
 
@@ -1796,6 +2427,102 @@ int	ipPacketReceive(IP_STACK_H hIp, ip_packet_typ *pPacket, IP_BUF_FREE_FCT *pFc
 
 	pFrame = (eth_frame*)pPacket->data;
 
+	if( ip_rx_filter(hIp, pFrame) )
+	{
+		// add to receive queue and increment rx buf write index
+		pQueue = hIp->pRxWrite;
+		
+		if(pQueue->pPacket==0)	// queue entry free
+		{
+			IP_STAT(hIp->stat.packets_used++);	// count incoming packets
+
+			pQueue->pFct	= pFct;			// release function of the buffer
+			pQueue->pPacket	= pPacket;		// write info to queue
+
+			hIp->pRxWrite = pQueue->pNext;	// set to next queue element
+
+			return 0;
+		}
+		else
+		{
+			// queue full, free buffer and return
+			IP_STAT(hIp->stat.packets_queue_full++);	// count incoming packets
+		}
+	}
+
+	return -1;
+}
+
+/*********************************************************************************
+
+  Function    : ipPacketProcess
+  Description : process a received frame immediately without taking it over
+				(for driver buffers which are only valid during the call)
+
+				Only frames which the stack would not keep after processing are
+				accepted: no fragments, no frames for sockets and only if no
+				other received frames are waiting in the rx queue.
+
+				The frame is only read. UDP hooks get pointers into the frame,
+				which are valid until the hook returns (see IP_HOOKFCT).
+
+  Parameter:
+	hIp		: handle of used interface
+	pData	: ptr to the ethernet frame
+	len		: number of valid bytes in the frame
+
+  Returns:
+	0  ... frame was processed or discarded, it is not referenced anymore
+	-1 ... frame not processed, pass a copy with ipPacketReceive()
+
+*********************************************************************************/
+int	ipPacketProcess(IP_STACK_H hIp, void *pData, unsigned long len)
+{
+	eth_frame		*pFrame = (eth_frame*)pData;
+	IP_BUF_FREE_FCT	*pFct = 0;		// nothing to release after processing
+
+	if(pData==0 || hIp==0 || len < sizeof(eth_hdr)) return -1;
+
+	// keep the order of received frames
+	if(hIp->pRxRead->pPacket) return -1;
+
+	if(pFrame->eth.type == HTONS(IP_ETHTYPE_IP))
+	{
+		// fragments are held by the reassembly
+		if(pFrame->prot.ip.ipoffset & HTONS(0x3FFF)) return -1;
+
+		// sockets keep the frame until the user has read the data
+		#if IP_TCP_SOCKETS > 0
+			if(pFrame->prot.ip.proto == IPPROTO_TCP || pFrame->prot.ip.proto == IPPROTO_UDP) return -1;
+		#endif
+	}
+
+	hIp->stat.rxPackets++;
+
+	if( ip_rx_filter(hIp, pFrame) )
+	{
+		IP_STAT(hIp->stat.packets_used++);	// count incoming packets
+
+		processFrame(hIp, pFrame, &pFct);
+	}
+
+	return 0;
+}
+
+/*********************************************************************************
+
+  Function    : ip_rx_filter
+  Description : pre-filter of received frames
+
+  Returns:
+	1 ... frame has to be processed by the stack
+	0 ... frame is not used (not ARP or IP, or not for the local ip address)
+
+*********************************************************************************/
+static int ip_rx_filter(IP_STACK_H hIp, eth_frame *pFrame)
+{
+	struct in_addr	ipAddr;
+
 	// filter to discard frames which are not used
 	if (pFrame->eth.type == HTONS(IP_ETHTYPE_IP))
 	{
@@ -1813,7 +2540,6 @@ int	ipPacketReceive(IP_STACK_H hIp, ip_packet_typ *pPacket, IP_BUF_FREE_FCT *pFc
 		if( memcmp(pFrame->prot.arp.dst_ip, pFrame->prot.arp.src_ip, 4) == 0 )
 		{
 			ipAddr.S_un.S_addr = hIp->local_ip_addr.S_un.S_addr;
-			pFrame->prot.arp.opcode = HTONS(ARP_ANNOUNCEMENT);	// mark frame as announcement frame
 		}
 		else
 		{
@@ -1825,7 +2551,7 @@ int	ipPacketReceive(IP_STACK_H hIp, ip_packet_typ *pPacket, IP_BUF_FREE_FCT *pFc
 	}
 	else
 	{
-		return -1;	// not ARP and not IP, re-use buffer for the next time
+		return 0;	// not ARP and not IP, re-use buffer for the next time
 	}
 
 	// ip frame not for local ip, discard frame, re-use buffer for the next frame
@@ -1835,30 +2561,10 @@ int	ipPacketReceive(IP_STACK_H hIp, ip_packet_typ *pPacket, IP_BUF_FREE_FCT *pFc
 	if(ipAddr.S_un.S_addr == hIp->local_ip_addr.S_un.S_addr )
 #endif
 	{
-		// add to receive queue and increment rx buf write index
-		pQueue = hIp->pRxWrite;
-		
-		if(pQueue->pPacket==0)	// queue entry free
-		{
-			IP_STAT(hIp->stat.packets_used++);	// count incoming packets
-
-			// store callback function inside the frame (first 4 bytes of dst-mac)
-			((ip_int_hdr*)pFrame)->pFct = pFct;
-			
-			pQueue->pPacket	= pPacket;		// write info to queue
-
-			hIp->pRxWrite = pQueue->pNext;	// set to next queue element
-
-			return 0;
-		}
-		else
-		{
-			// queue full, free buffer and return
-			IP_STAT(hIp->stat.packets_queue_full++);	// count incoming packets
-		}
+		return 1;
 	}
 
-	return -1;
+	return 0;
 }
 
 // get ip stack state
@@ -1869,157 +2575,356 @@ unsigned short	ipGetState(IP_STACK_H hIp)
 
 #if IP_REASS_BUF_CNT > 0
 
-// local variable which only hold the bitmasks for the reassembly algorithm
-static const unsigned char bitmask[] = {0xFF,0x7F,0x3F,0x1F,0x0F,0x07,0x03,0x01,0x00};
+//-----------------------------------------------------------------------------
+//
+// IP reassembly
+//
+// The fragments of a datagram are held by reference in the received frames
+// (the free function of the frame is taken over like in sock_in()). Missing
+// parts of the datagram are tracked with a hole list (RFC 815). When the last
+// hole is closed all fragments are copied to a reassembly buffer and the
+// frames are released.
+//
+// If a frame can not be held anymore (IP_REASS_FRAG_CNT or IP_REASS_MEM
+// reached) the datagram is linearized early: the held fragments are copied to
+// a reassembly buffer and the following fragments are copied directly. Every
+// payload byte is copied exactly once in both cases.
+//
+//-----------------------------------------------------------------------------
+
+// largest payload of a reassembled datagram
+#define REASS_MAX_PAYLOAD	(IP_MTU - sizeof(ip_hdr))
+
+// release all frames and the buffer of a datagram
+static void ip_reass_release(IP_STACK_H hIp, reass_dgram_type *pDg)
+{
+	reass_frag_type	*pFrag;
+
+	while(pDg->pFrag)
+	{
+		pFrag		= pDg->pFrag;
+		pDg->pFrag	= pFrag->pNext;
+
+		if(pFrag->pFctFree) pFrag->pFctFree(pFrag->pPacket);
+
+		pFrag->pNext		= hIp->pReassFragFree;
+		hIp->pReassFragFree	= pFrag;
+	}
 
+	hIp->reassMem	-= pDg->memUsed;
+	pDg->memUsed	= 0;
+	pDg->fragCnt	= 0;
 
+	// buffer of an incomplete datagram is still owned by the reassembly
+	if(pDg->pBuf && pDg->state == REASS_STATE_ACTIVE)
+	{
+		pDg->pBuf->pOwner				= 0;
+		pDg->pBuf->buf.header.state		= IP_BUF_STATE_IDLE;
+	}
+}
 
-static reass_buf_type *ip_reass(IP_STACK_H hIp, eth_frame *pFrame)
+// drop a datagram, fragments arriving later are counted as late
+static void ip_reass_drop(IP_STACK_H hIp, reass_dgram_type *pDg)
 {
-	unsigned short		len, hdrLen;
-	unsigned short		offset;
-	reass_buf_type		*pBuf;
-	unsigned char		*pByte,*pBitmap;
+	ip_reass_release(hIp, pDg);
 
-// 	logReass( pFrame->prot.ip.ipid, pFrame->prot.ip.ipoffset);
-// 	if(pFrame->prot.ip.ipoffset == 105) assert(0);
+	pDg->state = REASS_STATE_DROPPED;
+	pDg->pBuf  = 0;
+}
 
-	// loop through reassembly buffers and decrement timer (buffers with timer=0) will be deleted if the 
-	// memory is required
-	pBuf	= hIp->pReassBuffer;	// set to first reassembly buffer (after mac rx buffers)
-	offset	= 0;
+// find the datagram of a fragment (same ipid, source and destination)
+static reass_dgram_type *ip_reass_find(IP_STACK_H hIp, eth_frame *pFrame)
+{
+	reass_dgram_type	*pDg;
 
-	for(len=1;len<=IP_REASS_BUF_CNT;len++ , pBuf++)
+	for(pDg = hIp->reass ; pDg < hIp->reass + IP_REASS_DGRAM_CNT ; pDg++)
 	{
-		// check if this ip datagram is already somewhere in the reassembly buffers
-		if(pBuf->buf.data.frame.prot.ip.ipid == pFrame->prot.ip.ipid
+		if(pDg->state == REASS_STATE_FREE) continue;
+
+		if(pDg->ip.ipid == pFrame->prot.ip.ipid
 			&&
-			memcmp(pBuf->buf.data.frame.prot.ip.src_ip, pFrame->prot.ip.src_ip,8) == 0 )
+			memcmp(pDg->ip.src_ip, pFrame->prot.ip.src_ip, 8) == 0 )
 		{
-			// skip packet completely if a buffer is existing with the same ipid/srcip/dstip
-			// (the received fragment is either too late and the reass buffer was dropped becuase
-			// of timeout or the fragment was duplicated somewhere on the way and first copy
-			// arrived already
-			if(pBuf->timer == 0)
-			{
-				IP_STAT( hIp->stat.ip_reass_late_rx++);
-				return 0;
-			}
-			
-			offset = len;	// use this reassembly buffer (remember index and finish for-loop)
-			break;			// stop loop and proceed with reassembly
+			return pDg;
 		}
-
-		// store buffer index if timer is elapsed (buffer free)
-		if(offset==0 && pBuf->buf.header.state == IP_BUF_STATE_IDLE) offset = len;
 	}
 
-	if(offset==0) return 0;		// no existing reassembly buffer for this frame found or no free buffer available
-	
-	hdrLen	= (pFrame->prot.ip.vhl & 0xF)*4;			// length of ip header
-	pBuf	= hIp->pReassBuffer + offset - 1;
-	pBitmap	= pBuf->bitmap;
+	return 0;
+}
+
+// get a descriptor for a new datagram, finished datagrams are reused
+static reass_dgram_type *ip_reass_new(IP_STACK_H hIp, eth_frame *pFrame)
+{
+	reass_dgram_type	*pDg, *pUse = 0;
 
-	// new fragment buffer, initialize with headers
-	if(pBuf->timer==0)
+	for(pDg = hIp->reass ; pDg < hIp->reass + IP_REASS_DGRAM_CNT ; pDg++)
 	{
-		pBuf->timer = IP_REASS_MAXAGE;
-		pBuf->buf.header.dataSize = 0;	// will be set to ip payload length when last packet is received
+		if(pDg->state == REASS_STATE_FREE)
+		{
+			pUse = pDg;
+			break;
+		}
 
-		// copy the ethernet + ip header to the buffer, ip-options are ignored
-		// (too complicated to handle options of fragmented datagrams)
-		memcpy(&pBuf->buf.data.frame , pFrame , sizeof(eth_hdr) + hdrLen);
-		memset(pBitmap,0xFF,sizeof(pBuf->bitmap));						// clear the bitmap
+		// keep the descriptor if its buffer is held for a retry
+		if(pDg->state == REASS_STATE_ACTIVE) continue;
+		if(pDg->pBuf && pDg->pBuf->pOwner == pDg && pDg->pBuf->timer) continue;
+
+		if(pUse==0) pUse = pDg;
 	}
 
-	// get length and offset from header
-	len		= htons(pFrame->prot.ip.len) - hdrLen;
-	offset	= htons(pFrame->prot.ip.ipoffset);
+	if(pUse==0) return 0;
+
+	if(pUse->pBuf && pUse->pBuf->pOwner == pUse) pUse->pBuf->pOwner = 0;
+
+	memcpy(&pUse->eth, &pFrame->eth,     sizeof(eth_hdr));
+	memcpy(&pUse->ip,  &pFrame->prot.ip, sizeof(ip_hdr));
 
-	if((offset & IP_FRAG_FLAG_MORE) == 0)	// last fragment
+	pUse->state			= REASS_STATE_ACTIVE;
+	pUse->timer			= IP_REASS_MAXAGE;
+	pUse->pFrag			= 0;
+	pUse->pBuf			= 0;
+	pUse->memUsed		= 0;
+	pUse->fragCnt		= 0;
+	pUse->holeCnt		= 1;
+	pUse->hole[0].first	= 0;
+	pUse->hole[0].last	= 0xFFFF;	// end is unknown until the last fragment arrives
+
+	return pUse;
+}
+
+// remove the range first..last from the hole list
+// return: 1 new data, 0 duplicate, -1 hole list full
+static int ip_reass_fill(reass_dgram_type *pDg, unsigned short first, unsigned short last, int more)
+{
+	reass_hole_type	hole;
+	int				i = 0, used = 0;
+
+	while(i < pDg->holeCnt)
 	{
-		pBuf->buf.header.dataSize = (unsigned short)(offset*8 + len);	// payload data
+		hole = pDg->hole[i];
 
-		// write complete ip length to header
-		pBuf->buf.data.frame.prot.ip.len = htons((unsigned short)(pBuf->buf.header.dataSize+sizeof(ip_hdr)));
+		if(first > hole.last || last < hole.first)
+		{
+			i++;
+			continue;
+		}
+
+		used = 1;
+
+		// remove this hole, the last entry is moved here and checked next
+		pDg->hole[i] = pDg->hole[--pDg->holeCnt];
+
+		// part before the fragment is still missing
+		if(first > hole.first)
+		{
+			if(pDg->holeCnt >= IP_REASS_HOLE_CNT) return -1;
+
+			pDg->hole[pDg->holeCnt].first	= hole.first;
+			pDg->hole[pDg->holeCnt].last	= first - 1;
+			pDg->holeCnt++;
+		}
+
+		// part behind the fragment is still missing (not if this is the last fragment)
+		if(last < hole.last && more)
+		{
+			if(pDg->holeCnt >= IP_REASS_HOLE_CNT) return -1;
+
+			pDg->hole[pDg->holeCnt].first	= last + 1;
+			pDg->hole[pDg->holeCnt].last	= hole.last;
+			pDg->holeCnt++;
+		}
 	}
 
-	// remove flags in offset and convert to bytes (original value is in 8-byte-multiples)
-	offset = offset * 8;
+	return used;
+}
 
-	// If the offset or the offset + fragment length overflows the reassembly
-	// buffer, we discard the entire packet
-	if(offset > IP_MTU-sizeof(ip_hdr)  ||  offset+len > IP_MTU-sizeof(ip_hdr))
+// copy the fragments held by reference to a reassembly buffer and release the frames
+static int ip_reass_linearize(IP_STACK_H hIp, reass_dgram_type *pDg)
+{
+	reass_buf_type	*pBuf;
+	reass_frag_type	*pFrag;
+	char			*pPayload;
+
+	for(pBuf = hIp->pReassBuffer ; pBuf < hIp->pReassBuffer + IP_REASS_BUF_CNT ; pBuf++)
 	{
-		pBuf->timer = 0;
-		return 0;
+		if(pBuf->buf.header.state == IP_BUF_STATE_IDLE) break;
 	}
 
-    // copy the fragment into the reassembly buffer, at the right offset
-    memcpy(((char*)&pBuf->buf.data.frame.prot.ip) + sizeof(ip_hdr) + offset, ((char*)&pFrame->prot.ip) + hdrLen, len);
+	if(pBuf == hIp->pReassBuffer + IP_REASS_BUF_CNT) return 0;	// no buffer available
 
-	// calculate index of the first and the last bit to be set in the bitmap
-	offset	= offset / 8;	// this is the index of the first bit
-	len		= (len-1)/8+1;	// number of bits which should be set
+	pBuf->buf.header.state		= IP_BUF_STATE_RX;
+	pBuf->buf.header.dataSize	= 0;
+	pBuf->timer					= 0;
+	pBuf->pOwner				= pDg;
 
-	pByte = pBitmap + offset/8;	// set byte pointer to the byte which contains the first bit
-	
-	offset = offset & 7;	// get bit offset in the first byte
+	memcpy(&pBuf->buf.data.frame.eth,     &pDg->eth, sizeof(eth_hdr));
+	memcpy(&pBuf->buf.data.frame.prot.ip, &pDg->ip,  sizeof(ip_hdr));
+
+	pPayload = ((char*)&pBuf->buf.data.frame.prot.ip) + sizeof(ip_hdr);
+
+	for(pFrag = pDg->pFrag ; pFrag ; pFrag = pFrag->pNext)
+	{
+		memcpy(pPayload + pFrag->offset, pFrag->pData, pFrag->len);
+	}
+
+	ip_reass_release(hIp, pDg);	// frames are not required anymore
+	pDg->pBuf = pBuf;
+
+	return 1;
+}
 
-	if(offset)	// bit-set does not start on a byte-beginning, therefore we have to set the first few bits with &
+static reass_buf_type *ip_reass(IP_STACK_H hIp, eth_frame *pFrame, IP_BUF_FREE_FCT **ppFct)
+{
+	unsigned short		len, hdrLen;
+	unsigned short		offset;
+	int					more, fill;
+	reass_dgram_type	*pDg;
+	reass_frag_type		*pFrag;
+	reass_buf_type		*pBuf;
+	ip_packet_typ		*pPacket;
+	unsigned char		*pByte;
+
+	pDg = ip_reass_find(hIp, pFrame);
+
+	if(pDg && pDg->state != REASS_STATE_ACTIVE)
 	{
-		if(offset + len > 7) 
+		// the upper layer has asked for a retry of the completed datagram
+		// (the frame which completed the datagram is processed again)
+		pBuf = pDg->pBuf;
+
+		if(pBuf && pBuf->pOwner == pDg && pBuf->timer)
 		{
-			*(pByte++) &= ~bitmask[offset];	// clear all bits until the end of this byte
-			len = len + offset - 8;
+			pBuf->timer = 0;
+			return pBuf;
 		}
-		else
+
+		// skip packet completely if the datagram was already completed or dropped
+		// (the received fragment is either too late or was duplicated somewhere on the way)
+		IP_STAT( hIp->stat.ip_reass_late_rx++);
+		return 0;
+	}
+
+	if(pDg==0)
+	{
+		pDg = ip_reass_new(hIp, pFrame);
+
+		if(pDg==0)
 		{
-			*(pByte++) &= ~bitmask[offset] | bitmask[offset+len];
-			len = 0;	// all bits done
+			IP_STAT( hIp->stat.ip_reass_drop++ );
+			return 0;
 		}
 	}
-	while(len>7)		// set all 64-byte blocks
+
+	// get length and offset from header
+	hdrLen	= (pFrame->prot.ip.vhl & 0xF)*4;			// length of ip header
+	len		= htons(pFrame->prot.ip.len) - hdrLen;
+	offset	= htons(pFrame->prot.ip.ipoffset);
+	more	= (offset & IP_FRAG_FLAG_MORE) != 0;
+
+	// remove flags in offset and convert to bytes (original value is in 8-byte-multiples)
+	offset = (offset & 0x1FFF) * 8;
+
+	// If the offset + fragment length overflows the reassembly buffer, we discard the entire packet
+	if(len == 0 || offset + len > REASS_MAX_PAYLOAD)
+	{
+		IP_STAT( hIp->stat.ip_reass_drop++ );
+		ip_reass_drop(hIp, pDg);
+		return 0;
+	}
+
+	fill = ip_reass_fill(pDg, offset, offset + len - 1, more);
+
+	if(fill < 0)
 	{
-		*(pByte++) = 0;
-		len-=8;
+		IP_STAT( hIp->stat.ip_reass_drop++ );
+		ip_reass_drop(hIp, pDg);
+		return 0;
 	}
-	if(len) *pByte &= bitmask[len];	// set remaining bits
 
-	len = (unsigned short)pBuf->buf.header.dataSize;	// get total buffer length from buffer header
+	if(fill == 0) return 0;		// duplicate, nothing new in this fragment
+
+	if(!more) pDg->ip.len = htons((unsigned short)(offset + len + sizeof(ip_hdr)));	// complete ip length
+
+	pByte = ((unsigned char*)&pFrame->prot.ip) + hdrLen;	// payload of the fragment
 
-	if(len==0) return 0;		// last fragment not yet received, test makes no sense at this moment, wait
+	if(pDg->pBuf == 0 && pDg->holeCnt)
+	{
+		pPacket = GET_TYPE_BASE(ip_packet_typ, data, pFrame);
+
+		// hold the frame by reference if the limits allow it
+		if(hIp->pReassFragFree && hIp->reassMem + pPacket->length <= IP_REASS_MEM)
+		{
+			pFrag				= hIp->pReassFragFree;
+			hIp->pReassFragFree	= pFrag->pNext;
+
+			pFrag->pPacket	= pPacket;
+			pFrag->pFctFree	= *ppFct;	// overtake the release function of the frame
+			pFrag->pData	= pByte;
+			pFrag->offset	= offset;
+			pFrag->len		= len;
 
-	//---- test if all fragments were received ----
-	len		= (len-1) / 8;	// index of the last bit which has to be 1 in the bitmap (1 bit for every 8 bytes)
-	offset	= len & 7;		// get index (0-7) of the last bit in the last byte
-	len		= len / 8;		// get index of last bitmap byte
+			*ppFct = 0;		// mark the frame as held
 
-	// set byte ptr to first bitmap byte
-	pByte = pBitmap;
+			pFrag->pNext	= pDg->pFrag;
+			pDg->pFrag		= pFrag;
+			pDg->fragCnt++;
+			pDg->memUsed	+= pPacket->length;
+			hIp->reassMem	+= pPacket->length;
 
-	// compare all bytes in bitmap to see if all fragments are arrived
-	while(len)
+			return 0;
+		}
+
+		IP_STAT( hIp->stat.ip_reass_linear++ );
+	}
+
+	// copy the held fragments to a buffer (on completion or if the frame can not be held)
+	if(pDg->pBuf == 0 && ip_reass_linearize(hIp, pDg) == 0)
 	{
-		len--;
-		if(*(pByte++)) return 0;	// not yet complete
+		IP_STAT( hIp->stat.ip_reass_drop++ );
+		ip_reass_drop(hIp, pDg);
+		return 0;
 	}
 
-	// compare last byte, it is maybe not fully used because the overall length must not be multiple of 8
-	if(*pByte != bitmask[offset+1]) return 0;		// not yet complete
+	pBuf = pDg->pBuf;
+
+	// copy the fragment into the reassembly buffer, at the right offset
+	memcpy(((char*)&pBuf->buf.data.frame.prot.ip) + sizeof(ip_hdr) + offset, pByte, len);
+
+	if(pDg->holeCnt) return 0;	// not yet complete
 
 	// frame ready, pass it to the stack
-	pBuf->buf.header.state = IP_BUF_STATE_RX;
-	pBuf->timer = 0;
+	pDg->state = REASS_STATE_DONE;
+
+	IP_STAT( hIp->stat.ip_reass_ok++ );
 
 	// Pretend to be a "normal" (i.e., not fragmented) IP packet from now on
 	pByte = (void*)&pBuf->buf.data.frame.prot.ip;
+	IP(pByte)->len		= pDg->ip.len;
 	IP(pByte)->vhl		= (IP_VERSION_V4<<4) + sizeof(ip_hdr)/4;
 	IP(pByte)->ipoffset	= 0;
 	IP(pByte)->chksum	= 0;
 	IP(pByte)->chksum	= ip_chksum((ip_hdr*)pByte,0);
 
+	pBuf->buf.header.dataSize = htons(pDg->ip.len) - sizeof(ip_hdr);	// payload data
+
 	return pBuf;
 }
+
+// release datagrams which were not completed in time
+static void ip_reass_periodic(IP_STACK_H hIp)
+{
+	reass_dgram_type	*pDg;
+
+	for(pDg = hIp->reass ; pDg < hIp->reass + IP_REASS_DGRAM_CNT ; pDg++)
+	{
+		if(pDg->state != REASS_STATE_ACTIVE) continue;
+
+		if(--pDg->timer == 0)
+		{
+			IP_STAT( hIp->stat.ip_reass_timeout++ );
+			ip_reass_drop(hIp, pDg);
+		}
+	}
+}
 #endif
 
@@ -137,7 +137,7 @@ typedef unsigned long	SOCKET;			// socket handle
 		{
 			struct { unsigned char s_b1,s_b2,s_b3,s_b4; }	S_un_b;
 			struct { unsigned short s_w1,s_w2; }			S_un_w;
-			unsigned long									S_addr;
+			UINT32											S_addr;
 		}S_un;
 	};
 
@@ -254,6 +254,16 @@ typedef struct				// structure passed to udp hook function
 	eth_addr		*pRemoteMac;	// ptr to remote mac address
 }ip_udp_info;
 
+typedef struct				// payload segment for ipUdpSendv()
+{
+	const void		*pData;			// ptr to segment data
+	unsigned short	len;			// length of segment
+}ip_udp_seg;
+
+// pInfo->pData and pInfo->pRemoteMac point into the received frame. They are
+// only valid during the call: the frame may be a driver buffer which is
+// reused as soon as the hook returns (see ipPacketProcess()). Copy the data
+// if it is needed later.
 typedef void	IP_HOOKFCT		// hook function
 (
  void			*arg,			// function argument from ipListen() call
@@ -278,6 +288,7 @@ typedef unsigned long IP_ETHSEND	// ethernet driver send function
 typedef struct ip_rx_queue_typ
 {
  ip_packet_typ			*pPacket;	// ptr to received packet
+ IP_BUF_FREE_FCT		*pFct;		// function to release the packet (0: taken over by a socket or the reassembly)
  struct ip_rx_queue_typ	*pNext;		// ptr to next rx queue element
 }ip_rx_queue_typ;
 
@@ -296,6 +307,13 @@ typedef struct
 		unsigned long	prot_ip;		// ip packets processed
 
 		unsigned long	arp_req_tx;		// sent ARP requests
+		unsigned long	arp_hit;		// tx packets with resolved mac address
+		unsigned long	arp_miss;		// tx packets with unknown mac address (new arp entry)
+		unsigned long	arp_evict;		// arp entries replaced because the table was full
+		unsigned long	arp_queued;		// packets queued until the arp reply was received
+		unsigned long	arp_queue_drop;	// packets dropped because a packet was already queued
+		unsigned long	arp_neg_hit;	// packets dropped because the host did not answer (negative cache)
+		unsigned long	arp_timeout;	// arp resolutions without reply
 
 		unsigned long	icmp_rx;		// icmp frames rx
 		unsigned long	icmp_tx;		// icmp frames tx
@@ -315,12 +333,18 @@ typedef struct
 		unsigned long	err_tcp_chksum;	// tcp checksum error
 		unsigned long	err_udp_chksum;	// udp checksum error
 		unsigned long	ip_reass_late_rx;	// fragments arrived too late
+		unsigned long	ip_reass_ok;		// datagrams reassembled
+		unsigned long	ip_reass_linear;	// datagrams copied to a buffer before completion (frame limit reached)
+		unsigned long	ip_reass_drop;		// datagrams dropped (no resources or invalid fragment)
+		unsigned long	ip_reass_timeout;	// datagrams not completed in time
 		unsigned long	packets_queue_full;	// ethernet driver has passed too many buffers (should never happen)
 
 		unsigned long	tcp_synrst;
 		unsigned long	tcp_rst;
 		unsigned long	tcp_sock_full;	// no socket available for socket() call
 		unsigned long	tcp_retransmit;	// number of retransmissions
+		unsigned long	tcp_ack_delayed;	// pure acks sent after the ack delay elapsed
+		unsigned long	tcp_ack_piggyback;	// delayed acks sent together with data
 
 		unsigned long	port_reused;
 		unsigned long	port_reused_invalid;
@@ -388,6 +412,7 @@ void            ipGetGateway(IP_STACK_H hIp, void *pSubnetMask, void *pGateway);
 void			ipArpUpdate(IP_STACK_H hIp, void *pEthAddr, void *pIpAddr);
 
 // update arp table (updates ARP table only if IP is already in the list)
+// return ptr to the updated entry, 0 if the IP is not in the list
 void*			ipArpAnnouncement(IP_STACK_H hIp, void *pEthAddr, void *pIpAddr);
 
 // get MAC address address of specified IP address
@@ -435,12 +460,25 @@ void			ipSetMtu(unsigned short mtu);
 // calculate IP or TCP checksum
 unsigned short	ip_chksum(ip_hdr *pIP, unsigned long prot);		// calculate IP/UDP or TCP checksum
 
+// add a data block to a checksum accumulator (sum of 16 bit words, carries are not folded)
+unsigned long	ip_chksum_partial(const void *pData, unsigned long len, unsigned long sum);
+
+// fold a checksum accumulator to the final 16 bit checksum
+unsigned short	ip_chksum_fold(unsigned long sum);
+
+// incremental checksum update after a 16 bit field was changed (RFC 1624)
+unsigned short	ip_chksum_adjust(unsigned short chksum, unsigned short oldVal, unsigned short newVal);
+
 
 //************************** interface to packet driver ******************************
 
 // pass receive buffer to ip stack (must be linked to receive-callback from ethernet driver
 int	ipPacketReceive(IP_STACK_H hIp, ip_packet_typ *pPacket, IP_BUF_FREE_FCT *pFct);
 
+// process a received frame immediately without taking it over (-1 : frame has to be passed with ipPacketReceive)
+// the frame is only read, it is not referenced after the call
+int	ipPacketProcess(IP_STACK_H hIp, void *pData, unsigned long len);
+
 
 
 //################################################################################
@@ -480,6 +518,70 @@ int	ipUdpListen(IP_STACK_H hIp, unsigned long lport, IP_HOOKFCT *pFct, void *arg
 *********************************************************************************/
 int ipUdpSend(IP_STACK_H hIp, ip_udp_info *pInfo);
 
+/*********************************************************************************
+
+  Function    : ipUdpSendv
+  Description : send UDP frame which is given as a list of segments
+				(the segments are copied directly to the tx buffer)
+
+  Parameter:
+	hIp		: handle of used interface
+	pInfo	: ptr to structure with connection info (pData and len are not used)
+	pSeg	: ptr to array of payload segments
+	segCnt	: number of segments
+
+  Return Value:
+	>0 ... number of sent bytes (sum of all segments)
+	0  ... no send buffer available or driver not yet ready, try again
+	-1 ... Error (hIp=0 or length too big)
+*********************************************************************************/
+int ipUdpSendv(IP_STACK_H hIp, ip_udp_info *pInfo, const ip_udp_seg *pSeg, unsigned long segCnt);
+
+/*********************************************************************************
+
+  Function    : ipUdpReserve
+  Description : reserve a tx buffer for an UDP frame, the caller writes the
+				payload directly to the buffer and sends it with ipUdpCommit()
+				or releases it with ipUdpRelease()
+
+  Parameter:
+	hIp		: handle of used interface
+	maxLen	: maximum payload length the caller will write
+
+  Return Value:
+	ptr to the payload area of the buffer (maxLen bytes can be written)
+	0 ... no tx buffer available, length too big or hIp=0
+*********************************************************************************/
+void* ipUdpReserve(IP_STACK_H hIp, unsigned long maxLen);
+
+/*********************************************************************************
+
+  Function    : ipUdpCommit
+  Description : send an UDP frame reserved with ipUdpReserve()
+
+  Parameter:
+	hIp		: handle of used interface
+	pInfo	: ptr to structure with connection info
+			  (pData = ptr returned by ipUdpReserve(), len = number of written bytes)
+
+  Return Value:
+	>0 ... number of sent bytes
+	0  ... driver not yet ready, the buffer stays reserved (try again or release it)
+	-1 ... Error (hIp=0, length too big or no reserved buffer, the buffer is released)
+*********************************************************************************/
+int ipUdpCommit(IP_STACK_H hIp, ip_udp_info *pInfo);
+
+/*********************************************************************************
+
+  Function    : ipUdpRelease
+  Description : release a tx buffer reserved with ipUdpReserve() without sending
+
+  Parameter:
+	hIp		: handle of used interface
+	pData	: ptr returned by ipUdpReserve()
+*********************************************************************************/
+void ipUdpRelease(IP_STACK_H hIp, void *pData);
+
 /*********************************************************************************
 
   Function    : ipUdpClose
@@ -899,6 +1001,7 @@ old ioctl's */
 #define TCP_ACK_REQUEST		1			/* always send ack-request after sending data */
 #define TCP_REJECT_SEGMENT	2			/* reject segment if socket is occupied */
 #define TCP_PACK_SEND_DATA  3           /* pack send data into existing frame, if not yet in transmit queue */
+#define TCP_NODELAY         4           /* send every send() call in its own segment without delay */
 
 #define IP_DEFAULT_MULTICAST_TTL   1    /* normally limit m'casts to 1 hop  */
 #define IP_DEFAULT_MULTICAST_LOOP  1    /* normally hear sends if a member  */
@@ -165,7 +165,8 @@ void ip_dhcp_receive(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 	struct in_addr	subnet,gateway,server,given;
 	unsigned char	*pData;
 	unsigned short	i,len,type=0,code;
-	unsigned long	leaseTime, t1=0, t2=0, lval;
+	unsigned long	leaseTime, t1=0, t2=0;
+	UINT32			lval;	// 4 byte option value, filled bytewise
 
 	ipHdrLen =  ipHdrLen + sizeof(udp_hdr);	// add udp header to header variable
 
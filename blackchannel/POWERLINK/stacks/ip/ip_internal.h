@@ -143,13 +143,6 @@ STATE:
 
 *************************************************************************************
 ************************************************************************************/
-//--------------------- header which replaces the destination mac ---------------
-typedef struct
-{
-	IP_BUF_FREE_FCT		*pFct;
-	unsigned short       tag;	// buffer-tagging for debug purpose, normally not used
-}ip_int_hdr;
-
 
 //---------------------------------- packet buffer ----------------------------------
 
@@ -165,7 +158,7 @@ typedef struct
 typedef union
 {
 	eth_frame		frame;
-	unsigned long	dataLong[((IP_MTU+18)+3)/4];	// data array are longs to make sure the the field starts on an 4-byte address
+	UINT32			dataLong[((IP_MTU+18)+3)/4];	// data array are longs to make sure the the field starts on an 4-byte address
 }ip_buf_data;
 
 //------------------- complete packet
@@ -177,11 +170,19 @@ typedef struct
 }ip_buf_type;
 
 //--------------------------------- arp table entry ---------------------------------
+#define ARP_STATE_FREE			0	// entry not used
+#define ARP_STATE_RESOLVED		1	// mac address is valid
+#define ARP_STATE_PENDING		2	// arp request sent, waiting for reply
+#define ARP_STATE_FAILED		3	// no reply received (negative cache entry)
+
 typedef struct
 {
 	struct in_addr	ip;
 	eth_addr		eth;
 	unsigned short	time;		// Timestamp of arp entry (arp_time_s)
+	unsigned char	state;		// ARP_STATE_...
+	unsigned char	retry;		// number of sent arp requests in state PENDING
+	ip_buf_type		*pPending;	// first packet waiting for the arp reply (state PENDING)
 }arp_table_entry;
 
 //-------------------- udp listen type
@@ -190,17 +191,58 @@ typedef struct
 	unsigned long	lport;		// listen port
 	IP_HOOKFCT		*pFct;		// hook function
 	void			*arg;		// user info for each connection
+	unsigned char	next;		// index+1 of next entry in the same hash bucket (0 = end of chain)
 }listen_type;
 
+// hash bucket of a port number (network byte order), used for UDP listen ports and sockets
+#define IP_PORT_HASH(port)	(((port) ^ ((port) >> 8)) & (IP_SOCK_HASHSIZE - 1))
+
 //-------------------- structure for 1 reassembly-buffer
 typedef struct
 {
 	ip_buf_type		buf;
-	unsigned char	timer;
-	// reassemble-bitmap to store which fragments we have received already
-	unsigned char	bitmap[ (IP_MTU-sizeof(ip_hdr)-1)/64 + 1 ];
+	unsigned char	timer;		// != 0 : completed datagram is held for a retry of the upper layer
+	void			*pOwner;	// datagram descriptor which uses this buffer
 }reass_buf_type;
 
+//-------------------- fragment of a datagram held by reference
+typedef struct REASS_FRAG
+{
+	struct REASS_FRAG	*pNext;		// next fragment of the same datagram (or next free entry)
+	ip_packet_typ		*pPacket;	// received frame (not released until the datagram is linearized)
+	IP_BUF_FREE_FCT		*pFctFree;	// function to release the frame
+	unsigned char		*pData;		// first payload byte of the fragment inside the frame
+	unsigned short		offset;		// payload offset inside the datagram
+	unsigned short		len;		// payload length
+}reass_frag_type;
+
+//-------------------- hole in a datagram (RFC 815)
+typedef struct
+{
+	unsigned short	first;		// first missing payload byte
+	unsigned short	last;		// last missing payload byte
+}reass_hole_type;
+
+#define REASS_STATE_FREE		0	// descriptor not used
+#define REASS_STATE_ACTIVE		1	// fragments are collected
+#define REASS_STATE_DONE		2	// datagram completed, later fragments are duplicates
+#define REASS_STATE_DROPPED		3	// timeout or error, later fragments are dropped
+
+//-------------------- datagram under reassembly
+typedef struct
+{
+	unsigned char	state;		// REASS_STATE_...
+	unsigned char	timer;		// remaining lifetime in seconds
+	unsigned char	holeCnt;	// number of entries in hole[]
+	unsigned char	fragCnt;	// number of fragments in the chain
+	unsigned short	memUsed;	// frame bytes held by reference
+	eth_hdr			eth;		// ethernet header of the first received fragment
+	ip_hdr			ip;			// ip header of the first received fragment (options are ignored)
+	reass_frag_type	*pFrag;		// fragments held by reference
+	reass_buf_type	*pBuf;		// linear buffer (when the datagram was linearized)
+	reass_hole_type	hole[IP_REASS_HOLE_CNT];
+}reass_dgram_type;
+
 //--------------------------------- UDP header ---------------------------------
 typedef struct
 {
@@ -228,11 +270,17 @@ typedef struct
 #define	IP(p)		((ip_hdr*)p)
 #define	UDP(p)		((udp_hdr*)p)
 
+// udp payload of a tx buffer
+#define	UDP_DATA(pBuf)	(((unsigned char*)&(pBuf)->data.frame.prot.ip) + sizeof(ip_hdr) + sizeof(udp_hdr))
+
 //--------------------------------- tcp/ip connection ---------------------------------
 //
 // Representation of a TCP connection.
 //
-// The ip_conn structure is used for identifying a connection (32 Byte / connection)
+// The ip_conn structure is used for identifying a connection (68 Byte / connection with 32 bit pointers)
+//
+// The hash links are kept in the header, so they survive the clearing and copying
+// of the socket data in socket() and accept().
 //
 //-------------------------------------------------------------------------------------
 typedef struct IP_CONN_HEADER
@@ -240,6 +288,10 @@ typedef struct IP_CONN_HEADER
 	unsigned char	state;		// TCP/UDP state and flags
 	unsigned char	cntOpen;
 	unsigned char	cntFree;
+	unsigned char	portNext;	// index+1 of next socket in the same port hash bucket (0 = end of chain)
+	unsigned char	connNext;	// index+1 of next socket in the same connection hash bucket
+	unsigned char	portBucket;	// port hash bucket+1 the socket is linked into (0 = not linked)
+	unsigned char	connBucket;	// connection hash bucket+1 the socket is linked into (0 = not linked)
 	unsigned char	reserve;
 }IP_CONN_HEADER;
 
@@ -260,8 +312,8 @@ typedef struct IP_CONN
 
 	struct in_addr	ripaddr;	// IP address of the remote host
 
-	unsigned long	rcv_nxt;	// The sequence number that we expect to receive next
-	unsigned long	snd_nxt;	// The sequence number that was last sent by us
+	UINT32			rcv_nxt;	// The sequence number that we expect to receive next
+	UINT32			snd_nxt;	// The sequence number that was last sent by us
 	unsigned short	len;		// Length of the data that was previously sent
 	unsigned short	mss;		// Current maximum segment size for the connection
 	unsigned short	initialmss;	// Initial maximum segment size for the connection
@@ -270,6 +322,8 @@ typedef struct IP_CONN
 	unsigned char	rto;		// Retransmission time-out
 	unsigned char	timer;		// The retransmission timer
 	unsigned char	nrtx;		// The number of retransmissions for the last segment sent
+	unsigned char	ackDelay;	// delayed ack: calls left+1 before a pure ack is sent (0 = nothing to acknowledge)
+	unsigned char	nagle;		// number of calls the pending partial segment has been held back
 
 	ip_buf_type		*pTx;		// address to tx buffer
 	
@@ -310,8 +364,9 @@ struct IP_IF
 	//------------------ ARP ------------------------
 	unsigned char	arp_refresh;
 	unsigned char	arp_probe;
+	unsigned short	arp_unresolved;		// number of PENDING and FAILED entries in arp table
 
-	arp_table_entry	arp_table[IP_ARP_TABSIZE];			// arp table (12 byte RAM / entry)
+	arp_table_entry	arp_table[IP_ARP_TABSIZE];			// hashed arp table (20 byte RAM / entry)
 
 	//------------------ DHCP ------------------------
 	#if IP_DHCP == 1
@@ -347,10 +402,13 @@ struct IP_IF
 
 	//------------------  listen ports and sockets  --------------------------
 
-	listen_type	listen_udp[IP_LISTEN_PORTS_UDP];	// UDP listen ports (12 byte RAM / entry)
+	listen_type	listen_udp[IP_LISTEN_PORTS_UDP];	// UDP listen ports (16 byte RAM / entry)
+	unsigned char	listen_udp_hash[IP_SOCK_HASHSIZE];	// index+1 of first listen port per bucket
 
 	#if IP_TCP_SOCKETS > 0
 		IP_CONN			sock[IP_TCP_SOCKETS];		// sockets
+		unsigned char	sock_port_hash[IP_SOCK_HASHSIZE];	// index+1 of first socket per local port bucket
+		unsigned char	sock_conn_hash[IP_SOCK_HASHSIZE];	// index+1 of first socket per connection bucket
 	#endif
 
 	unsigned short	nextFreePort;
@@ -360,6 +418,11 @@ struct IP_IF
 
 	#if IP_REASS_BUF_CNT > 0
 		reass_buf_type	*pReassBuffer;	// buffers for reassembly (can also become a tx buffer)
+
+		reass_dgram_type	reass[IP_REASS_DGRAM_CNT];			// datagrams under reassembly
+		reass_frag_type		reassFrag[IP_REASS_FRAG_CNT];		// fragment chain entries
+		reass_frag_type		*pReassFragFree;					// list of unused chain entries
+		unsigned long		reassMem;							// frame bytes held by all datagrams
 	#endif
 
 	//------------------  statistics  --------------------------
@@ -388,10 +451,28 @@ void			ip_buf_send(IP_STACK_H hIp, ip_buf_type *pBuf, unsigned long option);
 
 //------------------------- function declarations -----------------------------
 // ip_sock.c
+
+// The states used in the socket->state
+#define IP_FREE			0
+#define IP_CLOSED		1
+#define IP_BOUND		2
+#define IP_SYN_RCVD		3
+#define IP_CONNECTED	4
+#define IP_FIN_WAIT_1	5
+#define IP_FIN_WAIT_2	6
+#define IP_CLOSING		7
+#define IP_TIME_WAIT	8		// wait after closing, maybe remote asks for resending the last ack
+#define IP_LAST_ACK		9		// wait till remote send ack to our FIN
+#define IP_LISTEN		10
+#define IP_SYN_TX		11
+#define IP_SYN_SENT		12
+#define IP_SYN_ACK_TX	13
+
 void sock_set_ip(IP_STACK_H hIp);
-int  sock_in(IP_STACK_H hIp,eth_frame *pFrame, unsigned short ipHdrLen);
+int  sock_in(IP_STACK_H hIp,eth_frame *pFrame, unsigned short ipHdrLen, IP_BUF_FREE_FCT **ppFct);
 void sock_out(IP_STACK_H hIp);
 void sock_periodic(IP_STACK_H hIp);
 void sock_set_mtu(unsigned short mtu);
+void ip_socket_free(SOCK_PTR socket, int state);
 
 #endif
@@ -50,8 +50,9 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 // Should be > number of connections from the local subnet
 // For all connections from other subnets only 1 tab entry is required
+// The table is hashed by IP address, the size must be a power of 2
 //-------------------------------------------------------------------------
-#define IP_ARP_TABSIZE			20		// size of ARP Table (12 Byte RAM / Entry)
+#define IP_ARP_TABSIZE			32		// size of ARP Table (20 Byte RAM / Entry)
 
 //-------------------------------------------------------------------------
 // MTU (Maximum Transmission Unit)
@@ -74,12 +75,39 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //-------------------------------------------------------------------------
 // Number of reassembly buffers
 // 
-// Each buffer needs (MTU+18) bytes of RAM
+// Each buffer needs (MTU+18) bytes of RAM. A buffer is only taken when a
+// datagram is completed or when its fragments can not be held by reference
+// anymore.
 //-------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------
-// If a reassembly buffer is not completed after this time the buffer
-// will be deleted and reused when the next reassembly starts
+// Fragments are held by reference in the received frames until the
+// datagram is completed.
+//
+// IP_REASS_DGRAM_CNT : datagrams which are reassembled at the same time
+// IP_REASS_FRAG_CNT  : received frames held by all datagrams (at least 1 and
+//                      less than IP_RX_BUF_CNT, the driver needs free buffers,
+//                      so the reassembly needs IP_RX_BUF_CNT >= 2)
+// IP_REASS_MEM       : frame bytes held by all datagrams
+// IP_REASS_HOLE_CNT  : missing ranges tracked per datagram
+//-------------------------------------------------------------------------
+#define IP_REASS_DGRAM_CNT		4
+#define IP_REASS_FRAG_CNT		(IP_RX_BUF_CNT-1)
+#define IP_REASS_MEM			(2*IP_MTU)
+#define IP_REASS_HOLE_CNT		4
+
+#if IP_REASS_BUF_CNT > 0
+	#if IP_REASS_FRAG_CNT < 1
+		#error "IP_REASS_FRAG_CNT must be at least 1, the reassembly needs IP_RX_BUF_CNT >= 2 !"
+	#endif
+	#if IP_REASS_FRAG_CNT >= IP_RX_BUF_CNT
+		#error "IP_REASS_FRAG_CNT must be less than IP_RX_BUF_CNT !"
+	#endif
+#endif
+
+//-------------------------------------------------------------------------
+// If a datagram is not completed after this time all of its fragments
+// are released and fragments arriving later are dropped
 // (Time in seconds)
 //-------------------------------------------------------------------------
 #define IP_REASS_MAXAGE			4
@@ -97,6 +125,10 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   #else
     #define LITTLE_ENDIAN           0
   #endif
+#elif defined(__i386__) || defined(__x86_64__)
+  // host build of the traffic harness (<endian.h> may have defined it differently)
+  #undef  LITTLE_ENDIAN
+  #define LITTLE_ENDIAN			1
 #else
   #error 'ERROR: Platform not found!'
 #endif
@@ -117,7 +149,31 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // maximum number of simultaneously open TCP connections
 // (0 : tcpip disabled, less code)
 //-------------------------------------------------------------------------
-#define IP_TCP_SOCKETS			0
+#ifndef IP_TCP_SOCKETS
+	#define IP_TCP_SOCKETS			0
+#endif
+
+//-------------------------------------------------------------------------
+// Number of hash buckets for the UDP listen ports and the socket lookup
+// (must be a power of 2, RAM usage = x*3)
+//-------------------------------------------------------------------------
+#define IP_SOCK_HASHSIZE		16
+
+//-------------------------------------------------------------------------
+// TCP send coalescing and delayed acknowledge, counted in ipPeriodic() calls
+//
+// IP_TCP_NAGLE_DELAY : a segment smaller than the MSS is held back for up to
+//                      x calls while sent data is unacknowledged, so that
+//                      following send() calls can fill it up. On an idle
+//                      connection it is sent at once.
+//                      (disabled per socket with TCP_NODELAY)
+// IP_TCP_ACK_DELAY   : the acknowledge of a partial segment is delayed for up
+//                      to x calls after the data was read, so that it can be
+//                      sent together with the response data
+// (0 : segments and acknowledges are sent immediately)
+//-------------------------------------------------------------------------
+#define IP_TCP_NAGLE_DELAY		1
+#define IP_TCP_ACK_DELAY		4
 
 //-------------------------------------------------------------------------
 // enable DHCP
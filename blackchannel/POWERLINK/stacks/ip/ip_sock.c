@@ -140,22 +140,6 @@ static struct
 #define TX_TCP_SYN		0x0002	// send syn
 //#define TX_TCP_NODATA	0x0004	// send no data
 
-// The states used in the socket->state
-#define IP_FREE			0
-#define IP_CLOSED		1
-#define IP_BOUND		2
-#define IP_SYN_RCVD		3
-#define IP_CONNECTED	4
-#define IP_FIN_WAIT_1	5
-#define IP_FIN_WAIT_2	6
-#define IP_CLOSING		7
-#define IP_TIME_WAIT	8		// wait after closing, maybe remote asks for resending the last ack
-#define IP_LAST_ACK		9		// wait till remote send ack to our FIN
-#define IP_LISTEN		10
-#define IP_SYN_TX		11
-#define IP_SYN_SENT		12
-#define IP_SYN_ACK_TX	13
-
 static const char dbgSockStateInfo[] = {
 	'-',	// Free
 	'Z',	// Closed (sockets should never 'freeze' on this state, then something is wrong)
@@ -188,7 +172,7 @@ static const char dbgSockStateInfo[] = {
 #define SOCK_FLAG_ACKREQ			0x0001
 #define SOCK_FLAG_REJECT_SEGMENT	0x0002
 #define SOCK_FLAG_SECONDARY_IP		0x0004
-#define SOCK_FLAG_PACK_SEND_DATA	0x0008
+#define SOCK_FLAG_NODELAY			0x0008	// no send coalescing, one segment per send() call
 
 
 /*
@@ -225,11 +209,14 @@ static const char dbgSockStateInfo[] = {
 
 #define IP_DYNAMIC_PORT_RANGE	49152
 
+// connection hash bucket of a 4-tuple (ports and ip address in network byte order,
+// the local ip address is the same for all sockets of an interface)
+#define SOCK_CONN_HASH(lport, rport, ip)	IP_PORT_HASH((lport) ^ (rport) ^ (unsigned short)((ip) ^ ((ip) >> 16)))
+
 
 
 void ip_tcp_appsend(SOCK_PTR socket);
 void ip_tcp_send(SOCK_PTR socket, ip_buf_type *pBuf, unsigned short flags);
-void ip_socket_free(SOCK_PTR socket, int state);
 
 
 
@@ -284,6 +271,104 @@ static SOCK_PTR findSock(IP_STACK_H hIp, unsigned char state)
 	return 0;
 }
 
+//-----------------------------------------------------------------------------
+//
+// Socket hash
+//
+// Every socket with a local port is linked into the port hash, which is used
+// to demultiplex UDP and to find the listening socket of a TCP port. Stream
+// sockets with a remote endpoint are also linked into the connection hash,
+// keyed by the 4-tuple. The chains only preselect sockets, sock_in() still
+// checks type, state and ports of every socket in the chain.
+//
+// sock_rehash() has to be called whenever lport, rport or ripaddr of a socket
+// is changed. The pending connection stored in a listening socket is the only
+// exception, listening sockets are never searched in the connection hash.
+//
+//-----------------------------------------------------------------------------
+
+// remove a socket from the hash chain starting at pLink
+static void sock_unlink(IP_STACK_H hIp, unsigned char *pLink, SOCK_PTR sock, int conn)
+{
+	unsigned char	id = (unsigned char)(sock - hIp->sock) + 1;
+	SOCK_PTR		s;
+
+	while(*pLink)
+	{
+		s = hIp->sock + *pLink - 1;
+
+		if(*pLink == id)
+		{
+			*pLink = conn ? s->header.connNext : s->header.portNext;
+			return;
+		}
+
+		pLink = conn ? &s->header.connNext : &s->header.portNext;
+	}
+}
+
+// link a socket into the hash chains according to its current ports and remote address
+static void sock_rehash(IP_STACK_H hIp, SOCK_PTR sock)
+{
+	unsigned char	id = (unsigned char)(sock - hIp->sock) + 1;
+	unsigned int	bucket;
+	IP_LOCK_LEVEL_VAR
+
+	IP_LOCK_LEVEL_ON
+
+	if(sock->header.portBucket)
+	{
+		sock_unlink(hIp, &hIp->sock_port_hash[sock->header.portBucket - 1], sock, 0);
+		sock->header.portBucket = 0;
+	}
+
+	if(sock->header.connBucket)
+	{
+		sock_unlink(hIp, &hIp->sock_conn_hash[sock->header.connBucket - 1], sock, 1);
+		sock->header.connBucket = 0;
+	}
+
+	if(sock->lport)
+	{
+		bucket = IP_PORT_HASH(sock->lport);
+
+		sock->header.portNext		= hIp->sock_port_hash[bucket];
+		sock->header.portBucket		= bucket + 1;
+		hIp->sock_port_hash[bucket]	= id;
+	}
+
+	if(sock->type == SOCK_STREAM && sock->rport)
+	{
+		bucket = SOCK_CONN_HASH(sock->lport, sock->rport, sock->ripaddr.S_un.S_addr);
+
+		sock->header.connNext		= hIp->sock_conn_hash[bucket];
+		sock->header.connBucket		= bucket + 1;
+		hIp->sock_conn_hash[bucket]	= id;
+	}
+
+	IP_LOCK_LEVEL_OFF
+}
+
+// find a socket with this local port and type, optionally in a given state (0 = any state)
+static SOCK_PTR sock_find_port(IP_STACK_H hIp, unsigned short lport, unsigned short type, unsigned char state)
+{
+	SOCK_PTR		sock;
+	unsigned char	link = hIp->sock_port_hash[IP_PORT_HASH(lport)];
+
+	for( ; link ; link = sock->header.portNext)
+	{
+		sock = hIp->sock + link - 1;
+
+		if(sock->lport != lport)							continue;
+		if(type && sock->type != type)						continue;
+		if(state && sock->header.state != state)			continue;
+
+		return sock;
+	}
+
+	return 0;
+}
+
 /*********************************************************************************
 
 Function    : socket
@@ -332,6 +417,8 @@ SOCKET	socket(int af, int type, int protocol)
 	sock->type	= type;
 	sock->hIp	= hIp;
 
+	sock_rehash(hIp, sock);	// remove old links of the previous user
+
 	sock->header.cntOpen++;
 
 	return (SOCKET)sock;	// return address to user
@@ -356,7 +443,6 @@ int bind(SOCKET s, struct sockaddr *addr)
 	SOCK_PTR			sock = (SOCK_PTR)s, sockSearch;
     IP_STACK_H			hIp;
     struct sockaddr_in	*pAddr = (struct sockaddr_in*)addr;
-    int                 i;
     unsigned short      newPort;
     
 	if(sock == 0 || sock->header.state == IP_FREE || addr->sa_family != AF_INET)
@@ -391,21 +477,18 @@ int bind(SOCKET s, struct sockaddr *addr)
             if(newPort < IP_DYNAMIC_PORT_RANGE) newPort = IP_DYNAMIC_PORT_RANGE;
 
             // search if port is already used by another socket
-            i = 0;
-            for(sockSearch = hIp->sock; sockSearch < hIp->sock + IP_TCP_SOCKETS; sockSearch++)
-            {
-                if(sockSearch->lport == newPort)
-                {
-                    i=1;		// port already used
-                    newPort++;	// try next port
-                }
-            }
-        }while(i);	// repeat this loop, till i=0 (which means port not found in current socket list)
+            sockSearch = sock_find_port(hIp, newPort, 0, 0);
+
+            if(sockSearch) newPort++;	// port already used, try next port
+
+        }while(sockSearch);	// repeat this loop till the port is not found in the current socket list
 
         sock->lport         = newPort;
         hIp->nextFreePort   = newPort+1;
     }
 
+	sock_rehash(hIp, sock);
+
 	sock->header.state = IP_BOUND;
 
 	return 0;
@@ -427,21 +510,18 @@ int bind(SOCKET s, struct sockaddr *addr)
 
 int listen(SOCKET s)
 {
-	SOCK_PTR sock = (SOCK_PTR)s, searchSock;
+	SOCK_PTR sock = (SOCK_PTR)s;
 
 	if(sock == 0)						RET_SOCK_ERROR(WSAENOTSOCK);	// socket invalid
 	if(sock->header.state != IP_BOUND)	RET_SOCK_ERROR(WSAEINVAL);		// socket not bound
 	if(sock->cmdClose)					RET_SOCK_ERROR(WSAESHUTDOWN);	// socket closing soon
 	if(sock->type != SOCK_STREAM)		RET_SOCK_ERROR(WSAEOPNOTSUPP);	// listen only for stream supported
 
-	// search for free socket
-	for(searchSock = sock->hIp->sock ; searchSock < sock->hIp->sock + IP_TCP_SOCKETS ; searchSock++)
+	// search for another socket listening on this port
+	if(sock_find_port(sock->hIp, sock->lport, 0, IP_LISTEN))
 	{
-		if(searchSock->header.state == IP_LISTEN && sock->lport == searchSock->lport && searchSock != sock)
-		{
-			// TODO ... verhalten kann mit SO_REUSEADDR gesteuert werden
-			RET_SOCK_ERROR(WSAEADDRINUSE);
-		}
+		// TODO ... verhalten kann mit SO_REUSEADDR gesteuert werden
+		RET_SOCK_ERROR(WSAEADDRINUSE);
 	}
 
 	sock->rport = 0;
@@ -522,6 +602,8 @@ SOCKET accept(SOCKET s, struct sockaddr *addr, int *addrlen)
 
 	newSock->header.state = IP_SYN_RCVD;				// start socket state machine
 
+	sock_rehash(newSock->hIp, newSock);				// new socket owns the connection now
+
 	sock->rport = 0;							// free listen socket for next connection establishment
 	
 	ip_tcp_send(newSock, pBuf, TCP_SYN | TCP_ACK);	// send synack
@@ -553,7 +635,7 @@ int getsockname(SOCKET s, struct sockaddr *addr, int *addrlen)
 	pAddr->sin_port			= sock->lport;
 	pAddr->sin_addr.s_addr	= sock->hIp->local_ip_addr.s_addr;
 
-	return NULL;
+	return 0;
 }
 
 /*********************************************************************************
@@ -580,7 +662,7 @@ int getpeername(SOCKET s, struct sockaddr *addr, int *addrlen)
 	pAddr->sin_port			= sock->rport;
 	pAddr->sin_addr.s_addr	= sock->ripaddr.s_addr;
 
-	return NULL;
+	return 0;
 }
 
 /*********************************************************************************
@@ -629,7 +711,7 @@ int send(SOCKET s, const char *buf, long len)
 	{
 		if(sock->pTx->header.state != IP_BUF_STATE_TX)		RET_SOCK_ERROR(WSAEWOULDBLOCK);  // last buffer already in tx queue
 
-		if(0 == (sock->flags & SOCK_FLAG_PACK_SEND_DATA))	RET_SOCK_ERROR(WSAEWOULDBLOCK);  // packing not allowed for this socket
+		if(sock->flags & SOCK_FLAG_NODELAY)					RET_SOCK_ERROR(WSAEWOULDBLOCK);  // packing not allowed for this socket
 
 		// add data to existing buffer if possible
 		pBuf   = sock->pTx;
@@ -877,6 +959,8 @@ int connect(SOCKET s, const struct sockaddr* name, int namelen)
 
 	sock->rport = ((struct sockaddr_in*)name)->sin_port;
 
+	sock_rehash(hIp, sock);
+
 	sock->snd_nxt		= hIp->time_s;
 	sock->initialmss	= sock->mss = ipSockInt.mss;
 	sock->header.state	= IP_SYN_TX;
@@ -1148,9 +1232,14 @@ int setsockopt(SOCKET s, int level, int optname, const char  * optval, int optle
 					else	sock->flags = sock->flags & (unsigned short)~SOCK_FLAG_REJECT_SEGMENT;
 					break;
 
-				case TCP_PACK_SEND_DATA:
-					if(val)	sock->flags = sock->flags | SOCK_FLAG_PACK_SEND_DATA;
-					else	sock->flags = sock->flags & (unsigned short)~SOCK_FLAG_PACK_SEND_DATA;
+				case TCP_PACK_SEND_DATA:	// packing is the default, kept for compatibility
+					if(val)	sock->flags = sock->flags & (unsigned short)~SOCK_FLAG_NODELAY;
+					else	sock->flags = sock->flags | SOCK_FLAG_NODELAY;
+					break;
+
+				case TCP_NODELAY:
+					if(val)	sock->flags = sock->flags | SOCK_FLAG_NODELAY;
+					else	sock->flags = sock->flags & (unsigned short)~SOCK_FLAG_NODELAY;
 					break;
 			}
 			break;
@@ -1278,6 +1367,7 @@ void sock_out(IP_STACK_H hIp)
 {
 	SOCK_PTR		sock;
 	int				ackRequest;
+	int				ackDue;
 
 	// loop through all stream sockets to see if there is one which has tx data
 	for(sock = hIp->sock; sock < hIp->sock + IP_TCP_SOCKETS; sock++)
@@ -1294,8 +1384,33 @@ void sock_out(IP_STACK_H hIp)
 			sock->pRx = 0;				// reset receive buffer
 			sock->recvLen = 0;
 		}
-		else if( sock->pTx && sock->pTx->header.state == IP_BUF_STATE_TX )
+
+		// the ack delay starts when the user has read all data, the ack is due when it has elapsed
+		ackDue = 0;
+
+		if(sock->ackDelay && sock->pRx==0)
+		{
+			if(sock->ackDelay > 1) sock->ackDelay--;
+			if(sock->ackDelay == 1) ackDue = 1;
+		}
+
+		if( sock->pTx && sock->pTx->header.state == IP_BUF_STATE_TX )
 		{
+			// hold back a partial segment while sent data is unacknowledged, following send() calls
+			// may fill it up (not on an idle connection, if the ack can be sent with the data now
+			// or the socket is closing)
+			if( (sock->pTx->header.dataSize < sock->mss)
+				&& (sock->len != 0)
+				&& (sock->nagle < IP_TCP_NAGLE_DELAY)
+				&& !(sock->flags & SOCK_FLAG_NODELAY)
+				&& !ackDue
+				&& !sock->cmdClose
+				)
+			{
+				sock->nagle++;
+				continue;
+			}
+
 			// send response with ack and data (followed by ack-request if configured)
 			if(sock->flags & SOCK_FLAG_ACKREQ) ackRequest = 1;
 		}
@@ -1303,11 +1418,18 @@ void sock_out(IP_STACK_H hIp)
 		{
 			// send
 		}
+		else if(ackDue)
+		{
+			// no data to piggyback the ack on, send pure ack
+			IP_STAT(hIp->stat.tcp_ack_delayed++);
+		}
 		else
 		{
 			continue;	// don't send
 		}
 
+		sock->nagle = 0;
+
 		ip_tcp_appsend(sock);
 
 		if( ackRequest && (sock->header.state != IP_LAST_ACK) ) ip_tcp_send(sock, 0, TCP_ACK);
@@ -1328,7 +1450,7 @@ void sock_out(IP_STACK_H hIp)
 							or a frame with invalid checksum
 
 *********************************************************************************/
-int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
+int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen, IP_BUF_FREE_FCT **ppFct)
 {
 	tcp_hdr			*pTCP;
 	udp_hdr			*pUDP;
@@ -1336,8 +1458,9 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 	struct in_addr	ipAddr;
 	unsigned int	dataLen,tcpHdrLen,response;
 	unsigned int	ret = IP_FRAME_UNUSED;
-	unsigned long	seq,ack;
+	UINT32			seq,ack;
 	ip_buf_type		*pBuf;
+	unsigned char	link;
 	IP_LOCK_LEVEL_VAR
 
 	copy_ip_address(&ipAddr , pFrame->prot.ip.src_ip);
@@ -1354,8 +1477,12 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 		IP_STAT(hIp->stat.udp_rx++);
 
 		// search for socket which is bound to this UDP port
-		for(sock = hIp->sock; sock < hIp->sock + IP_TCP_SOCKETS; sock++)
+		link = hIp->sock_port_hash[IP_PORT_HASH(pUDP->dst_port)];
+
+		for( ; link ; link = sock->header.portNext)
 		{
+			sock = hIp->sock + link - 1;
+
 			if(sock->type != SOCK_DGRAM)		continue;	// not a DGRAM socket (UDP)
 			if(sock->header.state <= IP_CLOSED)	continue;	// closed ... can not receive data, bind first
             if(pUDP->dst_port != sock->lport)	continue;	// not for the bound port
@@ -1366,11 +1493,11 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 			sock->rport				= pUDP->src_port;
 			sock->ripaddr.s_addr	= ipAddr.s_addr;
 
-			// overtake callback address from the first 4 bytes of the frame
-			sock->pFctFree = ((ip_int_hdr*)pFrame)->pFct;
+			// overtake the release function of the frame
+			sock->pFctFree = *ppFct;
 
-			// clear callback function in frame to mark as queued
-			((ip_int_hdr*)pFrame)->pFct = 0;
+			// clear the release function to mark the frame as queued
+			*ppFct = 0;
 
 			sock->pRx		= pFrame;
 			sock->pRecvData	= (char*)pUDP + sizeof(udp_hdr);
@@ -1405,22 +1532,20 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 	htonlc(&ack, pTCP->ackno);
 
 	// check if there is a socket for this connection
-	listenSock = 0;
-	for(sock = hIp->sock; sock < hIp->sock + IP_TCP_SOCKETS; sock++)
+	link = hIp->sock_conn_hash[SOCK_CONN_HASH(pTCP->dst_port, pTCP->src_port, ipAddr.S_un.S_addr)];
+
+	for( ; link ; link = sock->header.connNext)
 	{
+		sock = hIp->sock + link - 1;
+
 		// only consider stream sockets
 		if(sock->type != SOCK_STREAM) continue;
 
 		// not interesting at all if port is wrong
 		if(pTCP->dst_port != sock->lport) continue;
 
-		// listen port found
-		if(sock->header.state == IP_LISTEN)
-		{
-			// remember this socket if there is no connection pending at the moment
-			if(sock->rport==0) listenSock = sock;
-			continue;
-		}
+		// listen ports are searched in the port hash
+		if(sock->header.state == IP_LISTEN) continue;
 
 		// do not handle closed sockets
 		if(sock->header.state <= IP_CLOSED) continue;
@@ -1596,17 +1721,22 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 					return IP_FRAME_RETRY;
 				}
 
-				// overtake callback address from the first 4 bytes of the frame
-				sock->pFctFree = ((ip_int_hdr*)pFrame)->pFct;
+				// overtake the release function of the frame
+				sock->pFctFree = *ppFct;
 				
-				// clear callback function in frame to mark as queued
-				((ip_int_hdr*)pFrame)->pFct = 0;
+				// clear the release function to mark the frame as queued
+				*ppFct = 0;
 				
 				sock->pRx		= pFrame;
 				sock->pRecvData	= (char*)pTCP + tcpHdrLen;
 				sock->rcv_nxt	+= dataLen;
 				sock->recvLen	= dataLen;
 
+				// acknowledge a full window as soon as it was read (the remote can not send more before),
+				// the ack of a partial segment is delayed to be sent together with the response
+				if(dataLen >= ipSockInt.mss)	sock->ackDelay = 1;
+				else							sock->ackDelay = IP_TCP_ACK_DELAY + 1;
+
 				ret = IP_FRAME_QUEUED;
 			}
 
@@ -1829,7 +1959,10 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 	// If the SYN flag isn't set, it is an old packet and we send a RST.
 	if((pTCP->flags & TCP_CTL) == TCP_SYN)
 	{
-		if(listenSock)	// overtake data to listen socket if free
+		listenSock = sock_find_port(hIp, pTCP->dst_port, SOCK_STREAM, IP_LISTEN);
+
+		// overtake data to listen socket if free (no connection pending at the moment)
+		if(listenSock && listenSock->rport==0)
 		{
 			// store connection info
 			copy_ip_address(&listenSock->ripaddr, pFrame->prot.ip.src_ip);
@@ -1842,6 +1975,9 @@ int sock_in(IP_STACK_H hIp, eth_frame *pFrame, unsigned short ipHdrLen)
 			listenSock->pTx	= 0;
 			listenSock->pRx	= 0;
 
+			listenSock->ackDelay	= 0;
+			listenSock->nagle		= 0;
+
 			// Parse the TCP MSS option
 			listenSock->initialmss = listenSock->mss = 
 				parse_mss(((unsigned char*)pTCP) + sizeof(tcp_hdr), tcpHdrLen - sizeof(tcp_hdr) );
@@ -1997,6 +2133,18 @@ void sock_periodic(IP_STACK_H hIp)
 				pBuf = sock->pTx;
 				if(pBuf==0) continue;	// no buffer available
 
+				// the buffer is still owned by the tx queue or an arp entry, release it there and take another one
+				if(pBuf->header.state == IP_BUF_STATE_TX_Q || pBuf->header.state == IP_BUF_STATE_TX_ACK_Q)
+				{
+					pBuf = ip_alloc_tx_buffer(hIp);
+					if(pBuf==0) continue;	// no tx buffer available, try next time
+
+					EnableGlobalInterrupt(FALSE);
+					if(sock->pTx->header.state == IP_BUF_STATE_TX_ACK_Q)	sock->pTx->header.state = IP_BUF_STATE_TX_Q;
+					else if(sock->pTx->header.state != IP_BUF_STATE_TX_Q)	sock->pTx->header.state = IP_BUF_STATE_IDLE;	// sent meanwhile
+					EnableGlobalInterrupt(TRUE);
+				}
+
 				sock->pTx = 0;
 			}
 
@@ -2142,6 +2290,14 @@ void ip_tcp_send(SOCK_PTR sock, ip_buf_type *pBuf, unsigned short flags)
 	// no buffer available, just skip the frame
 	if(pBuf==0) return;
 
+	// the ack in this segment covers all received data, a delayed ack is not needed anymore
+	if(sock->ackDelay && (flags & TCP_ACK))
+	{
+		if(pBuf->header.dataSize) IP_STAT(sock->hIp->stat.tcp_ack_piggyback++);
+
+		sock->ackDelay = 0;
+	}
+
 	pIP  = &pBuf->data.frame.prot.ip;
 	pTCP = (tcp_hdr*)(pIP + 1);
 
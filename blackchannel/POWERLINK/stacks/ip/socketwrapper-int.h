@@ -44,15 +44,102 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //------------------------------------------------------------------------------
 #include <oplk/oplk.h>
 #include <ip.h>
+#include <socketwrapper.h>
 
 //------------------------------------------------------------------------------
 // const defines
 //------------------------------------------------------------------------------
+#define SOCKETWRAPPER_SEGMENTS_MAX      4   ///< Maximum number of segments of socketwrapper_sendSegments()
+#define SOCKETWRAPPER_TX_DATA_SIZE      (IP_MTU - 28)   ///< Maximum payload of a datagram sent with socketwrapper_sendSegments()
+
+/**
+ * Number of socket wrapper instances which can be created at the same time.
+ */
+#ifndef SOCKETWRAPPER_INSTANCE_CNT
+#define SOCKETWRAPPER_INSTANCE_CNT      2
+#endif
+
+/**
+ * Number of receive queues. Only instances created with
+ * socketwrapper_createQueued() take a queue, the other instances need no
+ * memory for it. socketwrapper_createQueued() fails if all queues are in use,
+ * with 0 queued instances are not available.
+ */
+#ifndef SOCKETWRAPPER_RX_QUEUE_CNT
+#define SOCKETWRAPPER_RX_QUEUE_CNT      0
+#endif
+
+/**
+ * Number of datagrams a receive queue can hold until socketwrapper_process()
+ * delivers them. Further datagrams are dropped and counted.
+ */
+#ifndef SOCKETWRAPPER_RX_QUEUE_SIZE
+#define SOCKETWRAPPER_RX_QUEUE_SIZE     4
+#endif
+
+/**
+ * Maximum payload size of a queued datagram. Larger datagrams are dropped and
+ * counted.
+ */
+#ifndef SOCKETWRAPPER_RX_DATA_SIZE
+#define SOCKETWRAPPER_RX_DATA_SIZE      (IP_MTU - 28)
+#endif
 
 //------------------------------------------------------------------------------
 // typedef
 //------------------------------------------------------------------------------
 
+/**
+\brief Payload segment of a datagram
+
+The segments are copied one after the other directly to the transmit buffer
+of the IP stack.
+*/
+typedef struct
+{
+    const void*     pData;          ///< Pointer to segment data
+    size_t          size;           ///< Size of segment data
+} tSocketWrapperSegment;
+
+/**
+\brief Received datagram
+
+The datagram is passed to the batch receive callback. The data is only valid
+during the callback.
+*/
+typedef struct
+{
+    const UINT8*            pData;      ///< Pointer to datagram payload
+    size_t                  size;       ///< Size of datagram payload
+    tSocketWrapperAddress   remote;     ///< Address of the sender
+} tSocketWrapperDatagram;
+
+/**
+\brief Batch receive callback
+
+The callback is called by socketwrapper_process() with all datagrams which
+were queued for the instance since the last call.
+
+\param  pSocketWrapper_p    Socket wrapper instance.
+\param  paDatagram_p        Array of received datagrams.
+\param  count_p             Number of datagrams in the array.
+*/
+typedef void (*tSocketWrapperBatchCb)(tSocketWrapper pSocketWrapper_p,
+                                      const tSocketWrapperDatagram* paDatagram_p,
+                                      UINT count_p);
+
+/**
+\brief Receive statistics of a socket wrapper instance
+*/
+typedef struct
+{
+    UINT32      rxCount;            ///< Datagrams received for the instance
+    UINT32      rxQueueFullCount;   ///< Datagrams dropped because the receive queue was full
+    UINT32      rxOversizeCount;    ///< Datagrams dropped because they do not fit into a queue entry
+    UINT32      batchCount;         ///< Calls of the batch receive callback
+    UINT16      rxQueuePeak;        ///< Maximum number of queued datagrams
+} tSocketWrapperStatistics;
+
 //------------------------------------------------------------------------------
 // function prototypes
 //------------------------------------------------------------------------------
@@ -63,6 +150,18 @@ extern "C"
 #endif
 
 tOplkError      socketwrapper_setIpStackHandle(IP_STACK_H pHandle_p);
+tOplkError      socketwrapper_sendSegments(tSocketWrapper pSocketWrapper_p,
+                                           const tSocketWrapperAddress* pRemote_p,
+                                           const tSocketWrapperSegment* pSegment_p,
+                                           UINT segmentCount_p);
+void*           socketwrapper_reserve(tSocketWrapper pSocketWrapper_p, size_t maxSize_p);
+tOplkError      socketwrapper_sendReserved(tSocketWrapper pSocketWrapper_p,
+                                           const tSocketWrapperAddress* pRemote_p,
+                                           void* pData_p, size_t dataSize_p);
+void            socketwrapper_release(tSocketWrapper pSocketWrapper_p, void* pData_p);
+tSocketWrapper  socketwrapper_createQueued(tSocketWrapperBatchCb pfnBatchCb_p);
+UINT            socketwrapper_process(void);
+const tSocketWrapperStatistics* socketwrapper_getStatistics(tSocketWrapper pSocketWrapper_p);
 
 #ifdef __cplusplus
 }
@@ -82,24 +82,60 @@ This module connects the IP stack with the SDO/UDP module.
 // local types
 //------------------------------------------------------------------------------
 
+/**
+\brief Receive queue entry
+*/
+typedef struct
+{
+    tSocketWrapperAddress   remote;                                 ///< Address of the sender
+    size_t                  size;                                   ///< Size of the datagram payload
+    UINT8                   aData[SOCKETWRAPPER_RX_DATA_SIZE];      ///< Datagram payload
+} tSocketWrapRxEntry;
+
+/**
+\brief Receive queue of an instance created with socketwrapper_createQueued()
+*/
+typedef struct
+{
+    BOOL                    fUsed;                                  ///< Queue is taken by an instance
+    UINT                    rxRead;                                 ///< Index of the oldest queued datagram
+    UINT                    rxCount;                                ///< Number of queued datagrams
+    tSocketWrapRxEntry      aEntry[SOCKETWRAPPER_RX_QUEUE_SIZE];    ///< Queued datagrams
+} tSocketWrapRxQueue;
+
 typedef struct
 {
     BOOL                    fInitialized;      ///< Flag to indicate whether socketwrapper instance is created.
+    BOOL                    fListening;        ///< Flag to indicate whether the port is opened in the IP stack.
+    UINT16                  listenPort;        ///< Port opened in the IP stack.
     IP_STACK_H              pIpStackHandle;    ///< Pointer to IP stack handle.
     tSocketWrapperAddress   socketAddress;     ///< Address of Socket Wrapper.
     tSocketWrapperReceiveCb socketReceiveCb;   ///< Receive callback function for the socket wrapper.
+    tSocketWrapperBatchCb   pfnBatchCb;        ///< Batch receive callback, NULL if datagrams are not queued.
+    tSocketWrapRxQueue*     pRxQueue;          ///< Receive queue, NULL if datagrams are not queued.
+    tSocketWrapperStatistics statistics;       ///< Receive statistics.
 } tSocketWrapInstance;
 
 //------------------------------------------------------------------------------
 // local vars
 //------------------------------------------------------------------------------
-static tSocketWrapInstance  instance_l;
+static tSocketWrapInstance  aInstance_l[SOCKETWRAPPER_INSTANCE_CNT];
+static IP_STACK_H           pIpStackHandle_l = NULL;
+#if SOCKETWRAPPER_RX_QUEUE_CNT > 0
+static tSocketWrapRxQueue   aRxQueue_l[SOCKETWRAPPER_RX_QUEUE_CNT];
+#endif
 
 //------------------------------------------------------------------------------
 // local function prototypes
 //------------------------------------------------------------------------------
 static void       receiveFromSocket(void* pArg_p, ip_udp_info* pInfo_p);
+static void       setUdpInfo(const tSocketWrapInstance* pInstance_p,
+                             const tSocketWrapperAddress* pRemote_p,
+                             ip_udp_info* pUdpInfo_p);
 static tOplkError updateIpStack(tSocketWrapInstance* pInstance_p);
+static tSocketWrapInstance* allocInstance(void);
+static tSocketWrapRxQueue*  findFreeRxQueue(void);
+static UINT       processInstance(tSocketWrapInstance* pInstance_p);
 
 //============================================================================//
 //            P U B L I C   F U N C T I O N S                                 //
@@ -109,7 +145,8 @@ static tOplkError updateIpStack(tSocketWrapInstance* pInstance_p);
 /**
 \brief  Create socket wrapper instance
 
-The function creates a socket wrapper instance.
+The function creates a socket wrapper instance. The receive callback is called
+for every datagram directly from the IP stack.
 
 \param  pfnReceiveCb_p      Socket receive callback
 
@@ -121,15 +158,60 @@ The function creates a socket wrapper instance.
 //------------------------------------------------------------------------------
 tSocketWrapper socketwrapper_create(tSocketWrapperReceiveCb pfnReceiveCb_p)
 {
-     if (pfnReceiveCb_p == NULL)
-         return NULL;
+    tSocketWrapInstance*    pInstance;
+
+    if (pfnReceiveCb_p == NULL)
+        return NULL;
 
-    memset(&instance_l, 0, sizeof(instance_l));
+    pInstance = allocInstance();
+    if (pInstance == NULL)
+        return NULL;
 
-    instance_l.fInitialized = TRUE;
-    instance_l.socketReceiveCb = pfnReceiveCb_p;
+    pInstance->socketReceiveCb = pfnReceiveCb_p;
 
-    return (tSocketWrapper)&instance_l;
+    return (tSocketWrapper)pInstance;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Create socket wrapper instance with receive queue
+
+The function creates a socket wrapper instance which queues the received
+datagrams. The queued datagrams are passed to the batch receive callback with
+one call per instance in socketwrapper_process(). The instance takes one of
+the SOCKETWRAPPER_RX_QUEUE_CNT receive queues until it is closed.
+
+\param  pfnBatchCb_p        Batch receive callback
+
+\return The function returns the created socket wrapper instance.
+\retval NULL    Error, no free instance or receive queue!
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+tSocketWrapper socketwrapper_createQueued(tSocketWrapperBatchCb pfnBatchCb_p)
+{
+    tSocketWrapInstance*    pInstance;
+    tSocketWrapRxQueue*     pRxQueue;
+
+    if (pfnBatchCb_p == NULL)
+        return NULL;
+
+    pRxQueue = findFreeRxQueue();
+    if (pRxQueue == NULL)
+        return NULL;
+
+    pInstance = allocInstance();
+    if (pInstance == NULL)
+        return NULL;
+
+    memset(pRxQueue, 0, sizeof(*pRxQueue));
+    pRxQueue->fUsed = TRUE;
+
+    pInstance->pfnBatchCb = pfnBatchCb_p;
+    pInstance->pRxQueue = pRxQueue;
+
+    return (tSocketWrapper)pInstance;
 }
 
 //------------------------------------------------------------------------------
@@ -190,6 +272,18 @@ void socketwrapper_close(tSocketWrapper pSocketWrapper_p)
     if (pInstance == NULL)
         return;
 
+    if (pInstance->fListening)
+    {
+        ipUdpClose(pInstance->pIpStackHandle, pInstance->listenPort);
+        pInstance->fListening = FALSE;
+    }
+
+    if (pInstance->pRxQueue != NULL)
+    {
+        pInstance->pRxQueue->fUsed = FALSE;
+        pInstance->pRxQueue = NULL;
+    }
+
     pInstance->fInitialized = FALSE;
 }
 
@@ -223,12 +317,9 @@ tOplkError socketwrapper_send(tSocketWrapper pSocketWrapper_p,
     if (!pInstance->fInitialized)
         return kErrorSdoUdpSocketError;
 
+    setUdpInfo(pInstance, pRemote_p, &udpInfo);
     udpInfo.pData = (void*)pData_p;
     udpInfo.len = dataSize_p;
-    udpInfo.localPort = instance_l.socketAddress.port;
-    udpInfo.localHost.S_un.S_addr = instance_l.socketAddress.ipAddress;
-    udpInfo.remotePort = htons(pRemote_p->port);
-    udpInfo.remoteHost.S_un.S_addr = pRemote_p->ipAddress;
 
     error = ipUdpSend(pInstance->pIpStackHandle, &udpInfo);
     if (error != (INT)dataSize_p)
@@ -237,6 +328,168 @@ tOplkError socketwrapper_send(tSocketWrapper pSocketWrapper_p,
     return kErrorOk;
 }
 
+//------------------------------------------------------------------------------
+/**
+\brief  Send segmented datagram to socket wrapper instance
+
+The function sends a datagram which consists of several segments to the remote
+address, e.g. a protocol header and the payload. The segments are copied
+directly to the transmit buffer of the IP stack, so the caller doesn't need to
+assemble the datagram in a temporary buffer.
+
+\param  pSocketWrapper_p    Socket wrapper instance.
+\param  pRemote_p           Pointer to remote socketwrapper address.
+\param  pSegment_p          Pointer to array of payload segments.
+\param  segmentCount_p      Number of segments (max. SOCKETWRAPPER_SEGMENTS_MAX).
+
+\return The function returns a tOplkError error code.
+\retval kErrorSdoUdpSendError   Too many segments, the datagram is larger than
+                                SOCKETWRAPPER_TX_DATA_SIZE or was not sent.
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+tOplkError socketwrapper_sendSegments(tSocketWrapper pSocketWrapper_p,
+                                      const tSocketWrapperAddress* pRemote_p,
+                                      const tSocketWrapperSegment* pSegment_p,
+                                      UINT segmentCount_p)
+{
+    tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)pSocketWrapper_p;
+    ip_udp_seg              aSeg[SOCKETWRAPPER_SEGMENTS_MAX];
+    size_t                  dataSize = 0;
+    UINT                    i;
+    INT                     error;
+    ip_udp_info             udpInfo;
+
+    if (pInstance == NULL)
+        return kErrorSdoUdpInvalidHdl;
+
+    if (!pInstance->fInitialized)
+        return kErrorSdoUdpSocketError;
+
+    if (segmentCount_p > SOCKETWRAPPER_SEGMENTS_MAX)
+        return kErrorSdoUdpSendError;
+
+    // The lengths of the IP stack are 16 bit, check before they are narrowed
+    for (i = 0; i < segmentCount_p; i++)
+    {
+        if (pSegment_p[i].size > SOCKETWRAPPER_TX_DATA_SIZE - dataSize)
+            return kErrorSdoUdpSendError;
+
+        aSeg[i].pData = pSegment_p[i].pData;
+        aSeg[i].len = (unsigned short)pSegment_p[i].size;
+        dataSize += pSegment_p[i].size;
+    }
+
+    setUdpInfo(pInstance, pRemote_p, &udpInfo);
+
+    error = ipUdpSendv(pInstance->pIpStackHandle, &udpInfo, aSeg, segmentCount_p);
+    if (error != (INT)dataSize)
+        return kErrorSdoUdpSendError;
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Reserve transmit buffer of socket wrapper instance
+
+The function reserves a transmit buffer of the IP stack. The caller writes the
+payload directly to the returned buffer and sends it with
+socketwrapper_sendReserved() or releases it with socketwrapper_release().
+
+\param  pSocketWrapper_p    Socket wrapper instance.
+\param  maxSize_p           Maximum payload size the caller will write.
+
+\return The function returns a pointer to the payload buffer.
+\retval NULL    No transmit buffer available or invalid instance.
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+void* socketwrapper_reserve(tSocketWrapper pSocketWrapper_p, size_t maxSize_p)
+{
+    tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)pSocketWrapper_p;
+
+    if ((pInstance == NULL) || !pInstance->fInitialized)
+        return NULL;
+
+    return ipUdpReserve(pInstance->pIpStackHandle, maxSize_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Send reserved buffer of socket wrapper instance
+
+The function sends a buffer reserved with socketwrapper_reserve() to the remote
+address. The buffer is released in any case.
+
+\param  pSocketWrapper_p    Socket wrapper instance.
+\param  pRemote_p           Pointer to remote socketwrapper address.
+\param  pData_p             Pointer returned by socketwrapper_reserve().
+\param  dataSize_p          Size of payload data written to the buffer.
+
+\return The function returns a tOplkError error code.
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+tOplkError socketwrapper_sendReserved(tSocketWrapper pSocketWrapper_p,
+                                      const tSocketWrapperAddress* pRemote_p,
+                                      void* pData_p, size_t dataSize_p)
+{
+    tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)pSocketWrapper_p;
+    INT                     error;
+    ip_udp_info             udpInfo;
+
+    if (pInstance == NULL)
+        return kErrorSdoUdpInvalidHdl;
+
+    if (!pInstance->fInitialized)
+    {
+        ipUdpRelease(pInstance->pIpStackHandle, pData_p);
+        return kErrorSdoUdpSocketError;
+    }
+
+    setUdpInfo(pInstance, pRemote_p, &udpInfo);
+    udpInfo.pData = pData_p;
+    udpInfo.len = dataSize_p;
+
+    error = ipUdpCommit(pInstance->pIpStackHandle, &udpInfo);
+    if (error != (INT)dataSize_p)
+    {
+        if (error == 0)
+            ipUdpRelease(pInstance->pIpStackHandle, pData_p);
+
+        return kErrorSdoUdpSendError;
+    }
+
+    return kErrorOk;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Release reserved buffer of socket wrapper instance
+
+The function releases a buffer reserved with socketwrapper_reserve() without
+sending it.
+
+\param  pSocketWrapper_p    Socket wrapper instance.
+\param  pData_p             Pointer returned by socketwrapper_reserve().
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+void socketwrapper_release(tSocketWrapper pSocketWrapper_p, void* pData_p)
+{
+    tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)pSocketWrapper_p;
+
+    if (pInstance == NULL)
+        return;
+
+    ipUdpRelease(pInstance->pIpStackHandle, pData_p);
+}
+
 //------------------------------------------------------------------------------
 /**
 \brief  Critical section
@@ -258,28 +511,88 @@ void socketwrapper_criticalSection(BOOL fEnable_p)
 /**
 \brief  Set IP stack handle
 
-The function sets the IP stack handle to the socket wrapper instance.
+The function sets the IP stack handle to all socket wrapper instances.
+Instances created later use the same handle.
 
 \param  pHandle_p           The IP stack handle
 
 \return The function returns a tOplkError error code.
+\retval kErrorApiNotInitialized    No socket wrapper instance was created yet.
 
 \ingroup module_socketwrapper
 */
 //------------------------------------------------------------------------------
 tOplkError socketwrapper_setIpStackHandle(IP_STACK_H pHandle_p)
 {
-    tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)&instance_l;
+    tOplkError              ret = kErrorApiNotInitialized;
+    tOplkError              error;
+    tSocketWrapInstance*    pInstance;
 
-    if (pInstance == NULL)
-        return kErrorSdoUdpInvalidHdl;
+    pIpStackHandle_l = pHandle_p;
 
-    if (!pInstance->fInitialized)
-        return kErrorApiNotInitialized;
+    for (pInstance = aInstance_l; pInstance < &aInstance_l[SOCKETWRAPPER_INSTANCE_CNT]; pInstance++)
+    {
+        if (!pInstance->fInitialized)
+            continue;
+
+        pInstance->pIpStackHandle = pHandle_p;
+
+        error = updateIpStack(pInstance);
+        if ((ret == kErrorOk) || (ret == kErrorApiNotInitialized))
+            ret = error;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Process socket wrapper instances
+
+The function passes the queued datagrams of every instance created with
+socketwrapper_createQueued() to its batch receive callback. The datagrams are
+queued while the IP stack is processed (ipPeriodic()), so the function has to
+be called from the same context after the IP stack.
+
+\return The function returns the number of delivered datagrams.
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+UINT socketwrapper_process(void)
+{
+    tSocketWrapInstance*    pInstance;
+    UINT                    count = 0;
+
+    for (pInstance = aInstance_l; pInstance < &aInstance_l[SOCKETWRAPPER_INSTANCE_CNT]; pInstance++)
+    {
+        if (pInstance->fInitialized && (pInstance->pRxQueue != NULL))
+            count += processInstance(pInstance);
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Get statistics of socket wrapper instance
+
+\param  pSocketWrapper_p    Socket wrapper instance.
+
+\return The function returns a pointer to the receive statistics.
+\retval NULL    Invalid instance.
+
+\ingroup module_socketwrapper
+*/
+//------------------------------------------------------------------------------
+const tSocketWrapperStatistics* socketwrapper_getStatistics(tSocketWrapper pSocketWrapper_p)
+{
+    tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)pSocketWrapper_p;
 
-    pInstance->pIpStackHandle = (IP_STACK_H)pHandle_p;
+    if (pInstance == NULL)
+        return NULL;
 
-    return updateIpStack(pInstance);
+    return &pInstance->statistics;
 }
 
 //============================================================================//
@@ -292,7 +605,9 @@ tOplkError socketwrapper_setIpStackHandle(IP_STACK_H pHandle_p)
 /**
 \brief  Socket receive callback
 
-The function is called by the IP stack socket if a frame is received.
+The function is called by the IP stack socket if a frame is received. The frame
+is passed to the receive callback or added to the receive queue of the
+instance.
 
 \param  pArg_p              Argument pointer holding the socket wrapper instance.
 \param  pInfo_p             Pointer to UDP frame info.
@@ -303,6 +618,8 @@ static void receiveFromSocket(void* pArg_p, ip_udp_info* pInfo_p)
 {
     tSocketWrapInstance*    pInstance = (tSocketWrapInstance*)pArg_p;
     tSocketWrapperAddress   remote;
+    tSocketWrapRxQueue*     pRxQueue;
+    tSocketWrapRxEntry*     pEntry;
 
     if (pInstance == NULL)
         return;
@@ -313,7 +630,155 @@ static void receiveFromSocket(void* pArg_p, ip_udp_info* pInfo_p)
     remote.ipAddress = pInfo_p->remoteHost.S_un.S_addr;
     remote.port = htons(pInfo_p->remotePort);
 
-    pInstance->socketReceiveCb((UINT8*)pInfo_p->pData, pInfo_p->len, &remote);
+    pInstance->statistics.rxCount++;
+
+    pRxQueue = pInstance->pRxQueue;
+    if (pRxQueue == NULL)
+    {
+        pInstance->socketReceiveCb((UINT8*)pInfo_p->pData, pInfo_p->len, &remote);
+        return;
+    }
+
+    if (pInfo_p->len > SOCKETWRAPPER_RX_DATA_SIZE)
+    {
+        pInstance->statistics.rxOversizeCount++;
+        return;
+    }
+
+    if (pRxQueue->rxCount >= SOCKETWRAPPER_RX_QUEUE_SIZE)
+    {
+        pInstance->statistics.rxQueueFullCount++;
+        return;
+    }
+
+    // The IP stack releases its buffer after the callback, so the payload is copied
+    pEntry = &pRxQueue->aEntry[(pRxQueue->rxRead + pRxQueue->rxCount) % SOCKETWRAPPER_RX_QUEUE_SIZE];
+    pEntry->remote = remote;
+    pEntry->size = pInfo_p->len;
+    memcpy(pEntry->aData, pInfo_p->pData, pInfo_p->len);
+
+    pRxQueue->rxCount++;
+    if (pRxQueue->rxCount > pInstance->statistics.rxQueuePeak)
+        pInstance->statistics.rxQueuePeak = (UINT16)pRxQueue->rxCount;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Deliver queued datagrams of an instance
+
+The function passes all queued datagrams of the instance to the batch receive
+callback with a single call.
+
+\param  pInstance_p         Pointer to socket wrapper instance
+
+\return The function returns the number of delivered datagrams.
+*/
+//------------------------------------------------------------------------------
+static UINT processInstance(tSocketWrapInstance* pInstance_p)
+{
+    tSocketWrapperDatagram  aDatagram[SOCKETWRAPPER_RX_QUEUE_SIZE];
+    tSocketWrapRxQueue*     pRxQueue = pInstance_p->pRxQueue;
+    tSocketWrapRxEntry*     pEntry;
+    UINT                    count = pRxQueue->rxCount;
+    UINT                    i;
+
+    if (count == 0)
+        return 0;
+
+    for (i = 0; i < count; i++)
+    {
+        pEntry = &pRxQueue->aEntry[(pRxQueue->rxRead + i) % SOCKETWRAPPER_RX_QUEUE_SIZE];
+
+        aDatagram[i].pData = pEntry->aData;
+        aDatagram[i].size = pEntry->size;
+        aDatagram[i].remote = pEntry->remote;
+    }
+
+    pInstance_p->statistics.batchCount++;
+    pInstance_p->pfnBatchCb((tSocketWrapper)pInstance_p, aDatagram, count);
+
+    // The entries are free after the callback, the instance may be closed by it
+    if ((pInstance_p->pRxQueue == pRxQueue) && (pRxQueue->rxCount >= count))
+    {
+        pRxQueue->rxRead = (pRxQueue->rxRead + count) % SOCKETWRAPPER_RX_QUEUE_SIZE;
+        pRxQueue->rxCount -= count;
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Allocate socket wrapper instance
+
+\return The function returns a free and cleared instance.
+\retval NULL    All instances are in use.
+*/
+//------------------------------------------------------------------------------
+static tSocketWrapInstance* allocInstance(void)
+{
+    tSocketWrapInstance*    pInstance;
+
+    for (pInstance = aInstance_l; pInstance < &aInstance_l[SOCKETWRAPPER_INSTANCE_CNT]; pInstance++)
+    {
+        if (pInstance->fInitialized)
+            continue;
+
+        memset(pInstance, 0, sizeof(*pInstance));
+
+        pInstance->fInitialized = TRUE;
+        pInstance->pIpStackHandle = pIpStackHandle_l;
+
+        return pInstance;
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Find free receive queue
+
+\return The function returns a receive queue which is not taken by an instance.
+\retval NULL    All receive queues are in use.
+*/
+//------------------------------------------------------------------------------
+static tSocketWrapRxQueue* findFreeRxQueue(void)
+{
+#if SOCKETWRAPPER_RX_QUEUE_CNT > 0
+    tSocketWrapRxQueue*     pRxQueue;
+
+    for (pRxQueue = aRxQueue_l; pRxQueue < &aRxQueue_l[SOCKETWRAPPER_RX_QUEUE_CNT]; pRxQueue++)
+    {
+        if (!pRxQueue->fUsed)
+            return pRxQueue;
+    }
+#endif
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief  Set UDP info for sending
+
+The function fills the local and remote address of a datagram to send.
+
+\param  pInstance_p         Pointer to socket wrapper instance
+\param  pRemote_p           Pointer to remote socketwrapper address.
+\param  pUdpInfo_p          UDP info to fill.
+*/
+//------------------------------------------------------------------------------
+static void setUdpInfo(const tSocketWrapInstance* pInstance_p,
+                       const tSocketWrapperAddress* pRemote_p,
+                       ip_udp_info* pUdpInfo_p)
+{
+    pUdpInfo_p->pData = NULL;
+    pUdpInfo_p->len = 0;
+    pUdpInfo_p->localPort = pInstance_p->socketAddress.port;
+    pUdpInfo_p->localHost.S_un.S_addr = pInstance_p->socketAddress.ipAddress;
+    pUdpInfo_p->remotePort = htons(pRemote_p->port);
+    pUdpInfo_p->remoteHost.S_un.S_addr = pRemote_p->ipAddress;
 }
 
 //------------------------------------------------------------------------------
@@ -334,11 +799,21 @@ static tOplkError updateIpStack(tSocketWrapInstance* pInstance_p)
 
     ipChangeAddress(pInstance_p->pIpStackHandle, (struct in_addr*)&ipAddr);
 
+    // A new bind replaces the listen port of the last one
+    if (pInstance_p->fListening)
+    {
+        ipUdpClose(pInstance_p->pIpStackHandle, pInstance_p->listenPort);
+        pInstance_p->fListening = FALSE;
+    }
+
     error = ipUdpListen(pInstance_p->pIpStackHandle, pInstance_p->socketAddress.port,
                         receiveFromSocket, pInstance_p);
     if (error < 0)
         return kErrorSdoUdpInvalidHdl;
 
+    pInstance_p->fListening = TRUE;
+    pInstance_p->listenPort = pInstance_p->socketAddress.port;
+
     return kErrorOk;
 }
 
@@ -0,0 +1,778 @@
+/**
+********************************************************************************
+\file   TSTipcases.c
+
+\brief  Directed cases of the IP stack traffic harness
+
+The cases send exact frame sequences to the stack and check its statistics
+afterwards. They cover situations which the random traffic reaches only by
+chance: the reassembly with fragments out of order and overlapping, the
+timeout of an incomplete datagram, the exhaustion of the datagram and
+frame pools of the reassembly, a TCP connection which is released while
+its segment waits for an ARP reply and the send coalescing on an idle
+connection. The case chksum compares the checksum
+functions of the stack with a bytewise reference and reports their speed.
+
+Usage: tstiptraffic -c reass_order|reass_overlap|reass_timeout|reass_pool|arp_close|nagle_idle|chksum
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include <time.h>
+
+#include <Driver/TSTiptrafficConfig.h>
+#include <Stubs/STBedrv.h>
+
+#include <ip_internal.h>
+
+#if IP_STATISTICS != 1
+#error "The directed cases check the statistics of the stack, IP_STATISTICS must be 1"
+#endif
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define CASE_PAYLOAD_SIZE       1200    ///< UDP payload of the datagrams of the cases
+#define CASE_UDP_SIZE           (8 + CASE_PAYLOAD_SIZE)
+#define CASE_DRAIN_CYCLES       100     ///< Cycles for the answers at the end of a case
+#define CASE_CONNECT_CYCLES     2000    ///< Cycles of TCP traffic to establish the connections
+#define CASE_CHKSUM_SIZE        1500    ///< Largest block of the checksum case
+#define CASE_CHKSUM_LOOPS       20000   ///< Calls per block size of the checksum benchmark
+
+#if IP_REASS_DGRAM_CNT + 1 > TST_PEER_CNT
+#error "reass_pool needs a remote host for each datagram of the reassembly"
+#endif
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Directed case
+*/
+typedef struct
+{
+    const char*     pName;              ///< Name of the case (option -c)
+    int             (*pfnRun)(void);    ///< Runs the case, returns 0 if all checks passed
+} tCase;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static IP_STACK_H   hIp_l;
+static uint64_t     timeNs_l;
+static tTstFrame    frame_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int      caseReassOrder(void);
+static int      caseReassOverlap(void);
+static int      caseReassTimeout(void);
+static int      caseReassPool(void);
+#if IP_TCP_SOCKETS > 0
+static int      caseArpClose(void);
+static int      caseNagleIdle(void);
+static SOCK_PTR findIdleConnection(void);
+#endif
+static int      caseChksum(void);
+static uint16_t chksumReference(const uint8_t* pData_p, size_t len_p);
+static uint64_t benchChksum(const uint8_t* pData_p, size_t len_p, int fReference_p,
+                            volatile uint16_t* pChksum_p);
+static void     sendFragment(int dgram_p, size_t offset_p, size_t len_p);
+static void     runTraffic(tTstTrafficType type_p, unsigned long count_p);
+static void     runCycles(unsigned long count_p);
+static int      check(const char* pName_p, unsigned long value_p, unsigned long expected_p);
+
+static const tCase aCase_l[] =
+{
+    {"reass_order",     caseReassOrder},
+    {"reass_overlap",   caseReassOverlap},
+    {"reass_timeout",   caseReassTimeout},
+    {"reass_pool",      caseReassPool},
+#if IP_TCP_SOCKETS > 0
+    {"arp_close",       caseArpClose},
+    {"nagle_idle",      caseNagleIdle},
+#endif
+    {"chksum",          caseChksum},
+};
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run a directed case
+
+\param[in] pName_p          Name of the case
+\param[in] hIp_p            Running IP stack
+\param[in] timeNs_p         Virtual time of the first cycle
+
+\return int
+\retval 0       All checks of the case passed
+\retval -1      A check failed
+\retval -2      Unknown case
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_caseRun(const char* pName_p, IP_STACK_H hIp_p, uint64_t timeNs_p)
+{
+    unsigned int i;
+
+    hIp_l    = hIp_p;
+    timeNs_l = timeNs_p;
+
+    for (i = 0; i < sizeof(aCase_l) / sizeof(aCase_l[0]); i++)
+    {
+        if (strcmp(aCase_l[i].pName, pName_p) == 0)
+            return aCase_l[i].pfnRun();
+    }
+
+    return -2;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Fragments out of order and interleaved with a second datagram
+
+The last fragment arrives first, so the length of the datagram is known before
+its start. The fragments of both datagrams are held by reference, none of them
+has to be linearized early.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseReassOrder(void)
+{
+    const ip_stat*  pStat = ipStats(hIp_l);
+    int             dgram0 = TST_genDatagram(0, CASE_PAYLOAD_SIZE);
+    int             dgram1 = TST_genDatagram(1, CASE_PAYLOAD_SIZE);
+    int             ret = 0;
+
+    sendFragment(dgram0, 912, CASE_UDP_SIZE - 912);
+    sendFragment(dgram1, 600, CASE_UDP_SIZE - 600);
+    sendFragment(dgram0, 304, 304);
+    sendFragment(dgram1, 0, 600);
+    sendFragment(dgram0, 0, 304);
+    sendFragment(dgram0, 608, 304);
+    runCycles(CASE_DRAIN_CYCLES);
+
+    ret |= check("datagrams reassembled", pStat->ip_reass_ok, 2);
+    ret |= check("datagrams linearized early", pStat->ip_reass_linear, 0);
+    ret |= check("datagrams dropped", pStat->ip_reass_drop, 0);
+    ret |= check("datagrams delivered", TST_genGetStatistics()->udpDelivered, 2);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Overlapping and duplicated fragments
+
+A fragment inside the received data is ignored, a fragment which overlaps the
+received data closes the remaining hole. A repetition after the completion is
+counted as late.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseReassOverlap(void)
+{
+    const ip_stat*  pStat = ipStats(hIp_l);
+    int             dgram = TST_genDatagram(0, CASE_PAYLOAD_SIZE);
+    int             ret = 0;
+
+    sendFragment(dgram, 600, CASE_UDP_SIZE - 600);
+    sendFragment(dgram, 0, 400);
+    sendFragment(dgram, 200, 200);
+    ret |= check("datagrams reassembled before the last hole", pStat->ip_reass_ok, 0);
+
+    sendFragment(dgram, 200, 400);
+    sendFragment(dgram, 0, 400);
+    runCycles(CASE_DRAIN_CYCLES);
+
+    ret |= check("datagrams reassembled", pStat->ip_reass_ok, 1);
+    ret |= check("late fragments", pStat->ip_reass_late_rx, 1);
+    ret |= check("datagrams dropped", pStat->ip_reass_drop, 0);
+    ret |= check("datagrams delivered", TST_genGetStatistics()->udpDelivered, 1);
+    ret |= check("invalid datagrams", TST_genGetStatistics()->invalidFrames, 0);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Timeout of an incomplete datagram
+
+The held frames are released when the datagram times out, the missing fragment
+arriving afterwards is dropped as late. A following datagram is reassembled
+again.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseReassTimeout(void)
+{
+    const ip_stat*  pStat = ipStats(hIp_l);
+    int             dgram0 = TST_genDatagram(0, CASE_PAYLOAD_SIZE);
+    int             dgram1 = TST_genDatagram(0, CASE_PAYLOAD_SIZE);
+    int             ret = 0;
+
+    sendFragment(dgram0, 0, 400);
+    sendFragment(dgram0, 800, CASE_UDP_SIZE - 800);
+    ret |= check("frames held by the reassembly", stb_edrvGetStatistics()->rxInUse, 2);
+
+    runCycles((IP_REASS_MAXAGE + 2) * (1000000000ULL / TST_CYCLE_NS));
+    ret |= check("datagrams timed out", pStat->ip_reass_timeout, 1);
+    ret |= check("frames held after the timeout", stb_edrvGetStatistics()->rxInUse, 0);
+
+    sendFragment(dgram0, 400, 400);
+    ret |= check("late fragments", pStat->ip_reass_late_rx, 1);
+
+    sendFragment(dgram1, 600, CASE_UDP_SIZE - 600);
+    sendFragment(dgram1, 0, 600);
+    runCycles(CASE_DRAIN_CYCLES);
+
+    ret |= check("datagrams reassembled", pStat->ip_reass_ok, 1);
+    ret |= check("datagrams delivered", TST_genGetStatistics()->udpDelivered, 1);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Exhaustion of the datagram and frame pools
+
+More datagrams are started than the reassembly can track. Only
+IP_REASS_FRAG_CNT frames are held, the next datagram is linearized into a
+reassembly buffer and the datagram without a descriptor is dropped. The driver
+never runs out of receive buffers and all tracked datagrams are completed.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseReassPool(void)
+{
+    const ip_stat*  pStat = ipStats(hIp_l);
+    int             aDgram[IP_REASS_DGRAM_CNT + 1];
+    unsigned int    i;
+    int             ret = 0;
+
+    for (i = 0; i < IP_REASS_DGRAM_CNT + 1; i++)
+    {
+        aDgram[i] = TST_genDatagram(i, CASE_PAYLOAD_SIZE);
+        sendFragment(aDgram[i], 0, 400);
+    }
+
+    ret |= check("frames held by the reassembly", stb_edrvGetStatistics()->rxInUse,
+                 IP_REASS_FRAG_CNT);
+    ret |= check("datagrams linearized early", pStat->ip_reass_linear,
+                 IP_REASS_DGRAM_CNT - IP_REASS_FRAG_CNT);
+    ret |= check("datagrams dropped", pStat->ip_reass_drop, 1);
+
+    for (i = 0; i < IP_REASS_DGRAM_CNT; i++)
+        sendFragment(aDgram[i], 400, CASE_UDP_SIZE - 400);
+    runCycles(CASE_DRAIN_CYCLES);
+
+    ret |= check("datagrams reassembled", pStat->ip_reass_ok, IP_REASS_DGRAM_CNT);
+    ret |= check("datagrams delivered", TST_genGetStatistics()->udpDelivered,
+                 IP_REASS_DGRAM_CNT);
+    ret |= check("frames without driver buffer", stb_edrvGetStatistics()->rxNoBuffer, 0);
+
+    return ret;
+}
+
+#if IP_TCP_SOCKETS > 0
+//------------------------------------------------------------------------------
+/**
+\brief    Connection released while its segment waits for an ARP reply
+
+The ARP table is cleared, so the next segment of an established connection is
+held by the ARP entry of the remote host. The connection is then released like
+by a reset of the remote host. The ARP entry keeps the segment: the buffer is
+not handed out again, it is sent with the ARP reply and released afterwards.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseArpClose(void)
+{
+    static const char   aData[] = "segment behind an unresolved address";
+    const ip_stat*      pStat = ipStats(hIp_l);
+    SOCK_PTR            sock;
+    ip_buf_type*        pSegment;
+    ip_buf_type*        pBuf;
+    ip_buf_type*        apAlloc[IP_TX_BUF_CNT];
+    unsigned int        allocCount = 0;
+    unsigned long       reused = 0;
+    unsigned long       held = 0;
+    unsigned long       inUse = 0;
+    unsigned long       echoed;
+    unsigned int        i;
+    int                 ret = 0;
+
+    runTraffic(kTstTrafficTcp, CASE_CONNECT_CYCLES);
+    runCycles(CASE_DRAIN_CYCLES);
+
+    sock = findIdleConnection();
+    if (sock == NULL)
+    {
+        printf("FAIL: no idle TCP connection\n");
+        return -1;
+    }
+
+    // Forget all addresses, the next segment has to wait for the ARP reply
+    for (i = 0; i < IP_ARP_TABSIZE; i++)
+        hIp_l->arp_table[i].state = ARP_STATE_FREE;
+    hIp_l->arp_unresolved = 0;
+
+    if (send((SOCKET)sock, aData, sizeof(aData)) != (int)sizeof(aData))
+    {
+        printf("FAIL: segment not accepted by the connection\n");
+        return -1;
+    }
+
+    // Only cycles without frames, the ARP reply comes with the next frame of the hosts
+    pSegment = sock->pTx;
+    for (i = 0; (i < CASE_DRAIN_CYCLES) && (pSegment->header.state == IP_BUF_STATE_TX); i++)
+    {
+        timeNs_l += TST_CYCLE_NS;
+        frame_l.len = 0;
+        TST_runCycle(&frame_l, timeNs_l);
+    }
+
+    for (i = 0; i < IP_ARP_TABSIZE; i++)
+    {
+        if (hIp_l->arp_table[i].pPending == pSegment)
+            held++;
+    }
+    ret |= check("segments held by the ARP entry", held, 1);
+
+    // Release the connection like sock_in() does for a reset of a closing connection
+    closesocket((SOCKET)sock);
+    ip_socket_free(sock, IP_FREE);
+
+    while ((pBuf = ip_alloc_tx_buffer(hIp_l)) != NULL)
+    {
+        if (pBuf == pSegment)
+            reused++;
+        apAlloc[allocCount++] = pBuf;
+    }
+    for (i = 0; i < allocCount; i++)
+        apAlloc[i]->header.state = IP_BUF_STATE_IDLE;
+
+    ret |= check("held segment handed out again", reused, 0);
+
+    echoed = TST_genGetStatistics()->tcpBytesEchoed;
+    runCycles(CASE_DRAIN_CYCLES);
+
+    for (i = 0; i < IP_TX_BUF_CNT; i++)
+    {
+        if (hIp_l->pTxBuffer[i].header.state != IP_BUF_STATE_IDLE)
+            inUse++;
+    }
+
+    ret |= check("ARP entries resolved", hIp_l->arp_unresolved, 0);
+    ret |= check("tx buffers in use", inUse, 0);
+    ret |= check("segments dropped by the ARP entry", pStat->arp_queue_drop, 0);
+    ret |= check("bytes sent with the ARP reply",
+                 TST_genGetStatistics()->tcpBytesEchoed - echoed, sizeof(aData));
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Partial segment on an idle connection
+
+Without unacknowledged data there is nothing a held segment could wait for.
+A segment smaller than the MSS is sent by the first sock_out() call, like
+with TCP_NODELAY.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseNagleIdle(void)
+{
+    static const char   aData[] = "request on an idle connection";
+    SOCK_PTR            sock;
+    ip_buf_type*        pSegment;
+    unsigned long       echoed;
+    int                 ret = 0;
+
+    runTraffic(kTstTrafficTcp, CASE_CONNECT_CYCLES);
+    runCycles(CASE_DRAIN_CYCLES);
+
+    sock = findIdleConnection();
+    if (sock == NULL)
+    {
+        printf("FAIL: no idle TCP connection\n");
+        return -1;
+    }
+
+    if (send((SOCKET)sock, aData, sizeof(aData)) != (int)sizeof(aData))
+    {
+        printf("FAIL: segment not accepted by the connection\n");
+        return -1;
+    }
+
+    // One cycle without frames of the hosts
+    pSegment = sock->pTx;
+    echoed = TST_genGetStatistics()->tcpBytesEchoed;
+    timeNs_l += TST_CYCLE_NS;
+    frame_l.len = 0;
+    TST_runCycle(&frame_l, timeNs_l);
+
+    ret |= check("segments held on the idle connection",
+                 (pSegment->header.state == IP_BUF_STATE_TX) ? 1 : 0, 0);
+
+    runCycles(CASE_DRAIN_CYCLES);
+    ret |= check("bytes received by the host",
+                 TST_genGetStatistics()->tcpBytesEchoed - echoed, sizeof(aData));
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Find an established connection without outstanding data
+
+\return SOCK_PTR
+\retval NULL    No idle connection
+*/
+//------------------------------------------------------------------------------
+static SOCK_PTR findIdleConnection(void)
+{
+    SOCK_PTR sock;
+
+    for (sock = hIp_l->sock; sock < hIp_l->sock + IP_TCP_SOCKETS; sock++)
+    {
+        if ((sock->type == SOCK_STREAM) && (sock->header.state == IP_CONNECTED) &&
+            (sock->pTx == NULL) && (sock->len == 0) && (sock->pRx == NULL) &&
+            (sock->mss != 0) && !sock->cmdClose)
+            return sock;
+    }
+
+    return NULL;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+\brief    Checksum functions against a bytewise reference
+
+ip_chksum_partial() is checked for all lengths up to CASE_CHKSUM_SIZE, in one
+block and split into two blocks at every even offset of a short block.
+ip_chksum_adjust() has to keep a rewritten header valid. Afterwards the time
+per call of the stack and of the reference is reported for frame sizes.
+
+\return int
+\retval 0       All checks passed
+\retval -1      A check failed
+*/
+//------------------------------------------------------------------------------
+static int caseChksum(void)
+{
+    static const size_t aBenchLen[] = {20, 64, 576, CASE_CHKSUM_SIZE};
+    unsigned long       aData[CASE_CHKSUM_SIZE / sizeof(unsigned long) + 1];
+    uint8_t*            pData = (uint8_t*)aData;
+    uint32_t            random = 0x12345678;
+    unsigned long       mismatch = 0;
+    unsigned long       splitMismatch = 0;
+    unsigned long       adjustInvalid = 0;
+    unsigned short      chksum;
+    unsigned short      word;
+    uint16_t            expected;
+    size_t              len;
+    size_t              split;
+    unsigned int        i;
+    uint64_t            stackNs;
+    uint64_t            referenceNs;
+    uint16_t            stackChksum;
+    uint16_t            referenceChksum;
+
+    for (i = 0; i < CASE_CHKSUM_SIZE; i++)
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        pData[i] = (uint8_t)random;
+    }
+
+    for (len = 0; len <= CASE_CHKSUM_SIZE; len++)
+    {
+        expected = chksumReference(pData, len);
+
+        chksum = ip_chksum_fold(ip_chksum_partial(pData, len, 0));
+        if (memcmp(&chksum, &expected, sizeof(chksum)) != 0)
+            mismatch++;
+
+        if (len > 64)
+            continue;
+
+        for (split = 0; split <= len; split += 2)
+        {
+            chksum = ip_chksum_fold(ip_chksum_partial(pData + split, len - split,
+                                                      ip_chksum_partial(pData, split, 0)));
+            if (memcmp(&chksum, &expected, sizeof(chksum)) != 0)
+                splitMismatch++;
+        }
+    }
+
+    // A header with a valid checksum in the last word, every other word is rewritten
+    chksum = ip_chksum_fold(ip_chksum_partial(pData, 18, 0));
+    memcpy(pData + 18, &chksum, sizeof(chksum));
+    for (i = 0; i < 9; i++)
+    {
+        memcpy(&word, pData + 2 * i, sizeof(word));
+        chksum = ip_chksum_adjust(chksum, word, (unsigned short)(word ^ (0x1111 * (i + 1))));
+        word ^= (unsigned short)(0x1111 * (i + 1));
+        memcpy(pData + 2 * i, &word, sizeof(word));
+        memcpy(pData + 18, &chksum, sizeof(chksum));
+
+        if (ip_chksum_fold(ip_chksum_partial(pData, 20, 0)) != 0)
+            adjustInvalid++;
+    }
+
+    for (i = 0; i < sizeof(aBenchLen) / sizeof(aBenchLen[0]); i++)
+    {
+        stackNs     = benchChksum(pData, aBenchLen[i], 0, &stackChksum);
+        referenceNs = benchChksum(pData, aBenchLen[i], 1, &referenceChksum);
+        if (stackChksum != referenceChksum)
+            mismatch++;
+
+        printf("chksum %4u bytes: stack %6.1f ns (%6.0f MB/s), reference %6.1f ns\n",
+               (unsigned int)aBenchLen[i],
+               (double)stackNs / CASE_CHKSUM_LOOPS,
+               (stackNs != 0) ? (double)aBenchLen[i] * CASE_CHKSUM_LOOPS * 1000.0 / stackNs : 0.0,
+               (double)referenceNs / CASE_CHKSUM_LOOPS);
+    }
+
+    return check("checksums differing from the reference", mismatch, 0) |
+           check("checksums of split blocks differing", splitMismatch, 0) |
+           check("invalid headers after an incremental update", adjustInvalid, 0);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Bytewise Internet checksum (RFC 1071)
+
+\param[in] pData_p          Data
+\param[in] len_p            Number of bytes, an odd length is padded with zero
+
+\return uint16_t
+\retval Checksum in network byte order (as it is stored in memory)
+*/
+//------------------------------------------------------------------------------
+static uint16_t chksumReference(const uint8_t* pData_p, size_t len_p)
+{
+    uint32_t    sum = 0;
+    uint8_t     aChksum[2];
+    uint16_t    chksum;
+    size_t      i;
+
+    for (i = 0; i < len_p; i++)
+        sum += (i & 1) ? pData_p[i] : ((uint32_t)pData_p[i] << 8);
+
+    while (sum >> 16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+
+    sum = ~sum & 0xFFFF;
+    aChksum[0] = (uint8_t)(sum >> 8);
+    aChksum[1] = (uint8_t)sum;
+    memcpy(&chksum, aChksum, sizeof(chksum));
+
+    return chksum;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Measure the checksum of a block
+
+\param[in] pData_p          Data (16 bit aligned)
+\param[in] len_p            Number of bytes
+\param[in] fReference_p     Nonzero: reference, 0: ip_chksum_partial()
+\param[out] pChksum_p       Checksum of the block (volatile, every call is measured)
+
+\return uint64_t
+\retval CPU time of CASE_CHKSUM_LOOPS calls in ns
+*/
+//------------------------------------------------------------------------------
+static uint64_t benchChksum(const uint8_t* pData_p, size_t len_p, int fReference_p,
+                            volatile uint16_t* pChksum_p)
+{
+    struct timespec start;
+    struct timespec end;
+    unsigned int    i;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+
+    for (i = 0; i < CASE_CHKSUM_LOOPS; i++)
+    {
+        if (fReference_p)
+            *pChksum_p = chksumReference(pData_p, len_p);
+        else
+            *pChksum_p = ip_chksum_fold(ip_chksum_partial(pData_p, len_p, 0));
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+
+    return ((uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL) +
+           (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Pass a fragment to the stack in one cycle
+
+\param[in] dgram_p          Index of the datagram
+\param[in] offset_p         Offset of the fragment in the UDP datagram
+\param[in] len_p            Length of the fragment
+*/
+//------------------------------------------------------------------------------
+static void sendFragment(int dgram_p, size_t offset_p, size_t len_p)
+{
+    timeNs_l += TST_CYCLE_NS;
+
+    if (TST_genFragment(dgram_p, offset_p, len_p, timeNs_l, &frame_l) != 0)
+    {
+        printf("FAIL: invalid fragment %u..%u of datagram %d\n",
+               (unsigned int)offset_p, (unsigned int)(offset_p + len_p), dgram_p);
+        frame_l.len = 0;
+    }
+
+    TST_runCycle(&frame_l, timeNs_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run cycles with generated traffic
+
+\param[in] type_p           Traffic type of the remote hosts
+\param[in] count_p          Number of cycles
+*/
+//------------------------------------------------------------------------------
+static void runTraffic(tTstTrafficType type_p, unsigned long count_p)
+{
+    unsigned long i;
+
+    for (i = 0; i < count_p; i++)
+    {
+        timeNs_l += TST_CYCLE_NS;
+
+        if (!TST_genNext(type_p, timeNs_l, &frame_l))
+            frame_l.len = 0;
+
+        TST_runCycle(&frame_l, timeNs_l);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run cycles with the answers of the remote hosts only
+
+\param[in] count_p          Number of cycles
+*/
+//------------------------------------------------------------------------------
+static void runCycles(unsigned long count_p)
+{
+    runTraffic(kTstTrafficNone, count_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check a counter of a case
+
+\param[in] pName_p          Name of the counter
+\param[in] value_p          Value of the counter
+\param[in] expected_p       Expected value
+
+\return int
+\retval 0       Counter has the expected value
+\retval -1      Counter differs
+*/
+//------------------------------------------------------------------------------
+static int check(const char* pName_p, unsigned long value_p, unsigned long expected_p)
+{
+    if (value_p == expected_p)
+        return 0;
+
+    printf("FAIL: %s %lu, expected %lu\n", pName_p, value_p, expected_p);
+    return -1;
+}
+
@@ -0,0 +1,843 @@
+/**
+********************************************************************************
+\file   TSTiptraffic.c
+
+\brief  Traffic harness of the IP stack
+
+The harness runs the IP stack with the fake Ethernet driver. In every cycle one
+frame is passed to the stack and the stack and the application are polled. The
+frames are either generated by the traffic generator or replayed from a pcap or
+pcapng capture. The application runs an UDP and a TCP echo server (the TCP
+server only if the stack is built with sockets). With -p the fake driver
+offers every frame to ipPacketProcess() before it loans a copy to the stack.
+With -d the echo connections are set to TCP_NODELAY (no send coalescing).
+With -c a directed case (see TSTipcases.c) is run instead of a traffic load.
+
+After the run the harness reports the packet rate, the CPU time per packet,
+the high-water marks of the buffers and the TCP goodput (echoed payload per
+second of virtual and of CPU time, payload per segment of the stack). Generated traffic is checked for
+missing or wrong answers of the stack.
+
+Usage: tstiptraffic [-g arp|icmp|udp|tcp|frag|mixed | -r capture [-t] | -c case]
+                    [-n count] [-w capture] [-s seed] [-p] [-d] [-q]
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <Driver/TSTiptrafficConfig.h>
+#include <Stubs/STBedrv.h>
+
+#include <ip_internal.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_FRAME_CNT_DEFAULT   10000   ///< Frames of a synthetic run
+#define TST_STARTUP_CYCLES      100     ///< Cycles to wait for the stack to become ready
+#define TST_DRAIN_CYCLES        2000    ///< Cycles without new traffic at the end of a run
+#define TST_ECHO_BUF_SIZE       2048    ///< Echo buffer of a TCP connection
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  TCP echo connection
+*/
+typedef struct
+{
+    SOCKET      sock;                           ///< Connected socket, INVALID_SOCKET if unused
+    size_t      len;                            ///< Data in the echo buffer
+    char        aBuffer[TST_ECHO_BUF_SIZE];     ///< Received data not yet sent back
+} tEchoConn;
+
+/**
+\brief  Measurement of a run
+*/
+typedef struct
+{
+    unsigned long   frames;             ///< Frames passed to the fake driver
+    unsigned long   cycles;             ///< Harness cycles
+    uint64_t        cpuNs;              ///< CPU time spent in the driver, stack and application
+    uint64_t        maxCycleNs;         ///< Maximum CPU time of a cycle with a frame
+    uint64_t        wallNs;             ///< Duration of the run
+    unsigned int    txHighWater;        ///< Maximum of the stack tx buffers in use
+    unsigned int    rxQueueHighWater;   ///< Maximum of the stack rx queue entries
+} tMeasurement;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static IP_STACK_H       hIp_l;
+#if IP_TCP_SOCKETS > 0
+static SOCKET           listenSock_l = INVALID_SOCKET;
+static tEchoConn        aConn_l[TST_TCP_PEER_CNT];
+#endif
+static tMeasurement     measurement_l;
+static int              fQuiet_l = 0;
+static int              fNoDelay_l = 0;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int      setupStack(const uint8_t* pMac_p, const uint8_t* pIp_p);
+static void     udpHook(void* pArg_p, ip_udp_info* pInfo_p);
+static void     pollApplication(void);
+static void     updateHighWater(void);
+static uint64_t getTimeNs(clockid_t clock_p);
+static void     sleepUntil(uint64_t timeNs_p);
+static int      parseType(const char* pName_p, tTstTrafficType* pType_p);
+static int      parseIp(const char* pText_p, uint8_t* pIp_p);
+static void     printReport(int fGenerated_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Traffic harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       Run finished without errors
+\retval 1       Invalid arguments or the stack could not be started
+\retval 2       The check of the run failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    static tTstFrame    frame;
+    tTstTrafficType     type = kTstTrafficNone;
+    tTstPcap            capture;
+    tTstPcap            record;
+    const char*         pReplayPath = NULL;
+    const char*         pRecordPath = NULL;
+    const char*         pCaseName = NULL;
+    unsigned long       frameCnt = 0;
+    unsigned int        seed = 1;
+    int                 fTimed = 0;
+    int                 fDirect = 0;
+    int                 ret = 0;
+    int                 c;
+    unsigned long       i;
+    uint64_t            timeNs;
+    uint64_t            firstNs = 0;
+    uint64_t            startNs;
+    uint8_t             aMac[6] = {0x00, 0x60, 0x65, 0x00, 0x00, 0x01};
+    uint8_t             aIp[4] = {192, 168, 100, 1};
+
+    memset(&capture, 0, sizeof(capture));
+    memset(&record, 0, sizeof(record));
+
+    while ((c = getopt(argc, argv, "g:r:c:tn:w:s:a:pdq")) != -1)
+    {
+        switch (c)
+        {
+            case 'g':
+                if (parseType(optarg, &type) != 0)
+                {
+                    fprintf(stderr, "Unknown traffic type %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'r':
+                pReplayPath = optarg;
+                break;
+
+            case 'c':
+                pCaseName = optarg;
+                break;
+
+            case 't':
+                fTimed = 1;
+                break;
+
+            case 'n':
+                frameCnt = strtoul(optarg, NULL, 0);
+                break;
+
+            case 'w':
+                pRecordPath = optarg;
+                break;
+
+            case 's':
+                seed = (unsigned int)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'a':
+                if (parseIp(optarg, aIp) != 0)
+                {
+                    fprintf(stderr, "Invalid IP address %s\n", optarg);
+                    return 1;
+                }
+                break;
+
+            case 'p':
+                fDirect = 1;
+                break;
+
+            case 'd':
+                fNoDelay_l = 1;
+                break;
+
+            case 'q':
+                fQuiet_l = 1;
+                break;
+
+            default:
+                return 1;
+        }
+    }
+
+    if ((pReplayPath != NULL) + (type != kTstTrafficNone) + (pCaseName != NULL) != 1)
+    {
+        fprintf(stderr, "Usage: %s [-g arp|icmp|udp|tcp|frag|mixed | -r capture [-t] | -c case] "
+                        "[-n count] [-w capture] [-s seed] [-a ip] [-p] [-d] [-q]\n", argv[0]);
+        return 1;
+    }
+
+    if ((pReplayPath != NULL) && (TST_pcapOpen(&capture, pReplayPath) != 0))
+    {
+        fprintf(stderr, "Cannot open capture %s\n", pReplayPath);
+        return 1;
+    }
+
+    if ((pRecordPath != NULL) && (TST_pcapCreate(&record, pRecordPath) != 0))
+    {
+        fprintf(stderr, "Cannot create capture %s\n", pRecordPath);
+        TST_pcapClose(&capture);
+        return 1;
+    }
+
+    if ((type != kTstTrafficNone) && (frameCnt == 0))
+        frameCnt = TST_FRAME_CNT_DEFAULT;
+
+    stb_edrvInit(TST_genStackFrame, fDirect);
+    TST_genInit(seed, aMac, aIp);
+
+    if (setupStack(aMac, aIp) != 0)
+    {
+        fprintf(stderr, "IP stack not ready\n");
+        ret = 1;
+        goto Exit;
+    }
+
+    timeNs  = (uint64_t)TST_STARTUP_CYCLES * TST_CYCLE_NS;
+    startNs = getTimeNs(CLOCK_MONOTONIC);
+
+    // A directed case runs its own frames and checks
+    if (pCaseName != NULL)
+    {
+        ret = TST_caseRun(pCaseName, hIp_l, timeNs);
+        if (ret == -2)
+        {
+            fprintf(stderr, "Unknown case %s\n", pCaseName);
+            ret = 1;
+            goto Exit;
+        }
+
+        measurement_l.wallNs = getTimeNs(CLOCK_MONOTONIC) - startNs;
+        ret = (ret != 0) ? 2 : 0;
+        goto Check;
+    }
+
+    // Main run, a replay ends with the capture if no count is given
+    for (i = 0; (frameCnt == 0) || (i < frameCnt); i++)
+    {
+        if (pReplayPath != NULL)
+        {
+            if (TST_pcapRead(&capture, &frame) != 1)
+                break;
+
+            // Keep the virtual time of the stack running with the capture
+            if (i == 0)
+                firstNs = frame.timeNs;
+            if (frame.timeNs < firstNs)
+                frame.timeNs = firstNs;
+            timeNs = (uint64_t)TST_STARTUP_CYCLES * TST_CYCLE_NS + (frame.timeNs - firstNs);
+
+            if (fTimed)
+                sleepUntil(startNs + (frame.timeNs - firstNs));
+        }
+        else
+        {
+            if (!TST_genNext(type, timeNs, &frame))
+                frame.len = 0;
+        }
+
+        if ((pRecordPath != NULL) && (frame.len != 0))
+        {
+            frame.timeNs = timeNs;
+            TST_pcapWrite(&record, &frame);
+        }
+
+        TST_runCycle(&frame, timeNs);
+
+        if (pReplayPath == NULL)
+            timeNs += TST_CYCLE_NS;
+    }
+
+    measurement_l.wallNs = getTimeNs(CLOCK_MONOTONIC) - startNs;
+
+    // Let the stack and the remote hosts finish outstanding answers
+    for (i = 0; i < TST_DRAIN_CYCLES; i++)
+    {
+        timeNs += TST_CYCLE_NS;
+
+        if ((pReplayPath != NULL) || !TST_genNext(kTstTrafficNone, timeNs, &frame))
+            frame.len = 0;
+
+        TST_runCycle(&frame, timeNs);
+    }
+
+Check:
+    printReport(pReplayPath == NULL);
+
+    if ((type != kTstTrafficNone) && (TST_genVerify(type) != 0))
+        ret = 2;
+
+    if (stb_edrvGetStatistics()->rxInUse != 0)
+    {
+        printf("FAIL: %u receive buffers not released by the stack\n",
+               stb_edrvGetStatistics()->rxInUse);
+        ret = 2;
+    }
+
+    if (fDirect && (stb_edrvGetStatistics()->rxDirect == 0))
+    {
+        printf("FAIL: no frame processed with ipPacketProcess()\n");
+        ret = 2;
+    }
+
+    if (stb_edrvGetStatistics()->rxModified != 0)
+    {
+        printf("FAIL: stack has written to %lu driver buffers in ipPacketProcess()\n",
+               stb_edrvGetStatistics()->rxModified);
+        ret = 2;
+    }
+
+Exit:
+    if (hIp_l != NULL)
+        ipDestroy(hIp_l);
+
+    TST_pcapClose(&capture);
+    TST_pcapClose(&record);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run one harness cycle
+
+The frame is passed to the stack, then the stack and the application are
+polled. Only the CPU time of the harness thread is measured, so the time of
+the generator, the file access and the high-water marks is not included. The
+stack buffers are sampled after the frame was passed and after the stack has
+run, the receive queue is only filled in between.
+
+\param[in] pFrame_p         Frame for the stack, no frame if the length is 0
+\param[in] timeNs_p         Virtual time of the cycle
+
+\return int
+\retval 0       The stack has taken the frame
+\retval -1      The frame was dropped
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_runCycle(const tTstFrame* pFrame_p, uint64_t timeNs_p)
+{
+    uint64_t    cpuNs = 0;
+    uint64_t    startNs;
+    int         ret = 0;
+
+    if (pFrame_p->len != 0)
+    {
+        startNs = getTimeNs(CLOCK_THREAD_CPUTIME_ID);
+        ret = stb_edrvReceive(hIp_l, pFrame_p->aData, pFrame_p->len);
+        cpuNs = getTimeNs(CLOCK_THREAD_CPUTIME_ID) - startNs;
+
+        measurement_l.frames++;
+        updateHighWater();
+    }
+
+    startNs = getTimeNs(CLOCK_THREAD_CPUTIME_ID);
+    ipPeriodic(hIp_l, (unsigned long)(timeNs_p / 1000000));
+    pollApplication();
+    cpuNs += getTimeNs(CLOCK_THREAD_CPUTIME_ID) - startNs;
+
+    updateHighWater();
+
+    measurement_l.cycles++;
+    measurement_l.cpuNs += cpuNs;
+    if ((pFrame_p->len != 0) && (cpuNs > measurement_l.maxCycleNs))
+        measurement_l.maxCycleNs = cpuNs;
+
+    return ret;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Start the IP stack and the application
+
+\param[in] pMac_p           MAC address of the stack
+\param[in] pIp_p            IP address of the stack
+
+\return int
+\retval 0       Stack is ready
+\retval -1      Stack could not be started
+*/
+//------------------------------------------------------------------------------
+static int setupStack(const uint8_t* pMac_p, const uint8_t* pIp_p)
+{
+    eth_addr            mac;
+    struct in_addr      ip;
+    struct in_addr      netmask;
+    unsigned long       i;
+#if IP_TCP_SOCKETS > 0
+    struct sockaddr_in  addr;
+#endif
+
+    memcpy(mac.addr, pMac_p, sizeof(mac.addr));
+
+    memset(&ip, 0, sizeof(ip));
+    memcpy(&ip.S_un.S_un_b, pIp_p, 4);
+
+    memset(&netmask, 0, sizeof(netmask));
+    netmask.S_un.S_un_b.s_b1 = 255;
+    netmask.S_un.S_un_b.s_b2 = 255;
+    netmask.S_un.S_un_b.s_b3 = 255;
+
+#if IP_TCP_SOCKETS > 0
+    ipPowerOn();
+#endif
+
+    hIp_l = ipInit(&mac, &ip, stb_edrvSend, NULL);
+    if (hIp_l == NULL)
+        return -1;
+
+    ipDisableInitArp(hIp_l);
+    ipSetNetmask(hIp_l, &netmask);
+
+    for (i = 0; i < TST_STARTUP_CYCLES; i++)
+    {
+        if (ipPeriodic(hIp_l, i * (TST_CYCLE_NS / 1000000)) == IP_STATE_OK)
+            break;
+    }
+
+    if (ipGetState(hIp_l) != IP_STATE_OK)
+        return -1;
+
+    if (ipUdpListen(hIp_l, TST_UDP_PORT, udpHook, NULL) != 0)
+        return -1;
+
+#if IP_TCP_SOCKETS > 0
+    for (i = 0; i < TST_TCP_PEER_CNT; i++)
+        aConn_l[i].sock = INVALID_SOCKET;
+
+    listenSock_l = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSock_l == INVALID_SOCKET)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(TST_TCP_PORT);
+
+    if ((bind(listenSock_l, (struct sockaddr*)&addr) != 0) ||
+        (listen(listenSock_l) != 0))
+        return -1;
+#endif
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    UDP hook of the harness port
+
+The datagram is echoed back to the sender. The echo is sent alternately with
+ipUdpSendv() (sequence number and data as separate segments) and by filling
+a buffer reserved with ipUdpReserve().
+
+\param[in] pArg_p           Argument of ipUdpListen() (unused)
+\param[in] pInfo_p          Received datagram
+*/
+//------------------------------------------------------------------------------
+static void udpHook(void* pArg_p, ip_udp_info* pInfo_p)
+{
+    static unsigned long    count = 0;
+    ip_udp_info             info = *pInfo_p;
+    ip_udp_seg              aSeg[2];
+    int                     ret;
+
+    (void)pArg_p;
+
+    TST_genUdpDelivered((const uint8_t*)pInfo_p->pData, pInfo_p->len);
+
+    // the sender is known, no ARP request for the echo
+    ipArpUpdate(hIp_l, pInfo_p->pRemoteMac, &pInfo_p->remoteHost);
+
+    if ((count++ & 1) == 0)
+    {
+        aSeg[0].pData = pInfo_p->pData;
+        aSeg[0].len   = 4;
+        aSeg[1].pData = (const uint8_t*)pInfo_p->pData + 4;
+        aSeg[1].len   = pInfo_p->len - 4;
+
+        ret = ipUdpSendv(hIp_l, &info, aSeg, 2);
+    }
+    else
+    {
+        info.pData = ipUdpReserve(hIp_l, pInfo_p->len);
+        if (info.pData == NULL)
+        {
+            ret = 0;
+        }
+        else
+        {
+            memcpy(info.pData, pInfo_p->pData, pInfo_p->len);
+
+            ret = ipUdpCommit(hIp_l, &info);
+            if (ret <= 0)
+                ipUdpRelease(hIp_l, info.pData);
+        }
+    }
+
+    if (ret != pInfo_p->len)
+        TST_genUdpEchoFailed();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Poll the TCP echo server
+
+New connections are accepted, received data is sent back on the same
+connection. A closed connection is released.
+*/
+//------------------------------------------------------------------------------
+static void pollApplication(void)
+{
+#if IP_TCP_SOCKETS > 0
+    tEchoConn*      pConn;
+    SOCKET          sock;
+    unsigned int    i;
+    int             len;
+
+    for (i = 0; i < TST_TCP_PEER_CNT; i++)
+    {
+        if (aConn_l[i].sock != INVALID_SOCKET)
+            continue;
+
+        sock = accept(listenSock_l, NULL, NULL);
+        if (sock == INVALID_SOCKET)
+            break;
+
+        aConn_l[i].sock = sock;
+        aConn_l[i].len  = 0;
+
+        if (fNoDelay_l)
+            setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)1, 0);
+    }
+
+    for (i = 0; i < TST_TCP_PEER_CNT; i++)
+    {
+        pConn = &aConn_l[i];
+        if (pConn->sock == INVALID_SOCKET)
+            continue;
+
+        len = recv(pConn->sock, pConn->aBuffer + pConn->len,
+                   (int)(sizeof(pConn->aBuffer) - pConn->len), 0);
+        if (len > 0)
+        {
+            pConn->len += (size_t)len;
+        }
+        else if ((len == SOCKET_ERROR) && (WSAGetLastError() != WSAEWOULDBLOCK))
+        {
+            closesocket(pConn->sock);
+            pConn->sock = INVALID_SOCKET;
+            continue;
+        }
+
+        if (pConn->len == 0)
+            continue;
+
+        len = send(pConn->sock, pConn->aBuffer, (long)pConn->len);
+        if (len > 0)
+        {
+            pConn->len -= (size_t)len;
+            memmove(pConn->aBuffer, pConn->aBuffer + len, pConn->len);
+        }
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Update the high-water marks of the stack buffers
+*/
+//------------------------------------------------------------------------------
+static void updateHighWater(void)
+{
+    ip_rx_queue_typ*    pEntry;
+    unsigned int        inUse = 0;
+    unsigned int        i;
+
+    for (i = 0; i < IP_TX_BUF_CNT; i++)
+    {
+        if (hIp_l->pTxBuffer[i].header.state != IP_BUF_STATE_IDLE)
+            inUse++;
+    }
+
+    if (inUse > measurement_l.txHighWater)
+        measurement_l.txHighWater = inUse;
+
+    inUse = 0;
+    for (pEntry = hIp_l->pRxRead; pEntry != hIp_l->pRxWrite; pEntry = pEntry->pNext)
+        inUse++;
+
+    if (inUse > measurement_l.rxQueueHighWater)
+        measurement_l.rxQueueHighWater = inUse;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read a clock
+
+\param[in] clock_p          Clock to read
+
+\return uint64_t
+\retval Time in ns
+*/
+//------------------------------------------------------------------------------
+static uint64_t getTimeNs(clockid_t clock_p)
+{
+    struct timespec ts;
+
+    clock_gettime(clock_p, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Wait until the monotonic clock reaches a time
+
+\param[in] timeNs_p         Time to wait for
+*/
+//------------------------------------------------------------------------------
+static void sleepUntil(uint64_t timeNs_p)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(timeNs_p / 1000000000ULL);
+    ts.tv_nsec = (long)(timeNs_p % 1000000000ULL);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+        ;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Convert the name of a traffic type
+
+\param[in]  pName_p         Name of the type
+\param[out] pType_p         Traffic type
+
+\return int
+\retval 0       Type is valid
+\retval -1      Unknown type
+*/
+//------------------------------------------------------------------------------
+static int parseType(const char* pName_p, tTstTrafficType* pType_p)
+{
+    static const char*  apName[] = {"arp", "icmp", "udp", "tcp", "frag", "mixed"};
+    unsigned int        i;
+
+    for (i = 0; i < sizeof(apName) / sizeof(apName[0]); i++)
+    {
+        if (strcmp(pName_p, apName[i]) == 0)
+        {
+            *pType_p = (tTstTrafficType)i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Convert an IP address in dotted notation
+
+\param[in]  pText_p         Address text
+\param[out] pIp_p           Address
+
+\return int
+\retval 0       Address is valid
+\retval -1      Invalid address
+*/
+//------------------------------------------------------------------------------
+static int parseIp(const char* pText_p, uint8_t* pIp_p)
+{
+    unsigned int    a[4];
+    unsigned int    i;
+
+    if (sscanf(pText_p, "%u.%u.%u.%u", &a[0], &a[1], &a[2], &a[3]) != 4)
+        return -1;
+
+    for (i = 0; i < 4; i++)
+    {
+        if (a[i] > 255)
+            return -1;
+        pIp_p[i] = (uint8_t)a[i];
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Print the result of the run
+
+\param[in] fGenerated_p     TRUE if the traffic was generated, the remote host
+                            statistics are printed in this case only
+*/
+//------------------------------------------------------------------------------
+static void printReport(int fGenerated_p)
+{
+    const tStbEdrvStatistics*   pEdrv = stb_edrvGetStatistics();
+    const tTstGenStatistics*    pGen = TST_genGetStatistics();
+    const ip_stat*              pStat = ipStats(hIp_l);
+    double                      frames = (measurement_l.frames != 0) ? measurement_l.frames : 1;
+    double                      virtualNs = (double)measurement_l.cycles * TST_CYCLE_NS;
+
+    printf("frames %lu, cycles %lu, wall %.3f ms, cpu %.3f ms\n",
+           measurement_l.frames, measurement_l.cycles,
+           measurement_l.wallNs / 1e6, measurement_l.cpuNs / 1e6);
+    printf("rate %.0f pps (cpu), %.0f pps (wall)\n",
+           (measurement_l.cpuNs != 0) ? frames * 1e9 / measurement_l.cpuNs : 0.0,
+           (measurement_l.wallNs != 0) ? frames * 1e9 / measurement_l.wallNs : 0.0);
+    printf("cpu per packet %.0f ns avg, %llu ns max\n",
+           measurement_l.cpuNs / frames, (unsigned long long)measurement_l.maxCycleNs);
+    printf("high water: rx buffers %u/%u, rx queue %u/%u, tx buffers %u/%u\n",
+           pEdrv->rxHighWater, STB_EDRV_RX_BUF_CNT,
+           measurement_l.rxQueueHighWater, IP_RX_BUF_CNT,
+           measurement_l.txHighWater, IP_TX_BUF_CNT);
+    printf("driver: rx %lu, direct %lu, no buffer %lu, rejected %lu, tx %lu (%lu bytes)\n",
+           pEdrv->rxFrames, pEdrv->rxDirect, pEdrv->rxNoBuffer, pEdrv->rxRejected,
+           pEdrv->txFrames, pEdrv->txBytes);
+
+    if (fQuiet_l)
+        return;
+
+    printf("stack: rx %lu, tx %lu, tx buffer full %lu, send overflow %lu\n",
+           pStat->rxPackets, pStat->txPackets, pStat->txBufferFull, pStat->ethSendOverflow);
+#if IP_STATISTICS == 1
+    printf("stack: arp req %lu, icmp rx %lu tx %lu, udp rx %lu unused %lu, "
+           "tcp rx %lu tx %lu retransmit %lu rst %lu\n",
+           pStat->arp_req_tx, pStat->icmp_rx, pStat->icmp_tx, pStat->udp_rx,
+           pStat->udp_unused, pStat->tcp_rx, pStat->tcp_tx, pStat->tcp_retransmit,
+           pStat->tcp_rst);
+    printf("stack: reassembled %lu, linearized %lu, dropped %lu, timeout %lu, late %lu\n",
+           pStat->ip_reass_ok, pStat->ip_reass_linear, pStat->ip_reass_drop,
+           pStat->ip_reass_timeout, pStat->ip_reass_late_rx);
+#endif
+
+    if (!fGenerated_p)
+        return;
+
+    printf("hosts: arp %lu/%lu, echo %lu/%lu, udp %lu/%lu echoed %lu/%lu "
+           "(%lu fragmented in %lu frames), arp answered %lu\n",
+           pGen->arpReplies, pGen->arpRequests, pGen->echoReplies, pGen->echoRequests,
+           pGen->udpDelivered, pGen->udpSent, pGen->udpEchoes,
+           pGen->udpDelivered - pGen->udpEchoFailed, pGen->udpFragmented,
+           pGen->udpFragments, pGen->arpAnswered);
+    printf("hosts: tcp connects %lu, segments %lu, retransmits %lu, "
+           "bytes %lu sent %lu echoed, resets %lu, invalid %lu\n",
+           pGen->tcpConnects, pGen->tcpSegments, pGen->tcpRetransmits,
+           pGen->tcpBytesSent, pGen->tcpBytesEchoed, pGen->tcpResets, pGen->invalidFrames);
+
+    if (pGen->tcpBytesEchoed == 0)
+        return;
+
+    printf("tcp goodput: %.1f kB/s (virtual), %.1f MB/s (cpu), %.1f payload bytes per stack segment\n",
+           pGen->tcpBytesEchoed * 1e6 / virtualNs,
+           (measurement_l.cpuNs != 0) ? pGen->tcpBytesEchoed * 1e3 / measurement_l.cpuNs : 0.0,
+           (pStat->tcp_tx != 0) ? (double)pGen->tcpBytesEchoed / pStat->tcp_tx : 0.0);
+#if IP_STATISTICS == 1
+    printf("tcp acks: delayed %lu, piggybacked %lu\n",
+           pStat->tcp_ack_delayed, pStat->tcp_ack_piggyback);
+#endif
+}
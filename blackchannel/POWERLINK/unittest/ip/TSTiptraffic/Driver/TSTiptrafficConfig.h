@@ -0,0 +1,159 @@
+/**
+********************************************************************************
+\file   TSTiptrafficConfig.h
+
+\brief  IP stack traffic harness configuration header
+
+The configuration header provides the types and function prototypes shared by
+the traffic harness modules.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <ip.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_FRAME_SIZE_MAX      (IP_MTU + 18)   ///< Ethernet frame with VLAN tag and CRC
+
+#define TST_PEER_CNT            8               ///< Number of simulated remote hosts
+#define TST_TCP_PEER_CNT        4               ///< Remote hosts with a TCP connection to the stack
+
+#define TST_UDP_PORT            5000            ///< UDP port the harness listens on
+#define TST_TCP_PORT            80              ///< TCP port of the echo server
+
+#define TST_CYCLE_NS            1000000         ///< Virtual time of one harness cycle
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Generated traffic type
+*/
+typedef enum
+{
+    kTstTrafficArp = 0,     ///< ARP requests for the stack address
+    kTstTrafficIcmp,        ///< ICMP echo requests
+    kTstTrafficUdp,         ///< UDP datagrams to the harness port
+    kTstTrafficTcp,         ///< TCP connections to the echo server
+    kTstTrafficFrag,        ///< Fragmented UDP datagrams, fragments out of order
+    kTstTrafficMixed,       ///< Weighted mix of all of the above
+    kTstTrafficNone,        ///< No new traffic, only answers and retransmissions
+} tTstTrafficType;
+
+/**
+\brief  Ethernet frame with time stamp
+*/
+typedef struct
+{
+    uint64_t    timeNs;                         ///< Time stamp of the frame
+    size_t      len;                            ///< Frame length
+    uint8_t     aData[TST_FRAME_SIZE_MAX];      ///< Frame data starting with the Ethernet header
+} tTstFrame;
+
+/**
+\brief  Capture file (pcap or pcapng)
+*/
+typedef struct
+{
+    FILE*       pFile;          ///< Open capture file
+    int         fNg;            ///< TRUE if the file is a pcapng file
+    int         fSwapped;       ///< TRUE if the file was written with the other byte order
+    uint64_t    tickRate;       ///< Time stamp ticks per second of a pcap file
+    uint64_t    aIfTickRate[8]; ///< Time stamp ticks per second of the pcapng interfaces (0: no Ethernet)
+    uint32_t    ifCount;        ///< Number of pcapng interfaces
+} tTstPcap;
+
+/**
+\brief  Traffic generator and remote host statistics
+*/
+typedef struct
+{
+    unsigned long   arpRequests;        ///< ARP requests sent to the stack
+    unsigned long   arpReplies;         ///< Valid ARP replies received from the stack
+    unsigned long   arpAnswered;        ///< ARP requests of the stack answered by a remote host
+    unsigned long   echoRequests;       ///< ICMP echo requests sent to the stack
+    unsigned long   echoReplies;        ///< Valid ICMP echo replies received from the stack
+    unsigned long   udpSent;            ///< UDP datagrams sent to the stack
+    unsigned long   udpDelivered;       ///< Valid UDP datagrams delivered to the harness port
+    unsigned long   udpEchoes;          ///< Valid UDP datagrams echoed back by the harness
+    unsigned long   udpEchoFailed;      ///< UDP datagrams the harness could not echo (no tx buffer)
+    unsigned long   udpFragmented;      ///< UDP datagrams sent in fragments
+    unsigned long   udpFragments;       ///< Fragments of these datagrams
+    unsigned long   tcpConnects;        ///< TCP connections established
+    unsigned long   tcpSegments;        ///< TCP data segments sent to the stack
+    unsigned long   tcpRetransmits;     ///< TCP segments retransmitted by the remote hosts
+    unsigned long   tcpBytesSent;       ///< TCP payload bytes acknowledged by the stack
+    unsigned long   tcpBytesEchoed;     ///< TCP payload bytes echoed back by the harness
+    unsigned long   tcpResets;          ///< TCP resets received from the stack
+    unsigned long   invalidFrames;      ///< Frames of the stack with bad checksum or content
+} tTstGenStatistics;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+int  TST_pcapOpen(tTstPcap* pPcap_p, const char* pPath_p);
+int  TST_pcapCreate(tTstPcap* pPcap_p, const char* pPath_p);
+int  TST_pcapRead(tTstPcap* pPcap_p, tTstFrame* pFrame_p);
+int  TST_pcapWrite(tTstPcap* pPcap_p, const tTstFrame* pFrame_p);
+void TST_pcapClose(tTstPcap* pPcap_p);
+
+void TST_genInit(unsigned int seed_p, const uint8_t* pStackMac_p,
+                 const uint8_t* pStackIp_p);
+int  TST_genNext(tTstTrafficType type_p, uint64_t timeNs_p, tTstFrame* pFrame_p);
+void TST_genStackFrame(const uint8_t* pData_p, size_t len_p);
+void TST_genUdpDelivered(const uint8_t* pData_p, size_t len_p);
+void TST_genUdpEchoFailed(void);
+int  TST_genVerify(tTstTrafficType type_p);
+const tTstGenStatistics* TST_genGetStatistics(void);
+int  TST_genDatagram(unsigned int peer_p, size_t len_p);
+int  TST_genFragment(int dgram_p, size_t offset_p, size_t len_p, uint64_t timeNs_p,
+                     tTstFrame* pFrame_p);
+
+int  TST_runCycle(const tTstFrame* pFrame_p, uint64_t timeNs_p);
+
+int  TST_caseRun(const char* pName_p, IP_STACK_H hIp_p, uint64_t timeNs_p);
@@ -0,0 +1,578 @@
+/**
+********************************************************************************
+\file   TSTpcap.c
+
+\brief  Capture file reader and writer of the IP stack traffic harness
+
+Reads Ethernet frames from pcap files (micro- and nanosecond resolution, both
+byte orders) and pcapng files (enhanced and simple packet blocks). Frames are
+written as pcap file with nanosecond resolution.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+
+#include <Driver/TSTiptrafficConfig.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define PCAP_MAGIC_US           0xA1B2C3D4
+#define PCAP_MAGIC_NS           0xA1B23C4D
+#define PCAP_LINKTYPE_ETHERNET  1
+
+#define PCAPNG_BLOCK_SHB        0x0A0D0D0A      ///< Section header block
+#define PCAPNG_BLOCK_IDB        0x00000001      ///< Interface description block
+#define PCAPNG_BLOCK_SPB        0x00000003      ///< Simple packet block
+#define PCAPNG_BLOCK_EPB        0x00000006      ///< Enhanced packet block
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define PCAPNG_OPT_IF_TSRESOL   9
+
+#define PCAPNG_BLOCK_SIZE_MAX   0x10000         ///< Larger blocks are skipped unread
+
+#define NSEC_PER_SEC            1000000000ULL
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static uint8_t aBlock_l[PCAPNG_BLOCK_SIZE_MAX];
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static uint32_t get32(const tTstPcap* pPcap_p, const uint8_t* pData_p);
+static uint16_t get16(const tTstPcap* pPcap_p, const uint8_t* pData_p);
+static uint64_t ticksToNs(uint64_t ticks_p, uint64_t tickRate_p);
+static int      readPcap(tTstPcap* pPcap_p, tTstFrame* pFrame_p);
+static int      readPcapng(tTstPcap* pPcap_p, tTstFrame* pFrame_p);
+static void     parseIdb(tTstPcap* pPcap_p, const uint8_t* pBody_p, uint32_t len_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Open a capture file for reading
+
+\param[out] pPcap_p         Capture file instance
+\param[in]  pPath_p         Path of a pcap or pcapng file
+
+\return int
+\retval 0       Success
+\retval -1      File not found or no Ethernet capture
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_pcapOpen(tTstPcap* pPcap_p, const char* pPath_p)
+{
+    uint8_t aHdr[24];
+
+    memset(pPcap_p, 0, sizeof(tTstPcap));
+
+    pPcap_p->pFile = fopen(pPath_p, "rb");
+    if (pPcap_p->pFile == NULL)
+        return -1;
+
+    if (fread(aHdr, 1, 4, pPcap_p->pFile) != 4)
+        goto Exit;
+
+    if (get32(pPcap_p, aHdr) == PCAPNG_BLOCK_SHB)
+    {
+        // Interfaces and byte order are taken from the blocks
+        pPcap_p->fNg = 1;
+        rewind(pPcap_p->pFile);
+        return 0;
+    }
+
+    if (fread(aHdr + 4, 1, sizeof(aHdr) - 4, pPcap_p->pFile) != sizeof(aHdr) - 4)
+        goto Exit;
+
+    switch (get32(pPcap_p, aHdr))
+    {
+        case PCAP_MAGIC_US:
+            pPcap_p->tickRate = 1000000;
+            break;
+
+        case PCAP_MAGIC_NS:
+            pPcap_p->tickRate = NSEC_PER_SEC;
+            break;
+
+        default:
+            pPcap_p->fSwapped = 1;
+            if (get32(pPcap_p, aHdr) == PCAP_MAGIC_US)
+                pPcap_p->tickRate = 1000000;
+            else if (get32(pPcap_p, aHdr) == PCAP_MAGIC_NS)
+                pPcap_p->tickRate = NSEC_PER_SEC;
+            else
+                goto Exit;
+            break;
+    }
+
+    if (get32(pPcap_p, aHdr + 20) == PCAP_LINKTYPE_ETHERNET)
+        return 0;
+
+Exit:
+    TST_pcapClose(pPcap_p);
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Create a pcap file
+
+\param[out] pPcap_p         Capture file instance
+\param[in]  pPath_p         Path of the file
+
+\return int
+\retval 0       Success
+\retval -1      File could not be created
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_pcapCreate(tTstPcap* pPcap_p, const char* pPath_p)
+{
+    uint32_t aHdr[6];
+
+    memset(pPcap_p, 0, sizeof(tTstPcap));
+
+    pPcap_p->pFile = fopen(pPath_p, "wb");
+    if (pPcap_p->pFile == NULL)
+        return -1;
+
+    // Native byte order, the reader detects it from the magic
+    aHdr[0] = PCAP_MAGIC_NS;
+    aHdr[1] = 2 | (4 << 16);        // version 2.4
+    aHdr[2] = 0;                    // time zone
+    aHdr[3] = 0;                    // time stamp accuracy
+    aHdr[4] = TST_FRAME_SIZE_MAX;   // snap length
+    aHdr[5] = PCAP_LINKTYPE_ETHERNET;
+
+    if (fwrite(aHdr, sizeof(aHdr), 1, pPcap_p->pFile) != 1)
+    {
+        TST_pcapClose(pPcap_p);
+        return -1;
+    }
+
+    pPcap_p->tickRate = NSEC_PER_SEC;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read the next Ethernet frame
+
+Frames larger than \ref TST_FRAME_SIZE_MAX and frames of non Ethernet
+interfaces are skipped.
+
+\param[in]  pPcap_p         Capture file instance
+\param[out] pFrame_p        Frame with time stamp
+
+\return int
+\retval 1       Frame read
+\retval 0       End of file
+\retval -1      File is corrupted
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_pcapRead(tTstPcap* pPcap_p, tTstFrame* pFrame_p)
+{
+    if (pPcap_p->fNg)
+        return readPcapng(pPcap_p, pFrame_p);
+
+    return readPcap(pPcap_p, pFrame_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Append a frame to a pcap file
+
+\param[in] pPcap_p          Capture file instance
+\param[in] pFrame_p         Frame with time stamp
+
+\return int
+\retval 0       Success
+\retval -1      Write error
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_pcapWrite(tTstPcap* pPcap_p, const tTstFrame* pFrame_p)
+{
+    uint32_t aHdr[4];
+
+    aHdr[0] = (uint32_t)(pFrame_p->timeNs / NSEC_PER_SEC);
+    aHdr[1] = (uint32_t)(pFrame_p->timeNs % NSEC_PER_SEC);
+    aHdr[2] = (uint32_t)pFrame_p->len;
+    aHdr[3] = (uint32_t)pFrame_p->len;
+
+    if ((fwrite(aHdr, sizeof(aHdr), 1, pPcap_p->pFile) != 1) ||
+        (fwrite(pFrame_p->aData, pFrame_p->len, 1, pPcap_p->pFile) != 1))
+        return -1;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Close a capture file
+
+\param[in] pPcap_p          Capture file instance
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void TST_pcapClose(tTstPcap* pPcap_p)
+{
+    if (pPcap_p->pFile != NULL)
+        fclose(pPcap_p->pFile);
+
+    pPcap_p->pFile = NULL;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read a 32 bit value in the byte order of the file
+
+\param[in] pPcap_p          Capture file instance
+\param[in] pData_p          Value in the file
+
+\return uint32_t
+\retval Value in host byte order
+*/
+//------------------------------------------------------------------------------
+static uint32_t get32(const tTstPcap* pPcap_p, const uint8_t* pData_p)
+{
+    uint32_t val;
+
+    memcpy(&val, pData_p, sizeof(val));
+
+    if (pPcap_p->fSwapped)
+    {
+        val = ((val & 0x000000FF) << 24) | ((val & 0x0000FF00) << 8) |
+              ((val & 0x00FF0000) >> 8)  | ((val & 0xFF000000) >> 24);
+    }
+
+    return val;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read a 16 bit value in the byte order of the file
+
+\param[in] pPcap_p          Capture file instance
+\param[in] pData_p          Value in the file
+
+\return uint16_t
+\retval Value in host byte order
+*/
+//------------------------------------------------------------------------------
+static uint16_t get16(const tTstPcap* pPcap_p, const uint8_t* pData_p)
+{
+    uint16_t val;
+
+    memcpy(&val, pData_p, sizeof(val));
+
+    if (pPcap_p->fSwapped)
+        val = (uint16_t)((val << 8) | (val >> 8));
+
+    return val;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Convert a time stamp to nanoseconds
+
+\param[in] ticks_p          Time stamp
+\param[in] tickRate_p       Time stamp ticks per second
+
+\return uint64_t
+\retval Time stamp in nanoseconds
+*/
+//------------------------------------------------------------------------------
+static uint64_t ticksToNs(uint64_t ticks_p, uint64_t tickRate_p)
+{
+    return (ticks_p / tickRate_p) * NSEC_PER_SEC +
+           (uint64_t)(((long double)(ticks_p % tickRate_p) * NSEC_PER_SEC) / tickRate_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read the next frame of a pcap file
+
+\param[in]  pPcap_p         Capture file instance
+\param[out] pFrame_p        Frame with time stamp
+
+\return int
+\retval 1       Frame read
+\retval 0       End of file
+\retval -1      File is corrupted
+*/
+//------------------------------------------------------------------------------
+static int readPcap(tTstPcap* pPcap_p, tTstFrame* pFrame_p)
+{
+    uint8_t     aHdr[16];
+    uint32_t    capLen;
+
+    for (;;)
+    {
+        if (fread(aHdr, 1, sizeof(aHdr), pPcap_p->pFile) != sizeof(aHdr))
+            return 0;
+
+        capLen = get32(pPcap_p, aHdr + 8);
+
+        if (capLen > TST_FRAME_SIZE_MAX)
+        {
+            if (fseek(pPcap_p->pFile, capLen, SEEK_CUR) != 0)
+                return -1;
+            continue;
+        }
+
+        if (fread(pFrame_p->aData, 1, capLen, pPcap_p->pFile) != capLen)
+            return -1;
+
+        pFrame_p->len    = capLen;
+        pFrame_p->timeNs = ticksToNs((uint64_t)get32(pPcap_p, aHdr) * pPcap_p->tickRate +
+                                     get32(pPcap_p, aHdr + 4), pPcap_p->tickRate);
+        return 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read the next frame of a pcapng file
+
+\param[in]  pPcap_p         Capture file instance
+\param[out] pFrame_p        Frame with time stamp
+
+\return int
+\retval 1       Frame read
+\retval 0       End of file
+\retval -1      File is corrupted
+*/
+//------------------------------------------------------------------------------
+static int readPcapng(tTstPcap* pPcap_p, tTstFrame* pFrame_p)
+{
+    uint8_t     aHdr[8];
+    uint32_t    type;
+    uint32_t    len;
+    uint32_t    capLen;
+    uint32_t    ifId;
+    uint64_t    ticks;
+
+    for (;;)
+    {
+        if (fread(aHdr, 1, sizeof(aHdr), pPcap_p->pFile) != sizeof(aHdr))
+            return 0;
+
+        type = get32(pPcap_p, aHdr);
+
+        if (type == PCAPNG_BLOCK_SHB)
+        {
+            // A new section may change the byte order, interfaces start again
+            uint8_t aMagic[4];
+
+            if (fread(aMagic, 1, sizeof(aMagic), pPcap_p->pFile) != sizeof(aMagic))
+                return -1;
+
+            pPcap_p->fSwapped = 0;
+            if (get32(pPcap_p, aMagic) != PCAPNG_BYTE_ORDER_MAGIC)
+                pPcap_p->fSwapped = 1;
+            if (get32(pPcap_p, aMagic) != PCAPNG_BYTE_ORDER_MAGIC)
+                return -1;
+
+            pPcap_p->ifCount = 0;
+
+            len = get32(pPcap_p, aHdr + 4);
+            if ((len < 12 + sizeof(aMagic)) ||
+                (fseek(pPcap_p->pFile, len - 12 - sizeof(aMagic), SEEK_CUR) != 0) ||
+                (fread(aHdr, 1, 4, pPcap_p->pFile) != 4))
+                return -1;
+            continue;
+        }
+
+        len = get32(pPcap_p, aHdr + 4);
+        if ((len < 12) || ((len & 3) != 0))
+            return -1;
+
+        if (len - 8 > sizeof(aBlock_l))
+        {
+            if (fseek(pPcap_p->pFile, len - 8, SEEK_CUR) != 0)
+                return -1;
+            continue;
+        }
+
+        // Block body and trailing length
+        if (fread(aBlock_l, 1, len - 8, pPcap_p->pFile) != len - 8)
+            return -1;
+
+        len -= 12;
+
+        switch (type)
+        {
+            case PCAPNG_BLOCK_IDB:
+                parseIdb(pPcap_p, aBlock_l, len);
+                break;
+
+            case PCAPNG_BLOCK_EPB:
+                if (len < 20)
+                    return -1;
+
+                ifId   = get32(pPcap_p, aBlock_l);
+                capLen = get32(pPcap_p, aBlock_l + 12);
+
+                if ((ifId >= pPcap_p->ifCount) || (pPcap_p->aIfTickRate[ifId] == 0) ||
+                    (capLen > TST_FRAME_SIZE_MAX) || (capLen > len - 20))
+                    break;
+
+                ticks = ((uint64_t)get32(pPcap_p, aBlock_l + 4) << 32) |
+                        get32(pPcap_p, aBlock_l + 8);
+
+                memcpy(pFrame_p->aData, aBlock_l + 20, capLen);
+                pFrame_p->len    = capLen;
+                pFrame_p->timeNs = ticksToNs(ticks, pPcap_p->aIfTickRate[ifId]);
+                return 1;
+
+            case PCAPNG_BLOCK_SPB:
+                // No time stamp, the frame keeps the time of the previous one
+                if ((len < 4) || (pPcap_p->ifCount == 0) || (pPcap_p->aIfTickRate[0] == 0))
+                    break;
+
+                capLen = get32(pPcap_p, aBlock_l);
+                if ((capLen > TST_FRAME_SIZE_MAX) || (capLen > len - 4))
+                    break;
+
+                memcpy(pFrame_p->aData, aBlock_l + 4, capLen);
+                pFrame_p->len = capLen;
+                return 1;
+
+            default:
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Register a pcapng interface
+
+\param[in] pPcap_p          Capture file instance
+\param[in] pBody_p          Body of the interface description block
+\param[in] len_p            Length of the body
+*/
+//------------------------------------------------------------------------------
+static void parseIdb(tTstPcap* pPcap_p, const uint8_t* pBody_p, uint32_t len_p)
+{
+    uint64_t    tickRate = 1000000;
+    uint32_t    pos = 8;
+    uint16_t    code;
+    uint16_t    optLen;
+    uint8_t     resol;
+
+    if ((len_p < 8) || (pPcap_p->ifCount >= sizeof(pPcap_p->aIfTickRate) / sizeof(uint64_t)))
+        return;
+
+    while (pos + 4 <= len_p)
+    {
+        code   = get16(pPcap_p, pBody_p + pos);
+        optLen = get16(pPcap_p, pBody_p + pos + 2);
+
+        if ((code == 0) || (pos + 4 + optLen > len_p))
+            break;
+
+        if ((code == PCAPNG_OPT_IF_TSRESOL) && (optLen >= 1))
+        {
+            resol = pBody_p[pos + 4];
+
+            // Power of 10 or power of 2 (MSB set) fractions of a second
+            tickRate = 1;
+            if (resol & 0x80)
+            {
+                if ((resol & 0x7F) < 64)
+                    tickRate = 1ULL << (resol & 0x7F);
+            }
+            else
+            {
+                while ((resol-- > 0) && (tickRate <= UINT64_MAX / 10))
+                    tickRate *= 10;
+            }
+        }
+
+        pos += 4 + ((optLen + 3) & ~3U);
+    }
+
+    // Frames of other link types are skipped
+    if (get16(pPcap_p, pBody_p) != PCAP_LINKTYPE_ETHERNET)
+        tickRate = 0;
+
+    pPcap_p->aIfTickRate[pPcap_p->ifCount++] = tickRate;
+}
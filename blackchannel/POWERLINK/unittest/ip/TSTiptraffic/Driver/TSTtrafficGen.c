@@ -0,0 +1,1425 @@
+/**
+********************************************************************************
+\file   TSTtrafficGen.c
+
+\brief  Synthetic traffic generator of the IP stack traffic harness
+
+The generator simulates a number of remote hosts on the subnet of the stack.
+The hosts send ARP requests, ICMP echo requests, UDP datagrams and TCP data to
+the stack. Every frame sent by the stack is checked by the addressed host: ARP
+and echo replies are counted, TCP segments are acknowledged and the echoed data
+is compared with the data that was sent. Answers of the hosts are queued and
+passed to the stack before new traffic is generated.
+
+All data is derived from a seed, so a run with the same parameters produces
+the same frames.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+
+#include <Driver/TSTiptrafficConfig.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define ETH_HDR_SIZE            14
+#define ETH_FRAME_SIZE_MIN      60
+#define ETH_TYPE_IP             0x0800
+#define ETH_TYPE_ARP            0x0806
+#define ETH_TYPE_VLAN           0x8100
+
+#define IP_HDR_SIZE             20
+#define IP_PROTO_ICMP           1
+#define IP_PROTO_TCP            6
+#define IP_PROTO_UDP            17
+
+#define ICMP_ECHO_REPLY         0
+#define ICMP_ECHO_REQUEST       8
+#define ICMP_ECHO_DATA_SIZE     56
+
+#define UDP_PAYLOAD_SIZE_MAX    1024
+#define UDP_SRC_PORT            6000
+#define UDP_HDR_SIZE            8
+
+#define FRAG_CNT_MAX            4               ///< Fragments of a generated datagram
+#define FRAG_FLAG_MORE          0x2000
+
+#define TCP_HDR_SIZE            20
+#define TCP_FLAG_FIN            0x01
+#define TCP_FLAG_SYN            0x02
+#define TCP_FLAG_RST            0x04
+#define TCP_FLAG_PSH            0x08
+#define TCP_FLAG_ACK            0x10
+#define TCP_SEGMENT_SIZE_MAX    512             ///< Payload of the data segments of the hosts
+#define TCP_UNECHOED_MAX        1024            ///< Data not yet echoed before a host stops sending
+#define TCP_WINDOW              4096
+#define TCP_RTO_NS              200000000ULL    ///< Retransmission timeout of the hosts
+#define TCP_SRC_PORT            20000
+
+#define PENDING_CNT             32              ///< Answers of the hosts waiting to be sent
+#define DGRAM_CNT               8               ///< Datagrams of the directed fragment cases
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  TCP state of a remote host
+*/
+typedef enum
+{
+    kTcpClosed = 0,
+    kTcpSynSent,
+    kTcpEstablished,
+} tTcpState;
+
+/**
+\brief  Simulated remote host
+*/
+typedef struct
+{
+    uint8_t     aMac[6];
+    uint8_t     aIp[4];
+    tTcpState   tcpState;
+    uint16_t    tcpPort;        ///< Local port of the current connection
+    uint32_t    iss;            ///< Initial send sequence number
+    uint32_t    sndUna;         ///< Oldest unacknowledged sequence number
+    uint32_t    sndNxt;         ///< Next sequence number to send
+    uint32_t    rcvNxt;         ///< Next sequence number expected from the stack
+    uint64_t    echoOffset;     ///< Stream offset of the next echoed byte
+    uint64_t    lastTxNs;       ///< Time of the last SYN or data segment
+} tPeer;
+
+/**
+\brief  Datagram of the directed fragment cases
+*/
+typedef struct
+{
+    unsigned int    peer;           ///< Index of the sending host
+    uint16_t        ipId;           ///< IP identification of the fragments
+    uint32_t        seq;            ///< UDP sequence number, defines the payload
+    size_t          len;            ///< UDP payload length
+} tDatagram;
+
+/**
+\brief  Generator instance
+*/
+typedef struct
+{
+    uint32_t            random;
+    uint8_t             aStackMac[6];
+    uint8_t             aStackIp[4];
+    tPeer               aPeer[TST_PEER_CNT];
+    tTstFrame           aPending[PENDING_CNT];
+    unsigned int        pendingRead;
+    unsigned int        pendingCount;
+    uint16_t            echoSeq;
+    uint32_t            udpSeq;
+    uint16_t            ipId;
+    uint8_t             aDatagram[IP_MTU];      ///< UDP datagram which is sent in fragments
+    tDatagram           aDgram[DGRAM_CNT];
+    unsigned int        dgramCount;
+    tTstGenStatistics   statistics;
+} tTrafficGen;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tTrafficGen gen_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static uint32_t     nextRandom(void);
+static uint8_t      pattern(uint64_t offset_p, unsigned int seed_p);
+static uint16_t     get16(const uint8_t* pData_p);
+static uint32_t     get32(const uint8_t* pData_p);
+static void         put16(uint8_t* pData_p, uint16_t val_p);
+static void         put32(uint8_t* pData_p, uint32_t val_p);
+static uint32_t     sum(const uint8_t* pData_p, size_t len_p, uint32_t sum_p);
+static uint16_t     fold(uint32_t sum_p);
+static uint32_t     pseudoSum(const uint8_t* pIpHdr_p, uint8_t proto_p, size_t len_p);
+static uint8_t*     buildIp(tTstFrame* pFrame_p, const tPeer* pPeer_p, uint8_t proto_p,
+                            size_t payloadLen_p);
+static void         buildArp(tTstFrame* pFrame_p, const tPeer* pPeer_p, uint16_t opcode_p,
+                             const uint8_t* pTargetMac_p, const uint8_t* pTargetIp_p);
+static void         buildTcp(tTstFrame* pFrame_p, tPeer* pPeer_p, uint32_t seq_p,
+                             uint8_t flags_p, size_t dataLen_p);
+static void         fillUdp(uint8_t* pUdp_p, size_t len_p, uint32_t seq_p,
+                            const uint8_t* pIpHdr_p);
+static tTstFrame*   allocPending(void);
+static int          popPending(uint64_t timeNs_p, tTstFrame* pFrame_p);
+static size_t       buildDatagram(const tPeer* pPeer_p, size_t len_p, uint32_t seq_p);
+static void         buildFragment(tTstFrame* pFrame_p, const tPeer* pPeer_p, uint16_t ipId_p,
+                                  size_t udpLen_p, size_t offset_p, size_t len_p);
+static void         genFragmented(const tPeer* pPeer_p);
+static int          genTcp(uint64_t timeNs_p, tTstFrame* pFrame_p, int fNewData_p);
+static tPeer*       findPeer(const uint8_t* pIp_p);
+static void         stackArp(const uint8_t* pArp_p, size_t len_p);
+static void         stackIcmp(const uint8_t* pIpHdr_p, size_t len_p);
+static void         stackUdp(const uint8_t* pIpHdr_p, size_t len_p);
+static void         stackTcp(tPeer* pPeer_p, const uint8_t* pIpHdr_p, size_t len_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Initialize the traffic generator
+
+\param[in] seed_p           Seed of the generated data
+\param[in] pStackMac_p      MAC address of the stack
+\param[in] pStackIp_p       IP address of the stack (the hosts use its /24 subnet)
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void TST_genInit(unsigned int seed_p, const uint8_t* pStackMac_p,
+                 const uint8_t* pStackIp_p)
+{
+    unsigned int i;
+
+    memset(&gen_l, 0, sizeof(gen_l));
+
+    gen_l.random = seed_p | 1;
+    memcpy(gen_l.aStackMac, pStackMac_p, sizeof(gen_l.aStackMac));
+    memcpy(gen_l.aStackIp, pStackIp_p, sizeof(gen_l.aStackIp));
+
+    for (i = 0; i < TST_PEER_CNT; i++)
+    {
+        tPeer* pPeer = &gen_l.aPeer[i];
+
+        pPeer->aMac[0] = 0x02;
+        pPeer->aMac[5] = (uint8_t)(i + 1);
+
+        memcpy(pPeer->aIp, pStackIp_p, 3);
+        pPeer->aIp[3] = (uint8_t)(pStackIp_p[3] + 100 + i);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the next frame for the stack
+
+Queued answers of the hosts are returned first, then new traffic of the
+requested type is generated.
+
+\param[in]  type_p          Type of the new traffic
+\param[in]  timeNs_p        Current time
+\param[out] pFrame_p        Frame for the stack
+
+\return int
+\retval 1       Frame returned
+\retval 0       Nothing to send in this cycle
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_genNext(tTstTrafficType type_p, uint64_t timeNs_p, tTstFrame* pFrame_p)
+{
+    tPeer*          pPeer;
+    uint8_t*        pData;
+    size_t          len;
+    unsigned int    i;
+
+    if (gen_l.pendingCount > 0)
+        return popPending(timeNs_p, pFrame_p);
+
+    pFrame_p->timeNs = timeNs_p;
+
+    if (type_p == kTstTrafficMixed)
+    {
+        i = nextRandom() % 10;
+        if (i < 1)
+            type_p = kTstTrafficArp;
+        else if (i < 3)
+            type_p = kTstTrafficIcmp;
+        else if (i < 6)
+            type_p = kTstTrafficUdp;
+        else if (i < 7)
+            type_p = kTstTrafficFrag;
+        else
+            type_p = kTstTrafficTcp;
+    }
+
+    pPeer = &gen_l.aPeer[nextRandom() % TST_PEER_CNT];
+
+    switch (type_p)
+    {
+        case kTstTrafficArp:
+            buildArp(pFrame_p, pPeer, 1, NULL, gen_l.aStackIp);
+            gen_l.statistics.arpRequests++;
+            return 1;
+
+        case kTstTrafficIcmp:
+            pData = buildIp(pFrame_p, pPeer, IP_PROTO_ICMP, 8 + ICMP_ECHO_DATA_SIZE);
+
+            gen_l.echoSeq++;
+            pData[0] = ICMP_ECHO_REQUEST;
+            pData[1] = 0;
+            put16(pData + 2, 0);
+            put16(pData + 4, (uint16_t)(pPeer - gen_l.aPeer));
+            put16(pData + 6, gen_l.echoSeq);
+            for (i = 0; i < ICMP_ECHO_DATA_SIZE; i++)
+                pData[8 + i] = pattern(i, gen_l.echoSeq);
+            put16(pData + 2, fold(sum(pData, 8 + ICMP_ECHO_DATA_SIZE, 0)));
+
+            gen_l.statistics.echoRequests++;
+            return 1;
+
+        case kTstTrafficUdp:
+            len = 4 + nextRandom() % (UDP_PAYLOAD_SIZE_MAX - 3);
+            pData = buildIp(pFrame_p, pPeer, IP_PROTO_UDP, UDP_HDR_SIZE + len);
+            fillUdp(pData, len, ++gen_l.udpSeq, pData - IP_HDR_SIZE);
+
+            gen_l.statistics.udpSent++;
+            return 1;
+
+        case kTstTrafficTcp:
+            return genTcp(timeNs_p, pFrame_p, 1);
+
+        case kTstTrafficFrag:
+            genFragmented(pPeer);
+            return popPending(timeNs_p, pFrame_p);
+
+        default:
+            return genTcp(timeNs_p, pFrame_p, 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Create a UDP datagram for the directed fragment cases
+
+The datagram is only registered, its fragments are built with
+TST_genFragment() in the order and layout of the case.
+
+\param[in] peer_p           Index of the sending host
+\param[in] len_p            UDP payload length (at least 4)
+
+\return int
+\retval >=0     Index of the datagram
+\retval -1      Invalid parameters or no datagram left
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_genDatagram(unsigned int peer_p, size_t len_p)
+{
+    tDatagram* pDgram;
+
+    if ((peer_p >= TST_PEER_CNT) || (len_p < 4) ||
+        (UDP_HDR_SIZE + len_p > IP_MTU - IP_HDR_SIZE) || (gen_l.dgramCount >= DGRAM_CNT))
+        return -1;
+
+    pDgram = &gen_l.aDgram[gen_l.dgramCount];
+    pDgram->peer = peer_p;
+    pDgram->ipId = ++gen_l.ipId;
+    pDgram->seq  = ++gen_l.udpSeq;
+    pDgram->len  = len_p;
+
+    gen_l.statistics.udpSent++;
+    gen_l.statistics.udpFragmented++;
+
+    return (int)gen_l.dgramCount++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build a fragment of a datagram of the directed fragment cases
+
+Offset and length refer to the UDP datagram (header and payload), so fragments
+may overlap, leave gaps or repeat each other.
+
+\param[in]  dgram_p         Index of the datagram (see TST_genDatagram())
+\param[in]  offset_p        Offset of the fragment (multiple of 8)
+\param[in]  len_p           Length of the fragment
+\param[in]  timeNs_p        Time stamp of the frame
+\param[out] pFrame_p        Frame for the stack
+
+\return int
+\retval 0       Fragment built
+\retval -1      Invalid parameters
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_genFragment(int dgram_p, size_t offset_p, size_t len_p, uint64_t timeNs_p,
+                    tTstFrame* pFrame_p)
+{
+    const tDatagram*    pDgram;
+    const tPeer*        pPeer;
+    size_t              udpLen;
+
+    if ((dgram_p < 0) || ((unsigned int)dgram_p >= gen_l.dgramCount))
+        return -1;
+
+    pDgram = &gen_l.aDgram[dgram_p];
+    if (((offset_p & 7) != 0) || (len_p == 0) || (offset_p + len_p > UDP_HDR_SIZE + pDgram->len))
+        return -1;
+
+    pPeer  = &gen_l.aPeer[pDgram->peer];
+    udpLen = buildDatagram(pPeer, pDgram->len, pDgram->seq);
+    buildFragment(pFrame_p, pPeer, pDgram->ipId, udpLen, offset_p, len_p);
+    pFrame_p->timeNs = timeNs_p;
+
+    gen_l.statistics.udpFragments++;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Pass a frame sent by the stack to the remote hosts
+
+\param[in] pData_p          Frame data starting with the Ethernet header
+\param[in] len_p            Frame length
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void TST_genStackFrame(const uint8_t* pData_p, size_t len_p)
+{
+    const uint8_t*  pIpHdr;
+    size_t          hdrLen;
+    size_t          ipLen;
+    uint16_t        type;
+    tPeer*          pPeer;
+
+    if (len_p < ETH_HDR_SIZE)
+        return;
+
+    hdrLen = ETH_HDR_SIZE;
+    type   = get16(pData_p + 12);
+    if ((type == ETH_TYPE_VLAN) && (len_p >= ETH_HDR_SIZE + 4))
+    {
+        hdrLen += 4;
+        type = get16(pData_p + 16);
+    }
+
+    if (type == ETH_TYPE_ARP)
+    {
+        stackArp(pData_p + hdrLen, len_p - hdrLen);
+        return;
+    }
+
+    if (type != ETH_TYPE_IP)
+        return;
+
+    pIpHdr = pData_p + hdrLen;
+    if ((len_p < hdrLen + IP_HDR_SIZE) || (pIpHdr[0] != 0x45) ||
+        (fold(sum(pIpHdr, IP_HDR_SIZE, 0)) != 0))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    ipLen = get16(pIpHdr + 2);
+    if ((ipLen < IP_HDR_SIZE) || (hdrLen + ipLen > len_p))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    pPeer = findPeer(pIpHdr + 16);
+    if (pPeer == NULL)
+        return;             // broadcast or other host
+
+    switch (pIpHdr[9])
+    {
+        case IP_PROTO_ICMP:
+            stackIcmp(pIpHdr, ipLen);
+            break;
+
+        case IP_PROTO_UDP:
+            stackUdp(pIpHdr, ipLen);
+            break;
+
+        case IP_PROTO_TCP:
+            stackTcp(pPeer, pIpHdr, ipLen);
+            break;
+
+        default:
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check a datagram delivered to the harness UDP port
+
+\param[in] pData_p          UDP payload
+\param[in] len_p            Payload length
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void TST_genUdpDelivered(const uint8_t* pData_p, size_t len_p)
+{
+    uint32_t    seq;
+    size_t      i;
+
+    if (len_p < 4)
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    seq = get32(pData_p);
+    for (i = 4; i < len_p; i++)
+    {
+        if (pData_p[i] != pattern(i, seq))
+        {
+            gen_l.statistics.invalidFrames++;
+            return;
+        }
+    }
+
+    gen_l.statistics.udpDelivered++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Count a datagram the harness could not echo
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void TST_genUdpEchoFailed(void)
+{
+    gen_l.statistics.udpEchoFailed++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check that the stack has answered all generated traffic
+
+\param[in] type_p           Type of the generated traffic
+
+\return int
+\retval 0       All traffic was answered correctly
+\retval -1      Answers are missing or invalid
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int TST_genVerify(tTstTrafficType type_p)
+{
+    const tTstGenStatistics*    pStat = &gen_l.statistics;
+    int                         ret = 0;
+
+    if (pStat->invalidFrames != 0)
+    {
+        printf("FAIL: %lu invalid frames from the stack\n", pStat->invalidFrames);
+        ret = -1;
+    }
+
+    if (pStat->arpReplies != pStat->arpRequests)
+    {
+        printf("FAIL: %lu of %lu ARP requests answered\n",
+               pStat->arpReplies, pStat->arpRequests);
+        ret = -1;
+    }
+
+    if (pStat->echoReplies != pStat->echoRequests)
+    {
+        printf("FAIL: %lu of %lu echo requests answered\n",
+               pStat->echoReplies, pStat->echoRequests);
+        ret = -1;
+    }
+
+    if (pStat->udpDelivered != pStat->udpSent)
+    {
+        printf("FAIL: %lu of %lu UDP datagrams delivered\n",
+               pStat->udpDelivered, pStat->udpSent);
+        ret = -1;
+    }
+
+    if (pStat->udpEchoes + pStat->udpEchoFailed != pStat->udpDelivered)
+    {
+        printf("FAIL: %lu of %lu UDP datagrams echoed, %lu not sent\n",
+               pStat->udpEchoes, pStat->udpDelivered, pStat->udpEchoFailed);
+        ret = -1;
+    }
+
+    if (pStat->tcpResets != 0)
+    {
+        printf("FAIL: %lu TCP connections reset by the stack\n", pStat->tcpResets);
+        ret = -1;
+    }
+
+    if (pStat->tcpBytesEchoed != pStat->tcpBytesSent)
+    {
+        printf("FAIL: %lu of %lu TCP bytes echoed\n",
+               pStat->tcpBytesEchoed, pStat->tcpBytesSent);
+        ret = -1;
+    }
+
+    if (((type_p == kTstTrafficTcp) || (type_p == kTstTrafficMixed)) &&
+        ((pStat->tcpConnects < TST_TCP_PEER_CNT) || (pStat->tcpBytesEchoed == 0)))
+    {
+        printf("FAIL: %lu TCP connections, %lu bytes echoed\n",
+               pStat->tcpConnects, pStat->tcpBytesEchoed);
+        ret = -1;
+    }
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the generator statistics
+
+\return const tTstGenStatistics*
+\retval Pointer to the statistics
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+const tTstGenStatistics* TST_genGetStatistics(void)
+{
+    return &gen_l.statistics;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the next pseudo random number (xorshift)
+
+\return uint32_t
+\retval Random number
+*/
+//------------------------------------------------------------------------------
+static uint32_t nextRandom(void)
+{
+    gen_l.random ^= gen_l.random << 13;
+    gen_l.random ^= gen_l.random >> 17;
+    gen_l.random ^= gen_l.random << 5;
+
+    return gen_l.random;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get a byte of generated payload
+
+\param[in] offset_p         Offset in the payload
+\param[in] seed_p           Sequence number or host of the payload
+
+\return uint8_t
+\retval Payload byte
+*/
+//------------------------------------------------------------------------------
+static uint8_t pattern(uint64_t offset_p, unsigned int seed_p)
+{
+    return (uint8_t)(offset_p * 13 + seed_p * 7 + 1);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read and write big endian values
+
+\param[in] pData_p          Address of the value
+\param[in] val_p            Value to write
+*/
+//------------------------------------------------------------------------------
+static uint16_t get16(const uint8_t* pData_p)
+{
+    return (uint16_t)((pData_p[0] << 8) | pData_p[1]);
+}
+
+static uint32_t get32(const uint8_t* pData_p)
+{
+    return ((uint32_t)get16(pData_p) << 16) | get16(pData_p + 2);
+}
+
+static void put16(uint8_t* pData_p, uint16_t val_p)
+{
+    pData_p[0] = (uint8_t)(val_p >> 8);
+    pData_p[1] = (uint8_t)val_p;
+}
+
+static void put32(uint8_t* pData_p, uint32_t val_p)
+{
+    put16(pData_p, (uint16_t)(val_p >> 16));
+    put16(pData_p + 2, (uint16_t)val_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Add data to an Internet checksum
+
+\param[in] pData_p          Data
+\param[in] len_p            Length of the data
+\param[in] sum_p            Checksum of the previous data
+
+\return uint32_t
+\retval Unfolded checksum
+*/
+//------------------------------------------------------------------------------
+static uint32_t sum(const uint8_t* pData_p, size_t len_p, uint32_t sum_p)
+{
+    size_t i;
+
+    for (i = 0; i + 1 < len_p; i += 2)
+        sum_p += get16(pData_p + i);
+
+    if (len_p & 1)
+        sum_p += (uint32_t)pData_p[len_p - 1] << 8;
+
+    return sum_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Fold and complement an Internet checksum
+
+\param[in] sum_p            Unfolded checksum
+
+\return uint16_t
+\retval Checksum
+*/
+//------------------------------------------------------------------------------
+static uint16_t fold(uint32_t sum_p)
+{
+    while (sum_p >> 16)
+        sum_p = (sum_p & 0xFFFF) + (sum_p >> 16);
+
+    return (uint16_t)~sum_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Checksum of the UDP and TCP pseudo header
+
+\param[in] pIpHdr_p         IP header with source and destination address
+\param[in] proto_p          Protocol
+\param[in] len_p            UDP or TCP length
+
+\return uint32_t
+\retval Unfolded checksum
+*/
+//------------------------------------------------------------------------------
+static uint32_t pseudoSum(const uint8_t* pIpHdr_p, uint8_t proto_p, size_t len_p)
+{
+    return sum(pIpHdr_p + 12, 8, 0) + proto_p + (uint32_t)len_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build Ethernet and IP header of a frame from a host to the stack
+
+\param[out] pFrame_p        Frame
+\param[in]  pPeer_p         Sending host
+\param[in]  proto_p         IP protocol
+\param[in]  payloadLen_p    Length of the IP payload
+
+\return uint8_t*
+\retval Address of the IP payload
+*/
+//------------------------------------------------------------------------------
+static uint8_t* buildIp(tTstFrame* pFrame_p, const tPeer* pPeer_p, uint8_t proto_p,
+                        size_t payloadLen_p)
+{
+    uint8_t* pIpHdr = pFrame_p->aData + ETH_HDR_SIZE;
+
+    memset(pFrame_p->aData, 0, ETH_FRAME_SIZE_MIN);
+
+    memcpy(pFrame_p->aData, gen_l.aStackMac, 6);
+    memcpy(pFrame_p->aData + 6, pPeer_p->aMac, 6);
+    put16(pFrame_p->aData + 12, ETH_TYPE_IP);
+
+    pIpHdr[0] = 0x45;
+    pIpHdr[1] = 0;
+    put16(pIpHdr + 2, (uint16_t)(IP_HDR_SIZE + payloadLen_p));
+    put16(pIpHdr + 4, ++gen_l.ipId);
+    put16(pIpHdr + 6, 0);
+    pIpHdr[8] = 64;
+    pIpHdr[9] = proto_p;
+    put16(pIpHdr + 10, 0);
+    memcpy(pIpHdr + 12, pPeer_p->aIp, 4);
+    memcpy(pIpHdr + 16, gen_l.aStackIp, 4);
+    put16(pIpHdr + 10, fold(sum(pIpHdr, IP_HDR_SIZE, 0)));
+
+    pFrame_p->len = ETH_HDR_SIZE + IP_HDR_SIZE + payloadLen_p;
+    if (pFrame_p->len < ETH_FRAME_SIZE_MIN)
+        pFrame_p->len = ETH_FRAME_SIZE_MIN;
+
+    return pIpHdr + IP_HDR_SIZE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build an ARP frame of a host
+
+\param[out] pFrame_p        Frame
+\param[in]  pPeer_p         Sending host
+\param[in]  opcode_p        1: request (broadcast), 2: reply
+\param[in]  pTargetMac_p    MAC address of the target (reply only)
+\param[in]  pTargetIp_p     IP address of the target
+*/
+//------------------------------------------------------------------------------
+static void buildArp(tTstFrame* pFrame_p, const tPeer* pPeer_p, uint16_t opcode_p,
+                     const uint8_t* pTargetMac_p, const uint8_t* pTargetIp_p)
+{
+    uint8_t* pArp = pFrame_p->aData + ETH_HDR_SIZE;
+
+    memset(pFrame_p->aData, 0, ETH_FRAME_SIZE_MIN);
+
+    if (opcode_p == 1)
+        memset(pFrame_p->aData, 0xFF, 6);
+    else
+        memcpy(pFrame_p->aData, pTargetMac_p, 6);
+    memcpy(pFrame_p->aData + 6, pPeer_p->aMac, 6);
+    put16(pFrame_p->aData + 12, ETH_TYPE_ARP);
+
+    put16(pArp, 1);                 // Ethernet
+    put16(pArp + 2, ETH_TYPE_IP);
+    pArp[4] = 6;
+    pArp[5] = 4;
+    put16(pArp + 6, opcode_p);
+    memcpy(pArp + 8, pPeer_p->aMac, 6);
+    memcpy(pArp + 14, pPeer_p->aIp, 4);
+    if (pTargetMac_p != NULL)
+        memcpy(pArp + 18, pTargetMac_p, 6);
+    memcpy(pArp + 24, pTargetIp_p, 4);
+
+    pFrame_p->len = ETH_FRAME_SIZE_MIN;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build a TCP segment of a host
+
+The payload is taken from the data stream of the host at the offset given by
+the sequence number.
+
+\param[out] pFrame_p        Frame
+\param[in]  pPeer_p         Sending host
+\param[in]  seq_p           Sequence number
+\param[in]  flags_p         TCP flags
+\param[in]  dataLen_p       Payload length
+*/
+//------------------------------------------------------------------------------
+static void buildTcp(tTstFrame* pFrame_p, tPeer* pPeer_p, uint32_t seq_p,
+                     uint8_t flags_p, size_t dataLen_p)
+{
+    size_t      hdrLen = (flags_p & TCP_FLAG_SYN) ? TCP_HDR_SIZE + 4 : TCP_HDR_SIZE;
+    uint8_t*    pTcp = buildIp(pFrame_p, pPeer_p, IP_PROTO_TCP, hdrLen + dataLen_p);
+    uint32_t    offset = seq_p - (pPeer_p->iss + 1);
+    size_t      i;
+
+    put16(pTcp, pPeer_p->tcpPort);
+    put16(pTcp + 2, TST_TCP_PORT);
+    put32(pTcp + 4, seq_p);
+    put32(pTcp + 8, (flags_p & TCP_FLAG_ACK) ? pPeer_p->rcvNxt : 0);
+    pTcp[12] = (uint8_t)((hdrLen / 4) << 4);
+    pTcp[13] = flags_p;
+    put16(pTcp + 14, TCP_WINDOW);
+    put16(pTcp + 16, 0);
+    put16(pTcp + 18, 0);
+
+    if (flags_p & TCP_FLAG_SYN)
+    {
+        pTcp[20] = 2;               // maximum segment size option
+        pTcp[21] = 4;
+        put16(pTcp + 22, IP_MTU - IP_HDR_SIZE - TCP_HDR_SIZE);
+    }
+
+    for (i = 0; i < dataLen_p; i++)
+        pTcp[hdrLen + i] = pattern(offset + i, (unsigned int)(pPeer_p - gen_l.aPeer));
+
+    put16(pTcp + 16, fold(sum(pTcp, hdrLen + dataLen_p,
+                              pseudoSum(pTcp - IP_HDR_SIZE, IP_PROTO_TCP, hdrLen + dataLen_p))));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Fill UDP header and payload of a datagram to the harness port
+
+The payload starts with the UDP sequence number, followed by the pattern of
+this number.
+
+\param[out] pUdp_p          UDP header
+\param[in]  len_p           Payload length (at least 4)
+\param[in]  seq_p           UDP sequence number
+\param[in]  pIpHdr_p        IP header with the addresses of the pseudo header
+*/
+//------------------------------------------------------------------------------
+static void fillUdp(uint8_t* pUdp_p, size_t len_p, uint32_t seq_p, const uint8_t* pIpHdr_p)
+{
+    size_t i;
+
+    put16(pUdp_p, UDP_SRC_PORT);
+    put16(pUdp_p + 2, TST_UDP_PORT);
+    put16(pUdp_p + 4, (uint16_t)(UDP_HDR_SIZE + len_p));
+    put16(pUdp_p + 6, 0);
+    put32(pUdp_p + UDP_HDR_SIZE, seq_p);
+    for (i = 4; i < len_p; i++)
+        pUdp_p[UDP_HDR_SIZE + i] = pattern(i, seq_p);
+
+    put16(pUdp_p + 6, fold(sum(pUdp_p, UDP_HDR_SIZE + len_p,
+                               pseudoSum(pIpHdr_p, IP_PROTO_UDP, UDP_HDR_SIZE + len_p))));
+    if (get16(pUdp_p + 6) == 0)
+        put16(pUdp_p + 6, 0xFFFF);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Allocate a frame in the queue of the host answers
+
+\return tTstFrame*
+\retval Frame to fill
+\retval NULL        Queue is full, the answer is lost
+*/
+//------------------------------------------------------------------------------
+static tTstFrame* allocPending(void)
+{
+    tTstFrame* pFrame;
+
+    if (gen_l.pendingCount >= PENDING_CNT)
+        return NULL;
+
+    pFrame = &gen_l.aPending[(gen_l.pendingRead + gen_l.pendingCount) % PENDING_CNT];
+    gen_l.pendingCount++;
+
+    return pFrame;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Take the oldest frame from the queue of the host answers
+
+\param[in]  timeNs_p        Current time
+\param[out] pFrame_p        Frame for the stack
+
+\return int
+\retval 1       Frame returned
+\retval 0       Queue is empty
+*/
+//------------------------------------------------------------------------------
+static int popPending(uint64_t timeNs_p, tTstFrame* pFrame_p)
+{
+    if (gen_l.pendingCount == 0)
+        return 0;
+
+    *pFrame_p = gen_l.aPending[gen_l.pendingRead];
+    pFrame_p->timeNs = timeNs_p;
+
+    gen_l.pendingRead = (gen_l.pendingRead + 1) % PENDING_CNT;
+    gen_l.pendingCount--;
+
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build the UDP datagram of a host which is sent in fragments
+
+\param[in] pPeer_p          Sending host
+\param[in] len_p            UDP payload length (at least 4)
+\param[in] seq_p            UDP sequence number
+
+\return size_t
+\retval Length of the UDP datagram
+*/
+//------------------------------------------------------------------------------
+static size_t buildDatagram(const tPeer* pPeer_p, size_t len_p, uint32_t seq_p)
+{
+    uint8_t aIpHdr[IP_HDR_SIZE];
+
+    // the pseudo header only needs the addresses
+    memcpy(aIpHdr + 12, pPeer_p->aIp, 4);
+    memcpy(aIpHdr + 16, gen_l.aStackIp, 4);
+
+    fillUdp(gen_l.aDatagram, len_p, seq_p, aIpHdr);
+
+    return UDP_HDR_SIZE + len_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build a fragment of the datagram built by buildDatagram()
+
+\param[out] pFrame_p        Frame
+\param[in]  pPeer_p         Sending host
+\param[in]  ipId_p          IP identification of the datagram
+\param[in]  udpLen_p        Length of the UDP datagram
+\param[in]  offset_p        Offset of the fragment (multiple of 8)
+\param[in]  len_p           Length of the fragment
+*/
+//------------------------------------------------------------------------------
+static void buildFragment(tTstFrame* pFrame_p, const tPeer* pPeer_p, uint16_t ipId_p,
+                          size_t udpLen_p, size_t offset_p, size_t len_p)
+{
+    uint8_t* pIpHdr;
+
+    pIpHdr = buildIp(pFrame_p, pPeer_p, IP_PROTO_UDP, len_p) - IP_HDR_SIZE;
+    memcpy(pIpHdr + IP_HDR_SIZE, gen_l.aDatagram + offset_p, len_p);
+
+    put16(pIpHdr + 4, ipId_p);
+    put16(pIpHdr + 6, (uint16_t)((offset_p / 8) |
+                                 ((offset_p + len_p < udpLen_p) ? FRAG_FLAG_MORE : 0)));
+    put16(pIpHdr + 10, 0);
+    put16(pIpHdr + 10, fold(sum(pIpHdr, IP_HDR_SIZE, 0)));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Queue a fragmented UDP datagram of a host
+
+The datagram is split into 2 to \ref FRAG_CNT_MAX fragments of about the same
+size. The fragments are queued in random order, so the last fragment often
+arrives first and the datagram has several holes during the reassembly.
+
+\param[in] pPeer_p          Sending host
+*/
+//------------------------------------------------------------------------------
+static void genFragmented(const tPeer* pPeer_p)
+{
+    unsigned int    aOrder[FRAG_CNT_MAX];
+    unsigned int    cnt;
+    unsigned int    i;
+    unsigned int    j;
+    unsigned int    swap;
+    size_t          udpLen;
+    size_t          fragSize;
+    size_t          offset;
+    uint16_t        ipId;
+
+    if (PENDING_CNT - gen_l.pendingCount < FRAG_CNT_MAX)
+        return;
+
+    udpLen = buildDatagram(pPeer_p, 4 + nextRandom() % (IP_MTU - IP_HDR_SIZE - UDP_HDR_SIZE - 3),
+                           ++gen_l.udpSeq);
+
+    // fragments have a multiple of 8 bytes, except for the last one
+    cnt      = 2 + nextRandom() % (FRAG_CNT_MAX - 1);
+    fragSize = ((udpLen + cnt - 1) / cnt + 7) & ~(size_t)7;
+    cnt      = (unsigned int)((udpLen + fragSize - 1) / fragSize);
+
+    for (i = 0; i < cnt; i++)
+        aOrder[i] = i;
+
+    for (i = cnt - 1; i > 0; i--)
+    {
+        j = nextRandom() % (i + 1);
+        swap = aOrder[i];
+        aOrder[i] = aOrder[j];
+        aOrder[j] = swap;
+    }
+
+    ipId = ++gen_l.ipId;
+
+    for (i = 0; i < cnt; i++)
+    {
+        offset = aOrder[i] * fragSize;
+        buildFragment(allocPending(), pPeer_p, ipId, udpLen, offset,
+                      (offset + fragSize < udpLen) ? fragSize : udpLen - offset);
+    }
+
+    gen_l.statistics.udpSent++;
+    gen_l.statistics.udpFragmented++;
+    gen_l.statistics.udpFragments += cnt;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Generate the next TCP segment of the hosts
+
+A host without connection sends a SYN. A host with a connection sends new data
+when all of its data was acknowledged and echoed. Unacknowledged SYNs and data
+are retransmitted after \ref TCP_RTO_NS.
+
+\param[in]  timeNs_p        Current time
+\param[out] pFrame_p        Frame
+\param[in]  fNewData_p      FALSE if only retransmissions are allowed
+
+\return int
+\retval 1       Segment returned
+\retval 0       No host can send
+*/
+//------------------------------------------------------------------------------
+static int genTcp(uint64_t timeNs_p, tTstFrame* pFrame_p, int fNewData_p)
+{
+    unsigned int    start = nextRandom() % TST_TCP_PEER_CNT;
+    unsigned int    i;
+    tPeer*          pPeer;
+    uint32_t        len;
+    uint64_t        sent;
+
+    for (i = 0; i < TST_TCP_PEER_CNT; i++)
+    {
+        pPeer = &gen_l.aPeer[(start + i) % TST_TCP_PEER_CNT];
+
+        switch (pPeer->tcpState)
+        {
+            case kTcpClosed:
+                if (!fNewData_p)
+                    break;
+
+                pPeer->tcpPort    = (uint16_t)(TCP_SRC_PORT + (pPeer - gen_l.aPeer) * 1000 +
+                                               gen_l.statistics.tcpConnects % 1000);
+                pPeer->iss        = nextRandom();
+                pPeer->sndUna     = pPeer->iss;
+                pPeer->sndNxt     = pPeer->iss + 1;
+                pPeer->echoOffset = 0;
+                pPeer->lastTxNs   = timeNs_p;
+                pPeer->tcpState   = kTcpSynSent;
+
+                buildTcp(pFrame_p, pPeer, pPeer->iss, TCP_FLAG_SYN, 0);
+                return 1;
+
+            case kTcpSynSent:
+                if (timeNs_p - pPeer->lastTxNs < TCP_RTO_NS)
+                    break;
+
+                pPeer->lastTxNs = timeNs_p;
+                gen_l.statistics.tcpRetransmits++;
+
+                buildTcp(pFrame_p, pPeer, pPeer->iss, TCP_FLAG_SYN, 0);
+                return 1;
+
+            case kTcpEstablished:
+                if (pPeer->sndUna != pPeer->sndNxt)
+                {
+                    if (timeNs_p - pPeer->lastTxNs < TCP_RTO_NS)
+                        break;
+
+                    pPeer->lastTxNs = timeNs_p;
+                    gen_l.statistics.tcpRetransmits++;
+
+                    buildTcp(pFrame_p, pPeer, pPeer->sndUna, TCP_FLAG_ACK | TCP_FLAG_PSH,
+                             pPeer->sndNxt - pPeer->sndUna);
+                    return 1;
+                }
+
+                sent = pPeer->sndUna - (pPeer->iss + 1);
+                if (!fNewData_p || (sent - pPeer->echoOffset >= TCP_UNECHOED_MAX))
+                    break;
+
+                len = 1 + nextRandom() % TCP_SEGMENT_SIZE_MAX;
+
+                buildTcp(pFrame_p, pPeer, pPeer->sndNxt, TCP_FLAG_ACK | TCP_FLAG_PSH, len);
+
+                pPeer->sndNxt  += len;
+                pPeer->lastTxNs = timeNs_p;
+                gen_l.statistics.tcpSegments++;
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Find the host with an IP address
+
+\param[in] pIp_p            IP address
+
+\return tPeer*
+\retval Host
+\retval NULL        No simulated host has this address
+*/
+//------------------------------------------------------------------------------
+static tPeer* findPeer(const uint8_t* pIp_p)
+{
+    unsigned int i;
+
+    for (i = 0; i < TST_PEER_CNT; i++)
+    {
+        if (memcmp(gen_l.aPeer[i].aIp, pIp_p, 4) == 0)
+            return &gen_l.aPeer[i];
+    }
+
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process an ARP frame of the stack
+
+Requests for a host are answered, replies to the requests of the hosts are
+counted.
+
+\param[in] pArp_p           ARP header
+\param[in] len_p            Length of the ARP frame
+*/
+//------------------------------------------------------------------------------
+static void stackArp(const uint8_t* pArp_p, size_t len_p)
+{
+    tPeer*      pPeer;
+    tTstFrame*  pFrame;
+
+    if (len_p < 28)
+        return;
+
+    pPeer = findPeer(pArp_p + 24);
+    if (pPeer == NULL)
+        return;             // probe or announcement of the stack
+
+    if ((memcmp(pArp_p + 8, gen_l.aStackMac, 6) != 0) ||
+        (memcmp(pArp_p + 14, gen_l.aStackIp, 4) != 0))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    switch (get16(pArp_p + 6))
+    {
+        case 1:
+            pFrame = allocPending();
+            if (pFrame == NULL)
+                break;
+
+            buildArp(pFrame, pPeer, 2, gen_l.aStackMac, gen_l.aStackIp);
+            gen_l.statistics.arpAnswered++;
+            break;
+
+        case 2:
+            gen_l.statistics.arpReplies++;
+            break;
+
+        default:
+            gen_l.statistics.invalidFrames++;
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process an ICMP packet of the stack
+
+\param[in] pIpHdr_p         IP header
+\param[in] len_p            IP length
+*/
+//------------------------------------------------------------------------------
+static void stackIcmp(const uint8_t* pIpHdr_p, size_t len_p)
+{
+    const uint8_t*  pIcmp = pIpHdr_p + IP_HDR_SIZE;
+    uint16_t        seq;
+    unsigned int    i;
+
+    if ((len_p != IP_HDR_SIZE + 8 + ICMP_ECHO_DATA_SIZE) ||
+        (fold(sum(pIcmp, len_p - IP_HDR_SIZE, 0)) != 0) ||
+        (pIcmp[0] != ICMP_ECHO_REPLY))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    seq = get16(pIcmp + 6);
+    for (i = 0; i < ICMP_ECHO_DATA_SIZE; i++)
+    {
+        if (pIcmp[8 + i] != pattern(i, seq))
+        {
+            gen_l.statistics.invalidFrames++;
+            return;
+        }
+    }
+
+    gen_l.statistics.echoReplies++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process an UDP datagram of the stack
+
+Only datagrams of the harness port are checked, they must carry the payload of
+a datagram sent to the stack.
+
+\param[in] pIpHdr_p         IP header
+\param[in] len_p            IP length
+*/
+//------------------------------------------------------------------------------
+static void stackUdp(const uint8_t* pIpHdr_p, size_t len_p)
+{
+    const uint8_t*  pUdp = pIpHdr_p + IP_HDR_SIZE;
+    size_t          udpLen = len_p - IP_HDR_SIZE;
+    uint32_t        seq;
+    size_t          i;
+
+    if ((udpLen < 8) || (get16(pUdp) != TST_UDP_PORT))
+        return;
+
+    if ((get16(pUdp + 4) != udpLen) || (udpLen < 8 + 4) ||
+        ((get16(pUdp + 6) != 0) &&
+         (fold(sum(pUdp, udpLen, pseudoSum(pIpHdr_p, IP_PROTO_UDP, udpLen))) != 0)))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    seq = get32(pUdp + 8);
+    for (i = 4; i < udpLen - 8; i++)
+    {
+        if (pUdp[8 + i] != pattern(i, seq))
+        {
+            gen_l.statistics.invalidFrames++;
+            return;
+        }
+    }
+
+    gen_l.statistics.udpEchoes++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process a TCP segment of the stack
+
+\param[in] pPeer_p          Addressed host
+\param[in] pIpHdr_p         IP header
+\param[in] len_p            IP length
+*/
+//------------------------------------------------------------------------------
+static void stackTcp(tPeer* pPeer_p, const uint8_t* pIpHdr_p, size_t len_p)
+{
+    const uint8_t*  pTcp = pIpHdr_p + IP_HDR_SIZE;
+    size_t          tcpLen = len_p - IP_HDR_SIZE;
+    size_t          hdrLen;
+    size_t          dataLen;
+    size_t          i;
+    uint32_t        seq;
+    uint32_t        ack;
+    uint8_t         flags;
+    tTstFrame*      pFrame;
+
+    if ((tcpLen < TCP_HDR_SIZE) ||
+        (fold(sum(pTcp, tcpLen, pseudoSum(pIpHdr_p, IP_PROTO_TCP, tcpLen))) != 0))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    hdrLen = (pTcp[12] >> 4) * 4;
+    if ((hdrLen < TCP_HDR_SIZE) || (hdrLen > tcpLen))
+    {
+        gen_l.statistics.invalidFrames++;
+        return;
+    }
+
+    if ((pPeer_p->tcpState == kTcpClosed) || (get16(pTcp + 2) != pPeer_p->tcpPort))
+        return;             // old connection
+
+    seq     = get32(pTcp + 4);
+    ack     = get32(pTcp + 8);
+    flags   = pTcp[13];
+    dataLen = tcpLen - hdrLen;
+
+    if (flags & TCP_FLAG_RST)
+    {
+        gen_l.statistics.tcpResets++;
+        pPeer_p->tcpState = kTcpClosed;
+        return;
+    }
+
+    if (pPeer_p->tcpState == kTcpSynSent)
+    {
+        if (((flags & (TCP_FLAG_SYN | TCP_FLAG_ACK)) != (TCP_FLAG_SYN | TCP_FLAG_ACK)) ||
+            (ack != pPeer_p->iss + 1))
+            return;
+
+        pPeer_p->rcvNxt   = seq + 1;
+        pPeer_p->sndUna   = ack;
+        pPeer_p->tcpState = kTcpEstablished;
+        gen_l.statistics.tcpConnects++;
+    }
+    else
+    {
+        // Acknowledged data
+        if ((flags & TCP_FLAG_ACK) &&
+            ((int32_t)(ack - pPeer_p->sndUna) > 0) && ((int32_t)(ack - pPeer_p->sndNxt) <= 0))
+        {
+            gen_l.statistics.tcpBytesSent += ack - pPeer_p->sndUna;
+            pPeer_p->sndUna = ack;
+        }
+
+        if ((dataLen == 0) && !(flags & TCP_FLAG_FIN))
+            return;         // nothing to acknowledge
+
+        // Echoed data, segments out of order are dropped and acknowledged
+        if ((seq == pPeer_p->rcvNxt) && (dataLen > 0))
+        {
+            for (i = 0; i < dataLen; i++)
+            {
+                if (pTcp[hdrLen + i] != pattern(pPeer_p->echoOffset + i,
+                                                (unsigned int)(pPeer_p - gen_l.aPeer)))
+                {
+                    gen_l.statistics.invalidFrames++;
+                    break;
+                }
+            }
+
+            pPeer_p->rcvNxt     += (uint32_t)dataLen;
+            pPeer_p->echoOffset += dataLen;
+            gen_l.statistics.tcpBytesEchoed += dataLen;
+        }
+    }
+
+    pFrame = allocPending();
+    if (pFrame != NULL)
+        buildTcp(pFrame, pPeer_p, pPeer_p->sndNxt, TCP_FLAG_ACK, 0);
+}
@@ -0,0 +1,281 @@
+/**
+********************************************************************************
+\file   STBedrv.c
+
+\brief  Fake Ethernet driver for the IP stack traffic harness
+
+The fake driver replaces edrv2veth and the POWERLINK virtual Ethernet. Received
+frames are copied to a small pool of driver buffers which are loaned to the
+stack with ipPacketReceive(), the same way edrv2veth does it. Frames sent by
+the stack are passed to a callback and released immediately.
+
+In direct mode every frame is first offered to ipPacketProcess() in a single
+driver buffer, like edrv2veth does with the POWERLINK receive buffer. The
+buffer is checked for writes of the stack and overwritten after the call, so
+a reference kept by the stack or a UDP hook shows up as corrupted data.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+
+#include <Stubs/STBedrv.h>
+
+#include <ip_internal.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define STB_EDRV_POISON         0xA5            ///< Fill byte of a released direct buffer
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Receive buffer descriptor
+
+The stack only knows the address of \ref length (ip_packet_typ).
+*/
+typedef struct
+{
+    int             fStackOwner;                ///< TRUE if the IP stack owns the buffer
+    unsigned long   length;                     ///< Frame length
+    uint8_t         aBuffer[IP_MTU + 18];       ///< Frame data
+} tStbEdrvRxDesc;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tStbEdrvRxDesc       aRxDesc_l[STB_EDRV_RX_BUF_CNT];
+static tStbEdrvStatistics   statistics_l;
+static tStbEdrvTxCb         pfnTxCb_l;
+static int                  fDirect_l;
+static uint32_t             aDirectBuffer_l[(IP_MTU + 18 + 3) / 4];     ///< Driver buffer of the direct mode
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void freePacket(ip_packet_typ* pPacket_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Initialize the fake driver
+
+\param[in] pfnTxCb_p        Callback for the frames sent by the stack
+\param[in] fDirect_p        TRUE to offer the frames to ipPacketProcess() first
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void stb_edrvInit(tStbEdrvTxCb pfnTxCb_p, int fDirect_p)
+{
+    memset(aRxDesc_l, 0, sizeof(aRxDesc_l));
+    memset(&statistics_l, 0, sizeof(statistics_l));
+
+    pfnTxCb_l = pfnTxCb_p;
+    fDirect_l = fDirect_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Pass a received frame to the stack
+
+\param[in] hIp_p            Handle of the IP stack
+\param[in] pData_p          Frame data starting with the Ethernet header
+\param[in] len_p            Frame length
+
+\return int
+\retval 0       The stack has taken the frame
+\retval -1      The frame was dropped
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int stb_edrvReceive(IP_STACK_H hIp_p, const uint8_t* pData_p, size_t len_p)
+{
+    tStbEdrvRxDesc* pDesc = NULL;
+    unsigned int    i;
+    int             ret;
+
+    if (fDirect_l && (len_p <= sizeof(aDirectBuffer_l)))
+    {
+        memcpy(aDirectBuffer_l, pData_p, len_p);
+
+        ret = ipPacketProcess(hIp_p, aDirectBuffer_l, len_p);
+
+        if (memcmp(aDirectBuffer_l, pData_p, len_p) != 0)
+            statistics_l.rxModified++;
+
+        // The driver reuses the buffer for the next frame
+        memset(aDirectBuffer_l, STB_EDRV_POISON, len_p);
+
+        if (ret == 0)
+        {
+            statistics_l.rxDirect++;
+            return 0;
+        }
+    }
+
+    for (i = 0; i < STB_EDRV_RX_BUF_CNT; i++)
+    {
+        if (!aRxDesc_l[i].fStackOwner)
+        {
+            pDesc = &aRxDesc_l[i];
+            break;
+        }
+    }
+
+    if ((pDesc == NULL) || (len_p > sizeof(pDesc->aBuffer)))
+    {
+        statistics_l.rxNoBuffer++;
+        return -1;
+    }
+
+    memcpy(pDesc->aBuffer, pData_p, len_p);
+    pDesc->length = len_p;
+
+    if (ipPacketReceive(hIp_p, (ip_packet_typ*)&pDesc->length, freePacket) != 0)
+    {
+        statistics_l.rxRejected++;
+        return -1;
+    }
+
+    pDesc->fStackOwner = 1;
+
+    statistics_l.rxFrames++;
+    statistics_l.rxInUse++;
+    if (statistics_l.rxInUse > statistics_l.rxHighWater)
+        statistics_l.rxHighWater = statistics_l.rxInUse;
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Send function of the fake driver (IP_ETHSEND)
+
+\param[in] hEth_p           Driver handle (unused)
+\param[in] pPacket_p        Frame to send
+\param[in] pfnFree_p        Function to release the frame
+
+\return unsigned long
+\retval Number of sent bytes
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+unsigned long stb_edrvSend(void* hEth_p, ip_packet_typ* pPacket_p,
+                           IP_BUF_FREE_FCT* pfnFree_p)
+{
+    unsigned long length = pPacket_p->length;
+
+    (void)hEth_p;
+
+    statistics_l.txFrames++;
+    statistics_l.txBytes += length;
+
+    if (pfnTxCb_l != NULL)
+        pfnTxCb_l(pPacket_p->data, length);
+
+    pfnFree_p(pPacket_p);
+
+    return length;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the fake driver statistics
+
+\return const tStbEdrvStatistics*
+\retval Pointer to the statistics
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+const tStbEdrvStatistics* stb_edrvGetStatistics(void)
+{
+    return &statistics_l;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Release a receive buffer loaned to the stack
+
+\param[in] pPacket_p        Frame passed with ipPacketReceive()
+*/
+//------------------------------------------------------------------------------
+static void freePacket(ip_packet_typ* pPacket_p)
+{
+    tStbEdrvRxDesc* pDesc = GET_TYPE_BASE(tStbEdrvRxDesc, length, pPacket_p);
+
+    if (pDesc->fStackOwner)
+    {
+        pDesc->fStackOwner = 0;
+        statistics_l.rxInUse--;
+    }
+}
@@ -0,0 +1,90 @@
+/**
+********************************************************************************
+\file   STBedrv.h
+
+\brief  Fake Ethernet driver for the IP stack traffic harness
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ip.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define STB_EDRV_RX_BUF_CNT     IP_RX_BUF_CNT   ///< Receive buffers of the driver
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+
+/**
+\brief  Fake driver statistics
+*/
+typedef struct
+{
+    unsigned long   rxFrames;       ///< Frames passed to the stack
+    unsigned long   rxDirect;       ///< Frames processed in the driver buffer with ipPacketProcess()
+    unsigned long   rxModified;     ///< Frames the stack has written to during ipPacketProcess()
+    unsigned long   rxNoBuffer;     ///< Frames dropped, no driver buffer free
+    unsigned long   rxRejected;     ///< Frames the stack did not take (filtered or queue full)
+    unsigned long   txFrames;       ///< Frames sent by the stack
+    unsigned long   txBytes;        ///< Bytes sent by the stack
+    unsigned int    rxInUse;        ///< Driver buffers currently owned by the stack
+    unsigned int    rxHighWater;    ///< Maximum of rxInUse
+} tStbEdrvStatistics;
+
+/**
+\brief  Callback for the frames sent by the stack
+*/
+typedef void (*tStbEdrvTxCb)(const uint8_t* pData_p, size_t len_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+void          stb_edrvInit(tStbEdrvTxCb pfnTxCb_p, int fDirect_p);
+int           stb_edrvReceive(IP_STACK_H hIp_p, const uint8_t* pData_p, size_t len_p);
+unsigned long stb_edrvSend(void* hEth_p, ip_packet_typ* pPacket_p,
+                           IP_BUF_FREE_FCT* pfnFree_p);
+const tStbEdrvStatistics* stb_edrvGetStatistics(void);
@@ -0,0 +1,448 @@
+/**
+********************************************************************************
+\file   TSTsocketwrapper.c
+
+\brief  Test of the socket wrapper receive queues
+
+The test runs the socket wrapper on a fake UDP interface of the IP stack. It
+checks that only instances created with socketwrapper_createQueued() take one
+of the receive queues, that queued datagrams are delivered by
+socketwrapper_process() and that the receive statistics count the dropped
+datagrams. The test is built with SOCKETWRAPPER_RX_QUEUE_CNT=1.
+
+Usage: tstsocketwrapper <case>, the case is one of pool, queue, stats or send.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <socketwrapper-int.h>
+#include <Stubs/STBip.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_LOCAL_PORT          3819            ///< Port the instances are bound to
+#define TST_REMOTE_PORT         4000            ///< Port of the sender (host byte order)
+#define TST_REMOTE_IP           0x0164A8C0UL    ///< 192.168.100.1 in network byte order
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Test case
+*/
+typedef struct
+{
+    const char*     pName;          ///< Name given on the command line
+    int             (*pfnRun)(void);///< Test function, returns the number of failed checks
+} tTstCase;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static char         aIpStack_l[16];     // Dummy IP stack handle, the fake does not use it
+static UINT         batchCount_l;
+static UINT         batchDatagrams_l;
+static UINT         receiveCount_l;
+static int          fOrderError_l;
+static int          fAddressError_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int  runPool(void);
+static int  runQueue(void);
+static int  runStats(void);
+static int  runSend(void);
+static tSocketWrapper openInstance(int fQueued_p);
+static void deliver(UINT8 seq_p, size_t len_p);
+static void receiveCb(const UINT8* pData_p, UINT dataSize_p,
+                      const tSocketWrapperAddress* pRemote_p);
+static void batchCb(tSocketWrapper pSocketWrapper_p,
+                    const tSocketWrapperDatagram* paDatagram_p, UINT count_p);
+static int  check(const char* pName_p, unsigned long value_p, unsigned long expected_p);
+
+static const tTstCase aCase_l[] =
+{
+    {"pool",    runPool},
+    {"queue",   runQueue},
+    {"stats",   runStats},
+    {"send",    runSend},
+};
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+int main(int argc, char** argv)
+{
+    unsigned int    i;
+    int             failCount;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s pool|queue|stats|send\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(aCase_l) / sizeof(aCase_l[0]); i++)
+    {
+        if (strcmp(argv[1], aCase_l[i].pName) != 0)
+            continue;
+
+        stb_ipReset();
+        socketwrapper_setIpStackHandle((IP_STACK_H)aIpStack_l);
+
+        failCount = aCase_l[i].pfnRun();
+        printf("%s: %s\n", aCase_l[i].pName, (failCount == 0) ? "ok" : "FAIL");
+
+        return (failCount == 0) ? 0 : 1;
+    }
+
+    fprintf(stderr, "Unknown case %s\n", argv[1]);
+    return 1;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Receive queues are only taken by queued instances
+
+With one receive queue a second queued instance fails, a plain instance is
+created without a queue. The queue is free again after the close.
+
+\return The function returns the number of failed checks.
+*/
+//------------------------------------------------------------------------------
+static int runPool(void)
+{
+    tSocketWrapper  pQueued;
+    tSocketWrapper  pPlain;
+    int             fail = 0;
+
+    pQueued = openInstance(TRUE);
+    fail += check("queued instance", pQueued != NULL, 1);
+    fail += check("second queued instance", socketwrapper_createQueued(batchCb) == NULL, 1);
+
+    pPlain = openInstance(FALSE);
+    fail += check("plain instance", pPlain != NULL, 1);
+
+    // The plain instance calls its callback directly, nothing is queued
+    deliver(0, 100);
+    fail += check("direct receive", receiveCount_l, 1);
+    fail += check("process without datagrams", socketwrapper_process(), 0);
+
+    socketwrapper_close(pPlain);
+    socketwrapper_close(pQueued);
+
+    pQueued = socketwrapper_createQueued(batchCb);
+    fail += check("queued instance after close", pQueued != NULL, 1);
+    socketwrapper_close(pQueued);
+
+    return fail;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Queued datagrams are delivered in one batch
+
+\return The function returns the number of failed checks.
+*/
+//------------------------------------------------------------------------------
+static int runQueue(void)
+{
+    tSocketWrapper  pQueued;
+    UINT8           seq;
+    int             fail = 0;
+
+    pQueued = openInstance(TRUE);
+    if (pQueued == NULL)
+        return check("queued instance", 0, 1);
+
+    for (seq = 0; seq < SOCKETWRAPPER_RX_QUEUE_SIZE; seq++)
+        deliver(seq, 20 + seq);
+
+    fail += check("batches before process", batchCount_l, 0);
+    fail += check("delivered datagrams", socketwrapper_process(), SOCKETWRAPPER_RX_QUEUE_SIZE);
+    fail += check("batches", batchCount_l, 1);
+    fail += check("datagrams of batch", batchDatagrams_l, SOCKETWRAPPER_RX_QUEUE_SIZE);
+    fail += check("order error", fOrderError_l, 0);
+    fail += check("address error", fAddressError_l, 0);
+    fail += check("second process", socketwrapper_process(), 0);
+    fail += check("batches after second process", batchCount_l, 1);
+
+    // The ring wraps after the first batch
+    deliver(0, 20);
+    deliver(1, 21);
+    fail += check("delivered after wrap", socketwrapper_process(), 2);
+    fail += check("order error after wrap", fOrderError_l, 0);
+
+    socketwrapper_close(pQueued);
+
+    return fail;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Dropped datagrams are counted in the statistics
+
+\return The function returns the number of failed checks.
+*/
+//------------------------------------------------------------------------------
+static int runStats(void)
+{
+    tSocketWrapper                  pQueued;
+    const tSocketWrapperStatistics* pStat;
+    UINT8                           seq;
+    int                             fail = 0;
+
+    pQueued = openInstance(TRUE);
+    if (pQueued == NULL)
+        return check("queued instance", 0, 1);
+
+    for (seq = 0; seq < SOCKETWRAPPER_RX_QUEUE_SIZE + 2; seq++)
+        deliver(seq, 64);
+    deliver(0, SOCKETWRAPPER_RX_DATA_SIZE + 1);
+
+    socketwrapper_process();
+    socketwrapper_process();
+
+    pStat = socketwrapper_getStatistics(pQueued);
+    fail += check("rxCount", pStat->rxCount, SOCKETWRAPPER_RX_QUEUE_SIZE + 3);
+    fail += check("rxQueueFullCount", pStat->rxQueueFullCount, 2);
+    fail += check("rxOversizeCount", pStat->rxOversizeCount, 1);
+    fail += check("rxQueuePeak", pStat->rxQueuePeak, SOCKETWRAPPER_RX_QUEUE_SIZE);
+    fail += check("batchCount", pStat->batchCount, 1);
+    fail += check("delivered datagrams", batchDatagrams_l, SOCKETWRAPPER_RX_QUEUE_SIZE);
+
+    socketwrapper_close(pQueued);
+
+    return fail;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Segment lengths are checked before they are passed to the IP stack
+
+\return The function returns the number of failed checks.
+*/
+//------------------------------------------------------------------------------
+static int runSend(void)
+{
+    static UINT8            aData[0x10010];
+    tSocketWrapper          pPlain;
+    tSocketWrapperAddress   remote;
+    tSocketWrapperSegment   aSegment[2];
+    int                     fail = 0;
+
+    pPlain = openInstance(FALSE);
+    if (pPlain == NULL)
+        return check("plain instance", 0, 1);
+
+    remote.ipAddress = TST_REMOTE_IP;
+    remote.port = TST_REMOTE_PORT;
+
+    aSegment[0].pData = aData;
+    aSegment[0].size = 8;
+    aSegment[1].pData = aData;
+    aSegment[1].size = 100;
+    fail += check("valid segments", socketwrapper_sendSegments(pPlain, &remote, aSegment, 2), kErrorOk);
+    fail += check("sent bytes", stb_ipGetStatistics()->sendBytes, 108);
+    fail += check("sent segments", stb_ipGetStatistics()->segmentCount, 2);
+
+    aSegment[1].size = SOCKETWRAPPER_TX_DATA_SIZE - 8 + 1;
+    fail += check("datagram over limit", socketwrapper_sendSegments(pPlain, &remote, aSegment, 2),
+                  kErrorSdoUdpSendError);
+
+    // Would be truncated to 16 bit without the check
+    aSegment[1].size = 0x10008;
+    fail += check("segment over 64 kB", socketwrapper_sendSegments(pPlain, &remote, aSegment, 2),
+                  kErrorSdoUdpSendError);
+    fail += check("datagrams sent", stb_ipGetStatistics()->sendCount, 1);
+
+    socketwrapper_close(pPlain);
+
+    return fail;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Create and bind an instance
+
+\param[in] fQueued_p        Create the instance with socketwrapper_createQueued()
+
+\return tSocketWrapper
+\retval NULL    Instance could not be created or bound
+*/
+//------------------------------------------------------------------------------
+static tSocketWrapper openInstance(int fQueued_p)
+{
+    static UINT16           port = TST_LOCAL_PORT;
+    tSocketWrapper          pSocketWrapper;
+    tSocketWrapperAddress   address;
+
+    pSocketWrapper = fQueued_p ? socketwrapper_createQueued(batchCb) : socketwrapper_create(receiveCb);
+    if (pSocketWrapper == NULL)
+        return NULL;
+
+    // Every instance gets its own port, the stub delivers to the last opened one
+    address.ipAddress = 0;
+    address.port = port++;
+
+    if (socketwrapper_bind(pSocketWrapper, &address) != kErrorOk)
+    {
+        socketwrapper_close(pSocketWrapper);
+        return NULL;
+    }
+
+    return pSocketWrapper;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Deliver a datagram to the last opened instance
+
+The payload is filled with the sequence number, the receiver checks the order
+with the first byte.
+
+\param[in] seq_p            Sequence number
+\param[in] len_p            Payload size
+*/
+//------------------------------------------------------------------------------
+static void deliver(UINT8 seq_p, size_t len_p)
+{
+    static UINT8    aData[IP_MTU];
+    UINT16          port;
+
+    memset(aData, seq_p, len_p);
+
+    for (port = TST_LOCAL_PORT + 16; port >= TST_LOCAL_PORT; port--)
+    {
+        if (stb_ipDeliver(port, aData, len_p, TST_REMOTE_IP, htons(TST_REMOTE_PORT)) == 0)
+            return;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Receive callback of the plain instances
+*/
+//------------------------------------------------------------------------------
+static void receiveCb(const UINT8* pData_p, UINT dataSize_p,
+                      const tSocketWrapperAddress* pRemote_p)
+{
+    UNUSED_PARAMETER(pData_p);
+    UNUSED_PARAMETER(dataSize_p);
+
+    if ((pRemote_p->ipAddress != TST_REMOTE_IP) || (pRemote_p->port != TST_REMOTE_PORT))
+        fAddressError_l = TRUE;
+
+    receiveCount_l++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Batch receive callback of the queued instances
+
+The datagrams of a batch carry the sequence numbers 0, 1, 2, ...
+*/
+//------------------------------------------------------------------------------
+static void batchCb(tSocketWrapper pSocketWrapper_p,
+                    const tSocketWrapperDatagram* paDatagram_p, UINT count_p)
+{
+    UINT i;
+
+    UNUSED_PARAMETER(pSocketWrapper_p);
+
+    for (i = 0; i < count_p; i++)
+    {
+        if ((paDatagram_p[i].pData[0] != i) ||
+            (paDatagram_p[i].pData[paDatagram_p[i].size - 1] != i))
+            fOrderError_l = TRUE;
+
+        if ((paDatagram_p[i].remote.ipAddress != TST_REMOTE_IP) ||
+            (paDatagram_p[i].remote.port != TST_REMOTE_PORT))
+            fAddressError_l = TRUE;
+    }
+
+    batchCount_l++;
+    batchDatagrams_l += count_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare a value with the expected one
+
+\return The function returns 1 if the values differ, otherwise 0.
+*/
+//------------------------------------------------------------------------------
+static int check(const char* pName_p, unsigned long value_p, unsigned long expected_p)
+{
+    if (value_p == expected_p)
+        return 0;
+
+    printf("FAIL: %s %lu, expected %lu\n", pName_p, value_p, expected_p);
+    return 1;
+}
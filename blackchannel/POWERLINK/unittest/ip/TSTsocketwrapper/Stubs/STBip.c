@@ -0,0 +1,301 @@
+/**
+********************************************************************************
+\file   STBip.c
+
+\brief  Fake UDP interface of the IP stack for the socket wrapper test
+
+The fake replaces the UDP functions of the IP stack which the socket wrapper
+calls. The hooks registered with ipUdpListen() are kept per port, so the test
+can deliver datagrams to an instance like the stack does. Sent datagrams are
+only counted.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <string.h>
+
+#include <Stubs/STBip.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define STB_IP_LISTEN_CNT       4           ///< Ports which can be opened at the same time
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Open UDP port
+*/
+typedef struct
+{
+    unsigned long   port;           ///< Local port, 0 if the entry is free
+    IP_HOOKFCT*     pfnHook;        ///< Hook of the port
+    void*           pArg;           ///< Argument of the hook
+} tStbIpListen;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tStbIpListen         aListen_l[STB_IP_LISTEN_CNT];
+static tStbIpStatistics     statistics_l;
+static unsigned long        aTxBuffer_l[(IP_MTU + 3) / 4];
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static tStbIpListen* findListen(unsigned long port_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Close all ports and clear the statistics
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void stb_ipReset(void)
+{
+    memset(aListen_l, 0, sizeof(aListen_l));
+    memset(&statistics_l, 0, sizeof(statistics_l));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Deliver a datagram to the hook of a port
+
+\param[in] port_p           Local port
+\param[in] pData_p          Payload
+\param[in] len_p            Payload size
+\param[in] remoteIp_p       IP address of the sender (network byte order)
+\param[in] remotePort_p     Port of the sender (network byte order)
+
+\return int
+\retval 0       Datagram passed to the hook
+\retval -1      Port not open
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int stb_ipDeliver(unsigned short port_p, const void* pData_p, size_t len_p,
+                  unsigned long remoteIp_p, unsigned short remotePort_p)
+{
+    tStbIpListen*   pListen = findListen(port_p);
+    ip_udp_info     info;
+
+    if (pListen == NULL)
+        return -1;
+
+    memset(&info, 0, sizeof(info));
+    info.pData      = (void*)pData_p;
+    info.len        = (unsigned short)len_p;
+    info.localPort  = port_p;
+    info.remotePort = remotePort_p;
+    info.remoteHost.S_un.S_addr = remoteIp_p;
+
+    pListen->pfnHook(pListen->pArg, &info);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the statistics of the fake IP stack
+
+\return const tStbIpStatistics*
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+const tStbIpStatistics* stb_ipGetStatistics(void)
+{
+    return &statistics_l;
+}
+
+int ipUdpListen(IP_STACK_H hIp, unsigned long lport, IP_HOOKFCT* pFct, void* arg)
+{
+    tStbIpListen* pListen = findListen(0);
+
+    (void)hIp;
+
+    statistics_l.listenCount++;
+
+    if ((pListen == NULL) || (findListen(lport) != NULL))
+        return -1;
+
+    pListen->port    = lport;
+    pListen->pfnHook = pFct;
+    pListen->pArg    = arg;
+
+    return 0;
+}
+
+int ipUdpClose(IP_STACK_H hIp, unsigned long lport)
+{
+    tStbIpListen* pListen = findListen(lport);
+
+    (void)hIp;
+
+    statistics_l.closeCount++;
+
+    if (pListen == NULL)
+        return -1;
+
+    memset(pListen, 0, sizeof(*pListen));
+
+    return 0;
+}
+
+int ipUdpSend(IP_STACK_H hIp, ip_udp_info* pInfo)
+{
+    (void)hIp;
+
+    statistics_l.sendCount++;
+    statistics_l.sendBytes    = pInfo->len;
+    statistics_l.segmentCount = 1;
+
+    return pInfo->len;
+}
+
+int ipUdpSendv(IP_STACK_H hIp, ip_udp_info* pInfo, const ip_udp_seg* pSeg, unsigned long segCnt)
+{
+    unsigned long   i;
+    int             len = 0;
+
+    (void)hIp;
+    (void)pInfo;
+
+    for (i = 0; i < segCnt; i++)
+        len += pSeg[i].len;
+
+    statistics_l.sendCount++;
+    statistics_l.sendBytes    = (unsigned long)len;
+    statistics_l.segmentCount = segCnt;
+
+    return len;
+}
+
+void* ipUdpReserve(IP_STACK_H hIp, unsigned long maxLen)
+{
+    (void)hIp;
+
+    return (maxLen <= sizeof(aTxBuffer_l)) ? aTxBuffer_l : NULL;
+}
+
+int ipUdpCommit(IP_STACK_H hIp, ip_udp_info* pInfo)
+{
+    return ipUdpSend(hIp, pInfo);
+}
+
+void ipUdpRelease(IP_STACK_H hIp, void* pData)
+{
+    (void)hIp;
+    (void)pData;
+}
+
+void ipChangeAddress(IP_STACK_H hIp, struct in_addr* pIpAddr)
+{
+    (void)hIp;
+    (void)pIpAddr;
+}
+
+int ipArpQuery(unsigned long ip, void* pMac)
+{
+    (void)ip;
+
+    memset(pMac, 0x11, 6);
+
+    return 0;
+}
+
+int ipArpRequest(unsigned long ip, void* pMac)
+{
+    return ipArpQuery(ip, pMac);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Find an open port
+
+\param[in] port_p           Local port, 0 finds a free entry
+
+\return tStbIpListen*
+\retval NULL    Port not open (no free entry)
+*/
+//------------------------------------------------------------------------------
+static tStbIpListen* findListen(unsigned long port_p)
+{
+    unsigned int i;
+
+    for (i = 0; i < STB_IP_LISTEN_CNT; i++)
+    {
+        if (aListen_l[i].port == port_p)
+            return &aListen_l[i];
+    }
+
+    return NULL;
+}
@@ -0,0 +1,93 @@
+/**
+********************************************************************************
+\file   oplk/oplk.h
+
+\brief  Stub of the openPOWERLINK API include file
+
+The socket wrapper is tested without openPOWERLINK. The stub provides the
+types and error codes the socket wrapper and its headers use.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <oplk/oplkinc.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef TRUE
+#define TRUE                    1
+#endif
+#ifndef FALSE
+#define FALSE                   0
+#endif
+
+#define UNUSED_PARAMETER(par)   (void)par
+#define PRINTF                  printf
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef int             INT;
+typedef unsigned int    UINT;
+typedef unsigned char   BOOL;
+
+/**
+\brief  Error codes used by the socket wrapper
+*/
+typedef enum
+{
+    kErrorOk = 0,
+    kErrorApiNotInitialized,
+    kErrorSdoUdpSocketError,
+    kErrorSdoUdpSendError,
+    kErrorSdoUdpInvalidHdl,
+    kErrorSdoUdpArpInProgress,
+} tOplkError;
+
+/**
+\brief  NMT state (only used by the edrv2veth prototypes)
+*/
+typedef UINT16 tNmtState;
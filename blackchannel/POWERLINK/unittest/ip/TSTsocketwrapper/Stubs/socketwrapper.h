@@ -0,0 +1,85 @@
+/**
+********************************************************************************
+\file   socketwrapper.h
+
+\brief  Stub of the openPOWERLINK socket wrapper interface
+
+The public part of the socket wrapper interface is defined by openPOWERLINK.
+The stub declares the types and functions the test uses.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#pragma once
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <oplk/oplk.h>
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef void* tSocketWrapper;
+
+/**
+\brief  Socket address
+*/
+typedef struct
+{
+    UINT32      ipAddress;          ///< IP address in network byte order
+    UINT16      port;               ///< Port in host byte order
+} tSocketWrapperAddress;
+
+/**
+\brief  Receive callback of an instance without receive queue
+*/
+typedef void (*tSocketWrapperReceiveCb)(const UINT8* pData_p, UINT dataSize_p,
+                                        const tSocketWrapperAddress* pRemote_p);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+tSocketWrapper  socketwrapper_create(tSocketWrapperReceiveCb pfnReceiveCb_p);
+tOplkError      socketwrapper_bind(tSocketWrapper pSocketWrapper_p,
+                                   const tSocketWrapperAddress* pSocketAddress_p);
+void            socketwrapper_close(tSocketWrapper pSocketWrapper_p);
+tOplkError      socketwrapper_send(tSocketWrapper pSocketWrapper_p,
+                                   const tSocketWrapperAddress* pRemote_p,
+                                   const void* pData_p, size_t dataSize_p);
+void            socketwrapper_criticalSection(BOOL fEnable_p);
+tOplkError      socketwrapper_arpQuery(tSocketWrapper pSocketWrapper_p,
+                                       UINT32 remoteIpAddress_p);
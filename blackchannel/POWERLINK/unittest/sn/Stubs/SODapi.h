@@ -0,0 +1,144 @@
+/**
+********************************************************************************
+\file   SODapi.h
+
+\brief  Stub of the SOD interface of the openSAFETY stack
+
+Provides the part of the SOD interface used by the modules of the SAPL and the
+SHNF. Each harness implements the functions it links on its own object
+dictionary.
+
+The handles of the harnesses are positions in their object dictionary instead
+of object addresses, which do not fit into 32 bit on 64 bit hosts.
+SOD_HDL_TO_OBJECT maps them back to the object.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_SODapi_H_
+#define _INC_SODapi_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <sn/global.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define B_INSTNUM_
+#define BYTE_B_INSTNUM_
+
+#define SOD_k_ATTR_AFT_WR       0x0040
+#define SOD_k_ATTR_CRC          0x0100
+
+#define SOD_HDL_TO_OBJECT(hdl)  tst_getSodObject(hdl)
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef enum
+{
+    EPLS_k_BOOLEAN = 0x01,
+    EPLS_k_INT8 = 0x02,
+    EPLS_k_INT16 = 0x03,
+    EPLS_k_INT32 = 0x04,
+    EPLS_k_UINT8 = 0x05,
+    EPLS_k_UINT16 = 0x06,
+    EPLS_k_UINT32 = 0x07,
+    EPLS_k_VISIBLE_STRING = 0x09,
+    EPLS_k_OCTET_STRING = 0x0A,
+    EPLS_k_DOMAIN = 0x0F,
+    EPLS_k_UINT64 = 0x1B,
+} EPLS_t_DATATYPE;
+
+typedef enum
+{
+    SOD_k_SRV_BEFORE_READ,
+    SOD_k_SRV_BEFORE_WRITE,
+    SOD_k_SRV_AFTER_WRITE,
+} SOD_t_SERVICE;
+
+typedef enum
+{
+    SOD_ABT_NO_ERROR = 0x00000000,
+    SOD_ABT_GENERAL_ERROR = 0x08000000,
+} SOD_t_ABORT_CODES;
+
+typedef struct
+{
+    UINT16 w_attr;
+    EPLS_t_DATATYPE e_dataType;
+    UINT32 dw_objLen;
+    const void * pv_defValue;
+} SOD_t_ATTR;
+
+typedef struct
+{
+    UINT16 w_index;
+    UINT8 b_subIndex;
+    SOD_t_ATTR s_attr;
+    void * pv_objData;
+} SOD_t_OBJECT;
+
+typedef struct
+{
+    UINT32 dw_actLen;
+    void * pv_objData;
+} SOD_t_ACT_LEN_PTR_DATA;
+
+typedef struct
+{
+    UINT16 w_errorCode;
+    UINT32 e_abortCode;
+} SOD_t_ERROR_RESULT;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+const SOD_t_ATTR * SOD_AttrGetNext(BOOLEAN o_start, UINT32 * pdw_hdl,
+                                   SOD_t_ERROR_RESULT * ps_errRes);
+const SOD_t_ATTR * SOD_AttrGet(UINT16 w_idx, UINT8 b_subIdx, UINT32 * pdw_hdl,
+                               BOOLEAN * po_appObj, SOD_t_ERROR_RESULT * ps_errRes);
+void * SOD_Read(UINT32 dw_hdl, BOOLEAN o_appObj, UINT32 dw_offset, UINT32 dw_size,
+                SOD_t_ERROR_RESULT * ps_errRes);
+BOOLEAN SOD_Write(UINT32 dw_hdl, BOOLEAN o_appObj, void * pv_data, BOOLEAN o_overwrite,
+                  UINT32 dw_offset, UINT32 dw_size);
+BOOLEAN SOD_ActualLenSet(UINT32 dw_hdl, BOOLEAN o_appObj, UINT32 dw_actLen);
+
+SOD_t_OBJECT * tst_getSodObject(UINT32 dw_hdl);
+
+#endif /* _INC_SODapi_H_ */
@@ -0,0 +1,62 @@
+/**
+********************************************************************************
+\file   oschecksum/crc.h
+
+\brief  Stub of the checksum library of the openSAFETY stack
+
+The reference implementation of the CRC engine calls the checksum library.
+The harnesses of the CRC engine implement the functions bit by bit.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_oschecksum_crc_H_
+#define _INC_oschecksum_crc_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <sn/global.h>
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+UINT8 crc8Checksum(INT32 i_max, const UINT8 * pb_data, UINT8 b_initCrc);
+UINT16 crc16Checksum(INT32 i_max, const UINT8 * pb_data, UINT16 w_initCrc);
+UINT16 crc16Checksum_AC9A(INT32 i_max, const void * pv_data, UINT16 w_initCrc);
+UINT32 crc32Checksum(INT32 i_max, const UINT8 * pb_data, UINT32 dw_initCrc);
+
+#endif /* _INC_oschecksum_crc_H_ */
@@ -0,0 +1,95 @@
+/**
+********************************************************************************
+\file   sn/global.h
+
+\brief  Stub of the global header of the SN application
+
+The global header of the application includes the openSAFETY stack
+configuration and the target headers. The harnesses of the SN build the
+modules without them and only provide the types and macros the modules use.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_sn_global_H_
+#define _INC_sn_global_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TRUE                    1
+#define FALSE                   0
+
+#define SAFE_INIT_SEKTOR
+
+#define MEMSET(dst, c, count)   memset((void *)(dst), (int)(c), (size_t)(count))
+#define MEMCOPY(dst, src, len)  memcpy((void *)(dst), (const void *)(src), (size_t)(len))
+
+#define UNUSED_PARAMETER(par)   (void)par
+
+#define DEBUG_TRACE(lvl, ...)
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef uint8_t     BOOLEAN;
+typedef int8_t      INT8;
+typedef uint8_t     UINT8;
+typedef uint16_t    UINT16;
+typedef int32_t     INT32;
+typedef uint32_t    UINT32;
+typedef uint64_t    UINT64;
+
+typedef BOOLEAN (*tSyncCycle)(void);
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+void util_enterCriticalSection(BOOLEAN fEnable_p);
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <sn/errorhandler.h>
+
+#endif /* _INC_sn_global_H_ */
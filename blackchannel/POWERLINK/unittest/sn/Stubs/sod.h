@@ -0,0 +1,84 @@
+/**
+********************************************************************************
+\file   sod.h
+
+\brief  Stub of the SOD configuration header
+
+Sizes the parameter checksum object 0x1018/6 and the parameter set buffer for
+the object dictionaries of the harnesses. A harness overrides the defaults
+with a compile definition.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_sod_H_
+#define _INC_sod_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <sn/global.h>
+#include <SODapi.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef EPS_NO_SOD_CRCS
+#define EPS_NO_SOD_CRCS             64          ///< 32kB of CRC relevant data
+#endif
+
+#ifndef SAPL_k_MAX_PARAM_SET_LEN
+#define SAPL_k_MAX_PARAM_SET_LEN    0x4000      ///< 16kB parameter set
+#endif
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef struct
+{
+    UINT32 aulSodCrc[EPS_NO_SOD_CRCS];
+} tParamChksum;
+
+//------------------------------------------------------------------------------
+// function prototypes
+//------------------------------------------------------------------------------
+extern BOOLEAN SAPL_SOD_ParamCrc_CLBK(BYTE_B_INSTNUM_ SOD_t_SERVICE e_srvc,
+                                      const SOD_t_OBJECT *ps_obj,
+                                      const void *pv_data,
+                                      UINT32 org_dw_offset, UINT32 org_dw_size,
+                                      SOD_t_ABORT_CODES *pe_abortCode);
+
+#endif /* _INC_sod_H_ */
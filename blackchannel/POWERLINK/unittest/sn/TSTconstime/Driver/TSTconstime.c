@@ -0,0 +1,469 @@
+/**
+********************************************************************************
+\file   TSTconstime.c
+
+\brief  Harness of the consecutive time of the SN
+
+The harness runs the consecutive time (shnf/constime.c) on the system timer
+mock of the x86 target (target/x86/timer-mock.c). It emulates the counter with
+16 and 32 bits, with a wrap interrupt and without one, and compares every read
+of the time base with the elapsed time of the harness. The time base has to be
+exact and must never go backwards.
+
+The test cases force wraps of the counter:
+- A sweep advances the counter in random steps over many wraps. The sync
+  interrupt calls constime_process() after every second step.
+- A reader is interrupted by a wrap of the counter on each of its timer
+  accesses. Without wrap interrupt the sync interrupt also updates the wrap
+  state in between. With wrap interrupt the interrupt is also held pending
+  like in a critical section.
+- Without wrap interrupt a reader interrupts constime_process() after the new
+  wrap state is written but before it is published. With wrap interrupt no
+  reader can interrupt the update, the wrap interrupt has the highest priority.
+
+Usage: tstconstime irq16|poll16|irq32|poll32
+
+    irq16       16 bit counter with wrap interrupt
+    poll16      16 bit counter, the wraps are counted by constime_process()
+    irq32       32 bit counter with wrap interrupt
+    poll32      32 bit counter, the wraps are counted by constime_process()
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sn/global.h>
+#include <sn/timer.h>
+#include <sn/timermock.h>
+
+#include <shnf/constime.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+void tst_publishHook(void);
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_SWEEP_STEPS         20000       ///< Counter advances of the sweep
+#define TST_MAX_STEP_US         2000        ///< Longest advance of the sweep
+#define TST_START_WRAPS         3           ///< Wraps of the counter before the start time
+#define TST_WRAP_AHEAD_US       50          ///< Start time before the next wrap
+#define TST_READER_ACCESSES     4           ///< Timer accesses of a reader which are interrupted
+
+#define TST_CHECK(cond, ...)                                        \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (failCnt_l++ < 10)                                   \
+            {                                                       \
+                printf("FAILED line %d: ", __LINE__);               \
+                printf(__VA_ARGS__);                                \
+                printf("\n");                                       \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+/**
+\brief  Emulated system timer
+*/
+typedef struct
+{
+    const char*     pName;          ///< Name of the test case
+    UINT8           tickWidth;      ///< Width of the counter in bits
+    BOOLEAN         fWrapIrq;       ///< The counter provides a wrap interrupt
+} tTstMode;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static const tTstMode aMode_l[] =
+{
+    { "irq16",  16, TRUE    },
+    { "poll16", 16, FALSE   },
+    { "irq32",  32, TRUE    },
+    { "poll32", 32, FALSE   },
+};
+
+static const tTstMode*  pMode_l;
+static UINT64           now_l;              ///< Elapsed time of the harness
+static UINT64           lastRead_l;         ///< Last time base which was read
+static UINT32           wrapAccess_l;       ///< Timer access of the reader which is interrupted by the wrap
+static BOOLEAN          fSyncInRead_l;      ///< The sync interrupt also interrupts the reader
+static BOOLEAN          fReadInPublish_l;   ///< A reader interrupts the next wrap state update
+static UINT32           publishReadCnt_l;   ///< Reads which interrupted a wrap state update
+static UINT32           rand_l = 1;
+static unsigned long    failCnt_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void         testSweep(void);
+static void         testInterruptedReader(BOOLEAN fMaskIrq_p);
+static void         testInterruptedWriter(void);
+static void         startAt(UINT64 time_p);
+static void         advance(UINT32 ticks_p);
+static void         checkRead(const char* pCtx_p);
+static void         wrapHook(UINT32 accessCnt_p);
+static UINT32       random32(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Consecutive time harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       All checks passed
+\retval 1       Invalid arguments or the consecutive time could not be started
+\retval 2       A check failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    UINT32  i;
+
+    if (argc != 2)
+    {
+        printf("Usage: %s irq16|poll16|irq32|poll32\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(aMode_l) / sizeof(aMode_l[0]); i++)
+    {
+        if (strcmp(argv[1], aMode_l[i].pName) == 0)
+            pMode_l = &aMode_l[i];
+    }
+
+    if (pMode_l == NULL)
+    {
+        printf("Unknown test case %s\n", argv[1]);
+        return 1;
+    }
+
+    timermock_setMode(pMode_l->tickWidth, pMode_l->fWrapIrq);
+
+    if (!constime_init())
+    {
+        printf("FAILED: constime_init()\n");
+        return 1;
+    }
+
+    testSweep();
+
+    testInterruptedReader(FALSE);
+    if (pMode_l->fWrapIrq)
+        testInterruptedReader(TRUE);
+    else
+        testInterruptedWriter();
+
+    constime_exit();
+
+    printf("%s\n", (failCnt_l == 0) ? "PASSED" : "FAILED");
+
+    return (failCnt_l == 0) ? 0 : 2;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Hook of the wrap state update in constime.c
+
+A reader with higher priority interrupts the update after the new state is
+written but before it is published.
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void tst_publishHook(void)
+{
+    if (fReadInPublish_l)
+    {
+        fReadInPublish_l = FALSE;
+        publishReadCnt_l++;
+
+        checkRead("Reader in the update");
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the error handler and the critical section
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Fatal error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+void util_enterCriticalSection(BOOLEAN fEnable_p)
+{
+    UNUSED_PARAMETER(fEnable_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Advance the counter in random steps over many wraps
+
+The sync interrupt processes the time after every second step, which is
+within the counter period also for the 16 bit counter without wrap interrupt.
+*/
+//------------------------------------------------------------------------------
+static void testSweep(void)
+{
+    tTimerMockStat  stat;
+    UINT64          startTime = ((UINT64)TST_START_WRAPS << pMode_l->tickWidth) - TST_WRAP_AHEAD_US;
+    UINT64*         pTime;
+    UINT32          expWraps;
+    UINT32          step;
+
+    startAt(startTime);
+
+    for (step = 1; step <= TST_SWEEP_STEPS; step++)
+    {
+        advance(1 + random32() % TST_MAX_STEP_US);
+
+        if ((step & 1) == 0)
+        {
+            pTime = constime_process();
+            TST_CHECK(*pTime == now_l, "Sync time %llu instead of %llu step %lu",
+                      (unsigned long long)*pTime, (unsigned long long)now_l, (unsigned long)step);
+        }
+
+        checkRead("Sweep");
+    }
+
+    timermock_getStatistics(&stat);
+    expWraps = (UINT32)((now_l >> pMode_l->tickWidth) - (startTime >> pMode_l->tickWidth));
+
+    printf("%s: %lu wraps in %lu steps\n", pMode_l->pName, (unsigned long)stat.wrapCnt_m,
+           (unsigned long)TST_SWEEP_STEPS);
+
+    TST_CHECK(expWraps > 0 && stat.wrapCnt_m == expWraps, "%lu wraps instead of %lu",
+              (unsigned long)stat.wrapCnt_m, (unsigned long)expWraps);
+    TST_CHECK(stat.wrapIrqCnt_m == (pMode_l->fWrapIrq ? expWraps : 0), "%lu wrap interrupts",
+              (unsigned long)stat.wrapIrqCnt_m);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Interrupt a reader by a wrap of the counter
+
+The counter wraps before each of the first timer accesses of the reader.
+Without wrap interrupt the sync interrupt runs in between in a second pass.
+With a masked wrap interrupt the reader runs like in a critical section and
+the interrupt is served after the read.
+
+\param fMaskIrq_p       TRUE: Hold the wrap interrupt pending
+*/
+//------------------------------------------------------------------------------
+static void testInterruptedReader(BOOLEAN fMaskIrq_p)
+{
+    UINT64  startTime = ((UINT64)TST_START_WRAPS << pMode_l->tickWidth) - TST_WRAP_AHEAD_US;
+    UINT8   pass;
+
+    for (pass = 0; pass < (pMode_l->fWrapIrq ? 1 : 2); pass++)
+    {
+        fSyncInRead_l = (pass == 1) ? TRUE : FALSE;
+
+        for (wrapAccess_l = 1; wrapAccess_l <= TST_READER_ACCESSES; wrapAccess_l++)
+        {
+            startAt(startTime);
+            timermock_maskWrapIrq(fMaskIrq_p);
+
+            timermock_setHook(wrapHook);
+            checkRead("Interrupted reader");
+            timermock_setHook(NULL);
+
+            timermock_maskWrapIrq(FALSE);
+            checkRead("Reader after the wrap");
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Interrupt the wrap state update by a reader
+
+The counter wraps, then the sync interrupt counts the wrap in
+constime_process(). A reader interrupts it before the new state is published.
+*/
+//------------------------------------------------------------------------------
+static void testInterruptedWriter(void)
+{
+    UINT64* pTime;
+
+    startAt(((UINT64)TST_START_WRAPS << pMode_l->tickWidth) - TST_WRAP_AHEAD_US);
+
+    publishReadCnt_l = 0;
+    advance(2 * TST_WRAP_AHEAD_US);
+
+    fReadInPublish_l = TRUE;
+    pTime = constime_process();
+
+    TST_CHECK(publishReadCnt_l == 1, "Update not interrupted");
+    TST_CHECK(*pTime == now_l, "Sync time %llu instead of %llu", (unsigned long long)*pTime,
+              (unsigned long long)now_l);
+    checkRead("Reader after the update");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set the time base and the elapsed time of the harness
+
+\param time_p    The new time
+*/
+//------------------------------------------------------------------------------
+static void startAt(UINT64 time_p)
+{
+    constime_setTimebase(time_p);
+
+    now_l = time_p;
+    lastRead_l = time_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Advance the counter and the elapsed time of the harness
+
+\param ticks_p   Number of microseconds
+*/
+//------------------------------------------------------------------------------
+static void advance(UINT32 ticks_p)
+{
+    timermock_advance(ticks_p);
+
+    now_l += ticks_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Read the time base and check it
+
+The time base has to be the elapsed time and must not go backwards.
+
+\param pCtx_p    Name of the check
+*/
+//------------------------------------------------------------------------------
+static void checkRead(const char* pCtx_p)
+{
+    UINT64  time = constime_getTimeBase();
+
+    TST_CHECK(time == now_l, "%s: %llu instead of %llu (access %lu)", pCtx_p,
+              (unsigned long long)time, (unsigned long long)now_l, (unsigned long)wrapAccess_l);
+    TST_CHECK(time >= lastRead_l, "%s: %llu after %llu", pCtx_p, (unsigned long long)time,
+              (unsigned long long)lastRead_l);
+
+    lastRead_l = time;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Wrap the counter on a timer access of the reader
+
+\param accessCnt_p     Number of the timer access
+*/
+//------------------------------------------------------------------------------
+static void wrapHook(UINT32 accessCnt_p)
+{
+    if (accessCnt_p == wrapAccess_l)
+    {
+        advance(2 * TST_WRAP_AHEAD_US);
+
+        // The sync interrupt counts the wrap
+        if (fSyncInRead_l)
+            (void)constime_process();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Pseudo random numbers (reproducible)
+
+\return Random 32 bit value
+*/
+//------------------------------------------------------------------------------
+static UINT32 random32(void)
+{
+    rand_l = (rand_l * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return (UINT32)((rand_l >> 16) | ((rand_l & 0xFFFFUL) << 16));
+}
+
+/// \}
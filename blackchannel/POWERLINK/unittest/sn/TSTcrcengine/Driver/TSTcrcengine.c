@@ -0,0 +1,439 @@
+/**
+********************************************************************************
+\file   TSTcrcengine.c
+
+\brief  Harness and benchmark of the CRC engine of the SN
+
+The harness runs the CRC engine of the SN application (shnf/crcengine.c) on
+the host. Every available implementation is compared with a bit by bit
+calculation and the throughput of each implementation is measured.
+
+Usage: tstcrcengine verify|bench
+
+    verify      All implementations against the bit by bit calculation with
+                random lengths, alignments and initial values. Checks that
+                slices above CRCENGINE_SLICE_LIMIT are not built and that
+                crcengine_init() falls back to the table implementation.
+    bench       Throughput of all implementations per polynomial
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <shnf/crcengine.h>
+
+#include <oschecksum/crc.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#ifndef CRCENGINE_SLICE_LIMIT
+  #define CRCENGINE_SLICE_LIMIT     8       ///< Has to match the limit of the CRC engine
+#endif
+
+#define TST_BUF_SIZE            0x1000  ///< Size of the random data
+#define TST_VERIFY_RUNS         2000    ///< Random calculations per implementation
+#define TST_BENCH_SIZE          0x1000  ///< Bytes per calculation of the benchmark
+#define TST_BENCH_LOOPS         500     ///< Calculations per measurement
+
+#define TST_CHECK(cond, ...)                                        \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (failCnt_l++ < 10)                                   \
+            {                                                       \
+                printf("FAILED line %d: ", __LINE__);               \
+                printf(__VA_ARGS__);                                \
+                printf("\n");                                       \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Bit by bit description of a polynomial
+*/
+typedef struct
+{
+    UINT8           width;          ///< Width of the CRC in bits
+    UINT32          poly;           ///< Polynomial without the top bit
+    const char*     pName;          ///< Name for the benchmark output
+} tTstPoly;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static const tTstPoly aPoly_l[kCrcPolyCount] =
+{
+    {  8, 0x2FUL,       "CRC8"          },
+    { 16, 0x5935UL,     "CRC16 AC9A"    },
+    { 16, 0x755BUL,     "CRC16 755B"    },
+    { 32, 0x1EDC6F41UL, "CRC32"         },
+};
+
+static const char* aImplName_l[kCrcImplCount] =
+{
+    "reference", "bitwise", "table", "slice4", "slice8", "hardware"
+};
+
+static UINT8                    aBuf_l[TST_BUF_SIZE + 8];
+
+static unsigned long            rand_l = 1;
+static unsigned long            failCnt_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void         testVerify(void);
+static void         runBenchmark(void);
+static UINT32       calcBitwise(UINT8 width_p, UINT32 poly_p, UINT32 crc_p,
+                                const UINT8* pData_p, INT32 length_p);
+static UINT32       random32(void);
+static double       getTimeUs(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    CRC engine harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       All checks passed
+\retval 1       Invalid arguments or the CRC engine could not be started
+\retval 2       A check failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    UINT32  i;
+
+    if (argc != 2)
+    {
+        printf("Usage: %s verify|bench\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(aBuf_l); i++)
+        aBuf_l[i] = (UINT8)random32();
+
+    if (!crcengine_init())
+    {
+        printf("FAILED: crcengine_init()\n");
+        return 1;
+    }
+
+    if (strcmp(argv[1], "verify") == 0)
+        testVerify();
+    else if (strcmp(argv[1], "bench") == 0)
+        runBenchmark();
+    else
+    {
+        printf("Unknown test case %s\n", argv[1]);
+        return 1;
+    }
+
+    crcengine_exit();
+
+    printf("%s\n", (failCnt_l == 0) ? "PASSED" : "FAILED");
+
+    return (failCnt_l == 0) ? 0 : 2;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the checksum library (bit by bit)
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT8 crc8Checksum(INT32 i_max, const UINT8 * pb_data, UINT8 b_initCrc)
+{
+    return (UINT8)calcBitwise(8, 0x2FUL, b_initCrc, pb_data, i_max);
+}
+
+UINT16 crc16Checksum(INT32 i_max, const UINT8 * pb_data, UINT16 w_initCrc)
+{
+    return (UINT16)calcBitwise(16, 0x755BUL, w_initCrc, pb_data, i_max);
+}
+
+UINT16 crc16Checksum_AC9A(INT32 i_max, const void * pv_data, UINT16 w_initCrc)
+{
+    return (UINT16)calcBitwise(16, 0x5935UL, w_initCrc, (const UINT8*)pv_data, i_max);
+}
+
+UINT32 crc32Checksum(INT32 i_max, const UINT8 * pb_data, UINT32 dw_initCrc)
+{
+    return calcBitwise(32, 0x1EDC6F41UL, dw_initCrc, pb_data, i_max);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the error handler
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postMinorError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Minor error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Fatal error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare all implementations with the bit by bit calculation
+
+The selection of crcengine_init() is checked first: CRCENGINE_DEFAULT_IMPL
+if it is available for the polynomial, otherwise the table implementation.
+Slices above CRCENGINE_SLICE_LIMIT must not be available.
+*/
+//------------------------------------------------------------------------------
+static void testVerify(void)
+{
+    tCrcEngineImpl  expImpl;
+    UINT32          mask;
+    UINT32          init;
+    UINT32          length;
+    UINT32          offset;
+    UINT32          crc;
+    UINT32          expCrc;
+    UINT32          i;
+    UINT8           poly;
+    UINT8           impl;
+
+    for (poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        expImpl = crcengine_isAvailable((tCrcEnginePoly)poly, CRCENGINE_DEFAULT_IMPL) ?
+                  CRCENGINE_DEFAULT_IMPL : kCrcImplTable;
+        TST_CHECK(crcengine_getImpl((tCrcEnginePoly)poly) == expImpl,
+                  "%s selected %s instead of %s", aPoly_l[poly].pName,
+                  aImplName_l[crcengine_getImpl((tCrcEnginePoly)poly)], aImplName_l[expImpl]);
+
+        TST_CHECK(CRCENGINE_SLICE_LIMIT >= 4 ||
+                  !crcengine_isAvailable((tCrcEnginePoly)poly, kCrcImplSlice4),
+                  "%s slice4 is available above the limit", aPoly_l[poly].pName);
+        TST_CHECK(CRCENGINE_SLICE_LIMIT >= 8 ||
+                  !crcengine_isAvailable((tCrcEnginePoly)poly, kCrcImplSlice8),
+                  "%s slice8 is available above the limit", aPoly_l[poly].pName);
+
+        mask = (aPoly_l[poly].width == 32) ? 0xFFFFFFFFUL : ((1UL << aPoly_l[poly].width) - 1);
+
+        for (impl = 0; impl < kCrcImplCount; impl++)
+        {
+            if (!crcengine_select((tCrcEnginePoly)poly, (tCrcEngineImpl)impl))
+                continue;
+
+            for (i = 0; i < TST_VERIFY_RUNS; i++)
+            {
+                // Short lengths and all alignments first, then random blocks
+                init = random32() & mask;
+                offset = i % 8;
+                length = (i < 256) ? (i / 8) : (random32() % TST_BUF_SIZE);
+
+                crc = crcengine_calc((tCrcEnginePoly)poly, init, length, &aBuf_l[offset]);
+                expCrc = calcBitwise(aPoly_l[poly].width, aPoly_l[poly].poly, init,
+                                     &aBuf_l[offset], (INT32)length);
+
+                TST_CHECK(crc == expCrc, "%s %s length %lu offset %lu: 0x%lx instead of 0x%lx",
+                          aPoly_l[poly].pName, aImplName_l[impl], (unsigned long)length,
+                          (unsigned long)offset, (unsigned long)crc, (unsigned long)expCrc);
+            }
+        }
+
+        (void)crcengine_select((tCrcEnginePoly)poly, expImpl);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Measure the throughput of all implementations
+
+The results of the implementations are compared, the throughput is only
+printed.
+*/
+//------------------------------------------------------------------------------
+static void runBenchmark(void)
+{
+    tCrcEngineImpl  selImpl;
+    double          startUs;
+    double          timeUs;
+    UINT32          crc;
+    UINT32          expCrc;
+    UINT32          loop;
+    UINT8           poly;
+    UINT8           impl;
+
+    printf("%-12s %-10s %12s\n", "polynomial", "impl", "bytes/us");
+
+    for (poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        selImpl = crcengine_getImpl((tCrcEnginePoly)poly);
+        expCrc = calcBitwise(aPoly_l[poly].width, aPoly_l[poly].poly, 0,
+                             aBuf_l, TST_BENCH_SIZE);
+
+        for (impl = 0; impl < kCrcImplCount; impl++)
+        {
+            if (!crcengine_select((tCrcEnginePoly)poly, (tCrcEngineImpl)impl))
+                continue;
+
+            crc = 0;
+            startUs = getTimeUs();
+            for (loop = 0; loop < TST_BENCH_LOOPS; loop++)
+                crc |= crcengine_calc((tCrcEnginePoly)poly, 0, TST_BENCH_SIZE, aBuf_l) ^ expCrc;
+            timeUs = getTimeUs() - startUs;
+
+            TST_CHECK(crc == 0, "%s %s calculated a wrong CRC", aPoly_l[poly].pName,
+                      aImplName_l[impl]);
+
+            printf("%-12s %-10s %12.1f\n", aPoly_l[poly].pName, aImplName_l[impl],
+                   (timeUs > 0.0) ? ((double)TST_BENCH_SIZE * TST_BENCH_LOOPS) / timeUs : 0.0);
+        }
+
+        (void)crcengine_select((tCrcEnginePoly)poly, selImpl);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Bit by bit CRC calculation (MSB first, no final XOR)
+
+\param width_p      Width of the CRC in bits
+\param poly_p       Polynomial without the top bit
+\param crc_p        Initial CRC value
+\param pData_p      Data
+\param length_p     Length of the data
+
+\return The CRC of the data
+*/
+//------------------------------------------------------------------------------
+static UINT32 calcBitwise(UINT8 width_p, UINT32 poly_p, UINT32 crc_p,
+                          const UINT8* pData_p, INT32 length_p)
+{
+    UINT32  topBit = 1UL << (width_p - 1);
+    UINT32  mask = (topBit << 1) - 1;
+    UINT8   bit;
+
+    while (length_p-- > 0)
+    {
+        crc_p ^= (UINT32)(*pData_p++) << (width_p - 8);
+        for (bit = 0; bit < 8; bit++)
+            crc_p = ((crc_p & topBit) != 0) ? ((crc_p << 1) ^ poly_p) : (crc_p << 1);
+        crc_p &= mask;
+    }
+
+    return crc_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Reproducible pseudo random numbers
+
+\return A 32 bit random number
+*/
+//------------------------------------------------------------------------------
+static UINT32 random32(void)
+{
+    rand_l = (rand_l * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return (UINT32)((rand_l >> 16) | ((rand_l & 0xFFFFUL) << 16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Monotonic time for the benchmark
+
+\return Time in microseconds
+*/
+//------------------------------------------------------------------------------
+static double getTimeUs(void)
+{
+    return ((double)clock() * 1000000.0) / CLOCKS_PER_SEC;
+}
+
+/// \}
@@ -0,0 +1,1003 @@
+/**
+********************************************************************************
+\file   TSTparamcrc.c
+
+\brief  Harness and benchmark of the incremental parameter CRC of the SN
+
+The harness runs the parameter CRC module of the SN application
+(sapl/parametercrc.c) and the CRC engine (shnf/crcengine.c) on a generated
+object dictionary. The SOD interface of the openSAFETY stack is implemented
+on this dictionary, the handles are the positions of the objects. The expected checksums of 0x1018/6 are calculated by the
+harness bit by bit over the CRC relevant objects.
+
+Usage: tstparamcrc combine|update|overflow|bench|operational
+
+    combine     crcengine_combine() against the chained calculation
+    update      Written objects, changed lengths, missing notifications and
+                invalid checksums
+    overflow    Object dictionary with more segments than cached
+    bench       Full pass against updates of a large object dictionary
+    operational Full pass before OPERATIONAL with unreported writes
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sapl/parametercrc.h>
+#include <shnf/crcengine.h>
+
+#include <sod.h>
+#include <SODapi.h>
+#include <oschecksum/crc.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length, const void *pv_data);
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_BLOCK_SIZE          0x200                           ///< Data of one CRC32 of 0x1018/6
+#define TST_CRC_DATA_MAX        (EPS_NO_SOD_CRCS * TST_BLOCK_SIZE)  ///< CRC relevant data of a dictionary
+#define TST_MAX_OBJECTS         6000                            ///< Objects of a dictionary
+#define TST_CHKSUM_HDL          TST_MAX_OBJECTS                 ///< Handle of 0x1018/6
+#define TST_DATA_SIZE           (2 * TST_CRC_DATA_MAX)          ///< Data of all objects
+#define TST_DOMAIN_MAX          700                             ///< Maximum length of a domain
+
+#define TST_UPDATE_ROUNDS       300     ///< Rounds of the update scenario
+#define TST_COMBINE_RUNS        4000    ///< Random splits of the combine scenario
+#define TST_BENCH_LOOPS         50      ///< Calculations per measurement
+
+#define TST_CHECK(cond, ...)                                        \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (failCnt_l++ < 10)                                   \
+            {                                                       \
+                printf("FAILED line %d: ", __LINE__);               \
+                printf(__VA_ARGS__);                                \
+                printf("\n");                                       \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Shape of a generated object dictionary
+*/
+typedef struct
+{
+    UINT16          objCnt;         ///< Number of objects
+    unsigned int    domainPercent;  ///< Share of domains and strings
+    unsigned int    noCrcPercent;   ///< Share of objects which are not CRC relevant
+    unsigned int    noClbkPercent;  ///< Share of CRC relevant objects without after write callback
+} tTstSodShape;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static SOD_t_OBJECT             aObject_l[TST_MAX_OBJECTS];
+static SOD_t_ACT_LEN_PTR_DATA   aDomain_l[TST_MAX_OBJECTS];
+static UINT8                    aData_l[TST_DATA_SIZE];
+static UINT16                   objCnt_l;
+static UINT16                   nextObj_l;
+
+static tParamChksum             paramChksum_l;
+static SOD_t_OBJECT             paramChksumObj_l;
+
+static unsigned long            rand_l = 1;
+static unsigned long            failCnt_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void         testCombine(void);
+static void         testUpdate(void);
+static void         testOverflow(void);
+static void         runBenchmark(void);
+static void         testOperational(void);
+static void         testCallback(void);
+static void         generateSod(const tTstSodShape* pShape_p);
+static void         updateParamChksum(void);
+static UINT16       writeObject(BOOLEAN fNotify_p, BOOLEAN fResize_p);
+static UINT8*       getData(UINT16 objIdx_p, UINT32* pLen_p);
+static tProcCrcRet  runParamCrc(BOOLEAN fFullPass_p);
+static UINT32       calcBitwise(UINT8 width_p, UINT32 poly_p, UINT32 crc_p,
+                                const UINT8* pData_p, INT32 length_p);
+static UINT32       random32(void);
+static double       getTimeUs(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Parameter CRC harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       All checks passed
+\retval 1       Invalid arguments or the CRC engine could not be started
+\retval 2       A check failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s combine|update|overflow|bench|operational|callback\n", argv[0]);
+        return 1;
+    }
+
+    if ((crcengine_init() == FALSE) || (paramcrc_init() == FALSE))
+    {
+        fprintf(stderr, "Initialisation failed\n");
+        return 1;
+    }
+
+    if (strcmp(argv[1], "combine") == 0)
+        testCombine();
+    else if (strcmp(argv[1], "update") == 0)
+        testUpdate();
+    else if (strcmp(argv[1], "overflow") == 0)
+        testOverflow();
+    else if (strcmp(argv[1], "bench") == 0)
+        runBenchmark();
+    else if (strcmp(argv[1], "operational") == 0)
+        testOperational();
+    else if (strcmp(argv[1], "callback") == 0)
+        testCallback();
+    else
+    {
+        fprintf(stderr, "Unknown scenario %s\n", argv[1]);
+        return 1;
+    }
+
+    paramcrc_exit();
+    crcengine_exit();
+
+    printf("%s\n", (failCnt_l == 0) ? "PASSED" : "FAILED");
+
+    return (failCnt_l == 0) ? 0 : 2;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Wrapper of the parameter CRC like in sapl.c
+
+\param w_initCrc    Initial value of the CRC
+\param l_length     Number of bytes
+\param pv_data      Pointer to the data
+
+\return The CRC32
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length, const void *pv_data)
+{
+    return crcengine_calc(kCrcPolyCrc32, w_initCrc, (UINT32)l_length, pv_data);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the SOD iteration over the generated dictionary
+
+\param o_start      TRUE to start with the first object
+\param pdw_hdl      Handle of the returned object
+\param ps_errRes    Error result (not used)
+
+\return Attributes of the next object, NULL at the end of the dictionary
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+const SOD_t_ATTR * SOD_AttrGetNext(BOOLEAN o_start, UINT32 * pdw_hdl,
+                                   SOD_t_ERROR_RESULT * ps_errRes)
+{
+    const SOD_t_ATTR*   pAttr = NULL;
+
+    UNUSED_PARAMETER(ps_errRes);
+
+    if (o_start)
+        nextObj_l = 0;
+
+    if (nextObj_l < objCnt_l)
+    {
+        *pdw_hdl = nextObj_l;
+        pAttr = &aObject_l[nextObj_l].s_attr;
+        nextObj_l++;
+    }
+
+    return pAttr;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the SOD attribute access (only 0x1018/6)
+
+\param w_idx        Index of the object
+\param b_subIdx     Sub-index of the object
+\param pdw_hdl      Handle of the object
+\param po_appObj    Application object flag
+\param ps_errRes    Error result (not used)
+
+\return Attributes of 0x1018/6, NULL for all other objects
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+const SOD_t_ATTR * SOD_AttrGet(UINT16 w_idx, UINT8 b_subIdx, UINT32 * pdw_hdl,
+                               BOOLEAN * po_appObj, SOD_t_ERROR_RESULT * ps_errRes)
+{
+    const SOD_t_ATTR*   pAttr = NULL;
+
+    UNUSED_PARAMETER(ps_errRes);
+
+    if ((w_idx == paramChksumObj_l.w_index) && (b_subIdx == paramChksumObj_l.b_subIndex))
+    {
+        *pdw_hdl = TST_CHKSUM_HDL;
+        *po_appObj = FALSE;
+        pAttr = &paramChksumObj_l.s_attr;
+    }
+
+    return pAttr;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the SOD read access
+
+\param dw_hdl       Handle of the object
+\param o_appObj     Application object flag (not used)
+\param dw_offset    Offset (not used)
+\param dw_size      Size (not used)
+\param ps_errRes    Error result (not used)
+
+\return Pointer to the object data
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void * SOD_Read(UINT32 dw_hdl, BOOLEAN o_appObj, UINT32 dw_offset, UINT32 dw_size,
+                SOD_t_ERROR_RESULT * ps_errRes)
+{
+    UNUSED_PARAMETER(o_appObj);
+    UNUSED_PARAMETER(dw_offset);
+    UNUSED_PARAMETER(dw_size);
+    UNUSED_PARAMETER(ps_errRes);
+
+    return tst_getSodObject(dw_hdl)->pv_objData;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Map a handle of the generated dictionary to its object
+
+\param dw_hdl       Handle of the object
+
+\return The object
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+SOD_t_OBJECT * tst_getSodObject(UINT32 dw_hdl)
+{
+    return (dw_hdl == TST_CHKSUM_HDL) ? &paramChksumObj_l : &aObject_l[dw_hdl];
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the checksum library (bit by bit)
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT8 crc8Checksum(INT32 i_max, const UINT8 * pb_data, UINT8 b_initCrc)
+{
+    return (UINT8)calcBitwise(8, 0x2FUL, b_initCrc, pb_data, i_max);
+}
+
+UINT16 crc16Checksum(INT32 i_max, const UINT8 * pb_data, UINT16 w_initCrc)
+{
+    return (UINT16)calcBitwise(16, 0x755BUL, w_initCrc, pb_data, i_max);
+}
+
+UINT16 crc16Checksum_AC9A(INT32 i_max, const void * pv_data, UINT16 w_initCrc)
+{
+    return (UINT16)calcBitwise(16, 0x5935UL, w_initCrc, (const UINT8*)pv_data, i_max);
+}
+
+UINT32 crc32Checksum(INT32 i_max, const UINT8 * pb_data, UINT32 dw_initCrc)
+{
+    return calcBitwise(32, 0x1EDC6F41UL, dw_initCrc, pb_data, i_max);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the error handler
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postMinorError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Minor error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Fatal error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare crcengine_combine() with the chained calculation
+*/
+//------------------------------------------------------------------------------
+static void testCombine(void)
+{
+    static UINT8    aBuf[4 * TST_BLOCK_SIZE];
+    static const UINT8 aWidth[kCrcPolyCount] = { 8, 16, 16, 32 };
+    UINT32          mask;
+    UINT32          init;
+    UINT32          lenA;
+    UINT32          lenB;
+    UINT32          crcA;
+    UINT32          crcB;
+    UINT32          expCrc;
+    UINT32          i;
+    UINT8           poly;
+
+    for (i = 0; i < sizeof(aBuf); i++)
+        aBuf[i] = (UINT8)random32();
+
+    for (poly = 0; poly < kCrcPolyCount; poly++)
+    {
+        mask = (aWidth[poly] == 32) ? 0xFFFFFFFFUL : ((1UL << aWidth[poly]) - 1);
+
+        for (i = 0; i < TST_COMBINE_RUNS; i++)
+        {
+            init = random32() & mask;
+            lenA = random32() % (sizeof(aBuf) / 2);
+            lenB = (i < 64) ? i : random32() % (sizeof(aBuf) / 2);
+
+            crcA = crcengine_calc((tCrcEnginePoly)poly, init, lenA, aBuf);
+            crcB = crcengine_calc((tCrcEnginePoly)poly, 0, lenB, &aBuf[lenA]);
+            expCrc = crcengine_calc((tCrcEnginePoly)poly, init, lenA + lenB, aBuf);
+
+            TST_CHECK(crcengine_combine((tCrcEnginePoly)poly, crcA, crcB, lenB) == expCrc,
+                      "poly %u lenA %lu lenB %lu", poly, (unsigned long)lenA, (unsigned long)lenB);
+        }
+    }
+
+    printf("%d random splits per polynomial combined\n", TST_COMBINE_RUNS);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Update the cache with written, resized and unreported objects
+*/
+//------------------------------------------------------------------------------
+static void testUpdate(void)
+{
+    static const tTstSodShape shape = { 400, 10, 15, 0 };
+    tParamCrcStatistics stat;
+    tParamCrcStatistics lastStat;
+    UINT32          writtenLen;
+    UINT32          len;
+    UINT16          objIdx;
+    unsigned int    round;
+    unsigned int    writes;
+    unsigned int    i;
+
+    generateSod(&shape);
+
+    TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "first full pass");
+    paramcrc_getStatistics(&lastStat);
+    TST_CHECK((lastStat.fullPassCnt_m == 1) && (lastStat.segmentCnt_m > 0), "first full pass not cached");
+
+    for (round = 1; round <= TST_UPDATE_ROUNDS; round++)
+    {
+        writtenLen = 0;
+
+        if ((round % 50) == 0)
+        {
+            // Invalid checksum: The cache result is repeated with a full pass
+            paramChksum_l.aulSodCrc[random32() % EPS_NO_SOD_CRCS] ^= 0x100;
+            TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcInvalid, "round %u: invalid checksum accepted", round);
+            paramcrc_getStatistics(&stat);
+            TST_CHECK(stat.fallbackCnt_m == lastStat.fallbackCnt_m + 1, "round %u: no fallback", round);
+            updateParamChksum();
+        }
+        else if ((round % 30) == 0)
+        {
+            // Missing notification: Only the full pass finds the change
+            do
+            {
+                objIdx = writeObject(FALSE, FALSE);
+            } while ((aObject_l[objIdx].s_attr.w_attr & SOD_k_ATTR_CRC) == 0);
+            updateParamChksum();
+            TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "round %u: unreported write", round);
+            paramcrc_getStatistics(&stat);
+            TST_CHECK(stat.fallbackCnt_m == lastStat.fallbackCnt_m + 1, "round %u: no fallback", round);
+        }
+        else if ((round % 20) == 0)
+        {
+            // Changed length of a domain moves the following data
+            writeObject(TRUE, TRUE);
+            updateParamChksum();
+            TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "round %u: resized object", round);
+            paramcrc_getStatistics(&stat);
+            TST_CHECK(stat.fullPassCnt_m == lastStat.fullPassCnt_m + 1, "round %u: no full pass", round);
+        }
+        else
+        {
+            writes = 1 + (random32() % 5);
+            for (i = 0; i < writes; i++)
+            {
+                objIdx = writeObject(TRUE, FALSE);
+                if ((aObject_l[objIdx].s_attr.w_attr & SOD_k_ATTR_CRC) != 0)
+                {
+                    getData(objIdx, &len);
+                    writtenLen += len;
+                }
+            }
+
+            updateParamChksum();
+            TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "round %u: %u written objects", round, writes);
+            paramcrc_getStatistics(&stat);
+            TST_CHECK((stat.updateCnt_m == lastStat.updateCnt_m + 1) &&
+                      (stat.fullPassCnt_m == lastStat.fullPassCnt_m),
+                      "round %u: not updated from the cache", round);
+            TST_CHECK(stat.byteCnt_m <= writtenLen, "round %u: %lu bytes read for %lu written bytes",
+                      round, (unsigned long)stat.byteCnt_m, (unsigned long)writtenLen);
+        }
+
+        paramcrc_getStatistics(&lastStat);
+    }
+
+    printf("%u rounds: %lu full passes, %lu updates, %lu fallbacks, %u segments\n",
+           TST_UPDATE_ROUNDS, (unsigned long)lastStat.fullPassCnt_m, (unsigned long)lastStat.updateCnt_m,
+           (unsigned long)lastStat.fallbackCnt_m, (unsigned int)lastStat.segmentCnt_m);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Object dictionary with more segments than the cache holds
+*/
+//------------------------------------------------------------------------------
+static void testOverflow(void)
+{
+    static const tTstSodShape shape = { TST_MAX_OBJECTS, 0, 5, 0 };
+    tParamCrcStatistics stat;
+    unsigned int    round;
+
+    generateSod(&shape);
+
+    for (round = 0; round < 10; round++)
+    {
+        writeObject(TRUE, FALSE);
+        updateParamChksum();
+        TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "round %u", round);
+    }
+
+    paramcrc_getStatistics(&stat);
+    TST_CHECK((stat.fullPassCnt_m == 10) && (stat.segmentCnt_m == 0), "cache used although it is too small");
+    printf("%lu full passes without cache\n", (unsigned long)stat.fullPassCnt_m);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare the full pass with updates of a large object dictionary
+*/
+//------------------------------------------------------------------------------
+static void runBenchmark(void)
+{
+    static const tTstSodShape shape = { 4000, 3, 20, 0 };
+    static const unsigned int aWrites[] = { 1, 8, 64 };
+    tParamCrcStatistics stat;
+    UINT32          fullBytes;
+    double          startTime;
+    double          fullTime;
+    double          updateTime;
+    unsigned int    loop;
+    unsigned int    i;
+    unsigned int    n;
+
+    generateSod(&shape);
+
+    // Full pass: paramcrc_init() drops the cache
+    startTime = getTimeUs();
+    for (loop = 0; loop < TST_BENCH_LOOPS; loop++)
+    {
+        paramcrc_init();
+        TST_CHECK(runParamCrc(TRUE) == kParamCrcProcCrcValid, "full pass");
+    }
+    fullTime = (getTimeUs() - startTime) / TST_BENCH_LOOPS;
+
+    paramcrc_getStatistics(&stat);
+    fullBytes = stat.byteCnt_m;
+
+    printf("%u objects, %lu bytes CRC data, %u segments\n\n", (unsigned int)objCnt_l,
+           (unsigned long)fullBytes, (unsigned int)stat.segmentCnt_m);
+    printf("%-16s %10s %10s %12s %10s\n", "calculation", "bytes", "calls", "time [us]", "speedup");
+    printf("%-16s %10lu %10lu %12.1f %10s\n", "full pass", (unsigned long)fullBytes,
+           (unsigned long)stat.stepCnt_m, fullTime, "1.0");
+
+    for (i = 0; i < sizeof(aWrites) / sizeof(aWrites[0]); i++)
+    {
+        updateTime = 0;
+        for (loop = 0; loop < TST_BENCH_LOOPS; loop++)
+        {
+            for (n = 0; n < aWrites[i]; n++)
+                writeObject(TRUE, FALSE);
+            updateParamChksum();
+
+            startTime = getTimeUs();
+            TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "update of %u objects", aWrites[i]);
+            updateTime += getTimeUs() - startTime;
+        }
+        updateTime /= TST_BENCH_LOOPS;
+
+        paramcrc_getStatistics(&stat);
+        printf("update %3u obj   %10lu %10lu %12.1f %10.1f\n", aWrites[i], (unsigned long)stat.byteCnt_m,
+               (unsigned long)stat.stepCnt_m, updateTime, (updateTime > 0) ? fullTime / updateTime : 0.0);
+
+        if (aWrites[i] == 1)
+            TST_CHECK(stat.byteCnt_m * 50 < fullBytes, "update of one object reads too much data");
+    }
+
+    paramcrc_getStatistics(&stat);
+    TST_CHECK(stat.fallbackCnt_m == 0, "fallback during the benchmark");
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Full pass before OPERATIONAL after writes the cache does not know
+
+The cached checksum still matches 0x1018/6 after an unreported write. The
+first verification after the start reads the whole dictionary and has to find
+the change anyway.
+*/
+//------------------------------------------------------------------------------
+static void testOperational(void)
+{
+    static const tTstSodShape shape = { 400, 10, 15, 0 };
+    tParamCrcStatistics stat;
+    tParamCrcStatistics lastStat;
+    UINT16          objIdx;
+    unsigned int    round;
+
+    generateSod(&shape);
+
+    TST_CHECK(runParamCrc(TRUE) == kParamCrcProcCrcValid, "first full pass");
+
+    for (round = 0; round < 10; round++)
+    {
+        paramcrc_getStatistics(&lastStat);
+
+        // Unreported write of a CRC relevant object, 0x1018/6 is left unchanged
+        do
+        {
+            objIdx = writeObject(FALSE, FALSE);
+        } while ((aObject_l[objIdx].s_attr.w_attr & SOD_k_ATTR_CRC) == 0);
+
+        TST_CHECK(runParamCrc(TRUE) == kParamCrcProcCrcInvalid, "round %u: unreported write accepted", round);
+        paramcrc_getStatistics(&stat);
+        TST_CHECK((stat.fullPassCnt_m == lastStat.fullPassCnt_m + 1) &&
+                  (stat.updateCnt_m == lastStat.updateCnt_m),
+                  "round %u: cache used for the verification", round);
+
+        updateParamChksum();
+        TST_CHECK(runParamCrc(TRUE) == kParamCrcProcCrcValid, "round %u: updated checksum", round);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Report writes with the SOD after write callback
+
+The update only uses the cache if every CRC relevant object has the after
+write callback. A dictionary with one object without it is always read with
+a full pass.
+*/
+//------------------------------------------------------------------------------
+static void testCallback(void)
+{
+    static const tTstSodShape shape = { 400, 10, 15, 0 };
+    static const tTstSodShape noClbkShape = { 400, 10, 15, 5 };
+    SOD_t_ABORT_CODES abortCode;
+    tParamCrcStatistics stat;
+    tParamCrcStatistics lastStat;
+    UINT16          objIdx;
+    unsigned int    round;
+
+    generateSod(&shape);
+
+    TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "first full pass");
+
+    for (round = 0; round < 20; round++)
+    {
+        paramcrc_getStatistics(&lastStat);
+
+        do
+        {
+            objIdx = writeObject(FALSE, FALSE);
+        } while ((aObject_l[objIdx].s_attr.w_attr & SOD_k_ATTR_CRC) == 0);
+
+        // Only the after write service reports the write
+        abortCode = SOD_ABT_GENERAL_ERROR;
+        TST_CHECK(SAPL_SOD_ParamCrc_CLBK(SOD_k_SRV_BEFORE_WRITE, &aObject_l[objIdx], NULL, 0, 0, &abortCode) &&
+                  (abortCode == SOD_ABT_NO_ERROR), "round %u: before write rejected", round);
+        TST_CHECK(SAPL_SOD_ParamCrc_CLBK(SOD_k_SRV_AFTER_WRITE, &aObject_l[objIdx], NULL, 0, 0, &abortCode) &&
+                  (abortCode == SOD_ABT_NO_ERROR), "round %u: after write rejected", round);
+
+        updateParamChksum();
+        TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "round %u: reported write", round);
+        paramcrc_getStatistics(&stat);
+        TST_CHECK((stat.updateCnt_m == lastStat.updateCnt_m + 1) &&
+                  (stat.fullPassCnt_m == lastStat.fullPassCnt_m) &&
+                  (stat.fallbackCnt_m == lastStat.fallbackCnt_m),
+                  "round %u: write not reported by the callback", round);
+    }
+
+    // Writes of objects without callback are not reported -> No cache
+    paramcrc_init();
+    generateSod(&noClbkShape);
+
+    for (round = 0; round < 5; round++)
+    {
+        writeObject(TRUE, FALSE);
+        updateParamChksum();
+        TST_CHECK(runParamCrc(FALSE) == kParamCrcProcCrcValid, "round %u: object without callback", round);
+    }
+
+    paramcrc_getStatistics(&stat);
+    TST_CHECK((stat.fullPassCnt_m == 5) && (stat.updateCnt_m == 0) && (stat.segmentCnt_m == 0),
+              "cache used for objects without callback");
+    printf("%lu full passes without cache\n", (unsigned long)stat.fullPassCnt_m);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Generate an object dictionary
+
+\param pShape_p     Shape of the dictionary
+*/
+//------------------------------------------------------------------------------
+static void generateSod(const tTstSodShape* pShape_p)
+{
+    static const UINT8  aLen[] = { 1, 1, 2, 4, 4, 4, 8 };
+    static const EPLS_t_DATATYPE aType[] = { EPLS_k_BOOLEAN, EPLS_k_UINT8, EPLS_k_UINT16,
+                                             EPLS_k_UINT32, EPLS_k_INT32, EPLS_k_UINT32, EPLS_k_UINT64 };
+    static const EPLS_t_DATATYPE aDomType[] = { EPLS_k_DOMAIN, EPLS_k_VISIBLE_STRING, EPLS_k_OCTET_STRING };
+    SOD_t_OBJECT*   pObj;
+    UINT32          dataOffset = 0;
+    UINT32          crcLen = 0;
+    UINT32          maxLen;
+    UINT32          i;
+    unsigned int    sel;
+
+    memset(aObject_l, 0, sizeof(aObject_l));
+    memset(aDomain_l, 0, sizeof(aDomain_l));
+
+    for (objCnt_l = 0; objCnt_l < pShape_p->objCnt; objCnt_l++)
+    {
+        pObj = &aObject_l[objCnt_l];
+        pObj->w_index = (UINT16)(0x2000 + objCnt_l / 64);
+        pObj->b_subIndex = (UINT8)(objCnt_l % 64);
+
+        if ((random32() % 100) < pShape_p->domainPercent)
+        {
+            maxLen = 1 + (random32() % TST_DOMAIN_MAX);
+            pObj->s_attr.e_dataType = aDomType[random32() % 3];
+            pObj->s_attr.dw_objLen = maxLen;
+            aDomain_l[objCnt_l].dw_actLen = 1 + (random32() % maxLen);
+            aDomain_l[objCnt_l].pv_objData = &aData_l[dataOffset];
+            pObj->pv_objData = &aDomain_l[objCnt_l];
+        }
+        else
+        {
+            sel = random32() % (sizeof(aLen) / sizeof(aLen[0]));
+            maxLen = aLen[sel];
+            pObj->s_attr.e_dataType = aType[sel];
+            pObj->s_attr.dw_objLen = maxLen;
+            pObj->pv_objData = &aData_l[dataOffset];
+        }
+
+        // The CRC relevant data must fit into 0x1018/6 even if all domains grow
+        if ((dataOffset + maxLen > sizeof(aData_l)) || (crcLen + maxLen > TST_CRC_DATA_MAX))
+            break;
+
+        if ((random32() % 100) >= pShape_p->noCrcPercent)
+        {
+            pObj->s_attr.w_attr = SOD_k_ATTR_CRC;
+            if ((random32() % 100) >= pShape_p->noClbkPercent)
+                pObj->s_attr.w_attr |= SOD_k_ATTR_AFT_WR;
+            crcLen += maxLen;
+        }
+
+        for (i = 0; i < maxLen; i++)
+            aData_l[dataOffset + i] = (UINT8)random32();
+        dataOffset += maxLen;
+    }
+
+    paramChksumObj_l.w_index = 0x1018;
+    paramChksumObj_l.b_subIndex = 0x06;
+    paramChksumObj_l.s_attr.e_dataType = EPLS_k_DOMAIN;
+    paramChksumObj_l.s_attr.dw_objLen = sizeof(tParamChksum);
+    paramChksumObj_l.pv_objData = &paramChksum_l;
+
+    updateParamChksum();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Calculate 0x1018/6 over the CRC relevant objects
+*/
+//------------------------------------------------------------------------------
+static void updateParamChksum(void)
+{
+    UINT8*  pData;
+    UINT32  len;
+    UINT32  blockLen = 0;
+    UINT32  part;
+    UINT16  block = 0;
+    UINT16  i;
+
+    memset(&paramChksum_l, 0, sizeof(paramChksum_l));
+
+    for (i = 0; i < objCnt_l; i++)
+    {
+        if ((aObject_l[i].s_attr.w_attr & SOD_k_ATTR_CRC) == 0)
+            continue;
+
+        pData = getData(i, &len);
+        while (len > 0)
+        {
+            if (blockLen == TST_BLOCK_SIZE)
+            {
+                block++;
+                blockLen = 0;
+            }
+
+            part = (len > TST_BLOCK_SIZE - blockLen) ? TST_BLOCK_SIZE - blockLen : len;
+            paramChksum_l.aulSodCrc[block] = calcBitwise(32, 0x1EDC6F41UL, paramChksum_l.aulSodCrc[block],
+                                                         pData, (INT32)part);
+            pData += part;
+            len -= part;
+            blockLen += part;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Write random data to a random object
+
+\param fNotify_p    Report the write to the parameter CRC module
+\param fResize_p    Change the length of a domain
+
+\return Index of the written object
+*/
+//------------------------------------------------------------------------------
+static UINT16 writeObject(BOOLEAN fNotify_p, BOOLEAN fResize_p)
+{
+    UINT8*  pData;
+    UINT32  len;
+    UINT32  i;
+    UINT16  objIdx;
+
+    do
+    {
+        objIdx = (UINT16)(random32() % objCnt_l);
+    } while (fResize_p && ((aObject_l[objIdx].pv_objData != &aDomain_l[objIdx]) ||
+                           ((aObject_l[objIdx].s_attr.w_attr & SOD_k_ATTR_CRC) == 0) ||
+                           (aObject_l[objIdx].s_attr.dw_objLen < 2)));
+
+    if (fResize_p)
+    {
+        len = aDomain_l[objIdx].dw_actLen;
+        while (len == aDomain_l[objIdx].dw_actLen)
+            aDomain_l[objIdx].dw_actLen = 1 + (random32() % aObject_l[objIdx].s_attr.dw_objLen);
+    }
+
+    pData = getData(objIdx, &len);
+    for (i = 0; i < len; i++)
+    {
+        // At least one byte changes
+        pData[i] = (i == 0) ? (UINT8)(pData[i] + 1 + (random32() % 255)) : (UINT8)random32();
+    }
+
+    if (fNotify_p)
+        paramcrc_objectWritten(objIdx);
+
+    return objIdx;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the data of an object
+
+\param objIdx_p     Index of the object
+\param pLen_p       Length of the data
+
+\return Pointer to the data
+*/
+//------------------------------------------------------------------------------
+static UINT8* getData(UINT16 objIdx_p, UINT32* pLen_p)
+{
+    UINT8*  pData;
+
+    if (aObject_l[objIdx_p].pv_objData == &aDomain_l[objIdx_p])
+    {
+        pData = (UINT8*)aDomain_l[objIdx_p].pv_objData;
+        *pLen_p = aDomain_l[objIdx_p].dw_actLen;
+    }
+    else
+    {
+        pData = (UINT8*)aObject_l[objIdx_p].pv_objData;
+        *pLen_p = aObject_l[objIdx_p].s_attr.dw_objLen;
+    }
+
+    return pData;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run the parameter CRC calculation like the SAPL
+
+\param fFullPass_p  Read the whole dictionary like before OPERATIONAL
+
+\return Result of the calculation
+*/
+//------------------------------------------------------------------------------
+static tProcCrcRet runParamCrc(BOOLEAN fFullPass_p)
+{
+    tProcCrcRet ret;
+
+    paramcrc_startProcessing(fFullPass_p);
+    do
+    {
+        ret = paramcrc_process();
+    } while (ret == kParamCrcProcBusy);
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Calculate a CRC bit by bit (MSB first, no final XOR)
+
+\param width_p      Width of the CRC
+\param poly_p       Generator polynomial
+\param crc_p        Initial value
+\param pData_p      Data
+\param length_p     Number of bytes
+
+\return The CRC
+*/
+//------------------------------------------------------------------------------
+static UINT32 calcBitwise(UINT8 width_p, UINT32 poly_p, UINT32 crc_p,
+                          const UINT8* pData_p, INT32 length_p)
+{
+    UINT32  topBit = 1UL << (width_p - 1);
+    UINT32  mask = (topBit << 1) - 1;
+    UINT8   bit;
+
+    while (length_p-- > 0)
+    {
+        crc_p ^= (UINT32)(*pData_p++) << (width_p - 8);
+        for (bit = 0; bit < 8; bit++)
+            crc_p = ((crc_p & topBit) != 0) ? ((crc_p << 1) ^ poly_p) : (crc_p << 1);
+        crc_p &= mask;
+    }
+
+    return crc_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Reproducible pseudo random numbers
+
+\return A 32 bit random number
+*/
+//------------------------------------------------------------------------------
+static UINT32 random32(void)
+{
+    rand_l = (rand_l * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return (UINT32)((rand_l >> 16) | ((rand_l & 0xFFFFUL) << 16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Monotonic time for the benchmark
+
+\return Time in microseconds
+*/
+//------------------------------------------------------------------------------
+static double getTimeUs(void)
+{
+    return ((double)clock() * 1000000.0) / CLOCKS_PER_SEC;
+}
+
+/// \}
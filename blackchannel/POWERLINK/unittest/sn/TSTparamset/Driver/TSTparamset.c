@@ -0,0 +1,921 @@
+/**
+********************************************************************************
+\file   TSTparamset.c
+
+\brief  Harness and benchmark of the parameter set parser of the SN
+
+The harness runs the parameter set module of the SN application
+(sapl/parameterset.c) on generated parameter sets. The SOD interface of the
+openSAFETY stack is implemented on a generated object dictionary which records
+the order of the writes. The time base advances by a simulated duration of each
+SOD write.
+
+Usage: tstparamset apply|invalid|budget|bench
+
+    apply       Objects of all types written in the order of the stream
+    invalid     Invalid parameter sets are rejected before the first write
+    budget      Objects and time per call of paramset_process()
+    bench       Calls and duration of a large parameter set
+
+\ingroup module_unittests
+*******************************************************************************/
+
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sapl/parameterset.h>
+#include <sapl/parametercrc.h>
+#include <shnf/constime.h>
+
+#include <sod.h>
+#include <SODapi.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_HEADER_LEN          7               ///< Index, sub-index and length of an object
+#define TST_MAX_OBJECTS         0x1000          ///< Objects of the dictionary
+#define TST_DOMAIN_MAX          64              ///< Maximum length of a domain or string
+#define TST_SET_SIZE            (SAPL_k_MAX_PARAM_SET_LEN + 0x100)  ///< Buffer of a parameter set
+#define TST_WRITE_COST_US       50              ///< Simulated duration of a write of the budget scenario
+
+#define TST_APPLY_ROUNDS        50              ///< Parameter sets of the apply scenario
+#define TST_BENCH_LOOPS         20              ///< Parameter sets per measurement
+
+#define TST_CHECK(cond, ...)                                        \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (failCnt_l++ < 10)                                   \
+            {                                                       \
+                printf("FAILED line %d: ", __LINE__);               \
+                printf(__VA_ARGS__);                                \
+                printf("\n");                                       \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Object of the generated dictionary
+*/
+typedef struct
+{
+    UINT16      index;                      ///< Index of the object
+    UINT8       subIndex;                   ///< Sub-index of the object
+    SOD_t_ATTR  attr;                       ///< Attributes of the object
+    UINT32      actLen;                     ///< Actual length of a domain or string
+    UINT8       aData[TST_DOMAIN_MAX];      ///< Data of the object
+    UINT8       aExpect[TST_DOMAIN_MAX];    ///< Data of the object in the last parameter set
+    UINT32      expectLen;                  ///< Length of the object in the last parameter set
+    UINT32      writeSeq;                   ///< Position of the object in the write order (0: not written)
+    UINT32      streamSeq;                  ///< Position of the object in the last parameter set (0: not contained)
+    BOOLEAN     fCrcNotified;               ///< paramcrc_objectWritten() called for the object
+} tTstObject;
+
+/**
+\brief  Shape of a generated parameter set
+*/
+typedef struct
+{
+    UINT32          maxLen;             ///< Maximum length of the parameter set
+    unsigned int    domainPercent;      ///< Share of domains and strings
+} tTstSetShape;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static tTstObject       aObject_l[TST_MAX_OBJECTS];
+static UINT8            aParamSet_l[TST_SET_SIZE];
+
+static UINT32           writeCnt_l;
+static UINT32           attrGetCnt_l;
+static UINT32           writeCostUs_l;
+static UINT64           timeBase_l;
+
+static unsigned long    rand_l = 1;
+static unsigned long    failCnt_l;
+static unsigned long    errorCnt_l;
+static BOOLEAN          fExpectError_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void             testApply(void);
+static void             testInvalid(void);
+static void             testBudget(void);
+static void             runBenchmark(void);
+static void             generateSod(void);
+static UINT32           generateSet(const tTstSetShape* pShape_p, UINT32* pObjCnt_p);
+static UINT32           findObject(BOOLEAN fDomain_p);
+static BOOLEAN          isDomain(const tTstObject* pObj_p);
+static UINT8*           putObject(UINT8* pPos_p, UINT16 index_p, UINT8 subIndex_p,
+                                  UINT32 length_p);
+static void             resetRecords(void);
+static void             checkApplied(UINT32 objCnt_p);
+static tProcParamRet    runParamSet(UINT32 paramSetLen_p, UINT32* pCallCnt_p);
+static void             checkRejected(const char* pName_p, UINT32 paramSetLen_p);
+static void             putLength(UINT8* pPos_p, UINT32 length_p);
+static UINT32           random32(void);
+static double           getTimeUs(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Parameter set harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       All checks passed
+\retval 1       Invalid arguments or the module could not be initialized
+\retval 2       A check failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s apply|invalid|budget|bench\n", argv[0]);
+        return 1;
+    }
+
+    if (paramset_init() == FALSE)
+    {
+        fprintf(stderr, "Initialisation failed\n");
+        return 1;
+    }
+
+    generateSod();
+
+    if (strcmp(argv[1], "apply") == 0)
+        testApply();
+    else if (strcmp(argv[1], "invalid") == 0)
+        testInvalid();
+    else if (strcmp(argv[1], "budget") == 0)
+        testBudget();
+    else if (strcmp(argv[1], "bench") == 0)
+        runBenchmark();
+    else
+    {
+        fprintf(stderr, "Unknown scenario %s\n", argv[1]);
+        return 1;
+    }
+
+    paramset_exit();
+
+    printf("%s\n", (failCnt_l == 0) ? "PASSED" : "FAILED");
+
+    return (failCnt_l == 0) ? 0 : 2;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the SOD attribute access (binary search like the stack)
+
+\param w_idx        Index of the object
+\param b_subIdx     Sub-index of the object
+\param pdw_hdl      Handle of the object (Position in the dictionary)
+\param po_appObj    Application object flag
+\param ps_errRes    Error result (not used)
+
+\return Attributes of the object, NULL if the object does not exist
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+const SOD_t_ATTR * SOD_AttrGet(UINT16 w_idx, UINT8 b_subIdx, UINT32 * pdw_hdl,
+                               BOOLEAN * po_appObj, SOD_t_ERROR_RESULT * ps_errRes)
+{
+    const SOD_t_ATTR*   pAttr = NULL;
+    UINT32              key = ((UINT32)w_idx << 8) | b_subIdx;
+    UINT32              objKey;
+    UINT32              low = 0;
+    UINT32              high = TST_MAX_OBJECTS;
+    UINT32              mid;
+
+    UNUSED_PARAMETER(ps_errRes);
+
+    attrGetCnt_l++;
+
+    while ((low < high) && (pAttr == NULL))
+    {
+        mid = (low + high) / 2;
+        objKey = ((UINT32)aObject_l[mid].index << 8) | aObject_l[mid].subIndex;
+        if (objKey == key)
+        {
+            *pdw_hdl = mid;
+            *po_appObj = FALSE;
+            pAttr = &aObject_l[mid].attr;
+        }
+        else if (objKey < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (pAttr == NULL)
+    {
+        // The stack reports the missing object via SAPL_SERR_SignalErrorClbk()
+        errorCnt_l++;
+    }
+
+    return pAttr;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the SOD write access
+
+Basic types are copied with the length of the object, domains and strings with
+the given size. Each write advances the time base by the simulated write
+duration.
+
+\param dw_hdl       Handle of the object
+\param o_appObj     Application object flag (not used)
+\param pv_data      Data to write
+\param o_overwrite  Overwrite flag (not used)
+\param dw_offset    Offset (must be 0)
+\param dw_size      Size of a domain or string (must be 0 for basic types)
+
+\return TRUE if the write is valid
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+BOOLEAN SOD_Write(UINT32 dw_hdl, BOOLEAN o_appObj, void * pv_data, BOOLEAN o_overwrite,
+                  UINT32 dw_offset, UINT32 dw_size)
+{
+    BOOLEAN     fReturn = FALSE;
+    tTstObject* pObj;
+    UINT32      len;
+
+    UNUSED_PARAMETER(o_appObj);
+    UNUSED_PARAMETER(o_overwrite);
+
+    timeBase_l += writeCostUs_l;
+
+    if ((dw_hdl < TST_MAX_OBJECTS) && (dw_offset == 0))
+    {
+        pObj = &aObject_l[dw_hdl];
+        len = isDomain(pObj) ? dw_size : pObj->attr.dw_objLen;
+        if (len <= pObj->attr.dw_objLen)
+        {
+            MEMCOPY(pObj->aData, pv_data, len);
+            writeCnt_l++;
+            pObj->writeSeq = writeCnt_l;
+            fReturn = TRUE;
+        }
+    }
+
+    TST_CHECK(fReturn, "Invalid write of handle %lu (size %lu)",
+              (unsigned long)dw_hdl, (unsigned long)dw_size);
+
+    return fReturn;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the actual length access of domains and strings
+
+\param dw_hdl       Handle of the object
+\param o_appObj     Application object flag (not used)
+\param dw_actLen    New actual length
+
+\return TRUE if the length fits into the object
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+BOOLEAN SOD_ActualLenSet(UINT32 dw_hdl, BOOLEAN o_appObj, UINT32 dw_actLen)
+{
+    BOOLEAN fReturn = FALSE;
+
+    UNUSED_PARAMETER(o_appObj);
+
+    if ((dw_hdl < TST_MAX_OBJECTS) && (dw_actLen <= aObject_l[dw_hdl].attr.dw_objLen))
+    {
+        aObject_l[dw_hdl].actLen = dw_actLen;
+        fReturn = TRUE;
+    }
+
+    TST_CHECK(fReturn, "Invalid actual length of handle %lu", (unsigned long)dw_hdl);
+
+    return fReturn;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the written object notification of the parameter CRC
+
+\param objHdl_p     Handle of the written object
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void paramcrc_objectWritten(UINT32 objHdl_p)
+{
+    TST_CHECK((objHdl_p < TST_MAX_OBJECTS) && (aObject_l[objHdl_p].writeSeq != 0),
+              "CRC notification of handle %lu without write", (unsigned long)objHdl_p);
+
+    if (objHdl_p < TST_MAX_OBJECTS)
+        aObject_l[objHdl_p].fCrcNotified = TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the time base (simulated duration of the writes)
+
+\return Time in us
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT64 constime_getTimeBase(void)
+{
+    return timeBase_l;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the error handler
+
+Errors are only expected by the invalid scenario.
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    errorCnt_l++;
+    if (fExpectError_l == FALSE)
+    {
+        failCnt_l++;
+        printf("Fatal error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+    }
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Write random parameter sets and compare the dictionary
+*/
+//------------------------------------------------------------------------------
+static void testApply(void)
+{
+    static const tTstSetShape aShape[] =
+    {
+        { 0x80, 50 },
+        { 0x400, 0 },
+        { 0x1000, 30 },
+        { SAPL_k_MAX_PARAM_SET_LEN, 20 },
+    };
+    tParamSetStatistics stat;
+    unsigned int        round;
+    UINT32              len;
+    UINT32              objCnt;
+    UINT32              callCnt;
+
+    for (round = 0; round < TST_APPLY_ROUNDS; round++)
+    {
+        len = generateSet(&aShape[round % (sizeof(aShape) / sizeof(aShape[0]))], &objCnt);
+
+        TST_CHECK(runParamSet(len, &callCnt) == kParamProcFinished,
+                  "Round %u not finished", round);
+        checkApplied(objCnt);
+
+        paramset_getStatistics(&stat);
+        TST_CHECK(stat.setCnt_m == round + 1, "Set count %lu", (unsigned long)stat.setCnt_m);
+        TST_CHECK(stat.objectCnt_m == objCnt, "Object count %lu instead of %lu",
+                  (unsigned long)stat.objectCnt_m, (unsigned long)objCnt);
+        TST_CHECK(stat.callCnt_m == callCnt, "Call count %lu instead of %lu",
+                  (unsigned long)stat.callCnt_m, (unsigned long)callCnt);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Reject invalid parameter sets without writing to the SOD
+*/
+//------------------------------------------------------------------------------
+static void testInvalid(void)
+{
+    static const tTstSetShape   shape = { 0x200, 30 };
+    UINT32                      len;
+    UINT32                      objCnt;
+    UINT32                      callCnt;
+    UINT32                      objIdx;
+    UINT8*                      pPos;
+
+    // Header of a further object cut off by the end of the set
+    len = generateSet(&shape, &objCnt);
+    MEMSET(&aParamSet_l[len], 0, TST_HEADER_LEN);
+    checkRejected("cut header", len + TST_HEADER_LEN - 1);
+
+    // Last object longer than the rest of the set
+    len = generateSet(&shape, &objCnt);
+    objIdx = findObject(TRUE);
+    pPos = putObject(&aParamSet_l[len], aObject_l[objIdx].index, aObject_l[objIdx].subIndex, 1);
+    len = (UINT32)(pPos - aParamSet_l);
+    putLength(&aParamSet_l[len - TST_HEADER_LEN + 2], 2);
+    checkRejected("object too long for set", len);
+
+    // Object which is not in the dictionary
+    len = generateSet(&shape, &objCnt);
+    pPos = putObject(&aParamSet_l[len], 0x1FFF, 0, 4);
+    checkRejected("unknown object", (UINT32)(pPos - aParamSet_l));
+
+    // Basic type with a longer payload than the type
+    len = generateSet(&shape, &objCnt);
+    objIdx = findObject(FALSE);
+    pPos = putObject(&aParamSet_l[len], aObject_l[objIdx].index, aObject_l[objIdx].subIndex,
+                     aObject_l[objIdx].attr.dw_objLen + 1);
+    checkRejected("basic type too long", (UINT32)(pPos - aParamSet_l));
+
+    // Domain with a longer payload than the object
+    len = generateSet(&shape, &objCnt);
+    objIdx = findObject(TRUE);
+    pPos = putObject(&aParamSet_l[len], aObject_l[objIdx].index, aObject_l[objIdx].subIndex,
+                     aObject_l[objIdx].attr.dw_objLen + 1);
+    checkRejected("domain too long", (UINT32)(pPos - aParamSet_l));
+
+    // Set longer than the parameter set object
+    checkRejected("set too long", SAPL_k_MAX_PARAM_SET_LEN + 1);
+
+    // A valid set is processed after the errors
+    len = generateSet(&shape, &objCnt);
+    TST_CHECK(runParamSet(len, &callCnt) == kParamProcFinished, "Valid set not finished");
+    checkApplied(objCnt);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check the object and time budget of paramset_process()
+*/
+//------------------------------------------------------------------------------
+static void testBudget(void)
+{
+    static const tTstSetShape   shape = { SAPL_k_MAX_PARAM_SET_LEN, 20 };
+    tParamSetStatistics         stat;
+    tProcParamRet               ret;
+    UINT32                      len;
+    UINT32                      objCnt;
+    UINT32                      callCnt = 0;
+    UINT32                      stopCnt;
+    UINT32                      handled;
+    UINT32                      handledMax = 0;
+    UINT32                      writes;
+    UINT32                      writesMax = 0;
+    UINT32                      prevHandled = 0;
+    UINT32                      prevWrites = 0;
+
+    // Without write duration only the number of objects limits a call
+    len = generateSet(&shape, &objCnt);
+    do
+    {
+        ret = paramset_process(aParamSet_l, len);
+        callCnt++;
+        handled = attrGetCnt_l + writeCnt_l - prevHandled;
+        prevHandled += handled;
+        if (handled > handledMax)
+            handledMax = handled;
+    } while ((ret == kParamProcBusy) && (callCnt < 100000));
+
+    TST_CHECK(ret == kParamProcFinished, "Set not finished");
+    checkApplied(objCnt);
+    TST_CHECK(handledMax == PARAMSET_BUDGET_OBJECTS, "%lu objects in one call",
+              (unsigned long)handledMax);
+    TST_CHECK(callCnt <= (2 * objCnt) / PARAMSET_BUDGET_OBJECTS + 2,
+              "%lu calls for %lu objects", (unsigned long)callCnt, (unsigned long)objCnt);
+
+    // With the simulated write duration the time limits the writes of a call
+    paramset_getStatistics(&stat);
+    stopCnt = stat.budgetStopCnt_m;
+    writeCostUs_l = TST_WRITE_COST_US;
+    len = generateSet(&shape, &objCnt);
+    callCnt = 0;
+    do
+    {
+        ret = paramset_process(aParamSet_l, len);
+        callCnt++;
+        writes = writeCnt_l - prevWrites;
+        prevWrites += writes;
+        if (writes > writesMax)
+            writesMax = writes;
+    } while ((ret == kParamProcBusy) && (callCnt < 100000));
+    writeCostUs_l = 0;
+
+    TST_CHECK(ret == kParamProcFinished, "Set not finished");
+    checkApplied(objCnt);
+    TST_CHECK(writesMax == PARAMSET_BUDGET_US / TST_WRITE_COST_US, "%lu writes in one call",
+              (unsigned long)writesMax);
+
+    paramset_getStatistics(&stat);
+    TST_CHECK(stat.budgetStopCnt_m - stopCnt == callCnt - 1, "%lu budget stops in %lu calls",
+              (unsigned long)(stat.budgetStopCnt_m - stopCnt), (unsigned long)callCnt);
+    TST_CHECK(stat.callCnt_m == callCnt, "Call count %lu instead of %lu",
+              (unsigned long)stat.callCnt_m, (unsigned long)callCnt);
+    TST_CHECK(stat.processTime_m == objCnt * TST_WRITE_COST_US, "Process time %lu us",
+              (unsigned long)stat.processTime_m);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Measure the processing of the largest parameter set
+
+The number of calls is compared with the former parser which handled one step
+of one object per call (Header, check, attributes and write).
+*/
+//------------------------------------------------------------------------------
+static void runBenchmark(void)
+{
+    static const tTstSetShape   shape = { SAPL_k_MAX_PARAM_SET_LEN, 10 };
+    unsigned int                loop;
+    UINT32                      len = 0;
+    UINT32                      objCnt = 0;
+    UINT32                      callCnt = 0;
+    double                      startTime;
+    double                      duration = 0.0;
+
+    for (loop = 0; loop < TST_BENCH_LOOPS; loop++)
+    {
+        len = generateSet(&shape, &objCnt);
+
+        startTime = getTimeUs();
+        TST_CHECK(runParamSet(len, &callCnt) == kParamProcFinished, "Set not finished");
+        duration += getTimeUs() - startTime;
+
+        checkApplied(objCnt);
+    }
+
+    printf("Parameter set of %lu bytes with %lu objects\n",
+           (unsigned long)len, (unsigned long)objCnt);
+    printf("  calls:       %lu (one step per call: %lu)\n",
+           (unsigned long)callCnt, (unsigned long)(4 * objCnt + 2));
+    printf("  duration:    %.1f us per set\n", duration / TST_BENCH_LOOPS);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Generate the dictionary sorted by index and sub-index
+
+The type of an object is given by its position, the maximum length of the
+domains and strings is random.
+*/
+//------------------------------------------------------------------------------
+static void generateSod(void)
+{
+    static const EPLS_t_DATATYPE aType[] =
+    {
+        EPLS_k_BOOLEAN, EPLS_k_UINT8, EPLS_k_UINT16, EPLS_k_UINT32,
+        EPLS_k_UINT64, EPLS_k_DOMAIN, EPLS_k_VISIBLE_STRING, EPLS_k_OCTET_STRING
+    };
+    static const UINT32 aLen[] = { 1, 1, 2, 4, 8, 0, 0, 0 };
+    UINT32              i;
+
+    for (i = 0; i < TST_MAX_OBJECTS; i++)
+    {
+        aObject_l[i].index = (UINT16)(0x2000 + i / 16);
+        aObject_l[i].subIndex = (UINT8)(i % 16 + 1);
+        aObject_l[i].attr.e_dataType = aType[i % 8];
+        aObject_l[i].attr.dw_objLen = aLen[i % 8];
+        if (aObject_l[i].attr.dw_objLen == 0)
+            aObject_l[i].attr.dw_objLen = random32() % TST_DOMAIN_MAX + 1;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Generate a parameter set of different objects in random order
+
+\param pShape_p     Shape of the parameter set
+\param pObjCnt_p    Number of objects in the set
+
+\return Length of the parameter set
+*/
+//------------------------------------------------------------------------------
+static UINT32 generateSet(const tTstSetShape* pShape_p, UINT32* pObjCnt_p)
+{
+    tTstObject* pObj;
+    UINT8*      pPos = aParamSet_l;
+    UINT32      len;
+    UINT32      objCnt = 0;
+
+    resetRecords();
+
+    for (;;)
+    {
+        pObj = &aObject_l[findObject((random32() % 100) < pShape_p->domainPercent)];
+
+        // Domains and strings are written with at least one byte
+        if (isDomain(pObj))
+            len = random32() % pObj->attr.dw_objLen + 1;
+        else
+            len = pObj->attr.dw_objLen;
+
+        if ((UINT32)(pPos - aParamSet_l) + TST_HEADER_LEN + len > pShape_p->maxLen)
+            break;
+
+        pPos = putObject(pPos, pObj->index, pObj->subIndex, len);
+        MEMCOPY(pObj->aExpect, pPos - len, len);
+        pObj->expectLen = len;
+        objCnt++;
+        pObj->streamSeq = objCnt;
+    }
+
+    *pObjCnt_p = objCnt;
+
+    return (UINT32)(pPos - aParamSet_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Find a random object which is not in the current parameter set
+
+\param fDomain_p    TRUE for a domain or string, FALSE for a basic type
+
+\return Position of the object in the dictionary
+*/
+//------------------------------------------------------------------------------
+static UINT32 findObject(BOOLEAN fDomain_p)
+{
+    UINT32  objIdx;
+
+    do
+    {
+        objIdx = random32() % TST_MAX_OBJECTS;
+    } while ((aObject_l[objIdx].streamSeq != 0) || (isDomain(&aObject_l[objIdx]) != fDomain_p));
+
+    return objIdx;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check if an object is a domain or string
+
+\param pObj_p   The object
+
+\return TRUE for a domain or string
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN isDomain(const tTstObject* pObj_p)
+{
+    return (pObj_p->attr.e_dataType == EPLS_k_DOMAIN) ||
+           (pObj_p->attr.e_dataType == EPLS_k_VISIBLE_STRING) ||
+           (pObj_p->attr.e_dataType == EPLS_k_OCTET_STRING);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Append an object with random payload to a parameter set
+
+\param pPos_p       Position of the object in the set
+\param index_p      Index of the object
+\param subIndex_p   Sub-index of the object
+\param length_p     Length of the payload
+
+\return Position after the object
+*/
+//------------------------------------------------------------------------------
+static UINT8* putObject(UINT8* pPos_p, UINT16 index_p, UINT8 subIndex_p,
+                        UINT32 length_p)
+{
+    UINT32  i;
+
+    pPos_p[0] = (UINT8)index_p;
+    pPos_p[1] = (UINT8)(index_p >> 8);
+    pPos_p[2] = subIndex_p;
+    putLength(&pPos_p[3], length_p);
+    pPos_p += TST_HEADER_LEN;
+
+    for (i = 0; i < length_p; i++)
+        *pPos_p++ = (UINT8)random32();
+
+    return pPos_p;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Write the length field of an object header (little endian)
+
+\param pPos_p       Position of the length field
+\param length_p     Length of the payload
+*/
+//------------------------------------------------------------------------------
+static void putLength(UINT8* pPos_p, UINT32 length_p)
+{
+    pPos_p[0] = (UINT8)length_p;
+    pPos_p[1] = (UINT8)(length_p >> 8);
+    pPos_p[2] = (UINT8)(length_p >> 16);
+    pPos_p[3] = (UINT8)(length_p >> 24);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Reset the write records of the dictionary
+*/
+//------------------------------------------------------------------------------
+static void resetRecords(void)
+{
+    UINT32  i;
+
+    for (i = 0; i < TST_MAX_OBJECTS; i++)
+    {
+        aObject_l[i].writeSeq = 0;
+        aObject_l[i].streamSeq = 0;
+        aObject_l[i].fCrcNotified = FALSE;
+    }
+
+    writeCnt_l = 0;
+    attrGetCnt_l = 0;
+    errorCnt_l = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare the dictionary with the last parameter set
+
+All objects of the set have to be written in the order of the stream with the
+data of the set and notified to the parameter CRC, no other object is written.
+
+\param objCnt_p     Number of objects in the set
+*/
+//------------------------------------------------------------------------------
+static void checkApplied(UINT32 objCnt_p)
+{
+    tTstObject* pObj;
+    UINT32      i;
+
+    TST_CHECK(writeCnt_l == objCnt_p, "%lu writes for %lu objects",
+              (unsigned long)writeCnt_l, (unsigned long)objCnt_p);
+
+    for (i = 0; i < TST_MAX_OBJECTS; i++)
+    {
+        pObj = &aObject_l[i];
+        TST_CHECK(pObj->writeSeq == pObj->streamSeq, "Object 0x%x/%u written at %lu instead of %lu",
+                  pObj->index, pObj->subIndex, (unsigned long)pObj->writeSeq,
+                  (unsigned long)pObj->streamSeq);
+
+        if (pObj->streamSeq != 0)
+        {
+            TST_CHECK(memcmp(pObj->aData, pObj->aExpect, pObj->expectLen) == 0,
+                      "Data of object 0x%x/%u", pObj->index, pObj->subIndex);
+            TST_CHECK(!isDomain(pObj) || (pObj->actLen == pObj->expectLen),
+                      "Actual length of object 0x%x/%u", pObj->index, pObj->subIndex);
+            TST_CHECK(pObj->fCrcNotified, "Object 0x%x/%u not notified",
+                      pObj->index, pObj->subIndex);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Process a parameter set like the SAPL
+
+\param paramSetLen_p    Length of the parameter set
+\param pCallCnt_p       Calls of paramset_process()
+
+\return Result of the last call
+*/
+//------------------------------------------------------------------------------
+static tProcParamRet runParamSet(UINT32 paramSetLen_p, UINT32* pCallCnt_p)
+{
+    tProcParamRet   ret;
+    UINT32          callCnt = 0;
+
+    do
+    {
+        ret = paramset_process(aParamSet_l, paramSetLen_p);
+        callCnt++;
+    } while ((ret == kParamProcBusy) && (callCnt < 100000));
+
+    *pCallCnt_p = callCnt;
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check that an invalid parameter set is rejected before the first write
+
+\param pName_p          Name of the case
+\param paramSetLen_p    Length of the parameter set
+*/
+//------------------------------------------------------------------------------
+static void checkRejected(const char* pName_p, UINT32 paramSetLen_p)
+{
+    UINT32  callCnt;
+
+    errorCnt_l = 0;
+    writeCnt_l = 0;
+    fExpectError_l = TRUE;
+
+    TST_CHECK(runParamSet(paramSetLen_p, &callCnt) == kParamProcError, "%s: not rejected", pName_p);
+    TST_CHECK(errorCnt_l != 0, "%s: no error reported", pName_p);
+    TST_CHECK(writeCnt_l == 0, "%s: %lu objects written", pName_p, (unsigned long)writeCnt_l);
+
+    fExpectError_l = FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Reproducible pseudo random numbers
+
+\return A 32 bit random number
+*/
+//------------------------------------------------------------------------------
+static UINT32 random32(void)
+{
+    rand_l = (rand_l * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return (UINT32)((rand_l >> 16) | ((rand_l & 0xFFFFUL) << 16));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Monotonic time for the benchmark
+
+\return Time in microseconds
+*/
+//------------------------------------------------------------------------------
+static double getTimeUs(void)
+{
+    return ((double)clock() * 1000000.0) / CLOCKS_PER_SEC;
+}
+
+/// \}
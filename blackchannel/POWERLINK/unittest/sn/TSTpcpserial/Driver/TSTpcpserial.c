@@ -0,0 +1,342 @@
+/**
+********************************************************************************
+\file   TSTpcpserial.c
+
+\brief  Harness of the PCP serial mock of the x86 target
+
+The harness calls pcpserial_transfer() of the PCP serial mock
+(target/x86/pcpserial-mock.c) with a fixed cycle time like the sync interrupt
+of the SN. The mock runs on its virtual clock, the harness advances it by one
+cycle time after each start and the simulated DMA finishes within this step.
+The counts do not depend on the load of the host. The latency of the
+simulated DMA selects the path:
+- normal: the transfer is finished long before the next cycle
+- late: the transfer overlaps one cycle, every second start is skipped
+- timeout: the transfer is stuck and is aborted after PCPSERIAL_TIMEOUT_CYCLES
+  overlapping starts
+- error: the simulated DMA reports an error
+
+Usage: tstpcpserial normal|late|timeout|error
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <apptarget/pcpserialmock.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_CYCLE_US            2000    ///< Cycle time of the transfer starts
+#define TST_CYCLES              40      ///< Transfer starts of a run
+#define TST_IMAGE_SIZE          64      ///< Size of the process images
+#define TST_IDLE_TIMEOUT_US     100000  ///< Virtual time to wait for the last transfer
+
+#define TST_NORMAL_LATENCY_US   100                     ///< Finished within the cycle
+#define TST_LATE_LATENCY_US     (TST_CYCLE_US * 3 / 2)  ///< Finished in the next cycle
+#define TST_STUCK_LATENCY_US    (TST_CYCLE_US * 100)    ///< Never finished in time
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static UINT8            aConsImage_l[TST_IMAGE_SIZE];
+static UINT8            aProdImage_l[TST_IMAGE_SIZE];
+static UINT32           finishCnt_l;
+static UINT32           timeoutCnt_l;
+static UINT32           errorCnt_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static int  runCycles(UINT32 latencyUs_p, tPcpSerialMockStat* pStat_p, tPcpSerialStat* pSerialStat_p);
+static int  checkImages(void);
+static void transferFinished(void);
+static void transferError(tPcpSerialError error_p);
+static int  check(const char* pName_p, unsigned long value_p, unsigned long expected_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    PCP serial harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       Run finished and all checks passed
+\retval 1       Invalid arguments or the serial could not be started
+\retval 2       A check of the run failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    tPcpSerialMockStat  stat;
+    tPcpSerialStat      serialStat;
+    const char*         pScenario;
+    int                 fail = 0;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s normal|late|timeout|error\n", argv[0]);
+        return 1;
+    }
+
+    pScenario = argv[1];
+
+    if (strcmp(pScenario, "normal") == 0)
+    {
+        if (runCycles(TST_NORMAL_LATENCY_US, &stat, &serialStat) != 0)
+            return 1;
+
+        fail += check("finished transfers", stat.finishCnt_m, TST_CYCLES);
+        fail += check("skipped starts", serialStat.skipCnt_m, 0);
+        fail += check("timeouts", serialStat.timeoutCnt_m, 0);
+        fail += check("finished callbacks", finishCnt_l, TST_CYCLES);
+        fail += check("error callbacks", errorCnt_l + timeoutCnt_l, 0);
+        fail += checkImages();
+    }
+    else if (strcmp(pScenario, "late") == 0)
+    {
+        // Every transfer overlaps the next start, the start after it begins a new one
+        if (runCycles(TST_LATE_LATENCY_US, &stat, &serialStat) != 0)
+            return 1;
+
+        fail += check("started transfers", stat.startCnt_m, TST_CYCLES / 2);
+        fail += check("skipped starts", serialStat.skipCnt_m, TST_CYCLES / 2);
+        fail += check("mock skipped starts", stat.skipCnt_m, serialStat.skipCnt_m);
+        fail += check("timeouts", serialStat.timeoutCnt_m, 0);
+        fail += check("finished callbacks", finishCnt_l, TST_CYCLES / 2);
+        fail += check("error callbacks", errorCnt_l + timeoutCnt_l, 0);
+        fail += checkImages();
+    }
+    else if (strcmp(pScenario, "timeout") == 0)
+    {
+        // Start, (PCPSERIAL_TIMEOUT_CYCLES - 1) skipped starts, abort and restart
+        if (runCycles(TST_STUCK_LATENCY_US, &stat, &serialStat) != 0)
+            return 1;
+
+        fail += check("timeouts", serialStat.timeoutCnt_m, (TST_CYCLES - 1) / PCPSERIAL_TIMEOUT_CYCLES);
+        fail += check("timeout callbacks", timeoutCnt_l, serialStat.timeoutCnt_m);
+        fail += check("skipped starts", serialStat.skipCnt_m,
+                      TST_CYCLES - 1 - serialStat.timeoutCnt_m);
+        fail += check("finished callbacks", finishCnt_l, 0);
+        fail += check("error callbacks", errorCnt_l, 0);
+    }
+    else if (strcmp(pScenario, "error") == 0)
+    {
+        pcpserialmock_injectError(TST_CYCLES / 4);
+
+        if (runCycles(TST_NORMAL_LATENCY_US, &stat, &serialStat) != 0)
+            return 1;
+
+        fail += check("error callbacks", errorCnt_l, TST_CYCLES / 4);
+        fail += check("finished callbacks", finishCnt_l, TST_CYCLES - (TST_CYCLES / 4));
+        fail += check("skipped starts", serialStat.skipCnt_m, 0);
+        fail += check("timeouts", timeoutCnt_l, 0);
+        fail += checkImages();
+    }
+    else
+    {
+        fprintf(stderr, "Unknown scenario %s\n", pScenario);
+        return 1;
+    }
+
+    printf("%lu starts, %lu finished, %lu skipped, %lu timeouts, %lu errors, "
+           "%llu us in the background\n",
+           (unsigned long)stat.startCnt_m, (unsigned long)stat.finishCnt_m,
+           (unsigned long)serialStat.skipCnt_m, (unsigned long)serialStat.timeoutCnt_m,
+           (unsigned long)stat.errorCnt_m, (unsigned long long)(stat.dmaTimeNs_m / 1000));
+    printf("%s\n", (fail == 0) ? "PASSED" : "FAILED");
+
+    return (fail == 0) ? 0 : 2;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Start a transfer in every cycle
+
+Each cycle starts a transfer and advances the virtual clock of the mock by the
+cycle time. After the last cycle the harness lets the running transfer finish
+and stops the serial.
+
+\param[in]  latencyUs_p     Latency of the simulated DMA
+\param[out] pStat_p         Returns the statistics of the mock
+\param[out] pSerialStat_p   Returns the statistics of the serial interface
+
+\return int
+\retval 0       Run finished
+\retval -1      Serial could not be started or a start failed
+*/
+//------------------------------------------------------------------------------
+static int runCycles(UINT32 latencyUs_p, tPcpSerialMockStat* pStat_p, tPcpSerialStat* pSerialStat_p)
+{
+    tHandlerParam       param;
+    unsigned int        i;
+    int                 ret = 0;
+
+    memset(aConsImage_l, 0, sizeof(aConsImage_l));
+    for (i = 0; i < TST_IMAGE_SIZE; i++)
+        aProdImage_l[i] = (UINT8)(i + 1);
+
+    param.consDesc_m.pBuffBase_m = aConsImage_l;
+    param.consDesc_m.buffSize_m = TST_IMAGE_SIZE;
+    param.prodDesc_m.pBuffBase_m = aProdImage_l;
+    param.prodDesc_m.buffSize_m = TST_IMAGE_SIZE;
+
+    pcpserialmock_useVirtualClock(TRUE);
+
+    if (!pcpserial_init(&param, transferFinished, transferError))
+        return -1;
+
+    pcpserialmock_setLatency(latencyUs_p);
+
+    for (i = 0; i < TST_CYCLES; i++)
+    {
+        if (!pcpserial_transfer(&param))
+            ret = -1;
+
+        pcpserialmock_advanceTime(TST_CYCLE_US);
+    }
+
+    if (latencyUs_p < TST_IDLE_TIMEOUT_US)
+        (void)pcpserialmock_waitIdle(TST_IDLE_TIMEOUT_US);
+
+    pcpserialmock_getStatistics(pStat_p);
+    pcpserial_getStatistics(pSerialStat_p);
+
+    pcpserial_exit();
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check that the images were exchanged
+
+\return The function returns the number of failed checks.
+*/
+//------------------------------------------------------------------------------
+static int checkImages(void)
+{
+    UINT8   aPcpImage[TST_IMAGE_SIZE];
+    UINT16  size;
+    int     fail = 0;
+
+    size = pcpserialmock_getPcpImage(aPcpImage, sizeof(aPcpImage));
+    fail += check("image size received by the PCP", size, TST_IMAGE_SIZE);
+    fail += check("image received by the PCP", memcmp(aPcpImage, aProdImage_l, size) == 0, 1);
+
+    return fail;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Transfer finished callback
+*/
+//------------------------------------------------------------------------------
+static void transferFinished(void)
+{
+    finishCnt_l++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Transfer error callback
+
+\param[in] error_p      Type of the transfer error
+*/
+//------------------------------------------------------------------------------
+static void transferError(tPcpSerialError error_p)
+{
+    if (error_p == kPcpSerialErrorTimeout)
+        timeoutCnt_l++;
+    else
+        errorCnt_l++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare a value with the expected one
+
+\return The function returns 1 if the values differ, otherwise 0.
+*/
+//------------------------------------------------------------------------------
+static int check(const char* pName_p, unsigned long value_p, unsigned long expected_p)
+{
+    if (value_p == expected_p)
+        return 0;
+
+    printf("FAILED: %s %lu, expected %lu\n", pName_p, value_p, expected_p);
+    return 1;
+}
@@ -0,0 +1,92 @@
+/**
+********************************************************************************
+\file   libpsi/psi.h
+
+\brief  Stub of the slim interface library header
+
+The PCP serial interface (common/pcpserial.h) only needs the descriptors of
+the transfer buffers. The stub provides them with the base types of the x86
+target, so the PCP serial mock builds without the generated triple buffer
+configuration of the PSI library.
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+#ifndef _INC_libpsi_psi_H_
+#define _INC_libpsi_psi_H_
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TRUE                    1
+#define FALSE                   0
+
+#define UNUSED_PARAMETER(par)   (void)par
+
+//------------------------------------------------------------------------------
+// typedef
+//------------------------------------------------------------------------------
+typedef uint8_t     BOOL;
+typedef uint8_t     UINT8;
+typedef uint16_t    UINT16;
+typedef uint32_t    UINT32;
+typedef uint64_t    UINT64;
+
+/**
+\brief  Descriptor of a transfer buffer
+*/
+typedef struct
+{
+    UINT8*      pBuffBase_m;        ///< Base address of the buffer
+    UINT16      buffSize_m;         ///< Size of the buffer
+} tBuffDescriptor;
+
+/**
+\brief  Buffers of a serial transfer
+*/
+typedef struct
+{
+    tBuffDescriptor consDesc_m;     ///< Descriptor of the incoming consuming payload
+    tBuffDescriptor prodDesc_m;     ///< Descriptor of the outgoing producing payload
+} tHandlerParam;
+
+#endif /* _INC_libpsi_psi_H_ */
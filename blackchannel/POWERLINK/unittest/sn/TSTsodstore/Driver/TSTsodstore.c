@@ -0,0 +1,1092 @@
+/**
+********************************************************************************
+\file   TSTsodstore.c
+
+\brief  Harness and benchmark of the SOD store of the SN
+
+The harness runs the SOD store of the SN application (sapl/sodstore.c) on the
+file backed NVS model of the x86 target (target/x86/nvs-file.c). The model
+advances the system timer mock by the program and erase time, which is the
+time base of the harness. The background loop calls the store like
+sapl_process(). A sync interrupt which falls into a flash write is delayed
+until the write is finished like by the CPU stall on the target.
+
+The benchmark also runs the former writer (8 bytes per call) on the same model
+to compare the store time and the delayed sync interrupts.
+
+A power cut is simulated by closing the store in the middle of a store and
+opening it again on the same backing file.
+
+Usage: tstsodstore store|restart|budget|banks|journal|wear|bench
+
+    store       Store and verify an image with and without a known cycle time
+    restart     Keep an image in a file over a restart and replace it
+    budget      Slow flash, too short cycles and a flash slower than nominal
+    banks       Alternating banks, power cuts and a corrupted bank
+    journal     Small changes in the journal, a torn entry and a full journal
+    wear        Sector erases of a sequence of stores
+    bench       Store time of several flash types and cycle times
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sapl/sodstore.h>
+#include <sn/nvs.h>
+#include <sn/nvsfile.h>
+#include <sn/timermock.h>
+#include <sn/cyclemon.h>
+#include <shnf/constime.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length, const void *pv_data);
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_CRC32_POLY          0x1EDC6F41UL    ///< Polynomial of the parameter CRC
+#define TST_PARAM_SET_LEN       5001            ///< Length of the stored parameter set
+#define TST_PARAM_SET_MAX       16384           ///< Buffer of the parameter set
+#define TST_FIXED_CHUNK_SIZE    8               ///< Chunk of the former writer
+#define TST_IMG_OFFSET_DATA     0x10            ///< Offset of the data in the image
+#define TST_JOURNAL_LEN         400             ///< Length of the parameter set of the journal scenarios
+#define TST_JOURNAL_ENTRY_MAX   64              ///< Maximum length of a journal entry of the store
+#define TST_JOURNAL_CHANGES     20              ///< Small changes of the journal scenario
+#define TST_WEAR_STORES         100             ///< Stores of the wear scenario
+#define TST_WEAR_FULL_PERIOD    10              ///< Every n-th store of the wear scenario changes all data
+#define TST_LOOP_TIME           5               ///< Time of the rest of the background loop in us
+#define TST_SYNC_TIME           150             ///< Time of the sync interrupt in us
+#define TST_MAX_CYCLES          1000000         ///< Cycles until a store is aborted
+#define TST_NVS_FILE_FMT        "tstsodstore_%s.nvs"    ///< Backing file of a scenario (one per scenario for parallel runs)
+
+#define TST_CHECK(cond, ...)                                        \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (failCnt_l++ < 10)                                   \
+            {                                                       \
+                printf("FAILED line %d: ", __LINE__);               \
+                printf(__VA_ARGS__);                                \
+                printf("\n");                                       \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Result of one store run
+*/
+typedef struct
+{
+    tProcStoreRet   ret;            ///< Last return value of the store
+    UINT32          cycleCnt;       ///< Cycles of the store
+    UINT32          callCnt;        ///< Calls of the store
+    UINT32          lateCnt;        ///< Sync interrupts delayed by a flash write
+    UINT32          lateMax;        ///< Longest delay of a sync interrupt in us
+    UINT32          storeTime;      ///< Time of the store in us
+} tTstResult;
+
+/**
+\brief  Flash type of the benchmark
+*/
+typedef struct
+{
+    const char*     pName;          ///< Name of the flash
+    tNvsFileConfig  config;         ///< Configuration of the NVS model
+} tTstFlash;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+
+// The storages hold two banks. The stm32f103 model is larger than on the
+// target as a bank has to hold the parameter set of the harness.
+static const tTstFlash aFlash_l[] =
+{
+    { "stm32f103",  { NULL, 0x4000, 0x400, 2, 1024, 53, 5, 20000 } },
+    { "stm32f401",  { NULL, 0x40000, 0x20000, 4, 256, 16, 2, 1000000 } },
+    { "cfi-nios2",  { NULL, 0x40000, 0x20000, 2, 32, 60, 40, 700000 } },
+};
+
+static const UINT32 aCycleTime_l[] = { 500, 1000, 2000 };
+
+static UINT8            aParamSet_l[TST_PARAM_SET_MAX];
+static UINT8            aSavedSet_l[TST_PARAM_SET_MAX];
+static UINT32           cycleTime_l;
+static UINT64           cycleStart_l;
+static UINT32           nextSync_l;
+static UINT32           fixedOffs_l;
+static unsigned long    rand_l = 1;
+static unsigned long    failCnt_l;
+static char             aNvsFile_l[64];
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void             testStore(void);
+static void             testRestart(void);
+static void             testBudget(void);
+static void             testBanks(void);
+static void             testJournal(void);
+static void             testWear(void);
+static void             runBenchmark(void);
+static void             openStore(const tNvsFileConfig* pConfig_p);
+static void             runStore(UINT32 len_p, BOOLEAN fFixedChunk_p, tTstResult* pResult_p);
+static tProcStoreRet    processFixedChunk(UINT32 len_p);
+static BOOLEAN          interruptStore(UINT32 len_p, UINT32 byteCnt_p);
+static void             serveSync(BOOLEAN fInWrite_p, tTstResult* pResult_p);
+static void             checkImage(UINT32 len_p);
+static UINT32           getImageBank(void);
+static void             fillParamSet(UINT32 len_p);
+static void             changeParamSet(UINT32 len_p, UINT32 changeCnt_p);
+static UINT32           random32(void);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    SOD store harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       All checks passed
+\retval 1       Invalid arguments
+\retval 2       A check failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s store|restart|budget|banks|journal|wear|bench\n", argv[0]);
+        return 1;
+    }
+
+    (void)snprintf(aNvsFile_l, sizeof(aNvsFile_l), TST_NVS_FILE_FMT, argv[1]);
+
+    // 32 bit time base without wrap interrupt
+    timermock_setMode(32, FALSE);
+    (void)timer_init();
+
+    if (strcmp(argv[1], "store") == 0)
+        testStore();
+    else if (strcmp(argv[1], "restart") == 0)
+        testRestart();
+    else if (strcmp(argv[1], "budget") == 0)
+        testBudget();
+    else if (strcmp(argv[1], "banks") == 0)
+        testBanks();
+    else if (strcmp(argv[1], "journal") == 0)
+        testJournal();
+    else if (strcmp(argv[1], "wear") == 0)
+        testWear();
+    else if (strcmp(argv[1], "bench") == 0)
+        runBenchmark();
+    else
+    {
+        fprintf(stderr, "Unknown scenario %s\n", argv[1]);
+        return 1;
+    }
+
+    // A failed check may leave the backing file behind
+    (void)remove(aNvsFile_l);
+
+    printf("%s\n", (failCnt_l == 0) ? "PASSED" : "FAILED");
+
+    return (failCnt_l == 0) ? 0 : 2;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Parameter CRC calculated bit by bit like HNFiff_Crc32CalcSwp() in
+          sapl.c (MSB first, no final XOR)
+
+\param w_initCrc    Initial value of the CRC
+\param l_length     Number of bytes
+\param pv_data      Pointer to the data
+
+\return The CRC32
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT32 HNFiff_Crc32CalcSwp(UINT32 w_initCrc, INT32 l_length, const void *pv_data)
+{
+    const UINT8*    pData = (const UINT8*)pv_data;
+    UINT32          crc = w_initCrc;
+    INT32           i;
+    int             bit;
+
+    for (i = 0; i < l_length; i++)
+    {
+        crc ^= ((UINT32)pData[i]) << 24;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80000000UL) ? ((crc << 1) ^ TST_CRC32_POLY) : (crc << 1);
+    }
+
+    return crc;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the time base of the SHNF on the timer mock
+
+\return The time base in us
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT64 constime_getTimeBase(void)
+{
+    return (UINT64)timer_getTickCount();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the cycle monitoring
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT32 cyclemon_getCycleTime(void)
+{
+    return cycleTime_l;
+}
+
+UINT64 cyclemon_getCycleStart(void)
+{
+    return cycleStart_l;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the error handler
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postMinorError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Minor error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Fatal error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Store an image with the default flash of the model
+*/
+//------------------------------------------------------------------------------
+static void testStore(void)
+{
+    tTstResult          result;
+    tSodStoreStatistics stat;
+    tNvsFileStat        nvsStat;
+    tNvsGeometry        geometry;
+
+    openStore(&aFlash_l[1].config);
+    nvs_getGeometry(&geometry);
+
+    cycleTime_l = 1000;
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    sodstore_getStatistics(&stat);
+    nvsfile_getStatistics(&nvsStat);
+
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN);
+
+    TST_CHECK(result.lateCnt == 0, "%lu sync interrupts delayed (max %lu us)",
+              (unsigned long)result.lateCnt, (unsigned long)result.lateMax);
+    TST_CHECK(stat.budgetOverrunCnt_m == 0, "%lu budget overruns",
+              (unsigned long)stat.budgetOverrunCnt_m);
+    TST_CHECK(stat.byteCnt_m == TST_PARAM_SET_LEN, "%lu bytes written",
+              (unsigned long)stat.byteCnt_m);
+    TST_CHECK(stat.burstLenMax_m <= geometry.pageSize_m, "burst of %lu bytes",
+              (unsigned long)stat.burstLenMax_m);
+    TST_CHECK(nvsStat.pageCrossCnt_m == 0, "%lu page boundaries crossed",
+              (unsigned long)nvsStat.pageCrossCnt_m);
+    TST_CHECK(nvsStat.progErrorCnt_m == 0, "%lu program errors",
+              (unsigned long)nvsStat.progErrorCnt_m);
+
+    printf("cycle %lu us: %lu cycles, %lu bursts, max burst %lu bytes, store time %lu us\n",
+           (unsigned long)cycleTime_l, (unsigned long)result.cycleCnt,
+           (unsigned long)stat.burstCnt_m, (unsigned long)stat.burstLenMax_m,
+           (unsigned long)stat.storeTime_m);
+
+    // Without a known cycle time the store writes with the default budget
+    TST_CHECK(sodstore_prepareStorage() != FALSE, "erase failed");
+    cycleTime_l = 0;
+    runStore(TST_PARAM_SET_LEN - 17, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store without cycle returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN - 17);
+
+    sodstore_close();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Keep the image in the backing file over a restart
+*/
+//------------------------------------------------------------------------------
+static void testRestart(void)
+{
+    tNvsFileConfig  config = aFlash_l[1].config;
+    tTstResult      result;
+    UINT8*          pBase;
+    UINT32          len;
+
+    (void)remove(aNvsFile_l);
+    config.pFileName_m = aNvsFile_l;
+    cycleTime_l = 1000;
+
+    openStore(&config);
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store returned %d", result.ret);
+    sodstore_close();
+
+    // Restart: The image is restored from the file
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    checkImage(TST_PARAM_SET_LEN);
+
+    // A new parameter set replaces the image on the next boot
+    fillParamSet(TST_PARAM_SET_LEN);
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "second store returned %d", result.ret);
+    sodstore_close();
+
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    checkImage(TST_PARAM_SET_LEN);
+
+    // Erase: No image on the next boot
+    TST_CHECK(sodstore_prepareStorage() != FALSE, "erase failed");
+    TST_CHECK(sodstore_getSodImage(&pBase, &len) == FALSE, "erased image accepted");
+    sodstore_close();
+
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    TST_CHECK(sodstore_getSodImage(&pBase, &len) == FALSE, "erase not kept in the file");
+
+    // Store again
+    fillParamSet(TST_PARAM_SET_LEN);
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store after erase returned %d", result.ret);
+    sodstore_close();
+
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    checkImage(TST_PARAM_SET_LEN);
+    sodstore_close();
+
+    (void)remove(aNvsFile_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Store with a slow flash, too short cycles and a flash slower than
+          the nominal program time
+*/
+//------------------------------------------------------------------------------
+static void testBudget(void)
+{
+    tNvsFileConfig      config = aFlash_l[0].config;
+    tTstResult          result;
+    tSodStoreStatistics stat;
+    UINT32              nominalEst;
+
+    // Slow flash: The bursts follow the budget of each cycle
+    openStore(&config);
+    cycleTime_l = 1000;
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    sodstore_getStatistics(&stat);
+    nominalEst = stat.accessTimeEst_m;
+
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN);
+    TST_CHECK(result.lateCnt == 0, "%lu sync interrupts delayed (max %lu us)",
+              (unsigned long)result.lateCnt, (unsigned long)result.lateMax);
+    TST_CHECK(stat.forcedWriteCnt_m == 0, "%lu forced writes", (unsigned long)stat.forcedWriteCnt_m);
+    sodstore_close();
+
+    // No budget left after the sync interrupt: Single forced bursts and
+    // forced writes of the header, the CRC and the sequence number
+    openStore(&config);
+    cycleTime_l = TST_SYNC_TIME + 50;
+    runStore(600, FALSE, &result);
+    sodstore_getStatistics(&stat);
+
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store without budget returned %d", result.ret);
+    checkImage(600);
+    TST_CHECK(stat.forcedWriteCnt_m == stat.processCnt_m + 3, "%lu of %lu writes forced",
+              (unsigned long)stat.forcedWriteCnt_m, (unsigned long)stat.processCnt_m);
+    TST_CHECK(result.cycleCnt > stat.forcedWriteCnt_m, "%lu forced writes in %lu cycles",
+              (unsigned long)stat.forcedWriteCnt_m, (unsigned long)result.cycleCnt);
+    sodstore_close();
+
+    // Flash three times slower than nominal: The estimate follows after the
+    // first burst, which may overrun into the cycle after the next one
+    openStore(&config);
+    config.progTime_m *= 3;
+    nvsfile_setConfig(&config);
+    cycleTime_l = 2000;
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    sodstore_getStatistics(&stat);
+
+    TST_CHECK(result.ret == kSodStoreProcFinished, "slow store returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN);
+    TST_CHECK(stat.budgetOverrunCnt_m <= 1, "%lu budget overruns", (unsigned long)stat.budgetOverrunCnt_m);
+    TST_CHECK(result.lateCnt <= 2, "%lu sync interrupts delayed", (unsigned long)result.lateCnt);
+    TST_CHECK(stat.accessTimeEst_m >= (5 * nominalEst) / 2, "estimate %lu (nominal %lu)",
+              (unsigned long)stat.accessTimeEst_m, (unsigned long)nominalEst);
+    sodstore_close();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Store to alternating banks and keep the previous image on a power
+          cut or a corrupted bank
+*/
+//------------------------------------------------------------------------------
+static void testBanks(void)
+{
+    tNvsFileConfig      config = aFlash_l[0].config;
+    tTstResult          result;
+    tSodStoreStatistics stat;
+    tNvsFileStat        nvsStat;
+    UINT32              sectorsPerBank = (config.size_m / 2) / config.sectorSize_m;
+    UINT32              usedSectors = (TST_IMG_OFFSET_DATA + TST_PARAM_SET_LEN + config.sectorSize_m - 1) /
+                                      config.sectorSize_m;
+    UINT8*              pBase;
+    UINT32              len;
+    UINT32              offset;
+    UINT8               zero = 0;
+    UINT32              i;
+
+    (void)remove(aNvsFile_l);
+    config.pFileName_m = aNvsFile_l;
+    cycleTime_l = 1000;
+
+    // Full stores alternate between the banks, only used sectors are erased
+    openStore(&config);
+    for (i = 0; i < 4; i++)
+    {
+        fillParamSet(TST_PARAM_SET_LEN);
+        runStore(TST_PARAM_SET_LEN, FALSE, &result);
+        TST_CHECK(result.ret == kSodStoreProcFinished, "store %lu returned %d", (unsigned long)i, result.ret);
+        checkImage(TST_PARAM_SET_LEN);
+        TST_CHECK(getImageBank() == (i & 1), "store %lu in bank %lu", (unsigned long)i,
+                  (unsigned long)getImageBank());
+    }
+
+    sodstore_getStatistics(&stat);
+    TST_CHECK(stat.fullStoreCnt_m == 4, "%lu full stores", (unsigned long)stat.fullStoreCnt_m);
+    TST_CHECK(stat.eraseCnt_m == 2 * usedSectors, "%lu sectors erased (expected %lu)",
+              (unsigned long)stat.eraseCnt_m, (unsigned long)(2 * usedSectors));
+    TST_CHECK(stat.eraseSkipCnt_m == 2 * sectorsPerBank + 2 * (sectorsPerBank - usedSectors),
+              "%lu blank sectors skipped", (unsigned long)stat.eraseSkipCnt_m);
+
+    // Power cut while the data is written: The previous image is restored
+    memcpy(aSavedSet_l, aParamSet_l, TST_PARAM_SET_LEN);
+    fillParamSet(TST_PARAM_SET_LEN);
+    TST_CHECK(interruptStore(TST_PARAM_SET_LEN, TST_PARAM_SET_LEN / 2) != FALSE, "store not interrupted");
+
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    memcpy(aParamSet_l, aSavedSet_l, TST_PARAM_SET_LEN);
+    checkImage(TST_PARAM_SET_LEN);
+    TST_CHECK(getImageBank() == 1, "image of bank %lu restored", (unsigned long)getImageBank());
+
+    // Power cut after the data before the commit
+    fillParamSet(TST_PARAM_SET_LEN);
+    TST_CHECK(interruptStore(TST_PARAM_SET_LEN, TST_PARAM_SET_LEN) != FALSE, "store not interrupted");
+
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    memcpy(aParamSet_l, aSavedSet_l, TST_PARAM_SET_LEN);
+    checkImage(TST_PARAM_SET_LEN);
+
+    // The next store erases the interrupted bank
+    fillParamSet(TST_PARAM_SET_LEN);
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store after power cut returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN);
+    TST_CHECK(getImageBank() == 0, "store in bank %lu", (unsigned long)getImageBank());
+
+    nvsfile_getStatistics(&nvsStat);
+    TST_CHECK(nvsStat.progErrorCnt_m == 0, "%lu program errors", (unsigned long)nvsStat.progErrorCnt_m);
+
+    // Corrupted newest bank: The restore takes the older bank
+    TST_CHECK(sodstore_getSodImage(&pBase, &len) != FALSE, "no valid image");
+    offset = (UINT32)(pBase - nvs_getAddress(0));
+    for (i = 0; i < len && pBase[i] == 0; i++)
+        ;
+    TST_CHECK(nvs_write(offset + i, &zero, 1) != FALSE, "corruption failed");
+
+    memcpy(aParamSet_l, aSavedSet_l, TST_PARAM_SET_LEN);
+    checkImage(TST_PARAM_SET_LEN);
+    TST_CHECK(getImageBank() == 1, "image of bank %lu restored", (unsigned long)getImageBank());
+
+    // The corrupted bank is overwritten by the next store
+    fillParamSet(TST_PARAM_SET_LEN);
+    runStore(TST_PARAM_SET_LEN, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store after corruption returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN);
+    TST_CHECK(getImageBank() == 0, "store in bank %lu", (unsigned long)getImageBank());
+
+    // A parameter set which does not fit into a bank can not be stored
+    result.ret = sodstore_process(aParamSet_l, (config.size_m / 2) - TST_IMG_OFFSET_DATA + 1);
+    TST_CHECK(result.ret == kSodStoreProcNotApplicable, "oversized store returned %d", result.ret);
+    checkImage(TST_PARAM_SET_LEN);
+
+    sodstore_close();
+    (void)remove(aNvsFile_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Append small changes to the journal and restore them
+*/
+//------------------------------------------------------------------------------
+static void testJournal(void)
+{
+    tNvsFileConfig      config = aFlash_l[0].config;
+    tTstResult          result;
+    tSodStoreStatistics stat;
+    tSodStoreStatistics before;
+    tNvsFileStat        nvsStat;
+    UINT32              i;
+
+    (void)remove(aNvsFile_l);
+    config.pFileName_m = aNvsFile_l;
+    cycleTime_l = 1000;
+
+    openStore(&config);
+    runStore(TST_JOURNAL_LEN, FALSE, &result);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store returned %d", result.ret);
+    checkImage(TST_JOURNAL_LEN);
+
+    // Small changes are appended to the journal of the active bank
+    for (i = 0; i < TST_JOURNAL_CHANGES; i++)
+    {
+        changeParamSet(TST_JOURNAL_LEN, 1 + (i % 3));
+        sodstore_getStatistics(&before);
+        runStore(TST_JOURNAL_LEN, FALSE, &result);
+        sodstore_getStatistics(&stat);
+
+        TST_CHECK(result.ret == kSodStoreProcFinished, "change %lu returned %d", (unsigned long)i, result.ret);
+        checkImage(TST_JOURNAL_LEN);
+        TST_CHECK(stat.journalCnt_m == i + 1, "%lu journal entries after change %lu",
+                  (unsigned long)stat.journalCnt_m, (unsigned long)i);
+        TST_CHECK(stat.byteCnt_m - before.byteCnt_m <= TST_JOURNAL_ENTRY_MAX, "change %lu wrote %lu bytes",
+                  (unsigned long)i, (unsigned long)(stat.byteCnt_m - before.byteCnt_m));
+    }
+
+    TST_CHECK(stat.fullStoreCnt_m == 1, "%lu full stores", (unsigned long)stat.fullStoreCnt_m);
+    TST_CHECK(stat.eraseCnt_m == 0, "%lu sectors erased", (unsigned long)stat.eraseCnt_m);
+
+    // An unchanged parameter set is not written
+    runStore(TST_JOURNAL_LEN, FALSE, &result);
+    sodstore_getStatistics(&before);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "unchanged store returned %d", result.ret);
+    TST_CHECK(before.byteCnt_m == stat.byteCnt_m, "unchanged store wrote %lu bytes",
+              (unsigned long)(before.byteCnt_m - stat.byteCnt_m));
+
+    // Restart: The bank and its journal are restored
+    sodstore_close();
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    checkImage(TST_JOURNAL_LEN);
+
+    // Power cut in the journal entry: The previous state is restored
+    memcpy(aSavedSet_l, aParamSet_l, TST_JOURNAL_LEN);
+    changeParamSet(TST_JOURNAL_LEN, 3);
+    cycleTime_l = TST_SYNC_TIME + 50;
+    TST_CHECK(interruptStore(TST_JOURNAL_LEN, 1) != FALSE, "journal entry not interrupted");
+
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    memcpy(aParamSet_l, aSavedSet_l, TST_JOURNAL_LEN);
+    checkImage(TST_JOURNAL_LEN);
+
+    // The torn entry closes the journal: The next change is a full store
+    cycleTime_l = 1000;
+    changeParamSet(TST_JOURNAL_LEN, 1);
+    runStore(TST_JOURNAL_LEN, FALSE, &result);
+    sodstore_getStatistics(&stat);
+    TST_CHECK(result.ret == kSodStoreProcFinished, "store after torn entry returned %d", result.ret);
+    checkImage(TST_JOURNAL_LEN);
+    TST_CHECK(stat.fullStoreCnt_m == 1 && stat.journalCnt_m == 0, "%lu full stores, %lu journal entries",
+              (unsigned long)stat.fullStoreCnt_m, (unsigned long)stat.journalCnt_m);
+
+    // Large changes and a new length are stored to the other bank
+    fillParamSet(TST_JOURNAL_LEN);
+    runStore(TST_JOURNAL_LEN, FALSE, &result);
+    checkImage(TST_JOURNAL_LEN);
+    runStore(TST_JOURNAL_LEN - 7, FALSE, &result);
+    checkImage(TST_JOURNAL_LEN - 7);
+    sodstore_getStatistics(&stat);
+    TST_CHECK(stat.fullStoreCnt_m == 3 && stat.journalCnt_m == 0, "%lu full stores, %lu journal entries",
+              (unsigned long)stat.fullStoreCnt_m, (unsigned long)stat.journalCnt_m);
+
+    // A full journal is compacted into the other bank
+    before = stat;
+    for (i = 0; (i < TST_MAX_CYCLES) && (stat.fullStoreCnt_m == before.fullStoreCnt_m); i++)
+    {
+        changeParamSet(TST_JOURNAL_LEN - 7, 1);
+        runStore(TST_JOURNAL_LEN - 7, FALSE, &result);
+        checkImage(TST_JOURNAL_LEN - 7);
+        sodstore_getStatistics(&stat);
+    }
+
+    TST_CHECK(stat.journalCnt_m > 100, "journal full after %lu entries", (unsigned long)stat.journalCnt_m);
+    printf("journal full after %lu entries\n", (unsigned long)stat.journalCnt_m);
+
+    sodstore_close();
+    TST_CHECK(sodstore_init() != FALSE, "reopen failed");
+    checkImage(TST_JOURNAL_LEN - 7);
+
+    nvsfile_getStatistics(&nvsStat);
+    TST_CHECK(nvsStat.progErrorCnt_m == 0, "%lu program errors", (unsigned long)nvsStat.progErrorCnt_m);
+
+    sodstore_close();
+    (void)remove(aNvsFile_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Count the sector erases of a sequence of small and large changes
+*/
+//------------------------------------------------------------------------------
+static void testWear(void)
+{
+    tNvsFileConfig      config = aFlash_l[0].config;
+    tTstResult          result;
+    tSodStoreStatistics stat;
+    tNvsFileStat        nvsStat;
+    UINT32              sectorsPerBank = (config.size_m / 2) / config.sectorSize_m;
+    UINT32              aBankCnt[2] = { 0, 0 };
+    UINT32              i;
+
+    openStore(&config);
+    cycleTime_l = 1000;
+    runStore(TST_JOURNAL_LEN, FALSE, &result);
+    aBankCnt[getImageBank() & 1]++;
+
+    for (i = 1; i <= TST_WEAR_STORES; i++)
+    {
+        if ((i % TST_WEAR_FULL_PERIOD) == 0)
+        {
+            fillParamSet(TST_JOURNAL_LEN);
+            runStore(TST_JOURNAL_LEN, FALSE, &result);
+            aBankCnt[getImageBank() & 1]++;
+        }
+        else
+        {
+            changeParamSet(TST_JOURNAL_LEN, 2);
+            runStore(TST_JOURNAL_LEN, FALSE, &result);
+        }
+
+        TST_CHECK(result.ret == kSodStoreProcFinished, "store %lu returned %d", (unsigned long)i, result.ret);
+        checkImage(TST_JOURNAL_LEN);
+    }
+
+    sodstore_getStatistics(&stat);
+    nvsfile_getStatistics(&nvsStat);
+
+    TST_CHECK(stat.fullStoreCnt_m == 1 + TST_WEAR_STORES / TST_WEAR_FULL_PERIOD, "%lu full stores",
+              (unsigned long)stat.fullStoreCnt_m);
+    TST_CHECK(stat.journalCnt_m == TST_WEAR_STORES - TST_WEAR_STORES / TST_WEAR_FULL_PERIOD,
+              "%lu journal entries", (unsigned long)stat.journalCnt_m);
+    TST_CHECK(stat.eraseCnt_m == nvsStat.eraseCnt_m, "%lu erases counted, %lu erased",
+              (unsigned long)stat.eraseCnt_m, (unsigned long)nvsStat.eraseCnt_m);
+    TST_CHECK(stat.eraseCnt_m <= (stat.fullStoreCnt_m - 2) * sectorsPerBank, "%lu sectors erased",
+              (unsigned long)stat.eraseCnt_m);
+    TST_CHECK((aBankCnt[0] <= aBankCnt[1] + 1) && (aBankCnt[1] <= aBankCnt[0] + 1), "full stores in bank 0: %lu, bank 1: %lu",
+              (unsigned long)aBankCnt[0], (unsigned long)aBankCnt[1]);
+
+    printf("%lu stores: %lu full (bank 0: %lu, bank 1: %lu), %lu journal entries, %lu sector erases\n",
+           (unsigned long)(TST_WEAR_STORES + 1), (unsigned long)stat.fullStoreCnt_m,
+           (unsigned long)aBankCnt[0], (unsigned long)aBankCnt[1], (unsigned long)stat.journalCnt_m,
+           (unsigned long)stat.eraseCnt_m);
+
+    sodstore_close();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Compare the store time of the burst writer and the former writer
+*/
+//------------------------------------------------------------------------------
+static void runBenchmark(void)
+{
+    tTstResult          result;
+    tTstResult          fixed;
+    tSodStoreStatistics stat;
+    size_t              flash;
+    size_t              cycle;
+
+    printf("%-10s %6s | %10s %7s %7s %6s | %10s %7s %6s\n", "flash", "cycle",
+           "burst [ms]", "cycles", "bursts", "late", "fixed [ms]", "cycles", "late");
+
+    for (flash = 0; flash < sizeof(aFlash_l) / sizeof(aFlash_l[0]); flash++)
+    {
+        for (cycle = 0; cycle < sizeof(aCycleTime_l) / sizeof(aCycleTime_l[0]); cycle++)
+        {
+            cycleTime_l = aCycleTime_l[cycle];
+
+            openStore(&aFlash_l[flash].config);
+            runStore(TST_PARAM_SET_LEN, FALSE, &result);
+            sodstore_getStatistics(&stat);
+            checkImage(TST_PARAM_SET_LEN);
+
+            TST_CHECK(sodstore_prepareStorage() != FALSE, "erase failed");
+            runStore(TST_PARAM_SET_LEN, TRUE, &fixed);
+            sodstore_close();
+
+            TST_CHECK(result.ret == kSodStoreProcFinished, "store returned %d", result.ret);
+
+            printf("%-10s %6lu | %10.1f %7lu %7lu %6lu | %10.1f %7lu %6lu\n",
+                   aFlash_l[flash].pName, (unsigned long)cycleTime_l,
+                   result.storeTime / 1000.0, (unsigned long)result.cycleCnt,
+                   (unsigned long)stat.burstCnt_m, (unsigned long)result.lateCnt,
+                   fixed.storeTime / 1000.0, (unsigned long)fixed.cycleCnt,
+                   (unsigned long)fixed.lateCnt);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Configure the NVS model and open the store with an erased image
+
+\param pConfig_p    Configuration of the NVS model
+*/
+//------------------------------------------------------------------------------
+static void openStore(const tNvsFileConfig* pConfig_p)
+{
+    nvsfile_setConfig(pConfig_p);
+
+    TST_CHECK(sodstore_init() != FALSE, "init failed");
+    TST_CHECK(sodstore_prepareStorage() != FALSE, "erase failed");
+
+    fillParamSet(TST_PARAM_SET_MAX);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run the background loop until the store is finished
+
+\param len_p            Length of the parameter set
+\param fFixedChunk_p    TRUE: Run the former writer
+\param pResult_p        Result of the run
+*/
+//------------------------------------------------------------------------------
+static void runStore(UINT32 len_p, BOOLEAN fFixedChunk_p, tTstResult* pResult_p)
+{
+    UINT32  start = timer_getTickCount();
+
+    memset(pResult_p, 0, sizeof(tTstResult));
+
+    cycleStart_l = start;
+    nextSync_l = start + cycleTime_l;
+    fixedOffs_l = 0;
+
+    do
+    {
+        if (fFixedChunk_p)
+            pResult_p->ret = processFixedChunk(len_p);
+        else
+            pResult_p->ret = sodstore_process(aParamSet_l, len_p);
+
+        pResult_p->callCnt++;
+
+        // A sync during the store call waits for the end of the flash write
+        serveSync(TRUE, pResult_p);
+
+        timermock_advance(TST_LOOP_TIME);
+        serveSync(FALSE, pResult_p);
+    } while ((pResult_p->ret == kSodStoreProcBusy) && (pResult_p->cycleCnt < TST_MAX_CYCLES));
+
+    pResult_p->storeTime = timer_getTickCount() - start;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    The former writer: 8 bytes of the parameter set per call
+
+Only the data of the image is written to compare the program loop.
+
+\param len_p    Length of the parameter set
+
+\return Busy until all data is written
+*/
+//------------------------------------------------------------------------------
+static tProcStoreRet processFixedChunk(UINT32 len_p)
+{
+    UINT32  chunk = len_p - fixedOffs_l;
+
+    if (chunk > TST_FIXED_CHUNK_SIZE)
+        chunk = TST_FIXED_CHUNK_SIZE;
+
+    TST_CHECK(nvs_write(TST_IMG_OFFSET_DATA + fixedOffs_l, &aParamSet_l[fixedOffs_l], chunk) != FALSE,
+              "fixed write at %lu failed", (unsigned long)fixedOffs_l);
+    fixedOffs_l += chunk;
+
+    return (fixedOffs_l < len_p) ? kSodStoreProcBusy : kSodStoreProcFinished;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run the store until a number of bytes is written and cut the power
+
+The store is closed like on a reset. The caller opens it again.
+
+\param len_p        Length of the parameter set
+\param byteCnt_p    Number of bytes written before the power cut
+
+\return TRUE if the store was interrupted before it finished
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN interruptStore(UINT32 len_p, UINT32 byteCnt_p)
+{
+    tTstResult          result;
+    tSodStoreStatistics stat;
+    UINT32              startCnt;
+
+    memset(&result, 0, sizeof(tTstResult));
+    sodstore_getStatistics(&stat);
+    startCnt = stat.byteCnt_m;
+
+    cycleStart_l = timer_getTickCount();
+    nextSync_l = (UINT32)cycleStart_l + cycleTime_l;
+
+    do
+    {
+        result.ret = sodstore_process(aParamSet_l, len_p);
+
+        serveSync(TRUE, &result);
+        timermock_advance(TST_LOOP_TIME);
+        serveSync(FALSE, &result);
+
+        sodstore_getStatistics(&stat);
+    } while ((result.ret == kSodStoreProcBusy) && (stat.byteCnt_m - startCnt < byteCnt_p) &&
+             (result.cycleCnt < TST_MAX_CYCLES));
+
+    sodstore_close();
+
+    return (result.ret == kSodStoreProcBusy) ? TRUE : FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Serve the sync interrupts which are due
+
+\param fInWrite_p   TRUE: The time passed in a flash write, the interrupt is
+                    delayed until now
+\param pResult_p    Result of the run
+*/
+//------------------------------------------------------------------------------
+static void serveSync(BOOLEAN fInWrite_p, tTstResult* pResult_p)
+{
+    UINT32  now = timer_getTickCount();
+    UINT32  late;
+
+    while ((cycleTime_l > 0) && ((INT32)(now - nextSync_l) >= 0))
+    {
+        if (fInWrite_p)
+        {
+            late = now - nextSync_l;
+            if (late > 0)
+            {
+                pResult_p->lateCnt++;
+                if (late > pResult_p->lateMax)
+                    pResult_p->lateMax = late;
+            }
+            cycleStart_l = now;
+        }
+        else
+        {
+            cycleStart_l = nextSync_l;
+        }
+
+        nextSync_l += cycleTime_l;
+        pResult_p->cycleCnt++;
+
+        timermock_advance(TST_SYNC_TIME);
+        now = timer_getTickCount();
+        fInWrite_p = FALSE;
+    }
+
+    if (cycleTime_l == 0)
+        pResult_p->cycleCnt++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check the stored image against the parameter set
+
+\param len_p    Length of the parameter set
+*/
+//------------------------------------------------------------------------------
+static void checkImage(UINT32 len_p)
+{
+    UINT8*  pBase = NULL;
+    UINT32  len = 0;
+
+    TST_CHECK(sodstore_getSodImage(&pBase, &len) != FALSE, "no valid image");
+    if (pBase != NULL)
+    {
+        TST_CHECK(len == len_p, "image length %lu (expected %lu)",
+                  (unsigned long)len, (unsigned long)len_p);
+        TST_CHECK(memcmp(pBase, aParamSet_l, len_p) == 0, "image data differs");
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Get the bank of the restored image
+
+\return The bank of an image without journal entries; 0xFF if the image is
+        not restored from the NVS directly
+*/
+//------------------------------------------------------------------------------
+static UINT32 getImageBank(void)
+{
+    tNvsGeometry    geometry;
+    UINT8*          pBase = NULL;
+    UINT32          len = 0;
+    UINT32          offset;
+    UINT32          bank = 0xFF;
+
+    nvs_getGeometry(&geometry);
+
+    if (sodstore_getSodImage(&pBase, &len) &&
+        (pBase >= nvs_getAddress(0)) && (pBase < nvs_getAddress(geometry.storageSize_m)))
+    {
+        offset = (UINT32)(pBase - nvs_getAddress(0)) - TST_IMG_OFFSET_DATA;
+        bank = offset / (((geometry.storageSize_m / 2) / geometry.sectorSize_m) * geometry.sectorSize_m);
+    }
+
+    return bank;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Fill the parameter set with random data
+
+\param len_p    Number of bytes
+*/
+//------------------------------------------------------------------------------
+static void fillParamSet(UINT32 len_p)
+{
+    UINT32  i;
+
+    for (i = 0; i < len_p; i++)
+        aParamSet_l[i] = (UINT8)random32();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Change single bytes of the parameter set
+
+\param len_p            Length of the parameter set
+\param changeCnt_p      Number of changed bytes
+*/
+//------------------------------------------------------------------------------
+static void changeParamSet(UINT32 len_p, UINT32 changeCnt_p)
+{
+    UINT32  i;
+
+    for (i = 0; i < changeCnt_p; i++)
+        aParamSet_l[random32() % len_p] ^= (UINT8)(1 + (random32() % 255));
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Pseudo random numbers (reproducible)
+
+\return Random 32 bit value
+*/
+//------------------------------------------------------------------------------
+static UINT32 random32(void)
+{
+    rand_l = (rand_l * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return (UINT32)((rand_l >> 16) | ((rand_l & 0xFFFFUL) << 16));
+}
+
+/// \}
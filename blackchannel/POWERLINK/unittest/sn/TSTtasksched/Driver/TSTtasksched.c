@@ -0,0 +1,600 @@
+/**
+********************************************************************************
+\file   TSTtasksched.c
+
+\brief  Harness of the end of cycle task scheduler of the SN
+
+The harness runs the task scheduler of the SN application (tasksched.c) with
+synthetic tasks on a virtual microsecond time base. Each task advances the
+time base by its configured cost. The cycles start with the cost of the
+synchronous stack processing, afterwards the scheduler is called like at the
+end of the sync interrupt. A sync interrupt which would occur during the
+tasks of the last cycle is delayed until the tasks are finished.
+
+The same workload is also run with the former fixed rotation (one task per
+cycle) to compare how long a backlog of received frames takes to drain.
+
+Usage: tsttasksched idle|backlog|overload|nocycle
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2013, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+
+#include <sn/tasksched.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_CYCLE_US            1000    ///< Cycle time of the virtual sync interrupt
+#define TST_SYNC_COST_US        250     ///< Stack processing in the sync interrupt before the scheduler
+#define TST_CYCLES              3000    ///< Cycles of a run
+#define TST_TASK_CNT            3       ///< Number of synthetic tasks
+
+#define TST_BACKLOG_FRAMES      60      ///< Frames received at once in the backlog scenario
+#define TST_BACKLOG_CYCLE       10      ///< Cycle the backlog is received
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+
+/**
+\brief  Synthetic task
+*/
+typedef struct
+{
+    const char*     pName;          ///< Name of the task in the report
+    UINT32          idleCost;       ///< Execution time without work
+    UINT32          workCost;       ///< Execution time of one work item
+    UINT32          spikeCost;      ///< Execution time of a spike
+    unsigned long   spikePeriod;    ///< Every n-th run is a spike (0: no spikes)
+    unsigned long   backlog;        ///< Work items waiting for the task
+    unsigned long   burst;          ///< Work items received at TST_BACKLOG_CYCLE
+    unsigned long   runs;           ///< Runs of the task
+    unsigned long   spikes;         ///< Runs with a spike
+    unsigned long   lastRunCycle;   ///< Cycle of the last run
+    unsigned long   maxGap;         ///< Maximum number of cycles between two runs
+} tTstTask;
+
+/**
+\brief  Result of a run
+*/
+typedef struct
+{
+    unsigned long   drainCycle;     ///< Cycle the backlog was drained (0: not drained)
+    unsigned long   lateSyncs;      ///< Sync interrupts delayed by the tasks of the last cycle
+} tTstResult;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static UINT32           timeUs_l;
+static unsigned long    cycle_l;
+static tTstTask         aTask_l[TST_TASK_CNT];
+static unsigned long    minorErrors_l;
+static unsigned long    fatalErrors_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void     setupTasks(const char* pScenario_p);
+static int      runScheduler(UINT32 cycleTime_p, tTstResult* pResult_p);
+static void     runLegacy(tTstResult* pResult_p);
+static void     runSynthetic(UINT8 taskIdx_p);
+static void     addBacklog(void);
+static BOOLEAN  shnfTask(void);
+static BOOLEAN  saplTask(void);
+static BOOLEAN  stateTask(void);
+static BOOLEAN  shnfPending(void);
+static UINT32   getTime(void);
+static void     printReport(const tTaskSchedStatistics* pStat_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Scheduler harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       Run finished and all checks passed
+\retval 1       Invalid arguments or the scheduler could not be started
+\retval 2       A check of the run failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    tTaskSchedStatistics    stat;
+    tTstResult              result;
+    tTstResult              legacy;
+    const char*             pScenario;
+    UINT32                  cycleTime = TST_CYCLE_US;
+    int                     ret = 0;
+    unsigned int            i;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s idle|backlog|overload|nocycle\n", argv[0]);
+        return 1;
+    }
+
+    pScenario = argv[1];
+    if ((strcmp(pScenario, "idle") != 0) && (strcmp(pScenario, "backlog") != 0) &&
+        (strcmp(pScenario, "overload") != 0) && (strcmp(pScenario, "nocycle") != 0))
+    {
+        fprintf(stderr, "Unknown scenario %s\n", pScenario);
+        return 1;
+    }
+
+    if (strcmp(pScenario, "nocycle") == 0)
+        cycleTime = 0;
+
+    // Former fixed rotation for comparison
+    setupTasks(pScenario);
+    runLegacy(&legacy);
+
+    setupTasks(pScenario);
+    if (runScheduler(cycleTime, &result) != 0)
+        return 1;
+
+    tasksched_getStatistics(&stat);
+    printReport(&stat);
+
+    printf("\nlate sync interrupts %lu, minor errors %lu\n", result.lateSyncs, minorErrors_l);
+    if (strcmp(pScenario, "backlog") == 0)
+    {
+        printf("backlog of %d frames drained after %lu cycles (fixed rotation: %lu cycles)\n",
+               TST_BACKLOG_FRAMES, result.drainCycle - TST_BACKLOG_CYCLE,
+               legacy.drainCycle - TST_BACKLOG_CYCLE);
+    }
+
+    // Checks of all scenarios
+    if (fatalErrors_l != 0)
+    {
+        printf("FAILED: fatal error posted by the scheduler\n");
+        ret = 2;
+    }
+
+    for (i = 0; i < TST_TASK_CNT; i++)
+    {
+        // The rotation guarantees each task a run every TST_TASK_CNT cycles
+        if (aTask_l[i].maxGap > TST_TASK_CNT)
+        {
+            printf("FAILED: task %s was not run for %lu cycles\n", aTask_l[i].pName, aTask_l[i].maxGap);
+            ret = 2;
+        }
+    }
+
+    if (stat.deadlineMissCnt_m != minorErrors_l)
+    {
+        printf("FAILED: %lu deadline misses but %lu errors reported\n",
+               (unsigned long)stat.deadlineMissCnt_m, minorErrors_l);
+        ret = 2;
+    }
+
+    if (strcmp(pScenario, "idle") == 0)
+    {
+        for (i = 0; i < TST_TASK_CNT; i++)
+        {
+            if (aTask_l[i].runs != TST_CYCLES)
+            {
+                printf("FAILED: task %s ran %lu times in %d cycles\n", aTask_l[i].pName, aTask_l[i].runs, TST_CYCLES);
+                ret = 2;
+            }
+        }
+
+        if ((stat.budgetOverrunCnt_m != 0) || (result.lateSyncs != 0))
+        {
+            printf("FAILED: budget overrun without load\n");
+            ret = 2;
+        }
+    }
+    else if (strcmp(pScenario, "backlog") == 0)
+    {
+        // Idle tasks have to give their time to the backlog
+        if ((result.drainCycle == 0) ||
+            ((result.drainCycle - TST_BACKLOG_CYCLE) * 2 > (legacy.drainCycle - TST_BACKLOG_CYCLE)))
+        {
+            printf("FAILED: backlog is not drained at least twice as fast as with the fixed rotation\n");
+            ret = 2;
+        }
+
+        if ((stat.deadlineMissCnt_m != 0) || (result.lateSyncs != 0))
+        {
+            printf("FAILED: backlog caused a deadline miss\n");
+            ret = 2;
+        }
+    }
+    else if (strcmp(pScenario, "overload") == 0)
+    {
+        // Only the spikes of the application task may exceed the cycle
+        if ((stat.deadlineMissCnt_m == 0) || (stat.deadlineMissCnt_m > aTask_l[1].spikes))
+        {
+            printf("FAILED: %lu deadline misses for %lu spikes\n",
+                   (unsigned long)stat.deadlineMissCnt_m, aTask_l[1].spikes);
+            ret = 2;
+        }
+    }
+    else
+    {
+        if (stat.runsPerCycleMax_m != 1)
+        {
+            printf("FAILED: more than one task per cycle without a cycle time\n");
+            ret = 2;
+        }
+    }
+
+    tasksched_exit();
+
+    printf("%s\n", (ret == 0) ? "PASSED" : "FAILED");
+
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the error handler (minor errors)
+
+\param source_p     Source of the error
+\param code_p       Error code
+\param addInfo_p    Additional information
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postMinorError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+    UNUSED_PARAMETER(addInfo_p);
+
+    if (code_p == kErrorTaskDeadlineMissed)
+        minorErrors_l++;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stub of the error handler (fatal errors)
+
+\param source_p     Source of the error
+\param code_p       Error code
+\param addInfo_p    Additional information
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+    UNUSED_PARAMETER(code_p);
+    UNUSED_PARAMETER(addInfo_p);
+
+    fatalErrors_l++;
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Set the synthetic task costs of a scenario
+
+\param pScenario_p      Name of the scenario
+*/
+//------------------------------------------------------------------------------
+static void setupTasks(const char* pScenario_p)
+{
+    memset(aTask_l, 0, sizeof(aTask_l));
+
+    // Received frames of the SHNF
+    aTask_l[0].pName = "shnf";
+    aTask_l[0].idleCost = 20;
+    aTask_l[0].workCost = 60;
+
+    // Application of the SAPL
+    aTask_l[1].pName = "sapl";
+    aTask_l[1].idleCost = 40;
+
+    // State changes
+    aTask_l[2].pName = "state";
+    aTask_l[2].idleCost = 10;
+
+    if (strcmp(pScenario_p, "backlog") == 0)
+        aTask_l[0].burst = TST_BACKLOG_FRAMES;
+
+    if (strcmp(pScenario_p, "overload") == 0)
+    {
+        // The application occasionally runs longer than a cycle
+        aTask_l[1].spikeCost = 900;
+        aTask_l[1].spikePeriod = 97;
+
+        // Frames arrive faster than the SHNF is scheduled by the fixed rotation
+        aTask_l[0].backlog = TST_BACKLOG_FRAMES;
+    }
+
+    timeUs_l = 0;
+    cycle_l = 0;
+    minorErrors_l = 0;
+    fatalErrors_l = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run the synthetic tasks with the task scheduler
+
+\param cycleTime_p      Cycle time passed to the scheduler (0: unknown)
+\param pResult_p        Result of the run
+
+\return 0 on success, -1 if the scheduler could not be started
+*/
+//------------------------------------------------------------------------------
+static int runScheduler(UINT32 cycleTime_p, tTstResult* pResult_p)
+{
+    static const tTaskSchedTask aTasks[TST_TASK_CNT] =
+    {
+        { shnfTask,     shnfPending },
+        { saplTask,     NULL },
+        { stateTask,    NULL },
+    };
+    tTaskSchedInit  initParam;
+    UINT32          cycleStart;
+
+    memset(pResult_p, 0, sizeof(tTstResult));
+
+    initParam.pTasks_m = aTasks;
+    initParam.taskCount_m = TST_TASK_CNT;
+    initParam.pfnGetTime_m = getTime;
+
+    if (tasksched_init(&initParam) == FALSE)
+        return -1;
+
+    for (cycle_l = 1; cycle_l <= TST_CYCLES; cycle_l++)
+    {
+        cycleStart = cycle_l * TST_CYCLE_US;
+        if ((INT32)(timeUs_l - cycleStart) > 0)
+        {
+            // The sync interrupt is delayed by the tasks of the last cycle
+            cycleStart = timeUs_l;
+            pResult_p->lateSyncs++;
+        }
+
+        if (cycle_l == TST_BACKLOG_CYCLE)
+            addBacklog();
+
+        timeUs_l = cycleStart + TST_SYNC_COST_US;
+
+        if (tasksched_process(cycleStart, cycleTime_p) == FALSE)
+            return -1;
+
+        if ((pResult_p->drainCycle == 0) && (cycle_l >= TST_BACKLOG_CYCLE) && (aTask_l[0].backlog == 0))
+            pResult_p->drainCycle = cycle_l;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run the synthetic tasks with the former fixed rotation
+
+\param pResult_p        Result of the run
+*/
+//------------------------------------------------------------------------------
+static void runLegacy(tTstResult* pResult_p)
+{
+    memset(pResult_p, 0, sizeof(tTstResult));
+
+    for (cycle_l = 1; cycle_l <= TST_CYCLES; cycle_l++)
+    {
+        if (cycle_l == TST_BACKLOG_CYCLE)
+            addBacklog();
+
+        runSynthetic((UINT8)((cycle_l - 1) % TST_TASK_CNT));
+
+        if ((pResult_p->drainCycle == 0) && (cycle_l >= TST_BACKLOG_CYCLE) && (aTask_l[0].backlog == 0))
+            pResult_p->drainCycle = cycle_l;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Advance the time base by the cost of one run of a task
+
+\param taskIdx_p    Index of the synthetic task
+*/
+//------------------------------------------------------------------------------
+static void runSynthetic(UINT8 taskIdx_p)
+{
+    tTstTask*   pTask = &aTask_l[taskIdx_p];
+    UINT32      cost = pTask->idleCost;
+
+    if (pTask->backlog > 0)
+    {
+        pTask->backlog--;
+        cost = pTask->workCost;
+    }
+
+    pTask->runs++;
+    if ((pTask->spikePeriod != 0) && ((pTask->runs % pTask->spikePeriod) == 0))
+    {
+        cost = pTask->spikeCost;
+        pTask->spikes++;
+    }
+
+    if ((pTask->lastRunCycle != cycle_l) && (cycle_l - pTask->lastRunCycle > pTask->maxGap))
+        pTask->maxGap = cycle_l - pTask->lastRunCycle;
+    pTask->lastRunCycle = cycle_l;
+
+    timeUs_l += cost;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Receive a burst of frames for the SHNF task
+*/
+//------------------------------------------------------------------------------
+static void addBacklog(void)
+{
+    aTask_l[0].backlog += aTask_l[0].burst;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Synthetic SHNF task
+
+\return Always TRUE
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN shnfTask(void)
+{
+    runSynthetic(0);
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Synthetic SAPL task
+
+\return Always TRUE
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN saplTask(void)
+{
+    runSynthetic(1);
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Synthetic state handler task
+
+\return Always TRUE
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN stateTask(void)
+{
+    runSynthetic(2);
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Report queued frames of the synthetic SHNF task
+
+\return TRUE if frames are waiting
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN shnfPending(void)
+{
+    return (aTask_l[0].backlog > 0) ? TRUE : FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Virtual microsecond time base of the scheduler
+
+\return The current virtual time
+*/
+//------------------------------------------------------------------------------
+static UINT32 getTime(void)
+{
+    return timeUs_l;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Print the statistics of the scheduler
+
+\param pStat_p      Statistics of the scheduler
+*/
+//------------------------------------------------------------------------------
+static void printReport(const tTaskSchedStatistics* pStat_p)
+{
+    unsigned int    i;
+
+    printf("%lu cycles, %lu budget overruns, %lu deadline misses, max %u runs per cycle, "
+           "mean unused budget %lu us\n\n",
+           (unsigned long)pStat_p->cycleCnt_m, (unsigned long)pStat_p->budgetOverrunCnt_m,
+           (unsigned long)pStat_p->deadlineMissCnt_m, (unsigned int)pStat_p->runsPerCycleMax_m,
+           (pStat_p->cycleCnt_m != 0) ? (unsigned long)(pStat_p->idleTimeSum_m / pStat_p->cycleCnt_m) : 0UL);
+
+    printf("%-8s %8s %8s %8s %10s %10s %8s\n",
+           "task", "runs", "skipped", "max gap", "est [us]", "mean [us]", "max [us]");
+    for (i = 0; i < TST_TASK_CNT; i++)
+    {
+        const tTaskSchedTaskStat*   pTask = &pStat_p->task_m[i];
+
+        printf("%-8s %8lu %8lu %8lu %10lu %10lu %8lu\n", aTask_l[i].pName,
+               (unsigned long)pTask->runCnt_m, (unsigned long)pTask->skipCnt_m, aTask_l[i].maxGap,
+               (unsigned long)pTask->costEst_m,
+               (pTask->runCnt_m != 0) ? (unsigned long)(pTask->execTimeSum_m / pTask->runCnt_m) : 0UL,
+               (unsigned long)pTask->execTimeMax_m);
+    }
+}
+
+/// \}
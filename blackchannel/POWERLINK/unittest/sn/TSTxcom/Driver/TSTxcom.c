@@ -0,0 +1,932 @@
+/**
+********************************************************************************
+\file   TSTxcom.c
+
+\brief  Harness of the cross communication of the SN
+
+The harness runs the cross communication of one processor (shnf/xcom.c with
+shnf/xcom-ma.c or shnf/xcom-sl.c) on the uP serial mock of the x86 target
+(target/x86/upserial-mock.c). The harness plays the other processor: it posts
+the SPDO and SSDO/SNMT frames of the scenario, checks the transmitted frames
+and injects the frames of the other processor. After TST_CYCLES cycles the
+bytes per cycle are printed and compared with the expected frame length.
+
+The harness is built for both processors with and without compact frames.
+Measured bytes per cycle (uP-Master tx / uP-Slave tx):
+
+    scenario    full        compact
+    none        24 / 56     16 / 16
+    spdo        24 / 56     20 / 36
+    spdossdo    24 / 56     24 / 56
+
+With SPDO and SSDO/SNMT in every cycle a compact frame saves nothing: it
+carries all sections and the three byte header takes the place of the message
+format and the two padding bytes of the image.
+
+The remaining test cases check the double buffer and the timing of the
+processing of a received frame.
+
+Usage: tstxcom none|spdo|spdossdo|budget|deadline|overrun
+
+    none        No SPDO and no SSDO/SNMT frame
+    spdo        An SPDO frame in every cycle
+    spdossdo    An SPDO and an SSDO/SNMT frame in every cycle
+    budget      The background loop has no time for a frame, the next sync
+                reports the overrun and the frame is processed late
+    deadline    The sync interrupt hits the processing of a frame
+    overrun     A second frame arrives while a frame waits for processing,
+                the waiting frame has to stay intact
+
+\ingroup module_unittests
+*******************************************************************************/
+
+/*------------------------------------------------------------------------------
+* License Agreement
+*
+* Copyright (c) 2014, B&R Industrial Automation GmbH
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms,
+* with or without modification,
+* are permitted provided that the following conditions are met:
+*
+*   * Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer
+*     in the documentation and/or other materials provided with the
+*     distribution.
+*   * Neither the name of the B&R nor the names of its contributors
+*     may be used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+* A PARTICULAR PURPOSE ARE DISCLAIMED.
+* IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+* ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+* LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+* ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+* THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+// includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <shnf/xcom.h>
+#include <shnf/xcomint.h>
+#include <shnf/constime.h>
+#include <shnf/hnf.h>
+
+#include <sn/upserialmock.h>
+
+#include <SFS.h>
+
+//============================================================================//
+//            G L O B A L   D E F I N I T I O N S                             //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// module global vars
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// global function prototypes
+//------------------------------------------------------------------------------
+
+//============================================================================//
+//            P R I V A T E   D E F I N I T I O N S                           //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+// const defines
+//------------------------------------------------------------------------------
+#define TST_CYCLES              1000        ///< Cycles of a scenario
+#define TST_CYCLE_US            1000        ///< Time between two sync interrupts
+#define TST_START_US            100000      ///< Time of the first sync interrupt
+#define TST_BG_DELAY_US         50          ///< Time of the background loop before the frame is received
+#define TST_PROC_DELAY_US       200         ///< Time of the background loop after the frame is received
+#define TST_NO_ERROR            0xFFFFU     ///< No fatal error was posted
+
+#ifndef XCOM_PROC_BUDGET_US
+  #define XCOM_PROC_BUDGET_US   100         ///< Default of shnf/xcom.c
+#endif
+#define TST_SUB1_LEN            0x10        ///< Length of subframe one of the posted frames
+
+#ifdef TST_XCOM_MASTER
+  #define TST_ROLE_NAME         "uP-Master"
+  #define TST_TX_ID             ID_VAL_MASL_MSG
+  #define TST_PEER_ID           ID_VAL_SLMA_MSG
+  #define TST_TX_LAYOUT         XCOM_MASL_LAYOUT
+  #define TST_PEER_LAYOUT       XCOM_SLMA_LAYOUT
+#else
+  #define TST_ROLE_NAME         "uP-Slave"
+  #define TST_TX_ID             ID_VAL_SLMA_MSG
+  #define TST_PEER_ID           ID_VAL_MASL_MSG
+  #define TST_TX_LAYOUT         XCOM_SLMA_LAYOUT
+  #define TST_PEER_LAYOUT       XCOM_MASL_LAYOUT
+#endif
+
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+  #define TST_FRAME_NAME        "compact"
+#else
+  #define TST_FRAME_NAME        "full"
+#endif
+
+#define TST_FORMAT_SPDO         (1 << MSG_FORMAT_SPDO_SET)
+#define TST_FORMAT_SSDO         (1 << MSG_FORMAT_SSDO_SET)
+
+#define TST_CHECK(cond, ...)                                        \
+    do                                                              \
+    {                                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (failCnt_l++ < 10)                                   \
+            {                                                       \
+                printf("FAILED line %d: ", __LINE__);               \
+                printf(__VA_ARGS__);                                \
+                printf("\n");                                       \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+//------------------------------------------------------------------------------
+// local types
+//------------------------------------------------------------------------------
+#ifdef TST_XCOM_MASTER
+typedef tXComMaSlImage  tTstTxImage;        ///< Image which is sent by the tested processor
+typedef tXComSlMaImage  tTstPeerImage;      ///< Image which is sent by the other processor
+#else
+typedef tXComSlMaImage  tTstTxImage;        ///< Image which is sent by the tested processor
+typedef tXComMaSlImage  tTstPeerImage;      ///< Image which is sent by the other processor
+#endif
+
+/**
+\brief  Scenario of the cross communication
+*/
+typedef struct
+{
+    const char*     pName;          ///< Name of the test case
+    UINT8           msgFormat;      ///< Frames which are posted in every cycle
+    UINT32          aExpBytes[2];   ///< Expected bytes per cycle of the uP-Master and the uP-Slave
+} tTstScenario;
+
+/**
+\brief  Test case of the processing of a received frame
+*/
+typedef struct
+{
+    const char*     pName;          ///< Name of the test case
+    void            (*pfnTest)(void);   ///< The test function
+} tTstTimingCase;
+
+//------------------------------------------------------------------------------
+// local vars
+//------------------------------------------------------------------------------
+static const tTstScenario aScenario_l[] =
+{
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    { "none",       0,                                  { 16, 16 } },
+    { "spdo",       TST_FORMAT_SPDO,                    { 20, 36 } },
+    { "spdossdo",   TST_FORMAT_SPDO | TST_FORMAT_SSDO,  { 24, 56 } },
+#else
+    { "none",       0,                                  { 24, 56 } },
+    { "spdo",       TST_FORMAT_SPDO,                    { 24, 56 } },
+    { "spdossdo",   TST_FORMAT_SPDO | TST_FORMAT_SSDO,  { 24, 56 } },
+#endif
+};
+
+static const tXComImgSection    aTxLayout_l[XCOM_IMG_SECTION_COUNT] = TST_TX_LAYOUT;
+static const tXComImgSection    aPeerLayout_l[XCOM_IMG_SECTION_COUNT] = TST_PEER_LAYOUT;
+
+static UINT8                    aSpdoSub1_l[TST_SUB1_LEN];
+static UINT8                    aSpdoSub2_l[TSPDO_SUB2_LEN];
+static UINT8                    aSpdoTarg_l[TST_SUB1_LEN + TSPDO_SUB2_LEN];
+static UINT8                    aSsdoSub1_l[TST_SUB1_LEN];
+static UINT8                    aSsdoSub2_l[TSSDO_SNMT_SUB2_LEN];
+static UINT8                    aSsdoTarg_l[TST_SUB1_LEN + TSSDO_SNMT_SUB2_LEN];
+
+static UINT64                   now_l;
+static UINT32                   syncTxCnt_l;
+static UINT32                   asyncTxCnt_l;
+static UINT32                   procCnt_l;          ///< Frames whose time was verified
+static UINT32                   fatalCnt_l;
+static UINT32                   firstFatal_l = TST_NO_ERROR;   ///< Like errh only the first error counts
+static BOOLEAN                  fSyncInProc_l;      ///< Raise the sync interrupt in the processing
+static BOOLEAN                  fSyncInProcRet_l;   ///< Result of xcom_enableReceiveCheck() in the processing
+static unsigned long            failCnt_l;
+
+//------------------------------------------------------------------------------
+// local function prototypes
+//------------------------------------------------------------------------------
+static void         runScenario(const tTstScenario* pScen_p);
+static void         testBudget(void);
+static void         testDeadline(void);
+static void         testOverrun(void);
+static BOOLEAN      startCycle(UINT32 cycle_p, UINT8 msgFormat_p);
+static void         runCycle(UINT32 cycle_p, UINT8 msgFormat_p, UINT32 procDelay_p);
+static void         postFrames(UINT32 cycle_p, UINT8 msgFormat_p);
+static void         checkTxFrame(UINT32 cycle_p, UINT8 msgFormat_p, UINT64 syncTime_p);
+static void         injectPeerFrame(UINT32 cycle_p, UINT8 msgFormat_p, UINT64 syncTime_p);
+static UINT32       encodeFrame(const tXComImgSection* pLayout_p, UINT8 msgFormat_p,
+                                const UINT8* pImg_p, UINT32 imgSize_p, UINT8* pFrame_p);
+static BOOLEAN      decodeFrame(const tXComImgSection* pLayout_p, const UINT8* pFrame_p,
+                                UINT32 frameLen_p, UINT8* pImg_p, UINT32 imgSize_p);
+static void         fillPattern(UINT8* pData_p, UINT32 length_p, UINT32 cycle_p, UINT8 sel_p);
+static UINT16       getCrc(UINT32 cycle_p, UINT8 sel_p);
+
+//============================================================================//
+//            P U B L I C   F U N C T I O N S                                 //
+//============================================================================//
+
+//------------------------------------------------------------------------------
+/**
+\brief    Cross communication harness entry point
+
+\param argc     Count of arguments
+\param argv     The program arguments
+
+\return int
+\retval 0       All checks passed
+\retval 1       Invalid arguments or the cross communication could not be started
+\retval 2       A check failed
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    static const tTstTimingCase aTimingCase[] =
+    {
+        { "budget",     testBudget      },
+        { "deadline",   testDeadline    },
+        { "overrun",    testOverrun     },
+    };
+    const tTstScenario*         pScen = NULL;
+    const tTstTimingCase*       pCase = NULL;
+    UINT32                      i;
+
+    if (argc != 2)
+    {
+        printf("Usage: %s none|spdo|spdossdo|budget|deadline|overrun\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(aScenario_l) / sizeof(aScenario_l[0]); i++)
+    {
+        if (strcmp(argv[1], aScenario_l[i].pName) == 0)
+            pScen = &aScenario_l[i];
+    }
+
+    for (i = 0; i < sizeof(aTimingCase) / sizeof(aTimingCase[0]); i++)
+    {
+        if (strcmp(argv[1], aTimingCase[i].pName) == 0)
+            pCase = &aTimingCase[i];
+    }
+
+    if (pScen == NULL && pCase == NULL)
+    {
+        printf("Unknown test case %s\n", argv[1]);
+        return 1;
+    }
+
+    if (!upserial_init() || !xcom_init())
+    {
+        printf("FAILED: xcom_init()\n");
+        return 1;
+    }
+
+    if (pScen != NULL)
+        runScenario(pScen);
+    else
+        pCase->pfnTest();
+
+    xcom_exit();
+    upserial_exit();
+
+    printf("%s\n", (failCnt_l == 0) ? "PASSED" : "FAILED");
+
+    return (failCnt_l == 0) ? 0 : 2;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the consecutive time
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+UINT64 constime_getTimeBase(void)
+{
+    return now_l;
+}
+
+BOOLEAN constime_syncConsTime(UINT64 * pLocTime_p, UINT64 * pRcvTime_p)
+{
+    procCnt_l++;
+
+    // The sync interrupt hits the processing of the frame
+    if (fSyncInProc_l)
+    {
+        fSyncInProc_l = FALSE;
+        fSyncInProcRet_l = xcom_enableReceiveCheck();
+    }
+
+    // Like the consecutive time the times are only averaged, not compared
+    return (pLocTime_p != NULL && pRcvTime_p != NULL) ? TRUE : FALSE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the HNF
+
+The uP-Master forwards the assembled SPDO and SSDO/SNMT frames. They consist
+of the local subframe one and subframe two of the uP-Slave.
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+BOOLEAN hnf_postSyncTx(const UINT8 * pPayload_p, UINT16 paylLen_p)
+{
+    TST_CHECK(paylLen_p == sizeof(aSpdoTarg_l) &&
+              memcmp(pPayload_p, aSpdoSub1_l, TST_SUB1_LEN) == 0 &&
+              memcmp(&pPayload_p[TST_SUB1_LEN], aSpdoSub2_l, TSPDO_SUB2_LEN) == 0,
+              "Assembled SPDO frame differs");
+    syncTxCnt_l++;
+
+    return TRUE;
+}
+
+BOOLEAN hnf_postAsyncTxChannel0(const UINT8 * pPayload_p, UINT16 paylLen_p)
+{
+    TST_CHECK(paylLen_p == sizeof(aSsdoTarg_l) &&
+              memcmp(pPayload_p, aSsdoSub1_l, TST_SUB1_LEN) == 0 &&
+              memcmp(&pPayload_p[TST_SUB1_LEN], aSsdoSub2_l, TSSDO_SNMT_SUB2_LEN) == 0,
+              "Assembled SSDO/SNMT frame differs");
+    asyncTxCnt_l++;
+
+    return TRUE;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Stubs of the error handler and the critical section
+
+The fatal errors are counted, the test cases check them. Like the error
+handler only the first fatal error is kept, the following ones are
+consequential errors.
+
+\ingroup module_unittests
+*/
+//------------------------------------------------------------------------------
+void errh_postMinorError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+
+    failCnt_l++;
+    printf("Minor error 0x%x (0x%lx)\n", (unsigned int)code_p, (unsigned long)addInfo_p);
+}
+
+void errh_postFatalError(tErrSource source_p, tErrorTypes code_p, UINT32 addInfo_p)
+{
+    UNUSED_PARAMETER(source_p);
+    UNUSED_PARAMETER(addInfo_p);
+
+    if (firstFatal_l == TST_NO_ERROR)
+        firstFatal_l = (UINT32)code_p;
+    fatalCnt_l++;
+}
+
+void util_enterCriticalSection(BOOLEAN fEnable_p)
+{
+    UNUSED_PARAMETER(fEnable_p);
+}
+
+//============================================================================//
+//            P R I V A T E   F U N C T I O N S                               //
+//============================================================================//
+/// \name Private Functions
+/// \{
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run the cycles of a scenario and check the bytes per cycle
+
+\param pScen_p      The scenario
+*/
+//------------------------------------------------------------------------------
+static void runScenario(const tTstScenario* pScen_p)
+{
+    tUpSerialMockStat   mockStat;
+    tXComStatistics     xcomStat;
+    UINT32              expBytes;
+    UINT32              cycle;
+
+#ifdef TST_XCOM_MASTER
+    expBytes = pScen_p->aExpBytes[0];
+#else
+    expBytes = pScen_p->aExpBytes[1];
+#endif
+
+    for (cycle = 1; cycle <= TST_CYCLES; cycle++)
+        runCycle(cycle, pScen_p->msgFormat, TST_PROC_DELAY_US);
+
+    upserialmock_getStatistics(&mockStat);
+    xcom_getStatistics(&xcomStat);
+
+    printf("%s %s %s: tx %lu rx %lu bytes per cycle\n", TST_ROLE_NAME, TST_FRAME_NAME,
+           pScen_p->pName,
+           (unsigned long)(xcomStat.txFrameCnt_m ? xcomStat.txByteCnt_m / xcomStat.txFrameCnt_m : 0),
+           (unsigned long)(xcomStat.rxFrameCnt_m ? xcomStat.rxByteCnt_m / xcomStat.rxFrameCnt_m : 0));
+
+    TST_CHECK(xcomStat.txFrameCnt_m == TST_CYCLES && xcomStat.rxFrameCnt_m == TST_CYCLES,
+              "%lu frames sent, %lu received", (unsigned long)xcomStat.txFrameCnt_m,
+              (unsigned long)xcomStat.rxFrameCnt_m);
+    TST_CHECK(xcomStat.txByteCnt_m == expBytes * TST_CYCLES,
+              "%lu bytes sent instead of %lu", (unsigned long)xcomStat.txByteCnt_m,
+              (unsigned long)(expBytes * TST_CYCLES));
+    TST_CHECK(mockStat.txByteCnt_m == xcomStat.txByteCnt_m &&
+              mockStat.rxByteCnt_m == xcomStat.rxByteCnt_m,
+              "Statistics of xcom and the serial differ");
+    TST_CHECK(mockStat.overrunCnt_m == 0, "%lu overruns", (unsigned long)mockStat.overrunCnt_m);
+
+    TST_CHECK(fatalCnt_l == 0, "Fatal error 0x%lx", (unsigned long)firstFatal_l);
+    TST_CHECK(procCnt_l == TST_CYCLES, "%lu frames processed", (unsigned long)procCnt_l);
+
+    // The frame of the first cycle is processed although the cycle time is unknown
+    TST_CHECK(xcomStat.lateProcCnt_m == 0, "%lu frames processed late",
+              (unsigned long)xcomStat.lateProcCnt_m);
+
+#ifdef TST_XCOM_MASTER
+    TST_CHECK(syncTxCnt_l == (((pScen_p->msgFormat & TST_FORMAT_SPDO) != 0) ? TST_CYCLES : 0),
+              "%lu SPDO frames forwarded", (unsigned long)syncTxCnt_l);
+    TST_CHECK(asyncTxCnt_l == (((pScen_p->msgFormat & TST_FORMAT_SSDO) != 0) ? TST_CYCLES : 0),
+              "%lu SSDO/SNMT frames forwarded", (unsigned long)asyncTxCnt_l);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    The background loop has no time left for a frame
+
+The frame of cycle three is processed with one microsecond more than the
+budget left, the frame of cycle four has to wait. The sync interrupt of cycle
+five reports the overrun and the background loop processes the frame although
+the budget is exhausted again.
+*/
+//------------------------------------------------------------------------------
+static void testBudget(void)
+{
+    tXComStatistics xcomStat;
+    UINT64          syncTime;
+
+    runCycle(1, 0, TST_PROC_DELAY_US);
+    runCycle(2, 0, TST_PROC_DELAY_US);
+    runCycle(3, 0, TST_CYCLE_US - XCOM_PROC_BUDGET_US - 1);
+    TST_CHECK(procCnt_l == 3, "Frame of cycle 3 not processed");
+
+    runCycle(4, 0, TST_CYCLE_US - XCOM_PROC_BUDGET_US);
+    TST_CHECK(procCnt_l == 3, "Frame of cycle 4 processed without budget");
+    TST_CHECK(fatalCnt_l == 0, "Fatal error 0x%lx before the sync", (unsigned long)firstFatal_l);
+
+    // The sync interrupt only reports the overrun
+    TST_CHECK(startCycle(5, 0), "xcom_enableReceiveCheck() cycle 5");
+    TST_CHECK(firstFatal_l == kXComProcessingOverrun, "Fatal error 0x%lx instead of the overrun",
+              (unsigned long)firstFatal_l);
+    TST_CHECK(procCnt_l == 3, "Frame of cycle 4 processed in the sync interrupt");
+
+    syncTime = TST_START_US + 5 * TST_CYCLE_US;
+    now_l = syncTime + TST_CYCLE_US - XCOM_PROC_BUDGET_US;
+    xcom_process();
+
+    xcom_getStatistics(&xcomStat);
+    TST_CHECK(procCnt_l == 4, "Late frame of cycle 4 not processed");
+    TST_CHECK(xcomStat.lateProcCnt_m == 1, "%lu frames processed late",
+              (unsigned long)xcomStat.lateProcCnt_m);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    The sync interrupt hits the processing of a frame
+
+The receive check of the next cycle has to fail and report the missed
+deadline.
+*/
+//------------------------------------------------------------------------------
+static void testDeadline(void)
+{
+    UINT64  syncTime = TST_START_US + 3 * TST_CYCLE_US;
+
+    runCycle(1, TST_FORMAT_SPDO, TST_PROC_DELAY_US);
+    runCycle(2, TST_FORMAT_SPDO, TST_PROC_DELAY_US);
+
+    TST_CHECK(startCycle(3, TST_FORMAT_SPDO), "xcom_enableReceiveCheck() cycle 3");
+    injectPeerFrame(3, TST_FORMAT_SPDO, syncTime);
+
+    fSyncInProcRet_l = TRUE;
+    fSyncInProc_l = TRUE;
+    now_l = syncTime + TST_PROC_DELAY_US;
+    xcom_process();
+
+    TST_CHECK(procCnt_l == 3, "Frame of cycle 3 not processed");
+    TST_CHECK(fSyncInProcRet_l == FALSE, "xcom_enableReceiveCheck() in the processing succeeded");
+    TST_CHECK(firstFatal_l == kXComProcessDeadlineMissed,
+              "Fatal error 0x%lx instead of the missed deadline", (unsigned long)firstFatal_l);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    A second frame arrives while a frame waits for processing
+
+The second frame is received to the other buffer and reported as overrun.
+The waiting frame is processed without a further error, i.e. the second frame
+did not overwrite it.
+*/
+//------------------------------------------------------------------------------
+static void testOverrun(void)
+{
+    UINT64  syncTime = TST_START_US + 2 * TST_CYCLE_US;
+
+    runCycle(1, TST_FORMAT_SPDO, TST_PROC_DELAY_US);
+
+    TST_CHECK(startCycle(2, TST_FORMAT_SPDO), "xcom_enableReceiveCheck() cycle 2");
+    injectPeerFrame(2, TST_FORMAT_SPDO, syncTime);
+
+    // A frame with a different flow count, time and CRCs
+    injectPeerFrame(99, TST_FORMAT_SPDO, syncTime + 1);
+    TST_CHECK(firstFatal_l == kXComProcessingOverrun, "Fatal error 0x%lx instead of the overrun",
+              (unsigned long)firstFatal_l);
+
+    now_l = syncTime + TST_PROC_DELAY_US;
+    xcom_process();
+
+    TST_CHECK(procCnt_l == 2, "Frame of cycle 2 not processed");
+    TST_CHECK(fatalCnt_l == 1, "%lu fatal errors, the waiting frame was overwritten",
+              (unsigned long)fatalCnt_l);
+#ifdef TST_XCOM_MASTER
+    TST_CHECK(syncTxCnt_l == 2, "%lu SPDO frames forwarded", (unsigned long)syncTxCnt_l);
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Start a cycle
+
+The sync interrupt enables the receive check and sets the time of the
+cycle like main.c, then the frames are posted and transmitted.
+
+\param cycle_p          Number of the cycle (flow count)
+\param msgFormat_p      Frames which are posted
+
+\return Result of xcom_enableReceiveCheck()
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN startCycle(UINT32 cycle_p, UINT8 msgFormat_p)
+{
+    UINT64  syncTime = TST_START_US + (UINT64)cycle_p * TST_CYCLE_US;
+    BOOLEAN fReturn;
+
+    now_l = syncTime;
+    fReturn = xcom_enableReceiveCheck();
+    TST_CHECK(xcom_setCurrentTimebase(&syncTime), "xcom_setCurrentTimebase() cycle %lu",
+              (unsigned long)cycle_p);
+
+    postFrames(cycle_p, msgFormat_p);
+
+    TST_CHECK(xcom_transmit(cycle_p), "xcom_transmit() cycle %lu", (unsigned long)cycle_p);
+    checkTxFrame(cycle_p, msgFormat_p, syncTime);
+
+    return fReturn;
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Run one cycle
+
+The sync interrupt starts the cycle, the background loop runs once before
+the frame of the other processor is received and once after it.
+
+\param cycle_p          Number of the cycle (flow count)
+\param msgFormat_p      Frames which are posted
+\param procDelay_p      Time of the background loop after the sync interrupt
+*/
+//------------------------------------------------------------------------------
+static void runCycle(UINT32 cycle_p, UINT8 msgFormat_p, UINT32 procDelay_p)
+{
+    UINT64  syncTime = TST_START_US + (UINT64)cycle_p * TST_CYCLE_US;
+
+    TST_CHECK(startCycle(cycle_p, msgFormat_p), "xcom_enableReceiveCheck() cycle %lu",
+              (unsigned long)cycle_p);
+
+    now_l = syncTime + TST_BG_DELAY_US;
+    xcom_process();
+
+    injectPeerFrame(cycle_p, msgFormat_p, syncTime);
+
+    now_l = syncTime + procDelay_p;
+    xcom_process();
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Post the SPDO and SSDO/SNMT frames of a cycle
+
+\param cycle_p          Number of the cycle
+\param msgFormat_p      Frames which are posted
+*/
+//------------------------------------------------------------------------------
+static void postFrames(UINT32 cycle_p, UINT8 msgFormat_p)
+{
+    tSubFrameParams sub1;
+    tSubFrameParams sub2;
+
+    if ((msgFormat_p & TST_FORMAT_SPDO) != 0)
+    {
+        fillPattern(aSpdoSub1_l, sizeof(aSpdoSub1_l), cycle_p, 1);
+        fillPattern(aSpdoSub2_l, sizeof(aSpdoSub2_l), cycle_p, 2);
+        sub1.pSubBase_m = aSpdoSub1_l;
+        sub1.subLen_m = sizeof(aSpdoSub1_l);
+        sub2.pSubBase_m = aSpdoSub2_l;
+        sub2.subLen_m = sizeof(aSpdoSub2_l);
+
+        xcom_setSpdoCrc(getCrc(cycle_p, 1), getCrc(cycle_p, 2));
+        TST_CHECK(xcom_postSpdoFrame(&sub1, &sub2, aSpdoTarg_l, sizeof(aSpdoTarg_l)),
+                  "xcom_postSpdoFrame() cycle %lu", (unsigned long)cycle_p);
+    }
+
+    if ((msgFormat_p & TST_FORMAT_SSDO) != 0)
+    {
+        fillPattern(aSsdoSub1_l, sizeof(aSsdoSub1_l), cycle_p, 3);
+        fillPattern(aSsdoSub2_l, sizeof(aSsdoSub2_l), cycle_p, 4);
+        sub1.pSubBase_m = aSsdoSub1_l;
+        sub1.subLen_m = sizeof(aSsdoSub1_l);
+        sub2.pSubBase_m = aSsdoSub2_l;
+        sub2.subLen_m = sizeof(aSsdoSub2_l);
+
+        xcom_setSsdoSnmtCrc(getCrc(cycle_p, 3), getCrc(cycle_p, 4));
+        TST_CHECK(xcom_postSsdoSnmtFrame(&sub1, &sub2, aSsdoTarg_l, sizeof(aSsdoTarg_l)),
+                  "xcom_postSsdoSnmtFrame() cycle %lu", (unsigned long)cycle_p);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Check the frame which was sent to the other processor
+
+\param cycle_p          Number of the cycle
+\param msgFormat_p      Frames which were posted
+\param syncTime_p       Time of the sync interrupt
+*/
+//------------------------------------------------------------------------------
+static void checkTxFrame(UINT32 cycle_p, UINT8 msgFormat_p, UINT64 syncTime_p)
+{
+    UINT8       aFrame[UPSERIAL_MOCK_FRAME_SIZE];
+    tTstTxImage img;
+    UINT32      frameLen;
+    UINT32      flowCnt;
+    UINT16      crc1;
+    UINT16      crc2;
+
+    MEMSET(&img, 0, sizeof(img));
+    frameLen = upserialmock_getTxFrame(aFrame, sizeof(aFrame));
+
+    if (!decodeFrame(aTxLayout_l, aFrame, frameLen, (UINT8*)&img, sizeof(img)))
+    {
+        TST_CHECK(FALSE, "Invalid frame of %lu bytes cycle %lu", (unsigned long)frameLen,
+                  (unsigned long)cycle_p);
+        return;
+    }
+
+    SFS_NET_CPY32(&flowCnt, &img.flowCnt_m);
+
+    TST_CHECK(img.id_m == TST_TX_ID && img.msgFormat_m == msgFormat_p &&
+              flowCnt == cycle_p && img.currTime_m == syncTime_p,
+              "Frame header differs cycle %lu", (unsigned long)cycle_p);
+
+    if ((msgFormat_p & TST_FORMAT_SPDO) != 0)
+    {
+        SFS_NET_CPY16(&crc1, &img.spdoSub1Crc_m);
+        SFS_NET_CPY16(&crc2, &img.spdoSub2Crc_m);
+        TST_CHECK(crc1 == getCrc(cycle_p, 1) && crc2 == getCrc(cycle_p, 2),
+                  "SPDO CRCs differ cycle %lu", (unsigned long)cycle_p);
+#ifndef TST_XCOM_MASTER
+        TST_CHECK(memcmp(img.spdoSub2Payl_m, aSpdoSub2_l, TSPDO_SUB2_LEN) == 0,
+                  "SPDO payload differs cycle %lu", (unsigned long)cycle_p);
+#endif
+    }
+
+    if ((msgFormat_p & TST_FORMAT_SSDO) != 0)
+    {
+        SFS_NET_CPY16(&crc1, &img.ssdoSub1Crc_m);
+        SFS_NET_CPY16(&crc2, &img.ssdoSub2Crc_m);
+        TST_CHECK(crc1 == getCrc(cycle_p, 3) && crc2 == getCrc(cycle_p, 4),
+                  "SSDO/SNMT CRCs differ cycle %lu", (unsigned long)cycle_p);
+#ifndef TST_XCOM_MASTER
+        TST_CHECK(memcmp(img.ssdoSub2Payl_m, aSsdoSub2_l, TSSDO_SNMT_SUB2_LEN) == 0,
+                  "SSDO/SNMT payload differs cycle %lu", (unsigned long)cycle_p);
+#endif
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Inject the frame of the other processor
+
+The other processor posted the same frames in this cycle.
+
+\param cycle_p          Number of the cycle
+\param msgFormat_p      Frames which were posted
+\param syncTime_p       Time of the sync interrupt
+*/
+//------------------------------------------------------------------------------
+static void injectPeerFrame(UINT32 cycle_p, UINT8 msgFormat_p, UINT64 syncTime_p)
+{
+    UINT8           aFrame[UPSERIAL_MOCK_FRAME_SIZE];
+    tTstPeerImage   img;
+    UINT32          frameLen;
+    UINT16          crc1;
+    UINT16          crc2;
+
+    MEMSET(&img, 0, sizeof(img));
+
+    img.id_m = TST_PEER_ID;
+    img.msgFormat_m = msgFormat_p;
+    SFS_NET_CPY32(&img.flowCnt_m, &cycle_p);
+    img.currTime_m = syncTime_p;
+
+    if ((msgFormat_p & TST_FORMAT_SPDO) != 0)
+    {
+        crc1 = getCrc(cycle_p, 1);
+        crc2 = getCrc(cycle_p, 2);
+        SFS_NET_CPY16(&img.spdoSub1Crc_m, &crc1);
+        SFS_NET_CPY16(&img.spdoSub2Crc_m, &crc2);
+#ifdef TST_XCOM_MASTER
+        MEMCOPY(img.spdoSub2Payl_m, aSpdoSub2_l, TSPDO_SUB2_LEN);
+#endif
+    }
+
+    if ((msgFormat_p & TST_FORMAT_SSDO) != 0)
+    {
+        crc1 = getCrc(cycle_p, 3);
+        crc2 = getCrc(cycle_p, 4);
+        SFS_NET_CPY16(&img.ssdoSub1Crc_m, &crc1);
+        SFS_NET_CPY16(&img.ssdoSub2Crc_m, &crc2);
+#ifdef TST_XCOM_MASTER
+        MEMCOPY(img.ssdoSub2Payl_m, aSsdoSub2_l, TSSDO_SNMT_SUB2_LEN);
+#endif
+    }
+
+    frameLen = encodeFrame(aPeerLayout_l, msgFormat_p, (const UINT8*)&img, sizeof(img), aFrame);
+
+    TST_CHECK(upserialmock_receive(aFrame, frameLen), "upserialmock_receive() cycle %lu",
+              (unsigned long)cycle_p);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Build the frame of an image like the other processor
+
+\param pLayout_p        Sections of the image
+\param msgFormat_p      Message format of the frame
+\param pImg_p           The image
+\param imgSize_p        Size of the image
+\param pFrame_p         The resulting frame
+
+\return Length of the frame
+*/
+//------------------------------------------------------------------------------
+static UINT32 encodeFrame(const tXComImgSection* pLayout_p, UINT8 msgFormat_p,
+                          const UINT8* pImg_p, UINT32 imgSize_p, UINT8* pFrame_p)
+{
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    UINT16  framePos = XCOM_FRAME_HEADER_SIZE;
+    UINT8   i;
+
+    UNUSED_PARAMETER(imgSize_p);
+
+    for (i = 0; i < XCOM_IMG_SECTION_COUNT; i++)
+    {
+        if (pLayout_p[i].msgFormatMask_m == 0 || (pLayout_p[i].msgFormatMask_m & msgFormat_p) != 0)
+        {
+            MEMCOPY(&pFrame_p[framePos], &pImg_p[pLayout_p[i].offset_m], pLayout_p[i].size_m);
+            framePos += pLayout_p[i].size_m;
+        }
+    }
+
+    pFrame_p[0] = (UINT8)framePos;
+    pFrame_p[1] = (UINT8)(framePos >> 8);
+    pFrame_p[2] = msgFormat_p;
+
+    return framePos;
+#else
+    UNUSED_PARAMETER(pLayout_p);
+    UNUSED_PARAMETER(msgFormat_p);
+
+    MEMCOPY(pFrame_p, pImg_p, imgSize_p);
+
+    return imgSize_p;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Parse a sent frame into an image
+
+\param pLayout_p        Sections of the image
+\param pFrame_p         The frame
+\param frameLen_p       Number of sent bytes
+\param pImg_p           The resulting image
+\param imgSize_p        Size of the image
+
+\return TRUE if the frame length is valid
+*/
+//------------------------------------------------------------------------------
+static BOOLEAN decodeFrame(const tXComImgSection* pLayout_p, const UINT8* pFrame_p,
+                           UINT32 frameLen_p, UINT8* pImg_p, UINT32 imgSize_p)
+{
+#ifdef XCOM_COMPACT_FRAME_ENABLED
+    UINT16  framePos = XCOM_FRAME_HEADER_SIZE;
+    UINT8   msgFormat;
+    UINT8   i;
+
+    UNUSED_PARAMETER(imgSize_p);
+
+    if (frameLen_p < XCOM_FRAME_HEADER_SIZE ||
+        (pFrame_p[0] | ((UINT32)pFrame_p[1] << 8)) != frameLen_p)
+        return FALSE;
+
+    msgFormat = pFrame_p[2];
+
+    for (i = 0; i < XCOM_IMG_SECTION_COUNT; i++)
+    {
+        if (pLayout_p[i].msgFormatMask_m == 0 || (pLayout_p[i].msgFormatMask_m & msgFormat) != 0)
+        {
+            if (framePos + pLayout_p[i].size_m > frameLen_p)
+                return FALSE;
+
+            MEMCOPY(&pImg_p[pLayout_p[i].offset_m], &pFrame_p[framePos], pLayout_p[i].size_m);
+            framePos += pLayout_p[i].size_m;
+        }
+    }
+
+    // The message format is carried by the header
+    pImg_p[offsetof(tTstTxImage, msgFormat_m)] = msgFormat;
+
+    return (framePos == frameLen_p) ? TRUE : FALSE;
+#else
+    UNUSED_PARAMETER(pLayout_p);
+
+    if (frameLen_p != imgSize_p)
+        return FALSE;
+
+    MEMCOPY(pImg_p, pFrame_p, imgSize_p);
+
+    return TRUE;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    Fill a subframe with a pattern of the cycle
+
+\param pData_p          The subframe
+\param length_p         Length of the subframe
+\param cycle_p          Number of the cycle
+\param sel_p            Selects the subframe
+*/
+//------------------------------------------------------------------------------
+static void fillPattern(UINT8* pData_p, UINT32 length_p, UINT32 cycle_p, UINT8 sel_p)
+{
+    UINT32  i;
+
+    for (i = 0; i < length_p; i++)
+        pData_p[i] = (UINT8)(cycle_p * 7 + i + sel_p * 0x40);
+}
+
+//------------------------------------------------------------------------------
+/**
+\brief    CRC value of a subframe
+
+\param cycle_p          Number of the cycle
+\param sel_p            Selects the subframe
+
+\return The CRC value both processors agree on
+*/
+//------------------------------------------------------------------------------
+static UINT16 getCrc(UINT32 cycle_p, UINT8 sel_p)
+{
+    return (UINT16)(cycle_p * 0x1021 + sel_p);
+}
+
+/// \}
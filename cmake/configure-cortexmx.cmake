@@ -50,6 +50,13 @@ ELSE()
 ENDIF()
 
 OPTION(CFG_BENCHMARK_ENABLED "Enable application benchmark module" ON)
+OPTION(CFG_BENCHMARK_TRACE_ENABLED "Record benchmark points in a RAM trace buffer instead of driving pins" OFF)
+OPTION(CFG_DEBUG_LOG_ENABLED "Record DEBUG_LOG() messages in binary form and print them deferred" OFF)
+OPTION(CFG_CRC_ENGINE_BENCHMARK "Print the throughput of all CRC implementations at startup" OFF)
+OPTION(CFG_XCOM_COMPACT_FRAME_ENABLED "Send only the present sections of the cross communication images (uP-Master and uP-Slave)" OFF)
+
+SET(CFG_CRC_ENGINE_IMPL "table" CACHE STRING "Implementation of the openSAFETY frame and parameter CRCs")
+SET_PROPERTY(CACHE CFG_CRC_ENGINE_IMPL PROPERTY STRINGS "reference;bitwise;table;slice4;slice8")
 
 OPTION(CFG_PROG_FLASH_ENABLE "Enable the program to flash target" OFF)
 
@@ -65,4 +72,49 @@ SET(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -mthumb -ffunction-sections -fdata-sections
 # Enable benchmarking
 IF(CFG_BENCHMARK_ENABLED)
     ADD_DEFINITIONS(-DBENCHMARK_ENABLED -DBENCHMARK_MODULES=0xEE800043L)
+
+    IF(CFG_BENCHMARK_TRACE_ENABLED)
+        ADD_DEFINITIONS(-DBENCHMARK_TRACE_ENABLED)
+    ENDIF()
+ENDIF()
+
+################################################################################
+# Select the CRC engine implementation (the slice-by-N tables need RAM)
+IF(CFG_CRC_ENGINE_IMPL STREQUAL "reference")
+    ADD_DEFINITIONS(-DCRCENGINE_DEFAULT_IMPL=kCrcImplReference)
+ELSEIF(CFG_CRC_ENGINE_IMPL STREQUAL "bitwise")
+    ADD_DEFINITIONS(-DCRCENGINE_DEFAULT_IMPL=kCrcImplBitwise)
+ELSEIF(CFG_CRC_ENGINE_IMPL STREQUAL "slice4")
+    ADD_DEFINITIONS(-DCRCENGINE_DEFAULT_IMPL=kCrcImplSlice4)
+ELSEIF(CFG_CRC_ENGINE_IMPL STREQUAL "slice8")
+    ADD_DEFINITIONS(-DCRCENGINE_DEFAULT_IMPL=kCrcImplSlice8)
+ELSE()
+    ADD_DEFINITIONS(-DCRCENGINE_DEFAULT_IMPL=kCrcImplTable)
+ENDIF()
+
+# The benchmark measures all slices, targets with little RAM cap them with
+# CRCENGINE_SLICE_LIMIT in apptarget/target.h
+IF(CFG_CRC_ENGINE_BENCHMARK OR CFG_CRC_ENGINE_IMPL STREQUAL "slice8")
+    ADD_DEFINITIONS(-DCRCENGINE_SLICE_MAX=8)
+ELSEIF(CFG_CRC_ENGINE_IMPL STREQUAL "slice4")
+    ADD_DEFINITIONS(-DCRCENGINE_SLICE_MAX=4)
+ENDIF()
+
+IF(CFG_CRC_ENGINE_BENCHMARK)
+    ADD_DEFINITIONS(-DCRCENGINE_BENCHMARK_ENABLED)
+ENDIF()
+
+################################################################################
+# Enable compact cross communication frames (has to match on both processors)
+IF(CFG_XCOM_COMPACT_FRAME_ENABLED)
+    ADD_DEFINITIONS(-DXCOM_COMPACT_FRAME_ENABLED)
+ENDIF()
+
+################################################################################
+# Enable deferred debug log
+IF(CFG_DEBUG_LOG_ENABLED)
+    SET(CFG_DEBUG_LOG_LVL "0xE0000200L" CACHE STRING "Debug levels compiled into DEBUG_LOG() (also in release builds)")
+    ADD_DEFINITIONS(-DDEBUG_LOG_ENABLED -DDEBUG_LOG_GLB_LVL=${CFG_DEBUG_LOG_LVL})
+ELSE()
+    UNSET(CFG_DEBUG_LOG_LVL CACHE)
 ENDIF()
\ No newline at end of file
@@ -76,4 +76,13 @@ ENDIF ( CYGWIN )
 
 SET( WIN32_EXECUTABLE "" )
 
-SET( TARGET_DIR ${APP_TARGET_DIR}/x86 )
\ No newline at end of file
+SET( TARGET_DIR ${APP_TARGET_DIR}/x86 )
+
+################################################################################
+# The x86 target has no pins for the benchmark points, they can only be
+# recorded in the RAM trace buffer (see apptarget/benchmark.h of the target)
+OPTION(CFG_BENCHMARK_TRACE_ENABLED "Record benchmark points in a RAM trace buffer" OFF)
+
+IF(CFG_BENCHMARK_TRACE_ENABLED)
+    ADD_DEFINITIONS(-DBENCHMARK_ENABLED -DBENCHMARK_TRACE_ENABLED -DBENCHMARK_MODULES=0xEE800043L)
+ENDIF()
@@ -37,4 +37,15 @@ MACRO(AppPostAction TARGET_NAME)
         COMMAND arm-none-eabi-size ${TARGET_NAME}
     )
 
+    ##############################################################################
+    # Extract the format string table of the deferred debug log
+    IF(CFG_DEBUG_LOG_ENABLED)
+        ADD_CUSTOM_COMMAND(
+            TARGET ${TARGET_NAME}
+            POST_BUILD
+            COMMAND ${PYTHON_EXECUTABLE} ${CMAKE_SOURCE_DIR}/contrib/scripts/debuglog.py
+                    extract ${TARGET_NAME} -o ${TARGET_NAME}.dbglog.json
+        )
+    ENDIF()
+
 ENDMACRO(AppPostAction)
\ No newline at end of file
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+################################################################################
+#
+# Decoder of the benchmark trace dumped by app/common/benchmark.c
+#
+# Copyright (c) 2013, B&R Industrial Automation GmbH
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the copyright holders nor the
+#       names of its contributors may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+#
+# The firmware prints the following lines over the debug output if it is built
+# with BENCHMARK_TRACE_ENABLED:
+#
+#   BMT H <tick Hz> <buffer size>           Trace started (after reset)
+#   BMT E <seq> <probe> <edge> <time>       Event (hex fields)
+#   BMT L <count>                           Events lost by the ring buffer
+#
+# All other lines of the log are ignored. The script prints latency statistics
+# per probe and optionally writes a Chrome trace (chrome://tracing, Perfetto).
+#
+# Usage: benchtrace.py [-t TICK_HZ] [-j trace.json] [logfile ...]
+#
+################################################################################
+
+import argparse
+import json
+import sys
+
+EDGE_RESET = 0
+EDGE_SET = 1
+EDGE_TOGGLE = 2
+
+
+def probeName(probe):
+    """Name of a probe id (module number in bits 7..3, pin in bits 2..0)"""
+    return "MOD_%02d.%d" % ((probe >> 3) + 1, probe & 0x07)
+
+
+class TraceError(Exception):
+    """The log cannot be decoded"""
+
+
+class Stat(object):
+    """Collects the samples of one measurement in seconds"""
+
+    def __init__(self):
+        self.samples = []
+
+    def add(self, value):
+        self.samples.append(value)
+
+    def row(self):
+        s = sorted(self.samples)
+        n = len(s)
+        if n == 0:
+            return None
+        return (n, s[0], sum(s) / n, s[(n - 1) // 2], s[min(n - 1, (n * 99) // 100)], s[-1])
+
+
+class Probe(object):
+    """State and statistics of one benchmark point"""
+
+    def __init__(self):
+        self.setTime = None
+        self.pulseOpen = False
+        self.lastEdgeTime = None
+        self.width = Stat()
+        self.period = Stat()
+        self.edges = 0
+
+
+class Decoder(object):
+    """Reconstructs a continuous time line from the dumped events"""
+
+    def __init__(self, tickHz):
+        self.tickHz = tickHz
+        self.fixedTickHz = tickHz is not None
+        self.probes = {}
+        self.events = []
+        self.lost = 0
+        self.offset = 0
+        self.lastTick = None
+        self.lastSeq = None
+
+    def header(self, tickHz):
+        # A new header marks a restart, continue the time line after the
+        # last event so sessions do not overlap
+        if not self.fixedTickHz:
+            self.tickHz = tickHz
+        if self.lastTick is not None:
+            self.offset = self.lastTick + 1
+        self.lastTick = None
+        self.lastSeq = None
+        for probe in self.probes.values():
+            probe.setTime = None
+            probe.pulseOpen = False
+            probe.lastEdgeTime = None
+
+    def event(self, seq, probeId, edge, stamp):
+        if self.tickHz is None:
+            raise TraceError("No trace header found, pass the tick rate with -t")
+
+        if self.lastSeq is not None:
+            gap = (seq - self.lastSeq - 1) & 0xFFFF
+            if gap != 0:
+                # Already reported by an L line, but the pairing is broken
+                for probe in self.probes.values():
+                    probe.setTime = None
+                    probe.pulseOpen = False
+        self.lastSeq = seq
+
+        # Unwrap the 32 bit time stamp of the target
+        if self.lastTick is None:
+            tick = self.offset + stamp
+        else:
+            tick = self.lastTick + ((stamp - (self.lastTick - self.offset)) & 0xFFFFFFFF)
+        self.lastTick = tick
+        time = tick / float(self.tickHz)
+
+        probe = self.probes.setdefault(probeId, Probe())
+        probe.edges += 1
+
+        if edge == EDGE_SET:
+            if probe.setTime is not None:
+                probe.period.add(time - probe.setTime)
+            probe.setTime = time
+            probe.pulseOpen = True
+        elif edge == EDGE_RESET:
+            if probe.pulseOpen:
+                probe.width.add(time - probe.setTime)
+            probe.pulseOpen = False
+        else:
+            if probe.lastEdgeTime is not None:
+                probe.period.add(time - probe.lastEdgeTime)
+        probe.lastEdgeTime = time
+
+        self.events.append((time, probeId, edge))
+
+    def parse(self, stream):
+        for line in stream:
+            pos = line.find("BMT ")
+            if pos < 0:
+                continue
+            fields = line[pos:].split()
+            try:
+                if fields[1] == "H":
+                    self.header(int(fields[2]))
+                elif fields[1] == "E":
+                    self.event(int(fields[2], 16), int(fields[3], 16),
+                               int(fields[4], 16), int(fields[5], 16))
+                elif fields[1] == "L":
+                    self.lost += int(fields[2])
+                    self.lastSeq = None
+                    for probe in self.probes.values():
+                        probe.setTime = None
+                        probe.pulseOpen = False
+            except (IndexError, ValueError):
+                sys.stderr.write("benchtrace: skipping malformed line: %s" % line)
+
+    def printReport(self, out):
+        out.write("%d events, %d lost\n\n" % (len(self.events), self.lost))
+        out.write("%-10s %-7s %8s %12s %12s %12s %12s %12s\n" %
+                  ("probe", "value", "count", "min [us]", "mean [us]", "median [us]",
+                   "p99 [us]", "max [us]"))
+        for probeId in sorted(self.probes):
+            probe = self.probes[probeId]
+            for label, stat in (("width", probe.width), ("period", probe.period)):
+                row = stat.row()
+                if row is None:
+                    continue
+                out.write("%-10s %-7s %8d %12.3f %12.3f %12.3f %12.3f %12.3f\n" %
+                          ((probeName(probeId), label, row[0]) +
+                           tuple(v * 1e6 for v in row[1:])))
+
+    def writeChromeTrace(self, path):
+        trace = []
+        openPulse = {}
+        for time, probeId, edge in self.events:
+            name = probeName(probeId)
+            entry = {"name": name, "pid": 1, "tid": (probeId >> 3) + 1,
+                     "ts": time * 1e6}
+            if edge == EDGE_SET:
+                if openPulse.get(probeId):
+                    trace.append(dict(entry, ph="E"))
+                entry["ph"] = "B"
+                openPulse[probeId] = True
+            elif edge == EDGE_RESET:
+                if not openPulse.get(probeId):
+                    continue
+                entry["ph"] = "E"
+                openPulse[probeId] = False
+            else:
+                entry["ph"] = "i"
+                entry["s"] = "t"
+            trace.append(entry)
+
+        for probeId in sorted(set(p >> 3 for p in self.probes)):
+            trace.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": probeId + 1,
+                          "args": {"name": "MOD_%02d" % (probeId + 1)}})
+
+        with open(path, "w") as f:
+            json.dump({"traceEvents": trace, "displayTimeUnit": "ns"}, f)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a benchmark trace dump")
+    parser.add_argument("logs", nargs="*", help="log files of the debug output (default: stdin)")
+    parser.add_argument("-t", "--tick-hz", type=int, default=None,
+                        help="time stamp frequency (overrides the trace header)")
+    parser.add_argument("-j", "--json", default=None, help="write a Chrome trace JSON file")
+    args = parser.parse_args()
+
+    decoder = Decoder(args.tick_hz)
+    try:
+        if args.logs:
+            for path in args.logs:
+                with open(path, "r", errors="replace") as f:
+                    decoder.parse(f)
+        else:
+            decoder.parse(sys.stdin)
+    except TraceError as err:
+        sys.stderr.write("benchtrace: %s\n" % err)
+        return 1
+
+    decoder.printReport(sys.stdout)
+    if args.json:
+        decoder.writeChromeTrace(args.json)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+################################################################################
+#
+# Format string extractor and decoder of the deferred debug log
+# (app/common/debuglog.c)
+#
+# Copyright (c) 2013, B&R Industrial Automation GmbH
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the copyright holders nor the
+#       names of its contributors may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+#
+# DEBUG_LOG() places its format strings in the ELF section .dbglog and records
+# the address of the string as id. The firmware prints the records over the
+# debug output:
+#
+#   BML H <contexts> <buffer size>              Log started (after reset)
+#   BML R <ctx> <seq> <fmt id> [arg ...]        Record (hex fields)
+#   BML L <ctx> <count>                         Records lost by the ring buffer
+#
+# Usage:
+#   debuglog.py extract <elf> [-o table.json]   Build the format string table
+#   debuglog.py decode (-t table.json | -e <elf>) [logfile ...]
+#
+################################################################################
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+SECTION_NAME = ".dbglog"
+CONTEXT_NAMES = {0: "bg", 1: "irq"}
+
+# C conversion specification: flags, width, precision, length, conversion
+FMT_SPEC = re.compile(r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class LogError(Exception):
+    """The input cannot be processed"""
+
+
+def readSection(path, name):
+    """Return (address, data) of an ELF section"""
+    with open(path, "rb") as f:
+        elf = f.read()
+
+    if elf[:4] != b"\x7fELF":
+        raise LogError("%s is not an ELF file" % path)
+
+    is64 = elf[4] == 2
+    endian = "<" if elf[5] == 1 else ">"
+
+    if is64:
+        shoff, = struct.unpack_from(endian + "Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", elf, 0x3A)
+        shdr = endian + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(endian + "I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", elf, 0x2E)
+        shdr = endian + "IIIIIIIIII"
+
+    sections = [struct.unpack_from(shdr, elf, shoff + i * shentsize) for i in range(shnum)]
+    strtab = sections[shstrndx]
+
+    for sec in sections:
+        nameOff = strtab[4] + sec[0]
+        secName = elf[nameOff:elf.index(b"\0", nameOff)].decode("ascii", "replace")
+        if secName == name:
+            addr, offset, size = sec[3], sec[4], sec[5]
+            return addr, elf[offset:offset + size]
+
+    raise LogError("%s has no section %s (built without DEBUG_LOG_ENABLED?)" % (path, name))
+
+
+def extractTable(path):
+    """Map the address of each format string to the string"""
+    addr, data = readSection(path, SECTION_NAME)
+    table = {}
+    pos = 0
+    while pos < len(data):
+        end = data.index(b"\0", pos)
+        if end > pos:
+            table["%x" % (addr + pos)] = data[pos:end].decode("latin-1")
+        pos = end + 1
+    return table
+
+
+def formatMessage(fmt, args):
+    """Format a C printf string with the raw 32 bit arguments"""
+    argIter = iter(args)
+
+    def convert(match):
+        flags, width, prec, length, conv = match.groups()
+        if conv == "%":
+            return "%"
+        try:
+            value = next(argIter)
+        except StopIteration:
+            return "<missing>"
+
+        if length in ("h",):
+            value &= 0xFFFF
+        elif length in ("hh",):
+            value &= 0xFF
+
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if conv in "di":
+            bits = 16 if length == "h" else 8 if length == "hh" else 32
+            if value & (1 << (bits - 1)):
+                value -= 1 << bits
+            return (spec + "d") % value
+        if conv == "u":
+            return (spec + "d") % value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "s":
+            return "<str@0x%08x>" % value
+        if conv == "p":
+            return "0x%08x" % value
+        return (spec + conv) % value
+
+    text = FMT_SPEC.sub(convert, fmt)
+    return text
+
+
+def decode(table, stream, out):
+    lost = 0
+    for line in stream:
+        pos = line.find("BML ")
+        if pos < 0:
+            continue
+        fields = line[pos:].split()
+        try:
+            if fields[1] == "H":
+                out.write("--- log started (%s contexts) ---\n" % fields[2])
+            elif fields[1] == "R":
+                ctx = int(fields[2])
+                seq = int(fields[3], 16)
+                fmtId = "%x" % int(fields[4], 16)
+                args = [int(a, 16) for a in fields[5:]]
+                fmt = table.get(fmtId)
+                if fmt is None:
+                    text = "<unknown format 0x%s> %s\n" % (fmtId, " ".join(fields[5:]))
+                else:
+                    text = formatMessage(fmt, args)
+                    if not text.endswith("\n"):
+                        text += "\n"
+                out.write("[%-3s %04x] %s" % (CONTEXT_NAMES.get(ctx, str(ctx)), seq,
+                                              text.lstrip("\n")))
+            elif fields[1] == "L":
+                lost += int(fields[3])
+                out.write("[%-3s] <%s records lost>\n" %
+                          (CONTEXT_NAMES.get(int(fields[2]), fields[2]), fields[3]))
+        except (IndexError, ValueError):
+            sys.stderr.write("debuglog: skipping malformed line: %s" % line)
+    return lost
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Deferred debug log tool")
+    sub = parser.add_subparsers(dest="command")
+
+    ext = sub.add_parser("extract", help="extract the format string table of an ELF file")
+    ext.add_argument("elf")
+    ext.add_argument("-o", "--output", default=None, help="table file (default: stdout)")
+
+    dec = sub.add_parser("decode", help="decode a dumped log")
+    dec.add_argument("logs", nargs="*", help="log files of the debug output (default: stdin)")
+    src = dec.add_mutually_exclusive_group(required=True)
+    src.add_argument("-t", "--table", help="table file written by extract")
+    src.add_argument("-e", "--elf", help="ELF file of the firmware")
+
+    args = parser.parse_args()
+
+    try:
+        if args.command == "extract":
+            table = extractTable(args.elf)
+            if args.output:
+                with open(args.output, "w") as f:
+                    json.dump(table, f, indent=1, sort_keys=True)
+            else:
+                json.dump(table, sys.stdout, indent=1, sort_keys=True)
+                sys.stdout.write("\n")
+        elif args.command == "decode":
+            if args.table:
+                with open(args.table, "r") as f:
+                    table = json.load(f)
+            else:
+                table = extractTable(args.elf)
+
+            if args.logs:
+                for path in args.logs:
+                    with open(path, "r", errors="replace") as f:
+                        decode(table, f, sys.stdout)
+            else:
+                decode(table, sys.stdin, sys.stdout)
+        else:
+            parser.print_help()
+            return 1
+    except (LogError, IOError) as err:
+        sys.stderr.write("debuglog: %s\n" % err)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())